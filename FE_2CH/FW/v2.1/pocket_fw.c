@@ -14,6 +14,7 @@
 //
 //  History:
 //  2021-10-18  1.0  new
+//  2026-10-15  1.1  add vendor requests of MAX2771 register block read/write
 //
 #pragma NOIV
 
@@ -22,7 +23,7 @@
 #include "fx2sdly.h"
 
 // constants and macros -------------------------------------------------------
-#define VER_FW       0x10       // Firmware version
+#define VER_FW       0x11       // Firmware version
 #ifndef F_TCXO
 #define F_TCXO       24000      // TCXO frequency (kHz)
 #endif
@@ -45,6 +46,8 @@
 #define VR_SAVE      0x47       // USB vendor request: Save settings to EEPROM
 #define VR_EE_READ   0x48       // USB vendor request: Read EEPROM
 #define VR_EE_WRITE  0x49       // USB vendor request: Write EEPROM
+#define VR_REG_READ_BLK  0x4C   // USB vendor request: Read MAX2771 reg block
+#define VR_REG_WRITE_BLK 0x4D   // USB vendor request: Write MAX2771 reg block
 
 #define MAX_CH       2          // number of MAX2771 channels
 #define MAX_ADDR     11         // number of MAX2771 registers
@@ -294,12 +297,16 @@ void loop(void) {
 //  Save settings to EEPROM 0x47  O  -           0  -
 //  Read EEPROM             0x48  I  address     n  data (n <= 64)
 //  Write EEPROM            0x49  O  address     n  data (n <= 64)
+//  Read MAX2771 reg block  0x4C  I  CH + addr* 4n  Register values (n <= 11)
+//  Write MAX2771 reg block 0x4D  O  CH + addr* 4n  Register values (n <= 11)
 //
 //  * bit15-8= MAX2771 CH (0:CH1,1:CH2), bit7-0= MAX2771 register address
+//    (start address of n registers for register block)
 //
 BOOL handle_req(void) {
   uint16_t len = WORD_(SETUPDAT + 6);
   uint16_t val = WORD_(SETUPDAT + 2);
+  uint8_t i, n = (uint8_t)(len / 4);
   
   if (SETUPDAT[1] == VR_STAT) {
     EP0BUF[0] = VER_FW;             // F/W version
@@ -322,6 +329,22 @@ BOOL handle_req(void) {
     while (EP0CS & bmEPBUSY) ;
     write_reg(SETUPDAT[3], SETUPDAT[2], *(uint32_t *)EP0BUF);
   }
+  else if (SETUPDAT[1] == VR_REG_READ_BLK) {
+    if (n < 1 || SETUPDAT[2] + n > MAX_ADDR) return TRUE;
+    for (i = 0; i < n; i++) {
+      ((uint32_t *)EP0BUF)[i] = read_reg(SETUPDAT[3], SETUPDAT[2] + i);
+    }
+    EP0BCH = 0;
+    EP0BCL = n * 4;
+  }
+  else if (SETUPDAT[1] == VR_REG_WRITE_BLK) {
+    if (n < 1 || SETUPDAT[2] + n > MAX_ADDR) return TRUE;
+    EP0BCH = EP0BCL = 0;
+    while (EP0CS & bmEPBUSY) ;
+    for (i = 0; i < n; i++) {
+      write_reg(SETUPDAT[3], SETUPDAT[2] + i, ((uint32_t *)EP0BUF)[i]);
+    }
+  }
   else if (SETUPDAT[1] == VR_START) {
     EP0BCH = EP0BCL = 0;
     start_bulk();
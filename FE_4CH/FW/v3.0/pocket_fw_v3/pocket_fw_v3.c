@@ -17,6 +17,9 @@
 //  History:
 //  2024-04-10  1.0  new
 //  2024-05-13  1.1  support H/W rev.A with -DREV_A
+//  2026-10-15  1.2  add vendor requests of MAX2771 register block read/write
+//  2026-10-15  1.3  deeper DMA buffers for super speed
+//                   add frame headers with sample counter of bulk transfer
 //
 #include <stdio.h>
 #include <stdint.h>
@@ -31,7 +34,7 @@
 #include "gpif_conf.h"
 
 // constants and macros --------------------------------------------------------
-#define VER_FW       0x30       // Firmware version
+#define VER_FW       0x32       // Firmware version
 #ifndef F_TCXO
 #define F_TCXO       24000      // TCXO frequency (kHz)
 #endif
@@ -72,12 +75,15 @@
 #define VR_EE_WRITE  0x49       // USB vendor request: Write EEPROM
 #define VR_IO_READ   0x4A       // USB vendor request: Read IO port
 #define VR_IO_WRITE  0x4B       // USB vendor request: Write IO port
+#define VR_REG_READ_BLK  0x4C   // USB vendor request: Read MAX2771 reg block
+#define VR_REG_WRITE_BLK 0x4D   // USB vendor request: Write MAX2771 reg block
+#define VR_FRAME     0x4E       // USB vendor request: Set frame header
 
 #define EP_BULK_IN   0x86       // Bulk transfer IN end point
 #define APP_STACK    0x0800     // App thread stack size
 #define APP_PRI      8          // App thread priority
 #define BUFF_COUNT_HS 32        // DMA buffer count (high speed)
-#define BUFF_COUNT_SS 2         // DMA buffer count (super speed)
+#define BUFF_COUNT_SS 4         // DMA buffer count (super speed)
 #define BURST_LEN    16         // DMA burst length (super speed)
 #define I2C_BITRATE  100000     // I2C bitrate (Hz)
 #define I2C_ADDR     0x51       // I2C EEPROM address
@@ -88,6 +94,9 @@
 #define HEAD_REG     0xABC00CBA // MAX2771 settings header
 #define MAX_CH       4          // Number of MAX2771 channels
 #define MAX_ADDR     11         // Number of MAX2771 registers
+#define FRM_HEAD     16         // Frame header size (bytes)
+#define FRM_MAGIC    0x4D524650 // Frame header magic number
+#define FRM_FLAG_OVR 0x01       // Frame flag: overrun before frame
 
 // external variables (pocket_usb_dscr.c) --------------------------------------
 extern const uint8_t CyFxUSB20DeviceDscr[];
@@ -107,6 +116,10 @@ static CyU3PDmaMultiChannel dma_ch; // DMA channel for bulk transfer
 static uint8_t usb_event = 0;       // USB event state
 static uint8_t app_act = 0;         // application active
 static uint8_t bulk_act = 0;        // bulk transfer active
+static uint8_t frm_ena = 0;         // frame header enabled
+static uint8_t frm_ovr = 0;         // overrun before next frame
+static uint16_t frm_size = 0;       // frame size (DMA buffer size) (bytes)
+static uint64_t frm_cnt = 0;        // sample counter of next frame
 static uint8_t EP0BUFF[128] __attribute__ ((aligned (32))); // EP0 data buffer
 
 // IO ports definitions
@@ -340,6 +353,39 @@ static int save_settings(void)
     return 1;
 }
 
+// DMA callback for frame header -----------------------------------------------
+//  The frame header consists of the magic number (4 bytes), the data size
+//  (2 bytes), the frame flags (1 byte), reserved (1 byte) and the sample
+//  counter of the first 16-bit sample of the frame (8 bytes) in little endian.
+//  It is written in the header space of the DMA buffer before committed to the
+//  USB end point.
+static void dma_cb(CyU3PDmaMultiChannel *ch, CyU3PDmaCbType_t type,
+    CyU3PDmaCBInput_t *input)
+{
+    if (type != CY_U3P_DMA_CB_PROD_EVENT) return;
+    
+    uint8_t *p = input->buffer_p.buffer;
+    uint16_t size = input->buffer_p.count;
+    
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(FRM_MAGIC >> (i * 8));
+    p[4] = (uint8_t)(size & 0xFF);
+    p[5] = (uint8_t)(size >> 8);
+    p[6] = frm_ovr ? FRM_FLAG_OVR : 0;
+    p[7] = 0;
+    for (int i = 0; i < 8; i++) p[8 + i] = (uint8_t)(frm_cnt >> (i * 8));
+    frm_cnt += size / 2;
+    frm_ovr = 0;
+    CyU3PDmaMultiChannelCommitBuffer(ch, size + FRM_HEAD, 0);
+}
+
+// P-port I/F callback ---------------------------------------------------------
+static void pib_cb(CyU3PPibIntrType type, uint16_t arg)
+{
+    if (type == CYU3P_PIB_INTR_ERROR) { // GPIF overrun
+        frm_ovr = 1;
+    }
+}
+
 // stop bulk transfer ----------------------------------------------------------
 static int stop_bulk(void)
 {
@@ -382,7 +428,7 @@ static int app_start(void)
     ecfg.burstLen = burst_len;
     if (CyU3PSetEpConfig(EP_BULK_IN, &ecfg)) return 0;
     
-    // generate DMA channel
+    // generate DMA channel (manual DMA channel with frame header)
     CyU3PDmaMultiChannelConfig_t dcfg = {0};
     dcfg.size = burst_len * pckt_size;
     dcfg.count = (speed == CY_U3P_HIGH_SPEED) ? BUFF_COUNT_HS : BUFF_COUNT_SS;
@@ -391,13 +437,21 @@ static int app_start(void)
     dcfg.prodSckId[0] = CY_U3P_PIB_SOCKET_0;
     dcfg.prodSckId[1] = CY_U3P_PIB_SOCKET_1;
     dcfg.consSckId[0] = CY_U3P_UIB_SOCKET_CONS_6; // EP 0x86
+    dcfg.prodHeader = frm_ena ? FRM_HEAD : 0;
     dcfg.notification = CY_U3P_DMA_CB_PROD_EVENT;
-    if (CyU3PDmaMultiChannelCreate(&dma_ch, CY_U3P_DMA_TYPE_AUTO_MANY_TO_ONE,
+    dcfg.cb = frm_ena ? dma_cb : NULL;
+    if (CyU3PDmaMultiChannelCreate(&dma_ch, frm_ena ?
+        CY_U3P_DMA_TYPE_MANUAL_MANY_TO_ONE : CY_U3P_DMA_TYPE_AUTO_MANY_TO_ONE,
         &dcfg)) {
         return 0;
     }
+    frm_size = dcfg.size;
+    frm_cnt = 0;
+    frm_ovr = 0;
+    
     // set data counter for socket switch
-    CyU3PGpifInitDataCounter(0, dcfg.size / 2 - 2, CyFalse, CyTrue, 1);
+    CyU3PGpifInitDataCounter(0, (dcfg.size - dcfg.prodHeader) / 2 - 2, CyFalse,
+        CyTrue, 1);
     
     // prepare and suspend DMA channel
     if (CyU3PDmaMultiChannelSetXfer(&dma_ch, 0, 0) ||
@@ -460,12 +514,18 @@ static int set_dev_desc(void)
 //  Write EEPROM            0x49  O  address       n  data (n <= 64)
 //  Read IO port            0x4A  I  IO port       1  0:off, 1:on
 //  Write IO port           0x4B  O  IO port       1  0:off, 1:on
+//  Read MAX2771 reg block  0x4C  I  CH + addr*   4n  Register values (n <= 11)
+//  Write MAX2771 reg block 0x4D  O  CH + addr*   4n  Register values (n <= 11)
+//  Set frame header        0x4E  I  0:off,1:on    4  Header size, frame size
+//                                                    (2 bytes each)
 //
 //  * bit15-8= MAX2771 CH (0:CH1,1:CH2,...), bit7-0= MAX2771 register address
+//    (start address of n registers for register block)
 //
 static int handle_req(uint8_t req, uint16_t val, uint16_t len)
 {
     uint8_t ch = (uint8_t)(val >> 8), addr = (uint8_t)(val & 0xFF);
+    int n = len / 4;
     
     if (req == VR_STAT) {
         uint8_t stat = (app_act << 5) + (bulk_act << 4) +
@@ -525,6 +585,41 @@ static int handle_req(uint8_t req, uint16_t val, uint16_t len)
         if (CyU3PUsbGetEP0Data(1, EP0BUFF, NULL)) return 0;
         write_iop(val, EP0BUFF[0]);
     }
+    else if (req == VR_REG_READ_BLK) {
+        if (ch >= MAX_CH || n < 1 || addr + n > MAX_ADDR) return 0;
+        for (int i = 0; i < n; i++) {
+            uint32_t reg = read_reg(ch, addr + i);
+            EP0BUFF[i * 4 + 0] = (reg >> 24) & 0xFF;
+            EP0BUFF[i * 4 + 1] = (reg >> 16) & 0xFF;
+            EP0BUFF[i * 4 + 2] = (reg >>  8) & 0xFF;
+            EP0BUFF[i * 4 + 3] = (reg >>  0) & 0xFF;
+        }
+        if (CyU3PUsbSendEP0Data(n * 4, EP0BUFF)) return 0;
+    }
+    else if (req == VR_FRAME) {
+        if (len < 4) return 0;
+        if ((val != 0) != frm_ena) {
+            frm_ena = (val != 0);
+            if (!app_stop() || !app_start()) return 0;
+        }
+        EP0BUFF[0] = 0;
+        EP0BUFF[1] = frm_ena ? FRM_HEAD : 0;
+        EP0BUFF[2] = (uint8_t)(frm_size >> 8);
+        EP0BUFF[3] = (uint8_t)(frm_size & 0xFF);
+        if (CyU3PUsbSendEP0Data(4, EP0BUFF)) return 0;
+    }
+    else if (req == VR_REG_WRITE_BLK) {
+        if (ch >= MAX_CH || n < 1 || addr + n > MAX_ADDR) return 0;
+        if (CyU3PUsbGetEP0Data(len, EP0BUFF, NULL)) return 0;
+        for (int i = 0; i < n; i++) {
+            uint32_t reg =
+                ((uint32_t)EP0BUFF[i * 4 + 0] << 24) +
+                ((uint32_t)EP0BUFF[i * 4 + 1] << 16) +
+                ((uint32_t)EP0BUFF[i * 4 + 2] <<  8) +
+                ((uint32_t)EP0BUFF[i * 4 + 3] <<  0);
+            if (!write_reg(ch, addr + i, reg)) return 0;
+        }
+    }
     else { // unknown request
         return 0;
     }
@@ -596,6 +691,9 @@ static int app_init(void)
     pclk.clkSrc = CY_U3P_SYS_CLK;
     if (CyU3PPibInit(CyTrue, &pclk)) return 0;
     
+    // register P-port I/F error callback
+    CyU3PPibRegisterCallback(pib_cb, CYU3P_PIB_INTR_ERROR);
+    
     // load GPIF configuration
     if (CyU3PGpifLoad(&CyFxGpifConfig)) return 0;
     
@@ -7,6 +7,8 @@
 //  History:
 //  2022-07-05  1.0  port pocket_acq.py to C
 //  2022-08-08  1.1  add option -w, modify option -d
+//  2026-10-14  1.2  search max correlation power in code search
+//                   search signals of PRNs in parallel by sdr_acq_batch()
 //
 #include "pocket_sdr.h"
 
@@ -25,49 +27,6 @@ static void show_usage(void)
     exit(0);
 }
 
-// search signal ---------------------------------------------------------------
-int search_sig(const char *sig, int prn, const sdr_buff_t *buff, double fs,
-    double fi, float ref_dop, float max_dop, const int *opt, double *dop,
-    double *coff, float *cn0)
-{
-    int8_t *code;
-    int len_code;
-    
-    // generate code
-    if (!(code = sdr_gen_code(sig, prn, &len_code))) {
-        return 0;
-    }
-    // shift IF frequency for GLONASS FDMA
-    fi = sdr_shift_freq(sig, prn, fi);
-    
-    // generate code FFT
-    double T = sdr_code_cyc(sig);
-    int N = (int)(fs * T), Nz = opt[2] ? 0 : N;
-    sdr_cpx_t *code_fft = sdr_cpx_malloc(2 * N);
-    sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, Nz, code_fft);
-    
-    // doppler search bins
-    int len_fds;
-    float *fds = sdr_dop_bins(T, ref_dop, max_dop, &len_fds);
-    
-    // parallel code search and non-coherent integration
-    float *P = (float *)sdr_malloc(sizeof(float) * (N + Nz) * len_fds);
-    for (int i = 0; i < buff->N - 2 * N + 1; i += N) {
-        sdr_search_code(code_fft, T, buff, i, N + Nz, fs, fi, fds, len_fds, P);
-    }
-    // max correlation power and C/N0
-    int ix[2] = {0};
-    *cn0 = sdr_corr_max(P, N + Nz, N, len_fds, T, ix);
-    
-    *dop = sdr_fine_dop(P, N + Nz, fds, len_fds, ix);
-    *coff = ix[1] / fs;
-    
-    sdr_cpx_free(code_fft);
-    sdr_free(fds);
-    sdr_free(P);
-    return 1;
-}
-
 //------------------------------------------------------------------------------
 //
 //   Synopsis
@@ -188,20 +147,28 @@ int main(int argc, char **argv)
     }
     uint32_t tick = sdr_get_tick();
     
-    // search signal
+    // search signals in parallel
+    sdr_acq_job_t *jobs = (sdr_acq_job_t *)sdr_malloc(sizeof(sdr_acq_job_t) *
+        (nprn + 1));
     for (int i = 0; i < nprn; i++) {
-        double dop, coff;
-        float cn0;
+        snprintf(jobs[i].sig, sizeof(jobs[i].sig), "%s", sig);
+        jobs[i].prn = prns[i];
+        jobs[i].dop = (float)ref_dop;
+        jobs[i].max_dop = (float)max_dop;
+    }
+    sdr_acq_batch(jobs, nprn, buff, fs, fi, !opt[2], 0);
+    
+    for (int i = 0; i < nprn; i++) {
+        float cn0 = jobs[i].cn0;
         
-        if (!search_sig(sig, prns[i], buff, fs, fi, ref_dop, max_dop, opt, &dop,
-                &coff, &cn0)) {
-            continue;
-        }
+        if (!jobs[i].stat) continue;
         printf("%sSIG= %-4s, %s= %3d, COFF= %8.5f ms, DOP= %5.0f Hz, C/N0= %4.1f dB-Hz%s\n",
-            (cn0 >= THRES_CN0) ? ESC_COL : "", sig, "PRN", prns[i], coff * 1e3,
-            dop, cn0, (cn0 >= THRES_CN0) ? ESC_RES : "");
+            (cn0 >= THRES_CN0) ? ESC_COL : "", sig, "PRN", prns[i],
+            jobs[i].coff * 1e3, jobs[i].fd, cn0,
+            (cn0 >= THRES_CN0) ? ESC_RES : "");
         fflush(stdout);
     }
+    sdr_free(jobs);
     printf("TIME = %.3f s\n", (sdr_get_tick() - tick) * 1e-3);
     return 0;
 }
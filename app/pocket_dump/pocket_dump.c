@@ -17,19 +17,64 @@
 //  2024-04-28  1.6  support Pocket SDR FE 4CH
 //  2024-06-29  1.7  support API change in sdr_dev.c
 //  2024-07-02  1.8  support tag file output
+//  2026-10-15  1.9  add option -shm for shared memory IF broker
+//                   write output files by writer threads with direct I/O
+//                   add option -pack for 2-bit packed output
 //
 #include <signal.h>
-#ifdef WIN32
 #include <fcntl.h>
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
 #endif
 #include "pocket_sdr.h"
 
 // constants and macros --------------------------------------------------------
 #define PROG_NAME       "pocket_dump" // program name
-#define DATA_CYC        10      // data capture cycle (ms)
 #define STAT_CYC        50      // status update cycle (ms)
 #define RATE_CYC        1000    // data rate update cycle (ms)
-#define F2BIT(buff,ch,IQ) (((buff)>>(4*(ch)+2*(IQ)))&3)
+#define BLK_SIZE        (1 << 20) // size of raw data block (bytes)
+#define NUM_BLK         64      // number of raw data blocks
+#define OUT_SIZE        (4 << 20) // size of output write (bytes)
+#define ALIGN_IO        4096    // alignment of direct I/O (bytes)
+#define TO_WAIT         100     // timeout of waiting data or block (ms)
+#define FMT_INT2        6       // IF data format: packed 2 bits (I)
+#define FMT_INT2X2      7       // IF data format: packed 2 bits x 2 (IQ)
+
+#ifndef O_BINARY
+#define O_BINARY        0
+#endif
+
+// raw data block queue type ---------------------------------------------------
+//  The raw data read from the device are copied to the blocks of the queue by
+//  the reader and the blocks are demuxed and written by the writer threads of
+//  the output files in parallel. A block is reused after read by all writers.
+typedef struct {
+    uint8_t *buff;              // raw data blocks {NUM_BLK * BLK_SIZE}
+    int size[NUM_BLK];          // data size of blocks (bytes)
+    int64_t nw;                 // number of blocks written (atomic)
+    int state;                  // state (0:stop,1:run) (atomic)
+    pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // block update condition
+} blk_que_t;
+
+// output file writer type -----------------------------------------------------
+typedef struct {
+    blk_que_t *que;             // raw data block queue
+    int fd;                     // file descriptor
+    int direct;                 // direct I/O (O_DIRECT)
+    int fmt, raw, pack;         // IF data format, raw output, 2-bit packing
+    int off, ns, nbit;          // byte offset and bytes of sample, bits of
+                                // output sample by packing
+    uint16_t LUT[256];          // demux LUT (int8 I/Q or 2-bit code)
+    uint8_t *out;               // output buffer
+    int nout;                   // size of data in output buffer (bytes)
+    int64_t nr;                 // number of blocks read (atomic)
+    double byte;                // bytes written
+    double lat, lat_max;        // write latency and peak (ms)
+    pthread_t thread;           // writer thread
+} writer_t;
 
 // interrupt flag --------------------------------------------------------------
 static volatile uint8_t intr = 0;
@@ -44,143 +89,338 @@ static void sig_func(int sig)
 // print usage -----------------------------------------------------------------
 static void print_usage(void)
 {
-    printf("Usage: %s [-t tsec] [-r] [-p bus[,port]] [-c conf_file] [-q]\n"
-        "    [file [file ...]]\n", PROG_NAME);
+    printf("Usage: %s [-t tsec] [-r] [-pack] [-p bus[,port]] [-c conf_file]\n"
+        "    [-shm name] [-q] [file [file ...]]\n", PROG_NAME);
     exit(0);
 }
 
-// generate lookup table -------------------------------------------------------
-static void gen_LUT(int8_t LUT[][256])
+// allocate and free memory aligned for direct I/O -----------------------------
+static uint8_t *alloc_io(size_t size)
+{
+    void *p = NULL;
+#ifdef WIN32
+    p = _aligned_malloc(size, ALIGN_IO);
+#else
+    if (posix_memalign(&p, ALIGN_IO, size)) p = NULL;
+#endif
+    if (!p) {
+        fprintf(stderr, "memory allocation error size=%d\n", (int)size);
+        exit(-1);
+    }
+    return (uint8_t *)p;
+}
+
+static void free_io(uint8_t *p)
+{
+#ifdef WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+// open output file ------------------------------------------------------------
+//  The file is opened with direct I/O to bypass the page cache if supported
+//  by the OS and the file system.
+static int open_file(const char *file, int *direct)
+{
+    int fd = -1;
+    
+    *direct = 0;
+    if (!strcmp(file, "-")) {
+#ifdef WIN32 // set binary mode for Windows
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        return fileno(stdout);
+    }
+#ifdef O_DIRECT
+    fd = open(file, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+    *direct = fd >= 0;
+#endif
+    if (fd < 0) {
+        fd = open(file, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+    }
+    if (fd < 0) {
+        fprintf(stderr, "file open error %s\n", file);
+    }
+    return fd;
+}
+
+// generate demux LUT of output file -------------------------------------------
+//  The LUT maps a raw data byte to the int8 I (and Q) sample(s) of the RF
+//  channel or the 2-bit sign + magnitude code(s) of them by packing.
+static void gen_LUT(writer_t *w, int ch, int IQ)
 {
     static const int8_t val[] = {1, 3, -1, -3}; // sign + magnitude
+    int sft; // bit shift of I sample in raw data byte
     
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 256; j++) {
-            LUT[i][j] = val[(j >> (i * 2)) & 3];
+    if (w->fmt == SDR_FMT_RAW8) { // packed 8(4x2) bits raw
+        w->off = 0;
+        sft = ch * 4;
+    }
+    else if (w->fmt == SDR_FMT_RAW16) { // packed 16(4x4) bits raw
+        w->off = ch / 2;
+        sft = ch % 2 * 4;
+    }
+    else { // packed 16(2x8) bits raw
+        w->off = ch / 4;
+        sft = ch % 4 * 2;
+        IQ = 1;
+    }
+    w->ns = w->fmt == SDR_FMT_RAW8 ? 1 : 2;
+    w->nbit = 2 * IQ;
+    for (int i = 0; i < 256; i++) {
+        int I = (i >> sft) & 3, Q = (i >> (sft + 2)) & 3;
+        if (w->pack) {
+            w->LUT[i] = (uint16_t)(IQ == 1 ? I : I | (Q << 2));
+        }
+        else {
+            w->LUT[i] = (uint8_t)val[I];
+            if (IQ == 2) w->LUT[i] |= (uint16_t)((uint8_t)val[Q] << 8);
         }
     }
 }
 
-// write IF data to file -------------------------------------------------------
-static int write_file(int fmt, const uint8_t *buff, int size, int ch, int IQ,
-    FILE *fp)
+// demux raw data to output buffer ---------------------------------------------
+//  The I/Q samples are written by one 16-bit LUT access per raw data sample.
+//  The 2-bit codes are packed LSB first (4 I or 2 I/Q samples per byte).
+static void demux_data(writer_t *w, const uint8_t *raw, int size)
 {
-    static int8_t LUT[4][256] = {{0}};
+    const uint8_t *p = raw + w->off;
+    uint8_t *out = w->out + w->nout;
+    int n = size / w->ns;
     
-    
-    if (!LUT[0][0]) {
-        gen_LUT(LUT);
+    if (w->pack) {
+        int k = 8 / w->nbit; // samples per byte
+        for (int i = 0; i < n; i += k) {
+            uint8_t c = 0;
+            for (int j = 0; j < k && i + j < n; j++) {
+                c |= (uint8_t)(w->LUT[p[(i+j)*w->ns]] << (j * w->nbit));
+            }
+            *out++ = c;
+        }
     }
-    int8_t data[size * IQ];
+    else if (w->nbit == 4) {
+        for (int i = 0; i < n; i++, out += 2) {
+            memcpy(out, w->LUT + p[i*w->ns], 2);
+        }
+    }
+    else {
+        for (int i = 0; i < n; i++) {
+            *out++ = (uint8_t)w->LUT[p[i*w->ns]];
+        }
+    }
+    w->nout = (int)(out - w->out);
+}
+
+// write data to output file ---------------------------------------------------
+//  The size should be aligned to ALIGN_IO for direct I/O except for the last
+//  write, for which direct I/O is disabled.
+static void write_data(writer_t *w, const uint8_t *data, int size)
+{
+    int64_t t0 = sdr_get_tick_ns();
     
-    if (fmt == SDR_FMT_RAW8) { // packed 8(4x2) bits raw
-        int pos = ch * 2;
-        for (int i = 0; i < size; i++) {
-            if (IQ == 1) {
-                data[i] = LUT[pos][buff[i]];
-            }
-            else {
-                data[i*2  ] = LUT[pos  ][buff[i]];
-                data[i*2+1] = LUT[pos+1][buff[i]];
-            }
+#ifdef O_DIRECT
+    if (w->direct && size % ALIGN_IO) {
+        fcntl(w->fd, F_SETFL, fcntl(w->fd, F_GETFL) & ~O_DIRECT);
+        w->direct = 0;
+    }
+#endif
+    for (int n = 0, m; n < size; n += m) {
+        if ((m = (int)write(w->fd, data + n, size - n)) <= 0) {
+            fprintf(stderr, "file write error\n");
+            break;
         }
+        w->byte += m;
     }
-    else if (fmt == SDR_FMT_RAW16) { // packed 16(4x4) bits raw
-        int pos = ch % 2 * 2;
-        for (int i = 0, j = ch / 2; i < size; i++, j += 2) {
-            if (IQ == 1) {
-                data[i] = LUT[pos][buff[j]];
+    w->lat = (sdr_get_tick_ns() - t0) * 1e-6;
+    if (w->lat > w->lat_max) w->lat_max = w->lat;
+}
+
+// output file writer thread ---------------------------------------------------
+static void *writer_thread(void *arg)
+{
+    writer_t *w = (writer_t *)arg;
+    blk_que_t *que = w->que;
+    
+    while (1) {
+        pthread_mutex_lock(&que->mtx);
+        while (w->nr >= __atomic_load_n(&que->nw, __ATOMIC_ACQUIRE) &&
+            __atomic_load_n(&que->state, __ATOMIC_ACQUIRE)) {
+            sdr_cond_wait(&que->cond, &que->mtx, TO_WAIT);
+        }
+        int64_t nw = __atomic_load_n(&que->nw, __ATOMIC_ACQUIRE);
+        pthread_mutex_unlock(&que->mtx);
+        
+        if (w->nr >= nw) break; // stopped
+        
+        for (int64_t k = w->nr; k < nw; k++) {
+            int i = (int)(k % NUM_BLK);
+            const uint8_t *blk = que->buff + (size_t)i * BLK_SIZE;
+            
+            if (w->raw) { // write raw data block without copy
+                write_data(w, blk, que->size[i]);
             }
             else {
-                data[i*2  ] = LUT[pos  ][buff[j]];
-                data[i*2+1] = LUT[pos+1][buff[j]];
+                demux_data(w, blk, que->size[i]);
+                if (w->nout >= OUT_SIZE) {
+                    int n = w->nout / ALIGN_IO * ALIGN_IO;
+                    write_data(w, w->out, n);
+                    memmove(w->out, w->out + n, w->nout - n);
+                    w->nout -= n;
+                }
             }
+            // release block to reader
+            pthread_mutex_lock(&que->mtx);
+            __atomic_store_n(&w->nr, k + 1, __ATOMIC_RELEASE);
+            pthread_cond_broadcast(&que->cond);
+            pthread_mutex_unlock(&que->mtx);
         }
     }
-    else { // packed 16(2x8) bits raw
-        int pos = ch % 4;
-        for (int i = 0, j = ch / 4; i < size; i++, j += 2) {
-            data[i] = LUT[pos][buff[j]];
+    if (w->nout > 0) {
+        write_data(w, w->out, w->nout);
+        w->nout = 0;
+    }
+    return NULL;
+}
+
+// wait for free block of queue ------------------------------------------------
+//  It returns 0 if the block is not released by all writers within TO_WAIT ms.
+static int wait_blk(blk_que_t *que, const writer_t *w, int nw)
+{
+    int stat = 1;
+    
+    pthread_mutex_lock(&que->mtx);
+    for (int i = 0; i < nw && stat; i++) {
+        if (w[i].fd < 0 || que->nw - __atomic_load_n(&w[i].nr,
+                __ATOMIC_ACQUIRE) < NUM_BLK) {
+            continue;
         }
+        sdr_cond_wait(&que->cond, &que->mtx, TO_WAIT);
+        stat = que->nw - __atomic_load_n(&w[i].nr, __ATOMIC_ACQUIRE) <
+            NUM_BLK;
     }
-    return (int)fwrite(data, 1, size * IQ, fp);
+    pthread_mutex_unlock(&que->mtx);
+    return stat;
+}
+
+// put block to queue ----------------------------------------------------------
+static void put_blk(blk_que_t *que, int size)
+{
+    pthread_mutex_lock(&que->mtx);
+    que->size[que->nw % NUM_BLK] = size;
+    __atomic_store_n(&que->nw, que->nw + 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&que->cond);
+    pthread_mutex_unlock(&que->mtx);
 }
 
 // print header ----------------------------------------------------------------
-static void print_head(int nfile, FILE **fp)
+static void print_head(int nfile, const writer_t *w)
 {
     fprintf(stderr, "%9s ", "TIME(s)");
     for (int i = 0; i < nfile; i++) {
-        if (fp[i]) fprintf(stderr, " %3s   CH%d(Bytes)", "T", i + 1);
+        if (w[i].fd >= 0) fprintf(stderr, " %3s   CH%d(Bytes)", "T", i + 1);
     }
-    fprintf(stderr, " %12s\n", "RATE(Ks/s)");
+    fprintf(stderr, " %12s %9s %8s\n", "RATE(Ks/s)", "DROP(MB)", "IO(ms)");
 }
 
 // print status ----------------------------------------------------------------
-static void print_stat(int nch, const int *IQ, FILE **fp, double time,
-    const double *byte, double rate)
+static void print_stat(int nch, const int *IQ, writer_t *w, double time,
+    double rate, double drop)
 {
     static const char *str_IQ[] = {"-", "I", "IQ", "I"};
+    double lat = 0.0;
     
     fprintf(stderr, "%9.1f ", time);
     for (int i = 0; i < nch; i++) {
-        if (!fp[i]) continue;
-        fprintf(stderr, " %3s %12.0f", str_IQ[IQ[i]], byte[i]);
+        if (w[i].fd < 0) continue;
+        fprintf(stderr, " %3s %12.0f", str_IQ[IQ[i]], w[i].byte);
+        if (w[i].lat_max > lat) lat = w[i].lat_max;
+        w[i].lat_max = 0.0;
     }
-    fprintf(stderr, " %12.1f\r", rate * 1e-3);
+    fprintf(stderr, " %12.1f %9.1f %8.1f\r", rate * 1e-3, drop * 1e-6, lat);
     fflush(stderr);
 }
 
 // dump digital IF data --------------------------------------------------------
-static void dump_data(sdr_dev_t *dev, double tsec, int quiet, int raw, int fmt,
-    int nfile, const int *IQ, FILE **fp)
+//  The IF data are read from the raw data buffer of the device without
+//  polling and copied to the blocks of the queue. The skipped data by the
+//  overrun of the raw data buffer are counted as drops.
+static void dump_data(sdr_dev_t *dev, double tsec, int quiet, int fmt,
+    int nfile, const int *IQ, writer_t *w)
 {
+    blk_que_t que = {0};
     double time = 0.0, time_p = 0.0, sample = 0.0, sample_p = 0.0;
-    double rate = 0.0, byte[SDR_MAX_RFCH] = {0};
-    int ns = (fmt == SDR_FMT_RAW8) ? 1 : 2;
-    uint8_t buff[SDR_SIZE_BUFF * ns];
+    double rate = 0.0, drop = 0.0;
+    int ns = (fmt == SDR_FMT_RAW8) ? 1 : 2, pos = 0;
+    
+    que.buff = alloc_io((size_t)BLK_SIZE * NUM_BLK);
+    que.state = 1;
+    pthread_mutex_init(&que.mtx, NULL);
+    pthread_cond_init(&que.cond, NULL);
     
+    for (int i = 0; i < nfile; i++) {
+        if (w[i].fd < 0) continue;
+        w[i].que = &que;
+        w[i].out = alloc_io((size_t)OUT_SIZE + BLK_SIZE * 2);
+        pthread_create(&w[i].thread, NULL, writer_thread, w + i);
+    }
     if (!quiet) {
-        print_head(nfile, fp);
+        print_head(nfile, w);
     }
-    uint32_t tick = sdr_get_tick();
-    
-    if (!sdr_dev_start(dev)) return;
+    uint32_t tick = sdr_get_tick(), tick_s = tick;
     
-    for (int i = 0; !intr && (tsec <= 0.0 || time < tsec); i++) {
-        if (!quiet) {
+    if (sdr_dev_start(dev)) {
+        while (!intr && (tsec <= 0.0 || time < tsec)) {
+            uint8_t *data;
+            
             time = (sdr_get_tick() - tick) * 1e-3;
-        }
-        while (sdr_dev_read(dev, buff, SDR_SIZE_BUFF * ns) && !intr) {
-            for (int j = 0; j < nfile; j++) {
-                if (!fp[j]) continue;
-                if (raw) {
-                    byte[j] += fwrite(buff, 1, SDR_SIZE_BUFF * ns, fp[j]);
-                }
-                else {
-                    byte[j] += write_file(fmt, buff, SDR_SIZE_BUFF, j, IQ[j],
-                        fp[j]);
-                }
+            
+            // skip unread data on overrun of raw data buffer
+            drop += (double)sdr_dev_sync(dev, dev->size_buff);
+            
+            if (sdr_dev_wait(dev, ns, TO_WAIT)) {
+                int n = sdr_dev_peek(dev, BLK_SIZE - pos, &data);
+                memcpy(que.buff + (que.nw % NUM_BLK) * BLK_SIZE + pos, data, n);
+                sdr_dev_consume(dev, n);
+                pos += n;
+                sample += n / ns;
+            }
+            if (pos >= BLK_SIZE && wait_blk(&que, w, nfile)) {
+                put_blk(&que, pos);
+                pos = 0;
+            }
+            if (!quiet && time - time_p > RATE_CYC * 1e-3) {
+                rate = (sample - sample_p) / (time - time_p);
+                time_p = time;
+                sample_p = sample;
+            }
+            if (!quiet && (int)(sdr_get_tick() - tick_s) >= STAT_CYC) {
+                print_stat(nfile, IQ, w, time, rate, drop);
+                tick_s = sdr_get_tick();
             }
-            sample += SDR_SIZE_BUFF;
-        }
-        if (!quiet && time - time_p > RATE_CYC * 1e-3) {
-            rate = (sample - sample_p) / (time - time_p);
-            time_p = time;
-            sample_p = sample;
-        }
-        if (!quiet && i % (STAT_CYC / DATA_CYC) == 0) {
-            print_stat(nfile, IQ, fp, time, byte, rate);
         }
-        sdr_sleep_msec(DATA_CYC);
+        sdr_dev_stop(dev);
+    }
+    if (pos > 0) {
+        while (!wait_blk(&que, w, nfile)) ;
+        put_blk(&que, pos);
+    }
+    __atomic_store_n(&que.state, 0, __ATOMIC_RELEASE);
+    for (int i = 0; i < nfile; i++) {
+        if (w[i].fd < 0) continue;
+        pthread_mutex_lock(&que.mtx);
+        pthread_cond_broadcast(&que.cond);
+        pthread_mutex_unlock(&que.mtx);
+        pthread_join(w[i].thread, NULL);
+        free_io(w[i].out);
     }
-    sdr_dev_stop(dev);
-    
     if (!quiet) {
         rate = time > 0.0 ? sample / time : 0.0;
-        print_stat(nfile, IQ, fp, time, byte, rate);
+        print_stat(nfile, IQ, w, time, rate, drop);
         fprintf(stderr, "\n");
     }
+    free_io(que.buff);
 }
 
 // write tag for IF data dump file ---------------------------------------------
@@ -188,7 +428,7 @@ static int write_tag(const char *file, const char *prog, time_t time, int fmt,
     double fs, const double *fo, const int *IQ)
 {
     static const char *fstr[] = {
-        "-", "INT8", "INT8X2", "RAW8", "RAW16", "RAW16I"
+        "-", "INT8", "INT8X2", "RAW8", "RAW16", "RAW16I", "INT2", "INT2X2"
     };
     FILE *fp;
     char path[1024+4], tstr[32];
@@ -204,7 +444,7 @@ static int write_tag(const char *file, const char *prog, time_t time, int fmt,
     fprintf(fp, "TIME = %s\n", tstr);
     fprintf(fp, "FMT  = %s\n", fstr[fmt]);
     fprintf(fp, "F_S  = %.6g\n", fs * 1e-6);
-    if (fmt >= SDR_FMT_RAW8) {
+    if (fmt >= SDR_FMT_RAW8 && fmt <= SDR_FMT_RAW16I) {
         int nch = fmt == SDR_FMT_RAW8 ? 2 : (fmt == SDR_FMT_RAW16 ? 4 : 8);
         fprintf(fp, "F_LO = ");
         for (int j = 0; j < nch; j++) {
@@ -224,8 +464,8 @@ static int write_tag(const char *file, const char *prog, time_t time, int fmt,
 }
 
 // write tag file --------------------------------------------------------------
-static void write_tag_files(time_t time, int raw, int fmt, double fs,
-    const double *fo, const int *IQ, int nch, char **files)
+static void write_tag_files(time_t time, int raw, int pack, int fmt,
+    double fs, const double *fo, const int *IQ, int nch, char **files)
 {
     for (int i = 0; i < (raw ? 1 : nch); i++) {
         if (!files[i] || !*files[i] || !strcmp(files[i], "-")) continue;
@@ -234,7 +474,9 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
             write_tag(files[i], PROG_NAME, time, fmt, fs, fo, IQ);
         }
         else {
-            int fmt_i = IQ[i] == 1 ? SDR_FMT_INT8 : SDR_FMT_INT8X2;
+            int fmt_i = IQ[i] == 1 || fmt == SDR_FMT_RAW16I ?
+                (pack ? FMT_INT2 : SDR_FMT_INT8) :
+                (pack ? FMT_INT2X2 : SDR_FMT_INT8X2);
             write_tag(files[i], PROG_NAME, time, fmt_i, fs, fo + i, IQ + i);
         }
     }
@@ -243,14 +485,20 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
 //------------------------------------------------------------------------------
 //  Synopsis
 //
-//    pocket_dump [-t tsec] [-r] [-p bus[,port]] [-c conf_file] [-q]
-//                [file [file ...]]
+//    pocket_dump [-t tsec] [-r] [-pack] [-p bus[,port]] [-c conf_file]
+//                [-shm name] [-q] [file [file ...]]
 //
 //  Description
 //
 //    Capture and dump digital IF (DIF) data of a Pocket SDR FE device to output
 //    files. To stop capturing, press Ctr-C.
 //
+//    The IF data are read from the device by the main thread and written to
+//    the output files by the writer threads of the files in parallel with
+//    direct I/O if supported. The IF data dropped by the overrun of the raw
+//    data buffer and the peak latency of the file writes are shown in the
+//    status as DROP(MB) and IO(ms).
+//
 //  Options
 //    -t tsec
 //        Data capturing time in seconds.
@@ -259,6 +507,11 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
 //        Dump raw data of the Pocket SDR FE device without channel separation
 //        and quantization.
 //
+//    -pack
+//        Dump the 2-bit sign and magnitude codes of the samples packed LSB
+//        first (4 I samples or 2 I/Q samples per byte) instead of int8
+//        samples. The formats in the tag files are INT2 or INT2X2.
+//
 //    -p bus[,port]
 //        USB bus and port number of the Pocket SDR FE device. Without the
 //        option, the command selects the device firstly found.
@@ -267,6 +520,11 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
 //        Configure the Pocket SDR FE device with a device configuration file
 //        before capturing.
 //
+//    -shm name
+//        Capture digital IF data from the shared memory IF broker of the name
+//        published by pocket_trk with the option -pub instead of the device.
+//        The options -p and -c are ignored.
+//
 //    -q 
 //        Suppress showing data dump status.
 //
@@ -285,13 +543,13 @@ static void write_tag_files(time_t time, int raw, int fmt, double fs,
 //
 int main(int argc, char **argv)
 {
-    FILE *fp[SDR_MAX_RFCH] = {0};
+    static writer_t w[SDR_MAX_RFCH];
     sdr_dev_t *dev;
     char *files[SDR_MAX_RFCH] = {0}, path[SDR_MAX_RFCH][64];
-    const char *conf_file = "";
+    const char *conf_file = "", *shm_name = "";
     time_t dump_time;
     double tsec = 0.0, fs, fo[SDR_MAX_RFCH];
-    int n = 0, bus = -1, port = -1, raw = 0, quiet = 0;
+    int n = 0, bus = -1, port = -1, raw = 0, pack = 0, quiet = 0;
     int nch, fmt, IQ[SDR_MAX_RFCH], nfile;
     
     for (int i = 1; i < argc; i++) {
@@ -301,12 +559,18 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-r")) {
             raw = 1; // raw output
         }
+        else if (!strcmp(argv[i], "-pack")) {
+            pack = 1; // 2-bit packed output
+        }
         else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
             sscanf(argv[++i], "%d,%d", &bus, &port);
         }
         else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
             conf_file = argv[++i];
         }
+        else if (!strcmp(argv[i], "-shm") && i + 1 < argc) {
+            shm_name = argv[++i];
+        }
         else if (!strcmp(argv[i], "-q")) {
             quiet = 1;
         }
@@ -317,10 +581,15 @@ int main(int argc, char **argv)
             files[n++] = argv[i];
         }
     }
-    if (!(dev = sdr_dev_open(bus, port))) {
+    if (*shm_name) {
+        if (!(dev = sdr_dev_attach(shm_name))) {
+            return -1;
+        }
+    }
+    else if (!(dev = sdr_dev_open(bus, port))) {
         return -1;
     }
-    if (*conf_file) {
+    else if (*conf_file) {
         if (!sdr_conf_write(dev, conf_file, 0)) {
             sdr_dev_close(dev);
             return -1;
@@ -343,15 +612,13 @@ int main(int argc, char **argv)
         }
     }
     for (int i = 0; i < nfile; i++) {
-        if (!files[i]) continue;
-        if (!strcmp(files[i], "-")) {
-#ifdef WIN32 // set binary mode for Windows
-            _setmode(_fileno(stdout), _O_BINARY);
-#endif
-            fp[i] = stdout;
-        }
-        else if (*files[i] && !(fp[i] = fopen(files[i], "wb"))) {
-            fprintf(stderr, "file open error %s\n", files[i]);
+        w[i].fd = -1;
+        w[i].fmt = fmt;
+        w[i].raw = raw;
+        w[i].pack = pack;
+        if (!raw) gen_LUT(w + i, i, IQ[i]);
+        if (!files[i] || !*files[i]) continue;
+        if ((w[i].fd = open_file(files[i], &w[i].direct)) < 0) {
             sdr_dev_close(dev);
             return -1;
         }
@@ -359,14 +626,14 @@ int main(int argc, char **argv)
     signal(SIGTERM, sig_func);
     signal(SIGINT, sig_func);
     
-    dump_data(dev, tsec, quiet, raw, fmt, nfile, IQ, fp);
+    dump_data(dev, tsec, quiet, fmt, nfile, IQ, w);
     
     for (int i = 0; i < nfile; i++) {
-        if (fp[i]) fclose(fp[i]);
+        if (w[i].fd >= 0 && w[i].fd != fileno(stdout)) close(w[i].fd);
     }
     sdr_dev_close(dev);
     
-    write_tag_files(dump_time, raw, fmt, fs, fo, IQ, nch, files);
+    write_tag_files(dump_time, raw, pack, fmt, fs, fo, IQ, nch, files);
     
     return 0;
 }
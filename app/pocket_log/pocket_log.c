@@ -0,0 +1,78 @@
+//
+//  Pocket SDR C AP - Binary Log Converter.
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//
+#include "pocket_sdr.h"
+
+// constants and macro ---------------------------------------------------------
+#define PROG_NAME       "pocket_log" // program name
+
+// show usage ------------------------------------------------------------------
+static void show_usage(void)
+{
+    printf("Usage: %s [-out file] file\n", PROG_NAME);
+    exit(0);
+}
+
+//------------------------------------------------------------------------------
+//  Synopsis
+//
+//    pocket_log [-out file] file
+//
+//  Description
+//
+//    Convert a binary log written by pocket_trk with -logbin option to the
+//    text log. The text log is as same as the one written without -logbin
+//    option. So it can be plotted by pocket_plot.py.
+//
+//  Options
+//
+//    -out file
+//        Output text log file. Without the option, the text log is written to
+//        stdout.
+//
+//    file
+//        Input binary log file.
+//
+int main(int argc, char **argv)
+{
+    FILE *ifp, *ofp = stdout;
+    const char *file = "", *out_file = "";
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-out") && i + 1 < argc) {
+            out_file = argv[++i];
+        }
+        else if (!strncmp(argv[i], "-", 1)) {
+            show_usage();
+        }
+        else {
+            file = argv[i];
+        }
+    }
+    if (!*file) {
+        show_usage();
+    }
+    if (!(ifp = fopen(file, "rb"))) {
+        fprintf(stderr, "file open error: %s\n", file);
+        return -1;
+    }
+    if (*out_file && !(ofp = fopen(out_file, "wb"))) {
+        fprintf(stderr, "file open error: %s\n", out_file);
+        fclose(ifp);
+        return -1;
+    }
+    int nrec = sdr_log_conv(ifp, ofp);
+    
+    fclose(ifp);
+    if (*out_file) {
+        fclose(ofp);
+        printf("%d log records converted.\n", nrec);
+    }
+    return 0;
+}
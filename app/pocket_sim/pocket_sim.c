@@ -0,0 +1,291 @@
+//
+//  Pocket SDR C AP - Synthetic IF Data Generator.
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//
+#include "pocket_sdr.h"
+
+// constants and macro ---------------------------------------------------------
+#define PROG_NAME       "pocket_sim" // program name
+#define DATA_CYC        10      // data generation cycle (ms)
+#define LEN_NAV         1000    // length of nav data symbols
+
+// show usage ------------------------------------------------------------------
+static void show_usage(void)
+{
+    printf("Usage: %s [-sig sig -prn prn[,...] ...] [-fmt fmt] [-f freq]\n"
+        "    [-fo freq[,freq...]] [-IQ n[,n...]] [-cn0 cn0] [-dop dop]\n"
+        "    [-rate rate] [-nav ncyc] [-tlen tlen] [-seed seed] [-th nthread]\n"
+        "    [-truth file] file\n", PROG_NAME);
+    exit(0);
+}
+
+// uniform random number in [a, b) ---------------------------------------------
+static double rand_uni(double a, double b)
+{
+    return a + (b - a) * rand() / (RAND_MAX + 1.0);
+}
+
+// write tag for IF data file --------------------------------------------------
+static int write_tag(const char *file, int fmt, double fs, const double *fo,
+    const int *IQ)
+{
+    static const char *fstr[] = {"-", "INT8", "INT8X2", "RAW8", "RAW16"};
+    FILE *fp;
+    char path[1024+4], tstr[32];
+    time_t time_now = time(NULL);
+    int nch = fmt == SDR_FMT_RAW8 ? 2 : (fmt == SDR_FMT_RAW16 ? 4 : 1);
+    
+    snprintf(path, sizeof(path), "%s.tag", file);
+    strftime(tstr, sizeof(tstr), "%Y-%m-%dT%H:%M:%SZ", gmtime(&time_now));
+    
+    if (!(fp = fopen(path, "w"))) {
+        fprintf(stderr, "tag file open error %s\n", path);
+        return 0;
+    }
+    fprintf(fp, "PROG = %s\n", PROG_NAME);
+    fprintf(fp, "TIME = %s\n", tstr);
+    fprintf(fp, "FMT  = %s\n", fstr[fmt]);
+    fprintf(fp, "F_S  = %.6g\n", fs * 1e-6);
+    fprintf(fp, "F_LO = ");
+    for (int j = 0; j < nch; j++) {
+        fprintf(fp, "%.6g%s", fo[j] * 1e-6, j < nch - 1 ? "," : "\n");
+    }
+    fprintf(fp, "IQ   = ");
+    for (int j = 0; j < nch; j++) {
+        fprintf(fp, "%d%s", fmt == SDR_FMT_INT8 ? 1 :
+            (fmt == SDR_FMT_INT8X2 ? 2 : IQ[j]), j < nch - 1 ? "," : "\n");
+    }
+    fclose(fp);
+    return 1;
+}
+
+// write ground truth of satellite signals -------------------------------------
+static int write_truth(const char *file, const sdr_sim_t *sim)
+{
+    FILE *fp;
+    
+    if (!(fp = fopen(file, "w"))) {
+        fprintf(stderr, "truth file open error %s\n", file);
+        return 0;
+    }
+    fprintf(fp, "%% %-6s %4s %4s %12s %10s %6s %12s\n", "SIG", "PRN", "RFCH",
+        "DOP(Hz)", "RATE(Hz/s)", "C/N0", "COFF(ms)");
+    for (int i = 0; i < sim->nsat; i++) {
+        const sdr_sim_sat_t *sat = sim->sats + i;
+        fprintf(fp, "  %-6s %4d %4d %12.3f %10.4f %6.1f %12.9f\n", sat->sig,
+            sat->prn, sat->rfch + 1, sat->dop, sat->rate, sat->cn0,
+            sat->coff * 1e3);
+    }
+    fclose(fp);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Synopsis
+//
+//    pocket_sim [-sig sig -prn prn[,...] ...] [-fmt fmt] [-f freq]
+//        [-fo freq[,freq...]] [-IQ n[,n...]] [-cn0 cn0] [-dop dop]
+//        [-rate rate] [-nav ncyc] [-tlen tlen] [-seed seed] [-th nthread]
+//        [-truth file] file
+//
+//  Description
+//
+//    Generate a synthetic IF data file of GNSS signals by the IF signal
+//    simulator of libsdr for load and scaling tests of pocket_trk. The
+//    Doppler frequencies, the Doppler rates and the code offsets of the
+//    signals are random in the ranges and written to the ground truth file.
+//    The tag file of the IF data file is also written.
+//
+//  Options ([]: default)
+//
+//    -sig sig -prn prn[,...] ...
+//        Signal type and PRN numbers as same as pocket_trk. [L1CA 1-32]
+//
+//    -fmt fmt
+//        IF data format (INT8, INT8X2, RAW8 or RAW16). [RAW8]
+//
+//    -f freq
+//        Sampling frequency of IF data in MHz. [24.0]
+//
+//    -fo freq[,freq...]
+//        LO frequencies of RF channels in MHz. [1575.42,1227.6,1176.45,1268.52]
+//
+//    -IQ n[,n...]
+//        Sampling types of RF channels (1:I, 2:IQ). [2,2,2,2]
+//
+//    -cn0 cn0
+//        C/N0 of the signals in dB-Hz. [45.0]
+//
+//    -dop dop
+//        Max Doppler frequency in Hz. [5000.0]
+//
+//    -rate rate
+//        Max Doppler frequency rate in Hz/s. [0.0]
+//
+//    -nav ncyc
+//        Modulate random nav data symbols of ncyc code cycles per symbol
+//        (0: no nav data). [0]
+//
+//    -tlen tlen
+//        Time length of IF data in s. [60.0]
+//
+//    -seed seed
+//        Seed of the random numbers and the noise. [1]
+//
+//    -th nthread
+//        Number of threads (0: number of CPU cores). [0]
+//
+//    -truth file
+//        Output ground truth file of the signals. [no output]
+//
+//    file
+//        Output IF data file.
+//
+int main(int argc, char **argv)
+{
+    static const char *sigs[SDR_MAX_NCH];
+    static int prns[SDR_MAX_NCH];
+    const char *sig = "L1CA", *file = "", *truth_file = "";
+    double fs = 24e6, fo[SDR_MAX_RFCH] = {1575.42e6, 1227.6e6, 1176.45e6,
+        1268.52e6};
+    double cn0 = 45.0, max_dop = 5000.0, max_rate = 0.0, tlen = 60.0;
+    int fmt = SDR_FMT_RAW8, IQ[SDR_MAX_RFCH] = {2, 2, 2, 2}, nch = 0, ncyc = 0;
+    int seed = 1, nthread = 0;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-sig") && i + 1 < argc) {
+            sig = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-prn") && i + 1 < argc) {
+            int nums[SDR_MAX_NCH];
+            int n = sdr_parse_nums(argv[++i], nums);
+            for (int j = 0; j < n && nch < SDR_MAX_NCH; j++) {
+                sigs[nch] = sig;
+                prns[nch++] = nums[j];
+            }
+        }
+        else if (!strcmp(argv[i], "-fmt") && i + 1 < argc) {
+            const char *format = argv[++i];
+            if      (!strcmp(format, "INT8"  )) fmt = SDR_FMT_INT8;
+            else if (!strcmp(format, "INT8X2")) fmt = SDR_FMT_INT8X2;
+            else if (!strcmp(format, "RAW8"  )) fmt = SDR_FMT_RAW8;
+            else if (!strcmp(format, "RAW16" )) fmt = SDR_FMT_RAW16;
+            else {
+                fprintf(stderr, "unsupported format: %s\n", format);
+                return -1;
+            }
+        }
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            fs = atof(argv[++i]) * 1e6;
+        }
+        else if (!strcmp(argv[i], "-fo") && i + 1 < argc) {
+            int n = sscanf(argv[++i], "%lf,%lf,%lf,%lf,%lf,%lf,%lf,%lf", fo,
+                fo + 1, fo + 2, fo + 3, fo + 4, fo + 5, fo + 6, fo + 7);
+            for (int j = 0; j < n; j++) fo[j] *= 1e6;
+        }
+        else if (!strcmp(argv[i], "-IQ") && i + 1 < argc) {
+            sscanf(argv[++i], "%d,%d,%d,%d,%d,%d,%d,%d", IQ, IQ + 1, IQ + 2,
+                IQ + 3, IQ + 4, IQ + 5, IQ + 6, IQ + 7);
+        }
+        else if (!strcmp(argv[i], "-cn0") && i + 1 < argc) {
+            cn0 = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-dop") && i + 1 < argc) {
+            max_dop = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-rate") && i + 1 < argc) {
+            max_rate = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-nav") && i + 1 < argc) {
+            ncyc = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-tlen") && i + 1 < argc) {
+            tlen = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-seed") && i + 1 < argc) {
+            seed = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-th") && i + 1 < argc) {
+            nthread = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-truth") && i + 1 < argc) {
+            truth_file = argv[++i];
+        }
+        else if (!strncmp(argv[i], "-", 1)) {
+            show_usage();
+        }
+        else {
+            file = argv[i];
+        }
+    }
+    if (!*file) {
+        show_usage();
+    }
+    if (nch <= 0) {
+        for ( ; nch < 32; nch++) {
+            sigs[nch] = sig;
+            prns[nch] = nch + 1;
+        }
+    }
+    sdr_sim_t *sim = sdr_sim_new(fmt, fs, fo, IQ, (uint32_t)seed, nthread);
+    if (!sim) {
+        return -1;
+    }
+    srand((unsigned int)seed);
+    uint8_t *data = (uint8_t *)sdr_malloc(LEN_NAV);
+    
+    for (int i = 0; i < nch; i++) {
+        for (int j = 0; j < LEN_NAV; j++) {
+            data[j] = rand() % 2;
+        }
+        double dop = rand_uni(-max_dop, max_dop);
+        double rate = rand_uni(-max_rate, max_rate);
+        double coff = rand_uni(0.0, sdr_code_cyc(sigs[i]));
+        if (!sdr_sim_add_sat(sim, sigs[i], prns[i], dop, rate, cn0, coff,
+            ncyc > 0 ? data : NULL, LEN_NAV, ncyc)) {
+            sdr_free(data);
+            sdr_sim_free(sim);
+            return -1;
+        }
+    }
+    sdr_free(data);
+    
+    if (*truth_file && !write_truth(truth_file, sim)) {
+        sdr_sim_free(sim);
+        return -1;
+    }
+    FILE *fp = fopen(file, "wb");
+    if (!fp) {
+        fprintf(stderr, "file open error: %s\n", file);
+        sdr_sim_free(sim);
+        return -1;
+    }
+    write_tag(file, fmt, fs, fo, IQ);
+    
+    int N = (int)(fs * DATA_CYC * 1e-3);
+    uint8_t *raw = (uint8_t *)sdr_malloc(N * 2);
+    int64_t ns = (int64_t)(fs * tlen);
+    uint32_t tick = sdr_get_tick();
+    
+    for (int64_t ix = 0; ix < ns; ix += N) {
+        int n = (int)(ns - ix < N ? ns - ix : N);
+        int size = sdr_sim_gen(sim, n, raw);
+        if ((int)fwrite(raw, 1, size, fp) < size) {
+            fprintf(stderr, "file write error: %s\n", file);
+            break;
+        }
+    }
+    double t = (sdr_get_tick() - tick) * 1e-3;
+    printf("%d signals, %.3f s IF data generated in %.3f s (x%.1f real-time)\n",
+        sim->nsat, tlen, t, t > 0.0 ? tlen / t : 0.0);
+    
+    fclose(fp);
+    sdr_free(raw);
+    sdr_sim_free(sim);
+    return 0;
+}
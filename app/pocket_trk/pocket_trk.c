@@ -21,6 +21,26 @@
 //                   delete input from stdin
 //  2024-07-02  1.8  add -fo, -raw option, delete -fi option
 //                   support tag file input for auto-configuration
+//  2026-10-14  1.13 support max speed replay by -tscale 0
+//                   add -seg option for batch processing in parallel
+//                   add -cb option for code book file
+//                   add -nco option for code NCO
+//                   add -srch option for signal search slots
+//                   add -pack option for packed IF data buffers
+//                   add -usb, -cpu and -pri options for USB transfer buffers
+//                   and CPU affinity and priority of threads
+//                   add -logbin option for binary log
+//                   add -perf option for performance status
+//                   add -fast and -frate options for fast-rate PVT solutions
+//                   multiple stream paths separated by '+' for output streams
+//                   multiple -p and -c options for multiple SDR devices
+//                   add -pub and -shm options for shared memory IF broker
+//                   add -npub and -net options for network IF stream
+//                   add -state option for warm-start state file
+//                   add -live option for budget of live channels
+//                   add frame header option to -usb option
+//                   add -mem option for hugepages, NUMA-local placement and
+//                   locking of large memory, memory placement in -perf
 //
 #include <math.h>
 #include <signal.h>
@@ -29,6 +49,7 @@
 // constants and macros ---------------------------------------------------------
 #define TRACE_LEVEL 2           // debug trace level
 #define FFTW_WISDOM "../python/fftw_wisdom.txt"
+#define FAST_RATE  50.0         // default fast-rate PVT output rate (Hz)
 #define NUM_COL    110          // number of channel status columns
 #define MAX_ROW    108          // max number of channel status rows
 #define ESC_COL    "\033[34m"   // ANSI escape color blue
@@ -41,8 +62,14 @@
 static const char *usage_text[] = {
     "Usage: pocket_trk [-sig sig -prn prn[,...] ...] [-fmt {INT8|INT8X2|RAW8|RAW16}]",
     "       [-f freq] [-fo freq[,...]] [-IQ {1|2}[,...]] [-toff toff] [-ti tint]",
-    "       [-p bus,[,port] [-c conf_file] [-log path] [-nmea path] [-rtcm path]",
-    "       [-raw path] [-w file] [file]", NULL
+    "       [-p bus,[,port] [-c conf_file] [-log path] [-logbin] [-nmea path]",
+    "       [-rtcm path] [-raw path] [-w file] [-cb file] [-seg tseg[,tovl[,nrun]]]",
+    "       [-nco sig[,...]] [-srch nsrch] [-pack] [-usb nbuff[,size[,frm]]]",
+    "       [-cpu ucpu[,rcpu[,wcpu]]] [-pri upri[,rpri[,wpri]]] [-perf]",
+    "       [-fast path] [-frate rate] [-pub name] [-shm name]",
+    "       [-npub addr] [-net addr] [-state file] [-live nlive]",
+    "       [-mem huge[,numa[,lock]]] [file]",
+    NULL
 };
 
 // interrupt flag --------------------------------------------------------------
@@ -94,14 +121,51 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
     return n;
 }
 
+// print performance status ----------------------------------------------------
+static void print_perf_stat(sdr_rcv_t *rcv)
+{
+    static const char *stage[] = {
+        "READ", "WRITE", "SRCH", "TRK", "NAV", "DEC", "PVT"
+    };
+    static double stat[SDR_N_PERF * 5 + 5 + SDR_N_MEM + SDR_MAX_NCH];
+    int n = sdr_rcv_perf_stat(rcv, stat);
+    
+    if (n <= 0) return;
+    printf("  %-6s %12s %10s %10s %10s %10s\n", "STAGE", "N", "AVE(us)",
+        "P50(us)", "P99(us)", "MAX(us)");
+    for (int i = 0; i < SDR_N_PERF; i++) {
+        const double *p = stat + i * 5;
+        printf("  %-6s %12.0f %10.2f %10.2f %10.2f %10.2f\n", stage[i], p[0],
+            p[1], p[2], p[3], p[4]);
+    }
+    const double *q = stat + SDR_N_PERF * 5;
+    printf("  BUFF(%%) = %.1f/%.1f, DEC JOBS = %.0f, PVT NAVQ = %.0f, "
+        "OUT QUEUE(bytes) = %.0f\n", q[0], q[1], q[2], q[3], q[4]);
+    const double *m = q + 5;
+    printf("  MEM(MB) = %.1f, 4K = %.1f, THP = %.1f, 2M = %.1f, 1G = %.1f, "
+        "LOCK = %.1f, NUMA = %.1f, NODES = %.0f\n", m[0], m[1], m[2], m[3],
+        m[4], m[5], m[6], m[7]);
+    printf("  CPU(%%) =");
+    for (int i = 0; i < n - SDR_N_PERF * 5 - 5 - SDR_N_MEM; i++) {
+        printf("%s CH%d:%.1f", i > 0 && i % 10 == 0 ? "\n          " : "",
+            i + 1, m[SDR_N_MEM+i]);
+    }
+    printf("\n");
+}
+
 //------------------------------------------------------------------------------
 //
 //   Synopsis
 //
 //     pocket_trk [-sig sig -prn prn[,...] ...] [-fmt {INT8|INT8X2|RAW8|RAW16}]
 //         [-f freq] [-fo freq[,...]] [-IQ {1|2}[,...]] [-toff toff] [-ti tint]
-//         [-p bus,[,port] [-c conf_file] [-log path] [-nmea path] [-rtcm path]
-//         [-raw path] [-w file] [file]
+//         [-p bus,[,port] [-c conf_file] [-log path] [-logbin] [-nmea path]
+//         [-rtcm path] [-raw path] [-w file] [-cb file] [-seg tseg[,tovl[,nrun]]]
+//         [-nco sig[,...]] [-srch nsrch] [-pack] [-usb nbuff[,size[,frm]]]
+//         [-cpu ucpu[,rcpu[,wcpu]]] [-pri upri[,rpri[,wpri]]] [-perf]
+//         [-fast path] [-frate rate] [-pub name] [-shm name]
+//         [-npub addr] [-net addr] [-state file] [-live nlive]
+//         [-mem huge[,numa[,lock]]] [file]
 //
 //   Description
 //
@@ -146,7 +210,9 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //         Time offset from the start of the IF data in s. [0.0]
 //
 //     -tscale scale
-//         Time scale to replay the IF data file. [1.0]
+//         Time scale to replay the IF data file. If 0 specified, the IF data
+//         file is replayed at max speed with waiting for all channels updated.
+//         [1.0]
 //
 //     -ti tint
 //         Update interval of the signal tracking status in seconds. If 0
@@ -154,11 +220,14 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //
 //     -p bus[,port]
 //         USB bus and port number of the Pocket SDR FE device in case of IF data
-//         input from the device.
+//         input from the device. Repeat the option up to 4 times to aggregate
+//         multiple devices sharing the reference clock into the receiver. The
+//         RF channels of the devices are numbered in the order of the options.
 //
 //     -c conf_file
 //         Configure the Pocket SDR FE device with a device configuration file
-//         before signal acquisition and tracking.
+//         before signal acquisition and tracking. For multiple devices, the
+//         n-th -c option is applied to the device of the n-th -p option.
 //
 //     -log path
 //         A stream path to write the signal tracking log. The log includes
@@ -170,13 +239,23 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //         (2) TCP server  :port
 //         (3) TCP client  address:port
 //
+//         Multiple stream paths separated by '+' write the same data to all
+//         of the streams (up to 8).
+//
+//     -logbin
+//         Write the log in the binary format without formatting the log
+//         records. It reduces the CPU load and the size of the log. The binary
+//         log is converted to the text log by pocket_log. [no]
+//
 //     -nmea path
 //         A stream path to write PVT solutions as NMEA GNRMC, GNGGA and GNGSV
 //         sentences. The stream path is as same as the -log option.
 //         
 //     -rtcm path
 //         A stream path to write raw observation and navigation data as RTCM3.3
-//         messages. The stream path is as same as the -log option.
+//         messages. The MSM7 messages of an epoch are encoded once and written
+//         to the streams together. The stream path is as same as the -log
+//         option.
 //
 //     -raw path
 //         A stream path to write raw IF data. The stream path is as same as the
@@ -185,6 +264,128 @@ static int print_rcv_stat(sdr_rcv_t *rcv, int nrow)
 //     -w file
 //         Specify the FFTW wisdowm file. [../python/fftw_wisdom.txt]
 //
+//     -cb file
+//         Specify the code book file to cache the code FFTs and the resampled
+//         codes of signals over runs. [no code book file]
+//
+//     -seg tseg[,tovl[,nrun]]
+//         Batch processing of the IF data file in parallel over time segments.
+//         The IF data file is split into segments of tseg seconds, and each
+//         segment is processed at max speed by an independent receiver
+//         starting tovl seconds before the segment to acquire signals and
+//         decode navigation data. nrun is the max number of segments processed
+//         in parallel (0: number of CPU cores). The NMEA and RTCM3 outputs of
+//         the segments are merged in time order. The signal tracking status,
+//         the log stream and the raw IF data stream are not available.
+//         [tseg,30,0]
+//
+//     -nco sig[,...]
+//         Specify the signal IDs tracked with the code NCO. The code replica of
+//         the signals is generated for each correlation at the exact code phase
+//         and the code rate with Doppler instead of the bank of the resampled
+//         codes. It reduces the memory for the long code signals. The L6D and
+//         L6E signals are not supported. [no signal]
+//
+//     -srch nsrch
+//         Specify the max number of channels searching signals at the same
+//         time. The re-acquisition and the assisted acquisition are searched
+//         before the blind search. The number is reduced by the IF data buffer
+//         usage. [4]
+//
+//     -pack
+//         Store 2-bit raw IF data of RAW8 or RAW16 format packed in the IF data
+//         buffers with two samples per byte. It halves the memory and the
+//         memory bandwidth of the IF data buffers. [no]
+//
+//     -usb nbuff[,size[,frm]]
+//         Specify the number and the size (bytes, multiple of 1024) of the USB
+//         transfer buffers submitted to the Pocket SDR FE device. The number
+//         of 0 sets the buffers to 0.2 s of the raw IF data. frm = 1 enables
+//         the frame headers of the USB transfers with the sample counter to
+//         detect lost IF data, if supported by the device F/W. [0,65536,0]
+//
+//     -cpu ucpu[,rcpu[,wcpu]]
+//         Specify CPU cores to pin the USB event handler thread, the receiver
+//         thread and the worker threads. The worker threads are pinned to the
+//         consecutive CPU cores from wcpu. -1 means not pinned. [-1,-1,-1]
+//
+//     -pri upri[,rpri[,wpri]]
+//         Specify real-time priorities (1-99) of the USB event handler thread,
+//         the receiver thread and the worker threads. 0 means the default
+//         priority. Root privilege may be required. [99,0,0]
+//
+//     -perf
+//         Print the performance status at the end: the number of samples, the
+//         average, the median, the 99th percentile and the max of the elapsed
+//         times of the stages (READ: read IF data, WRITE: write IF data
+//         buffers, SRCH: search signal, TRK: track channel block, NAV: decode
+//         navigation data, DEC: decoder thread job, PVT: update PVT solution),
+//         the queue depths, the memory placement and the CPU load of each
+//         channel. [no]
+//
+//     -fast path
+//         A stream path to write fast-rate PVT solutions as binary records
+//         between the PVT epochs. The solutions are updated by the code offsets
+//         and the carrier phases of the latest tracking states extrapolated by
+//         the Doppler frequencies. The stream path is as same as the -log
+//         option. The record format is described in sdr_pvt.c. The option is
+//         not available with -seg. [no output]
+//
+//     -frate rate
+//         Specify the output rate of the fast-rate PVT solutions in Hz. [50]
+//
+//     -pub name
+//         Publish the IF data of the Pocket SDR FE device as a shared memory IF
+//         broker of the name to be read by other processes with the option
+//         -shm without their own USB claims. For multiple devices, the names
+//         of the second or later devices are name_2, name_3, ... [no]
+//
+//     -shm name
+//         Input IF data from the shared memory IF broker of the name published
+//         by another pocket_trk with the option -pub instead of the device.
+//         The device settings by the options -p and -c are not available.
+//
+//     -npub addr
+//         Stream the IF data of the Pocket SDR FE device to the network to be
+//         read by other pocket_trk with the option -net on the same or other
+//         hosts. The address is udp://host:port to send UDP packets to the
+//         host (unicast or multicast) or tcp://:port to listen at the port for
+//         a reader. For multiple devices, the ports of the second or later
+//         devices are port+1, port+2, ... [no]
+//
+//     -net addr
+//         Input IF data from the network IF stream streamed by another
+//         pocket_trk with the option -npub instead of the device. The address
+//         is udp://:port (or udp://group:port for multicast) for UDP or
+//         tcp://host:port for TCP. The IF data lost in the network are
+//         detected by the sequence numbers of the packets as IF data gaps.
+//
+//     -state file
+//         Warm-start state file. The receiver position, the clock drift, the
+//         ephemerides and the Doppler frequencies of the locked channels are
+//         saved to the file every 60 s with PVT solutions and at exit. At
+//         start, the state in the file is loaded to predict the Doppler
+//         frequencies of the visible satellites for the signal acquisition
+//         assist without blind search. The system clock should be accurate
+//         within several seconds. [no]
+//
+//     -live nlive
+//         Specify the max number of live channels holding the code books. The
+//         other channels are put to sleep with the code books released and
+//         woken for the signal search in the budget. The channels of the
+//         satellites predicted below the elevation mask or unhealthy by PVT
+//         are also put to sleep. It reduces the memory for the configurations
+//         of many signals and satellites. 0 means all channels live. [0]
+//
+//     -mem huge[,numa[,lock]]
+//         Specify the pages of the large memory as the IF data buffers and the
+//         raw data buffers (huge = 0: 4 KB pages, 1: 2 MB hugepages, 2: 1 GB
+//         hugepages). The hugepages should be reserved by the OS. Otherwise
+//         the transparent hugepages are used. numa = 1 binds the IF data
+//         buffers to the NUMA nodes of the worker threads pinned by the -cpu
+//         option. lock = 1 locks the large memory in RAM to avoid page faults
+//         in real-time operation. Linux only. [0,0,0]
+//
 //     [file]
 //         A file path of the input IF data. The Pocket SDR FE deveice and
 //         pocket_dump can be used to capture such digitized IF data.
@@ -205,12 +406,21 @@ int main(int argc, char **argv)
     sdr_rcv_t *rcv;
     int prns[SDR_MAX_NCH], nch = 0, fmt = SDR_FMT_INT8X2;
     int IQ[SDR_MAX_RFCH] = {2, 2, 2, 2, 2, 2, 2, 2};
-    int dev_type = SDR_DEV_FILE, bus = -1, port = -1, nrow = 0;
+    int dev_type = SDR_DEV_FILE, nrow = 0, ndev = 0, nconf = 0;
+    int bus[SDR_MAX_DEV] = {-1, -1, -1, -1};
+    int port[SDR_MAX_DEV] = {-1, -1, -1, -1};
     double fs = 12.0, fo[SDR_MAX_RFCH] = {0}, toff = 0.0, tscale = 1.0;
-    double tint = 0.1;
+    double tint = 0.1, tseg = 0.0, tovl = 30.0;
+    int nrun = 0, usb[3] = {0}, cpu[3] = {-1, -1, -1}, pri[3] = {99, 0, 0};
+    int perf = 0, mem[3] = {0};
+    double frate = FAST_RATE;
     const char *sig = "L1CA", *sigs[SDR_MAX_NCH];
-    const char *file = "", *fftw_wisdom = FFTW_WISDOM, *conf_file = "";
-    const char *paths[4] = {"", "", "", ""}, *debug_file = "";
+    const char *file = "", *fftw_wisdom = FFTW_WISDOM;
+    const char *conf_files[SDR_MAX_DEV] = {"", "", "", ""};
+    const char *paths[5] = {"", "", "", "", ""}, *debug_file = "";
+    const char *cb_file = "";
+    const char *nco_sigs = "";
+    const char *shm_name = "", *net_addr = "";
     
     for (int i = 1; i < argc; i++) {
         if (!strcmp(argv[i], "-sig") && i + 1 < argc) {
@@ -258,10 +468,15 @@ int main(int argc, char **argv)
             tint = atof(argv[++i]);
         }
         else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
-            sscanf(argv[++i], "%d,%d", &bus, &port);
+            const char *p = argv[++i];
+            if (ndev < SDR_MAX_DEV) {
+                sscanf(p, "%d,%d", bus + ndev, port + ndev);
+                ndev++;
+            }
         }
         else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
-            conf_file = argv[++i];
+            const char *p = argv[++i];
+            if (nconf < SDR_MAX_DEV) conf_files[nconf++] = p;
         }
         else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
             fftw_wisdom = argv[++i];
@@ -269,6 +484,9 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-log") && i + 1 < argc) {
             paths[0] = argv[++i];
         }
+        else if (!strcmp(argv[i], "-logbin")) {
+            sdr_log_format(SDR_LOG_BIN);
+        }
         else if (!strcmp(argv[i], "-nmea") && i + 1 < argc) {
             paths[1] = argv[++i];
         }
@@ -278,6 +496,60 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-raw") && i + 1 < argc) {
             paths[3] = argv[++i];
         }
+        else if (!strcmp(argv[i], "-cb") && i + 1 < argc) {
+            cb_file = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-seg") && i + 1 < argc) {
+            sscanf(argv[++i], "%lf,%lf,%d", &tseg, &tovl, &nrun);
+        }
+        else if (!strcmp(argv[i], "-nco") && i + 1 < argc) {
+            nco_sigs = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-srch") && i + 1 < argc) {
+            sdr_rcv_setopt("n_srch", atof(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-pack")) {
+            sdr_rcv_setopt("pack_buff", 1);
+        }
+        else if (!strcmp(argv[i], "-usb") && i + 1 < argc) {
+            sscanf(argv[++i], "%d,%d,%d", usb, usb + 1, usb + 2);
+        }
+        else if (!strcmp(argv[i], "-cpu") && i + 1 < argc) {
+            sscanf(argv[++i], "%d,%d,%d", cpu, cpu + 1, cpu + 2);
+        }
+        else if (!strcmp(argv[i], "-pri") && i + 1 < argc) {
+            sscanf(argv[++i], "%d,%d,%d", pri, pri + 1, pri + 2);
+        }
+        else if (!strcmp(argv[i], "-perf")) {
+            perf = 1;
+        }
+        else if (!strcmp(argv[i], "-fast") && i + 1 < argc) {
+            paths[4] = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-frate") && i + 1 < argc) {
+            frate = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-pub") && i + 1 < argc) {
+            sdr_rcv_setopt_str("shm_pub", argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-shm") && i + 1 < argc) {
+            shm_name = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-npub") && i + 1 < argc) {
+            sdr_rcv_setopt_str("net_pub", argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-net") && i + 1 < argc) {
+            net_addr = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-state") && i + 1 < argc) {
+            sdr_rcv_setopt_str("state", argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-live") && i + 1 < argc) {
+            sdr_rcv_setopt("n_live", atof(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-mem") && i + 1 < argc) {
+            sscanf(argv[++i], "%d,%d,%d", mem, mem + 1, mem + 2);
+        }
         else if (!strcmp(argv[i], "-debug") && i + 1 < argc) {
             debug_file = argv[++i];
         }
@@ -292,7 +564,24 @@ int main(int argc, char **argv)
         traceopen(debug_file);
         tracelevel(TRACE_LEVEL);
     }
+    sdr_rcv_setopt("usb_nbuff", usb[0]);
+    sdr_rcv_setopt("usb_size" , usb[1]);
+    sdr_rcv_setopt("usb_frame", usb[2]);
+    sdr_rcv_setopt("usb_cpu"  , cpu[0]);
+    sdr_rcv_setopt("rcv_cpu"  , cpu[1]);
+    sdr_rcv_setopt("work_cpu" , cpu[2]);
+    sdr_rcv_setopt("usb_pri"  , pri[0]);
+    sdr_rcv_setopt("rcv_pri"  , pri[1]);
+    sdr_rcv_setopt("work_pri" , pri[2]);
+    sdr_rcv_setopt("mem_huge" , mem[0]);
+    sdr_rcv_setopt("mem_numa" , mem[1]);
+    sdr_rcv_setopt("mem_lock" , mem[2]);
+    if (*paths[4] && frate > 0.0) {
+        sdr_rcv_setopt("t_fast", 1.0 / frate);
+    }
     sdr_func_init(fftw_wisdom);
+    sdr_code_book_file(cb_file);
+    sdr_ch_set_nco(nco_sigs);
     
     signal(SIGTERM, sig_func);
     signal(SIGINT, sig_func);
@@ -301,12 +590,31 @@ int main(int argc, char **argv)
 #endif
     uint32_t tt = sdr_get_tick();
     
+    if (*file && tseg > 0.0) { // batch processing over time segments
+        int nseg = sdr_rcv_batch(sigs, prns, nch, fmt, fs, fo, IQ, toff, tseg,
+            tovl, nrun, file, paths);
+        if (tint > 0.0) {
+            printf("  SEGMENTS = %d, TIME(s) = %.3f\n", nseg,
+                (sdr_get_tick() - tt) * 1e-3);
+        }
+        if (*debug_file) {
+            traceclose();
+        }
+        return nseg > 0 ? 0 : -1;
+    }
     if (*file) {
         rcv = sdr_rcv_open_file(sigs, prns, nch, fmt, fs, fo, IQ, toff,
             tscale, file, paths);
     }
+    else if (*shm_name) {
+        rcv = sdr_rcv_open_shm(sigs, prns, nch, shm_name, paths);
+    }
+    else if (*net_addr) {
+        rcv = sdr_rcv_open_net(sigs, prns, nch, net_addr, paths);
+    }
     else {
-        rcv = sdr_rcv_open_dev(sigs, prns, nch, bus, port, conf_file, paths);
+        rcv = sdr_rcv_open_devs(sigs, prns, nch, bus, port, ndev > 0 ? ndev : 1,
+            conf_files, paths);
     }
     if (!rcv) {
         return -1;
@@ -325,6 +633,9 @@ int main(int argc, char **argv)
         printf("  TIME(s) = %.3f\n", (sdr_get_tick() - tt) * 1e-3);
         printf("%s", ESC_VCUR);
     }
+    if (perf) {
+        print_perf_stat(rcv);
+    }
     sdr_rcv_close(rcv);
     
     if (*debug_file) {
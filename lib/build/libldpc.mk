@@ -1,6 +1,9 @@
 #
 #  makefile of LDPC-codes library (libldpc.so, libldpc.a)
 #
+#  The library is not linked to libsdr or the applications. It is only used
+#  by the Python LDPC decoder without libsdr (make -f libldpc.mk).
+#
 #! You need to install LDPC-codes source tree as follows.
 #!
 #! $ git clone https://github.com/radfordneal/LDPC-codes LDPC-codes
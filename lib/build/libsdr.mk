@@ -13,34 +13,36 @@ ifeq ($(OS),Windows_NT)
     CC = g++
     INSTALL = ../win32
     INCLUDE = -I$(SRC) -I../RTKLIB/src -I../cyusb
-    OPTIONS = -DWIN32 -DAVX2 -mavx2 -mfma
-    LDLIBS = -static ./librtk.a ./libfec.a ./libldpc.a -lfftw3f -lwinmm \
+    OPTIONS = -DWIN32 -DAVX2
+    LDLIBS = -static ./librtk.a ./libfec.a -lfftw3f -lwinmm \
              ../cyusb/CyAPI.a -lpthread -lsetupapi -lavrt -lwsock32
 else ifeq ($(shell uname -sm),Darwin arm64)
     CC = clang
     INSTALL = ../macos
     INCLUDE = -I$(SRC) -I../RTKLIB/src -I/opt/homebrew/include
     OPTIONS = -DMACOS -DNEON -Wno-deprecated
-    LDLIBS = -L/opt/homebrew/lib ./librtk.a ./libfec.a ./libldpc.a -lfftw3f \
+    LDLIBS = -L/opt/homebrew/lib ./librtk.a ./libfec.a -lfftw3f \
              -lusb-1.0 -lpthread
 else
     CC = g++
     INSTALL = ../linux
     INCLUDE = -I$(SRC) -I../RTKLIB/src
-    OPTIONS = -DAVX2 -mavx2 -mfma
-    LDLIBS = ./librtk.a ./libfec.a ./libldpc.a -lfftw3f -lpthread -lusb-1.0 -lm \
+    OPTIONS = -DAVX2
+    LDLIBS = ./librtk.a ./libfec.a -lfftw3f -lpthread -lusb-1.0 -lm \
              -lpthread
 endif
 ifeq ($(shell uname -m),aarch64)
     OPTIONS = -DNEON
 endif
 
+# SIMD kernels for x86 (-DAVX2) are selected at runtime by CPU features
+# (set env POCKET_SDR_SIMD=c|sse4|avx2|avx512|neon to force a variant)
 #CFLAGS = -Ofast -march=native $(INCLUDE) $(OPTIONS) -Wall -fPIC -g
 CFLAGS = -Ofast $(INCLUDE) $(OPTIONS) -Wall -fPIC -g
 
 OBJ = sdr_cmn.o sdr_func.o sdr_code.o sdr_code_gal.o sdr_ch.o \
       sdr_nav.o sdr_pvt.o sdr_rcv.o sdr_fec.o sdr_ldpc.o sdr_nb_ldpc.o \
-      sdr_usb.o sdr_dev.o sdr_conf.o
+      sdr_usb.o sdr_dev.o sdr_conf.o sdr_sim.o sdr_snap.o
 
 TARGET = libsdr.so libsdr.a
 
@@ -94,6 +96,12 @@ sdr_dev.o : $(SRC)/sdr_dev.c
 sdr_conf.o : $(SRC)/sdr_conf.c
 	$(CC) -c $(CFLAGS) $(SRC)/sdr_conf.c
 
+sdr_sim.o  : $(SRC)/sdr_sim.c
+	$(CC) -c $(CFLAGS) $(SRC)/sdr_sim.c
+
+sdr_snap.o : $(SRC)/sdr_snap.c
+	$(CC) -c $(CFLAGS) $(SRC)/sdr_snap.c
+
 sdr_cmn.o  : $(SRC)/pocket_sdr.h
 sdr_func.o : $(SRC)/pocket_sdr.h
 sdr_code.o : $(SRC)/pocket_sdr.h
@@ -107,6 +115,8 @@ sdr_nb_ldpc.o: $(SRC)/pocket_sdr.h
 sdr_usb.o  : $(SRC)/pocket_sdr.h
 sdr_dev.o  : $(SRC)/pocket_sdr.h
 sdr_conf.o : $(SRC)/pocket_sdr.h
+sdr_sim.o  : $(SRC)/pocket_sdr.h
+sdr_snap.o : $(SRC)/pocket_sdr.h
 
 clean:
 	rm -f $(TARGET) *.o
@@ -13,6 +13,7 @@
 #  2022-01-20  1.3  add signals: I5S
 #                   add option: -l, -s
 #  2022-02-17  1.4  add option: -h
+#  2026-10-15  1.5  accumulate correlation powers in place by search_code()
 #
 import sys, time
 import numpy as np
@@ -99,7 +100,7 @@ def search_sig(sig, prn, data, fs, fi, max_dop, zero_pad):
     # parallel code search and non-coherent integration
     P = np.zeros((len(fds), N), dtype='float32')
     for i in range(0, len(data) - len(code_fft) + 1, N):
-        P += sdr_func.search_code(code_fft, T, data, i, fs, fi, fds)
+        sdr_func.search_code(code_fft, T, data, i, fs, fi, fds, P)
     
     # max correlation power and C/N0
     P_max, ix, cn0 = sdr_func.corr_max(P, T)
@@ -7,6 +7,9 @@
 #
 #  History:
 #  2024-06-29  1.0  new
+#  2026-10-15  1.1  get signal status from status snapshots of receiver
+#                   add memory placement stats to get_perf_stat()
+#                   pass status string buffers to get_rcv_stat(), get_sat_stat()
 #
 import os, platform, time, re
 from math import *
@@ -35,6 +38,13 @@ P2_COLOR   = '#888844'       # plot color 2
 SDR_N_CORR = (4+81)          # number of correlators
 SDR_N_HIST = 5000            # number of correlator history
 SDR_N_PSD  = 2048            # number FFT points for PSD
+SDR_N_PERF = 7               # number of performance stages
+SDR_MAX_NCH = 999            # max number of receiver channels
+SDR_MAX_RFCH = 8             # max number of RF channels in a SDR device
+SDR_STAT_VER = 1             # version of status snapshot types
+SDR_N_MEM = 8                # number of memory placement stats
+SDR_STATE_LOCK = 3           # SDR channel state: lock
+PERF_STAGE = ('READ', 'WRITE', 'SRCH', 'TRK', 'NAV', 'DEC', 'PVT')
 MAX_RCVLOG = 2000            # max receiver logs
 UD_CYCLE1  = 20              # update cycle (ms) RF channels/Correlator pages
 UD_CYCLE2  = 100             # update cycle (ms) other pages
@@ -76,6 +86,33 @@ except:
 # general object class ---------------------------------------------------------
 class Obj: pass
 
+# status snapshot types (sdr_rcv_stat_t, sdr_pvt_stat_t, sdr_ch_stat_t) --------
+class RcvStat(Structure):
+    _fields_ = [('seq', c_uint32), ('ver', c_uint32), ('size', c_uint32 * 3),
+        ('state', c_int32), ('dev', c_int32), ('fmt', c_int32),
+        ('nrf', c_int32), ('time', c_double), ('fs', c_double),
+        ('fo', c_double * SDR_MAX_RFCH), ('IQ', c_int32 * SDR_MAX_RFCH),
+        ('nch', c_int32), ('ntrk', c_int32), ('nsrch', c_int32),
+        ('nlive', c_int32), ('sys', c_char * 8), ('data_rate', c_double),
+        ('data_sum', c_double), ('buff_use', c_double),
+        ('buff_max', c_double), ('usb_max', c_double),
+        ('ngap', c_int64 * 3), ('ndrop', c_int64 * 3)]
+
+class PvtStat(Structure):
+    _fields_ = [('seq', c_uint32), ('stat', c_int32), ('ns', c_int32),
+        ('nsat', c_int32), ('time', c_double), ('pos', c_double * 3),
+        ('rr', c_double * 6), ('dtr', c_double), ('drift', c_double),
+        ('count', c_int32 * 4)]
+
+class ChStat(Structure):
+    _fields_ = [('seq', c_uint32), ('no', c_int32), ('rfch', c_int32),
+        ('state', c_int32), ('sleep', c_int32), ('sat', c_char * 16),
+        ('sig', c_char * 16), ('prn', c_int32), ('sync', c_int32),
+        ('time', c_double), ('lock', c_double), ('cn0', c_double),
+        ('coff', c_double), ('fd', c_double), ('adr', c_double),
+        ('nnav', c_int32), ('nerr', c_int32), ('lost', c_int32),
+        ('fec', c_int32)]
+
 # get font ---------------------------------------------------------------------
 def get_font(add_size=0, weight='normal', mono=0):
     return (FONT[mono], FONT_SIZE[mono] + add_size, weight)
@@ -112,7 +149,7 @@ def rcv_open_dev(sys_opt, inp_opt, out_opt, sig_opt):
         for i in range(4)]
     c_sigs = (c_char_p * len(sigs))(*[s.encode() for s in sigs])
     c_prns = (c_int32 * len(sigs))(*prns)
-    c_paths = (c_char_p * 4)(*[s.encode() for s in paths])
+    c_paths = (c_char_p * 5)(*[s.encode() for s in paths + ['']])
     libsdr.sdr_rcv_open_dev.argtypes = [POINTER(c_char_p), POINTER(c_int32),
         c_int32, c_int32, c_int32, c_char_p, POINTER(c_char_p)]
     libsdr.sdr_rcv_open_dev.restype = c_void_p
@@ -135,7 +172,7 @@ def rcv_open_file(sys_opt, inp_opt, out_opt, sig_opt):
     c_prns = (c_int32 * len(sigs))(*prns)
     c_fo = (c_double * 8)(*fo)
     c_IQ = (c_int32 * 8)(*IQ)
-    c_paths = (c_char_p * 4)(*[s.encode() for s in paths])
+    c_paths = (c_char_p * 5)(*[s.encode() for s in paths + ['']])
     
     libsdr.sdr_func_init.argtypes = (c_char_p,)
     libsdr.sdr_func_init(sys_opt.fftw_wisdom_path.get().encode())
@@ -221,9 +258,10 @@ def set_rcv_opts(sys_opt):
 
 # get receiver status ----------------------------------------------------------
 def get_rcv_stat(rcv):
-    libsdr.sdr_rcv_rcv_stat.argtypes = (c_void_p,)
+    buff = create_string_buffer(1024)
+    libsdr.sdr_rcv_rcv_stat.argtypes = (c_void_p, c_char_p)
     libsdr.sdr_rcv_rcv_stat.restype = c_char_p
-    return libsdr.sdr_rcv_rcv_stat(rcv).decode()
+    return libsdr.sdr_rcv_rcv_stat(rcv, buff).decode()
 
 # get receiver channel status --------------------------------------------------
 def get_ch_stat(rcv, sys, all=0):
@@ -231,14 +269,34 @@ def get_ch_stat(rcv, sys, all=0):
     libsdr.sdr_rcv_ch_stat.restype = c_char_p
     return libsdr.sdr_rcv_ch_stat(rcv, sys.encode(), all).decode().splitlines()
 
+# get status snapshots ---------------------------------------------------------
+def get_stat_snap(rcv):
+    stat, pvt = RcvStat(), PvtStat()
+    chs = (ChStat * SDR_MAX_NCH)()
+    libsdr.sdr_rcv_get_stat.argtypes = (c_void_p, POINTER(RcvStat),
+        POINTER(PvtStat), POINTER(ChStat), c_int32)
+    n = libsdr.sdr_rcv_get_stat(rcv, byref(stat), byref(pvt), chs,
+        SDR_MAX_NCH)
+    if n < 0 or stat.ver != SDR_STAT_VER or stat.size[0] != sizeof(RcvStat) \
+       or stat.size[1] != sizeof(PvtStat) or stat.size[2] != sizeof(ChStat):
+        return None, None, []
+    return stat, pvt, chs[:n]
+
+# satellite selection ----------------------------------------------------------
+def sat_select(sat, sys):
+    syss = {'GPS': 'G', 'GLONASS': 'R', 'Galileo': 'E', 'QZSS': 'J',
+        'BeiDou': 'C', 'NavIC': 'I', 'SBAS': '1S'}
+    return sys == 'ALL' or (sys in syss and sat[:1] in syss[sys])
+
 # get signal status ------------------------------------------------------------
 def get_sig_stat(rcv, sys):
-    stat = get_ch_stat(rcv, sys)[2:]
     sig_stat = []
-    for s in stat:
-        ss = s.split()
-        no = 'GREJCIS'.find(ss[2][0]) * 100 + int(ss[2][1:])
-        sig_stat.append([no, -float(ss[6]), ss[2], ss[3], float(ss[6])])
+    for ch in get_stat_snap(rcv)[2]:
+        sat, sig = ch.sat.decode(), ch.sig.decode()
+        if not sat_select(sat, sys) or ch.state != SDR_STATE_LOCK or \
+           ch.lock < 2.0: continue
+        no = 'GREJCIS'.find(sat[0]) * 100 + int(sat[1:])
+        sig_stat.append([no, -ch.cn0, sat, sig, ch.cn0])
     sig_stat = sorted(sig_stat)
     sats = [s[2] for s in sig_stat]
     sigs = [s[3] for s in sig_stat]
@@ -247,9 +305,11 @@ def get_sig_stat(rcv, sys):
 
 # get satellite status ---------------------------------------------------------
 def get_sat_stat(rcv, sys):
-    libsdr.sdr_rcv_sat_stat.argtypes = (c_void_p, c_char_p)
+    buff = create_string_buffer(32 * 1024)
+    libsdr.sdr_rcv_sat_stat.argtypes = (c_void_p, c_char_p, c_char_p)
     libsdr.sdr_rcv_sat_stat.restype = c_char_p
-    stat = libsdr.sdr_rcv_sat_stat(rcv, sys.encode()).decode().splitlines()
+    stat = libsdr.sdr_rcv_sat_stat(rcv, sys.encode(), buff).decode()
+    stat = stat.splitlines()
     sats = [s.split()[0] for s in stat]
     az  = [float(s.split()[1]) for s in stat]
     el  = [float(s.split()[2]) for s in stat]
@@ -303,6 +363,22 @@ def set_sel_ch(rcv, ch):
     libsdr.sdr_rcv_sel_ch.argtypes = (c_void_p, c_int32)
     libsdr.sdr_rcv_sel_ch(rcv, ch)
 
+# get performance status -------------------------------------------------------
+def get_perf_stat(rcv):
+    stat = np.zeros(SDR_N_PERF * 5 + 5 + SDR_N_MEM + SDR_MAX_NCH,
+        dtype='float64')
+    libsdr.sdr_rcv_perf_stat.argtypes = (c_void_p,
+        ctypeslib.ndpointer('float64'))
+    n = libsdr.sdr_rcv_perf_stat(rcv, stat)
+    if n <= 0:
+        return {}, [], [], []
+    # {stage: (n, ave, p50, p99, max) (us)}, queue depths, memory placement
+    # (total, 4K, THP, 2M, 1G, locked, NUMA-bound (MB), nodes), CPU load (%)
+    perf = {s: tuple(stat[i*5:i*5+5]) for i, s in enumerate(PERF_STAGE)}
+    i = SDR_N_PERF * 5
+    j = i + 5 + SDR_N_MEM
+    return perf, stat[i:i+5], stat[i+5:j], stat[j:n]
+
 # get correlator status ---------------------------------------------------------
 def get_corr_stat(rcv, ch):
     stat = np.array([0, 24e6, 0, 0, 0, 0], dtype='float64')
@@ -443,10 +519,11 @@ def update_rcv_stat(p):
     labels = ('Receiver Time (s)', 'Input Source', 'IF Data Format',
         '# of RF CHs', 'LO Freqs (MHz)', '', 'Sampling Types',
         'Sampling Rate (Msps)', '# of BB CHs Locked/All',
-        'IF Data Rate (MB/s)', 'IF Data Buffer Usage (%)', 'Time (GPST)',
+        'IF Data Rate (MB/s)', 'IF Buffer Use/Peak/USB (%)', 'Time (GPST)',
         'Solution Status', 'Latitude (\xb0)', 'Longitude (\xb0)',
-        'Altitude (m)', 'Systems Tracked', '# of Sats Used/Tracked', 'Output',
-        '# of PVT Solutions', '# of OBS/NAV Data', 'IF Data Log (MB)')
+        'Altitude (m)', 'Systems Tracked', '# of Sats Used/Tracked',
+        'Output Drops', '# of PVT Solutions', '# of OBS/NAV Data',
+        'IF Data Log (MB)')
     value = get_rcv_stat(rcv_body).split(',')
     plt.plot_clear(p)
     for i in range(len(labels)):
@@ -8,6 +8,7 @@
 #  History:
 #  2022-02-14  1.0  new
 #  2022-07-08  1.1  add option -v
+#  2026-10-15  1.2  accumulate correlation powers in place by search_code()
 #
 import sys, math, time, re
 import numpy as np
@@ -89,7 +90,7 @@ def search_sig(data, sig, sys, prn, dif, fs, fi, rrate):
     # parallel code search
     P = np.zeros((len(fds), N), dtype='float32')
     for i in range(0, len(dif) - len(code_fft[sat]) + 1, N):
-        P += sdr_func.search_code(code_fft[sat], T, dif, i, fs, fi, fds)
+        sdr_func.search_code(code_fft[sat], T, dif, i, fs, fi, fds, P)
     
     # max correlation power
     P_max, ix, cn0 = sdr_func.corr_max(P, T)
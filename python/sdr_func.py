@@ -16,6 +16,12 @@
 #                   support np.fromfile() without offset option
 #  2023-12-27  1.6  support API changes of sdr_func.c
 #  2024-04-04  1.7  support API changes of sdr_func.c
+#  2026-10-15  1.8  set argument types of external library once at loading
+#                   pass contiguous ndarrays to external library w/o copy
+#                   search all Doppler bins by a call of external library in
+#                   search_code() and add optional accumulation of P
+#                   use external library for decode_LDPC() in sdr_ldpc.py
+#                   fix enable check of external library in psd()
 #
 from math import *
 from ctypes import *
@@ -40,7 +46,21 @@ except:
     #print('libsdr load error: ' + lib)
     libsdr = None
 else:
+    # ctypes releases GIL during the calls of external library
+    f32  = ctypeslib.ndpointer('float32', flags='C_CONTIGUOUS')
+    i32  = ctypeslib.ndpointer('int32', flags='C_CONTIGUOUS')
+    u8   = ctypeslib.ndpointer('uint8', flags='C_CONTIGUOUS')
+    cpx  = ctypeslib.ndpointer('complex64', flags='C_CONTIGUOUS')
     libsdr.sdr_func_init.argtypes = (c_char_p,)
+    libsdr.sdr_search_code_buff_cpx.argtypes = (cpx, c_double, cpx, c_int32,
+        c_int32, c_int32, c_double, c_double, f32, c_int32, f32)
+    libsdr.sdr_corr_std_cpx.argtypes = (cpx, c_int32, c_int32, c_int32,
+        c_double, c_double, c_double, f32, i32, c_int32, cpx)
+    libsdr.sdr_corr_fft_cpx.argtypes = (cpx, c_int32, c_int32, c_int32,
+        c_double, c_double, c_double, cpx, cpx)
+    libsdr.sdr_psd_cpx.argtypes = (cpx, c_int32, c_int32, c_double, c_int32,
+        f32)
+    libsdr.sdr_decode_LDPC.argtypes = (c_char_p, u8, c_int32, u8)
     libsdr.sdr_func_init(''.encode())
 
 # constants --------------------------------------------------------------------
@@ -94,18 +114,26 @@ def read_data(file, fs, IQ, T, toff=0.0):
 #      fs       (I) Sampling frequency (Hz)
 #      fi       (I) IF frequency (Hz)
 #      fds      (I) Doppler frequency bins as ndarray (Hz)
+#      P        (IO) Correlation powers accumulated as float32 2D-ndarray
+#                   (None: new ndarray) (optional)
 #
 #  returns:
 #      P        Correlation powers in the Doppler frequencies - Code offset
 #               space as float32 2D-ndarray
 #
-def search_code(code_fft, T, buff, ix, fs, fi, fds):
+def search_code(code_fft, T, buff, ix, fs, fi, fds, P=None):
     N = int(fs * T)
-    P = np.zeros((len(fds), N), dtype='float32')
+    if P is None:
+        P = np.zeros((len(fds), N), dtype='float32')
     
+    if libsdr and LIBSDR_ENA:
+        fds = np.ascontiguousarray(fds, dtype='float32')
+        libsdr.sdr_search_code_buff_cpx(code_fft, T, buff, len(buff), ix,
+            len(code_fft), fs, fi, fds, len(fds), P)
+        return P
     for i in range(len(fds)):
         C = corr_fft(buff, ix, len(code_fft), fs, fi + fds[i], 0.0, code_fft)[:N]
-        P[i] = np.abs(C) ** 2
+        P[i] += np.abs(C) ** 2
     return P
 
 # max correlation power and C/N0 -----------------------------------------------
@@ -139,13 +167,9 @@ def dop_bins(T, dop, max_dop):
 def corr_std(buff, ix, N, fs, fc, phi, code, pos):
     if libsdr and LIBSDR_ENA:
         corr = np.empty(len(pos), dtype='complex64')
-        code_real = np.array(code.real, dtype='float32')
-        pos = np.array(pos, dtype='int32')
-        libsdr.sdr_corr_std_cpx.argtypes = [
-            ctypeslib.ndpointer('complex64'), c_int32, c_int32, c_int32,
-            c_double, c_double, c_double, ctypeslib.ndpointer('float32'),
-            ctypeslib.ndpointer('int32'), c_int32,
-            ctypeslib.ndpointer('complex64')]
+        code_real = code if code.dtype == np.float32 else \
+            np.ascontiguousarray(code.real, dtype='float32')
+        pos = np.ascontiguousarray(pos, dtype='int32')
         libsdr.sdr_corr_std_cpx(buff, len(buff), ix, N, fs, fc, phi, code_real,
             pos, len(pos), corr)
         return corr
@@ -157,10 +181,6 @@ def corr_std(buff, ix, N, fs, fc, phi, code, pos):
 def corr_fft(buff, ix, N, fs, fc, phi, code_fft):
     if libsdr and LIBSDR_ENA:
         corr = np.empty(N, dtype='complex64')
-        libsdr.sdr_corr_fft_cpx.argtypes = [
-            ctypeslib.ndpointer('complex64'), c_int32, c_int32, c_int32,
-            c_double, c_double, c_double, ctypeslib.ndpointer('complex64'),
-            ctypeslib.ndpointer('complex64')]
         libsdr.sdr_corr_fft_cpx(buff, len(buff), ix, N, fs, fc, phi, code_fft,
             corr)
         return corr
@@ -196,13 +216,11 @@ def corr_fft_(data, code_fft):
 
 # PSD of IF data ---------------------------------------------------------------
 def psd(data, N, fs, IQ):
-    if not libsdr and LIBSDR_ENA:
+    if not libsdr or not LIBSDR_ENA:
         return []
     psd = np.zeros(N if IQ == 2 else N // 2, dtype='float32')
-    libsdr.sdr_psd_cpx.argtypes = [
-        ctypeslib.ndpointer('complex64'), c_int32, c_int32, c_double, c_int32,
-        ctypeslib.ndpointer('float32')]
-    libsdr.sdr_psd_cpx(np.array(data, 'complex64'), len(data), N, fs, IQ, psd)
+    data = np.ascontiguousarray(data, dtype='complex64')
+    libsdr.sdr_psd_cpx(data, len(data), N, fs, IQ, psd)
     return psd
 
 # open log ---------------------------------------------------------------------
@@ -24,11 +24,13 @@
 #  2023-01-07  1.1  support IRNV1_SF2 and IRNV1_SF3 in decode_LDPC()
 #  2023-01-09  1.2  support BCNV1_SF2, BCNV1_SF3, BCNV2, BCNV3 in decode_LDPC()
 #  2023-01-24  1.3  support NB-LDPC error correction
+#  2026-10-15  1.4  use external library libsdr for decode_LDPC()
 #
 import os, platform
 from ctypes import *
 import numpy as np
 from sdr_nb_ldpc import *
+import sdr_func
 
 # load library of LDPC-codes ([1],[2]) -----------------------------------------
 env = platform.platform()
@@ -49,6 +51,8 @@ except:
 MAX_ITER = 250
 ERR_PROB = 1e-5
 RATIO = ((1.0 - ERR_PROB) / ERR_PROB, ERR_PROB / (1.0 - ERR_PROB))
+LDPC_TYPES = ('CNV2_SF2', 'CNV2_SF3', 'BCNV1_SF2', 'BCNV1_SF3', 'BCNV2',
+    'BCNV3', 'IRNV1_SF2', 'IRNV1_SF3')
 
 # LDPC H-matrix cache ----------------------------------------------------------
 H_CNV2_SF2  = None
@@ -2160,6 +2164,12 @@ H_IRNV1_SF3_T = ( # [7] table 41
 
 # decode LDPC ------------------------------------------------------------------
 def decode_LDPC(type, syms):
+    if sdr_func.libsdr and sdr_func.LIBSDR_ENA and type in LDPC_TYPES:
+        syms = np.ascontiguousarray(syms, dtype='uint8')
+        syms_dec = np.zeros(len(syms) // 2, dtype='uint8')
+        nerr = sdr_func.libsdr.sdr_decode_LDPC(type.encode(), syms, len(syms),
+            syms_dec)
+        return syms_dec, nerr
     if type == 'CNV2_SF2':
         return decode_LDPC_CNV2_SF2(syms)
     elif type == 'CNV2_SF3':
@@ -17,6 +17,128 @@
 //  2024-04-28  1.9  update constants, types and API
 //  2024-05-28  1.10 update constants, types and APIs
 //  2024-07-01  1.11 import pocket_dev.h
+//  2026-10-14  1.12 add receiver worker thread type and API sdr_get_ncpu()
+//                   add wakeup latency type and APIs sdr_get_tick_us(),
+//                   sdr_cond_wait(), sdr_dev_wait(), sdr_rcv_lat_stat()
+//                   lock-free raw data buffer of SDR device type
+//                   add API sdr_dev_peek(), sdr_dev_consume()
+//                   add API sdr_scratch_alloc(), sdr_scratch_free(),
+//                   sdr_scratch_clear(), sdr_alloc_stat()
+//                   add SIMD variants and API sdr_set_simd(), sdr_get_simd()
+//                   add IF data file type and APIs sdr_file_open(),
+//                   sdr_file_close(), sdr_file_seek(), sdr_file_read()
+//                   add output window to receiver type and API sdr_rcv_batch()
+//                   add code book type and APIs sdr_code_book_file(),
+//                   sdr_code_book_get(), sdr_code_book_put()
+//                   add packed primary code type and APIs sdr_gen_code_pack(),
+//                   sdr_res_code_pack(), sdr_gen_code_fft_pack()
+//                   add APIs sdr_code_nco(), sdr_ch_set_nco()
+//                   add API sdr_search_code_max()
+//                   add signal acquisition job type and API sdr_acq_batch()
+//                   add data DFT cache type and APIs sdr_dft_cache_new(),
+//                   sdr_dft_cache_free(), sdr_dft_cache_inval()
+//                   add Doppler window of external assist in acquisition
+//                   add satellite prediction to PVT and API sdr_pvt_pred_dop()
+//                   add signal IDs, signal descriptor type and APIs
+//                   sdr_sig_id(), sdr_sig_get()
+//                   ring buffers of P correlation history and nav symbols,
+//                   add API sdr_nav_add_sym()
+//                   add channel block type and APIs sdr_ch_blk_new(),
+//                   sdr_ch_blk_free(), sdr_ch_blk_add(), sdr_ch_blk_update(),
+//                   add channel block task type to receiver worker thread
+//                   add API sdr_atan2_blk()
+//                   add standard correlator job type and API
+//                   sdr_corr_std_multi()
+//                   add carrier mixers and API sdr_set_mix()
+//                   add packed IF data buffer and APIs sdr_buff_new_pack(),
+//                   sdr_buff_get()
+//                   runtime size of USB transfer buffers and API
+//                   sdr_dev_set_buff()
+//                   add APIs sdr_dev_sync(), sdr_dev_check(), sdr_ch_coast()
+//                   add APIs sdr_set_thread(), sdr_dev_set_thread(),
+//                   sdr_nav_async()
+//  2026-10-15  1.13 add soft-decision nav symbols and APIs sdr_nav_add_ssym(),
+//                   sdr_decode_LDPC_soft()
+//                   add Viterbi decoder type and APIs sdr_vit_init(),
+//                   sdr_vit_update(), sdr_vit_chainback()
+//                   add bit-packed nav symbols buffer to nav data type
+//                   add PVT observation slot and navigation data message
+//                   types, PVT thread and API sdr_pvt_start()
+//                   add output stream type and APIs sdr_ostr_open(),
+//                   sdr_ostr_close(), sdr_ostr_write()
+//                   add binary log format and APIs sdr_log_format(),
+//                   sdr_log_conv()
+//                   add performance counter type and APIs sdr_get_tick_ns(),
+//                   sdr_perf_add(), sdr_perf_get(), sdr_perf_reset(),
+//                   sdr_nav_queue(), sdr_pvt_nav_queue(),
+//                   sdr_rcv_perf_stat()
+//                   add IF signal simulator types and APIs sdr_sim_new(),
+//                   sdr_sim_free(), sdr_sim_add_sat(), sdr_sim_gen()
+//                   add API sdr_par_for()
+//                   add IF data monitor type and APIs sdr_mon_new(),
+//                   sdr_mon_free(), sdr_mon_update(), sdr_mon_psd(),
+//                   sdr_mon_hist()
+//                   add API sdr_file_read_data()
+//                   add snapshot positioning types and APIs sdr_snap_new(),
+//                   sdr_snap_free(), sdr_snap_pos(), sdr_snap_batch()
+//                   add long integration states to signal acquisition type
+//                   and API sdr_search_code_cpx()
+//                   add GLONASS FDMA channelizer type and APIs sdr_fdma_new(),
+//                   sdr_fdma_free(), sdr_fdma_buff(), sdr_fdma_update()
+//                   replace GLONASS FDMA channelizer type by sub-band DDC type
+//                   and APIs sdr_ddc_new(), sdr_ddc_free(), sdr_ddc_dec(),
+//                   sdr_ddc_update()
+//                   add pilot channel of joint tracking to receiver channel
+//                   type and API sdr_ch_join()
+//                   add Doppler aiding and vector coast states to receiver
+//                   channel type and API sdr_ch_aid(), add predicted range
+//                   acceleration to PVT type, modify API sdr_pvt_pred_dop()
+//                   add correlation interval to receiver channel type, add API
+//                   sdr_ch_ncyc(), modify API sdr_ch_blk_update()
+//                   add CSK demodulator type and APIs sdr_csk_new(),
+//                   sdr_csk_free(), sdr_csk_corr()
+//                   add satellite position cache type and processing options
+//                   to PVT type
+//                   add fast-rate PVT solution to PVT type
+//                   fan out output stream to multiple streams
+//                   add multiple SDR devices to receiver type and API
+//                   sdr_rcv_open_devs()
+//                   add shared memory IF broker to SDR device type and APIs
+//                   sdr_dev_share(), sdr_dev_attach(), sdr_rcv_open_shm(),
+//                   sdr_rcv_setopt_str()
+//                   add network IF stream to SDR device type and APIs
+//                   sdr_dev_stream(), sdr_dev_connect(), sdr_rcv_open_net()
+//                   add API sdr_search_code_buff_cpx()
+//                   add warm-start state to PVT type and APIs
+//                   sdr_pvt_save_state(), sdr_pvt_load_state()
+//                   add sleep flag to receiver channel type and live channel
+//                   count to receiver type, add APIs sdr_ch_sleep(),
+//                   sdr_ch_wake()
+//                   add decimated search of partial code to signal acquisition
+//                   type, add API sdr_search_code_dec()
+//                   add register shadow cache to SDR device type, add APIs
+//                   sdr_dev_read_regs(), sdr_dev_write_regs()
+//                   add frame headers of USB transfers to SDR device type,
+//                   add API sdr_dev_set_frame()
+//                   add status snapshot types of receiver, PVT and channels,
+//                   add APIs sdr_seq_begin(), sdr_seq_end(), sdr_seq_read(),
+//                   sdr_rcv_get_stat()
+//                   add APIs sdr_mem_alloc(), sdr_mem_free(), sdr_mem_bind(),
+//                   sdr_mem_page(), sdr_mem_node(), sdr_mem_nnode(),
+//                   sdr_mem_stat()
+//                   add satellite status snapshot type to PVT type, modify
+//                   APIs sdr_rcv_rcv_stat(), sdr_rcv_sat_stat()
+//                   add busy flags of channel lanes to channel block task type
+//                   add APIs sdr_fftw_plan(), sdr_search_plan(),
+//                   sdr_fftw_import(), sdr_fftw_export()
+//                   add decoder job buffers to nav data type
+//                   add warm-start seed type of PVT, add warm-start seed and
+//                   IF data file cycle to receiver type, add API
+//                   sdr_pvt_load_seed()
+//                   add valid flag and Doppler bins of external assist to
+//                   acquisition type
+//                   add primary code hash and save flag to code book type, add
+//                   API sdr_code_book_save()
 //
 #ifndef POCKET_SDR_H
 #define POCKET_SDR_H
@@ -42,17 +164,40 @@ extern "C" {
 
 // constants and macros ------------------------------------------------------
 #define SDR_MAX_RFCH   8        // max number of RF channels in a SDR device
+#define SDR_MAX_DEV    4        // max number of SDR devices of a receiver
 #define SDR_MAX_REG    11       // max number of registers in a SDR device
-#define SDR_MAX_BUFF   96       // number of IF data buffer
-#define SDR_SIZE_BUFF  (1<<16)  // size of IF data buffer (bytes)
+#define SDR_MAX_BUFF   96       // default number of USB transfer buffers
+#define SDR_SIZE_BUFF  (1<<16)  // default size of USB transfer buffer (bytes)
+#define SDR_CACHE_LINE 64       // size of CPU cache line (bytes)
 
 #define SDR_MAX_NPRN   256      // max number of PRNs
 #define SDR_MAX_NCH    999      // max number of receiver channels
+#define SDR_MAX_WORK   64       // max number of receiver worker threads
 #define SDR_MAX_NSYM   2000     // max number of symbols
 #define SDR_MAX_DATA   4096     // max length of navigation data
+#define SDR_MAX_VIT    (SDR_MAX_NSYM/2) // max steps of Viterbi decoder
 #define SDR_N_CORR     (4+81)   // number of correlators
 #define SDR_N_HIST     5000     // number of P correlator history 
+#define SDR_CH_BLK     8        // max number of channels in a channel block
+#define SDR_N_CHEB     10       // number of Chebyshev coefficients of satellite
+                                // position cache
 #define SDR_CSCALE    (1/24.0f) // carrier scale (max(IQ)*sqrt(2)/scale<127)
+#define SDR_STAT_VER   1        // version of status snapshot types
+#define SDR_MAX_NODE   16       // max number of NUMA nodes
+#define SDR_N_MEM      8        // number of memory placement stats
+
+#define SDR_SIMD_C      0       // SIMD variant: scalar
+#define SDR_SIMD_SSE4   1       // SIMD variant: SSE4.1
+#define SDR_SIMD_AVX2   2       // SIMD variant: AVX2
+#define SDR_SIMD_AVX512 3       // SIMD variant: AVX-512BW
+#define SDR_SIMD_NEON   4       // SIMD variant: NEON
+#define SDR_PAGE_HEAP   0       // memory page type: heap
+#define SDR_PAGE_4K     1       // memory page type: 4 KB pages
+#define SDR_PAGE_THP    2       // memory page type: transparent hugepages
+#define SDR_PAGE_2M     3       // memory page type: 2 MB hugepages
+#define SDR_PAGE_1G     4       // memory page type: 1 GB hugepages
+#define SDR_MIX_LUT     0       // carrier mixer: LUT of 8-bit phase
+#define SDR_MIX_NCO     1       // carrier mixer: polynomial NCO
 #define SDR_CYC        1e-3     // IF data processing cycle (s)
 #define PI 3.1415926535897932   // pi 
 
@@ -73,6 +218,9 @@ extern "C" {
 #define SDR_VR_STOP    0x45     // SDR USB vendor request: Stop bulk transfer
 #define SDR_VR_RESET   0x46     // SDR USB vendor request: Reset device
 #define SDR_VR_SAVE    0x47     // SDR USB vendor request: Save settings
+#define SDR_VR_REG_READ_BLK 0x4C // SDR USB vendor request: Read reg block
+#define SDR_VR_REG_WRITE_BLK 0x4D // SDR USB vendor request: Write reg block
+#define SDR_VR_FRAME   0x4E     // SDR USB vendor request: Set frame header
 
 #define SDR_FMT_INT8   1        // SDR IF data format: int8 (I)
 #define SDR_FMT_INT8X2 2        // SDR IF data format: int8 x 2 complex (IQ)
@@ -80,13 +228,100 @@ extern "C" {
 #define SDR_FMT_RAW16  4        // SDR IF data format: packed 16 bits raw (4CH)
 #define SDR_FMT_RAW16I 5        // SDR IF data format: packed 16 bits raw (8CH)
 
+#define SDR_CODE_FFT   1        // SDR code book type: code FFT
+#define SDR_CODE_RES   2        // SDR code book type: resampled code
+
+#define SDR_OSTR_DROP  1        // output stream option: drop data if full
+#define SDR_OSTR_MP    2        // output stream option: multiple producers
+#define SDR_MAX_OSTR   8        // max number of streams of an output stream
+
+#define SDR_LOG_TEXT   0        // log format: text
+#define SDR_LOG_BIN    1        // log format: binary
+#define SDR_LOG_SYNC   0xA5     // binary log record: sync code
+#define SDR_LOG_FDEF   1        // binary log record type: format definition
+#define SDR_LOG_DATA   2        // binary log record type: log data
+
+#define SDR_PERF_READ  0        // performance stage: read IF data
+#define SDR_PERF_WRITE 1        // performance stage: write IF data buffer
+#define SDR_PERF_SRCH  2        // performance stage: search signal
+#define SDR_PERF_TRK   3        // performance stage: track channel block
+#define SDR_PERF_NAV   4        // performance stage: decode navigation data
+#define SDR_PERF_DEC   5        // performance stage: decoder thread job
+#define SDR_PERF_PVT   6        // performance stage: update PVT solution
+#define SDR_N_PERF     7        // number of performance stages
+#define SDR_N_PERF_BIN 32       // number of bins of performance histogram
+
 #define SDR_STATE_IDLE 1        // SDR channel state: idle
 #define SDR_STATE_SRCH 2        // SDR channel state: search
 #define SDR_STATE_LOCK 3        // SDR channel state: lock
 
+#define SDR_SIG_L1CA     1      // SDR signal ID: L1CA
+#define SDR_SIG_L1S      2      // SDR signal ID: L1S
+#define SDR_SIG_L1CB     3      // SDR signal ID: L1CB
+#define SDR_SIG_L1CP     4      // SDR signal ID: L1CP
+#define SDR_SIG_L1CD     5      // SDR signal ID: L1CD
+#define SDR_SIG_L2CM     6      // SDR signal ID: L2CM
+#define SDR_SIG_L2CL     7      // SDR signal ID: L2CL
+#define SDR_SIG_L5I      8      // SDR signal ID: L5I
+#define SDR_SIG_L5Q      9      // SDR signal ID: L5Q
+#define SDR_SIG_L5SI     10     // SDR signal ID: L5SI
+#define SDR_SIG_L5SQ     11     // SDR signal ID: L5SQ
+#define SDR_SIG_L5SIV    12     // SDR signal ID: L5SIV
+#define SDR_SIG_L5SQV    13     // SDR signal ID: L5SQV
+#define SDR_SIG_L6D      14     // SDR signal ID: L6D
+#define SDR_SIG_L6E      15     // SDR signal ID: L6E
+#define SDR_SIG_G1CA     16     // SDR signal ID: G1CA
+#define SDR_SIG_G2CA     17     // SDR signal ID: G2CA
+#define SDR_SIG_G1OCD    18     // SDR signal ID: G1OCD
+#define SDR_SIG_G1OCP    19     // SDR signal ID: G1OCP
+#define SDR_SIG_G2OCP    20     // SDR signal ID: G2OCP
+#define SDR_SIG_G3OCD    21     // SDR signal ID: G3OCD
+#define SDR_SIG_G3OCP    22     // SDR signal ID: G3OCP
+#define SDR_SIG_E1B      23     // SDR signal ID: E1B
+#define SDR_SIG_E1C      24     // SDR signal ID: E1C
+#define SDR_SIG_E5AI     25     // SDR signal ID: E5AI
+#define SDR_SIG_E5AQ     26     // SDR signal ID: E5AQ
+#define SDR_SIG_E5BI     27     // SDR signal ID: E5BI
+#define SDR_SIG_E5BQ     28     // SDR signal ID: E5BQ
+#define SDR_SIG_E6B      29     // SDR signal ID: E6B
+#define SDR_SIG_E6C      30     // SDR signal ID: E6C
+#define SDR_SIG_B1I      31     // SDR signal ID: B1I
+#define SDR_SIG_B1CD     32     // SDR signal ID: B1CD
+#define SDR_SIG_B1CP     33     // SDR signal ID: B1CP
+#define SDR_SIG_B2I      34     // SDR signal ID: B2I
+#define SDR_SIG_B2AD     35     // SDR signal ID: B2AD
+#define SDR_SIG_B2AP     36     // SDR signal ID: B2AP
+#define SDR_SIG_B2BI     37     // SDR signal ID: B2BI
+#define SDR_SIG_B3I      38     // SDR signal ID: B3I
+#define SDR_SIG_I1SD     39     // SDR signal ID: I1SD
+#define SDR_SIG_I1SP     40     // SDR signal ID: I1SP
+#define SDR_SIG_I5S      41     // SDR signal ID: I5S
+#define SDR_SIG_ISS      42     // SDR signal ID: ISS
+#define SDR_NUM_SIG      43     // number of SDR signal IDs + 1
+
+#define SDR_TRK_P(trk, i) ((trk)->P[((trk)->ip + (i)) % SDR_N_HIST]) // P corr.
+                                // history (i: 0 oldest - SDR_N_HIST-1 latest)
+#define SDR_NAV_SYMS(nav) ((nav)->syms + (nav)->isym) // nav symbols as array
+                                // (oldest - SDR_MAX_NSYM-1 latest)
+#define SDR_NAV_SSYMS(nav) ((nav)->ssyms + (nav)->isym) // soft-decision nav
+                                // symbols as array (0-255) (128: erasure)
+#define SDR_CH_FD(ch)   ((ch)->blk->fd[(ch)->ib])   // Doppler frequency (Hz)
+#define SDR_CH_COFF(ch) ((ch)->blk->coff[(ch)->ib]) // code offset (s)
+#define SDR_CH_ADR(ch)  ((ch)->blk->adr[(ch)->ib])  // accumulated Doppler
+                                // range (cyc)
+#define SDR_CH_CN0(ch)  ((ch)->blk->cn0[(ch)->ib])  // C/N0 (dB-Hz)
+
 #define SDR_CPX8(re, im) (sdr_cpx8_t)(((int8_t)(im)<<4)|(((int8_t)((re)<<4)>>4)&0xF))
 #define SDR_CPX8_I(x)  ((int8_t)((x)<<4)>>4)
 #define SDR_CPX8_Q(x)  ((int8_t)((x)<<0)>>4)
+#define SDR_CODE_CHIP(c, i) ((((c)->zero >> ((i) % (c)->nz)) & 1) ? 0 : \
+    ((((c)->bits[(i) >> 3] >> ((i) & 7)) & 1) ? 1 : -1))
+
+#if defined(AVX2)               // function targets of x86 SIMD kernels
+#define SDR_TARGET_SSE4   __attribute__((target("sse4.1")))
+#define SDR_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define SDR_TARGET_AVX512 __attribute__((target("avx2,fma,avx512f,avx512bw")))
+#endif
 
 // type definitions ----------------------------------------------------------
 typedef uint8_t sdr_cpx8_t;      // 8(4+4) bits complex type 
@@ -102,41 +337,161 @@ typedef struct {                // USB device type
 } sdr_usb_t;
 #endif
 
+typedef struct {                // wakeup latency type
+    int64_t n;                  // number of wakeups
+    int64_t t;                  // time of last notify (us)
+    double sum, max;            // sum and max of wakeup latency (us)
+} sdr_lat_t;
+
+typedef struct {                // performance counter type
+    int64_t n;                  // number of samples
+    int64_t sum, max;           // sum and max of elapsed time (ns)
+    int64_t hist[SDR_N_PERF_BIN]; // histogram of elapsed time
+                                // (bin i: 2^i <= time < 2^(i+1) ns)
+} sdr_perf_t;
+
 typedef struct {                // SDR device type
     sdr_usb_t *usb;             // USB device
     int state;                  // state of USB event handler
-    int64_t rp, wp;             // read/write pointer of raw data buffer
     uint8_t *buff;              // raw data buffer
+    uint8_t *err;               // error flags of USB transfer buffers
+    int nbuff, size_buff;       // number and size of USB transfer buffers
+    int size_data;              // IF data size of USB transfer buffer (bytes)
+    int frame;                  // frame headers of USB transfers requested
+    int size_frm, size_hdr;     // size of frame and frame header (0: no frame)
+    int64_t cnt;                // sample counter of next frame (-1: no sync)
+    int dma;                    // raw data buffer in USB device memory
+    int cpu, pri;               // CPU core and priority of event handler
 #ifndef WIN32
-    struct libusb_transfer *transfer[SDR_MAX_BUFF]; // USB transfers
+    struct libusb_transfer **transfer; // USB transfers
 #endif
+    struct sdr_shm_tag *shm;    // shared memory IF broker (NULL: not shared)
+    size_t size_shm;            // size of shared memory segment (bytes)
+    int shm_rd;                 // attached to IF broker read-only
+    char shm_name[64];          // name of shared memory segment
+    struct sdr_net_tag *net;    // network IF stream (NULL: no stream)
+    int net_rd;                 // network IF stream reader
+    uint8_t info[6];            // device info (info[0]=0: not read)
+    int blk;                    // register block access (0:unknown,1:yes,-1:no)
+    uint32_t regs[SDR_MAX_RFCH][SDR_MAX_REG]; // register shadow cache
+    uint32_t regs_ok[SDR_MAX_RFCH]; // valid flags of register shadow cache
+    uint8_t pad0[SDR_CACHE_LINE]; // padding to separate cache lines
+    int64_t wp;                 // write pointer of raw data buffer (atomic)
+    int64_t ndrop;              // number of dropped transfers (atomic)
+    int64_t nseq;               // number of out-of-sequence transfers (atomic)
+    int64_t unread_max;         // peak unread data size (bytes) (atomic)
+    int64_t t0;                 // time of first transfer (ns) (atomic)
+    uint8_t pad1[SDR_CACHE_LINE];
+    int64_t rp;                 // read pointer of raw data buffer (atomic)
+    int64_t nskip;              // data skipped by overrun (bytes)
+    int wait;                   // reader waiting flag (atomic)
+    sdr_lat_t lat;              // wakeup latency of reader
+    uint8_t pad2[SDR_CACHE_LINE];
     pthread_t thread;           // USB event handler thread
-    pthread_mutex_t mtx;        // lock flag
+    pthread_mutex_t mtx;        // lock flag for reader wait
+    pthread_cond_t cond;        // raw data buffer update condition
 } sdr_dev_t;
 
+typedef struct {                // packed primary code type
+    int N;                      // length of code (chips)
+    int nz;                     // period of zero-chip pattern (chips)
+    uint8_t zero;               // zero-chip pattern (bit j: chip j+k*nz = 0)
+    uint8_t *bits;              // code bits (bit i: chip i = 1, otherwise -1)
+} sdr_code_pack_t;
+
+typedef struct sdr_code_book_tag { // code book type
+    char sig[16];               // signal ID
+    int prn;                    // PRN number
+    double fs;                  // sampling frequency (Hz)
+    int N, Nz;                  // number of samples and zero-padding
+    int nbank;                  // number of code offsets in bank
+    int type;                   // type (SDR_CODE_FFT, SDR_CODE_RES)
+    int ref;                    // reference count
+    uint32_t hash;              // primary code hash
+    int save;                   // save to code book file (0:no,1:pending)
+    sdr_cpx_t *code_fft;        // code FFT bank ((N + Nz) x nbank)
+    sdr_cpx16_t *code_res;      // resampled code bank ((N + Nz) x nbank)
+    struct sdr_code_book_tag *next; // next code book
+} sdr_code_book_t;
+
 typedef struct {                // signal acquisition type 
+    sdr_code_book_t *book;      // code book of code FFT
     sdr_cpx_t *code_fft;        // code FFT 
     float *fds;                 // Doppler bins 
     int len_fds;                // length of Doppler bins 
+    int ext;                    // Doppler external assist (0:none,1:valid)
     float fd_ext;               // Doppler external assist
+    float max_dop_ext;          // half width of Doppler window of external
+                                // assist (Hz) (0: +/-1 bin)
+    float *fds_ext;             // Doppler bins of external assist
+                                // (len_fds)
     float *P_sum;               // sum of correlation powers 
     int n_sum;                  // number of sum 
+    int K;                      // code cycles of coherent integration of
+                                // long integration (0: not started)
+    int n_hyp;                  // number of secondary code hypotheses
+    int8_t *hyp;                // secondary code hypotheses (K x n_hyp)
+    sdr_cpx_t *C;               // correlations of coherent integration
+                                // (N x len_fds x K)
+    float *P_blk;               // non-coherent sums of even and odd coherent
+                                // integrations (N x len_fds * K x 2)
+    double time0;               // start time of long integration (s)
+    int D;                      // decimation factor of decimated search of
+                                // partial code (0: no decimated search)
+    int Np;                     // partial code length (decimated samples)
+    sdr_code_book_t *book_d;    // code book of partial code FFT
+    sdr_cpx_t *code_fft_d;      // partial code FFT (2 * N / D)
+    float *fds_d;               // Doppler bins of decimated search
+    int len_fds_d;              // length of Doppler bins of decimated search
 } sdr_acq_t;
 
+typedef struct {                // signal acquisition job type
+    char sig[16];               // signal ID
+    int prn;                    // PRN number (FCN for GLONASS FDMA)
+    float dop;                  // center of Doppler search window (Hz)
+    float max_dop;              // half width of Doppler search window (Hz)
+    int stat;                   // status (1: OK, 0: error)
+    float cn0;                  // C/N0 (dB-Hz)
+    double fd;                  // Doppler frequency (Hz)
+    double coff;                // code offset (s)
+    float P[3];                 // correlation powers at code offsets
+                                // (coff - 1/fs, coff, coff + 1/fs)
+} sdr_acq_job_t;
+
+typedef struct {                // CSK demodulator type
+    const sdr_code_pack_t *code; // primary code (packed)
+    int N;                      // code cycle (samples)
+    int L;                      // code length in CSK chips
+    int nsym;                   // number of CSK symbols
+    int M;                      // FFT size of chip-rate correlation
+    sdr_cpx_t *code_fft;        // DFT of chip-rate code {M}
+    sdr_cpx_t *X;               // chip-rate data and correlation {2 * M}
+    sdr_cpx16_t *IQ;            // carrier-mixed IF data {N}
+    sdr_cpx16_t *code_res;      // code replica of detected symbol {N}
+    float *P;                   // correlation powers of symbols {2 * nsym}
+} sdr_csk_t;
+
 typedef struct {                // signal tracking type 
     int npos;                   // number of correlator position
     int pos[SDR_N_CORR];        // correlator positions 
     sdr_cpx_t C[SDR_N_CORR];    // correlations 
-    sdr_cpx_t P[SDR_N_HIST];    // history of P correlations 
+    sdr_cpx_t P[SDR_N_HIST];    // history of P correlations (ring buffer)
+    int ip;                     // index of oldest P correlation in history
     int sec_sync;               // secondary code sync status 
     int sec_pol;                // secondary code polarity 
-    double err_phas;            // phase error (cyc) 
-    double err_code;            // code error (chip) 
-    double sumP, sumE, sumL, sumN; // sum of correlations 
-    sdr_cpx16_t *code;          // resampled code 
-    sdr_cpx_t *code_fft;        // code FFT
+    int rot;                    // rotation of correlations by pilot carrier
+                                // (0: undecided, 1: 0 deg, 2: 90 deg)
+    sdr_code_book_t *book;      // code book of resampled code or code FFT
+    sdr_cpx16_t *code;          // resampled code (NULL: code NCO)
+    sdr_csk_t *csk;             // CSK demodulator (NULL: no CSK)
 } sdr_trk_t;
 
+typedef struct {                // Viterbi decoder type (K=7, R=1/2)
+    uint16_t metric[64];        // path metrics of states
+    uint64_t dec[SDR_MAX_VIT];  // decisions of states (ring buffer)
+    int n;                      // number of updated steps
+} sdr_vit_t;
+
 typedef struct {                // SDR receiver navigation data type
     int ssync;                  // symbol sync time as lock count (0: no-sync)
     int fsync;                  // nav frame sync time as lock count (0: no-sync)
@@ -144,20 +499,56 @@ typedef struct {                // SDR receiver navigation data type
     int nerr;                   // number of error corrected
     int seq, type, stat;        // sequence number, type, update status
     double coff;                // code offset for L6D/E CSK
-    uint8_t syms[SDR_MAX_NSYM]; // nav symbols buffer
+    uint8_t syms[SDR_MAX_NSYM*2]; // nav symbols buffer (mirrored ring buffer)
+    uint8_t ssyms[SDR_MAX_NSYM*2]; // soft-decision nav symbols buffer
+    uint64_t psyms[SDR_MAX_NSYM/32+2]; // bit-packed nav symbols buffer
+    float amp;                  // mean amplitude of nav symbols
+    int isym;                   // index of oldest nav symbol in buffer
+    sdr_vit_t vit[2];           // Viterbi decoders of symbol pairs (even, odd)
+    int ivit;                   // index of Viterbi decoder updated next
     uint8_t data[SDR_MAX_DATA]; // navigation data buffer
     int count[2];               // navigation data count (OK, error)
+    struct nav_job_tag *job;    // pending decoder jobs (list)
+    struct nav_pool_tag *pool;  // decoder job buffers
 } sdr_nav_t;
 
-typedef struct {                // SDR receiver channel type 
+typedef struct {                // SDR signal descriptor type
+    const char *sig;            // signal ID as string
+    double freq;                // carrier frequency (Hz)
+    double cyc;                 // primary code cycle (s)
+    int len;                    // primary code length (chip)
+    uint8_t code;               // RINEX observation code (CODE_???)
+    uint8_t csk;                // CSK modulation by FFT correlator (0/1)
+} sdr_sig_t;
+
+struct sdr_ch_tag;
+
+typedef struct {                // SDR channel block type (hot states of
+                                // tracking loops as structure of arrays)
+    int n;                      // number of channels in block
+    int own;                    // owned by a channel (0: shared, 1: owned)
+    struct sdr_ch_tag *ch[SDR_CH_BLK]; // channels
+    double fd[SDR_CH_BLK];      // Doppler frequencies (Hz)
+    double coff[SDR_CH_BLK];    // code offsets (s)
+    double adr[SDR_CH_BLK];     // accumulated Doppler ranges (cyc)
+    double cn0[SDR_CH_BLK];     // C/N0 (dB-Hz)
+    double err_phas[SDR_CH_BLK]; // phase errors (cyc)
+    double err_code[SDR_CH_BLK]; // code errors (chip)
+    double sumP[SDR_CH_BLK], sumE[SDR_CH_BLK]; // sums of correlations
+    double sumL[SDR_CH_BLK], sumN[SDR_CH_BLK];
+} sdr_ch_blk_t;
+
+typedef struct sdr_ch_tag {     // SDR receiver channel type 
     int no;                     // channel number
     int rf_ch;                  // RF channel
     int state;                  // channel state 
     double time;                // receiver time 
     char sat[16];               // satellite ID 
     char sig[16];               // signal ID 
+    int sig_id;                 // signal ID (SDR_SIG_???)
+    const sdr_sig_t *desc;      // signal descriptor
     int prn;                    // PRN number 
-    const int8_t *code;         // primary code 
+    const sdr_code_pack_t *code; // primary code (packed)
     const int8_t *sec_code;     // secondary code
     int len_code, len_sec_code;
     double fc;                  // carrier frequency (Hz) 
@@ -165,72 +556,415 @@ typedef struct {                // SDR receiver channel type
     double fi;                  // IF freqency (Hz) 
     double T;                   // code cycle (s) 
     int N;                      // code cycle (samples) 
-    double fd;                  // Doppler frequency (Hz) 
-    double coff;                // code offset (s) 
-    double adr;                 // accumurated Doppler range (cyc) 
-    double cn0;                 // C/N0 (dB-Hz) 
+    sdr_ch_blk_t *blk;          // channel block of tracking loop states
+                                // (fd, coff, adr, cn0 by SDR_CH_???())
+    int ib;                     // index of channel in channel block
+    struct sdr_ch_tag *pilot;   // pilot channel of joint tracking (NULL: no)
     int week, tow;              // week number (week), TOW (ms)
     int tow_v;                  // TOW flag (0:invalid,1:valid,2:amb-unresolved)
     int lock, lost;             // lock and lost counts 
+    int nc;                     // code cycles of correlation interval
+    int coast;                  // code cycles coasted across IF data gaps
+    double t_aid;               // time of Doppler aiding by PVT (s) (0: none)
+    double fd_aid, fdot_aid;    // aided Doppler (Hz) and Doppler rate (Hz/s)
+    int coast_v;                // code cycles coasted by Doppler aiding across
+                                // signal blockage
+    double t_rec;               // time of recovery from signal blockage (s)
     int costas;                 // Costas PLL flag 
+    int sleep;                  // code books released (0: live, 1: sleep)
     sdr_acq_t *acq;             // signal acquisition 
     sdr_trk_t *trk;             // signal tracking 
     sdr_nav_t *nav;             // navigation decoder
+    int64_t tcpu;               // CPU time for channel (ns)
     pthread_mutex_t mtx;        // lock flag
 } sdr_ch_t;
 
+typedef struct {                // data DFT cache slot type
+    int ix, N;                  // index and number of samples
+    double fc;                  // carrier frequency to mix (Hz)
+    int stat;                   // status (0: empty, 1: computing, 2: ready,
+                                // 3: computing and invalidated)
+    int ref;                    // reference count
+    uint32_t tick;              // last used tick
+    int size;                   // allocated size of DFT
+    sdr_cpx_t *X;               // data DFT
+} sdr_dft_slot_t;
+
+typedef struct {                // data DFT cache type
+    int n;                      // number of slots
+    sdr_dft_slot_t *slot;       // slots
+    uint32_t tick;              // use tick
+    int64_t nhit, nmiss;        // number of cache hits and misses
+    pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // condition variable for DFT ready
+} sdr_dft_cache_t;
+
 typedef struct {                // IF data buffer type
     sdr_cpx8_t *data;           // IF data
     int IQ, N;                  // sampling types (1:I,2:IQ) and buffer size
+    int pack;                   // packed IF data (0:no,1:2 samples/byte)
+    sdr_cpx8_t LUT[16];         // code to sample LUT of packed IF data
+    sdr_dft_cache_t *dft;       // data DFT cache (NULL: no cache)
 } sdr_buff_t;
 
+typedef struct {                // IF data monitor type
+    double fs;                  // sampling frequency (Hz)
+    int IQ;                     // sampling type (1:I,2:IQ)
+    int ena;                    // monitor enabled
+    int N, N_req;               // FFT size and requested FFT size (0:no PSD)
+    int L, per;                 // segment size and burst period (samples)
+    int ix, ix_end;             // buffer index of next segment and next write
+    int nava, nseg, nskip;      // samples available, segments in burst and
+                                // samples to skip to next burst
+    int nave;                   // number of averaged bursts
+    double tave;                // averaging time constant (s)
+    float w_ave;                // average of window function
+    float *w;                   // window function (N)
+    float *p, *p_ave;           // power of burst and averaged power (N)
+    sdr_cpx_t *cpx;             // FFT input and output (N x 2)
+    sdr_cpx8_t *data;           // unpacked segment (L)
+    fftwf_plan plan[2];         // FFTW plans
+    uint32_t cnt[256];          // sample counts of burst
+    double hist[256];           // averaged sample histogram
+    pthread_mutex_t mtx;        // lock flag
+} sdr_mon_t;
+
+typedef struct {                // sub-band DDC (digital down converter) type
+    const sdr_buff_t *src;      // IF data buffer
+    double fs;                  // sampling rate of IF data (sps)
+    double fc;                  // center frequency of sub-band (Hz)
+    int N, D;                   // IF data cycle (sample) and decimation ratio
+    int depth;                  // depth of IF data buffers (cyc)
+    sdr_buff_t *buff;           // sub-band IF data buffer
+    int64_t ix[2];              // down-converted IF data cycles [ix[0], ix[1])
+    float scale;                // AGC scale of sub-band
+    pthread_mutex_t mtx;        // lock flag
+} sdr_ddc_t;
+
+typedef struct {                // standard correlator job type
+    int ix, N;                  // index of IF data buffer and number of samples
+    double fs, fc;              // sampling rate and IF carrier frequency (Hz)
+    double phi;                 // carrier phase of the first sample (cyc)
+    const sdr_cpx16_t *code;    // resampled code (N)
+    const int *pos;             // correlator positions (samples)
+    int npos;                   // number of correlator positions
+    sdr_cpx_t *corr;            // correlations (npos) (output)
+} sdr_corr_job_t;
+
+typedef struct {                // IF data file type
+    FILE *fp;                   // file pointer (NULL: memory-mapped)
+    uint8_t *map;               // memory-mapped file data
+    int64_t size, pos;          // file size and read position (bytes)
+    int64_t pos_rel;            // read position of pages released (bytes)
+    uint8_t *buff;              // read buffer for file pointer
+    int size_buff;              // size of read buffer (bytes)
+#ifdef WIN32
+    HANDLE hmap;                // file mapping handle
+#endif
+} sdr_file_t;
+
+typedef struct sdr_ostr_tag {   // output stream type
+    stream_t *strs[SDR_MAX_OSTR]; // streams to fan out data
+    int nstr;                   // number of streams
+    uint8_t *buff;              // ring buffer of output data
+    int size;                   // size of ring buffer (bytes)
+    int opt;                    // options (SDR_OSTR_???)
+    int64_t wp, rp;             // write and read pointer (bytes) (atomic)
+    int64_t ndrop;              // number of dropped writes (atomic)
+    pthread_mutex_t mtx;        // lock flag for multiple producers
+    struct sdr_ostr_tag *next;  // next output stream of writer thread
+} sdr_ostr_t;
+
+typedef struct {                // SDR receiver channel status snapshot type
+    uint32_t seq;               // sequence count of seqlock (odd: writing)
+    int32_t no, rfch;           // channel number and RF channel (1-)
+    int32_t state, sleep;       // channel state (SDR_STATE_???) and sleep flag
+    char sat[16], sig[16];      // satellite ID and signal ID
+    int32_t prn;                // PRN number
+    int32_t sync;               // sync flags (1:secondary code,2:bit,4:frame,
+                                // 8:polarity reversed)
+    double time;                // receiver time (s)
+    double lock;                // lock time (s)
+    double cn0;                 // C/N0 (dB-Hz)
+    double coff;                // code offset (s)
+    double fd;                  // Doppler frequency (Hz)
+    double adr;                 // accumulated Doppler range (cyc)
+    int32_t nnav, nerr;         // navigation data and error count
+    int32_t lost, fec;          // lost count and FEC error count
+} sdr_ch_stat_t;
+
 struct sdr_rcv_tag;
 
 typedef struct {                // SDR receiver channel thread type
     int state;                  // state (0:stop,1:run)
     sdr_ch_t *ch;               // SDR receiver channel
+    sdr_ch_stat_t stat;         // channel status snapshot
     int64_t ix;                 // IF data buffer read pointer (cyc)
+    const sdr_buff_t *buff;     // IF data buffer of channel
+    int N;                      // IF data cycle of channel (sample)
+    sdr_ddc_t *ddc;             // sub-band DDC of channel (NULL: no)
     struct sdr_rcv_tag *rcv;    // pointer to SDR receiver
-    pthread_t thread;           // SDR receiver channel thread
 } sdr_ch_th_t;
 
+typedef struct {                // SDR receiver channel block task type
+    int busy;                   // busy flag of tracking lanes (0:free,
+                                // 1:running on a worker)
+    int lane[SDR_CH_BLK];       // busy flags of channel lanes (0:free,
+                                // 1:claimed by a worker)
+    int nth;                    // number of channel threads
+    sdr_ch_th_t *th[SDR_CH_BLK]; // channel threads (th[k]->ch = blk->ch[k])
+    sdr_ch_blk_t *blk;          // channel block
+} sdr_blk_th_t;
+
+typedef struct {                // SDR receiver worker thread type
+    int no;                     // worker number
+    int state;                  // state (0:stop,1:run)
+    int nbt;                    // number of assigned channel block tasks
+    sdr_blk_th_t **bt;          // assigned channel block tasks
+    struct sdr_rcv_tag *rcv;    // pointer to SDR receiver
+    pthread_t thread;           // SDR receiver worker thread
+} sdr_work_t;
+
+typedef struct {                // SDR PVT observation slot type
+    int64_t ix;                 // epoch cycle of slot (cyc) (0: writing)
+    int stat;                   // status (0: no observation, 1: observation)
+    int sat;                    // satellite number
+    const sdr_sig_t *desc;      // signal descriptor
+    int week, tow, tow_v;       // week, TOW (ms) and TOW valid flag
+    double coff;                // code offset (s)
+    double coff_nav;            // code offset for L6D/E CSK (s)
+    double L, D;                // carrier phase (cyc) and Doppler (Hz)
+    double fc;                  // carrier frequency (Hz)
+    float cn0;                  // C/N0 (dB-Hz)
+    uint8_t LLI;                // loss of lock indicator
+} sdr_pvt_obs_t;
+
+typedef struct {                // SDR PVT navigation data message type
+    int64_t ix;                 // IF data cycle of navigation data (cyc)
+    int sat, prn, sig_id, type; // satellite number, PRN, signal ID and type
+    uint8_t data[SDR_MAX_DATA]; // navigation data
+} sdr_pvt_nav_t;
+
+typedef struct {                // SDR PVT satellite position cache type
+    int stat;                   // status (0: no fit, 1: fit, -1: fit error)
+    gtime_t t0;                 // start time of fit span
+    int svh;                    // satellite health flag
+    double var;                 // variance of ephemeris error (m^2)
+    double c[4][SDR_N_CHEB];    // Chebyshev coefficients of satellite position
+                                // (m) and clock bias (s)
+} sdr_pvt_sat_t;
+
+typedef struct {                // SDR PVT status snapshot type
+    uint32_t seq;               // sequence count of seqlock (odd: writing)
+    int32_t stat;               // solution status (0:none,1:fix)
+    int32_t ns, nsat;           // number of satellites of solution and
+                                // observation data
+    double time;                // solution or epoch time (GPST, s from
+                                // 1970-01-01)
+    double pos[3];              // latitude (deg), longitude (deg), height (m)
+    double rr[6];               // ECEF position (m) and velocity (m/s)
+    double dtr;                 // receiver clock bias (s)
+    double drift;               // receiver clock drift (m/s)
+    int32_t count[4];           // solution, OBS, NAV and fast-rate solution
+                                // count
+} sdr_pvt_stat_t;
+
+typedef struct {                // SDR PVT satellite status snapshot type
+    uint32_t seq;               // sequence count of seqlock (odd: writing)
+    int32_t n;                  // number of satellites above horizon
+    int32_t sat[MAXSAT];        // satellite numbers
+    float az[MAXSAT], el[MAXSAT]; // azimuth and elevation angles (deg)
+    int32_t vs[MAXSAT];         // valid satellite flags of solution
+} sdr_pvt_sat_stat_t;
+
+typedef struct {                // warm-start seed of SDR PVT type
+    int stat;                   // status (0:none,1:set,-1:expired) (atomic)
+    int64_t ix_max;             // max receiver cycle to set seed (cyc)
+    gtime_t time;               // time of PVT solution (GPST)
+    int64_t ix;                 // IF data file cycle of PVT solution (cyc)
+    double rr[6];               // receiver position and velocity (ECEF) (m)
+    double drift;               // receiver clock drift (m/s)
+    eph_t eph[MAXSAT*4];        // ephemerides
+    geph_t geph[MAXPRNGLO];     // GLONASS ephemerides
+} sdr_pvt_seed_t;
+
 typedef struct {                // SDR PVT type
     gtime_t time;               // epoch time
-    int64_t ix;                 // epoch cycle (cyc)
-    int nsat, nch;              // number of satellites and updated channels
+    int64_t ix;                 // epoch cycle (cyc) (atomic)
+    int nsat;                   // number of satellites
     obs_t *obs;                 // observation data
     nav_t *nav;                 // navigation data
     sol_t *sol;                 // PVT solution
     ssat_t *ssat;               // satellite status
+    ssat_t *ssat_w;             // satellite status (work)
+    sdr_pvt_obs_t *slot;        // observation slots of channels {SDR_MAX_NCH}
+    sdr_pvt_obs_t *slot_f;      // latest observation slots of channels for
+                                // fast-rate solution {SDR_MAX_NCH}
+    obs_t *obs_f;               // observation data at fast-rate epoch
+    sol_t *sol_f;               // fast-rate PVT solution
+    int64_t ix_fast;            // next fast-rate epoch cycle (cyc) (0: none)
+                                // (atomic)
+    sdr_pvt_nav_t *navq;        // navigation data message queue
+    sdr_pvt_sat_t *sats;        // satellite position cache {MAXSAT}
+    prcopt_t *opt;              // processing options
+    int navq_r, navq_w;         // read and write index of navigation data
+                                // message queue
+    int64_t ix_rcv;             // received IF data cycle (cyc) (atomic)
     rtcm_t *rtcm;               // RTCM control
-    int count[3];               // solution, OBS and NAV count
+    int count[4];               // solution, OBS, NAV and fast-rate solution
+                                // count
+    int64_t ix_pred;            // cycle of satellite prediction (0: none)
+    uint8_t pred[MAXSAT];       // satellite prediction status (0: none,
+                                // 1: visible, 2: below mask or unhealthy)
+    float pred_rate[MAXSAT];    // predicted range rate with receiver clock
+                                // drift (m/s)
+    float pred_acc[MAXSAT];     // predicted range acceleration (m/s^2)
+    double drift;               // estimated receiver clock drift (m/s)
+    int64_t ix_warm;            // cycle of warm-start (0: none)
+    gtime_t time_warm;          // time of warm-start
+    float rate_warm[MAXSAT];    // range rates of warm-start state (m/s)
+    int64_t ix_state;           // cycle of last saved warm-start state
+    sdr_pvt_stat_t stat;        // PVT status snapshot
+    sdr_pvt_sat_stat_t sat_stat; // PVT satellite status snapshot
     struct sdr_rcv_tag *rcv;    // pointer to SDR receiver
+    int state;                  // state of PVT thread (0:stop,1:run)
+    pthread_t thread;           // PVT thread
     pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // PVT epoch update condition
 } sdr_pvt_t;
 
+typedef struct {                // SDR receiver status snapshot type
+    uint32_t seq;               // sequence count of seqlock (odd: writing)
+    uint32_t ver;               // version (SDR_STAT_VER)
+    uint32_t size[3];           // sizes of receiver, PVT and channel status
+                                // snapshot types (bytes)
+    int32_t state;              // receiver state (0:stop,1:run)
+    int32_t dev, fmt;           // SDR device type and IF data format
+    int32_t nrf;                // number of RF channels
+    double time;                // receiver time (s)
+    double fs;                  // IF data sampling rate (sps)
+    double fo[SDR_MAX_RFCH];    // LO frequencies (Hz)
+    int32_t IQ[SDR_MAX_RFCH];   // IF sampling types (I:1,I/Q:2)
+    int32_t nch, ntrk;          // number of receiver and tracking channels
+    int32_t nsrch, nlive;       // number of search and live channels
+    char sys[8];                // navigation systems of tracking channels
+    double data_rate;           // IF data rate (MB/s)
+    double data_sum;            // IF data log size (MB)
+    double buff_use, buff_max;  // buffer usage and peak buffer usage (%)
+    double usb_max;             // peak usage of USB transfer buffers (%)
+    int64_t ngap[3];            // IF data gaps by overrun, error and lapped
+                                // channels (cyc)
+    int64_t ndrop[3];           // dropped writes of NMEA, RTCM3 and IF data
+                                // log streams (-1: no stream)
+} sdr_rcv_stat_t;
+
 typedef struct sdr_rcv_tag {    // SDR receiver type
     int state;                  // state (0:stop,1:run)
     int dev;                    // SDR device type (SDR_DEV_???)
-    void *dp;                   // SDR device pointer
+    void *dp;                   // SDR device pointer (first device)
+    int ndev;                   // number of SDR devices
+    void *dps[SDR_MAX_DEV];     // SDR device pointers
     int fmt;                    // IF data format (SDR_FMT_???)
     double fs;                  // IF data sampling rate (sps) 
     double fo[SDR_MAX_RFCH];    // LO frequencies (Hz)
     int IQ[SDR_MAX_RFCH];       // IF sampling types (I:1,I/Q:2)
     int N;                      // IF data cycle (sample)
+    int depth;                  // depth of IF data buffers (cyc)
+    uint8_t *gap;               // gap flags of IF data cycles {depth}
+    int64_t ngap[3];            // IF data gaps by overrun, error and lapped
+                                // channels (cyc)
     int nch, nbuff;             // number of receiver channels and IF buffers
-    int ich;                    // signal search channel index
+    int ich;                    // last blind signal search channel index
+    int nsrch;                  // number of signal search channels
+    int nlive;                  // number of live channels
     sdr_ch_th_t *th[SDR_MAX_NCH]; // SDR receiver channel threads
+    int nblk;                   // number of channel blocks
+    sdr_ch_blk_t *blk[SDR_MAX_NCH]; // channel blocks
+    int nwork;                  // number of worker threads
+    sdr_work_t *work[SDR_MAX_WORK]; // SDR receiver worker threads
     sdr_buff_t *buff[SDR_MAX_RFCH]; // IF data buffers
+    sdr_mon_t *mon[SDR_MAX_RFCH]; // IF data monitors
+    int nddc;                   // number of sub-band DDCs
+    sdr_ddc_t *ddc[SDR_MAX_NCH]; // sub-band DDCs
     int64_t ix;                 // IF data cycle count (cyc)
-    double tscale;              // time scale to replay IF data file
+    sdr_lat_t lat;              // wakeup latency of worker threads
+    int64_t perf_t0;            // start time of performance counters (ns)
+    double tscale;              // time scale to replay IF data file (0:max)
+    int64_t ix_out, ix_end;     // output window of file replay (cyc) (0:all)
+    int64_t ix_file;            // IF data file cycle at cycle 0 (cyc)
+    sdr_pvt_seed_t *seed;       // warm-start seed of PVT shared by receivers
+                                // of batch (NULL: none)
     double data_rate, data_sum; // IF data rate (MB/s) and size (MB)
-    double buff_use;            // buffer usage (%)
+    double buff_use, buff_max;  // buffer usage and peak buffer usage (%)
     sdr_pvt_t *pvt;             // SDR PVT
-    stream_t *strs[4];          // NMEA, RTCM3 and IF data log streams
+    sdr_ostr_t *strs[5];        // NMEA, RTCM3, IF data log and fast-rate PVT
+                                // streams
+    sdr_rcv_stat_t stat;        // receiver status snapshot
     pthread_t thread;           // SDR receiver thread
     pthread_mutex_t mtx;        // lock flag
+    pthread_cond_t cond;        // IF data buffer update condition
+    pthread_cond_t cond_rd;     // IF data buffer read condition
 } sdr_rcv_t;
 
+typedef struct {                // IF signal simulator satellite type
+    char sig[16];               // signal type
+    int prn;                    // PRN number (FCN for GLONASS FDMA)
+    int rfch;                   // RF channel
+    double fc, fi;              // carrier and IF frequency (Hz)
+    double T;                   // primary code cycle (s)
+    int len_code;               // primary code length (chip)
+    const int8_t *code;         // primary code
+    const int8_t *sec_code;     // secondary code
+    int len_sec_code;           // secondary code length
+    double dop, rate;           // Doppler (Hz) and Doppler rate (Hz/s)
+    double cn0;                 // C/N0 (dB-Hz)
+    double coff;                // code offset (s)
+    double phi;                 // carrier phase at time 0 (cyc)
+    float amp;                  // signal amplitude
+    uint8_t *data;              // nav data symbols (0 or 1) (NULL: no data)
+    int len_data;               // length of nav data symbols
+    int ncyc;                   // number of code cycles per nav data symbol
+} sdr_sim_sat_t;
+
+typedef struct {                // IF signal simulator type
+    int fmt;                    // IF data format (SDR_FMT_???)
+    double fs;                  // sampling rate (sps)
+    double fo[SDR_MAX_RFCH];    // LO frequencies (Hz)
+    int IQ[SDR_MAX_RFCH];       // IF sampling types (I:1,I/Q:2)
+    int nrfch;                  // number of RF channels
+    uint32_t seed;              // seed of noise
+    int nthread;                // number of threads
+    int64_t ix;                 // sample index of next IF data
+    sdr_sim_sat_t *sats;        // satellite signals
+    int nsat, nmax;             // number and max number of satellite signals
+} sdr_sim_t;
+
+typedef struct {                // snapshot positioning solution type
+    gtime_t time;               // time of solution (GPST)
+    double rr[3];               // receiver position (ECEF) (m)
+    double dtr;                 // receiver clock bias (s)
+    int nsig;                   // number of signals acquired
+    int ns;                     // number of satellites (0: no solution)
+} sdr_snap_sol_t;
+
+typedef struct {                // snapshot positioning job type
+    gtime_t time;               // capture time of snapshot (GPST)
+    double toff;                // time offset of snapshot in IF data file (s)
+    double rr[3];               // coarse receiver position (ECEF) (m)
+                                // (0: no coarse position)
+    sdr_snap_sol_t sol;         // solution (output)
+} sdr_snap_job_t;
+
+typedef struct {                // snapshot positioning engine type
+    const nav_t *nav;           // navigation data
+    int sys;                    // navigation systems (SYS_???)
+    double fs, fi;              // sampling and IF frequency (Hz)
+    int IQ;                     // sampling type (1:I,2:IQ)
+    double tint;                // integration time of signal search (s)
+    int nbook;                  // number of code books
+    sdr_code_book_t **book;     // code books of code FFTs (NULL: not selected)
+} sdr_snap_t;
+
 // function prototypes -------------------------------------------------------
 
 // sdr_cmn.c
@@ -239,6 +973,32 @@ void sdr_free(void *p);
 void sdr_get_time(double *t);
 uint32_t sdr_get_tick(void);
 void sdr_sleep_msec(int msec);
+int sdr_get_ncpu(void);
+int sdr_set_thread(int cpu, int pri);
+int64_t sdr_get_tick_us(void);
+int64_t sdr_get_tick_ns(void);
+int64_t sdr_perf_add(int stage, int64_t t0);
+void sdr_perf_get(sdr_perf_t *perf);
+void sdr_perf_reset(void);
+int sdr_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mtx, int msec);
+void sdr_seq_begin(uint32_t *seq);
+void sdr_seq_end(uint32_t *seq);
+int sdr_seq_read(const uint32_t *seq, void *dst, const void *src, size_t size);
+void *sdr_scratch_alloc(size_t size);
+void sdr_scratch_free(void *p);
+void sdr_scratch_clear(void);
+void sdr_alloc_stat(int64_t *stat);
+void *sdr_mem_alloc(size_t size, int node);
+void sdr_mem_free(void *p);
+int sdr_mem_bind(void *p, int node);
+int sdr_mem_page(const void *p);
+int sdr_mem_node(int cpu);
+int sdr_mem_nnode(void);
+void sdr_mem_stat(double *stat);
+sdr_file_t *sdr_file_open(const char *path);
+void sdr_file_close(sdr_file_t *file);
+int sdr_file_seek(sdr_file_t *file, int64_t pos);
+int sdr_file_read(sdr_file_t *file, int size, uint8_t **data);
 
 // sdr_usb.c
 sdr_usb_t *sdr_usb_open(int bus, int port, const uint16_t *vid,
@@ -250,12 +1010,27 @@ int sdr_usb_req(sdr_usb_t *usb, int mode, uint8_t req, uint16_t val,
 // sdr_dev.c
 sdr_dev_t *sdr_dev_open(int bus, int port);
 void sdr_dev_close(sdr_dev_t *dev);
+int sdr_dev_set_buff(sdr_dev_t *dev, int nbuff, int size);
+int sdr_dev_set_frame(sdr_dev_t *dev, int ena);
+int sdr_dev_share(sdr_dev_t *dev, const char *name);
+sdr_dev_t *sdr_dev_attach(const char *name);
+int sdr_dev_stream(sdr_dev_t *dev, const char *addr);
+sdr_dev_t *sdr_dev_connect(const char *addr);
+void sdr_dev_set_thread(sdr_dev_t *dev, int cpu, int pri);
 int sdr_dev_start(sdr_dev_t *dev);
 int sdr_dev_stop(sdr_dev_t *dev);
 int sdr_dev_read(sdr_dev_t *dev, uint8_t *buff, int size);
+int sdr_dev_wait(sdr_dev_t *dev, int size, int msec);
+int sdr_dev_peek(sdr_dev_t *dev, int size, uint8_t **data);
+int64_t sdr_dev_sync(sdr_dev_t *dev, int align);
+int sdr_dev_check(sdr_dev_t *dev, int size);
+void sdr_dev_consume(sdr_dev_t *dev, int size);
 int sdr_dev_get_info(sdr_dev_t *dev, int *fmt, double *fs, double *fo, int *IQ);
 int sdr_dev_get_gain(sdr_dev_t *dev, int ch);
 int sdr_dev_set_gain(sdr_dev_t *dev, int ch, int gain);
+int sdr_dev_read_regs(sdr_dev_t *dev, int ch, int addr, int n, uint32_t *regs);
+int sdr_dev_write_regs(sdr_dev_t *dev, int ch, int addr, int n,
+    const uint32_t *regs);
 
 // sdr_conf.c
 int sdr_conf_read(sdr_dev_t *dev, const char *file, int opt);
@@ -263,19 +1038,44 @@ int sdr_conf_write(sdr_dev_t *dev, const char *file, int opt);
 
 // sdr_func.c
 void sdr_func_init(const char *file);
+int sdr_set_simd(int simd);
+int sdr_get_simd(void);
+int sdr_set_mix(int mix);
 sdr_cpx_t *sdr_cpx_malloc(int N);
 void sdr_cpx_free(sdr_cpx_t *cpx);
 float sdr_cpx_abs(sdr_cpx_t cpx);
 void sdr_cpx_mul(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
     sdr_cpx_t *c);
 sdr_buff_t *sdr_buff_new(int N, int IQ);
+sdr_buff_t *sdr_buff_new_pack(int N, int IQ);
+sdr_cpx8_t sdr_buff_get(const sdr_buff_t *buff, int ix);
 void sdr_buff_free(sdr_buff_t *buff);
+sdr_dft_cache_t *sdr_dft_cache_new(int n);
+void sdr_dft_cache_free(sdr_dft_cache_t *cache);
+void sdr_dft_cache_inval(sdr_buff_t *buff, int ix, int N);
 sdr_buff_t *sdr_read_data(const char *file, double fs, int IQ, double T,
     double toff);
+sdr_buff_t *sdr_file_read_data(sdr_file_t *fp, double fs, int IQ, double T,
+    double toff);
 void sdr_search_code(const sdr_cpx_t *code_fft, double T,
     const sdr_buff_t *buff, int ix, int N, double fs, double fi,
     const float *fds, int len_fds, float *P);
+float sdr_search_code_max(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P, int Nmax, int *ixp);
+void sdr_search_code_cpx(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, int Nmax, sdr_cpx_t *C);
+void sdr_search_code_buff_cpx(const sdr_cpx_t *code_fft, double T,
+    const sdr_cpx_t *buff, int len_buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P);
+float sdr_search_code_dec(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, int D, double fs, double fi,
+    const float *fds, int len_fds, float *P, int Nmax, int *ixp);
 float sdr_corr_max(const float *P, int N, int M, int Nmax, double T, int *ix);
+int sdr_acq_batch(sdr_acq_job_t *jobs, int n, const sdr_buff_t *buff,
+    double fs, double fi, int zero_pad, int nthread);
+void sdr_atan2_blk(const double *y, const double *x, int n, double *z);
 double sdr_fine_dop(const float *P, int N, const float *fds, int len_fds,
     const int *ix);
 double sdr_shift_freq(const char *sig, int fcn, double fi);
@@ -283,6 +1083,9 @@ float *sdr_dop_bins(double T, float dop, float max_dop, int *len_fds);
 void sdr_corr_std(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, const sdr_cpx16_t *code, const int *pos, int n,
     sdr_cpx_t *corr);
+void sdr_code_nco(const sdr_code_pack_t *code, double phi, double step, int N,
+    sdr_cpx16_t *code_res);
+void sdr_corr_std_multi(const sdr_buff_t *buff, sdr_corr_job_t *jobs, int n);
 void sdr_corr_std_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     double fs, double fc, double phi, const float *code, const int *pos, int n,
     sdr_cpx_t *corr);
@@ -293,16 +1096,38 @@ void sdr_corr_fft_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
     sdr_cpx_t *corr);
 void sdr_mix_carr(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
     double phi, sdr_cpx16_t *IQ);
+sdr_csk_t *sdr_csk_new(const sdr_code_pack_t *code, int N, int nsym);
+void sdr_csk_free(sdr_csk_t *csk);
+int sdr_csk_corr(sdr_csk_t *csk, const sdr_buff_t *buff, int ix, double fs,
+    double fc, double phi, double chip, double step, const int *pos, int n,
+    sdr_cpx_t *corr);
 void sdr_psd_cpx(const sdr_cpx_t *buff, int len_buff, int N, double fs, int IQ,
     float *psd);
+sdr_mon_t *sdr_mon_new(double fs, int IQ);
+void sdr_mon_free(sdr_mon_t *mon);
+void sdr_mon_update(sdr_mon_t *mon, const sdr_buff_t *buff, int ix, int n);
+int sdr_mon_psd(sdr_mon_t *mon, double tave, int N, float *psd);
+int sdr_mon_hist(sdr_mon_t *mon, double tave, int *val, double *hist1,
+    double *hist2);
+int sdr_ddc_dec(double fs, int N, double fs_min);
+sdr_ddc_t *sdr_ddc_new(const sdr_buff_t *buff, double fs, double fc, int N,
+    int D);
+void sdr_ddc_free(sdr_ddc_t *ddc);
+void sdr_ddc_update(sdr_ddc_t *ddc, int64_t ix, int n);
+void sdr_par_for(int n, int nthread, void (*func)(void *, int), void *arg);
 stream_t *sdr_str_open(const char *path);
 void sdr_str_close(stream_t *str);
 int sdr_str_write(stream_t *str, uint8_t *data, int size);
+sdr_ostr_t *sdr_ostr_open(const char *path, int size, int opt);
+void sdr_ostr_close(sdr_ostr_t *ostr);
+int sdr_ostr_write(sdr_ostr_t *ostr, const uint8_t *data, int size);
 int sdr_log_open(const char *path);
 void sdr_log_close(void);
 void sdr_log_level(int level);
+void sdr_log_format(int format);
 void sdr_log(int level, const char *msg, ...);
 int sdr_get_log(char *buff, int size);
+int sdr_log_conv(FILE *ifp, FILE *ofp);
 int sdr_parse_nums(const char *str, int *prns);
 void sdr_add_buff(void *buff, int len_buff, void *item, size_t size_item);
 void sdr_pack_bits(const uint8_t *data, int nbit, int nz, uint8_t *buff);
@@ -310,24 +1135,52 @@ void sdr_unpack_bits(const uint8_t *data, int nbit, uint8_t *buff);
 void sdr_unpack_data(uint32_t data, int nbit, uint8_t *buff);
 uint8_t sdr_xor_bits(uint32_t X);
 int sdr_gen_fftw_wisdom(const char *file, int N);
+int sdr_fftw_plan(int N, int M, fftwf_plan *plan);
+int sdr_search_plan(int N, int len_fds);
+int sdr_fftw_import(const char *file);
+int sdr_fftw_export(void);
 
 // sdr_code.c
 int8_t *sdr_gen_code(const char *sig, int prn, int *N);
+const sdr_code_pack_t *sdr_gen_code_pack(const char *sig, int prn);
 int8_t *sdr_sec_code(const char *sig, int prn, int *N);
 double sdr_code_cyc(const char *sig);
 int sdr_code_len(const char *sig);
 double sdr_sig_freq(const char *sig);
+int sdr_sig_id(const char *sig);
+const sdr_sig_t *sdr_sig_get(int id);
 void sdr_sat_id(const char *sig, int prn, char *sat);
 uint8_t sdr_sig_code(const char *sig);
 void sdr_res_code(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx16_t *code_res);
 void sdr_gen_code_fft(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx_t *code_fft);
+void sdr_res_code_pack(const sdr_code_pack_t *code, double T, double coff,
+    double fs, int N, int Nz, sdr_cpx16_t *code_res);
+void sdr_gen_code_fft_pack(const sdr_code_pack_t *code, double T, double coff,
+    double fs, int N, int Nz, sdr_cpx_t *code_fft);
+int sdr_code_book_file(const char *file);
+sdr_code_book_t *sdr_code_book_get(const char *sig, int prn, double fs, int N,
+    int Nz, int nbank, int type);
+void sdr_code_book_put(sdr_code_book_t *book);
+int sdr_code_book_save(void);
 
 // sdr_ch.c
 sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi);
 void sdr_ch_free(sdr_ch_t *ch);
+void sdr_ch_set_nco(const char *sigs);
 void sdr_ch_update(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix);
+void sdr_ch_coast(sdr_ch_t *ch, double time);
+int sdr_ch_join(sdr_ch_t *data, sdr_ch_t *pilot);
+void sdr_ch_aid(sdr_ch_t *ch, double time, double fd, double fdot);
+int sdr_ch_sleep(sdr_ch_t *ch);
+int sdr_ch_wake(sdr_ch_t *ch);
+int sdr_ch_ncyc(const sdr_ch_t *ch);
+sdr_ch_blk_t *sdr_ch_blk_new(void);
+void sdr_ch_blk_free(sdr_ch_blk_t *blk);
+int sdr_ch_blk_add(sdr_ch_blk_t *blk, sdr_ch_t *ch);
+void sdr_ch_blk_update(sdr_ch_blk_t *blk, uint32_t mask, const double *time,
+    const sdr_buff_t *const *buff, const int *ix, int *ncyc);
 void sdr_ch_set_corr(sdr_ch_t *ch, int npos);
 int sdr_ch_corr_stat(sdr_ch_t *ch, double *stat, int *pos, sdr_cpx_t *C);
 int sdr_ch_corr_hist(sdr_ch_t *ch, double tspan, double *stat, sdr_cpx_t *P);
@@ -336,27 +1189,62 @@ int sdr_ch_corr_hist(sdr_ch_t *ch, double tspan, double *stat, sdr_cpx_t *P);
 sdr_nav_t *sdr_nav_new(void);
 void sdr_nav_free(sdr_nav_t *nav);
 void sdr_nav_init(sdr_nav_t *nav);
+void sdr_nav_add_sym(sdr_nav_t *nav, uint8_t sym);
+void sdr_nav_add_ssym(sdr_nav_t *nav, float P);
 void sdr_nav_decode(sdr_ch_t *ch);
+int sdr_nav_async(int nth);
+int sdr_nav_queue(void);
 
 // sdr_fec.c
+void sdr_vit_init(sdr_vit_t *vit, int state);
+void sdr_vit_update(sdr_vit_t *vit, const uint8_t *syms, int N);
+int sdr_vit_chainback(const sdr_vit_t *vit, int state, int nbits, int ntail,
+    uint8_t *bits);
 void sdr_decode_conv(const uint8_t *data, int N, uint8_t *dec_data);
 int sdr_decode_rs(uint8_t *syms);
 
 // sdr_ldpc.c
 int sdr_decode_LDPC(const char *type, const uint8_t *syms, int N,
     uint8_t *syms_dec);
+int sdr_decode_LDPC_soft(const char *type, const uint8_t *syms, int N,
+    uint8_t *syms_dec);
 
 // sdr_nb_ldpc.c
 int sdr_decode_NB_LDPC(const uint8_t H_idx[][4], const uint8_t H_ele[][4],
     int m, int n, const uint8_t *syms, uint8_t *syms_dec);
 
+// sdr_sim.c
+sdr_sim_t *sdr_sim_new(int fmt, double fs, const double *fo, const int *IQ,
+    uint32_t seed, int nthread);
+void sdr_sim_free(sdr_sim_t *sim);
+int sdr_sim_add_sat(sdr_sim_t *sim, const char *sig, int prn, double dop,
+    double rate, double cn0, double coff, const uint8_t *data, int len_data,
+    int ncyc);
+int sdr_sim_gen(sdr_sim_t *sim, int N, uint8_t *raw);
+
+// sdr_snap.c
+sdr_snap_t *sdr_snap_new(const nav_t *nav, int sys, double fs, double fi,
+    double tint);
+void sdr_snap_free(sdr_snap_t *snap);
+int sdr_snap_pos(sdr_snap_t *snap, gtime_t time, const sdr_buff_t *buff,
+    const double *rr, int nthread, sdr_snap_sol_t *sol);
+int sdr_snap_batch(sdr_snap_t *snap, sdr_file_t *fp, sdr_snap_job_t *jobs,
+    int n, int nthread);
+
 // sdr_pvt.c
 sdr_pvt_t *sdr_pvt_new(sdr_rcv_t *rcv);
 void sdr_pvt_free(sdr_pvt_t *pvt);
+int sdr_pvt_start(sdr_pvt_t *pvt);
+int sdr_pvt_nav_queue(sdr_pvt_t *pvt);
 void sdr_pvt_udobs(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch);
 void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch);
 void sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix);
 void sdr_pvt_solstr(sdr_pvt_t *pvt, char *buff);
+int sdr_pvt_pred_dop(sdr_pvt_t *pvt, int64_t ix, const char *sat, double fc,
+    float *fd, float *fdot);
+int sdr_pvt_save_state(sdr_pvt_t *pvt, const char *file);
+int sdr_pvt_load_state(sdr_pvt_t *pvt, const char *file);
+int sdr_pvt_load_seed(sdr_pvt_t *pvt, const sdr_pvt_seed_t *seed);
 
 // sdr_rcv.c
 sdr_rcv_t *sdr_rcv_new(const char **sigs, const int *prns, int n, int fmt,
@@ -366,15 +1254,30 @@ int sdr_rcv_start(sdr_rcv_t *rcv, int dev, void *dp, const char **paths);
 void sdr_rcv_stop(sdr_rcv_t *rcv);
 sdr_rcv_t *sdr_rcv_open_dev(const char **sigs, int *prns, int n, int bus,
     int port, const char *conf_file, const char **paths);
+sdr_rcv_t *sdr_rcv_open_devs(const char **sigs, int *prns, int n,
+    const int *bus, const int *port, int ndev, const char **conf_files,
+    const char **paths);
+sdr_rcv_t *sdr_rcv_open_shm(const char **sigs, int *prns, int n,
+    const char *name, const char **paths);
+sdr_rcv_t *sdr_rcv_open_net(const char **sigs, int *prns, int n,
+    const char *addr, const char **paths);
 sdr_rcv_t *sdr_rcv_open_file(const char **sigs, int *prns, int n, int fmt,
     double fs, const double *fo, const int *IQ, double toff, double tscale,
     const char *file, const char **paths);
+int sdr_rcv_batch(const char **sigs, int *prns, int n, int fmt, double fs,
+    const double *fo, const int *IQ, double toff, double tseg, double tovl,
+    int nrun, const char *file, const char **paths);
 void sdr_rcv_close(sdr_rcv_t *rcv);
 void sdr_rcv_setopt(const char *opt, double value);
-char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv);
-char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys);
+void sdr_rcv_setopt_str(const char *opt, const char *str);
+char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv, char *buff);
+char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys, char *buff);
 char *sdr_rcv_ch_stat(sdr_rcv_t *rcv, const char *sys, int all);
 void sdr_rcv_sel_ch(sdr_rcv_t *rcv, int ch);
+int sdr_rcv_lat_stat(sdr_rcv_t *rcv, double *stat);
+int sdr_rcv_perf_stat(sdr_rcv_t *rcv, double *stat);
+int sdr_rcv_get_stat(sdr_rcv_t *rcv, sdr_rcv_stat_t *stat, sdr_pvt_stat_t *pvt,
+    sdr_ch_stat_t *chs, int nmax);
 int sdr_rcv_corr_stat(sdr_rcv_t *rcv, int ch, double *stat, int *pos,
     sdr_cpx_t *C);
 int sdr_rcv_corr_hist(sdr_rcv_t *rcv, int ch, double tspan, double *stat,
@@ -15,6 +15,40 @@
 //  2024-04-28  1.7  modify API sdr_ch_new()
 //  2024-06-06  1.8  modify API sdr_ch_new()
 //  2024-06-10  1.9  add API sdr_ch_stat_req(), sdr_ch_stat_get()
+//  2026-10-14  1.10 no sleep on search failure for worker thread pool
+//                   use scratch arena for L6 correlator buffers
+//                   share code FFTs and resampled codes by code books
+//                   store primary codes bit-packed
+//                   add API sdr_ch_set_nco()
+//                   search max correlation power in code search
+//                   search Doppler window of external assist
+//                   resolve signal ID and descriptor in sdr_ch_new()
+//                   ring buffer of P correlation history
+//                   move tracking loop states to channel block,
+//                   add APIs sdr_ch_blk_new(), sdr_ch_blk_free(),
+//                   sdr_ch_blk_add(), sdr_ch_blk_update()
+//                   batched FLL/PLL, DLL and C/N0 update of channel block
+//                   multi-channel standard correlator of channel block
+//                   add API sdr_ch_coast() to coast NCOs across IF data gaps
+//  2026-10-15  1.11 count performance of signal search and tracking and CPU
+//                   time of channels
+//                   add long integration acquisition for weak signals
+//                   add API sdr_ch_join() for joint tracking of data and pilot
+//                   channels
+//                   add API sdr_ch_aid() for Doppler aiding of tracking loops
+//                   by PVT, coast aided channels across signal blockages
+//                   add API sdr_ch_ncyc(), modify API sdr_ch_blk_update() for
+//                   coherent integration over multiple code cycles
+//                   demodulate L6D/L6E CSK by CSK demodulator of chip-rate FFT
+//                   correlator
+//                   add APIs sdr_ch_sleep(), sdr_ch_wake() to release code
+//                   books of IDLE channels
+//                   blind search of long code signals by decimated search of
+//                   partial code followed by full code search in Doppler
+//                   window
+//                   plan FFTs of signal search at channel generation
+//                   limit Doppler window of external assist by Doppler bins of
+//                   blind search, add valid flag of external assist
 //
 #include <ctype.h>
 #include <math.h>
@@ -37,7 +71,23 @@
 #define THRES_SYNC 0.02     // threshold for sec-code sync
 #define THRES_LOST 0.002    // threshold for sec-code lost
 #define N_CODE     10       // number of resampled code bank
+#define N_CSK      256      // number of CSK symbols
 #define ADD_CORR   40       // number of additional correlators
+#define T_COAST    0.5      // max time to coast across IF data gaps (s)
+#define T_AID      5.0      // max age of Doppler aiding (s)
+#define T_VCOAST   10.0     // max time to coast by Doppler aiding (s)
+#define T_INT      0.0      // max coherent integration time for tracking (s)
+#define MAX_INT    20       // max code cycles of coherent integration
+#define T_ACQ_L    0.0      // integration time for long integration acquis.
+                            // (s) (0: no long integration)
+#define T_COH      0.010    // coherent integration time for long integ. (s)
+#define THRES_CN0_W 21.0    // C/N0 threshold (dB-Hz) (long integration)
+#define MAX_COH    32       // max code cycles of coherent integration
+#define MAX_HYP    16       // max secondary code hypotheses
+#define MAX_MEM_L  (64 << 20) // max memory for long integration (bytes)
+#define T_PART     0.004    // partial code length of decimated search (s)
+#define MAX_T_DEC  0.020    // max code cycle of decimated search (s)
+#define DEC_OSR    2.0      // min sampling rate of decimated search (* chip)
 
 #define DPI        (2.0 * PI)
 #define SQR(x)     ((x) * (x)) 
@@ -55,6 +105,21 @@ double sdr_b_fll_n = B_FLL_N;
 double sdr_max_dop = MAX_DOP;
 double sdr_thres_cn0_l = THRES_CN0_L;
 double sdr_thres_cn0_u = THRES_CN0_U;
+double sdr_t_acq_l = T_ACQ_L;
+double sdr_t_coh   = T_COH;
+double sdr_thres_cn0_w = THRES_CN0_W;
+double sdr_t_int   = T_INT;
+
+static char nco_sigs[256] = ""; // signals tracked with code NCO
+
+static const struct {           // code cycles per navigation data symbol
+    const char *sig;            // (0: pilot)
+    int nsym;
+} sym_sigs[] = {
+    {"L1CA", 20}, {"L5I" , 10}, {"E5AI", 20}, {"E5BI",  4}, {"L5Q" ,  0},
+    {"E1C" ,  0}, {"E5AQ",  0}, {"E5BQ",  0}, {"B2AP",  0}, {"L1CP",  0},
+    {"B1CP",  0}
+};
 
 // upper cases of signal string ------------------------------------------------
 static void sig_upper(const char *sig, char *Sig)
@@ -67,18 +132,65 @@ static void sig_upper(const char *sig, char *Sig)
     Sig[i] = '\0';
 }
 
+// test signal tracked with code NCO -------------------------------------------
+static int is_nco_sig(const char *sig)
+{
+    int n = (int)strlen(sig);
+    
+    for (const char *p = nco_sigs; (p = strstr(p, sig)); p += n) {
+        if ((p == nco_sigs || p[-1] == ',') && (!p[n] || p[n] == ',')) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// get code book of signal acquisition -----------------------------------------
+//  The code book of the partial code FFT is also got for the decimated search.
+static int acq_book(sdr_acq_t *acq, const char *sig, int prn, double fs, int N)
+{
+    acq->book = sdr_code_book_get(sig, prn, fs, N, N, 1, SDR_CODE_FFT);
+    acq->code_fft = acq->book ? acq->book->code_fft : NULL;
+    if (acq->D > 0) {
+        int M = 2 * N / acq->D;
+        acq->book_d = sdr_code_book_get(sig, prn, fs / acq->D, acq->Np,
+            M - acq->Np, 1, SDR_CODE_FFT);
+        acq->code_fft_d = acq->book_d ? acq->book_d->code_fft : NULL;
+        if (!acq->book_d) return 0;
+    }
+    return acq->book != NULL;
+}
+
 // new signal acquisition ------------------------------------------------------
-static sdr_acq_t *acq_new(const int8_t *code, int len_code, double T, double fs,
-    int N)
+//  The long code signal is searched by the partial code of about T_PART s in
+//  the IF data decimated to DEC_OSR samples per chip.
+static sdr_acq_t *acq_new(const char *sig, int prn, int len_code, double T,
+    double fs, int N)
 {
     sdr_acq_t *acq = (sdr_acq_t *)sdr_malloc(sizeof(sdr_acq_t));
     
-    acq->code_fft = sdr_cpx_malloc(2 * N);
-    sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, N, acq->code_fft);
+    if (T > T_PART && T <= MAX_T_DEC) {
+        int n = (int)(T / T_PART + 0.5); // partial codes in code cycle
+        acq->D = sdr_ddc_dec(fs, N, DEC_OSR * len_code / T);
+        acq->Np = N / acq->D / n;
+        acq->fds_d = sdr_dop_bins(T / n, 0.0, sdr_max_dop, &acq->len_fds_d);
+    }
+    acq_book(acq, sig, prn, fs, N);
+    acq->ext = 0;
     acq->fd_ext = 0.0;
+    acq->max_dop_ext = 0.0;
     acq->fds = sdr_dop_bins(T, 0.0, sdr_max_dop, &acq->len_fds);
+    acq->fds_ext = (float *)sdr_malloc(sizeof(float) * acq->len_fds);
+    
+    // plan FFTs of signal search before worker threads run
+    sdr_search_plan(2 * N, acq->len_fds);
+    if (acq->D > 0) sdr_search_plan(2 * N / acq->D, acq->len_fds_d);
     acq->P_sum = NULL;
     acq->n_sum = 0;
+    acq->K = acq->n_hyp = 0;
+    acq->hyp = NULL;
+    acq->C = NULL;
+    acq->P_blk = NULL;
     return acq;
 }
 
@@ -86,15 +198,37 @@ static sdr_acq_t *acq_new(const int8_t *code, int len_code, double T, double fs,
 static void acq_free(sdr_acq_t *acq)
 {
     if (!acq) return;
-    sdr_cpx_free(acq->code_fft);
+    sdr_code_book_put(acq->book);
+    sdr_code_book_put(acq->book_d);
     sdr_free(acq->fds);
+    sdr_free(acq->fds_ext);
+    sdr_free(acq->fds_d);
     sdr_free(acq->P_sum);
+    sdr_free(acq->hyp);
+    sdr_free(acq->C);
+    sdr_free(acq->P_blk);
     sdr_free(acq);
 }
 
+// get code book or CSK demodulator of signal tracking -------------------------
+static int trk_book(sdr_trk_t *trk, const char *sig, int prn, int csk, double T,
+    double fs)
+{
+    int N = (int)(fs * T);
+    
+    if (csk) {
+        trk->csk = sdr_csk_new(sdr_gen_code_pack(sig, prn), N, N_CSK);
+        return trk->csk != NULL;
+    }
+    if (is_nco_sig(sig)) return 1;
+    trk->book = sdr_code_book_get(sig, prn, fs, N, 0, N_CODE, SDR_CODE_RES);
+    trk->code = trk->book ? trk->book->code_res : NULL;
+    return trk->book != NULL;
+}
+
 // new signal tracking ---------------------------------------------------------
-static sdr_trk_t *trk_new(const char *sig, int prn, const int8_t *code,
-    int len_code, double T, double fs)
+static sdr_trk_t *trk_new(const char *sig, int prn, int len_code, int csk,
+    double T, double fs)
 {
     sdr_trk_t *trk = (sdr_trk_t *)sdr_malloc(sizeof(sdr_trk_t));
     int i = 0, npos = (SDR_N_CORR - 5) / 2;
@@ -109,24 +243,7 @@ static sdr_trk_t *trk_new(const char *sig, int prn, const int8_t *code,
     }
     trk->npos = 4;
     trk->sec_sync = trk->sec_pol = 0;
-    trk->err_phas = 0.0;
-    trk->sumP = trk->sumE = trk->sumL = trk->sumN = 0.0;
-    int N = (int)(fs * T);
-    if (!strcmp(sig, "L6D") || !strcmp(sig, "L6E")) {
-        trk->code_fft = sdr_cpx_malloc(N * N_CODE);
-        for (int i = 0; i < N_CODE; i++) {
-            double coff = -i / fs / N_CODE;
-            sdr_gen_code_fft(code, len_code, T, coff, fs, N, 0,
-                trk->code_fft + i * N);
-        }
-    }
-    else {
-        trk->code = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N * N_CODE);
-        for (int i = 0; i < N_CODE; i++) {
-            double coff = -i / fs / N_CODE;
-            sdr_res_code(code, len_code, T, coff, fs, N, 0, trk->code + i * N);
-        }
-    }
+    trk_book(trk, sig, prn, csk, T, fs);
     return trk;
 }
 
@@ -134,11 +251,24 @@ static sdr_trk_t *trk_new(const char *sig, int prn, const int8_t *code,
 static void trk_free(sdr_trk_t *trk)
 {
     if (!trk) return;
-    sdr_free(trk->code);
-    sdr_cpx_free(trk->code_fft);
+    sdr_code_book_put(trk->book);
+    sdr_csk_free(trk->csk);
     sdr_free(trk);
 }
 
+// release code books of signal acquisition and tracking ----------------------
+static void put_books(sdr_ch_t *ch)
+{
+    sdr_code_book_put(ch->acq->book);
+    sdr_code_book_put(ch->acq->book_d);
+    sdr_code_book_put(ch->trk->book);
+    sdr_csk_free(ch->trk->csk);
+    ch->acq->book = ch->acq->book_d = ch->trk->book = NULL;
+    ch->acq->code_fft = ch->acq->code_fft_d = NULL;
+    ch->trk->code = NULL;
+    ch->trk->csk = NULL;
+}
+
 //------------------------------------------------------------------------------
 //  Generate new receiver channel.
 //
@@ -158,30 +288,37 @@ sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi)
     ch->state = SDR_STATE_IDLE;
     ch->time = 0.0;
     sig_upper(sig, ch->sig);
+    ch->sig_id = sdr_sig_id(ch->sig);
     ch->prn = prn;
     sdr_sat_id(ch->sig, prn, ch->sat);
-    if (!(ch->code = sdr_gen_code(sig, prn, &ch->len_code)) ||
+    if (!(ch->desc = sdr_sig_get(ch->sig_id)) ||
+        !(ch->code = sdr_gen_code_pack(sig, prn)) ||
         !(ch->sec_code = sdr_sec_code(sig, prn, &ch->len_sec_code))) {
         sdr_free(ch);
         return NULL;
     }
-    ch->fc = sdr_sig_freq(sig);
+    ch->len_code = ch->code->N;
+    ch->fc = ch->desc->freq;
     ch->fs = fs;
     ch->fi = sdr_shift_freq(sig, prn, fi);
-    ch->T = sdr_code_cyc(sig);
+    ch->T = ch->desc->cyc;
     ch->N = (int)(fs * ch->T);
-    ch->fd = ch->coff = ch->adr = ch->cn0 = 0.0;
+    sdr_ch_blk_t *blk = sdr_ch_blk_new();
+    blk->own = 1;
+    sdr_ch_blk_add(blk, ch);
     ch->lock = ch->lost = 0;
-    ch->costas = strcmp(ch->sig, "L6D") && strcmp(ch->sig, "L6E");
-    ch->acq = acq_new(ch->code, ch->len_code, ch->T, fs, ch->N);
-    ch->trk = trk_new(ch->sig, ch->prn, ch->code, ch->len_code, ch->T, fs);
+    ch->costas = !ch->desc->csk;
+    ch->acq = acq_new(ch->sig, ch->prn, ch->len_code, ch->T, fs, ch->N);
+    ch->trk = trk_new(ch->sig, ch->prn, ch->len_code, ch->desc->csk,
+        ch->T, fs);
     ch->nav = sdr_nav_new();
     pthread_mutex_init(&ch->mtx, NULL);
     return ch;
 }
 
 //------------------------------------------------------------------------------
-//  Free receiver channel.
+//  Free receiver channel. The channel block shared by channels is not freed
+//  and should be freed by sdr_ch_blk_free() after freeing the channels.
 //
 //  args:
 //      ch       (I) Receiver channel
@@ -192,75 +329,232 @@ sdr_ch_t *sdr_ch_new(const char *sig, int prn, double fs, double fi)
 void sdr_ch_free(sdr_ch_t *ch)
 {
     if (!ch) return;
+    if (ch->blk->own) sdr_ch_blk_free(ch->blk);
     acq_free(ch->acq);
     trk_free(ch->trk);
     sdr_nav_free(ch->nav);
     sdr_free(ch);
 }
 
+//------------------------------------------------------------------------------
+//  Set signals tracked with code NCO. The code replica of the signals is
+//  generated by code NCO for each correlation at the exact code phase and the
+//  code rate with Doppler instead of the bank of N_CODE resampled codes. It
+//  should be called before generating receiver channels.
+//
+//  args:
+//      sigs     (I)  Signal IDs separated by ',' ("": no signal)
+//
+//  return:
+//      none
+//
+void sdr_ch_set_nco(const char *sigs)
+{
+    int i;
+    
+    for (i = 0; i < (int)sizeof(nco_sigs) - 1 && sigs[i]; i++) {
+        nco_sigs[i] = (char)toupper(sigs[i]);
+    }
+    nco_sigs[i] = '\0';
+}
+
+//------------------------------------------------------------------------------
+//  Generate new channel block. A channel block holds the hot states of the
+//  tracking loops (FLL/PLL, DLL and C/N0) of up to SDR_CH_BLK channels as
+//  structure of arrays to update them in a pass by sdr_ch_blk_update().
+//
+//  args:
+//      none
+//
+//  return:
+//      Channel block
+//
+sdr_ch_blk_t *sdr_ch_blk_new(void)
+{
+    return (sdr_ch_blk_t *)sdr_malloc(sizeof(sdr_ch_blk_t));
+}
+
+//------------------------------------------------------------------------------
+//  Free channel block.
+//
+//  args:
+//      blk      (I)  Channel block
+//
+//  return:
+//      none
+//
+void sdr_ch_blk_free(sdr_ch_blk_t *blk)
+{
+    sdr_free(blk);
+}
+
+// copy tracking loop states of channel in channel blocks ----------------------
+static void copy_lane(sdr_ch_blk_t *dst, int i, const sdr_ch_blk_t *src, int j)
+{
+    dst->fd[i] = src->fd[j];
+    dst->coff[i] = src->coff[j];
+    dst->adr[i] = src->adr[j];
+    dst->cn0[i] = src->cn0[j];
+    dst->err_phas[i] = src->err_phas[j];
+    dst->err_code[i] = src->err_code[j];
+    dst->sumP[i] = src->sumP[j];
+    dst->sumE[i] = src->sumE[j];
+    dst->sumL[i] = src->sumL[j];
+    dst->sumN[i] = src->sumN[j];
+}
+
+//------------------------------------------------------------------------------
+//  Add receiver channel to channel block. The tracking loop states of the
+//  channel are moved from the channel block owned by the channel, which is
+//  freed. It should not be called while updating the channel.
+//
+//  args:
+//      blk      (IO) Channel block
+//      ch       (IO) Receiver channel
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_ch_blk_add(sdr_ch_blk_t *blk, sdr_ch_t *ch)
+{
+    sdr_ch_blk_t *blk0 = ch->blk;
+    
+    if (blk->n >= SDR_CH_BLK || (blk0 && (!blk0->own || blk0 == blk))) {
+        return 0;
+    }
+    int k = blk->n++;
+    blk->ch[k] = ch;
+    if (blk0) {
+        copy_lane(blk, k, blk0, ch->ib);
+        sdr_ch_blk_free(blk0);
+    }
+    ch->blk = blk;
+    ch->ib = k;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Join data channel to pilot channel of a signal for joint tracking. While
+//  both channels are updated in a pass of a channel block, the data channel
+//  is slaved to the pilot channel. It is not searched but started by the lock
+//  of the pilot channel and lost with it. The carrier and code NCOs of the
+//  data channel follow the FLL/PLL and DLL of the pilot channel, so the
+//  correlators of both channels share the carrier-mixed IF data. The
+//  correlations of the data channel are rotated by 0 or 90 deg to the
+//  carrier phase of the pilot channel to decode the navigation data. The data
+//  and pilot channels should have the same PRN, code cycle, sampling rate and
+//  IF frequency. It should not be called while updating the channels.
+//
+//  args:
+//      data     (IO) Receiver channel of data component
+//      pilot    (I)  Receiver channel of pilot component (NULL: unjoin)
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_ch_join(sdr_ch_t *data, sdr_ch_t *pilot)
+{
+    if (pilot && (pilot == data || pilot->pilot || pilot->prn != data->prn ||
+        pilot->fc != data->fc || pilot->T != data->T || pilot->N != data->N ||
+        pilot->fs != data->fs || pilot->fi != data->fi)) {
+        fprintf(stderr, "channel join error: %s/%d %s/%d\n", data->sig,
+            data->prn, pilot->sig, pilot->prn);
+        return 0;
+    }
+    data->pilot = pilot;
+    return 1;
+}
+
 // initialize signal tracking --------------------------------------------------
 static void trk_init(sdr_trk_t *trk)
 {
-    trk->err_phas = 0.0;
-    trk->sec_sync = trk->sec_pol = 0;
-    trk->sumP = trk->sumE = trk->sumL = trk->sumN = 0.0;
+    trk->sec_sync = trk->sec_pol = trk->rot = 0;
     memset(trk->C, 0, sizeof(sdr_cpx_t) * SDR_N_CORR);
     memset(trk->P, 0, sizeof(sdr_cpx_t) * SDR_N_HIST);
+    trk->ip = 0;
+}
+
+// add P correlation to history ------------------------------------------------
+static void add_hist_P(sdr_trk_t *trk, const sdr_cpx_t P)
+{
+    memcpy(trk->P[trk->ip], P, sizeof(sdr_cpx_t));
+    trk->ip = (trk->ip + 1) % SDR_N_HIST;
 }
 
 // start tracking --------------------------------------------------------------
 static void start_track(sdr_ch_t *ch, double time, double fd, double coff,
     double cn0)
 {
+    sdr_ch_blk_t *blk = ch->blk;
+    int k = ch->ib;
+    
     ch->state = SDR_STATE_LOCK;
     ch->time = time;
-    ch->lock = 0;
-    ch->fd = fd;
-    ch->coff = coff;
-    ch->adr = 0.0;
-    ch->cn0 = cn0;
+    ch->lock = ch->coast_v = 0;
+    ch->nc = 1;
+    blk->fd[k] = fd;
+    blk->coff[k] = coff;
+    blk->adr[k] = 0.0;
+    blk->cn0[k] = cn0;
+    blk->err_phas[k] = 0.0;
+    blk->sumP[k] = blk->sumE[k] = blk->sumL[k] = blk->sumN[k] = 0.0;
     ch->week = 0;
     ch->tow = -1;
     trk_init(ch->trk);
     sdr_nav_init(ch->nav);
 }
 
+// Doppler bins of signal search -----------------------------------------------
+//  The Doppler window of the external assist is limited to the number of the
+//  Doppler bins of the blind search, which is sized by the code length.
+static int search_bins(sdr_ch_t *ch, float **fds)
+{
+    sdr_acq_t *acq = ch->acq;
+    int n = acq->len_fds;
+    
+    *fds = acq->fds;
+    if (acq->ext) { // assisted
+        float step = 0.5 / ch->T;
+        int m = MAX(1, (int)(acq->max_dop_ext / step));
+        m = MIN(m, (acq->len_fds - 1) / 2);
+        for (n = 0; n < 2 * m + 1; n++) {
+            acq->fds_ext[n] = acq->fd_ext + (n - m) * step;
+        }
+        *fds = acq->fds_ext;
+    }
+    return n;
+}
+
 // search signal ---------------------------------------------------------------
 static void search_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff,
     int ix)
 {
-    float *fds = ch->acq->fds, fd_ext[3];
-    int n = ch->acq->len_fds;
+    float *fds;
+    int n = search_bins(ch, &fds);
     
-    if (ch->acq->fd_ext != 0.0) { // assist by external Doppler
-        for (n = 0; n < 3; n++) {
-            fd_ext[n] = ch->acq->fd_ext + (n - 1) * 0.5 / ch->T;
-        }
-        fds = fd_ext;
-    }
     if (!ch->acq->P_sum) {
         ch->acq->P_sum = (float *)sdr_malloc(sizeof(float) * 2 * ch->N * n);
     }
     // parallel code search and non-coherent integration
-    sdr_search_code(ch->acq->code_fft, ch->T, buff, ix, 2 * ch->N, ch->fs,
-        ch->fi, fds, n, ch->acq->P_sum);
-    ch->acq->n_sum++;
-    
-    if (ch->acq->n_sum * ch->T >= sdr_t_acq) {
-        int ix[2];
+    if (++ch->acq->n_sum * ch->T < sdr_t_acq) {
+        sdr_search_code(ch->acq->code_fft, ch->T, buff, ix, 2 * ch->N, ch->fs,
+            ch->fi, fds, n, ch->acq->P_sum);
+    }
+    else {
+        int ixp[2] = {0};
         
-        // search max correlation power
-        float cn0 = sdr_corr_max(ch->acq->P_sum, 2 * ch->N, ch->N, n, ch->T, ix);
+        // search max correlation power in the last integration
+        float cn0 = sdr_search_code_max(ch->acq->code_fft, ch->T, buff, ix,
+            2 * ch->N, ch->fs, ch->fi, fds, n, ch->acq->P_sum, ch->N, ixp);
         
         if (cn0 >= sdr_thres_cn0_l) {
-            double fd = sdr_fine_dop(ch->acq->P_sum, 2 * ch->N, fds, n, ix);
-            double coff = ix[1] / ch->fs;
+            double fd = sdr_fine_dop(ch->acq->P_sum, 2 * ch->N, fds, n, ixp);
+            double coff = ixp[1] / ch->fs;
             start_track(ch, time, fd, coff, cn0);
             sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL FOUND (%.1f,%.1f,%.7f)", time,
                 ch->sig, ch->prn, cn0, fd, coff * 1e3);
         }
         else {
-            sdr_sleep_msec(100);
             ch->state = SDR_STATE_IDLE;
             sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL NOT FOUND (%.1f)", time, ch->sig,
                 ch->prn, cn0);
@@ -271,14 +565,235 @@ static void search_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff,
     }
 }
 
+// search signal by decimated search of partial code -------------------------
+//  The long code signal is searched by the partial code in the decimated IF
+//  data over the whole Doppler range. The detected signal is searched again by
+//  the full code in the IF data in the Doppler window of the bin width of the
+//  decimated search to get the Doppler and the code offset for tracking.
+static void search_sig_dec(sdr_ch_t *ch, double time, const sdr_buff_t *buff,
+    int ix)
+{
+    sdr_acq_t *acq = ch->acq;
+    int M = 2 * ch->N / acq->D, n = acq->len_fds_d, ixp[2] = {0};
+    double Tp = acq->Np * acq->D / ch->fs; // partial code length (s)
+    
+    if (!acq->P_sum) {
+        acq->P_sum = (float *)sdr_malloc(sizeof(float) * M * n);
+    }
+    int last = ++acq->n_sum * ch->T >= sdr_t_acq;
+    float cn0 = sdr_search_code_dec(acq->code_fft_d, Tp, buff, ix, 2 * ch->N,
+        acq->D, ch->fs, ch->fi, acq->fds_d, n, acq->P_sum, M / 2,
+        last ? ixp : NULL);
+    
+    if (!last) return;
+    
+    if (cn0 >= sdr_thres_cn0_l) {
+        acq->ext = 1;
+        acq->fd_ext = (float)sdr_fine_dop(acq->P_sum, M, acq->fds_d, n, ixp);
+        acq->max_dop_ext = n > 1 ? acq->fds_d[1] - acq->fds_d[0] : 0.0f;
+        sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL DETECTED (%.1f,%.1f)", time,
+            ch->sig, ch->prn, cn0, acq->fd_ext);
+    }
+    else {
+        ch->state = SDR_STATE_IDLE;
+        sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL NOT FOUND (%.1f)", time, ch->sig,
+            ch->prn, cn0);
+    }
+    sdr_free(acq->P_sum);
+    acq->P_sum = NULL;
+    acq->n_sum = 0;
+}
+
+// secondary code hypotheses ---------------------------------------------------
+//  The sign patterns of K consecutive secondary code chips are generated for
+//  all of the code phases. The patterns are normalized by the first chip and
+//  the duplicated patterns are removed since the sign of the coherent
+//  integration does not affect the power. Up to MAX_HYP + 1 patterns are
+//  generated.
+static int sec_hyp(const int8_t *code, int len, int K, int8_t *hyp)
+{
+    int n = 0;
+    
+    for (int i = 0; i < len && n <= MAX_HYP; i++) {
+        int8_t *p = hyp + n * K;
+        for (int k = 0; k < K; k++) {
+            p[k] = code[(i + k) % len] * code[i];
+        }
+        int j;
+        for (j = 0; j < n && memcmp(hyp + j * K, p, K); j++) ;
+        if (j == n) n++;
+    }
+    return n;
+}
+
+// start long integration ------------------------------------------------------
+//  The code cycles of the coherent integration are limited by the max memory
+//  for the correlations and the power sums, and by the max number of the
+//  secondary code hypotheses.
+static void long_start(sdr_ch_t *ch, int n, double time)
+{
+    sdr_acq_t *acq = ch->acq;
+    int8_t hyp[(MAX_HYP + 1) * MAX_COH];
+    int K = MIN(MAX((int)(sdr_t_coh / ch->T + 0.5), 1), MAX_COH);
+    
+    K = MIN(K, MAX((int)(MAX_MEM_L / (16.0 * n * ch->N)), 1));
+    while (K > 1 && sec_hyp(ch->sec_code, ch->len_sec_code, K, hyp) > MAX_HYP) {
+        K--;
+    }
+    acq->K = K;
+    acq->n_hyp = sec_hyp(ch->sec_code, ch->len_sec_code, K, hyp);
+    acq->hyp = (int8_t *)sdr_malloc(K * acq->n_hyp);
+    memcpy(acq->hyp, hyp, K * acq->n_hyp);
+    acq->C = (sdr_cpx_t *)sdr_malloc(sizeof(sdr_cpx_t) * ch->N * n * K);
+    acq->P_blk = (float *)sdr_malloc(sizeof(float) * ch->N * n * K * 2);
+    acq->n_sum = 0;
+    acq->time0 = time;
+}
+
+// end long integration --------------------------------------------------------
+static void long_end(sdr_acq_t *acq)
+{
+    sdr_free(acq->hyp);
+    sdr_free(acq->C);
+    sdr_free(acq->P_blk);
+    acq->hyp = NULL;
+    acq->C = NULL;
+    acq->P_blk = NULL;
+    acq->K = acq->n_hyp = acq->n_sum = 0;
+}
+
+// Doppler frequency of sub-bin of coherent integration ------------------------
+static double sub_bin_dop(const float *fds, int K, double T, int i)
+{
+    return fds[i / K] + (i % K - (K - 1) * 0.5) / (2.0 * K * T);
+}
+
+// coherent integration of correlations ----------------------------------------
+//  The correlations of K code cycles are integrated coherently for K sub-bins
+//  of each Doppler bin with the secondary code hypotheses. The max power over
+//  the hypotheses is added to the non-coherent sums with the code offsets
+//  shifted by the code Doppler from the start of the long integration. t is
+//  the time of the first code cycle from the start. The max over the
+//  hypotheses raises the mean noise power, so C/N0 of signals with secondary
+//  codes is underestimated.
+static void coh_int(sdr_ch_t *ch, const float *fds, int n, double t,
+    float *P_sum)
+{
+    sdr_acq_t *acq = ch->acq;
+    int N = ch->N, K = acq->K;
+    double Tc = N / ch->fs; // code cycle of IF data (s)
+    sdr_cpx_t *A = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N);
+    float *P = (float *)sdr_scratch_alloc(sizeof(float) * N);
+    
+    for (int i = 0; i < n * K; i++) {
+        double fd = sub_bin_dop(fds, K, ch->T, i);
+        double f = ch->fi + fd;
+        memset(P, 0, sizeof(float) * N);
+        
+        for (int h = 0; h < acq->n_hyp; h++) {
+            const int8_t *p = acq->hyp + h * K;
+            memset(A, 0, sizeof(sdr_cpx_t) * N);
+            
+            // wipe off carrier phase rotation and secondary code
+            for (int k = 0; k < K; k++) {
+                const sdr_cpx_t *C = acq->C + (k * n + i / K) * N;
+                double phi = -DPI * fmod(f * Tc * k, 1.0);
+                float c = (float)(p[k] * cos(phi));
+                float s = (float)(p[k] * sin(phi));
+                for (int j = 0; j < N; j++) {
+                    A[j][0] += c * C[j][0] - s * C[j][1];
+                    A[j][1] += c * C[j][1] + s * C[j][0];
+                }
+            }
+            for (int j = 0; j < N; j++) {
+                float Pj = SQR(A[j][0]) + SQR(A[j][1]);
+                if (Pj > P[j]) P[j] = Pj;
+            }
+        }
+        // non-coherent integration with code Doppler shift
+        int d = (int)floor(fd / ch->fc * ch->fs * t + 0.5) % N;
+        d = d < 0 ? d + N : d;
+        float *Q = P_sum + i * N;
+        for (int j = 0; j < N - d; j++) Q[j+d] += P[j];
+        for (int j = N - d; j < N; j++) Q[j+d-N] += P[j];
+    }
+    sdr_scratch_free(A);
+}
+
+// search signal by long integration -------------------------------------------
+//  The correlations of code cycles are integrated coherently for acq->K code
+//  cycles, and the powers are integrated non-coherently for sdr_t_acq_l. The
+//  non-coherent sums of the even and the odd coherent integrations are kept
+//  separately. Either of them is free of nav data bit transitions if the
+//  coherent integration time is half or less of the nav data bit length
+//  (alternate half-bit method).
+static void search_sig_long(sdr_ch_t *ch, double time, const sdr_buff_t *buff,
+    int ix)
+{
+    sdr_acq_t *acq = ch->acq;
+    float *fds;
+    int n = search_bins(ch, &fds), N = ch->N;
+    
+    if (!acq->K) {
+        long_start(ch, n, time);
+    }
+    int K = acq->K, nf = n * K;
+    
+    // parallel code search with complex correlations
+    sdr_search_code_cpx(acq->code_fft, ch->T, buff, ix, 2 * N, ch->fs, ch->fi,
+        fds, n, N, acq->C + acq->n_sum % K * n * N);
+    
+    if (++acq->n_sum % K) return;
+    int nblk = acq->n_sum / K;
+    double t = time - acq->time0 - (K - 1) * ch->T;
+    coh_int(ch, fds, n, t, acq->P_blk + (nblk - 1) % 2 * nf * N);
+    
+    if (acq->n_sum * ch->T < sdr_t_acq_l) return;
+    
+    // search max correlation power in even and odd integrations
+    int ixp[2] = {0}, ixq[2];
+    float cn0 = 0.0f;
+    const float *P = acq->P_blk;
+    for (int i = 0; i < MIN(nblk, 2); i++) {
+        const float *Q = acq->P_blk + i * nf * N;
+        float cn0_i = sdr_corr_max(Q, N, N, nf, K * ch->T, ixq);
+        if (cn0_i <= cn0) continue;
+        cn0 = cn0_i;
+        P = Q;
+        ixp[0] = ixq[0];
+        ixp[1] = ixq[1];
+    }
+    if (cn0 >= sdr_thres_cn0_w) {
+        float *fdf = (float *)sdr_scratch_alloc(sizeof(float) * nf);
+        for (int i = 0; i < nf; i++) {
+            fdf[i] = (float)sub_bin_dop(fds, K, ch->T, i);
+        }
+        double fd = sdr_fine_dop(P, N, fdf, nf, ixp);
+        double coff = fmod(ixp[1] - fd / ch->fc * ch->fs * (time - acq->time0),
+            N);
+        coff = (coff < 0.0 ? coff + N : coff) / ch->fs;
+        sdr_scratch_free(fdf);
+        start_track(ch, time, fd, coff, cn0);
+        sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL FOUND (%.1f,%.1f,%.7f)", time,
+            ch->sig, ch->prn, cn0, fd, coff * 1e3);
+    }
+    else {
+        ch->state = SDR_STATE_IDLE;
+        sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL NOT FOUND (%.1f)", time, ch->sig,
+            ch->prn, cn0);
+    }
+    long_end(acq);
+}
+
 // sync and remove secondary code ----------------------------------------------
 static void sync_sec_code(sdr_ch_t *ch, int N)
 {
     if (ch->trk->sec_sync == 0) {
         float P = 0.0, R = 0.0;
         for (int i = 0; i < N; i++) {
-            P += ch->trk->P[SDR_N_HIST-N+i][0] * ch->sec_code[i] / N;
-            R += fabsf(ch->trk->P[SDR_N_HIST-N+i][0]) / N;
+            float IP = SDR_TRK_P(ch->trk, SDR_N_HIST-N+i)[0];
+            P += IP * ch->sec_code[i] / N;
+            R += fabsf(IP) / N;
         }
         if (fabsf(P) >= R && R >= THRES_SYNC) {
             ch->trk->sec_sync = ch->lock;
@@ -288,7 +803,7 @@ static void sync_sec_code(sdr_ch_t *ch, int N)
     else if ((ch->lock - ch->trk->sec_sync) % N == 0) {
         float P = 0.0;
         for (int i = 0; i < N; i++) {
-            P += ch->trk->P[SDR_N_HIST-N+i][0] / N;
+            P += SDR_TRK_P(ch->trk, SDR_N_HIST-N+i)[0] / N;
         }
         if (fabsf(P) < THRES_LOST) {
             ch->trk->sec_sync = ch->trk->sec_pol = 0;
@@ -301,113 +816,150 @@ static void sync_sec_code(sdr_ch_t *ch, int N)
             ch->trk->C[i][0] *= C;
             ch->trk->C[i][1] *= C;
         }
-        ch->trk->P[SDR_N_HIST-1][0] *= C;
-        ch->trk->P[SDR_N_HIST-1][1] *= C;
+        SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0] *= C;
+        SDR_TRK_P(ch->trk, SDR_N_HIST-1)[1] *= C;
     }
 }
 
-// FLL ------------------------------------------------------------------------
-static void FLL(sdr_ch_t *ch)
+// update FLL/PLL of channels in channel block --------------------------------
+//  The discriminators of the channels are evaluated by the arctangent of
+//  arrays. For Costas PLL, atan(Q / I) = atan2(Q * sign(I), |I|).
+static void update_carr(sdr_ch_blk_t *blk, uint32_t mask)
 {
-    if (ch->lock >= 2) {
-        double IP1 = ch->trk->P[SDR_N_HIST-1][0];
-        double QP1 = ch->trk->P[SDR_N_HIST-1][1];
-        double IP2 = ch->trk->P[SDR_N_HIST-2][0];
-        double QP2 = ch->trk->P[SDR_N_HIST-2][1];
-        double dot   = IP1 * IP2 + QP1 * QP2;
-        double cross = IP1 * QP2 - QP1 * IP2;
-        if (dot != 0.0) {
-            double B = ch->lock * ch->T < T_FPULLIN ? sdr_b_fll_w : sdr_b_fll_n;
-            double err_freq = ch->costas ? atan(cross / dot) : atan2(cross, dot);
-            ch->fd -= B / 0.25 * err_freq / DPI;
+    double y[SDR_CH_BLK], x[SDR_CH_BLK], err[SDR_CH_BLK];
+    int ks[SDR_CH_BLK], fll[SDR_CH_BLK], n = 0;
+    
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask & (1u << k))) continue;
+        const sdr_ch_t *ch = blk->ch[k];
+        int f = ch->lock * ch->T <= T_FPULLIN;
+        double X, Y;
+        
+        if (f) { // FLL
+            if (ch->lock < 2) continue;
+            double IP1 = SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0];
+            double QP1 = SDR_TRK_P(ch->trk, SDR_N_HIST-1)[1];
+            double IP2 = SDR_TRK_P(ch->trk, SDR_N_HIST-2)[0];
+            double QP2 = SDR_TRK_P(ch->trk, SDR_N_HIST-2)[1];
+            X = IP1 * IP2 + QP1 * QP2; // dot
+            Y = IP1 * QP2 - QP1 * IP2; // cross
         }
+        else { // PLL
+            X = ch->trk->C[0][0];
+            Y = ch->trk->C[0][1];
+        }
+        if (X == 0.0) continue;
+        if (ch->costas && X < 0.0) {
+            X = -X;
+            Y = -Y;
+        }
+        y[n] = Y;
+        x[n] = X;
+        fll[n] = f;
+        ks[n++] = k;
     }
-}
-
-// PLL -------------------------------------------------------------------------
-static void PLL(sdr_ch_t *ch)
-{
-    double IP = ch->trk->C[0][0];
-    double QP = ch->trk->C[0][1];
-    if (IP != 0.0) {
-        double err_phas = (ch->costas ? atan(QP / IP) : atan2(QP, IP)) / DPI;
-        double W = sdr_b_pll / 0.53;
-        ch->fd += 1.4 * W * (err_phas - ch->trk->err_phas) +
-            W * W * err_phas * ch->T;
-        ch->trk->err_phas = err_phas;
+    sdr_atan2_blk(y, x, n, err);
+    
+    for (int i = 0; i < n; i++) {
+        int k = ks[i];
+        const sdr_ch_t *ch = blk->ch[k];
+        
+        if (fll[i]) {
+            double B = ch->lock * ch->T < T_FPULLIN ? sdr_b_fll_w : sdr_b_fll_n;
+            blk->fd[k] -= B / 0.25 * err[i] / DPI;
+        }
+        else {
+            double err_phas = err[i] / DPI;
+            double W = sdr_b_pll / 0.53;
+            blk->fd[k] += 1.4 * W * (err_phas - blk->err_phas[k]) +
+                W * W * err_phas * ch->T * ch->nc;
+            blk->err_phas[k] = err_phas;
+        }
     }
 }
 
-// DLL -------------------------------------------------------------------------
-static void DLL(sdr_ch_t *ch)
+// update DLL and C/N0 of channels in channel block ----------------------------
+//  The DLL is not updated for the held channels (hold). The DLL and C/N0 are
+//  updated if the lock count crosses the update cycles in the correlation
+//  interval of ch->nc code cycles.
+static void update_code(sdr_ch_blk_t *blk, uint32_t mask, uint32_t hold)
 {
-    int N = MAX(1, (int)(sdr_t_dll / ch->T));
-    ch->trk->sumE += sdr_cpx_abs(ch->trk->C[1]); // non-coherent sum 
-    ch->trk->sumL += sdr_cpx_abs(ch->trk->C[2]);
-    if (ch->lock % N == 0) {
-        double E = ch->trk->sumE;
-        double L = ch->trk->sumL;
-        if (E + L > 0.0) {
-            double err_code = (E - L) / (E + L) * 0.5f * ch->T / ch->len_code;
-            ch->coff -= sdr_b_dll / 0.25 * err_code * ch->T * N;
-            ch->trk->err_code = err_code;
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask & (1u << k))) continue;
+        const sdr_ch_t *ch = blk->ch[k];
+        sdr_cpx_t *C = ch->trk->C;
+        
+        // DLL
+        int N = MAX(ch->nc, (int)(sdr_t_dll / ch->T));
+        if (!(hold & (1u << k))) {
+            blk->sumE[k] += sdr_cpx_abs(C[1]); // non-coherent sum 
+            blk->sumL[k] += sdr_cpx_abs(C[2]);
+        }
+        if (!(hold & (1u << k)) && ch->lock % N < ch->nc) {
+            double E = blk->sumE[k];
+            double L = blk->sumL[k];
+            if (E + L > 0.0) {
+                double err_code = (E - L) / (E + L) * 0.5f * ch->T /
+                    ch->len_code;
+                blk->coff[k] -= sdr_b_dll / 0.25 * err_code * ch->T * N;
+                blk->err_code[k] = err_code;
+            }
+            blk->sumE[k] = blk->sumL[k] = 0.0;
+        }
+        // C/N0 (summed by add_corr())
+        if (ch->lock % (int)(T_CN0 / ch->T) < ch->nc) {
+            if (blk->sumN[k] > 0.0) {
+                double cn0 = 10.0 * log10(blk->sumP[k] / blk->sumN[k] / ch->T);
+                blk->cn0[k] += 0.5 * (cn0 - blk->cn0[k]);
+            }
+            blk->sumP[k] = blk->sumN[k] = 0.0;
         }
-        ch->trk->sumE = ch->trk->sumL = 0.0;
     }
 }
 
-// update C/N0 -----------------------------------------------------------------
-static void CN0(sdr_ch_t *ch)
+// update tracking loops of channels in channel block --------------------------
+//  The FLL/PLL and DLL of the held channels (hold) are not updated.
+static void update_loop(sdr_ch_blk_t *blk, uint32_t mask, uint32_t hold)
 {
-    ch->trk->sumP += SQR(ch->trk->C[0][0]) + SQR(ch->trk->C[0][1]);
-    ch->trk->sumN += SQR(ch->trk->C[3][0]) + SQR(ch->trk->C[3][1]);
-    if (ch->lock % (int)(T_CN0 / ch->T) == 0) {
-        if (ch->trk->sumN > 0.0) {
-            double cn0 = 10.0 * log10(ch->trk->sumP / ch->trk->sumN / ch->T);
-            ch->cn0 += 0.5 * (cn0 - ch->cn0);
-        }
-        ch->trk->sumP = ch->trk->sumN = 0.0;
-    }
+    // FLL/PLL, DLL and update C/N0 
+    update_carr(blk, mask & ~hold);
+    update_code(blk, mask, hold);
 }
 
-// interpolate correlation -----------------------------------------------------
-static void interp_corr(const sdr_cpx_t *C, double x, sdr_cpx_t *c)
+// Doppler aiding valid ? ------------------------------------------------------
+static int aid_valid(const sdr_ch_t *ch)
 {
-    int i = (int)x;
-    double a1 = x - i, a0 = 1.0 - a1;
-    (*c)[0] = a0 * C[i][0] + a1 * C[i+1][0];
-    (*c)[1] = a0 * C[i][1] + a1 * C[i+1][1];
+    return ch->t_aid > 0.0 && fabs(ch->time - ch->t_aid) <= T_AID;
 }
 
-// decode L6 CSK ---------------------------------------------------------------
-static void CSK(sdr_ch_t *ch, const sdr_cpx_t *corr)
+// aid tracking loops of channels in channel block -----------------------------
+//  The NCOs of the channels slaved to pilot channels (slv) are set to the ones
+//  of the pilot channels. The Doppler of the channels coasted by Doppler aiding
+//  is set to the aided Doppler. For the other aided channels, the aided Doppler
+//  rate is fed forward to the FLL/PLL.
+static void aid_loop(sdr_ch_blk_t *blk, uint32_t mask, uint32_t slv)
 {
-    double R = (double)ch->N / (ch->len_code / 2); // samples / chips 
-    int n = (int)(280 * R);
-    sdr_cpx_t *C = sdr_cpx_malloc(2 * n);
-    memcpy(C, corr + ch->N - n, sizeof(sdr_cpx_t) * n);
-    memcpy(C + n, corr, sizeof(sdr_cpx_t) * n);
-    
-    // interpolate correlation powers and detect peak
-    double P_max = 0.0;
-    int ix = 0;
-    for (int i = -255; i <= 255; i++) {
-        sdr_cpx_t c;
-        interp_corr(C, n + i * R, &c);
-        double P = sdr_cpx_abs(c);
-        if (P <= P_max) continue;
-        P_max = P;
-        ix = i;
-    }
-    // add CSK symbol to buffer 
-    uint8_t sym = (uint8_t)(255 - ix % 256);
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    
-    // generate correlator outputs
-    for (int i = 0; i < ch->trk->npos; i++) {
-        interp_corr(C, n + ix * R + ch->trk->pos[i], ch->trk->C + i);
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask & (1u << k))) continue;
+        const sdr_ch_t *ch = blk->ch[k];
+        
+        if (slv & (1u << k)) { // follow FLL/PLL and DLL of pilot channel
+            int j = ch->pilot->ib;
+            blk->fd[k] = blk->fd[j];
+            blk->coff[k] = blk->coff[j];
+            blk->adr[k] = blk->adr[j];
+            blk->err_phas[k] = blk->err_phas[j];
+        }
+        else if (!aid_valid(ch)) {
+            continue;
+        }
+        else if (ch->coast_v) {
+            blk->fd[k] = ch->fd_aid + ch->fdot_aid * (ch->time - ch->t_aid);
+        }
+        else {
+            blk->fd[k] += ch->fdot_aid * ch->T * ch->nc;
+        }
     }
-    sdr_cpx_free(C);
 }
 
 // update TOW ------------------------------------------------------------------
@@ -417,86 +969,429 @@ static void update_tow(sdr_ch_t *ch, double sec)
     ch->tow = (ch->tow + (int)(sec / 1e-3)) % (86400 * 7 * 1000);
 }
 
-// track signal ----------------------------------------------------------------
-static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
+// update NCOs of tracked signal to receiver time ------------------------------
+//  The carrier and code NCOs are propagated by Doppler. The time interval (s)
+//  from the last update is returned.
+static double update_nco(sdr_ch_t *ch, double time)
 {
+    sdr_ch_blk_t *blk = ch->blk;
+    int k = ch->ib;
     double tau = time - ch->time;   // time interval (s) 
-    double fc = ch->fi + ch->fd;    // IF carrier frequency with Doppler (Hz) 
-    ch->adr += ch->fd * tau;        // accumulated Doppler (cyc)
-    ch->coff -= ch->fd / ch->fc * tau; // carrier-aided code offset (s) 
+    blk->adr[k] += blk->fd[k] * tau; // accumulated Doppler (cyc)
+    blk->coff[k] -= blk->fd[k] / ch->fc * tau; // carrier-aided code offset (s) 
     ch->time = time;
     
-    // adjust code offset within 1 cycle range (0 <= ch->coff < ch->T)
-    if (ch->coff >= ch->T) {
-        ch->coff -= ch->T;
+    // adjust code offset within 1 cycle range (0 <= coff < ch->T)
+    if (blk->coff[k] >= ch->T) {
+        blk->coff[k] -= ch->T;
         update_tow(ch, -ch->T);
         ch->lock--;
-        memmove(ch->trk->P + 1, ch->trk->P, sizeof(sdr_cpx_t) *
-            (SDR_N_HIST - 1));
+        // drop latest P correlation and keep oldest
+        int ip = ch->trk->ip;
+        ch->trk->ip = (ip + SDR_N_HIST - 1) % SDR_N_HIST;
+        memcpy(ch->trk->P[ch->trk->ip], ch->trk->P[ip], sizeof(sdr_cpx_t));
     }
-    else if (ch->coff < 0.0) {
-        ch->coff += ch->T;
+    else if (blk->coff[k] < 0.0) {
+        blk->coff[k] += ch->T;
         update_tow(ch, ch->T);
         ch->lock++;
-        memmove(ch->trk->P, ch->trk->P + 1, sizeof(sdr_cpx_t) *
-            (SDR_N_HIST - 1));
+        // drop oldest P correlation and repeat latest
+        add_hist_P(ch->trk, SDR_TRK_P(ch->trk, SDR_N_HIST - 1));
     }
+    return tau;
+}
+
+// correlate tracked signal ----------------------------------------------------
+//  The CSK symbol is demodulated and correlated by the CSK demodulator for CSK.
+//  Otherwise the standard correlator job is set to job and 1 is returned. The
+//  code replica by code NCO is allocated in scratch arena and returned as
+//  *code.
+static int corr_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix,
+    sdr_corr_job_t *job, sdr_cpx16_t **code)
+{
+    sdr_ch_blk_t *blk = ch->blk;
+    int k = ch->ib;
+    double tau = update_nco(ch, time); // time interval (s)
+    double fc = ch->fi + blk->fd[k]; // IF carrier frequency with Doppler (Hz) 
+    
     // code position (samples) and carrier phase (cyc) 
-    int i = (int)(ch->coff * ch->fs);
-    int j = (int)((ch->coff * ch->fs - i) * N_CODE); // code bank index
-    double phi = ch->fi * tau + ch->adr + fc * i / ch->fs;
+    int i = (int)(blk->coff[k] * ch->fs);
+    int j = (int)((blk->coff[k] * ch->fs - i) * N_CODE); // code bank index
+    double phi = ch->fi * tau + blk->adr[k] + fc * i / ch->fs;
     
-    if (!strcmp(ch->sig, "L6D") || !strcmp(ch->sig, "L6E")) {
-        sdr_cpx_t *corr = sdr_cpx_malloc(ch->N);
+    *code = NULL;
+    if (ch->trk->csk) {
+        double step = ch->len_code / ch->T / ch->fs *
+            (1.0 + blk->fd[k] / ch->fc);
         
-        // FFT correlator 
-        sdr_corr_fft(buff, ix + i, ch->N, ch->fs, fc, phi,
-            ch->trk->code_fft + j * ch->N, corr);
-        
-        // decode L6 CSK 
-        CSK(ch, corr);
+        // demodulate L6 CSK and add CSK symbol to buffer
+        int lag = sdr_csk_corr(ch->trk->csk, buff, ix + i, ch->fs, fc, phi,
+            (i - blk->coff[k] * ch->fs) * step, step, ch->trk->pos,
+            ch->trk->npos, ch->trk->C);
+        sdr_nav_add_sym(ch->nav, (uint8_t)(N_CSK - 1 - lag % N_CSK));
+        return 0;
+    }
+    if (!ch->trk->code) {
+        *code = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * ch->N);
         
-        sdr_cpx_free(corr);
+        // code NCO with code rate by Doppler
+        double step = ch->len_code / ch->T / ch->fs *
+            (1.0 + blk->fd[k] / ch->fc);
+        sdr_code_nco(ch->code, (i - blk->coff[k] * ch->fs) * step, step, ch->N,
+            *code);
     }
-    else {
-        // standard correlator
-        sdr_corr_std(buff, ix + i, ch->N, ch->fs, fc, phi,
-            ch->trk->code + j * ch->N, ch->trk->pos, ch->trk->npos, ch->trk->C);
+    // standard correlator job
+    job->ix = ix + i;
+    job->N = ch->N;
+    job->fs = ch->fs;
+    job->fc = fc;
+    job->phi = phi;
+    job->code = *code ? *code : ch->trk->code + j * ch->N;
+    job->pos = ch->trk->pos;
+    job->npos = ch->trk->npos;
+    job->corr = ch->trk->C;
+    return 1;
+}
+
+// run standard correlator jobs by IF data buffers -----------------------------
+static void corr_jobs(const sdr_corr_job_t *jobs, const sdr_buff_t **buff,
+    int n)
+{
+    sdr_corr_job_t sel[SDR_CH_BLK*MAX_INT];
+    uint8_t done[SDR_CH_BLK*MAX_INT] = {0};
+    
+    for (int i = 0; i < n; i++) {
+        if (done[i]) continue;
+        int m = 0;
+        for (int j = i; j < n; j++) {
+            if (buff[j] != buff[i]) continue;
+            sel[m++] = jobs[j];
+            done[j] = 1;
+        }
+        sdr_corr_std_multi(buff[i], sel, m);
+    }
+}
+
+// rotate correlations of data channel slaved to pilot channel ----------------
+//  The data component is in phase or in quadrature with the pilot component.
+//  The rotation is decided by the P correlations during the PLL pull-in
+//  before the navigation data decoding and the secondary code sync, and the
+//  history of P correlations is rotated at the decision. The sign ambiguity
+//  is resolved by the polarity of the navigation data.
+static void rot_corr(sdr_ch_t *ch)
+{
+    sdr_trk_t *trk = ch->trk;
+    
+    if (!trk->rot) {
+        if ((ch->lock + 1) * ch->T < T_NPULLIN) return;
+        int n = MIN((int)((T_NPULLIN - T_FPULLIN) / ch->T), ch->lock);
+        double I = 0.0, Q = 0.0;
+        for (int i = SDR_N_HIST - n; i < SDR_N_HIST; i++) {
+            I += fabsf(SDR_TRK_P(trk, i)[0]);
+            Q += fabsf(SDR_TRK_P(trk, i)[1]);
+        }
+        trk->rot = Q > I ? 2 : 1;
+        for (int i = 0; trk->rot == 2 && i < SDR_N_HIST; i++) {
+            float I_i = trk->P[i][0];
+            trk->P[i][0] = trk->P[i][1];
+            trk->P[i][1] = -I_i;
+        }
+    }
+    for (int i = 0; trk->rot == 2 && i < trk->npos; i++) {
+        float I_i = trk->C[i][0];
+        trk->C[i][0] = trk->C[i][1];
+        trk->C[i][1] = -I_i;
     }
+}
+
+// add correlations of tracked signal ------------------------------------------
+static void add_corr(sdr_ch_t *ch)
+{
+    sdr_cpx_t *C = ch->trk->C;
+    int k = ch->ib;
+    
     // add P correlator outputs to history 
-    sdr_add_buff(ch->trk->P, SDR_N_HIST, ch->trk->C[0], sizeof(sdr_cpx_t));
+    add_hist_P(ch->trk, C[0]);
     update_tow(ch, ch->T);
     ch->lock++;
+    ch->coast = 0;
     
     // sync and remove secondary code 
     if (ch->len_sec_code >= 2 && ch->lock * ch->T >= T_NPULLIN) {
         sync_sec_code(ch, ch->len_sec_code);
     }
-    // FLL/PLL, DLL and update C/N0 
-    if (ch->lock * ch->T <= T_FPULLIN) {
-        FLL(ch);
+    // sum signal and noise powers for C/N0
+    ch->blk->sumP[k] += SQR(C[0][0]) + SQR(C[0][1]);
+    ch->blk->sumN[k] += SQR(C[3][0]) + SQR(C[3][1]);
+}
+
+// decode navigation data of tracked signal ------------------------------------
+static void decode_nav(sdr_ch_t *ch)
+{
+    if (ch->lock * ch->T >= T_NPULLIN && !ch->coast_v) {
+        sdr_nav_decode(ch);
     }
-    else {
-        PLL(ch);
+}
+
+// add correlations of tracked signal in correlation interval -----------------
+//  The correlations of nc code cycles from time (s) are added one by one with
+//  the navigation data decoding except for the last cycle, decoded after the
+//  tracking loop update. The correlations are rotated for the slaved data
+//  channel (rot = 1). The correlations averaged over the interval are set to
+//  ch->trk->C for the tracking loops.
+static void add_corr_int(sdr_ch_t *ch, int rot, sdr_cpx_t *corr, int nc,
+    double time)
+{
+    sdr_cpx_t *C = ch->trk->C;
+    int npos = ch->trk->npos;
+    
+    for (int j = 0; j < nc; j++) {
+        memcpy(C, corr + j * npos, sizeof(sdr_cpx_t) * npos);
+        ch->time = time + j * ch->T;
+        if (rot) rot_corr(ch);
+        add_corr(ch);
+        if (j < nc - 1) decode_nav(ch);
+        for (int i = 0; j > 0 && i < npos; i++) {
+            corr[i][0] += C[i][0];
+            corr[i][1] += C[i][1];
+        }
+        if (j == 0) memcpy(corr, C, sizeof(sdr_cpx_t) * npos);
+    }
+    for (int i = 0; i < npos; i++) {
+        C[i][0] = corr[i][0] / nc;
+        C[i][1] = corr[i][1] / nc;
     }
-    DLL(ch);
-    CN0(ch);
+}
+
+// reset lock of lost signal ---------------------------------------------------
+static void lost_sig(sdr_ch_t *ch)
+{
+    ch->state = SDR_STATE_IDLE;
+    ch->lock = ch->coast = ch->coast_v = 0;
+    ch->trk->sec_sync = ch->trk->sec_pol = 0;
+    ch->nav->ssync = ch->nav->fsync = ch->nav->rev = 0;
+    ch->lost++;
+}
+
+// update state of data channel slaved to pilot channel -----------------------
+//  The data channel is started with the NCOs of the locked pilot channel and
+//  lost with the pilot channel. 1 is returned if the channel is slaved.
+static int slave_ch(sdr_ch_t *ch, uint32_t mask)
+{
+    const sdr_ch_t *pilot = ch->pilot;
     
-    // decode navigation data 
-    if (ch->lock * ch->T >= T_NPULLIN) {
-        sdr_nav_decode(ch);
+    if (!pilot || pilot->blk != ch->blk || !(mask & (1u << pilot->ib))) {
+        return 0;
     }
-    if (ch->cn0 < sdr_thres_cn0_u) { // signal lost 
+    if (pilot->state != SDR_STATE_LOCK) {
+        if (ch->state == SDR_STATE_LOCK) {
+            lost_sig(ch);
+            sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL LOST (%s, PILOT)", ch->time,
+                ch->sig, ch->prn, ch->sig);
+        }
         ch->state = SDR_STATE_IDLE;
-        ch->lock = 0;
-        ch->trk->sec_sync = ch->trk->sec_pol = 0;
-        ch->nav->ssync = ch->nav->fsync = ch->nav->rev = 0;
-        ch->lost++;
+    }
+    else if (ch->state != SDR_STATE_LOCK) {
+        const sdr_ch_blk_t *blk = pilot->blk;
+        int j = pilot->ib;
+        start_track(ch, pilot->time, blk->fd[j], blk->coff[j], blk->cn0[j]);
+        ch->blk->adr[ch->ib] = blk->adr[j];
+        sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL FOUND BY PILOT (%s)", pilot->time,
+            ch->sig, ch->prn, pilot->sig);
+    }
+    return 1;
+}
+
+// decode navigation data and check signal lost of tracked signal --------------
+//  If the Doppler aiding is valid, the signal is not lost by the low C/N0 but
+//  coasted by the aided Doppler with the tracking loops held up to T_VCOAST s
+//  until C/N0 recovers to the lock threshold.
+static void post_track(sdr_ch_t *ch)
+{
+    double cn0 = SDR_CH_CN0(ch);
+    
+    // decode navigation data 
+    decode_nav(ch);
+    
+    if (ch->coast_v) { // coasting by Doppler aiding
+        if (cn0 >= sdr_thres_cn0_l) {
+            sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL RECOVERED (%s, %.1f, %.3f)",
+                ch->time, ch->sig, ch->prn, ch->sig, cn0,
+                ch->coast_v * ch->T);
+            ch->coast_v = 0;
+            ch->t_rec = ch->time;
+        }
+        else if (++ch->coast_v * ch->T > T_VCOAST || !aid_valid(ch)) {
+            lost_sig(ch);
+            sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL LOST (%s, BLOCKED)", ch->time,
+                ch->sig, ch->prn, ch->sig);
+        }
+    }
+    else if (cn0 < sdr_thres_cn0_u && aid_valid(ch)) { // signal blocked
+        ch->coast_v = 1;
+        sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL BLOCKED (%s, %.1f)", ch->time,
+            ch->sig, ch->prn, ch->sig, cn0);
+    }
+    else if (cn0 < sdr_thres_cn0_u) { // signal lost 
+        lost_sig(ch);
         sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL LOST (%s, %.1f)", ch->time, ch->sig,
-            ch->prn, ch->sig, ch->cn0);
+            ch->prn, ch->sig, cn0);
     }
 }
 
+//------------------------------------------------------------------------------
+//  Coast a receiver channel across a gap of IF data. For the tracked signal,
+//  the carrier and code NCOs are propagated to the receiver time by Doppler
+//  without correlation and the tracking loops are held. The code cycles in
+//  the gap are counted in the TOW and lock count with null P correlations to
+//  keep the navigation data symbol timing. The signal is lost if coasted over
+//  T_COAST s. States other than SDR_STATE_LOCK are not changed.
+//
+//  args:
+//      ch       (IO) Receiver channel
+//      time     (I)  Sampling time of the end of digitized IF data (s)
+//
+//  return:
+//      none
+//
+void sdr_ch_coast(sdr_ch_t *ch, double time)
+{
+    static const sdr_cpx_t P0 = {0};
+    
+    pthread_mutex_lock(&ch->mtx);
+    if (ch->state == SDR_STATE_LOCK) {
+        int n = (int)floor((time - ch->time) / ch->T + 0.5); // code cycles
+        update_nco(ch, time);
+        for (int i = 0; i < MIN(n, SDR_N_HIST); i++) {
+            add_hist_P(ch->trk, P0);
+        }
+        update_tow(ch, ch->T * n);
+        ch->lock += n;
+        ch->coast += n;
+        if (ch->coast * ch->T > T_COAST) {
+            lost_sig(ch);
+            sdr_log(4, "$LOG,%.3f,%s,%d,SIGNAL LOST (%s, GAP)", ch->time,
+                ch->sig, ch->prn, ch->sig);
+        }
+    }
+    pthread_mutex_unlock(&ch->mtx);
+}
+
+//------------------------------------------------------------------------------
+//  Aid tracking loops of a receiver channel by Doppler predicted by PVT (vector
+//  aided tracking). The aided Doppler rate is fed forward to the FLL/PLL to
+//  remove the dynamics of the satellite from the loops. While the aiding is
+//  valid (T_AID s), the tracked signal blocked with the low C/N0 is coasted by
+//  the aided Doppler with the tracking loops held instead of lost, and the
+//  tracking is resumed when C/N0 recovers without re-acquisition.
+//
+//  args:
+//      ch       (IO) Receiver channel
+//      time     (I)  Time of aided Doppler (s)
+//      fd       (I)  Aided Doppler frequency (Hz)
+//      fdot     (I)  Aided Doppler frequency rate (Hz/s)
+//
+//  return:
+//      none
+//
+void sdr_ch_aid(sdr_ch_t *ch, double time, double fd, double fdot)
+{
+    pthread_mutex_lock(&ch->mtx);
+    ch->t_aid = time;
+    ch->fd_aid = fd;
+    ch->fdot_aid = fdot;
+    pthread_mutex_unlock(&ch->mtx);
+}
+
+//------------------------------------------------------------------------------
+//  Put an IDLE receiver channel to sleep. The code books of the signal
+//  acquisition and tracking and the CSK demodulator, the most of the memory of
+//  the channel, are released. The states of the channel are kept to be woken
+//  by sdr_ch_wake() before the next signal search. It should not be called
+//  while updating the channel.
+//
+//  args:
+//      ch       (IO) Receiver channel
+//
+//  return:
+//      Status (1: put to sleep, 0: not IDLE or already sleeping)
+//
+int sdr_ch_sleep(sdr_ch_t *ch)
+{
+    if (ch->sleep || ch->state != SDR_STATE_IDLE) return 0;
+    put_books(ch);
+    ch->sleep = 1;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Wake a receiver channel put to sleep by sdr_ch_sleep(). The code books
+//  shared in the process or read from the code book file are got again.
+//
+//  args:
+//      ch       (IO) Receiver channel
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_ch_wake(sdr_ch_t *ch)
+{
+    if (!ch->sleep) return 1;
+    if (!acq_book(ch->acq, ch->sig, ch->prn, ch->fs, ch->N) ||
+        !trk_book(ch->trk, ch->sig, ch->prn, ch->desc->csk, ch->T, ch->fs)) {
+        put_books(ch);
+        fprintf(stderr, "channel wake error: %s/%d\n", ch->sig, ch->prn);
+        return 0;
+    }
+    ch->sleep = 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Get code cycles of the next correlation interval of a receiver channel. The
+//  tracked signal is coherently integrated over multiple code cycles up to
+//  sdr_t_int s (MAX_INT cycles) with one tracking loop update per interval
+//  after the PLL pull-in. For the signal with navigation data, the interval
+//  is aligned to the navigation data symbols after the symbol sync or the
+//  secondary code sync. For the pilot signal with secondary code, the
+//  secondary code sync is needed to remove the code before the integration.
+//  The interval is not extended over a code offset wrap. The data channel
+//  slaved to the pilot channel follows the interval of the pilot channel.
+//
+//  args:
+//      ch       (I)  Receiver channel
+//
+//  return:
+//      code cycles of correlation interval (1: no integration)
+//
+int sdr_ch_ncyc(const sdr_ch_t *ch)
+{
+    const sdr_ch_t *pilot = ch->pilot;
+    int M = MIN((int)(sdr_t_int / ch->T + 1e-6), MAX_INT), nsym = -1;
+    
+    if (pilot && pilot->blk == ch->blk && pilot->state == SDR_STATE_LOCK) {
+        return sdr_ch_ncyc(pilot);
+    }
+    if (M <= 1 || ch->state != SDR_STATE_LOCK || ch->desc->csk ||
+        ch->coast_v || ch->lock * ch->T < T_NPULLIN) {
+        return 1;
+    }
+    for (int i = 0; i < (int)(sizeof(sym_sigs) / sizeof(sym_sigs[0])); i++) {
+        if (!strcmp(ch->sig, sym_sigs[i].sig)) nsym = sym_sigs[i].nsym;
+    }
+    if (nsym < 0 || (ch->len_sec_code >= 2 && ch->trk->sec_sync <= 0)) {
+        return 1;
+    }
+    if (nsym > 0) { // align to navigation data symbols
+        int sync = ch->len_sec_code >= 2 ? ch->trk->sec_sync : ch->nav->ssync;
+        if (sync <= 0 || ch->lock < sync) return 1;
+        M = MIN(M, nsym - (ch->lock - sync) % nsym);
+    }
+    double coff = ch->blk->coff[ch->ib] - ch->blk->fd[ch->ib] / ch->fc *
+        (M + 1) * ch->T;
+    return (coff < 0.0 || coff >= ch->T) ? 1 : M;
+}
+
 //------------------------------------------------------------------------------
 //  Update a receiver channel. A receiver channel is a state machine which has
 //  the following internal states indicated as ch.state. By calling the function,
@@ -523,13 +1418,163 @@ static void track_sig(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
 //
 void sdr_ch_update(sdr_ch_t *ch, double time, const sdr_buff_t *buff, int ix)
 {
-    if (ch->state == SDR_STATE_SRCH) {
-        search_sig(ch, time, buff, ix);
+    double times[SDR_CH_BLK];
+    const sdr_buff_t *buffs[SDR_CH_BLK];
+    int ixs[SDR_CH_BLK];
+    
+    times[ch->ib] = time;
+    buffs[ch->ib] = buff;
+    ixs[ch->ib] = ix;
+    sdr_ch_blk_update(ch->blk, 1u << ch->ib, times, buffs, ixs, NULL);
+}
+
+//------------------------------------------------------------------------------
+//  Update receiver channels in a channel block. Each channel selected by the
+//  mask is updated as sdr_ch_update(). The correlations of the tracked signals
+//  are taken first by sdr_corr_std_multi() in a pass over each IF data buffer.
+//  Then the tracking loops of the channels are updated in a pass over the
+//  channel block, followed by the navigation data decoding. The data channels
+//  joined to the pilot channels updated together are tracked jointly (see
+//  sdr_ch_join()).
+//
+//  If ncyc is not NULL, the tracked signal is coherently integrated over a
+//  correlation interval of multiple code cycles up to ncyc[k] (see
+//  sdr_ch_ncyc()). The correlations of the code cycles in the interval are
+//  taken by one call of sdr_corr_std_multi() and the tracking loops are
+//  updated once per interval. The IF data of the interval should be
+//  contiguous from ix[k] (sampling times time[k] + j * ch->T, j = 0, ...,
+//  ncyc[k] - 1).
+//
+//  args:
+//      blk      (IO) Channel block
+//      mask     (I)  Channel mask (bit k: channel blk->ch[k])
+//      time     (I)  Sampling times of the end of digitized IF data (s) {k}
+//      buff     (I)  IF data buffers {k}
+//      ix       (I)  Indices of IF data buffers {k}
+//      ncyc     (IO) Max code cycles of correlation intervals (I) and code
+//                    cycles updated (O) {k} (NULL: 1 cycle)
+//
+//  return:
+//      none
+//
+void sdr_ch_blk_update(sdr_ch_blk_t *blk, uint32_t mask, const double *time,
+    const sdr_buff_t *const *buff, const int *ix, int *ncyc)
+{
+    sdr_corr_job_t jobs[SDR_CH_BLK*MAX_INT];
+    const sdr_buff_t *buff_job[SDR_CH_BLK*MAX_INT];
+    sdr_cpx16_t *codes[SDR_CH_BLK*MAX_INT];
+    sdr_cpx_t *corr[SDR_CH_BLK] = {0}, *corr_int = NULL;
+    uint32_t mask_trk = 0, slv = 0;
+    int nj = 0, ncode = 0, nt = 0, nc[SDR_CH_BLK], mc = 1, ncorr = 0;
+    int64_t t0 = sdr_get_tick_ns();
+    
+    // update states of data channels slaved to pilot channels
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask & (1u << k)) || !blk->ch[k]->pilot) continue;
+        pthread_mutex_lock(&blk->ch[k]->mtx);
+        if (slave_ch(blk->ch[k], mask)) slv |= 1u << k;
+        pthread_mutex_unlock(&blk->ch[k]->mtx);
     }
-    else if (ch->state == SDR_STATE_LOCK) {
-        pthread_mutex_lock(&ch->mtx);
-        track_sig(ch, time, buff, ix);
-        pthread_mutex_unlock(&ch->mtx);
+    // search signals and set up correlators of tracked signals
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask & (1u << k))) continue;
+        sdr_ch_t *ch = blk->ch[k];
+        
+        if (ch->state == SDR_STATE_SRCH) {
+            int64_t ts = sdr_get_tick_ns();
+            if (sdr_t_acq_l > 0.0) {
+                search_sig_long(ch, time[k], buff[k], ix[k]);
+            }
+            else if (ch->acq->D > 0 && !ch->acq->ext) {
+                search_sig_dec(ch, time[k], buff[k], ix[k]);
+            }
+            else {
+                search_sig(ch, time[k], buff[k], ix[k]);
+            }
+            int64_t t = sdr_perf_add(SDR_PERF_SRCH, ts);
+            ch->tcpu += t;
+            t0 += t; // exclude search time from tracking time
+        }
+        else if (ch->state == SDR_STATE_LOCK) {
+            pthread_mutex_lock(&ch->mtx);
+            ch->nc = ncyc ? MAX(1, MIN(ncyc[k], sdr_ch_ncyc(ch))) : 1;
+            mask_trk |= 1u << k;
+            nt++;
+        }
+    }
+    slv &= mask_trk;
+    
+    // code cycles of correlation intervals (slaved channels follow pilots)
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask & (1u << k))) continue;
+        sdr_ch_t *ch = blk->ch[k];
+        nc[k] = 1;
+        if (mask_trk & (1u << k)) {
+            if (slv & (1u << k)) ch->nc = ch->pilot->nc;
+            nc[k] = ch->nc;
+        }
+        if (nc[k] > 1) ncorr += nc[k] * ch->trk->npos;
+        mc = MAX(mc, nc[k]);
+        if (ncyc) ncyc[k] = nc[k];
+    }
+    if (ncorr > 0) {
+        corr_int = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * ncorr);
+    }
+    // set up correlators of tracked signals in code cycles of intervals
+    for (int j = 0, m = 0; j < mc; j++) {
+        for (int k = 0; k < blk->n; k++) {
+            if (!(mask_trk & (1u << k)) || j >= nc[k]) continue;
+            sdr_ch_t *ch = blk->ch[k];
+            sdr_cpx16_t *code;
+            if (j == 0 && nc[k] > 1) {
+                corr[k] = corr_int + m;
+                m += nc[k] * ch->trk->npos;
+            }
+            if (corr_sig(ch, time[k] + j * ch->T, buff[k], ix[k] + j * ch->N,
+                jobs + nj, &code)) {
+                if (nc[k] > 1) jobs[nj].corr = corr[k] + j * ch->trk->npos;
+                buff_job[nj++] = buff[k];
+            }
+            if (code) codes[ncode++] = code;
+        }
+    }
+    // standard correlators in a pass over each IF data buffer
+    corr_jobs(jobs, buff_job, nj);
+    
+    for (int i = ncode - 1; i >= 0; i--) {
+        sdr_scratch_free(codes[i]);
+    }
+    uint32_t hold = slv;
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask_trk & (1u << k))) continue;
+        sdr_ch_t *ch = blk->ch[k];
+        if (nc[k] > 1) {
+            add_corr_int(ch, (slv >> k) & 1, corr[k], nc[k], time[k]);
+        }
+        else {
+            if (slv & (1u << k)) rot_corr(ch);
+            add_corr(ch);
+        }
+        if (ch->coast_v) hold |= 1u << k;
+    }
+    if (corr_int) sdr_scratch_free(corr_int);
+    
+    // update and aid tracking loops
+    update_loop(blk, mask_trk, hold);
+    aid_loop(blk, mask_trk, slv);
+    
+    // decode navigation data and check signal lost
+    for (int k = 0; k < blk->n; k++) {
+        if (!(mask_trk & (1u << k))) continue;
+        post_track(blk->ch[k]);
+        pthread_mutex_unlock(&blk->ch[k]->mtx);
+    }
+    // tracking time shared by tracked channels
+    if (nt > 0) {
+        int64_t t = sdr_perf_add(SDR_PERF_TRK, t0) / nt;
+        for (int k = 0; k < blk->n; k++) {
+            if (mask_trk & (1u << k)) blk->ch[k]->tcpu += t;
+        }
     }
 }
 
@@ -549,9 +1594,9 @@ int sdr_ch_corr_stat(sdr_ch_t *ch, double *stat, int *pos, sdr_cpx_t *C)
     stat[0] = ch->state;
     stat[1] = ch->fs;
     stat[2] = ch->lock * ch->T;
-    stat[3] = ch->cn0;
-    stat[4] = ch->coff * 1e3;
-    stat[5] = ch->fd;
+    stat[3] = SDR_CH_CN0(ch);
+    stat[4] = SDR_CH_COFF(ch) * 1e3;
+    stat[5] = SDR_CH_FD(ch);
     memcpy(pos, ch->trk->pos, sizeof(int) * n);
     memcpy(C, ch->trk->C, sizeof(sdr_cpx_t) * n);
     pthread_mutex_unlock(&ch->mtx);
@@ -565,7 +1610,9 @@ int sdr_ch_corr_hist(sdr_ch_t *ch, double tspan, double *stat, sdr_cpx_t *P)
     int n = MIN((int)(tspan / ch->T), SDR_N_HIST);
     stat[0] = ch->time;
     stat[1] = ch->T;
-    memcpy(P, ch->trk->P + SDR_N_HIST - n, sizeof(sdr_cpx_t) * n);
+    for (int i = 0; i < n; i++) {
+        memcpy(P[i], SDR_TRK_P(ch->trk, SDR_N_HIST-n+i), sizeof(sdr_cpx_t));
+    }
     pthread_mutex_unlock(&ch->mtx);
     return n;
 }
@@ -10,13 +10,99 @@
 //  2022-05-17  1.1  add API sdr_cpx_malloc(), sdr_cpx_free()
 //  2022-07-08  1.2  add API sdr_get_time()
 //                   move API sdr_cpx_malloc(), sdr_cpx_free() to sdr_func.c
+//  2026-10-14  1.3  add API sdr_get_ncpu(), sdr_get_tick_us(), sdr_cond_wait()
+//                   add API sdr_scratch_alloc(), sdr_scratch_free(),
+//                   sdr_scratch_clear(), sdr_alloc_stat()
+//                   add API sdr_file_open(), sdr_file_close(), sdr_file_seek(),
+//                   sdr_file_read()
+//                   add API sdr_set_thread()
+//  2026-10-15  1.4  add API sdr_get_tick_ns(), sdr_perf_add(), sdr_perf_get(),
+//                   sdr_perf_reset()
+//  2026-10-15  1.5  add API sdr_seq_begin(), sdr_seq_end(), sdr_seq_read()
+//                   add API sdr_mem_alloc(), sdr_mem_free(), sdr_mem_bind(),
+//                   sdr_mem_page(), sdr_mem_node(), sdr_mem_nnode(),
+//                   sdr_mem_stat() of large memory on hugepages and NUMA nodes
+//                   release scratch arena of thread at thread exit
 //
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE         // CPU_SET(), pthread_setaffinity_np(), sched_getcpu()
+#endif
 #include "pocket_sdr.h"
 #ifndef WIN32
 #include <time.h>
 #include <sys/time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sched.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
 #endif
 
+// constants -------------------------------------------------------------------
+#define SCRATCH_SIZE  (1<<20) // default scratch arena block size (bytes)
+#define SCRATCH_ALIGN 64    // scratch memory alignment (bytes)
+#define FILE_REL_SIZE (1<<24) // size to release pages of mapped file (bytes)
+#define SEQ_RETRY   1000    // max retries of seqlock read
+#define MEM_MIN     (1<<20) // min size of large memory mapped (bytes)
+#define MAX_CPU     1024    // max number of CPU cores of NUMA nodes
+#define SIZE_2M     ((size_t)1<<21) // size of 2 MB hugepage (bytes)
+#define SIZE_1G     ((size_t)1<<30) // size of 1 GB hugepage (bytes)
+
+#ifdef __linux__
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26       // shift of hugepage size flags of mmap()
+#endif
+#define MPOL_PREFERRED 1        // memory policy: preferred node
+#define MPOL_MF_MOVE   (1<<1)   // memory policy flag: move pages
+#endif
+
+// type definitions ------------------------------------------------------------
+typedef struct scratch_blk_tag { // scratch arena block type
+    struct scratch_blk_tag *prev; // previous block
+    size_t size, used;          // block size and used size (bytes)
+    void *mem;                  // memory allocated
+    uint8_t *data;              // aligned data area
+} scratch_blk_t;
+
+typedef struct mem_blk_tag {    // large memory block type
+    void *p;                    // memory pointer
+    size_t size;                // mapped size (bytes)
+    int page;                   // page type (SDR_PAGE_???)
+    int node;                   // NUMA node bound (-1: any)
+    int lock;                   // locked in RAM (0:no,1:yes)
+    struct mem_blk_tag *next;   // next block
+} mem_blk_t;
+
+typedef struct perf_th_tag {    // per-thread performance counters type
+    sdr_perf_t perf[SDR_N_PERF]; // performance counters of stages
+    int used;                   // used by a thread
+    struct perf_th_tag *next;   // next counters
+} perf_th_t;
+
+// global variables ------------------------------------------------------------
+int64_t sdr_n_heap[2] = {0};    // number of heap allocations and frees
+static int64_t n_scratch[2] = {0}; // number of scratch and arena allocations
+static __thread scratch_blk_t *scratch_blk = NULL; // scratch arena
+static __thread size_t scratch_use = 0, scratch_peak = 0; // scratch usage
+static pthread_key_t scratch_key; // key to release scratch arena at thread exit
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+static perf_th_t *perf_ths = NULL; // per-thread performance counters
+                                // (lock-free list)
+static __thread perf_th_t *perf_th = NULL; // counters of this thread
+static pthread_key_t perf_key;  // key to release counters at thread exit
+static pthread_once_t perf_once = PTHREAD_ONCE_INIT;
+int sdr_mem_huge = 0;           // hugepages of large memory (0:off,1:2MB,2:1GB)
+int sdr_mem_numa = 0;           // NUMA-local placement (0:off,1:on)
+int sdr_mem_lock = 0;           // lock large memory in RAM (0:off,1:on)
+static mem_blk_t *mem_blks = NULL; // large memory blocks
+static pthread_mutex_t mem_mtx = PTHREAD_MUTEX_INITIALIZER;
+static int16_t cpu_node[MAX_CPU]; // NUMA nodes of CPU cores (-1: unknown)
+static int n_node = 0;          // number of NUMA nodes
+static pthread_once_t node_once = PTHREAD_ONCE_INIT;
+
 //------------------------------------------------------------------------------
 //  Allocate memory. If no memory allocated, it exits the AP immediately with
 //  an error message.
@@ -35,6 +121,7 @@ void *sdr_malloc(size_t size)
         fprintf(stderr, "memory allocation error size=%d\n", (int)size);
         exit(-1);
     }
+    __atomic_add_fetch(&sdr_n_heap[0], 1, __ATOMIC_RELAXED);
     return p;
 }
 
@@ -49,9 +136,174 @@ void *sdr_malloc(size_t size)
 //
 void sdr_free(void *p)
 {
+    if (!p) return;
+    __atomic_add_fetch(&sdr_n_heap[1], 1, __ATOMIC_RELAXED);
     free(p);
 }
 
+// new scratch arena block -----------------------------------------------------
+static scratch_blk_t *scratch_blk_new(size_t size)
+{
+    scratch_blk_t *blk = (scratch_blk_t *)malloc(sizeof(scratch_blk_t));
+    
+    if (!blk || !(blk->mem = malloc(size + SCRATCH_ALIGN))) {
+        fprintf(stderr, "scratch allocation error size=%d\n", (int)size);
+        exit(-1);
+    }
+    blk->data = (uint8_t *)(((uintptr_t)blk->mem + SCRATCH_ALIGN - 1) &
+        ~(uintptr_t)(SCRATCH_ALIGN - 1));
+    blk->size = size;
+    blk->used = 0;
+    blk->prev = NULL;
+    __atomic_add_fetch(&n_scratch[1], 1, __ATOMIC_RELAXED);
+    return blk;
+}
+
+// free scratch arena block ----------------------------------------------------
+static scratch_blk_t *scratch_blk_free(scratch_blk_t *blk)
+{
+    scratch_blk_t *prev = blk->prev;
+    scratch_use -= blk->used;
+    free(blk->mem);
+    free(blk);
+    return prev;
+}
+
+// release scratch arena at thread exit ----------------------------------------
+static void free_scratch(void *arg)
+{
+    for (scratch_blk_t *blk = (scratch_blk_t *)arg; blk; ) {
+        scratch_blk_t *prev = blk->prev;
+        free(blk->mem);
+        free(blk);
+        blk = prev;
+    }
+}
+
+static void init_scratch(void)
+{
+    pthread_key_create(&scratch_key, free_scratch);
+}
+
+// set scratch arena of thread -------------------------------------------------
+//  The arena is registered to the thread-specific key to be released at thread
+//  exit if the thread does not call sdr_scratch_clear().
+static void set_scratch(scratch_blk_t *blk)
+{
+    pthread_once(&scratch_once, init_scratch);
+    scratch_blk = blk;
+    pthread_setspecific(scratch_key, blk);
+}
+
+//------------------------------------------------------------------------------
+//  Allocate scratch memory from the arena of the calling thread. The memory is
+//  aligned to 64 bytes and not initialized. It should be freed by
+//  sdr_scratch_free() in reverse order of allocation. The arena grows to the
+//  peak usage, so steady-state calls do no heap allocation.
+//  
+//  args:
+//      size     (I)  memory size (bytes)
+//
+//  return:
+//      scratch memory pointer
+//
+void *sdr_scratch_alloc(size_t size)
+{
+    size = (size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+    
+    if (!scratch_blk || scratch_blk->used + size > scratch_blk->size) {
+        size_t n = scratch_peak + size;
+        scratch_blk_t *blk = scratch_blk_new(n < SCRATCH_SIZE ? SCRATCH_SIZE :
+            n);
+        blk->prev = scratch_blk;
+        set_scratch(blk);
+    }
+    void *p = scratch_blk->data + scratch_blk->used;
+    scratch_blk->used += size;
+    scratch_use += size;
+    if (scratch_use > scratch_peak) scratch_peak = scratch_use;
+    __atomic_add_fetch(&n_scratch[0], 1, __ATOMIC_RELAXED);
+    return p;
+}
+
+//------------------------------------------------------------------------------
+//  Free scratch memory allocated by sdr_scratch_alloc(). All scratch memory
+//  allocated after it is also freed.
+//  
+//  args:
+//      p        (I)  scratch memory pointer (NULL: no operation)
+//
+//  return:
+//      none
+//
+void sdr_scratch_free(void *p)
+{
+    uint8_t *q = (uint8_t *)p;
+    
+    if (!q) return;
+    
+    scratch_blk_t *blk = scratch_blk;
+    while (blk && (q < blk->data || q >= blk->data + blk->size)) {
+        blk = scratch_blk_free(blk);
+    }
+    if (blk != scratch_blk) set_scratch(blk);
+    if (!scratch_blk) {
+        fprintf(stderr, "scratch free error p=%p\n", p);
+        return;
+    }
+    scratch_use -= scratch_blk->used - (size_t)(q - scratch_blk->data);
+    scratch_blk->used = (size_t)(q - scratch_blk->data);
+    
+    // merge arena into a block of the peak size if emptied
+    if (scratch_use == 0 && scratch_blk->size < scratch_peak) {
+        for (blk = scratch_blk; blk; ) {
+            blk = scratch_blk_free(blk);
+        }
+        set_scratch(scratch_blk_new(scratch_peak));
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Release the scratch arena of the calling thread. The arena of a thread not
+//  calling it is released at the thread exit.
+//  
+//  args:
+//      none
+//
+//  return:
+//      none
+//
+void sdr_scratch_clear(void)
+{
+    scratch_blk_t *blk = scratch_blk;
+    
+    while (blk) {
+        blk = scratch_blk_free(blk);
+    }
+    if (scratch_blk) set_scratch(NULL);
+    scratch_use = scratch_peak = 0;
+}
+
+//------------------------------------------------------------------------------
+//  Get memory allocation statistics. The heap allocations include
+//  sdr_malloc() and sdr_cpx_malloc().
+//  
+//  args:
+//      stat     (O)  allocation counts
+//                      {heap allocs, heap frees, scratch allocs,
+//                       scratch arena block allocs}
+//
+//  return:
+//      none
+//
+void sdr_alloc_stat(int64_t *stat)
+{
+    stat[0] = __atomic_load_n(&sdr_n_heap[0], __ATOMIC_RELAXED);
+    stat[1] = __atomic_load_n(&sdr_n_heap[1], __ATOMIC_RELAXED);
+    stat[2] = __atomic_load_n(&n_scratch[0], __ATOMIC_RELAXED);
+    stat[3] = __atomic_load_n(&n_scratch[1], __ATOMIC_RELAXED);
+}
+
 //------------------------------------------------------------------------------
 //  Get current time in UTC.
 //  
@@ -131,3 +383,773 @@ void sdr_sleep_msec(int msec)
 #endif
 }
 
+
+//------------------------------------------------------------------------------
+//  Get number of online CPU cores.
+//  
+//  args:
+//      none
+//
+//  return:
+//      number of CPU cores (>= 1)
+//
+int sdr_get_ncpu(void)
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Set CPU affinity and real-time priority of the calling thread. The CPU
+//  affinity is not supported on macOS.
+//  
+//  args:
+//      cpu      (I)  CPU core to pin the thread (-1: not pinned)
+//      pri      (I)  real-time priority (1-99) (0: not changed)
+//
+//  return:
+//      status (1: OK, 0: error)
+//
+int sdr_set_thread(int cpu, int pri)
+{
+    int stat = 1;
+#ifdef WIN32
+    if (cpu >= 0 && (cpu >= (int)sizeof(DWORD_PTR) * 8 ||
+        !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu))) {
+        fprintf(stderr, "SetThreadAffinityMask error cpu=%d\n", cpu);
+        stat = 0;
+    }
+    if (pri > 0 && !SetThreadPriority(GetCurrentThread(), pri >= 50 ?
+        THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST)) {
+        fprintf(stderr, "SetThreadPriority error (%d)\n", (int)GetLastError());
+        stat = 0;
+    }
+#else
+#ifdef __linux__
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        if (cpu >= CPU_SETSIZE ||
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set)) {
+            fprintf(stderr, "set thread affinity error cpu=%d\n", cpu);
+            stat = 0;
+        }
+    }
+#endif
+    if (pri > 0) {
+        struct sched_param param = {0};
+        param.sched_priority = pri < sched_get_priority_max(SCHED_RR) ? pri :
+            sched_get_priority_max(SCHED_RR);
+        if (pthread_setschedparam(pthread_self(), SCHED_RR, &param)) {
+            fprintf(stderr, "set thread scheduling error pri=%d\n", pri);
+            stat = 0;
+        }
+    }
+#endif
+    return stat;
+}
+
+//------------------------------------------------------------------------------
+//  Get monotonic system tick (usec).
+//  
+//  args:
+//      none
+//
+//  return:
+//      system tick (us)
+//
+int64_t sdr_get_tick_us(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER freq, count;
+    
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (int64_t)((double)count.QuadPart * 1e6 / freq.QuadPart);
+#else
+    struct timespec ts = {0, 0};
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Get monotonic system tick (nsec).
+//  
+//  args:
+//      none
+//
+//  return:
+//      system tick (ns)
+//
+int64_t sdr_get_tick_ns(void)
+{
+#ifdef WIN32
+    static LARGE_INTEGER freq = {0};
+    LARGE_INTEGER count;
+    
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (int64_t)((double)count.QuadPart * 1e9 / freq.QuadPart);
+#else
+    struct timespec ts = {0, 0};
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Wait for condition variable signaled with timeout. The mutex should be
+//  locked by the caller.
+//  
+//  args:
+//      cond     (I)  condition variable
+//      mtx      (I)  mutex locked
+//      msec     (I)  timeout (ms)
+//
+//  return:
+//      status (1: signaled, 0: timeout)
+//
+int sdr_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mtx, int msec)
+{
+    struct timespec ts = {0, 0};
+    
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += msec / 1000;
+    ts.tv_nsec += (long)(msec % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return !pthread_cond_timedwait(cond, mtx, &ts);
+}
+
+// read NUMA nodes of CPU cores ------------------------------------------------
+static void init_node(void)
+{
+    for (int i = 0; i < MAX_CPU; i++) {
+        cpu_node[i] = -1;
+    }
+#ifdef __linux__
+    for (int i = 0; i < SDR_MAX_NODE; i++) {
+        char path[64], buff[1024], *p = buff;
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+            i);
+        FILE *fp = fopen(path, "r");
+        if (!fp) continue;
+        if (fgets(buff, sizeof(buff), fp)) { // e.g. "0-15,32-47"
+            while (*p >= '0' && *p <= '9') {
+                int a = (int)strtol(p, &p, 10), b = a;
+                if (*p == '-') b = (int)strtol(p + 1, &p, 10);
+                for (int j = a; j <= b && j < MAX_CPU; j++) {
+                    cpu_node[j] = (int16_t)i;
+                }
+                if (*p == ',') p++;
+            }
+        }
+        fclose(fp);
+        n_node = i + 1;
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Get NUMA node of a CPU core.
+//
+//  args:
+//      cpu      (I)  CPU core (-1: CPU core of the calling thread)
+//
+//  return:
+//      NUMA node (-1: unknown)
+//
+int sdr_mem_node(int cpu)
+{
+    pthread_once(&node_once, init_node);
+#ifdef __linux__
+    if (cpu < 0) cpu = sched_getcpu();
+#endif
+    return (cpu >= 0 && cpu < MAX_CPU) ? cpu_node[cpu] : -1;
+}
+
+//------------------------------------------------------------------------------
+//  Get number of NUMA nodes.
+//
+//  args:
+//      none
+//
+//  return:
+//      number of NUMA nodes (0: unknown)
+//
+int sdr_mem_nnode(void)
+{
+    pthread_once(&node_once, init_node);
+    return n_node;
+}
+
+#ifndef WIN32
+// map large memory ------------------------------------------------------------
+//  The memory is mapped on hugepages by the option mem_huge if reserved, or on
+//  4 KB pages advised to be backed by transparent hugepages.
+static void *map_mem(size_t size, size_t *size_map, int *page)
+{
+    void *p;
+#ifdef __linux__
+    static const struct {int huge, page, shift; size_t size;} hp[] = {
+        {2, SDR_PAGE_1G, 30, SIZE_1G}, {1, SDR_PAGE_2M, 21, SIZE_2M}
+    };
+    for (int i = 0; i < 2; i++) {
+        if (sdr_mem_huge < hp[i].huge) continue;
+        size_t n = (size + hp[i].size - 1) / hp[i].size * hp[i].size;
+        p = mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS |
+            MAP_HUGETLB | (hp[i].shift << MAP_HUGE_SHIFT), -1, 0);
+        if (p != MAP_FAILED) {
+            *size_map = n;
+            *page = hp[i].page;
+            return p;
+        }
+    }
+#endif
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+        -1, 0);
+    if (p == MAP_FAILED) return NULL;
+    *size_map = size;
+    *page = SDR_PAGE_4K;
+#ifdef MADV_HUGEPAGE
+    if (sdr_mem_huge && size >= SIZE_2M && !madvise(p, size, MADV_HUGEPAGE)) {
+        *page = SDR_PAGE_THP;
+    }
+#endif
+    return p;
+}
+
+// bind large memory to NUMA node ----------------------------------------------
+//  The pages already touched are moved to the node.
+static int bind_mem(void *p, size_t size, int node)
+{
+#ifdef __linux__
+    unsigned long mask = 1ul << node;
+    return !syscall(SYS_mbind, p, size, MPOL_PREFERRED, &mask,
+        sizeof(mask) * 8 + 1, MPOL_MF_MOVE);
+#else
+    return 0;
+#endif
+}
+
+// search large memory block (mem_mtx locked) ----------------------------------
+static mem_blk_t **find_blk(const void *p)
+{
+    mem_blk_t **q = &mem_blks;
+    while (*q && (*q)->p != p) q = &(*q)->next;
+    return q;
+}
+#endif // WIN32
+
+//------------------------------------------------------------------------------
+//  Allocate large memory. The memory of the size >= 1 MB or on a NUMA node is
+//  mapped on hugepages by the option mem_huge (0: 4 KB pages, 1: 2 MB
+//  hugepages, 2: 1 GB hugepages) with fallback to smaller hugepages and
+//  transparent hugepages, and locked in RAM by the option mem_lock. The
+//  smaller memory is allocated by sdr_malloc(). The memory is initialized with
+//  zeros. If no memory allocated, it exits the AP immediately with an error
+//  message.
+//  
+//  args:
+//      size     (I)  memory size (bytes)
+//      node     (I)  NUMA node to bind (-1: any)
+//
+//  return:
+//      memory pointer allocated (freed by sdr_mem_free())
+//
+void *sdr_mem_alloc(size_t size, int node)
+{
+#ifdef WIN32
+    return sdr_malloc(size);
+#else
+    if (size < MEM_MIN && node < 0) return sdr_malloc(size);
+    
+    mem_blk_t *blk = (mem_blk_t *)sdr_malloc(sizeof(mem_blk_t));
+    if (!(blk->p = map_mem(size, &blk->size, &blk->page))) {
+        sdr_free(blk);
+        return sdr_malloc(size);
+    }
+    blk->node = (node >= 0 && bind_mem(blk->p, blk->size, node)) ? node : -1;
+    if (sdr_mem_lock) {
+        if (!mlock(blk->p, blk->size)) {
+            blk->lock = 1;
+        }
+        else {
+            fprintf(stderr, "memory lock error size=%.0f\n", (double)size);
+        }
+    }
+    pthread_mutex_lock(&mem_mtx);
+    blk->next = mem_blks;
+    mem_blks = blk;
+    pthread_mutex_unlock(&mem_mtx);
+    return blk->p;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Free memory allocated by sdr_mem_alloc().
+//  
+//  args:
+//      p        (I)  memory pointer (NULL: no operation)
+//
+//  return:
+//      none
+//
+void sdr_mem_free(void *p)
+{
+    if (!p) return;
+#ifndef WIN32
+    pthread_mutex_lock(&mem_mtx);
+    mem_blk_t **q = find_blk(p), *blk = *q;
+    if (blk) *q = blk->next;
+    pthread_mutex_unlock(&mem_mtx);
+    
+    if (blk) {
+        munmap(blk->p, blk->size);
+        sdr_free(blk);
+        return;
+    }
+#endif
+    sdr_free(p);
+}
+
+//------------------------------------------------------------------------------
+//  Bind memory allocated by sdr_mem_alloc() to a NUMA node. The pages already
+//  touched are moved to the node.
+//  
+//  args:
+//      p        (I)  memory pointer
+//      node     (I)  NUMA node
+//
+//  return:
+//      status (1: OK, 0: error or memory allocated by sdr_malloc())
+//
+int sdr_mem_bind(void *p, int node)
+{
+    int stat = 0;
+#ifndef WIN32
+    pthread_mutex_lock(&mem_mtx);
+    mem_blk_t *blk = *find_blk(p);
+    if (blk && node >= 0 && (stat = bind_mem(blk->p, blk->size, node))) {
+        blk->node = node;
+    }
+    pthread_mutex_unlock(&mem_mtx);
+#endif
+    return stat;
+}
+
+//------------------------------------------------------------------------------
+//  Get page type of memory allocated by sdr_mem_alloc().
+//  
+//  args:
+//      p        (I)  memory pointer
+//
+//  return:
+//      page type (SDR_PAGE_???)
+//
+int sdr_mem_page(const void *p)
+{
+    int page = SDR_PAGE_HEAP;
+#ifndef WIN32
+    pthread_mutex_lock(&mem_mtx);
+    mem_blk_t *blk = *find_blk(p);
+    if (blk) page = blk->page;
+    pthread_mutex_unlock(&mem_mtx);
+#endif
+    return page;
+}
+
+//------------------------------------------------------------------------------
+//  Get placement statistics of large memory allocated by sdr_mem_alloc().
+//  
+//  args:
+//      stat     (O)  placement stats {SDR_N_MEM}
+//                      {large memory (MB), on 4 KB pages (MB), on transparent
+//                       hugepages (MB), on 2 MB hugepages (MB), on 1 GB
+//                       hugepages (MB), locked (MB), bound to NUMA nodes (MB),
+//                       number of NUMA nodes}
+//
+//  return:
+//      none
+//
+void sdr_mem_stat(double *stat)
+{
+    for (int i = 0; i < SDR_N_MEM; i++) {
+        stat[i] = 0.0;
+    }
+#ifndef WIN32
+    pthread_mutex_lock(&mem_mtx);
+    for (mem_blk_t *blk = mem_blks; blk; blk = blk->next) {
+        double size = blk->size * 1e-6;
+        stat[0] += size;
+        stat[blk->page] += size;
+        if (blk->lock) stat[5] += size;
+        if (blk->node >= 0) stat[6] += size;
+    }
+    pthread_mutex_unlock(&mem_mtx);
+#endif
+    stat[7] = sdr_mem_nnode();
+}
+
+//------------------------------------------------------------------------------
+//  Begin to write data protected by a seqlock. The seqlock is a sequence count
+//  which is odd while the data is written. A seqlock allows only one writer.
+//  The readers copy the data by sdr_seq_read() without lock or wait of the
+//  writer.
+//
+//  args:
+//      seq      (IO) sequence count of seqlock
+//
+//  return:
+//      none
+//
+void sdr_seq_begin(uint32_t *seq)
+{
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+//  End to write data protected by a seqlock.
+//
+//  args:
+//      seq      (IO) sequence count of seqlock
+//
+//  return:
+//      none
+//
+void sdr_seq_end(uint32_t *seq)
+{
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+//  Read data protected by a seqlock. The data is copied again if the data was
+//  written during the copy.
+//
+//  args:
+//      seq      (I)  sequence count of seqlock
+//      dst      (O)  destination of data
+//      src      (I)  data protected by seqlock
+//      size     (I)  size of data (bytes)
+//
+//  return:
+//      status (1: OK, 0: retry count exceeded)
+//
+int sdr_seq_read(const uint32_t *seq, void *dst, const void *src, size_t size)
+{
+    for (int i = 0; i < SEQ_RETRY; i++) {
+        uint32_t s = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if (s & 1) continue;
+        memcpy(dst, src, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s) return 1;
+    }
+    return 0;
+}
+
+// map file to memory ----------------------------------------------------------
+static int map_file(sdr_file_t *file, const char *path)
+{
+#ifdef WIN32
+    HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size;
+    
+    if (h == INVALID_HANDLE_VALUE) return 0;
+    if (!GetFileSizeEx(h, &size) || size.QuadPart <= 0 ||
+        !(file->hmap = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0,
+        NULL))) {
+        CloseHandle(h);
+        return 0;
+    }
+    CloseHandle(h);
+    if (!(file->map = (uint8_t *)MapViewOfFile(file->hmap, FILE_MAP_READ, 0, 0,
+        0))) {
+        CloseHandle(file->hmap);
+        return 0;
+    }
+    file->size = (int64_t)size.QuadPart;
+    return 1;
+#else
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    
+    if (fd < 0) return 0;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size <= 0 ||
+        (uint64_t)st.st_size > (uint64_t)SIZE_MAX) {
+        close(fd);
+        return 0;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return 0;
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    file->map = (uint8_t *)map;
+    file->size = (int64_t)st.st_size;
+    return 1;
+#endif
+}
+
+// release pages of mapped file before read position ---------------------------
+static void release_pages(sdr_file_t *file)
+{
+#ifndef WIN32
+    static int64_t page = 0;
+    
+    if (!page) page = (int64_t)sysconf(_SC_PAGESIZE);
+    int64_t pos = file->pos / page * page;
+    if (pos - file->pos_rel < FILE_REL_SIZE) return;
+    madvise(file->map + file->pos_rel, (size_t)(pos - file->pos_rel),
+        MADV_DONTNEED);
+    file->pos_rel = pos;
+#endif
+}
+
+//------------------------------------------------------------------------------
+//  Open IF data file. The file is memory-mapped with sequential read-ahead if
+//  possible, otherwise it is read by stdio (e.g. pipe or FIFO).
+//  
+//  args:
+//      path     (I)  file path
+//
+//  return:
+//      IF data file (NULL: open error)
+//
+sdr_file_t *sdr_file_open(const char *path)
+{
+    sdr_file_t *file = (sdr_file_t *)sdr_malloc(sizeof(sdr_file_t));
+    
+    if (map_file(file, path)) {
+        return file;
+    }
+    if (!(file->fp = fopen(path, "rb"))) {
+        sdr_free(file);
+        return NULL;
+    }
+#ifdef WIN32
+    if (!_fseeki64(file->fp, 0, SEEK_END)) {
+        file->size = (int64_t)_ftelli64(file->fp);
+        _fseeki64(file->fp, 0, SEEK_SET);
+    }
+#else
+    if (!fseeko(file->fp, 0, SEEK_END)) {
+        file->size = (int64_t)ftello(file->fp);
+        fseeko(file->fp, 0, SEEK_SET);
+    }
+#endif
+    return file;
+}
+
+//------------------------------------------------------------------------------
+//  Close IF data file.
+//  
+//  args:
+//      file     (I)  IF data file
+//
+//  return:
+//      none
+//
+void sdr_file_close(sdr_file_t *file)
+{
+    if (!file) return;
+    
+    if (file->fp) {
+        fclose(file->fp);
+    }
+    else {
+#ifdef WIN32
+        UnmapViewOfFile(file->map);
+        CloseHandle(file->hmap);
+#else
+        munmap(file->map, (size_t)file->size);
+#endif
+    }
+    sdr_free(file->buff);
+    sdr_free(file);
+}
+
+//------------------------------------------------------------------------------
+//  Seek read position of IF data file.
+//  
+//  args:
+//      file     (I)  IF data file
+//      pos      (I)  read position from the beginning (bytes)
+//
+//  return:
+//      status (1: OK, 0: error)
+//
+int sdr_file_seek(sdr_file_t *file, int64_t pos)
+{
+    if (pos < 0 || (file->size > 0 && pos > file->size)) return 0;
+    
+    if (file->fp && pos != file->pos) { // no seek for pipe at current position
+#ifdef WIN32
+        if (_fseeki64(file->fp, pos, SEEK_SET)) return 0;
+#else
+        if (fseeko(file->fp, (off_t)pos, SEEK_SET)) return 0;
+#endif
+    }
+    file->pos = file->pos_rel = pos;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Read IF data from IF data file. The data is not copied for memory-mapped
+//  file. The data pointer is valid until the next call.
+//  
+//  args:
+//      file     (I)  IF data file
+//      size     (I)  data size to read (bytes)
+//      data     (O)  data pointer
+//
+//  return:
+//      data size read (bytes) (< size: end of file)
+//
+int sdr_file_read(sdr_file_t *file, int size, uint8_t **data)
+{
+    int n;
+    
+    if (file->fp) {
+        if (file->size_buff < size) {
+            sdr_free(file->buff);
+            file->buff = (uint8_t *)sdr_malloc(size);
+            file->size_buff = size;
+        }
+        n = (int)fread(file->buff, 1, size, file->fp);
+        *data = file->buff;
+    }
+    else {
+        n = (int)(file->size - file->pos < size ? file->size - file->pos :
+            size);
+        *data = file->map + file->pos;
+        release_pages(file);
+    }
+    file->pos += n;
+    return n;
+}
+
+// release per-thread performance counters at thread exit ----------------------
+static void free_perf_th(void *arg)
+{
+    __atomic_store_n(&((perf_th_t *)arg)->used, 0, __ATOMIC_RELEASE);
+}
+
+static void init_perf_th(void)
+{
+    pthread_key_create(&perf_key, free_perf_th);
+}
+
+// get per-thread performance counters -----------------------------------------
+//  The counters released by exited threads are taken over by new threads.
+static perf_th_t *get_perf_th(void)
+{
+    perf_th_t *p;
+    
+    if (perf_th) return perf_th;
+    
+    pthread_once(&perf_once, init_perf_th);
+    
+    for (p = __atomic_load_n(&perf_ths, __ATOMIC_ACQUIRE); p; p = p->next) {
+        int unused = 0;
+        if (__atomic_compare_exchange_n(&p->used, &unused, 1, 0,
+                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) break;
+    }
+    if (!p) {
+        p = (perf_th_t *)sdr_malloc(sizeof(perf_th_t));
+        p->used = 1;
+        p->next = __atomic_load_n(&perf_ths, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&perf_ths, &p->next, p, 0,
+                   __ATOMIC_RELEASE, __ATOMIC_RELAXED)) ;
+    }
+    pthread_setspecific(perf_key, p);
+    return perf_th = p;
+}
+
+//------------------------------------------------------------------------------
+//  Add elapsed time of a stage to the performance counters. The counters are
+//  kept per thread and updated without lock or atomic RMW.
+//  
+//  args:
+//      stage    (I)  performance stage (SDR_PERF_???)
+//      t0       (I)  start time of stage by sdr_get_tick_ns() (ns)
+//
+//  return:
+//      elapsed time (ns)
+//
+int64_t sdr_perf_add(int stage, int64_t t0)
+{
+    int64_t t = sdr_get_tick_ns() - t0;
+    sdr_perf_t *perf = get_perf_th()->perf + stage;
+    int i = t < 2 ? 0 : 63 - __builtin_clzll((uint64_t)t);
+    
+    if (i >= SDR_N_PERF_BIN) i = SDR_N_PERF_BIN - 1;
+    __atomic_store_n(&perf->n, perf->n + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&perf->sum, perf->sum + t, __ATOMIC_RELAXED);
+    __atomic_store_n(&perf->hist[i], perf->hist[i] + 1, __ATOMIC_RELAXED);
+    if (t > perf->max) {
+        __atomic_store_n(&perf->max, t, __ATOMIC_RELAXED);
+    }
+    return t;
+}
+
+//------------------------------------------------------------------------------
+//  Get performance counters summed over threads.
+//  
+//  args:
+//      perf     (O)  performance counters {SDR_N_PERF}
+//
+//  return:
+//      none
+//
+void sdr_perf_get(sdr_perf_t *perf)
+{
+    memset(perf, 0, sizeof(sdr_perf_t) * SDR_N_PERF);
+    
+    for (perf_th_t *p = __atomic_load_n(&perf_ths, __ATOMIC_ACQUIRE); p;
+         p = p->next) {
+        for (int i = 0; i < SDR_N_PERF; i++) {
+            sdr_perf_t *q = p->perf + i;
+            int64_t max = __atomic_load_n(&q->max, __ATOMIC_RELAXED);
+            perf[i].n += __atomic_load_n(&q->n, __ATOMIC_RELAXED);
+            perf[i].sum += __atomic_load_n(&q->sum, __ATOMIC_RELAXED);
+            if (max > perf[i].max) perf[i].max = max;
+            for (int j = 0; j < SDR_N_PERF_BIN; j++) {
+                perf[i].hist[j] += __atomic_load_n(&q->hist[j],
+                    __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Reset performance counters. The counters should be reset while the stages
+//  are not running on other threads.
+//  
+//  args:
+//      none
+//
+//  return:
+//      none
+//
+void sdr_perf_reset(void)
+{
+    for (perf_th_t *p = __atomic_load_n(&perf_ths, __ATOMIC_ACQUIRE); p;
+         p = p->next) {
+        memset(p->perf, 0, sizeof(p->perf));
+    }
+}
@@ -65,6 +65,18 @@
 //  2024-01-07  1.12 add signal G1OCD, G1OCP, G2OCP
 //  2024-01-15  1.13 add API sdr_sat_id()
 //  2024-03-20  1.14 modify API sdr_res_code()
+//  2026-10-14  1.15 add API sdr_code_book_file(), sdr_code_book_get(),
+//                   sdr_code_book_put()
+//                   add API sdr_gen_code_pack(), sdr_res_code_pack(),
+//                   sdr_gen_code_fft_pack()
+//                   add signal descriptor table and APIs sdr_sig_id(),
+//                   sdr_sig_get()
+//                   cache L1CB codes per PRN
+//                   DFT of resampled code by cached FFTW plan
+//                   add API sdr_code_book_save(), add header and index to code
+//                   book file, replace code book file by atomic rename
+//                   cache primary codes of sdr_gen_code() by signal and PRN
+//                   instead of code arrays per signal
 //
 #include <ctype.h>
 #include "pocket_sdr.h"
@@ -81,52 +93,124 @@ extern const char *code_gal_CS100[];
 
 // constants ------------------------------------------------------------------
 static const int8_t CHIP[] = {-1, 1};
+static const char BOOK_ID[8] = "PSDRCBF"; // code book file ID
+static const int32_t BOOK_VER = 2;        // code book file format version
+static const int32_t BOOK_GEN = 1;        // code book generator version
+static const uint32_t BOOK_ENDIAN = 0x01020304; // endian mark
+
+// signal descriptors (indexed by signal ID SDR_SIG_???) ----------------------
+static const sdr_sig_t sig_tbl[SDR_NUM_SIG] = {
+    // {sig, carrier freq (Hz), code cycle (s), code length, RINEX code, CSK}
+    {""      , 0.0         , 0.0    ,      0, 0       , 0},
+    {"L1CA"  , 1575.420E6  , 1E-3   ,   1023, CODE_L1C, 0},
+    {"L1S"   , 1575.420E6  , 1E-3   ,   1023, CODE_L1Z, 0},
+    {"L1CB"  , 1575.420E6  , 1E-3   ,   1023, CODE_L1E, 0},
+    {"L1CP"  , 1575.420E6  , 10E-3  ,  10230, CODE_L1L, 0},
+    {"L1CD"  , 1575.420E6  , 10E-3  ,  10230, CODE_L1S, 0},
+    {"L2CM"  , 1227.600E6  , 20E-3  ,  10230, CODE_L2S, 0},
+    {"L2CL"  , 1227.600E6  , 1500E-3, 767250, CODE_L2L, 0},
+    {"L5I"   , 1176.450E6  , 1E-3   ,  10230, CODE_L5I, 0},
+    {"L5Q"   , 1176.450E6  , 1E-3   ,  10230, CODE_L5Q, 0},
+    {"L5SI"  , 1176.450E6  , 1E-3   ,  10230, CODE_L5D, 0},
+    {"L5SQ"  , 1176.450E6  , 1E-3   ,  10230, CODE_L5P, 0},
+    {"L5SIV" , 1176.450E6  , 1E-3   ,  10230, CODE_L5D, 0},
+    {"L5SQV" , 1176.450E6  , 1E-3   ,  10230, CODE_L5P, 0},
+    {"L6D"   , 1278.750E6  , 4E-3   ,  10230, CODE_L6S, 1},
+    {"L6E"   , 1278.750E6  , 4E-3   ,  10230, CODE_L6E, 1},
+    {"G1CA"  , 1602.000E6  , 1E-3   ,    511, CODE_L1C, 0},
+    {"G2CA"  , 1246.000E6  , 1E-3   ,    511, CODE_L2C, 0},
+    {"G1OCD" , 1600.995E6  , 2E-3   ,   1023, CODE_L4A, 0},
+    {"G1OCP" , 1600.995E6  , 8E-3   ,   4092, CODE_L4B, 0},
+    {"G2OCP" , 1248.000E6  , 20E-3  ,  10230, CODE_L6B, 0},
+    {"G3OCD" , 1202.025E6  , 1E-3   ,  10230, CODE_L3I, 0},
+    {"G3OCP" , 1202.025E6  , 1E-3   ,  10230, CODE_L3Q, 0},
+    {"E1B"   , 1575.420E6  , 4E-3   ,   4092, CODE_L1B, 0},
+    {"E1C"   , 1575.420E6  , 4E-3   ,   4092, CODE_L1C, 0},
+    {"E5AI"  , 1176.450E6  , 1E-3   ,  10230, CODE_L5I, 0},
+    {"E5AQ"  , 1176.450E6  , 1E-3   ,  10230, CODE_L5Q, 0},
+    {"E5BI"  , 1207.140E6  , 1E-3   ,  10230, CODE_L7I, 0},
+    {"E5BQ"  , 1207.140E6  , 1E-3   ,  10230, CODE_L7Q, 0},
+    {"E6B"   , 1278.750E6  , 1E-3   ,   5115, CODE_L6B, 0},
+    {"E6C"   , 1278.750E6  , 1E-3   ,   5115, CODE_L6C, 0},
+    {"B1I"   , 1561.098E6  , 1E-3   ,   2046, CODE_L2I, 0},
+    {"B1CD"  , 1575.420E6  , 10E-3  ,  10230, CODE_L1D, 0},
+    {"B1CP"  , 1575.420E6  , 10E-3  ,  10230, CODE_L1P, 0},
+    {"B2I"   , 1207.140E6  , 1E-3   ,   2046, CODE_L7I, 0},
+    {"B2AD"  , 1176.450E6  , 1E-3   ,  10230, CODE_L5D, 0},
+    {"B2AP"  , 1176.450E6  , 1E-3   ,  10230, CODE_L5P, 0},
+    {"B2BI"  , 1207.140E6  , 1E-3   ,  10230, CODE_L7D, 0},
+    {"B3I"   , 1268.520E6  , 1E-3   ,  10230, CODE_L6I, 0},
+    {"I1SD"  , 1575.420E6  , 10E-3  ,  10230, CODE_L1D, 0},
+    {"I1SP"  , 1575.420E6  , 10E-3  ,  10230, CODE_L1P, 0},
+    {"I5S"   , 1176.450E6  , 1E-3   ,   1023, CODE_L5A, 0},
+    {"ISS"   , 2492.028E6  , 1E-3   ,   1023, CODE_L9A, 0},
+};
 
-// code caches ----------------------------------------------------------------
-static int8_t *L1CA [210] = {0};
-static int8_t *L1CP [210] = {0};
-static int8_t *L1CD [210] = {0};
+// type definitions -----------------------------------------------------------
+typedef struct {                // code book file header type
+    char id[8];                 // file ID (BOOK_ID)
+    int32_t ver;                // format version (BOOK_VER)
+    uint32_t endian;            // endian mark (BOOK_ENDIAN)
+    uint32_t gen;               // generator hash
+    int32_t n;                  // number of records
+    int64_t stamp;              // write stamp (ns)
+} book_head_t;
+
+typedef struct {                // code book file record header type
+    char sig[16];               // signal ID
+    int32_t prn, N, Nz, nbank, type, size; // key and data size (bytes)
+    uint32_t hash;              // primary code hash
+    double fs;                  // sampling frequency (Hz)
+} book_rec_t;
+
+typedef struct {                // code book file index type
+    book_rec_t rec;             // record header
+    int64_t off;                // file offset of record data (bytes)
+} book_idx_t;
+
+typedef struct code_tag {       // primary code cache type
+    char sig[16];               // signal ID
+    int prn;                    // PRN number
+    int N;                      // length of code
+    int8_t *code;               // primary code
+    struct code_tag *next;      // next primary code
+} code_t;
+
+typedef struct code_pack_tag {  // packed primary code cache type
+    char sig[16];               // signal ID
+    int prn;                    // PRN number
+    sdr_code_pack_t code;       // packed primary code
+    struct code_pack_tag *next; // next packed primary code
+} code_pack_t;
+
+// primary code cache ----------------------------------------------------------
+static code_t *codes = NULL;           // primary codes got by sdr_gen_code()
+static code_pack_t *code_packs = NULL; // packed primary codes
+static pthread_mutex_t code_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+// code book cache ------------------------------------------------------------
+static sdr_code_book_t *code_books = NULL; // code books
+static char code_book_file[1024] = "";     // code book file
+static pthread_mutex_t code_book_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t code_book_fmtx = PTHREAD_MUTEX_INITIALIZER; // file lock
+
+// code book file index (code_book_fmtx locked) --------------------------------
+static book_idx_t *book_idx = NULL; // index of records
+static int n_idx = 0;               // number of records
+static char idx_file[1024] = "";    // code book file of index
+static int64_t idx_stamp = 0;       // write stamp of code book file of index
+
+// secondary code and sequence caches -----------------------------------------
 static int8_t *L1CO [210] = {0};
-static int8_t *L2CM [210] = {0};
-static int8_t *L2CL [210] = {0};
-static int8_t *L5I  [210] = {0};
-static int8_t *L5Q  [210] = {0};
-static int8_t *L6D  [ 10] = {0};
-static int8_t *L6E  [ 10] = {0};
-static int8_t *G1CA [  1] = {0};
-static int8_t *G1OCD[ 64] = {0};
-static int8_t *G1OCP[ 64] = {0};
-static int8_t *G2OCP[ 64] = {0};
-static int8_t *G3OCD[ 64] = {0};
-static int8_t *G3OCP[ 64] = {0};
-static int8_t *E1B  [ 50] = {0};
-static int8_t *E1C  [ 50] = {0};
 static int8_t *E1CS       = NULL;
-static int8_t *E5AI [ 50] = {0};
-static int8_t *E5AQ [ 50] = {0};
 static int8_t *E5AIS      = NULL;
 static int8_t *E5AQS[ 50] = {0};
-static int8_t *E5BI [ 50] = {0};
 static int8_t *E5BIS      = NULL;
-static int8_t *E5BQ [ 50] = {0};
 static int8_t *E5BQS[ 50] = {0};
-static int8_t *E6B  [ 50] = {0};
-static int8_t *E6C  [ 50] = {0};
 static int8_t *E6CS [ 50] = {0};
-static int8_t *B1I  [ 63] = {0};
-static int8_t *B1CD [ 63] = {0};
-static int8_t *B1CP [ 63] = {0};
 static int8_t *B1CS [ 63] = {0};
-static int8_t *B2AD [ 63] = {0};
-static int8_t *B2AP [ 63] = {0};
 static int8_t *B2AS [ 63] = {0};
-static int8_t *B2BI [ 63] = {0};
-static int8_t *B3I  [ 63] = {0};
-static int8_t *I1SD [ 14] = {0};
-static int8_t *I1SP [ 14] = {0};
 static int8_t *I1SPO[ 14] = {0};
-static int8_t *I5S  [ 14] = {0};
-static int8_t *ISS  [ 14] = {0};
 
 static int8_t *L1CA_G1    = NULL;
 static int8_t *L1CA_G2    = NULL;
@@ -774,18 +858,16 @@ static int8_t *gen_code_L1CA(int prn, int *N)
         return NULL;
     }
     *N = 1023;
-    if (!L1CA[prn-1]) {
-        if (!L1CA_G1) {
-            L1CA_G1 = gen_code_L1CA_G1(*N);
-            L1CA_G2 = gen_code_L1CA_G2(*N);
-        }
-        L1CA[prn-1] = (int8_t *)sdr_malloc(*N);
-        for (int i = 0; i < *N; i++) {
-            int j = (i + (*N) - L1CA_G2_delay[prn-1]) % (*N);
-            L1CA[prn-1][i] = -L1CA_G1[i] * L1CA_G2[j];
-        }
+    if (!L1CA_G1) {
+        L1CA_G1 = gen_code_L1CA_G1(*N);
+        L1CA_G2 = gen_code_L1CA_G2(*N);
+    }
+    int8_t *code = (int8_t *)sdr_malloc(*N);
+    for (int i = 0; i < *N; i++) {
+        int j = (i + (*N) - L1CA_G2_delay[prn-1]) % (*N);
+        code[i] = -L1CA_G1[i] * L1CA_G2[j];
     }
-    return L1CA[prn-1];
+    return code;
 }
 
 // generate L1S code ([2]) -----------------------------------------------------
@@ -803,10 +885,12 @@ static int8_t *gen_code_L1CB(int prn, int *N)
     if (prn != 198 && (prn < 202 || prn > 206)) {
         return NULL;
     }
-    int8_t *code_L1CA = gen_code_L1CA(prn, N);
-    int8_t *code = mod_code(code_L1CA, *N, BOC, 2); // BOC(1,1)
-    *N *= 2;
-    return code;
+    int n = 1023;
+    *N = n * 2;
+    int8_t *code = gen_code_L1CA(prn, &n);
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1)
+    sdr_free(code);
+    return code_m;
 }
 
 // generate Legendre sequence --------------------------------------------------
@@ -853,13 +937,11 @@ static int8_t *gen_code_L1CP(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!L1CP[prn-1]) {
-        int8_t *code = gen_code_L1CPD(n, L1CP_weil_idx[prn-1],
-            L1CP_ins_idx[prn-1]);
-        L1CP[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1)
-        sdr_free(code);
-    }
-    return L1CP[prn-1];
+    int8_t *code = gen_code_L1CPD(n, L1CP_weil_idx[prn-1],
+        L1CP_ins_idx[prn-1]);
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1)
+    sdr_free(code);
+    return code_m;
 }
 
 // generate L1CD code ----------------------------------------------------------
@@ -870,13 +952,11 @@ static int8_t *gen_code_L1CD(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!L1CD[prn-1]) {
-        int8_t *code = gen_code_L1CPD(n, L1CD_weil_idx[prn-1],
-            L1CD_ins_idx[prn-1]);
-        L1CD[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1)
-        sdr_free(code);
-    }
-    return L1CD[prn-1];
+    int8_t *code = gen_code_L1CPD(n, L1CD_weil_idx[prn-1],
+        L1CD_ins_idx[prn-1]);
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1)
+    sdr_free(code);
+    return code_m;
 }
 
 // generate L1CP secondary code ([7]) ------------------------------------------
@@ -925,13 +1005,11 @@ static int8_t *gen_code_L2CM(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!L2CM[prn-1]) {
-        uint32_t R = (prn <= 63) ? L2CM_R_init_1[prn-1] : L2CM_R_init_2[prn-159];
-        int8_t *code = gen_code_L2C(n, R);
-        L2CM[prn-1] = mod_code(code, n, sub_carr, 2);
-        sdr_free(code);
-    }
-    return L2CM[prn-1];
+    uint32_t R = (prn <= 63) ? L2CM_R_init_1[prn-1] : L2CM_R_init_2[prn-159];
+    int8_t *code = gen_code_L2C(n, R);
+    int8_t *code_m = mod_code(code, n, sub_carr, 2);
+    sdr_free(code);
+    return code_m;
 }
 
 // generate L2CL code ([1]) ----------------------------------------------------
@@ -944,13 +1022,11 @@ static int8_t *gen_code_L2CL(int prn, int *N)
     }
     int n = 767250;
     *N = n * 2;
-    if (!L2CL[prn-1]) {
-        uint32_t R = (prn <= 63) ? L2CL_R_init_1[prn-1] : L2CL_R_init_2[prn-159];
-        int8_t *code = gen_code_L2C(n, R);
-        L2CL[prn-1] = mod_code(code, n, sub_carr, 2);
-        sdr_free(code);
-    }
-    return L2CL[prn-1];
+    uint32_t R = (prn <= 63) ? L2CL_R_init_1[prn-1] : L2CL_R_init_2[prn-159];
+    int8_t *code = gen_code_L2C(n, R);
+    int8_t *code_m = mod_code(code, n, sub_carr, 2);
+    sdr_free(code);
+    return code_m;
 }
 
 // generate L5 XA code ---------------------------------------------------------
@@ -977,17 +1053,15 @@ static int8_t *gen_code_L5I(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!L5I[prn-1]) {
-        if (!L5_XA) {
-            L5_XA = gen_code_L5_XA(*N);
-            L5_XB = gen_code_L5_XB(*N);
-        }
-        L5I[prn-1] = (int8_t *)sdr_malloc(*N);
-        for (int i = 0; i < *N; i++) {
-            L5I[prn-1][i] = -L5_XA[i] * L5_XB[(i + L5I_XB_adv[prn-1]) % (*N)];
-        }
+    if (!L5_XA) {
+        L5_XA = gen_code_L5_XA(*N);
+        L5_XB = gen_code_L5_XB(*N);
     }
-    return L5I[prn-1];
+    int8_t *code = (int8_t *)sdr_malloc(*N);
+    for (int i = 0; i < *N; i++) {
+        code[i] = -L5_XA[i] * L5_XB[(i + L5I_XB_adv[prn-1]) % (*N)];
+    }
+    return code;
 }
 
 // generate L5Q code ([2]) -----------------------------------------------------
@@ -997,17 +1071,15 @@ static int8_t *gen_code_L5Q(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!L5Q[prn-1]) {
-        if (!L5_XA) {
-            L5_XA = gen_code_L5_XA(*N);
-            L5_XB = gen_code_L5_XB(*N);
-        }
-        L5Q[prn-1] = (int8_t *)sdr_malloc(*N);
-        for (int i = 0; i < *N; i++) {
-            L5Q[prn-1][i] = -L5_XA[i] * L5_XB[(i + L5Q_XB_adv[prn-1]) % (*N)];
-        }
+    if (!L5_XA) {
+        L5_XA = gen_code_L5_XA(*N);
+        L5_XB = gen_code_L5_XB(*N);
+    }
+    int8_t *code = (int8_t *)sdr_malloc(*N);
+    for (int i = 0; i < *N; i++) {
+        code[i] = -L5_XA[i] * L5_XB[(i + L5Q_XB_adv[prn-1]) % (*N)];
     }
-    return L5Q[prn-1];
+    return code;
 }
 
 // generate L5SI code ([15]) ---------------------------------------------------
@@ -1128,12 +1200,10 @@ static int8_t *gen_code_L6D(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!L6D[prn-193]) {
-        int8_t *code = gen_code_L6(n, L6D_R_init[prn-193]);
-        L6D[prn-193] = mod_code(code, n, sub_carr, 2);
-        sdr_free(code);
-    }
-    return L6D[prn-193];
+    int8_t *code = gen_code_L6(n, L6D_R_init[prn-193]);
+    int8_t *code_m = mod_code(code, n, sub_carr, 2);
+    sdr_free(code);
+    return code_m;
 }
 
 // generate L6E code ([4]) -----------------------------------------------------
@@ -1146,12 +1216,10 @@ static int8_t *gen_code_L6E(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!L6E[prn-203]) {
-        int8_t *code = gen_code_L6(n, L6E_R_init[prn-203]);
-        L6E[prn-203] = mod_code(code, n, sub_carr, 2);
-        sdr_free(code);
-    }
-    return L6E[prn-203];
+    int8_t *code = gen_code_L6(n, L6E_R_init[prn-203]);
+    int8_t *code_m = mod_code(code, n, sub_carr, 2);
+    sdr_free(code);
+    return code_m;
 }
 
 // generate GLONASS C/A code ---------------------------------------------------
@@ -1174,10 +1242,7 @@ static int8_t *gen_code_G1CA(int prn, int *N)
         return NULL;
     }
     *N = 511;
-    if (!G1CA[0]) {
-        G1CA[0] = gen_code_GLO_CA(*N);
-    }
-    return G1CA[0];
+    return gen_code_GLO_CA(*N);
 }
 
 // generate G2CA code ([14]) ---------------------------------------------------
@@ -1196,16 +1261,14 @@ static int8_t *gen_code_G1OCD(int prn, int *N)
    }
    int n = 1023;
    *N = n * 2;
-   if (!G1OCD[prn]) {
-       int8_t *DC1 = LFSR(n, 0x0C8, 0x009, 10);
-       int8_t *DC2 = LFSR(n, prn, 0x08B, 10);
-       int8_t *code = xor_code(DC1, DC2, n);
-       G1OCD[prn] = mod_code(code, n, sub_carr, 2);
-       sdr_free(DC1);
-       sdr_free(DC2);
-       sdr_free(code);
-   }
-   return G1OCD[prn];
+   int8_t *DC1 = LFSR(n, 0x0C8, 0x009, 10);
+   int8_t *DC2 = LFSR(n, prn, 0x08B, 10);
+   int8_t *code = xor_code(DC1, DC2, n);
+   int8_t *code_m = mod_code(code, n, sub_carr, 2);
+   sdr_free(DC1);
+   sdr_free(DC2);
+   sdr_free(code);
+   return code_m;
 }
 
 // generate G1OCP code ([19]) -------------------------------------------------
@@ -1218,16 +1281,14 @@ static int8_t *gen_code_G1OCP(int prn, int *N)
    }
    int n = 4092;
    *N = n * 4;
-   if (!G1OCP[prn]) {
-       int8_t *DC1 = LFSR(n, 0x0C5, 0x053, 12);
-       int8_t *DC2 = LFSR(n, prn, 0x21, 6);
-       int8_t *code = xor_code(DC1, DC2, n);
-       G1OCP[prn] = mod_code(code, n, sub_carr, 4);
-       sdr_free(DC1);
-       sdr_free(DC2);
-       sdr_free(code);
-   }
-   return G1OCP[prn];
+   int8_t *DC1 = LFSR(n, 0x0C5, 0x053, 12);
+   int8_t *DC2 = LFSR(n, prn, 0x21, 6);
+   int8_t *code = xor_code(DC1, DC2, n);
+   int8_t *code_m = mod_code(code, n, sub_carr, 4);
+   sdr_free(DC1);
+   sdr_free(DC2);
+   sdr_free(code);
+   return code_m;
 }
 
 // generate G2OCP code ([20]) --------------------------------------------------
@@ -1240,16 +1301,14 @@ static int8_t *gen_code_G2OCP(int prn, int *N)
    }
    int n = 10230;
    *N = n * 4;
-   if (!G2OCP[prn]) {
-       int8_t *DC1 = LFSR(n, 0x0D38, 0x0443, 14);
-       int8_t *DC2 = LFSR(n, prn + 64, 0x03, 7);
-       int8_t *code = xor_code(DC1, DC2, n);
-       G2OCP[prn] = mod_code(code, n, sub_carr, 4);
-       sdr_free(DC1);
-       sdr_free(DC2);
-       sdr_free(code);
-   }
-   return G2OCP[prn];
+   int8_t *DC1 = LFSR(n, 0x0D38, 0x0443, 14);
+   int8_t *DC2 = LFSR(n, prn + 64, 0x03, 7);
+   int8_t *code = xor_code(DC1, DC2, n);
+   int8_t *code_m = mod_code(code, n, sub_carr, 4);
+   sdr_free(DC1);
+   sdr_free(DC2);
+   sdr_free(code);
+   return code_m;
 }
 
 // generate G3OC DC1 code ([17]) -----------------------------------------------
@@ -1268,13 +1327,11 @@ static int8_t *gen_code_G3OCD(int prn, int *N)
        return NULL;
    }
    *N = 10230;
-   if (!G3OCD[prn]) {
-       int8_t *DC1 = gen_code_G3OC_DC1(*N);
-       int8_t *DC2 = LFSR(*N, prn, 0x03, 7);
-       G3OCD[prn] = xor_code(DC1, DC2, *N);
-       sdr_free(DC2);
-   }
-   return G3OCD[prn];
+   int8_t *DC1 = gen_code_G3OC_DC1(*N);
+   int8_t *DC2 = LFSR(*N, prn, 0x03, 7);
+   int8_t *code = xor_code(DC1, DC2, *N);
+   sdr_free(DC2);
+   return code;
 }
 
 // generate G3OCP code ---------------------------------------------------------
@@ -1284,13 +1341,11 @@ static int8_t *gen_code_G3OCP(int prn, int *N)
        return NULL;
    }
    *N = 10230;
-   if (!G3OCP[prn]) {
-       int8_t *DC1 = gen_code_G3OC_DC1(*N);
-       int8_t *DC3 = LFSR(*N, prn + 64, 0x03, 7);
-       G3OCP[prn] = xor_code(DC1, DC3, *N);
-       sdr_free(DC3);
-   }
-   return G3OCP[prn];
+   int8_t *DC1 = gen_code_G3OC_DC1(*N);
+   int8_t *DC3 = LFSR(*N, prn + 64, 0x03, 7);
+   int8_t *code = xor_code(DC1, DC3, *N);
+   sdr_free(DC3);
+   return code;
 }
 
 // generate G1CA secondary code ------------------------------------------------
@@ -1359,12 +1414,10 @@ static int8_t *gen_code_E1B(int prn, int *N)
     }
     int n = 4092;
     *N = n * 2;
-    if (!E1B[prn-1]) {
-        int8_t *code = read_code_hex(code_gal_E1B[prn-1], n);
-        E1B[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1) instead of CBOC
-        sdr_free(code);
-    }
-    return E1B[prn-1];
+    int8_t *code = read_code_hex(code_gal_E1B[prn-1], n);
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1) instead of CBOC
+    sdr_free(code);
+    return code_m;
 }
 
 // generate E1C code ([5]) -----------------------------------------------------
@@ -1375,12 +1428,10 @@ static int8_t *gen_code_E1C(int prn, int *N)
     }
     int n = 4092;
     *N = n * 2;
-    if (!E1C[prn-1]) {
-        int8_t *code = read_code_hex(code_gal_E1C[prn-1], n);
-        E1C[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1) instead of CBOC
-        sdr_free(code);
-    }
-    return E1C[prn-1];
+    int8_t *code = read_code_hex(code_gal_E1C[prn-1], n);
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1) instead of CBOC
+    sdr_free(code);
+    return code_m;
 }
 
 // generate E1C secondary code ([5]) -------------------------------------------
@@ -1412,14 +1463,12 @@ static int8_t *gen_code_E5AI(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!E5AI[prn-1]) {
-        int8_t *code1 = gen_code_E5_X1(*N, 040503);
-        int8_t *code2 = gen_code_E5_X2(*N, 050661, E5AI_X2_init[prn-1]);
-        E5AI[prn-1] = xor_code(code1, code2, *N);
-        sdr_free(code1);
-        sdr_free(code2);
-    }
-    return E5AI[prn-1];
+    int8_t *code1 = gen_code_E5_X1(*N, 040503);
+    int8_t *code2 = gen_code_E5_X2(*N, 050661, E5AI_X2_init[prn-1]);
+    int8_t *code = xor_code(code1, code2, *N);
+    sdr_free(code1);
+    sdr_free(code2);
+    return code;
 }
 
 // generate E5AI secondary code ([5]) ------------------------------------------
@@ -1439,14 +1488,12 @@ static int8_t *gen_code_E5AQ(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!E5AQ[prn-1]) {
-        int8_t *code1 = gen_code_E5_X1(*N, 040503);
-        int8_t *code2 = gen_code_E5_X2(*N, 050661, E5AQ_X2_init[prn-1]);
-        E5AQ[prn-1] = xor_code(code1, code2, *N);
-        sdr_free(code1);
-        sdr_free(code2);
-    }
-    return E5AQ[prn-1];
+    int8_t *code1 = gen_code_E5_X1(*N, 040503);
+    int8_t *code2 = gen_code_E5_X2(*N, 050661, E5AQ_X2_init[prn-1]);
+    int8_t *code = xor_code(code1, code2, *N);
+    sdr_free(code1);
+    sdr_free(code2);
+    return code;
 }
 
 // generate E5AQ secondary code ([5]) ------------------------------------------
@@ -1469,14 +1516,12 @@ static int8_t *gen_code_E5BI(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!E5BI[prn-1]) {
-        int8_t *code1 = gen_code_E5_X1(*N, 064021);
-        int8_t *code2 = gen_code_E5_X2(*N, 051445, E5BI_X2_init[prn-1]);
-        E5BI[prn-1] = xor_code(code1, code2, *N);
-        sdr_free(code1);
-        sdr_free(code2);
-    }
-    return E5BI[prn-1];
+    int8_t *code1 = gen_code_E5_X1(*N, 064021);
+    int8_t *code2 = gen_code_E5_X2(*N, 051445, E5BI_X2_init[prn-1]);
+    int8_t *code = xor_code(code1, code2, *N);
+    sdr_free(code1);
+    sdr_free(code2);
+    return code;
 }
 
 // generate E5BQ code ----------------------------------------------------------
@@ -1486,14 +1531,12 @@ static int8_t *gen_code_E5BQ(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!E5BQ[prn-1]) {
-        int8_t *code1 = gen_code_E5_X1(*N, 064021);
-        int8_t *code2 = gen_code_E5_X2(*N, 043143, E5BQ_X2_init[prn-1]);
-        E5BQ[prn-1] = xor_code(code1, code2, *N);
-        sdr_free(code1);
-        sdr_free(code2);
-    }
-    return E5BQ[prn-1];
+    int8_t *code1 = gen_code_E5_X1(*N, 064021);
+    int8_t *code2 = gen_code_E5_X2(*N, 043143, E5BQ_X2_init[prn-1]);
+    int8_t *code = xor_code(code1, code2, *N);
+    sdr_free(code1);
+    sdr_free(code2);
+    return code;
 }
 
 // generate E5BI secondary code ([5]) ------------------------------------------
@@ -1526,10 +1569,7 @@ static int8_t *gen_code_E6B(int prn, int *N)
         return NULL;
     }
     *N = 5115;
-    if (!E6B[prn-1]) {
-        E6B[prn-1] = read_code_hex(code_gal_E6B[prn-1], *N);
-    }
-    return E6B[prn-1];
+    return read_code_hex(code_gal_E6B[prn-1], *N);
 }
 
 // generate E6C code ([6]) -----------------------------------------------------
@@ -1539,10 +1579,7 @@ static int8_t *gen_code_E6C(int prn, int *N)
         return NULL;
     }
     *N = 5115;
-    if (!E6C[prn-1]) {
-        E6C[prn-1] = read_code_hex(code_gal_E6C[prn-1], *N);
-    }
-    return E6C[prn-1];
+    return read_code_hex(code_gal_E6C[prn-1], *N);
 }
 
 // generate E6C secondary code -------------------------------------------------
@@ -1587,14 +1624,12 @@ static int8_t *gen_code_B1I(int prn, int *N)
         return NULL;
     }
     *N = 2046;
-    if (!B1I[prn-1]) {
-        int8_t * code1 = gen_code_B1I_G1(*N);
-        int8_t * code2 = gen_code_B1I_G2(*N, B1I_ph_sel[prn-1]);
-        B1I[prn-1] = xor_code(code1, code2, *N);
-        sdr_free(code1);
-        sdr_free(code2);
-    }
-    return B1I[prn-1];
+    int8_t * code1 = gen_code_B1I_G1(*N);
+    int8_t * code2 = gen_code_B1I_G2(*N, B1I_ph_sel[prn-1]);
+    int8_t *code = xor_code(code1, code2, *N);
+    sdr_free(code1);
+    sdr_free(code2);
+    return code;
 }
 
 // generate B1I secondary code ([12]) ------------------------------------------
@@ -1630,16 +1665,14 @@ static int8_t *gen_code_B1CD(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!B1CD[prn-1]) {
-        int8_t *code = (int8_t *)sdr_malloc(n);
-        for (int i = 0; i < n; i++) {
-            int j = (i + B1CD_trunc_pnt[prn-1] - 1) % 10243;
-            code[i] = B1C_weil_code(j, B1CD_ph_diff[prn-1]);
-        }
-        B1CD[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1)
-        sdr_free(code);
+    int8_t *code = (int8_t *)sdr_malloc(n);
+    for (int i = 0; i < n; i++) {
+        int j = (i + B1CD_trunc_pnt[prn-1] - 1) % 10243;
+        code[i] = B1C_weil_code(j, B1CD_ph_diff[prn-1]);
     }
-    return B1CD[prn-1];
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1)
+    sdr_free(code);
+    return code_m;
 }
 
 // generate B1CP code ([8]) ----------------------------------------------------
@@ -1650,16 +1683,14 @@ static int8_t *gen_code_B1CP(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!B1CP[prn-1]) {
-        int8_t *code = (int8_t *)sdr_malloc(n);
-        for (int i = 0; i < n; i++) {
-            int j = (i + B1CP_trunc_pnt[prn-1] - 1) % 10243;
-            code[i] = B1C_weil_code(j, B1CP_ph_diff[prn-1]);
-        }
-        B1CP[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1) instead of QMBOC
-        sdr_free(code);
+    int8_t *code = (int8_t *)sdr_malloc(n);
+    for (int i = 0; i < n; i++) {
+        int j = (i + B1CP_trunc_pnt[prn-1] - 1) % 10243;
+        code[i] = B1C_weil_code(j, B1CP_ph_diff[prn-1]);
     }
-    return B1CP[prn-1];
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1) instead of QMBOC
+    sdr_free(code);
+    return code_m;
 }
 
 // B1C Weil-code 3607 chip -----------------------------------------------------
@@ -1724,15 +1755,13 @@ static int8_t *gen_code_B2AD(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!B2AD[prn-1]) {
-        if (!B2AD_G1) {
-            B2AD_G1 = gen_code_B2AD_G1(*N);
-        }
-        int8_t *B2AD_G2 = gen_code_B2AD_G2(*N, B2AD_G2_init[prn-1]);
-        B2AD[prn-1] = xor_code(B2AD_G1, B2AD_G2, *N);
-        sdr_free(B2AD_G2);
+    if (!B2AD_G1) {
+        B2AD_G1 = gen_code_B2AD_G1(*N);
     }
-    return B2AD[prn-1];
+    int8_t *B2AD_G2 = gen_code_B2AD_G2(*N, B2AD_G2_init[prn-1]);
+    int8_t *code = xor_code(B2AD_G1, B2AD_G2, *N);
+    sdr_free(B2AD_G2);
+    return code;
 }
 
 // generate B2AD secondary code ------------------------------------------------
@@ -1768,15 +1797,13 @@ static int8_t *gen_code_B2AP(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!B2AP[prn-1]) {
-        if (!B2AP_G1) {
-            B2AP_G1 = gen_code_B2AP_G1(*N);
-        }
-        int8_t *B2AP_G2 = gen_code_B2AP_G2(*N, B2AP_G2_init[prn-1]);
-        B2AP[prn-1] = xor_code(B2AP_G1, B2AP_G2, *N);
-        sdr_free(B2AP_G2);
+    if (!B2AP_G1) {
+        B2AP_G1 = gen_code_B2AP_G1(*N);
     }
-    return B2AP[prn-1];
+    int8_t *B2AP_G2 = gen_code_B2AP_G2(*N, B2AP_G2_init[prn-1]);
+    int8_t *code = xor_code(B2AP_G1, B2AP_G2, *N);
+    sdr_free(B2AP_G2);
+    return code;
 }
 
 // B2A Weil-code 1021 chip -----------------------------------------------------
@@ -1829,15 +1856,13 @@ static int8_t *gen_code_B2BI(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!B2BI[prn-1]) {
-        if (!B2BI_G1) {
-            B2BI_G1 = gen_code_B2BI_G1(*N);
-        }
-        int8_t *B2BI_G2 = gen_code_B2BI_G2(*N, B2BI_G2_init[prn-1]);
-        B2BI[prn-1] = xor_code(B2BI_G1, B2BI_G2, *N);
-        sdr_free(B2BI_G2);
+    if (!B2BI_G1) {
+        B2BI_G1 = gen_code_B2BI_G1(*N);
     }
-    return B2BI[prn-1];
+    int8_t *B2BI_G2 = gen_code_B2BI_G2(*N, B2BI_G2_init[prn-1]);
+    int8_t *code = xor_code(B2BI_G1, B2BI_G2, *N);
+    sdr_free(B2BI_G2);
+    return code;
 }
 
 // generate B3I G1 code --------------------------------------------------------
@@ -1864,15 +1889,13 @@ static int8_t *gen_code_B3I(int prn, int *N)
         return NULL;
     }
     *N = 10230;
-    if (!B3I[prn-1]) {
-        if (!B3I_G1) {
-            B3I_G1 = gen_code_B3I_G1(*N);
-        }
-        int8_t *B3I_G2 = gen_code_B3I_G2(*N, B3I_G2_init[prn-1]);
-        B3I[prn-1] = xor_code(B3I_G1, B3I_G2, *N);
-        sdr_free(B3I_G2);
+    if (!B3I_G1) {
+        B3I_G1 = gen_code_B3I_G1(*N);
     }
-    return B3I[prn-1];
+    int8_t *B3I_G2 = gen_code_B3I_G2(*N, B3I_G2_init[prn-1]);
+    int8_t *code = xor_code(B3I_G1, B3I_G2, *N);
+    sdr_free(B3I_G2);
+    return code;
 }
 
 // generate B3I secondary code -------------------------------------------------
@@ -1904,19 +1927,17 @@ static int8_t *gen_code_I1SD(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!I1SD[prn-1]) {
-        int8_t *code = (int8_t *)sdr_malloc(n);
-        uint64_t R0 = I1SD_R0_init[prn-1];
-        uint64_t R1 = I1SD_R1_init[prn-1];
-        uint64_t C = I1SD_C_init[prn-1];
-        for (int i = 0; i < n; i++) {
-            code[i] = CHIP[((C>>4) ^ (R1>>54)) & 1];
-            shift_I1S(&R0, &R1, &C);
-        }
-        I1SD[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1)
-        sdr_free(code);
+    int8_t *code = (int8_t *)sdr_malloc(n);
+    uint64_t R0 = I1SD_R0_init[prn-1];
+    uint64_t R1 = I1SD_R1_init[prn-1];
+    uint64_t C = I1SD_C_init[prn-1];
+    for (int i = 0; i < n; i++) {
+        code[i] = CHIP[((C>>4) ^ (R1>>54)) & 1];
+        shift_I1S(&R0, &R1, &C);
     }
-    return I1SD[prn-1];
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1)
+    sdr_free(code);
+    return code_m;
 }
 
 // generate I1SP code ([18]) ---------------------------------------------------
@@ -1927,19 +1948,17 @@ static int8_t *gen_code_I1SP(int prn, int *N)
     }
     int n = 10230;
     *N = n * 2;
-    if (!I1SP[prn-1]) {
-        int8_t *code = (int8_t *)sdr_malloc(n);
-        uint64_t R0 = I1SP_R0_init[prn-1];
-        uint64_t R1 = I1SP_R1_init[prn-1];
-        uint64_t C = I1SP_C_init[prn-1];
-        for (int i = 0; i < n; i++) {
-            code[i] = CHIP[((C>>4) ^ (R1>>54)) & 1];
-            shift_I1S(&R0, &R1, &C);
-        }
-        I1SP[prn-1] = mod_code(code, n, BOC, 2); // BOC(1,1)
-        sdr_free(code);
+    int8_t *code = (int8_t *)sdr_malloc(n);
+    uint64_t R0 = I1SP_R0_init[prn-1];
+    uint64_t R1 = I1SP_R1_init[prn-1];
+    uint64_t C = I1SP_C_init[prn-1];
+    for (int i = 0; i < n; i++) {
+        code[i] = CHIP[((C>>4) ^ (R1>>54)) & 1];
+        shift_I1S(&R0, &R1, &C);
     }
-    return I1SP[prn-1];
+    int8_t *code_m = mod_code(code, n, BOC, 2); // BOC(1,1)
+    sdr_free(code);
+    return code_m;
 }
 
 // shift registers of I1S overlay code ([18]) ----------------------------------
@@ -1980,15 +1999,13 @@ static int8_t *gen_code_I5S(int prn, int *N)
         return NULL;
     }
     *N = 1023;
-    if (!I5S[prn-1]) {
-        int32_t R_init = rev_reg(I5S_G2_init[prn-1], 10);
-        int8_t *I5S_G1 = LFSR(*N, 0x3FF, 0x081, 10);
-        int8_t *I5S_G2 = LFSR(*N, R_init, 0x197, 10);
-        I5S[prn-1] = xor_code(I5S_G1, I5S_G2, *N);
-        sdr_free(I5S_G1);
-        sdr_free(I5S_G2);
-    }
-    return I5S[prn-1];
+    int32_t R_init = rev_reg(I5S_G2_init[prn-1], 10);
+    int8_t *I5S_G1 = LFSR(*N, 0x3FF, 0x081, 10);
+    int8_t *I5S_G2 = LFSR(*N, R_init, 0x197, 10);
+    int8_t *code = xor_code(I5S_G1, I5S_G2, *N);
+    sdr_free(I5S_G1);
+    sdr_free(I5S_G2);
+    return code;
 }
 
 // generate ISS code -----------------------------------------------------------
@@ -1998,18 +2015,17 @@ static int8_t *gen_code_ISS(int prn, int *N)
         return NULL;
     }
     *N = 1023;
-    if (!ISS[prn-1]) {
-        int32_t R_init = rev_reg(ISS_G2_init[prn-1], 10);
-        int8_t *ISS_G1 = LFSR(*N, 0x3FF, 0x081, 10);
-        int8_t *ISS_G2 = LFSR(*N, R_init, 0x197, 10);
-        ISS[prn-1] = xor_code(ISS_G1, ISS_G2, *N);
-        sdr_free(ISS_G1);
-        sdr_free(ISS_G2);
-    }
-    return ISS[prn-1];
+    int32_t R_init = rev_reg(ISS_G2_init[prn-1], 10);
+    int8_t *ISS_G1 = LFSR(*N, 0x3FF, 0x081, 10);
+    int8_t *ISS_G2 = LFSR(*N, R_init, 0x197, 10);
+    int8_t *code = xor_code(ISS_G1, ISS_G2, *N);
+    sdr_free(ISS_G1);
+    sdr_free(ISS_G2);
+    return code;
 }
 
 // generate primary code -------------------------------------------------------
+//  The generated code is not cached and should be freed by the caller.
 static int8_t *gen_code(const char *sig, int prn, int *N)
 {
     char Sig[16];
@@ -2145,8 +2161,20 @@ static int8_t *gen_code(const char *sig, int prn, int *N)
     return NULL;
 }
 
+// search primary code cache (code_mtx locked) ---------------------------------
+static code_t *find_code(const char *sig, int prn)
+{
+    code_t *p;
+    
+    for (p = codes; p; p = p->next) {
+        if (!strcmp(p->sig, sig) && p->prn == prn) break;
+    }
+    return p;
+}
+
 //------------------------------------------------------------------------------
-//  Generate primary code.
+//  Generate primary code. The code is generated once for the signal and the
+//  PRN number and cached until the end of the process.
 //
 //  args:
 //      sig      (I) Signal type as string ('L1CA', 'L1CB', 'L1CP', ....)
@@ -2159,13 +2187,108 @@ static int8_t *gen_code(const char *sig, int prn, int *N)
 //
 int8_t *sdr_gen_code(const char *sig, int prn, int *N)
 {
-    static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+    code_t *p;
+    char Sig[16];
     
-    pthread_mutex_lock(&mtx);
-    int8_t *code = gen_code(sig, prn, N);
-    pthread_mutex_unlock(&mtx);
+    sig_upper(sig, Sig);
+    pthread_mutex_lock(&code_mtx);
     
-    return code;
+    if (!(p = find_code(Sig, prn))) {
+        int n;
+        int8_t *code = gen_code(sig, prn, &n);
+        
+        if (code) {
+            p = (code_t *)sdr_malloc(sizeof(code_t));
+            snprintf(p->sig, sizeof(p->sig), "%s", Sig);
+            p->prn = prn;
+            p->N = n;
+            p->code = code;
+            p->next = codes;
+            codes = p;
+        }
+    }
+    pthread_mutex_unlock(&code_mtx);
+    
+    if (!p) return NULL;
+    *N = p->N;
+    return p->code;
+}
+
+// pack primary code -----------------------------------------------------------
+static int pack_code(const int8_t *code, int N, sdr_code_pack_t *pack)
+{
+    // search period of zero-chip pattern (TDM or BOC + TDM)
+    for (pack->nz = 1; pack->nz <= 8; pack->nz++) {
+        int i;
+        pack->zero = 0;
+        for (i = 0; i < pack->nz && i < N; i++) {
+            if (!code[i]) pack->zero |= (uint8_t)(1 << i);
+        }
+        for (i = 0; i < N; i++) {
+            if ((code[i] == 0) != ((pack->zero >> (i % pack->nz)) & 1)) break;
+        }
+        if (i >= N) break;
+    }
+    if (pack->nz > 8) return 0;
+    
+    pack->N = N;
+    pack->bits = (uint8_t *)sdr_malloc((N + 7) / 8 + 4); // padding for SIMD
+    for (int i = 0; i < N; i++) {
+        if (code[i] > 0) pack->bits[i >> 3] |= (uint8_t)(1 << (i & 7));
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Generate packed primary code. The packed code is generated on demand and
+//  cached with 1 bit per chip. The zero chips for TDM are represented by the
+//  periodic zero-chip pattern. Use SDR_CODE_CHIP() to get a chip of the code.
+//
+//  args:
+//      sig      (I) Signal type as string ('L1CA', 'L1CB', 'L1CP', ....)
+//      prn      (I) PRN number
+//
+//  return:
+//      Packed primary code (NULL: error)
+//      (sub-carrier modulated for BOC or zero-padded for TDM)
+//
+const sdr_code_pack_t *sdr_gen_code_pack(const char *sig, int prn)
+{
+    code_pack_t *p;
+    char Sig[16];
+    int N;
+    
+    sig_upper(sig, Sig);
+    pthread_mutex_lock(&code_mtx);
+    
+    for (p = code_packs; p; p = p->next) {
+        if (!strcmp(p->sig, Sig) && p->prn == prn) break;
+    }
+    if (!p) {
+        code_t *q = find_code(Sig, prn);
+        int8_t *code = q ? q->code : gen_code(sig, prn, &N);
+        
+        if (q) N = q->N;
+        if (code) {
+            p = (code_pack_t *)sdr_malloc(sizeof(code_pack_t));
+            if (pack_code(code, N, &p->code)) {
+                snprintf(p->sig, sizeof(p->sig), "%s", Sig);
+                p->prn = prn;
+                p->next = code_packs;
+                code_packs = p;
+            }
+            else {
+                fprintf(stderr, "code pack error: sig=%s prn=%d\n", sig, prn);
+                sdr_free(p);
+                p = NULL;
+            }
+            // free unpacked code to keep only packed code
+            if (!q) sdr_free(code);
+        }
+    }
+    pthread_mutex_unlock(&code_mtx);
+    
+    return p ? &p->code : NULL;
 }
 
 // generate secondary (overlay) code -------------------------------------------
@@ -2310,43 +2433,7 @@ int8_t *sdr_sec_code(const char *sig, int prn, int *N)
 //
 double sdr_code_cyc(const char *sig)
 {
-    char Sig[16];
-    
-    sig_upper(sig, Sig);
-    
-    if (!strcmp(Sig, "L1CA") || !strcmp(Sig, "L1CB") || !strcmp(Sig, "L1S" ) ||
-        !strcmp(Sig, "L5I" ) || !strcmp(Sig, "L5Q" ) || !strcmp(Sig, "L5SI") ||
-        !strcmp(Sig, "L5SIV") || !strcmp(Sig, "L5SQ") || !strcmp(Sig, "L5SQV") ||
-        !strcmp(Sig, "G1CA") || !strcmp(Sig, "G2CA") || !strcmp(Sig, "G3OCD") ||
-        !strcmp(Sig, "G3OCP") || !strcmp(Sig, "E5AI") || !strcmp(Sig, "E5AQ") ||
-        !strcmp(Sig, "E5BI") || !strcmp(Sig, "E5BQ") || !strcmp(Sig, "E6B" ) ||
-        !strcmp(Sig, "E6C" ) || !strcmp(Sig, "B1I" ) || !strcmp(Sig, "B2I" ) ||
-        !strcmp(Sig, "B2AD") || !strcmp(Sig, "B2AP") || !strcmp(Sig, "B2BI") ||
-        !strcmp(Sig, "B3I" ) || !strcmp(Sig, "I5S" ) || !strcmp(Sig, "ISS" )) {
-        return 1e-3;
-    }
-    else if (!strcmp(Sig, "G1OCD")) {
-        return 2e-3;
-    }
-    else if (!strcmp(Sig, "L6D" ) || !strcmp(Sig, "L6E" ) ||
-        !strcmp(Sig, "E1B" ) || !strcmp(Sig, "E1C" )) {
-        return 4e-3;
-    }
-    else if (!strcmp(Sig, "G1OCP")) {
-        return 8e-3;
-    }
-    else if (!strcmp(Sig, "L1CP") || !strcmp(Sig, "L1CD") ||
-        !strcmp(Sig, "B1CD") || !strcmp(Sig, "B1CP") || !strcmp(Sig, "I1SD") ||
-        !strcmp(Sig, "I1SP")) {
-        return 10e-3;
-    }
-    else if (!strcmp(Sig, "L2CM") || !strcmp(Sig, "G2OCP")) {
-        return 20e-3;
-    }
-    else if (!strcmp(Sig, "L2CL")) {
-        return 1500e-3;
-    }
-    return 0.0;
+    return sig_tbl[sdr_sig_id(sig)].cyc;
 }
 
 //------------------------------------------------------------------------------
@@ -2360,42 +2447,7 @@ double sdr_code_cyc(const char *sig)
 //
 int sdr_code_len(const char *sig)
 {
-    char Sig[16];
-    
-    sig_upper(sig, Sig);
-    
-    if (!strcmp(Sig, "L1CA") || !strcmp(Sig, "L1CB") || !strcmp(Sig, "L1S" ) ||
-        !strcmp(Sig, "G1OCD") || !strcmp(Sig, "I5S" ) || !strcmp(Sig, "ISS" )) {
-        return 1023;
-    }
-    else if (!strcmp(Sig, "L1CP") || !strcmp(Sig, "L1CD") ||
-        !strcmp(Sig, "L2CM") || !strcmp(Sig, "L5I" ) || !strcmp(Sig, "L5Q" ) ||
-        !strcmp(Sig, "L5SI") || !strcmp(Sig, "L5SIV") || !strcmp(Sig, "L5SQ") ||
-        !strcmp(Sig, "L5SQV") || !strcmp(Sig, "L6D" ) || !strcmp(Sig, "L6E" ) ||
-        !strcmp(Sig, "G2OCP") || !strcmp(Sig, "G3OCD") || !strcmp(Sig, "G3OCP") ||
-        !strcmp(Sig, "E5AI") || !strcmp(Sig, "E5AQ") || !strcmp(Sig, "E5BI") ||
-        !strcmp(Sig, "E5BQ") || !strcmp(Sig, "B1CD") || !strcmp(Sig, "B1CP") ||
-        !strcmp(Sig, "B2AD") || !strcmp(Sig, "B2AP") || !strcmp(Sig, "B2BI") ||
-        !strcmp(Sig, "B3I" ) || !strcmp(Sig, "I1SD") || !strcmp(Sig, "I1SP")) {
-        return 10230;
-    }
-    else if (!strcmp(Sig, "L2CL")) {
-        return 767250;
-    }
-    else if (!strcmp(Sig, "E6B" ) || !strcmp(Sig, "E6C" )) {
-        return 5115;
-    }
-    else if (!strcmp(Sig, "E1B" ) || !strcmp(Sig, "E1C" ) ||
-             !strcmp(Sig, "G1OCP")) {
-        return 4092;
-    }
-    else if (!strcmp(Sig, "G1CA") || !strcmp(Sig, "G2CA")) {
-        return 511;
-    }
-    else if (!strcmp(Sig, "B1I" ) || !strcmp(Sig, "B2I" )) {
-        return 2046;
-    }
-    return 0;
+    return sig_tbl[sdr_sig_id(sig)].len;
 }
 
 //------------------------------------------------------------------------------
@@ -2408,59 +2460,43 @@ int sdr_code_len(const char *sig)
 //      Signal carrier frequency (Hz) (0.0: error)
 //
 double sdr_sig_freq(const char *sig)
+{
+    return sig_tbl[sdr_sig_id(sig)].freq;
+}
+
+//------------------------------------------------------------------------------
+//  Get signal ID number of signal ID string.
+//
+//  args:
+//      sig      (I) Signal type as string ('L1CA', 'L1CB', 'L1CP', ....)
+//
+//  return:
+//      Signal ID (SDR_SIG_???) (0: error)
+//
+int sdr_sig_id(const char *sig)
 {
     char Sig[16];
     
     sig_upper(sig, Sig);
     
-    if (!strcmp(Sig, "L1CA") || !strcmp(Sig, "L1CB") || !strcmp(Sig, "L1S" ) ||
-        !strcmp(Sig, "E1B" ) || !strcmp(Sig, "E1C" ) || !strcmp(Sig, "L1CP") ||
-        !strcmp(Sig, "L1CD") || !strcmp(Sig, "B1CD") || !strcmp(Sig, "B1CP") ||
-        !strcmp(Sig, "I1SD") || !strcmp(Sig, "I1SP")) {
-        return 1575.42e6;
-    }
-    else if (!strcmp(Sig, "L2CM") || !strcmp(Sig, "L2CL")) {
-        return 1227.60e6;
-    }
-    else if (!strcmp(Sig, "L5I" ) || !strcmp(Sig, "L5Q" ) ||
-        !strcmp(Sig, "L5SI") || !strcmp(Sig, "L5SIV") || !strcmp(Sig, "L5SQ") ||
-        !strcmp(Sig, "L5SQV") || !strcmp(Sig, "E5AI") || !strcmp(Sig, "E5AQ") ||
-        !strcmp(Sig, "B2AD") || !strcmp(Sig, "B2AP") || !strcmp(Sig, "I5S")) {
-        return 1176.45e6;
-    }
-    else if (!strcmp(Sig, "E5BI") || !strcmp(Sig, "E5BQ") ||
-             !strcmp(Sig, "B2I" ) || !strcmp(Sig, "B2BI")) {
-        return 1207.14e6;
-    }
-    else if (!strcmp(Sig, "L6D" ) || !strcmp(Sig, "L6E" ) ||
-             !strcmp(Sig, "E6B" ) || !strcmp(Sig, "E6C" )) {
-        return 1278.75e6;
-    }
-    else if (!strcmp(Sig, "B1I" )) {
-        return 1561.098e6;
-    }
-    else if (!strcmp(Sig, "B3I" )) {
-        return 1268.52e6;
-    }
-    else if (!strcmp(Sig, "G1CA")) {
-        return 1602.0e6;
+    for (int i = 1; i < SDR_NUM_SIG; i++) {
+        if (!strcmp(Sig, sig_tbl[i].sig)) return i;
     }
-    else if (!strcmp(Sig, "G1OCD") || !strcmp(Sig, "G1OCP")) {
-        return 1600.995e6;
-    }
-    else if (!strcmp(Sig, "G2CA")) {
-        return 1246.0e6;
-    }
-    else if (!strcmp(Sig, "G2OCP")) {
-        return 1248.0e6;
-    }
-    else if (!strcmp(Sig, "G3OCD") || !strcmp(Sig, "G3OCP")) {
-        return 1202.025e6;
-    }
-    else if (!strcmp(Sig, "ISS" )) {
-        return 2492.028e6;
-    }
-    return 0.0;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//  Get signal descriptor.
+//
+//  args:
+//      id       (I) Signal ID (SDR_SIG_???)
+//
+//  return:
+//      Signal descriptor (NULL: error)
+//
+const sdr_sig_t *sdr_sig_get(int id)
+{
+    return id > 0 && id < SDR_NUM_SIG ? sig_tbl + id : NULL;
 }
 
 // get satellite ID for QZSS ([3],[4],[15]) ------------------------------------
@@ -2568,6 +2604,85 @@ void sdr_res_code(const int8_t *code, int len_code, double T, double coff,
     }
 }
 
+//------------------------------------------------------------------------------
+//  Generate resampled and zero-padded code from packed code.
+//
+//  args:
+//      code     (I) Packed code
+//      T        (I) Code cycle (period) (s)
+//      coff     (I) Code offset (s)
+//      fs       (I) Sampling frequency (Hz)
+//      N        (I) Number of samples
+//      Nz       (I) Number of zero-padding
+//      code_res (O) Resampled and zero-padded code as sdr_cpx16_t array
+//                   (N + Nz)
+//
+//  return:
+//      none
+//
+void sdr_res_code_pack(const sdr_code_pack_t *code, double T, double coff,
+    double fs, int N, int Nz, sdr_cpx16_t *code_res)
+{
+    double dx = code->N / T / fs;
+    
+    memset(code_res, 0, sizeof(sdr_cpx16_t) * (N + Nz));
+    
+    for (int i = 0; i < N; i++) {
+        int j = (int)((coff * fs + i) * dx) % code->N;
+        code_res[i].I = code_res[i].Q = (int8_t)SDR_CODE_CHIP(code, j);
+    }
+}
+
+// DFT of resampled code with conjugate ----------------------------------------
+//  The cached FFTW plan is executed into an aligned buffer, as code_fft may not
+//  be aligned as the buffers of the plan.
+static void code_dft(sdr_cpx_t *code_res, int N, sdr_cpx_t *code_fft)
+{
+    fftwf_plan plan[2];
+    
+    if (!sdr_fftw_plan(N, 1, plan)) return;
+    sdr_cpx_t *X = sdr_cpx_malloc(N);
+    fftwf_execute_dft(plan[0], code_res, X);
+    
+    // complex conjugate
+    for (int i = 0; i < N; i++) {
+        code_fft[i][0] =  X[i][0];
+        code_fft[i][1] = -X[i][1];
+    }
+    sdr_cpx_free(X);
+}
+
+//------------------------------------------------------------------------------
+//  Generate resampled and zero-padded code FFT (DFT) from packed code.
+//
+//  args:
+//      code     (I) Packed code
+//      T        (I) Code cycle (period) (s)
+//      coff     (I) Code offset (s)
+//      fs       (I) Sampling frequency (Hz)
+//      N        (I) Number of samples
+//      Nz       (I) Number of zero-padding
+//      code_fft (O) Resampled and zero-padded code DFT with conjugate as
+//                   complex array (N + Nz)
+//
+//  return:
+//      none
+//
+void sdr_gen_code_fft_pack(const sdr_code_pack_t *code, double T, double coff,
+    double fs, int N, int Nz, sdr_cpx_t *code_fft)
+{
+    double dx = code->N / T / fs;
+    sdr_cpx_t *code_res = sdr_cpx_malloc(N + Nz);
+    
+    memset(code_res, 0, sizeof(sdr_cpx_t) * (N + Nz));
+    for (int i = 0; i < N; i++) {
+        int j = (int)((coff * fs + i) * dx) % code->N;
+        code_res[i][0] = SDR_CODE_CHIP(code, j);
+    }
+    code_dft(code_res, N + Nz, code_fft);
+    sdr_cpx_free(code_res);
+}
+
 //------------------------------------------------------------------------------
 //  Generate resampled and zero-padded code FFT (DFT).
 //
@@ -2588,9 +2703,6 @@ void sdr_res_code(const int8_t *code, int len_code, double T, double coff,
 void sdr_gen_code_fft(const int8_t *code, int len_code, double T, double coff,
     double fs, int N, int Nz, sdr_cpx_t *code_fft)
 {
-    static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
-    static fftwf_plan plan = NULL;
-    static int N_plan = 0;
     double dx = len_code / T / fs;
     sdr_cpx_t *code_res = sdr_cpx_malloc(N + Nz);
     
@@ -2598,23 +2710,466 @@ void sdr_gen_code_fft(const int8_t *code, int len_code, double T, double coff,
     for (int i = 0; i < N; i++) {
         code_res[i][0] = code[(int)((coff * fs + i) * dx) % len_code];
     }
-    pthread_mutex_lock(&mtx);
-    if (N + Nz != N_plan) {
-        if (plan) {
-            fftwf_destroy_plan(plan);
+    code_dft(code_res, N + Nz, code_fft);
+    sdr_cpx_free(code_res);
+}
+
+
+//------------------------------------------------------------------------------
+//  Set code book file. The code book file is a binary cache of code books
+//  generated by sdr_code_book_get() to skip generating them in next runs. It
+//  consists of the header, the index of the records and the record data. The
+//  file of another format version, endianness or generator hash (generator
+//  version and data type sizes) is rejected, and the record of a primary code
+//  with another hash is not used. The generated code books are saved by
+//  sdr_code_book_save() or at the release of them by replacing the file with
+//  a new file atomically.
+//
+//  args:
+//      file     (I) Code book file path ("": no code book file)
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_code_book_file(const char *file)
+{
+    pthread_mutex_lock(&code_book_mtx);
+    snprintf(code_book_file, sizeof(code_book_file), "%s", file);
+    pthread_mutex_unlock(&code_book_mtx);
+    return 1;
+}
+
+// code book file header -------------------------------------------------------
+static book_head_t book_head(int n)
+{
+    book_head_t head;
+    char buff[64];
+    
+    memset(&head, 0, sizeof(head)); // zero padding for memcmp()
+    memcpy(head.id, BOOK_ID, sizeof(head.id));
+    head.ver = BOOK_VER;
+    head.endian = BOOK_ENDIAN;
+    int len = snprintf(buff, sizeof(buff), "%d,%d,%d", BOOK_GEN,
+        (int)sizeof(sdr_cpx_t), (int)sizeof(sdr_cpx16_t));
+    head.gen = rtk_crc32((const uint8_t *)buff, len);
+    head.n = n;
+    head.stamp = sdr_get_tick_ns();
+    return head;
+}
+
+// primary code hash -----------------------------------------------------------
+static uint32_t code_hash(const sdr_code_pack_t *code)
+{
+    uint32_t val[4];
+    
+    val[0] = rtk_crc32(code->bits, (code->N + 7) / 8);
+    val[1] = (uint32_t)code->N;
+    val[2] = (uint32_t)code->nz;
+    val[3] = code->zero;
+    return rtk_crc32((const uint8_t *)val, sizeof(val));
+}
+
+// code book file record header ------------------------------------------------
+static book_rec_t book_rec(const sdr_code_book_t *book)
+{
+    book_rec_t rec;
+    memset(&rec, 0, sizeof(rec)); // zero padding for memcmp()
+    snprintf(rec.sig, sizeof(rec.sig), "%s", book->sig);
+    rec.prn = book->prn;
+    rec.N = book->N;
+    rec.Nz = book->Nz;
+    rec.nbank = book->nbank;
+    rec.type = book->type;
+    rec.size = (book->N + book->Nz) * book->nbank * (book->type == SDR_CODE_FFT ?
+        (int)sizeof(sdr_cpx_t) : (int)sizeof(sdr_cpx16_t));
+    rec.hash = book->hash;
+    rec.fs = book->fs;
+    return rec;
+}
+
+// code book data pointer ------------------------------------------------------
+static void *book_data(const sdr_code_book_t *book)
+{
+    return book->type == SDR_CODE_FFT ? (void *)book->code_fft :
+        (void *)book->code_res;
+}
+
+// load code book file index (code_book_fmtx locked) ---------------------------
+//  The index is reloaded only if the file is replaced after the last load. The
+//  file of another format version, endianness or generator is rejected.
+static void load_index(const char *file)
+{
+    book_head_t head, ref = book_head(0);
+    FILE *fp;
+    
+    memset(&head, 0, sizeof(head));
+    if (!(fp = fopen(file, "rb"))) {
+        sdr_free(book_idx);
+        book_idx = NULL;
+        n_idx = 0;
+        *idx_file = '\0';
+        return;
+    }
+    int stat = fread(&head, sizeof(head), 1, fp) == 1 &&
+        !memcmp(head.id, ref.id, sizeof(head.id)) && head.ver == ref.ver &&
+        head.endian == ref.endian && head.gen == ref.gen && head.n >= 0;
+    if (!strcmp(idx_file, file) && head.stamp == idx_stamp &&
+        (stat || n_idx <= 0)) {
+        fclose(fp); // index up to date
+        return;
+    }
+    sdr_free(book_idx);
+    book_idx = NULL;
+    n_idx = 0;
+    snprintf(idx_file, sizeof(idx_file), "%s", file);
+    idx_stamp = head.stamp;
+    
+    if (!stat) {
+        fprintf(stderr, "code book file format error %s\n", file);
+    }
+    else if (head.n > 0) {
+        book_idx = (book_idx_t *)sdr_malloc(sizeof(book_idx_t) * head.n);
+        if (fread(book_idx, sizeof(book_idx_t), head.n, fp) ==
+            (size_t)head.n) {
+            n_idx = head.n;
+        }
+        else {
+            fprintf(stderr, "code book file read error %s\n", file);
         }
-        plan = fftwf_plan_dft_1d(N + Nz, code_res, code_fft, FFTW_FORWARD,
-            FFTW_ESTIMATE);
-        N_plan = N + Nz;
     }
-    pthread_mutex_unlock(&mtx);
+    fclose(fp);
+}
+
+// search code book file index (code_book_fmtx locked) -------------------------
+static const book_idx_t *find_index(const book_rec_t *rec)
+{
+    for (int i = 0; i < n_idx; i++) {
+        if (!memcmp(&book_idx[i].rec, rec, sizeof(book_rec_t))) {
+            return book_idx + i;
+        }
+    }
+    return NULL;
+}
+
+// open code book file of index (code_book_fmtx locked) ------------------------
+static FILE *open_index(const char *file)
+{
+    book_head_t head;
+    FILE *fp;
+    
+    if (!(fp = fopen(file, "rb"))) return NULL;
+    if (fread(&head, sizeof(head), 1, fp) != 1 || head.stamp != idx_stamp) {
+        fclose(fp); // replaced after index loaded
+        return NULL;
+    }
+    return fp;
+}
+
+// read code book from code book file (code_book_fmtx locked) ------------------
+static int read_book(const char *file, const sdr_code_book_t *book)
+{
+    book_rec_t rec = book_rec(book);
+    const book_idx_t *idx;
+    FILE *fp;
     
-    fftwf_execute_dft(plan, code_res, code_fft);
+    if (!*file) return 0;
     
-    // complex conjugate
-    for (int i = 0; i < N + Nz; i++) {
-        code_fft[i][1] = -code_fft[i][1];
+    load_index(file);
+    if (!(idx = find_index(&rec)) || !(fp = open_index(file))) return 0;
+    int stat = !fseek(fp, (long)idx->off, SEEK_SET) &&
+        fread(book_data(book), rec.size, 1, fp) == 1;
+    fclose(fp);
+    return stat;
+}
+
+// copy record data of code book file ------------------------------------------
+static int copy_data(FILE *ifp, int64_t off, int size, FILE *ofp)
+{
+    uint8_t buff[65536];
+    
+    if (fseek(ifp, (long)off, SEEK_SET)) return 0;
+    for (int n; size > 0; size -= n) {
+        n = size < (int)sizeof(buff) ? size : (int)sizeof(buff);
+        if (fread(buff, n, 1, ifp) != 1 || fwrite(buff, n, 1, ofp) != 1) {
+            return 0;
+        }
     }
-    sdr_cpx_free(code_res);
+    return 1;
+}
+
+// write code books to code book file (code_book_fmtx locked) ------------------
+//  The code books not in the file are added to the records of the file. The
+//  new file is written to <file>.tmp and renamed to replace the file
+//  atomically.
+static int write_books(const char *file, sdr_code_book_t **books, int n)
+{
+    sdr_code_book_t **books_w;
+    book_idx_t *idx;
+    FILE *ifp = NULL, *ofp;
+    char tmp[sizeof(idx_file)+4];
+    int m;
+    
+    load_index(file);
+    idx = (book_idx_t *)sdr_malloc(sizeof(book_idx_t) * (n_idx + n));
+    books_w = (sdr_code_book_t **)sdr_malloc(sizeof(sdr_code_book_t *) * n);
+    if (n_idx > 0) memcpy(idx, book_idx, sizeof(book_idx_t) * n_idx);
+    m = n_idx;
+    for (int i = 0; i < n; i++) {
+        book_rec_t rec = book_rec(books[i]);
+        int j = n_idx;
+        while (j < m && memcmp(&idx[j].rec, &rec, sizeof(rec))) j++;
+        if (find_index(&rec) || j < m) continue;
+        books_w[m-n_idx] = books[i];
+        idx[m++].rec = rec;
+    }
+    book_head_t head = book_head(m);
+    int64_t off = sizeof(head) + sizeof(book_idx_t) * m;
+    for (int i = 0; i < m; i++) {
+        idx[i].off = off;
+        off += idx[i].rec.size;
+    }
+    snprintf(tmp, sizeof(tmp), "%s.tmp", file);
+    int stat = m > n_idx && (n_idx <= 0 || (ifp = open_index(file))) &&
+        (ofp = fopen(tmp, "wb"));
+    if (stat) {
+        stat = fwrite(&head, sizeof(head), 1, ofp) == 1 &&
+            fwrite(idx, sizeof(book_idx_t), m, ofp) == (size_t)m;
+        for (int i = 0; stat && i < n_idx; i++) {
+            stat = copy_data(ifp, book_idx[i].off, book_idx[i].rec.size, ofp);
+        }
+        for (int i = n_idx; stat && i < m; i++) {
+            stat = fwrite(book_data(books_w[i-n_idx]), idx[i].rec.size, 1,
+                ofp) == 1;
+        }
+        stat = !fclose(ofp) && stat;
+    }
+    if (ifp) fclose(ifp);
+#if defined(WIN32)
+    if (stat) remove(file);
+#endif
+    if (stat && !rename(tmp, file)) {
+        sdr_free(book_idx);
+        book_idx = idx;
+        n_idx = m;
+        idx_stamp = head.stamp;
+    }
+    else {
+        if (m > n_idx) {
+            fprintf(stderr, "code book file write error %s\n", file);
+            remove(tmp);
+        }
+        sdr_free(idx);
+        stat = m <= n_idx;
+    }
+    sdr_free(books_w);
+    return stat;
+}
+
+// free code book --------------------------------------------------------------
+static void free_book(sdr_code_book_t *book)
+{
+    sdr_cpx_free(book->code_fft);
+    sdr_free(book->code_res);
+    sdr_free(book);
+}
+
+// generate code book ----------------------------------------------------------
+//  The code book is read from the code book file if recorded. Otherwise, the
+//  generated code book is marked to be saved to the code book file.
+static sdr_code_book_t *gen_book(const char *file, const char *sig, int prn,
+    double fs, int N, int Nz, int nbank, int type)
+{
+    const sdr_code_pack_t *code = sdr_gen_code_pack(sig, prn);
+    double T = sdr_code_cyc(sig);
+    
+    if (!code || T <= 0.0) return NULL;
+    
+    sdr_code_book_t *book = (sdr_code_book_t *)sdr_malloc(
+        sizeof(sdr_code_book_t));
+    sig_upper(sig, book->sig);
+    book->prn = prn;
+    book->fs = fs;
+    book->N = N;
+    book->Nz = Nz;
+    book->nbank = nbank;
+    book->type = type;
+    book->hash = code_hash(code);
+    if (type == SDR_CODE_FFT) {
+        book->code_fft = sdr_cpx_malloc((N + Nz) * nbank);
+    }
+    else {
+        book->code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) *
+            (N + Nz) * nbank);
+    }
+    pthread_mutex_lock(&code_book_fmtx);
+    int stat = read_book(file, book);
+    pthread_mutex_unlock(&code_book_fmtx);
+    if (stat) return book;
+    
+    for (int i = 0; i < nbank; i++) {
+        double coff = -i / fs / nbank;
+        if (type == SDR_CODE_FFT) {
+            sdr_gen_code_fft_pack(code, T, coff, fs, N, Nz,
+                book->code_fft + i * (N + Nz));
+        }
+        else {
+            sdr_res_code_pack(code, T, coff, fs, N, Nz,
+                book->code_res + i * (N + Nz));
+        }
+    }
+    book->save = 1;
+    return book;
+}
+
+// search code book in code book cache (code_book_mtx locked) ------------------
+static sdr_code_book_t *find_book(const char *sig, int prn, double fs, int N,
+    int Nz, int nbank, int type)
+{
+    sdr_code_book_t *book;
+    
+    for (book = code_books; book; book = book->next) {
+        if (!strcmp(book->sig, sig) && book->prn == prn && book->fs == fs &&
+            book->N == N && book->Nz == Nz && book->nbank == nbank &&
+            book->type == type) break;
+    }
+    return book;
+}
+
+//------------------------------------------------------------------------------
+//  Get code book of code FFTs or resampled codes. The code book is shared in
+//  the process with reference count. The code book contains nbank codes with
+//  code offsets -i / fs / nbank (s) (i = 0, 1, ..., nbank - 1). A code book
+//  not in the cache is generated out of the cache lock and published to the
+//  cache unless published by another thread meanwhile. The code book file is
+//  read and written without the cache lock.
+//
+//  args:
+//      sig      (I) Signal ID as string ('L1CA', 'L1CB', 'L1CP', ....)
+//      prn      (I) PRN number
+//      fs       (I) Sampling frequency (Hz)
+//      N        (I) Number of samples
+//      Nz       (I) Number of zero-padding
+//      nbank    (I) Number of code offsets in code book
+//      type     (I) Code book type (SDR_CODE_FFT: code FFT as
+//                   sdr_gen_code_fft(), SDR_CODE_RES: resampled code as
+//                   sdr_res_code())
+//
+//  return:
+//      Code book (NULL: error)
+//
+sdr_code_book_t *sdr_code_book_get(const char *sig, int prn, double fs, int N,
+    int Nz, int nbank, int type)
+{
+    sdr_code_book_t *book, *book_new;
+    char Sig[16], file[sizeof(code_book_file)];
+    
+    sig_upper(sig, Sig);
+    pthread_mutex_lock(&code_book_mtx);
+    if ((book = find_book(Sig, prn, fs, N, Nz, nbank, type))) book->ref++;
+    snprintf(file, sizeof(file), "%s", code_book_file);
+    pthread_mutex_unlock(&code_book_mtx);
+    if (book) return book;
+    
+    if (!(book_new = gen_book(file, sig, prn, fs, N, Nz, nbank, type))) {
+        return NULL;
+    }
+    
+    pthread_mutex_lock(&code_book_mtx);
+    if (!(book = find_book(Sig, prn, fs, N, Nz, nbank, type))) {
+        book = book_new;
+        book->next = code_books;
+        code_books = book;
+        book_new = NULL;
+    }
+    book->ref++;
+    pthread_mutex_unlock(&code_book_mtx);
+    if (book_new) {
+        free_book(book_new); // published by another thread
+    }
+    return book;
+}
+
+//------------------------------------------------------------------------------
+//  Release code book got by sdr_code_book_get(). The code book is freed if
+//  it is not referenced. The code book not saved to the code book file is
+//  saved before freed.
+//
+//  args:
+//      book     (I) Code book (NULL: no operation)
+//
+//  return:
+//      none
+//
+void sdr_code_book_put(sdr_code_book_t *book)
+{
+    char file[sizeof(code_book_file)];
+    
+    if (!book) return;
+    
+    pthread_mutex_lock(&code_book_mtx);
+    int ref = --book->ref;
+    if (ref <= 0) {
+        for (sdr_code_book_t **p = &code_books; *p; p = &(*p)->next) {
+            if (*p != book) continue;
+            *p = book->next;
+            break;
+        }
+    }
+    snprintf(file, sizeof(file), "%s", code_book_file);
+    pthread_mutex_unlock(&code_book_mtx);
+    
+    if (ref > 0) return;
+    if (book->save && *file) {
+        pthread_mutex_lock(&code_book_fmtx);
+        write_books(file, &book, 1);
+        pthread_mutex_unlock(&code_book_fmtx);
+    }
+    free_book(book);
 }
 
+//------------------------------------------------------------------------------
+//  Save the code books generated and not saved yet to the code book file. The
+//  code books are added to the code book file at once. The code book file is
+//  written without the cache lock.
+//
+//  args:
+//      none
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_code_book_save(void)
+{
+    sdr_code_book_t *book, **books;
+    char file[sizeof(code_book_file)];
+    int n = 0, stat = 1;
+    
+    pthread_mutex_lock(&code_book_mtx);
+    snprintf(file, sizeof(file), "%s", code_book_file);
+    for (book = code_books; book; book = book->next) {
+        if (book->save) n++;
+    }
+    if (!*file || n <= 0) {
+        pthread_mutex_unlock(&code_book_mtx);
+        return 1;
+    }
+    books = (sdr_code_book_t **)sdr_malloc(sizeof(sdr_code_book_t *) * n);
+    n = 0;
+    for (book = code_books; book; book = book->next) {
+        if (!book->save) continue;
+        book->save = 0;
+        book->ref++;
+        books[n++] = book;
+    }
+    pthread_mutex_unlock(&code_book_mtx);
+    
+    pthread_mutex_lock(&code_book_fmtx);
+    stat = write_books(file, books, n);
+    pthread_mutex_unlock(&code_book_fmtx);
+    
+    for (int i = 0; i < n; i++) {
+        sdr_code_book_put(books[i]);
+    }
+    sdr_free(books);
+    return stat;
+}
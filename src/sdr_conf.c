@@ -12,6 +12,8 @@
 //  2024-04-20  1.3  support Pocket SDR FE 4CH
 //  2024-06-29  1.4  delete API sdr_read_settings(), sdr_write_settings()
 //                   add API sdr_conf_read(), sdr_conf_write()
+//  2026-10-15  1.5  access registers by register block through register
+//                   shadow cache of device
 //
 #include "pocket_sdr.h"
 
@@ -435,44 +437,12 @@ static int write_config(const char *file, int type, double fx,
     return 1;
 }
 
-// read device register --------------------------------------------------------
-static uint32_t read_reg(sdr_usb_t *usb, int ch, int addr)
-{
-    uint8_t data[4] = {0};
-    
-    if (!sdr_usb_req(usb, 0, SDR_VR_REG_READ, (uint16_t)((ch << 8) + addr),
-             data, 4)) {
-        fprintf(stderr, "register read error. [CH%d] 0x%X\n", ch + 1, addr);
-        return 0;
-    }
-    uint32_t val = 0;
-    
-    for (int i = 0; i < 4; i++ ) {
-        val = (val << 8) | data[i];
-    }
-    return val;
-}
-
-// write device register -------------------------------------------------------
-static void write_reg(sdr_usb_t *usb, int ch, int addr, uint32_t val)
-{
-    uint8_t data[4];
-    
-    for (int i = 0; i < 4; i++ ) {
-        data[i] = (uint8_t)(val >> (3 - i) * 8);
-    }
-    if (!sdr_usb_req(usb, 1, SDR_VR_REG_WRITE, (uint16_t)((ch << 8) + addr),
-             data, 4)) {
-        fprintf(stderr, "register write error. [CH%d] 0x%X\n", ch + 1, addr);
-    }
-}
-
 // read settings from device registers -----------------------------------------
-static void read_regs(sdr_usb_t *usb, int type, uint32_t regs[][SDR_MAX_REG])
+static void read_regs(sdr_dev_t *dev, int type, uint32_t regs[][SDR_MAX_REG])
 {
     for (int i = 0; i < max_ch(type); i++) {
-        for (int j = 0; j < max_reg(type); j++) {
-            regs[i][j] = read_reg(usb, i, j);
+        if (!sdr_dev_read_regs(dev, i, 0, max_reg(type), regs[i])) {
+            memset(regs[i], 0, sizeof(uint32_t) * max_reg(type));
         }
     }
 }
@@ -504,19 +474,27 @@ static void set_fixed(int type, uint32_t regs[][SDR_MAX_REG])
     }
 }
 
+// test reserved or test register ----------------------------------------------
+static int test_reg(int type, int addr)
+{
+    if (type == TYPE_SPIDER) {
+        return addr == 6 || addr == 8;
+    }
+    return addr == 6 || addr == 8 || addr == 9; // Pocket SDR
+}
+
 // write settings to device registers ------------------------------------------
-static void write_regs(sdr_usb_t *usb, int type, uint32_t regs[][SDR_MAX_REG])
+static void write_regs(sdr_dev_t *dev, int type, uint32_t regs[][SDR_MAX_REG])
 {
     for (int i = 0; i < max_ch(type); i++) {
-        for (int j = 0; j < max_reg(type); j++) {
-            // write register except reserved or test reg
-            if (type == TYPE_SPIDER) {
-                if (j == 6 || j == 8) continue;
-            }
-            else { // Pocket SDR
-                if (j == 6 || j == 8 || j == 9) continue;
+        for (int j = 0, k; j < max_reg(type); j = k) {
+            // write runs of registers except reserved or test reg
+            if (test_reg(type, j)) {
+                k = j + 1;
+                continue;
             }
-            write_reg(usb, i, j, regs[i][j]);
+            for (k = j + 1; k < max_reg(type) && !test_reg(type, k); k++) ;
+            sdr_dev_write_regs(dev, i, j, k - j, regs[i] + j);
         }
     }
 }
@@ -555,7 +533,7 @@ int sdr_conf_read(sdr_dev_t *dev, const char *file, int opt)
         return 0;
     }
     // read settings from device registers
-    read_regs(dev->usb, type, regs);
+    read_regs(dev, type, regs);
     
     // write settings to configuration file
     if (!write_config(file, type, fx * 1e-6, regs, opt)) {
@@ -590,7 +568,7 @@ int sdr_conf_write(sdr_dev_t *dev, const char *file, int opt)
         return 0;
     }
     // read settings from device registers
-    read_regs(dev->usb, type, regs);
+    read_regs(dev, type, regs);
     
     // set fixed value of settings
     set_fixed(type, regs);
@@ -600,7 +578,7 @@ int sdr_conf_write(sdr_dev_t *dev, const char *file, int opt)
         return 0;
     }
     // write settings to device registers
-    write_regs(dev->usb, type, regs);
+    write_regs(dev, type, regs);
     
     if (opt & 1) {
         // save device registers to EEPROM
@@ -17,33 +17,299 @@
 //  2024-05-28  1.6  delete API sdr_dev_info()
 //  2024-06-29  1.7  add API sdr_dev_get_info(), sdr_dev_set_gain(),
 //                   sdr_dev_get_gain()
+//  2026-10-14  1.8  notify raw data buffer update, add API sdr_dev_wait()
+//                   lock-free raw data buffer with overrun detection
+//                   add API sdr_dev_peek(), sdr_dev_consume()
+//                   add API sdr_dev_set_buff(), peak unread data size
+//                   sequence check and error flags of USB transfers
+//                   add API sdr_dev_sync(), sdr_dev_check()
+//                   add API sdr_dev_set_thread(), USB device memory for raw
+//                   data buffer
+//  2026-10-15  1.9  handle USB events of device by its own USB context
+//                   record time of first USB transfer for multiple devices
+//                   shared memory IF broker, add API sdr_dev_share(),
+//                   sdr_dev_attach()
+//                   network IF stream, add API sdr_dev_stream(),
+//                   sdr_dev_connect()
+//                   register shadow cache, vendor requests of register block
+//                   add API sdr_dev_read_regs(), sdr_dev_write_regs()
+//                   frame headers with sample counter of USB transfers, add
+//                   API sdr_dev_set_frame()
+//                   allocate raw data buffer by sdr_mem_alloc()
 //
 #include "pocket_sdr.h"
 #ifdef WIN32
 #include <avrt.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #endif
 
 // constants and macros --------------------------------------------------------
-#define BUFF_SIZE       (SDR_SIZE_BUFF * SDR_MAX_BUFF)
+#define BUFF_SIZE(dev)  ((dev)->size_data * (dev)->nbuff) // ring size (bytes)
 #define TO_TRANSFER     3000    // USB transfer timeout (ms)
+#define MAX_UNREAD(dev) (BUFF_SIZE(dev) - (dev)->size_data) // max unread data
+#define MIN_BUFF        4       // min number of USB transfer buffers
+#define ALIGN_BUFF      1024    // alignment of USB transfer buffer size (bytes)
+#define PRI_USB         99      // default priority of USB event handler
+#define SHM_MAGIC       0x50534852 // magic number of IF broker header
+#define SHM_ALIGN       4096    // alignment of IF broker segment (bytes)
+#define SHM_POLL        1       // polling cycle of IF broker reader (ms)
+#define NET_MAGIC       0x464E5350 // magic number of network IF packet
+#define NET_HEAD        16      // size of network IF packet header (bytes)
+#define NET_PAYLOAD     1024    // size of network IF packet payload (bytes)
+#define NET_PKT         (NET_HEAD + NET_PAYLOAD) // max size of packet (bytes)
+#define NET_BATCH       64      // max number of packets per system call
+#define NET_INFO_CYC    1000    // cycle of device info packets (ms)
+#define NET_TO          3000    // timeout of device info packet (ms)
+#define NET_TO_SOCK     100     // timeout of socket send and receive (ms)
+#define NET_POLL        1       // polling cycle of network IF sender (ms)
+#define NET_SIZE_SOCK   (8 << 20) // size of socket buffer (bytes)
+#define NET_FLAG_ERR    0x01    // packet flag: transfer error
+#define NET_FLAG_INFO   0x02    // packet flag: device info
+#define FRM_MAGIC       0x4D524650 // magic number of frame header
+#define FRM_FLAG_OVR    0x01    // frame flag: overrun of device before frame
+
+#define MIN(x, y)       ((x) < (y) ? (x) : (y))
+#define MAX(x, y)       ((x) > (y) ? (x) : (y))
+#define SHM_ALIGN_UP(n) (((size_t)(n) + SHM_ALIGN - 1) / SHM_ALIGN * SHM_ALIGN)
+#define SHM_OFF_ERR     SHM_ALIGN_UP(sizeof(sdr_shm_t)) // offset of error flags
+#define SHM_OFF_BUFF(nbuff) (SHM_OFF_ERR + SHM_ALIGN_UP(nbuff)) // ring offset
+
+// shared memory IF broker header ----------------------------------------------
+//  The shared memory segment of the IF broker consists of the header, the
+//  error flags of the USB transfer buffers and the raw data buffer. The write
+//  pointer and the transfer counters are updated by the seqlock to be read
+//  consistently by the readers in other processes.
+typedef struct sdr_shm_tag {
+    uint32_t magic;             // magic number (SHM_MAGIC: ready)
+    int32_t fmt, nch;           // IF data format and number of RF channels
+    int32_t nbuff, size_buff;   // number and size of USB transfer buffers
+    int32_t IQ[SDR_MAX_RFCH];   // sampling types of RF channels
+    double fs;                  // sampling frequency (Hz)
+    double fo[SDR_MAX_RFCH];    // LO frequencies of RF channels (Hz)
+    uint8_t pad0[SDR_CACHE_LINE]; // padding to separate cache lines
+    uint32_t seq;               // sequence of seqlock (odd: writing) (atomic)
+    int32_t state;              // state of publisher (0:stop,1:run) (atomic)
+    int64_t wp;                 // write pointer of raw data buffer (atomic)
+    int64_t ndrop, nseq;        // number of dropped and out-of-sequence
+                                // transfers (atomic)
+} sdr_shm_t;
+
+// network IF stream type ------------------------------------------------------
+//  The IF data are sent as the packets of the header and NET_PAYLOAD bytes of
+//  the raw data as received from the device (RAW8 or RAW16) without repacking.
+//  The packet header consists of the magic number (4 bytes), the payload size
+//  (2 bytes), the IF data format (1 byte), the packet flags (1 byte) and the
+//  sequence number of the packet (8 bytes) in little endian. The device info
+//  is sent as the payload of the packet with the flag NET_FLAG_INFO every
+//  NET_INFO_CYC ms.
+typedef struct sdr_net_tag {
+    int tcp;                    // protocol (0:UDP,1:TCP)
+    int sock;                   // socket (-1: not connected)
+    int sock_lsn;               // listening socket of TCP sender (-1: no)
+    int fmt, nch;               // IF data format and number of RF channels
+    int IQ[SDR_MAX_RFCH];       // sampling types of RF channels
+    double fs;                  // sampling frequency (Hz)
+    double fo[SDR_MAX_RFCH];    // LO frequencies of RF channels (Hz)
+    uint64_t seq;               // sequence number of next packet (sender)
+    uint64_t base;              // sequence number at position 0 (reader)
+    int64_t rp;                 // read pointer of raw data buffer (sender)
+    int64_t pos;                // write position of raw data buffer (reader)
+    int sync, err;              // synced and error flag of transfer (reader)
+    uint32_t tick;              // time of last device info packet (ms)
+    pthread_t thread;           // network IF sender thread
+    uint8_t *pkt;               // packet buffer {NET_BATCH * NET_PKT}
+} sdr_net_t;
+
+// write status of raw data buffer to IF broker header (seqlock writer) --------
+static void put_shm(sdr_dev_t *dev, int64_t wp)
+{
+    sdr_shm_t *shm = dev->shm;
+    uint32_t seq = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED) + 1;
+    
+    __atomic_store_n(&shm->seq, seq, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&shm->wp, wp, __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->ndrop, __atomic_load_n(&dev->ndrop,
+        __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->nseq, __atomic_load_n(&dev->nseq, __ATOMIC_RELAXED),
+        __ATOMIC_RELAXED);
+    __atomic_store_n(&shm->seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+// read status of raw data buffer from IF broker header (seqlock reader) -------
+static int get_shm(const sdr_shm_t *shm, int64_t *stat)
+{
+    uint32_t seq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+    
+    if (seq & 1) return 0; // writing
+    stat[0] = __atomic_load_n(&shm->wp, __ATOMIC_RELAXED);
+    stat[1] = __atomic_load_n(&shm->ndrop, __ATOMIC_RELAXED);
+    stat[2] = __atomic_load_n(&shm->nseq, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == seq;
+}
+
+// notify raw data buffer update to reader -------------------------------------
+static void notify_reader(sdr_dev_t *dev)
+{
+    // notify to reader only if waiting
+    if (__atomic_load_n(&dev->wait, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&dev->mtx);
+        pthread_cond_signal(&dev->cond);
+        pthread_mutex_unlock(&dev->mtx);
+    }
+}
+
+// update write pointer of raw data buffer (producer) -------------------------
+//  The error flag of the transfer buffer is set before the write pointer is
+//  released to the reader.
+static void update_wp(sdr_dev_t *dev, int size, int err)
+{
+    int64_t wp = __atomic_load_n(&dev->wp, __ATOMIC_RELAXED);
+    int64_t rp = __atomic_load_n(&dev->rp, __ATOMIC_ACQUIRE);
+    
+    dev->err[(wp / dev->size_data) % dev->nbuff] = (uint8_t)(err != 0);
+    if (wp == 0) {
+        __atomic_store_n(&dev->t0, sdr_get_tick_ns(), __ATOMIC_RELAXED);
+    }
+    wp += size;
+    
+    // transfer error or overrun of unread data
+    if (err || wp - rp > MAX_UNREAD(dev)) {
+        __atomic_fetch_add(&dev->ndrop, 1, __ATOMIC_RELAXED);
+    }
+    if (wp - rp > __atomic_load_n(&dev->unread_max, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&dev->unread_max, wp - rp, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&dev->lat.t, sdr_get_tick_us(), __ATOMIC_RELAXED);
+    __atomic_store_n(&dev->wp, wp, __ATOMIC_SEQ_CST);
+    
+    // publish write pointer to IF broker readers
+    if (dev->shm) put_shm(dev, wp);
+    
+    notify_reader(dev);
+}
+
+// get unread data size of raw data buffer (consumer) --------------------------
+static int64_t get_unread(sdr_dev_t *dev)
+{
+    return __atomic_load_n(&dev->wp, __ATOMIC_ACQUIRE) - dev->rp;
+}
+
+// get latest write pointer of raw data buffer (consumer) ----------------------
+//  The write pointer of the IF broker reader is read from the IF broker header
+//  since the local one lags by the polling cycle.
+static int64_t get_wp(sdr_dev_t *dev)
+{
+    if (dev->shm_rd) {
+        return __atomic_load_n(&dev->shm->wp, __ATOMIC_ACQUIRE);
+    }
+    return __atomic_load_n(&dev->wp, __ATOMIC_ACQUIRE);
+}
+
+// read device info and status -------------------------------------------------
+//  The device info is read once and cached. Only the static fields of the
+//  device info (F/W version, TCXO frequency and device type) should be used.
+static const uint8_t *read_info(sdr_dev_t *dev)
+{
+    uint8_t data[6];
+    
+    if (!dev->info[0]) {
+        if (!sdr_usb_req(dev->usb, 0, SDR_VR_STAT, 0, data, 6)) {
+            return NULL;
+        }
+        memcpy(dev->info, data, 6);
+    }
+    return dev->info;
+}
+
+// test register block access of device ----------------------------------------
+//  The vendor requests of the register block are supported by F/W ver.1.1
+//  (FE 2CH) or ver.3.1 (FE 4CH) and later.
+static int test_blk(sdr_dev_t *dev)
+{
+    if (!dev->blk) {
+        const uint8_t *info = read_info(dev);
+        if (!info) return 0;
+        int ver = info[0];
+        dev->blk = ((ver >> 4) == 1 || (ver >> 4) == 3) && (ver & 0xF) >= 1 ?
+            1 : -1;
+    }
+    return dev->blk > 0;
+}
+
+// test register same as register shadow cache ---------------------------------
+static int same_reg(const sdr_dev_t *dev, int ch, int addr, uint32_t val)
+{
+    return ((dev->regs_ok[ch] >> addr) & 1) && dev->regs[ch][addr] == val;
+}
+
+// read or write device registers by USB vendor requests -----------------------
+static int req_regs(sdr_dev_t *dev, int mode, int ch, int addr, int n,
+    uint32_t *regs)
+{
+    uint8_t data[4 * SDR_MAX_REG];
+    int blk = n > 1 && test_blk(dev);
+    
+    for (int i = 0; mode && i < 4 * n; i++) { // big endian
+        data[i] = (uint8_t)(regs[i / 4] >> (3 - i % 4) * 8);
+    }
+    if (blk && !sdr_usb_req(dev->usb, mode, mode ? SDR_VR_REG_WRITE_BLK :
+            SDR_VR_REG_READ_BLK, (uint16_t)((ch << 8) + addr), data, 4 * n)) {
+        dev->blk = blk = -1; // fall back to access to each register
+    }
+    for (int i = 0; blk <= 0 && i < n; i++) {
+        if (!sdr_usb_req(dev->usb, mode, mode ? SDR_VR_REG_WRITE :
+                SDR_VR_REG_READ, (uint16_t)((ch << 8) + addr + i), data + 4 * i,
+                4)) {
+            return 0;
+        }
+    }
+    for (int i = 0; !mode && i < n; i++) {
+        regs[i] = ((uint32_t)data[4 * i] << 24) +
+            ((uint32_t)data[4 * i + 1] << 16) +
+            ((uint32_t)data[4 * i + 2] << 8) + data[4 * i + 3];
+    }
+    return 1;
+}
+
+// pointer to data in raw data buffer ------------------------------------------
+//  The data position excludes the frame headers. The size of contiguous data
+//  from the position to the end of the frame or the buffer is returned in n.
+static uint8_t *buff_ptr(const sdr_dev_t *dev, int64_t pos, int *n)
+{
+    if (!dev->size_hdr) {
+        int p = (int)(pos % BUFF_SIZE(dev));
+        *n = BUFF_SIZE(dev) - p;
+        return dev->buff + p;
+    }
+    int size = dev->size_frm - dev->size_hdr;
+    int i = (int)((pos / size) % (BUFF_SIZE(dev) / size));
+    *n = size - (int)(pos % size);
+    return dev->buff + (size_t)i * dev->size_frm + dev->size_hdr + pos % size;
+}
 
 // read MAX2771 status ---------------------------------------------------------
 static int read_MAX2771_stat(sdr_dev_t *dev, int ch, double fx, double *fs,
     double *fo, int *IQ)
 {
     static const double ratio[8] = {2.0, 0.25, 0.5, 1.0, 4.0};
-    uint8_t data[4];
     uint32_t reg[11], ENIQ, INT_PLL, NDIV, RDIV, FDIV, REFDIV, FCLKIN, ADCCLK;
     uint32_t REFCLK_L, REFCLK_M, ADCCLK_L, ADCCLK_M, PREFRACDIV;
     
-    for (int i = 0; i < 11; i++) {
-        if (!sdr_usb_req(dev->usb, 0, SDR_VR_REG_READ, (ch << 8) + i, data,
-            4)) {
-            return 0;
-        }
-        for (int j = 0; j < 4; j++) { // swap bytes
-            *((uint8_t *)(reg + i) + j) = data[3 - j];
-        }
+    if (!sdr_dev_read_regs(dev, ch, 0, 11, reg)) {
+        return 0;
     }
     ENIQ     = (reg[ 1] >> 27) & 0x1;
     INT_PLL  = (reg[ 3] >>  3) & 0x1;
@@ -73,18 +339,11 @@ static int read_MAX2769B_stat(sdr_dev_t *dev, int ch, double fx, double *fs,
     double *fo, int *IQ)
 {
     static const double ratio[8] = {2.0, 0.25, 0.5, 1.0};
-    uint8_t data[4];
     uint32_t reg[8], ENIQ, INT_PLL, NDIV, RDIV, FDIV, REFDIV, L_CNT, M_CNT;
     uint32_t FCLKIN, ADCCLK;
     
-    for (int i = 0; i < 8; i++) {
-        if (!sdr_usb_req(dev->usb, 0, SDR_VR_REG_READ, (ch << 8) + i, data,
-            4)) {
-            return 0;
-        }
-        for (int j = 0; j < 4; j++) { // swap bytes
-            *((uint8_t *)(reg + i) + j) = data[3 - j];
-        }
+    if (!sdr_dev_read_regs(dev, ch, 0, 8, reg)) {
+        return 0;
     }
     ENIQ    = (reg[1] >> 27) & 0x1;
     INT_PLL = (reg[3] >>  3) & 0x1;
@@ -141,142 +400,1074 @@ static CCyBulkEndPoint *get_bulk_ep(sdr_usb_t *usb, int ep)
     return NULL;
 }
 
-// USB event handler thread ----------------------------------------------------
-static void *event_handler(void *arg)
+// USB event handler thread ----------------------------------------------------
+static void *event_handler(void *arg)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)arg;
+    CCyBulkEndPoint *ep;
+    long len = dev->size_buff;
+    
+    // rise process/thread priority and pin thread
+    if (dev->pri > 0) rise_pri();
+    sdr_set_thread(dev->cpu, 0);
+    
+    if (!(ep = get_bulk_ep(dev->usb, SDR_DEV_EP))) {
+        fprintf(stderr, "bulk endpoint get error ep=0x%02X\n", SDR_DEV_EP);
+        return 0;
+    }
+    uint8_t **ctx = (uint8_t **)sdr_malloc(sizeof(uint8_t *) * dev->nbuff);
+    OVERLAPPED *ov = (OVERLAPPED *)sdr_malloc(sizeof(OVERLAPPED) * dev->nbuff);
+    ep->SetXferSize(len);
+    for (int i = 0; i < dev->nbuff; i++) {
+        ov[i].hEvent = CreateEvent(NULL, false, false, NULL);
+        ctx[i] = ep->BeginDataXfer(dev->buff + len * i, len, &ov[i]); 
+    }
+    for (int i = 0; dev->state; ) {
+        if (!ep->WaitForXfer(&ov[i], TO_TRANSFER)) {
+            fprintf(stderr, "bulk transfer timeout\n");
+            continue;
+        }
+        if (!ep->FinishDataXfer(dev->buff + len * i, len, &ov[i], ctx[i])) {
+            fprintf(stderr, "bulk transfer error\n");
+            break;
+        }
+        ctx[i] = ep->BeginDataXfer(dev->buff + len * i, len, &ov[i]);
+        update_wp(dev, len, 0);
+        i = (i + 1) % dev->nbuff;
+    }
+    for (int i = 0; i < dev->nbuff; i++) {
+        ep->FinishDataXfer(dev->buff + len * i, len, &ov[i], ctx[i]);
+        CloseHandle(ov[i].hEvent);
+    }
+    sdr_free(ctx);
+    sdr_free(ov);
+    return 0;
+}
+
+#else // WIN32
+
+// put and get little endian integer of n bytes --------------------------------
+static void put_le(uint8_t *p, uint64_t x, int n)
+{
+    for (int i = 0; i < n; i++) {
+        p[i] = (uint8_t)(x >> (i * 8));
+    }
+}
+
+static uint64_t get_le(const uint8_t *p, int n)
+{
+    uint64_t x = 0;
+    for (int i = 0; i < n; i++) {
+        x |= (uint64_t)p[i] << (i * 8);
+    }
+    return x;
+}
+
+// check frame headers of USB transfer buffer ----------------------------------
+//  The frame header consists of the magic number (4 bytes), the IF data size
+//  (2 bytes), the frame flags (1 byte), reserved (1 byte) and the sample
+//  counter of the first 16-bit sample of the frame (8 bytes) in little endian.
+//  The sample counter is checked for continuity across the frames and resynced
+//  to the frame header on the discontinuity.
+static int check_frm(sdr_dev_t *dev, const uint8_t *buff)
+{
+    int size = dev->size_frm - dev->size_hdr, stat = 1;
+    
+    for (int i = 0; i < dev->size_buff; i += dev->size_frm) {
+        const uint8_t *p = buff + i;
+        if (get_le(p, 4) != FRM_MAGIC || (int)get_le(p + 4, 2) != size) {
+            dev->cnt = -1;
+            stat = 0;
+            continue;
+        }
+        int64_t cnt = (int64_t)get_le(p + 8, 8);
+        if (dev->cnt >= 0 && (cnt != dev->cnt || (p[6] & FRM_FLAG_OVR))) {
+            stat = 0;
+        }
+        dev->cnt = cnt + size / 2;
+    }
+    return stat;
+}
+
+// set frame headers of USB transfers ------------------------------------------
+//  The frame headers are enabled or disabled by the vendor request if the
+//  device F/W supports it (F/W ver.3.2 (FE 4CH) or later). The device returns
+//  the sizes of the frame header and the frame (DMA buffer). The frame headers
+//  are not used for the IF broker and the network IF stream, which carry the
+//  raw data buffer as is.
+static void set_frame(sdr_dev_t *dev)
+{
+    const uint8_t *info = read_info(dev);
+    uint8_t data[4];
+    int ena = dev->frame && !dev->shm && !dev->net;
+    
+    dev->size_frm = dev->size_hdr = 0;
+    dev->size_data = dev->size_buff;
+    dev->cnt = -1;
+    
+    if (!info || (info[0] >> 4) != 3 || (info[0] & 0xF) < 2 ||
+        !sdr_usb_req(dev->usb, 0, SDR_VR_FRAME, (uint16_t)ena, data, 4)) {
+        if (ena) fprintf(stderr, "frame header not supported by device\n");
+        return;
+    }
+    int size_hdr = (data[0] << 8) + data[1];
+    int size_frm = (data[2] << 8) + data[3];
+    
+    if (!ena) return;
+    if (size_hdr <= 0 || size_frm <= size_hdr || size_frm % 2 ||
+        dev->size_buff % size_frm) {
+        fprintf(stderr, "frame header size error hdr=%d frm=%d\n", size_hdr,
+            size_frm);
+        sdr_usb_req(dev->usb, 0, SDR_VR_FRAME, 0, data, 4);
+        return;
+    }
+    dev->size_hdr = size_hdr;
+    dev->size_frm = size_frm;
+    dev->size_data = dev->size_buff / size_frm * (size_frm - size_hdr);
+}
+
+// USB bulk transfer callback --------------------------------------------------
+//  The frame headers in the transfer buffer are checked in place and skipped
+//  by the readers of the raw data buffer without copy.
+static void transfer_cb(struct libusb_transfer *transfer)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)transfer->user_data;
+    
+    int64_t wp = __atomic_load_n(&dev->wp, __ATOMIC_RELAXED);
+    int i = (int)((transfer->buffer - dev->buff) / dev->size_buff);
+    int err = transfer->status != LIBUSB_TRANSFER_COMPLETED ||
+        transfer->actual_length != dev->size_buff;
+    
+    // check sequence of transfer buffers completed and frame headers
+    int seq = i == (int)((wp / dev->size_data) % dev->nbuff);
+    if (!err && dev->size_hdr) {
+        seq &= check_frm(dev, transfer->buffer);
+    }
+    if (!seq) {
+        __atomic_fetch_add(&dev->nseq, 1, __ATOMIC_RELAXED);
+        err = 1;
+    }
+    update_wp(dev, dev->size_data, err);
+    
+    libusb_submit_transfer(transfer);
+}
+
+// USB event handler thread ----------------------------------------------------
+//  The events are handled in the USB context of the device to run a handler
+//  thread per device.
+static void *event_handler(void *arg)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)arg;
+    struct timeval to = {0, 100000};
+    
+    // set thread scheduling real-time and pin thread
+    sdr_set_thread(dev->cpu, dev->pri);
+    
+    while (dev->state) {
+        if (libusb_handle_events_timeout(dev->usb->ctx, &to)) continue;
+    }
+    return NULL;
+}
+
+// IF broker reader thread -----------------------------------------------------
+//  The write pointer of the IF broker is polled and copied to the local one to
+//  notify the reader in the same way as the USB transfers.
+static void *shm_handler(void *arg)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)arg;
+    int64_t stat[3];
+    
+    sdr_set_thread(dev->cpu, dev->pri);
+    
+    while (dev->state) {
+        if (get_shm(dev->shm, stat) && stat[0] > dev->wp) {
+            int64_t unread = stat[0] - __atomic_load_n(&dev->rp,
+                __ATOMIC_ACQUIRE);
+            if (!dev->t0) {
+                __atomic_store_n(&dev->t0, sdr_get_tick_ns(), __ATOMIC_RELAXED);
+            }
+            if (unread > __atomic_load_n(&dev->unread_max, __ATOMIC_RELAXED)) {
+                __atomic_store_n(&dev->unread_max, unread, __ATOMIC_RELAXED);
+            }
+            __atomic_store_n(&dev->ndrop, stat[1], __ATOMIC_RELAXED);
+            __atomic_store_n(&dev->nseq, stat[2], __ATOMIC_RELAXED);
+            __atomic_store_n(&dev->lat.t, sdr_get_tick_us(), __ATOMIC_RELAXED);
+            __atomic_store_n(&dev->wp, stat[0], __ATOMIC_SEQ_CST);
+            notify_reader(dev);
+        }
+        sdr_sleep_msec(SHM_POLL);
+    }
+    return NULL;
+}
+
+// free shared memory segment of IF broker -------------------------------------
+static void free_shm(sdr_dev_t *dev)
+{
+    munmap(dev->shm, dev->size_shm);
+    if (!dev->shm_rd) shm_unlink(dev->shm_name);
+    dev->shm = NULL;
+    dev->size_shm = 0;
+}
+
+// new shared memory segment of IF broker --------------------------------------
+static int new_shm(sdr_dev_t *dev, int nbuff, int size)
+{
+    size_t n = SHM_OFF_BUFF(nbuff) + (size_t)size * nbuff;
+    void *p = MAP_FAILED;
+    int fd;
+    
+    shm_unlink(dev->shm_name); // remove stale segment
+    if ((fd = shm_open(dev->shm_name, O_CREAT | O_EXCL | O_RDWR, 0644)) >= 0) {
+        if (!ftruncate(fd, (off_t)n)) {
+            p = mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+    }
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "IF broker create error: %s\n", dev->shm_name);
+        if (fd >= 0) shm_unlink(dev->shm_name);
+        return 0;
+    }
+    dev->shm = (sdr_shm_t *)p;
+    dev->size_shm = n;
+    dev->shm->nbuff = nbuff;
+    dev->shm->size_buff = size;
+    dev->err = (uint8_t *)p + SHM_OFF_ERR;
+    dev->buff = (uint8_t *)p + SHM_OFF_BUFF(nbuff);
+    return 1;
+}
+
+// write device info to IF broker header ---------------------------------------
+static int put_info(sdr_dev_t *dev)
+{
+    sdr_shm_t *shm = dev->shm;
+    double fo[SDR_MAX_RFCH] = {0};
+    int fmt, IQ[SDR_MAX_RFCH] = {0};
+    
+    if (!(shm->nch = sdr_dev_get_info(dev, &fmt, &shm->fs, fo, IQ))) {
+        return 0;
+    }
+    shm->fmt = fmt;
+    for (int i = 0; i < SDR_MAX_RFCH; i++) {
+        shm->fo[i] = fo[i];
+        shm->IQ[i] = IQ[i];
+    }
+    __atomic_store_n(&shm->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// put and get double as little endian -----------------------------------------
+static void put_d8(uint8_t *p, double x)
+{
+    uint64_t u;
+    memcpy(&u, &x, 8);
+    put_le(p, u, 8);
+}
+
+static double get_d8(const uint8_t *p)
+{
+    uint64_t u = get_le(p, 8);
+    double x;
+    memcpy(&x, &u, 8);
+    return x;
+}
+
+// set header of network IF packet ---------------------------------------------
+static void set_head(uint8_t *p, int size, int fmt, int flag, uint64_t seq)
+{
+    put_le(p, NET_MAGIC, 4);
+    put_le(p + 4, (uint64_t)size, 2);
+    p[6] = (uint8_t)fmt;
+    p[7] = (uint8_t)flag;
+    put_le(p + 8, seq, 8);
+}
+
+// set socket options ----------------------------------------------------------
+static void set_sockopt(int sock, int rcv)
+{
+    struct timeval to = {0, NET_TO_SOCK * 1000};
+    int size = NET_SIZE_SOCK;
+    
+    setsockopt(sock, SOL_SOCKET, rcv ? SO_RCVBUF : SO_SNDBUF,
+        (const char *)&size, sizeof(size));
+    setsockopt(sock, SOL_SOCKET, rcv ? SO_RCVTIMEO : SO_SNDTIMEO,
+        (const char *)&to, sizeof(to));
+}
+
+// free network IF stream ------------------------------------------------------
+static void free_net(sdr_net_t *net)
+{
+    if (net->sock >= 0) close(net->sock);
+    if (net->sock_lsn >= 0) close(net->sock_lsn);
+    sdr_free(net->pkt);
+    sdr_free(net);
+}
+
+// open network IF stream ------------------------------------------------------
+//  The address is "udp://host:port" or "tcp://host:port". The UDP sender sends
+//  the packets to the host (unicast or multicast) and the UDP reader receives
+//  them at the port (host: "" or multicast group). The TCP sender listens at
+//  the port (host: "") for a reader connecting to the host.
+static sdr_net_t *open_net(const char *addr, int rd)
+{
+    struct sockaddr_in sa = {0};
+    struct addrinfo hints = {0}, *ai = NULL;
+    char host[256] = "";
+    int port = 0, tcp = !strncmp(addr, "tcp://", 6), on = 1, stat = 0;
+    
+    if (tcp || !strncmp(addr, "udp://", 6)) {
+        if (addr[6] == ':') sscanf(addr + 7, "%d", &port);
+        else if (sscanf(addr + 6, "%255[^:]:%d", host, &port) < 2) port = 0;
+    }
+    // host required by TCP reader and UDP sender, none for TCP sender
+    if (port <= 0 || port > 65535 || (tcp == rd && !*host) ||
+        (tcp && !rd && *host)) {
+        fprintf(stderr, "network IF stream address error: %s\n", addr);
+        return NULL;
+    }
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons((uint16_t)port);
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    hints.ai_family = AF_INET;
+    if (*host) {
+        if (getaddrinfo(host, NULL, &hints, &ai) || !ai) {
+            fprintf(stderr, "network IF stream host error: %s\n", addr);
+            return NULL;
+        }
+        sa.sin_addr = ((struct sockaddr_in *)ai->ai_addr)->sin_addr;
+        freeaddrinfo(ai);
+    }
+    sdr_net_t *net = (sdr_net_t *)sdr_malloc(sizeof(sdr_net_t));
+    net->tcp = tcp;
+    net->sock = net->sock_lsn = -1;
+    net->pkt = (uint8_t *)sdr_malloc(NET_BATCH * NET_PKT);
+    
+    if (tcp && !rd) { // TCP sender listening for reader
+        if ((net->sock_lsn = socket(AF_INET, SOCK_STREAM, 0)) >= 0) {
+            setsockopt(net->sock_lsn, SOL_SOCKET, SO_REUSEADDR,
+                (const char *)&on, sizeof(on));
+            stat = !bind(net->sock_lsn, (struct sockaddr *)&sa, sizeof(sa)) &&
+                !listen(net->sock_lsn, 1);
+        }
+    }
+    else if (tcp) { // TCP reader connecting to sender
+        if ((net->sock = socket(AF_INET, SOCK_STREAM, 0)) >= 0) {
+            set_sockopt(net->sock, 1);
+            stat = !connect(net->sock, (struct sockaddr *)&sa, sizeof(sa));
+        }
+    }
+    else if (!rd) { // UDP sender connected to destination
+        if ((net->sock = socket(AF_INET, SOCK_DGRAM, 0)) >= 0) {
+            set_sockopt(net->sock, 0);
+            stat = !connect(net->sock, (struct sockaddr *)&sa, sizeof(sa));
+        }
+    }
+    else if ((net->sock = socket(AF_INET, SOCK_DGRAM, 0)) >= 0) { // UDP reader
+        struct ip_mreq mreq;
+        mreq.imr_multiaddr = sa.sin_addr;
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        sa.sin_addr.s_addr = htonl(INADDR_ANY);
+        set_sockopt(net->sock, 1);
+        setsockopt(net->sock, SOL_SOCKET, SO_REUSEADDR, (const char *)&on,
+            sizeof(on));
+        stat = !bind(net->sock, (struct sockaddr *)&sa, sizeof(sa));
+        
+        // join multicast group of host
+        if (stat && *host) {
+            stat = IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr)) &&
+                !setsockopt(net->sock, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                (const char *)&mreq, sizeof(mreq));
+        }
+    }
+    if (!stat) {
+        fprintf(stderr, "network IF stream open error: %s\n", addr);
+        free_net(net);
+        return NULL;
+    }
+    return net;
+}
+
+// close connection of TCP sender to reader ------------------------------------
+static void close_reader(sdr_net_t *net)
+{
+    if (!net->tcp || net->sock < 0) return;
+    close(net->sock);
+    net->sock = -1;
+}
+
+// accept connection of reader to TCP sender -----------------------------------
+static int accept_reader(sdr_net_t *net)
+{
+    struct pollfd pfd = {net->sock_lsn, POLLIN, 0};
+    
+    if (!net->tcp || net->sock >= 0) return 1;
+    if (poll(&pfd, 1, 0) <= 0 ||
+        (net->sock = accept(net->sock_lsn, NULL, NULL)) < 0) {
+        return 0;
+    }
+    set_sockopt(net->sock, 0);
+    net->tick = sdr_get_tick() - NET_INFO_CYC; // send device info first
+    return 1;
+}
+
+// send network IF packets -----------------------------------------------------
+//  The packets of the header and the payload in the raw data buffer are sent
+//  without copy by a system call for UDP (sendmmsg) or TCP (sendmsg). The
+//  connection of TCP is closed on a partial send since the framing is lost.
+static int send_pkts(sdr_net_t *net, struct iovec *iov, int n)
+{
+    if (net->tcp) {
+        struct msghdr msg = {0};
+        ssize_t size = 0;
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n * 2;
+        for (int i = 0; i < n * 2; i++) {
+            size += (ssize_t)iov[i].iov_len;
+        }
+        if (sendmsg(net->sock, &msg, MSG_NOSIGNAL) != size) {
+            close_reader(net);
+            return 0;
+        }
+        return 1;
+    }
+#ifdef __linux__
+    struct mmsghdr msgs[NET_BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < n; i++) {
+        msgs[i].msg_hdr.msg_iov = iov + i * 2;
+        msgs[i].msg_hdr.msg_iovlen = 2;
+    }
+    for (int i = 0; i < n; ) {
+        int m = sendmmsg(net->sock, msgs + i, n - i, 0);
+        if (m <= 0) return 0; // no reader or buffer full
+        i += m;
+    }
+#else
+    for (int i = 0; i < n; i++) {
+        struct msghdr msg = {0};
+        msg.msg_iov = iov + i * 2;
+        msg.msg_iovlen = 2;
+        if (sendmsg(net->sock, &msg, 0) < 0) return 0;
+    }
+#endif
+    return 1;
+}
+
+// send device info packet -----------------------------------------------------
+static void send_info(sdr_net_t *net)
+{
+    uint8_t buff[NET_HEAD + 2 + SDR_MAX_RFCH * 9 + 8] = {0}, *p;
+    struct iovec iov[2];
+    
+    set_head(buff, sizeof(buff) - NET_HEAD, net->fmt, NET_FLAG_INFO, net->seq);
+    p = buff + NET_HEAD;
+    p[0] = (uint8_t)net->fmt;
+    p[1] = (uint8_t)net->nch;
+    put_d8(p + 2, net->fs);
+    for (int i = 0; i < SDR_MAX_RFCH; i++) {
+        put_d8(p + 10 + i * 8, net->fo[i]);
+        p[10 + SDR_MAX_RFCH * 8 + i] = (uint8_t)net->IQ[i];
+    }
+    iov[0].iov_base = buff;
+    iov[0].iov_len = NET_HEAD;
+    iov[1].iov_base = buff + NET_HEAD;
+    iov[1].iov_len = sizeof(buff) - NET_HEAD;
+    send_pkts(net, iov, 1);
+    net->tick = sdr_get_tick();
+}
+
+// network IF sender thread ----------------------------------------------------
+//  The raw data buffer is read by the own read pointer of the sender and sent
+//  in batch of up to NET_BATCH packets. On overrun of unread data by a slow
+//  network or reader, the unread data are skipped and the sequence number is
+//  advanced by the skipped packets to be detected as a gap by the readers.
+static void *net_sender(void *arg)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)arg;
+    sdr_net_t *net = dev->net;
+    uint8_t head[NET_BATCH][NET_HEAD];
+    struct iovec iov[NET_BATCH * 2];
+    
+    while (dev->state) {
+        int64_t wp = __atomic_load_n(&dev->wp, __ATOMIC_ACQUIRE);
+        
+        if (!accept_reader(net)) { // no reader connected to TCP sender
+            net->seq += (wp - net->rp) / NET_PAYLOAD;
+            net->rp = wp;
+            sdr_sleep_msec(NET_TO_SOCK);
+            continue;
+        }
+        if ((int)(sdr_get_tick() - net->tick) >= NET_INFO_CYC) {
+            send_info(net);
+        }
+        if (wp - net->rp > MAX_UNREAD(dev)) { // overrun of unread data
+            net->seq += (wp - net->rp) / NET_PAYLOAD;
+            net->rp = wp;
+        }
+        if (wp <= net->rp) {
+            sdr_sleep_msec(NET_POLL);
+            continue;
+        }
+        int n = (int)MIN((wp - net->rp) / NET_PAYLOAD, (int64_t)NET_BATCH);
+        
+        for (int i = 0; i < n; i++) {
+            int64_t p = net->rp + (int64_t)i * NET_PAYLOAD;
+            int err = dev->err[(p / dev->size_data) % dev->nbuff];
+            set_head(head[i], NET_PAYLOAD, net->fmt, err ? NET_FLAG_ERR : 0,
+                net->seq + i);
+            iov[i*2  ].iov_base = head[i];
+            iov[i*2  ].iov_len = NET_HEAD;
+            iov[i*2+1].iov_base = dev->buff + p % BUFF_SIZE(dev);
+            iov[i*2+1].iov_len = NET_PAYLOAD;
+        }
+        send_pkts(net, iov, n);
+        net->rp += (int64_t)n * NET_PAYLOAD;
+        net->seq += n;
+    }
+    close_reader(net);
+    return NULL;
+}
+
+// receive network IF packets --------------------------------------------------
+//  The UDP packets are received in batch by a system call (recvmmsg). The TCP
+//  packets are received one by one by the header and the payload.
+static int recv_pkts(sdr_net_t *net, int *len)
+{
+    if (net->tcp) {
+        int n = 0, size = NET_HEAD, nto = 0;
+        while (n < size) {
+            ssize_t m = recv(net->sock, (char *)net->pkt + n, size - n, 0);
+            if (m < 0 && errno == EAGAIN) { // timeout
+                if (n == 0) return 0;
+                if (++nto < NET_TO / NET_TO_SOCK) continue;
+            }
+            if (m <= 0) return -1; // disconnected or stalled
+            n += (int)m;
+            if (n == NET_HEAD) { // payload size by header
+                size += MIN((int)get_le(net->pkt + 4, 2), NET_PKT - NET_HEAD);
+            }
+        }
+        len[0] = n;
+        return 1;
+    }
+#ifdef __linux__
+    struct mmsghdr msgs[NET_BATCH];
+    struct iovec iov[NET_BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < NET_BATCH; i++) {
+        iov[i].iov_base = net->pkt + i * NET_PKT;
+        iov[i].iov_len = NET_PKT;
+        msgs[i].msg_hdr.msg_iov = iov + i;
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+    int n = recvmmsg(net->sock, msgs, NET_BATCH, MSG_WAITFORONE, NULL);
+    for (int i = 0; i < n; i++) {
+        len[i] = (int)msgs[i].msg_len;
+    }
+#else
+    int n = 0;
+    for ( ; n < NET_BATCH; n++) {
+        ssize_t m = recv(net->sock, (char *)net->pkt + n * NET_PKT, NET_PKT,
+            n > 0 ? MSG_DONTWAIT : 0);
+        if (m < 0) break;
+        len[n] = (int)m;
+    }
+#endif
+    return MAX(n, 0);
+}
+
+// read device info packet -----------------------------------------------------
+static int get_info_pkt(sdr_net_t *net, const uint8_t *pkt, int len)
+{
+    const uint8_t *p = pkt + NET_HEAD;
+    
+    if (len < NET_HEAD + 2 + SDR_MAX_RFCH * 9 + 8) return 0;
+    net->fmt = p[0];
+    net->nch = MIN((int)p[1], SDR_MAX_RFCH);
+    net->fs = get_d8(p + 2);
+    for (int i = 0; i < SDR_MAX_RFCH; i++) {
+        net->fo[i] = get_d8(p + 10 + i * 8);
+        net->IQ[i] = p[10 + SDR_MAX_RFCH * 8 + i];
+    }
+    return net->nch > 0;
+}
+
+// write network IF packet to raw data buffer (reader) -------------------------
+//  The payload is written to the position of the raw data buffer by the
+//  sequence number. The transfer buffers of the lost packets are marked as
+//  errors to be detected as gaps by the receiver. The late or duplicated
+//  packets are discarded and counted as out-of-sequence transfers. The stream
+//  is resynced on a large jump of the sequence number by a restarted sender.
+static void put_pkt(sdr_dev_t *dev, const uint8_t *pkt, int len)
+{
+    sdr_net_t *net = dev->net;
+    
+    if (len < NET_HEAD || get_le(pkt, 4) != NET_MAGIC ||
+        (pkt[7] & NET_FLAG_INFO) || get_le(pkt + 4, 2) != NET_PAYLOAD ||
+        len != NET_PKT) {
+        return;
+    }
+    uint64_t seq = get_le(pkt + 8, 8);
+    if (!net->sync) {
+        net->base = seq - (uint64_t)(net->pos / NET_PAYLOAD);
+        net->sync = 1;
+    }
+    int64_t pos = (int64_t)(seq - net->base) * NET_PAYLOAD;
+    
+    if (pos < net->pos && net->pos - pos <= BUFF_SIZE(dev)) {
+        __atomic_fetch_add(&dev->nseq, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    if (pos < net->pos || pos - net->pos > BUFF_SIZE(dev) * 4) { // resync
+        net->base = seq - (uint64_t)(net->pos / NET_PAYLOAD);
+        pos = net->pos;
+        net->err = 1;
+    }
+    while (net->pos < pos) { // lost packets
+        net->pos += MIN(pos - net->pos,
+            (int64_t)(dev->size_buff - net->pos % dev->size_buff));
+        net->err = 1;
+        if (net->pos % dev->size_buff == 0) {
+            update_wp(dev, dev->size_buff, 1);
+        }
+    }
+    memcpy(dev->buff + net->pos % BUFF_SIZE(dev), pkt + NET_HEAD,
+        NET_PAYLOAD);
+    net->pos += NET_PAYLOAD;
+    net->err |= pkt[7] & NET_FLAG_ERR;
+    if (net->pos % dev->size_buff == 0) {
+        update_wp(dev, dev->size_buff, net->err);
+        net->err = 0;
+    }
+}
+
+// network IF reader thread ----------------------------------------------------
+//  The packets received are written to the raw data buffer and the write
+//  pointer is updated by the transfer buffers as the USB transfers.
+static void *net_receiver(void *arg)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)arg;
+    int len[NET_BATCH];
+    
+    sdr_set_thread(dev->cpu, dev->pri);
+    
+    while (dev->state) {
+        int n = recv_pkts(dev->net, len);
+        if (n < 0) { // TCP sender disconnected or stalled
+            sdr_sleep_msec(NET_TO_SOCK);
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            put_pkt(dev, dev->net->pkt + i * NET_PKT, len[i]);
+        }
+    }
+    return NULL;
+}
+
+// wait for device info packet of network IF stream ----------------------------
+static int wait_info(sdr_net_t *net)
+{
+    int len[NET_BATCH];
+    uint32_t tick = sdr_get_tick();
+    
+    while ((int)(sdr_get_tick() - tick) < NET_TO) {
+        int n = recv_pkts(net, len);
+        for (int i = 0; i < n; i++) {
+            const uint8_t *pkt = net->pkt + i * NET_PKT;
+            if (len[i] >= NET_HEAD && get_le(pkt, 4) == NET_MAGIC &&
+                (pkt[7] & NET_FLAG_INFO) && get_info_pkt(net, pkt, len[i])) {
+                return 1;
+            }
+        }
+        if (n < 0) break;
+    }
+    return 0;
+}
+
+#endif // WIN32
+
+// free USB transfer buffers ---------------------------------------------------
+static void free_buff(sdr_dev_t *dev)
+{
+#ifndef WIN32
+    for (int i = 0; dev->transfer && i < dev->nbuff; i++) {
+        libusb_free_transfer(dev->transfer[i]);
+    }
+    sdr_free(dev->transfer);
+    dev->transfer = NULL;
+    if (dev->shm) {
+        free_shm(dev);
+        dev->buff = dev->err = NULL;
+    }
+#if LIBUSB_API_VERSION >= 0x01000105
+    if (dev->dma) {
+        libusb_dev_mem_free(dev->usb->h, dev->buff,
+            (size_t)dev->size_buff * dev->nbuff);
+        dev->buff = NULL;
+    }
+#endif
+#endif
+    sdr_mem_free(dev->buff);
+    sdr_free(dev->err);
+    dev->buff = dev->err = NULL;
+    dev->nbuff = dev->size_buff = dev->size_data = dev->dma = 0;
+}
+
+// new USB transfer buffers ----------------------------------------------------
+//  The raw data buffer is allocated in the USB device memory for zero-copy DMA
+//  if supported by libusb and the OS (Linux usbfs). Otherwise it falls back to
+//  the large memory by sdr_mem_alloc(). The raw data buffer of the IF broker is
+//  allocated in the shared memory segment.
+static int new_buff(sdr_dev_t *dev, int nbuff, int size)
+{
+#ifndef WIN32
+    if (*dev->shm_name && !new_shm(dev, nbuff, size)) {
+        return 0;
+    }
+#endif
+#if !defined(WIN32) && LIBUSB_API_VERSION >= 0x01000105
+    if (!dev->shm && dev->usb) {
+        dev->buff = libusb_dev_mem_alloc(dev->usb->h, (size_t)size * nbuff);
+        dev->dma = dev->buff != NULL;
+    }
+#endif
+    if (!dev->buff) {
+        dev->buff = (uint8_t *)sdr_mem_alloc((size_t)size * nbuff, -1);
+    }
+    if (!dev->err) {
+        dev->err = (uint8_t *)sdr_malloc(nbuff);
+    }
+    dev->nbuff = nbuff;
+    dev->size_buff = dev->size_data = size;
+#ifndef WIN32
+    if (!dev->usb) return 1; // network IF stream reader
+    dev->transfer = (struct libusb_transfer **)sdr_malloc(
+        sizeof(struct libusb_transfer *) * nbuff);
+    for (int i = 0; i < nbuff; i++) {
+        if (!(dev->transfer[i] = libusb_alloc_transfer(0))) {
+            fprintf(stderr, "libusb_alloc_transfer(%d) error\n", i);
+            free_buff(dev);
+            return 0;
+        }
+    }
+#endif
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Open a SDR device.
+//
+//  args:
+//      bus         (I)   USB bus number of SDR device  (-1:any)
+//      port        (I)   USB port number of SDR device (-1:any)
+//
+//  return
+//      SDR device pointer (NULL: error)
+//
+sdr_dev_t *sdr_dev_open(int bus, int port)
+{
+    sdr_dev_t *dev = (sdr_dev_t *)sdr_malloc(sizeof(sdr_dev_t));
+    uint16_t vid[] = {SDR_DEV_VID, SDR_DEV_VID};
+    uint16_t pid[] = {SDR_DEV_PID1, SDR_DEV_PID2};
+    
+    if (!(dev->usb = sdr_usb_open(bus, port, vid, pid, 2))) {
+        fprintf(stderr, "No device found. BUS=%d PORT=%d VID=%04X PID=%04X,%04X\n",
+            bus, port, SDR_DEV_VID, SDR_DEV_PID1, SDR_DEV_PID2);
+        sdr_free(dev);
+        return NULL;
+    }
+    if (!new_buff(dev, SDR_MAX_BUFF, SDR_SIZE_BUFF)) {
+        sdr_usb_close(dev->usb);
+        sdr_free(dev);
+        return NULL;
+    }
+    dev->cpu = -1;
+    dev->pri = PRI_USB;
+    pthread_mutex_init(&dev->mtx, NULL);
+    pthread_cond_init(&dev->cond, NULL);
+    return dev;
+}
+
+//------------------------------------------------------------------------------
+//  Close SDR device.
+//
+//  args:
+//      dev         (I)   SDR device
+//
+//  return
+//      none
+//
+void sdr_dev_close(sdr_dev_t *dev)
+{
+    free_buff(dev);
+#ifndef WIN32
+    if (dev->net) free_net(dev->net);
+#endif
+    if (dev->usb) sdr_usb_close(dev->usb);
+    sdr_free(dev);
+}
+
+//------------------------------------------------------------------------------
+//  Set the number and the size of USB transfer buffers of the SDR device. The
+//  raw data buffer is reallocated as the ring of the USB transfer buffers. It
+//  should be called before sdr_dev_start(). The defaults are SDR_MAX_BUFF
+//  buffers of SDR_SIZE_BUFF bytes.
+//
+//  args:
+//      dev         (I)   SDR device
+//      nbuff       (I)   number of USB transfer buffers (>= 4)
+//      size        (I)   size of USB transfer buffer (bytes) (aligned to 1024)
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_set_buff(sdr_dev_t *dev, int nbuff, int size)
+{
+    if (dev->state || dev->shm_rd || nbuff < MIN_BUFF || size < ALIGN_BUFF ||
+        size % ALIGN_BUFF || (int64_t)size * nbuff > INT32_MAX) {
+        fprintf(stderr, "USB transfer buffer size error nbuff=%d size=%d\n",
+            nbuff, size);
+        return 0;
+    }
+    if (nbuff == dev->nbuff && size == dev->size_buff) return 1;
+    free_buff(dev);
+    if (!new_buff(dev, nbuff, size)) return 0;
+#ifndef WIN32
+    if (dev->shm) return put_info(dev);
+#endif
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Request the frame headers of the USB transfers of the SDR device. Each DMA
+//  buffer of the device is sent as a frame with the frame header of the sample
+//  counter to detect the lost IF data by the discontinuity of the counter. The
+//  discontinuity is counted as an out-of-sequence transfer and the transfer is
+//  flagged as error. The frame headers are skipped in the raw data buffer by
+//  sdr_dev_read() and sdr_dev_peek() without copy. It should be called before
+//  sdr_dev_start(). The frame headers are enabled by sdr_dev_start() only if
+//  the device F/W supports them and the size of the USB transfer buffers is a
+//  multiple of the frame size.
+//
+//  args:
+//      dev         (I)   SDR device
+//      ena         (I)   frame headers (0: disable, 1: enable)
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_set_frame(sdr_dev_t *dev, int ena)
+{
+    if (dev->state || !dev->usb) return 0;
+    dev->frame = ena;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Share the raw data buffer of the SDR device as a shared memory IF broker.
+//  The raw data buffer is reallocated in the POSIX shared memory segment of
+//  the name to be attached by sdr_dev_attach() in other processes without
+//  copy. It should be called before sdr_dev_start(). The segment is removed by
+//  sdr_dev_close().
+//
+//  args:
+//      dev         (I)   SDR device
+//      name        (I)   name of shared memory segment (e.g. "/pocket_sdr")
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_share(sdr_dev_t *dev, const char *name)
 {
-    sdr_dev_t *dev = (sdr_dev_t *)arg;
-    CCyBulkEndPoint *ep;
-    uint8_t *ctx[SDR_MAX_BUFF] = {0};
-    OVERLAPPED ov[SDR_MAX_BUFF] = {{0,0,0,0,0}};
-    long len = SDR_SIZE_BUFF;
-    
-    // rise process/thread priority
-    rise_pri();
+#ifdef WIN32
+    fprintf(stderr, "IF broker not supported: %s\n", name);
+    return 0;
+#else
+    int nbuff = dev->nbuff, size = dev->size_buff;
     
-    if (!(ep = get_bulk_ep(dev->usb, SDR_DEV_EP))) {
-        fprintf(stderr, "bulk endpoint get error ep=0x%02X\n", SDR_DEV_EP);
+    if (dev->state || dev->shm || !*name ||
+        strlen(name) + 2 > sizeof(dev->shm_name)) {
+        fprintf(stderr, "IF broker share error: %s\n", name);
         return 0;
     }
-    ep->SetXferSize(SDR_SIZE_BUFF);
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
-        ov[i].hEvent = CreateEvent(NULL, false, false, NULL);
-        ctx[i] = ep->BeginDataXfer(dev->buff + len * i, len, &ov[i]); 
-    }
-    for (int i = 0; dev->state; ) {
-        if (!ep->WaitForXfer(&ov[i], TO_TRANSFER)) {
-            fprintf(stderr, "bulk transfer timeout\n");
-            continue;
-        }
-        if (!ep->FinishDataXfer(dev->buff + len * i, len, &ov[i], ctx[i])) {
-            fprintf(stderr, "bulk transfer error\n");
-            break;
-        }
-        ctx[i] = ep->BeginDataXfer(dev->buff + len * i, len, &ov[i]);
-        pthread_mutex_lock(&dev->mtx);
-        dev->wp += len;
-        pthread_mutex_unlock(&dev->mtx);
-        i = (i + 1) % SDR_MAX_BUFF;
-    }
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
-        ep->FinishDataXfer(dev->buff + len * i, len, &ov[i], ctx[i]);
-        CloseHandle(ov[i].hEvent);
+    snprintf(dev->shm_name, sizeof(dev->shm_name), "%s%s",
+        *name == '/' ? "" : "/", name);
+    free_buff(dev);
+    if (!new_buff(dev, nbuff, size)) {
+        *dev->shm_name = '\0';
+        new_buff(dev, nbuff, size);
+        return 0;
     }
-    return 0;
+    return put_info(dev);
+#endif
 }
 
-#else // WIN32
-
-// USB bulk transfer callback --------------------------------------------------
-static void transfer_cb(struct libusb_transfer *transfer)
+//------------------------------------------------------------------------------
+//  Attach to a shared memory IF broker of a SDR device shared by
+//  sdr_dev_share() in another process. The raw data buffer of the device is
+//  mapped read-only and read by the APIs of the SDR device without copy as the
+//  USB device. The reader has its own read pointer and detects the overrun of
+//  unread data independently of the other readers. The gain and the register
+//  settings are not accessible by the reader.
+//
+//  args:
+//      name        (I)   name of shared memory segment
+//
+//  return
+//      SDR device pointer (NULL: error)
+//
+sdr_dev_t *sdr_dev_attach(const char *name)
 {
-    sdr_dev_t *dev = (sdr_dev_t *)transfer->user_data;
+#ifdef WIN32
+    fprintf(stderr, "IF broker not supported: %s\n", name);
+    return NULL;
+#else
+    sdr_dev_t *dev = (sdr_dev_t *)sdr_malloc(sizeof(sdr_dev_t));
+    struct stat st;
+    void *p = MAP_FAILED;
+    int fd;
     
-    if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
-        fprintf(stderr, "libusb bulk transfer error (%d)\n", transfer->status);
+    snprintf(dev->shm_name, sizeof(dev->shm_name), "%s%s",
+        *name == '/' ? "" : "/", name);
+    if ((fd = shm_open(dev->shm_name, O_RDONLY, 0)) >= 0) {
+        if (!fstat(fd, &st) && (size_t)st.st_size >= SHM_OFF_ERR) {
+            p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
     }
-    pthread_mutex_lock(&dev->mtx);
-    dev->wp += SDR_SIZE_BUFF;
-    pthread_mutex_unlock(&dev->mtx);
-    
-    libusb_submit_transfer(transfer);
+    if (p == MAP_FAILED) {
+        fprintf(stderr, "IF broker open error: %s\n", dev->shm_name);
+        sdr_free(dev);
+        return NULL;
+    }
+    sdr_shm_t *shm = (sdr_shm_t *)p;
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+        (size_t)st.st_size != SHM_OFF_BUFF(shm->nbuff) +
+        (size_t)shm->size_buff * shm->nbuff) {
+        fprintf(stderr, "IF broker format error: %s\n", dev->shm_name);
+        munmap(p, (size_t)st.st_size);
+        sdr_free(dev);
+        return NULL;
+    }
+    dev->shm = shm;
+    dev->size_shm = (size_t)st.st_size;
+    dev->shm_rd = 1;
+    dev->nbuff = shm->nbuff;
+    dev->size_buff = dev->size_data = shm->size_buff;
+    dev->err = (uint8_t *)p + SHM_OFF_ERR;
+    dev->buff = (uint8_t *)p + SHM_OFF_BUFF(shm->nbuff);
+    dev->cpu = -1;
+    pthread_mutex_init(&dev->mtx, NULL);
+    pthread_cond_init(&dev->cond, NULL);
+    return dev;
+#endif
 }
 
-// USB event handler thread ----------------------------------------------------
-static void *event_handler(void *arg)
+//------------------------------------------------------------------------------
+//  Stream the IF data of the SDR device to the network. The IF data received
+//  from the device are sent by the network IF sender thread to the readers
+//  connecting by sdr_dev_connect() in the packets with the sequence numbers.
+//  It should be called before sdr_dev_start(). The stream is closed by
+//  sdr_dev_close().
+//
+//  args:
+//      dev         (I)   SDR device
+//      addr        (I)   address of network IF stream
+//                          "udp://host:port": send UDP packets to the host
+//                                             (unicast or multicast)
+//                          "tcp://:port"    : listen at the port for a reader
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_stream(sdr_dev_t *dev, const char *addr)
 {
-    sdr_dev_t *dev = (sdr_dev_t *)arg;
-    struct sched_param param = {99};
-    struct timeval to = {0, 100000};
+#ifdef WIN32
+    fprintf(stderr, "network IF stream not supported: %s\n", addr);
+    return 0;
+#else
+    sdr_net_t *net;
     
-    // set thread scheduling real-time
-    if (pthread_setschedparam(dev->thread, SCHED_RR, &param)) {
-        fprintf(stderr, "set thread scheduling error\n");
+    if (dev->state || dev->net || dev->shm_rd || !dev->usb) {
+        fprintf(stderr, "network IF stream error: %s\n", addr);
+        return 0;
     }
-    while (dev->state) {
-        if (libusb_handle_events_timeout(NULL, &to)) continue;
+    if (!(net = open_net(addr, 0))) {
+        return 0;
     }
-    return NULL;
+    if (!(net->nch = sdr_dev_get_info(dev, &net->fmt, &net->fs, net->fo,
+            net->IQ))) {
+        free_net(net);
+        return 0;
+    }
+    dev->net = net;
+    return 1;
+#endif
 }
 
-#endif // WIN32
-
 //------------------------------------------------------------------------------
-//  Open a SDR device.
+//  Connect to a network IF stream of a SDR device streamed by sdr_dev_stream()
+//  in another process or host. The device info is obtained by the device info
+//  packet of the stream. The packets received are written to the raw data
+//  buffer of the device by the network IF reader thread and read by the APIs
+//  of the SDR device as the USB device. The lost packets are detected by the
+//  sequence numbers and the transfer buffers of them are marked as errors. The
+//  gain and the register settings are not accessible by the reader.
 //
 //  args:
-//      bus         (I)   USB bus number of SDR device  (-1:any)
-//      port        (I)   USB port number of SDR device (-1:any)
+//      addr        (I)   address of network IF stream
+//                          "udp://:port"    : receive UDP packets at the port
+//                          "udp://host:port": receive UDP packets of the
+//                                             multicast group at the port
+//                          "tcp://host:port": connect to the TCP sender
 //
 //  return
 //      SDR device pointer (NULL: error)
 //
-sdr_dev_t *sdr_dev_open(int bus, int port)
+sdr_dev_t *sdr_dev_connect(const char *addr)
 {
-    sdr_dev_t *dev = (sdr_dev_t *)sdr_malloc(sizeof(sdr_dev_t));
-    uint16_t vid[] = {SDR_DEV_VID, SDR_DEV_VID};
-    uint16_t pid[] = {SDR_DEV_PID1, SDR_DEV_PID2};
+#ifdef WIN32
+    fprintf(stderr, "network IF stream not supported: %s\n", addr);
+    return NULL;
+#else
+    sdr_net_t *net;
     
-    if (!(dev->usb = sdr_usb_open(bus, port, vid, pid, 2))) {
-        fprintf(stderr, "No device found. BUS=%d PORT=%d VID=%04X PID=%04X,%04X\n",
-            bus, port, SDR_DEV_VID, SDR_DEV_PID1, SDR_DEV_PID2);
-        sdr_free(dev);
+    if (!(net = open_net(addr, 1))) {
         return NULL;
     }
-    dev->buff = (uint8_t *)sdr_malloc(BUFF_SIZE);
-    
-#ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
-        if (!(dev->transfer[i] = libusb_alloc_transfer(0))) {
-            fprintf(stderr, "libusb_alloc_transfer(%d) error\n", i);
-            sdr_usb_close(dev->usb);
-            sdr_free(dev);
-            return NULL;
-        }
+    if (!wait_info(net)) {
+        fprintf(stderr, "network IF stream no device info: %s\n", addr);
+        free_net(net);
+        return NULL;
     }
-#endif
+    sdr_dev_t *dev = (sdr_dev_t *)sdr_malloc(sizeof(sdr_dev_t));
+    dev->net = net;
+    dev->net_rd = 1;
+    new_buff(dev, SDR_MAX_BUFF, SDR_SIZE_BUFF);
+    dev->cpu = -1;
     pthread_mutex_init(&dev->mtx, NULL);
+    pthread_cond_init(&dev->cond, NULL);
     return dev;
+#endif
 }
 
 //------------------------------------------------------------------------------
-//  Close SDR device.
+//  Set the CPU affinity and the real-time priority of the USB event handler
+//  thread of the SDR device. It should be called before sdr_dev_start(). The
+//  defaults are not pinned and priority 99.
 //
 //  args:
 //      dev         (I)   SDR device
+//      cpu         (I)   CPU core to pin the thread (-1: not pinned)
+//      pri         (I)   real-time priority (1-99) (0: not changed)
 //
 //  return
 //      none
 //
-void sdr_dev_close(sdr_dev_t *dev)
+void sdr_dev_set_thread(sdr_dev_t *dev, int cpu, int pri)
 {
-    sdr_usb_close(dev->usb);
-#ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
-        libusb_free_transfer(dev->transfer[i]);
-    }
-#endif
-    sdr_free(dev->buff);
-    sdr_free(dev);
+    dev->cpu = cpu;
+    dev->pri = pri;
 }
 
 //------------------------------------------------------------------------------
@@ -293,10 +1484,31 @@ int sdr_dev_start(sdr_dev_t *dev)
     if (dev->state) return 0;
     
 #ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
+    if (dev->shm_rd) { // IF broker reader from the latest data
+        int64_t stat[3];
+        while (!get_shm(dev->shm, stat)) {
+            sdr_sleep_msec(SHM_POLL);
+        }
+        dev->state = 1;
+        dev->rp = dev->wp = stat[0];
+        dev->ndrop = dev->nseq = dev->nskip = dev->unread_max = dev->t0 = 0;
+        pthread_create(&dev->thread, NULL, shm_handler, dev);
+        return 1;
+    }
+    if (dev->net_rd) { // network IF stream reader from the next packet
+        dev->state = 1;
+        dev->rp = dev->wp = dev->ndrop = dev->nseq = dev->nskip = 0;
+        dev->unread_max = dev->t0 = 0;
+        dev->net->pos = dev->net->sync = dev->net->err = 0;
+        pthread_create(&dev->thread, NULL, net_receiver, dev);
+        return 1;
+    }
+    set_frame(dev);
+    
+    for (int i = 0; i < dev->nbuff; i++) {
         int ret;
         libusb_fill_bulk_transfer(dev->transfer[i], dev->usb->h, SDR_DEV_EP,
-            dev->buff + SDR_SIZE_BUFF * i, SDR_SIZE_BUFF, transfer_cb, dev,
+            dev->buff + dev->size_buff * i, dev->size_buff, transfer_cb, dev,
             TO_TRANSFER);
         if ((ret = libusb_submit_transfer(dev->transfer[i]))) {
             fprintf(stderr, "libusb_submit_transfer(%d) error (%d)\n", i, ret);
@@ -307,8 +1519,23 @@ int sdr_dev_start(sdr_dev_t *dev)
     sdr_usb_req(dev->usb, 0, SDR_VR_START, 0, NULL, 0);
     
     dev->state = 1;
-    dev->rp = dev->wp = 0;
+    dev->rp = dev->wp = dev->ndrop = dev->nseq = dev->nskip = 0;
+    dev->unread_max = dev->t0 = 0;
+#ifndef WIN32
+    if (dev->shm) {
+        put_shm(dev, 0);
+        __atomic_store_n(&dev->shm->state, 1, __ATOMIC_RELEASE);
+    }
+#endif
     pthread_create(&dev->thread, NULL, event_handler, dev);
+#ifndef WIN32
+    if (dev->net) {
+        dev->net->rp = 0;
+        dev->net->seq = 0;
+        dev->net->tick = sdr_get_tick() - NET_INFO_CYC;
+        pthread_create(&dev->net->thread, NULL, net_sender, dev);
+    }
+#endif
     return 1;
 }
 
@@ -327,11 +1554,22 @@ int sdr_dev_stop(sdr_dev_t *dev)
     
     dev->state = 0;
     pthread_join(dev->thread, NULL);
+    if (dev->shm_rd || dev->net_rd) return 1;
+#ifndef WIN32
+    if (dev->net) pthread_join(dev->net->thread, NULL);
+#endif
     sdr_usb_req(dev->usb, 0, SDR_VR_STOP, 0, NULL, 0);
 #ifndef WIN32
-    for (int i = 0; i < SDR_MAX_BUFF; i++) {
+    for (int i = 0; i < dev->nbuff; i++) {
         libusb_cancel_transfer(dev->transfer[i]);
     }
+    if (dev->size_hdr) {
+        uint8_t data[4];
+        sdr_usb_req(dev->usb, 0, SDR_VR_FRAME, 0, data, 4);
+    }
+    if (dev->shm) {
+        __atomic_store_n(&dev->shm->state, 0, __ATOMIC_RELEASE);
+    }
 #endif
     return 1;
 }
@@ -350,24 +1588,145 @@ int sdr_dev_stop(sdr_dev_t *dev)
 //
 int sdr_dev_read(sdr_dev_t *dev, uint8_t *buff, int size)
 {
-    pthread_mutex_lock(&dev->mtx);
-    int64_t wp = dev->wp;
-    pthread_mutex_unlock(&dev->mtx);
+    sdr_dev_sync(dev, dev->size_data);
+    
+    if (get_unread(dev) < size) {
+        return 0;
+    }
+    for (int i = 0, n; i < size; i += n) {
+        uint8_t *p = buff_ptr(dev, dev->rp + i, &n);
+        n = MIN(n, size - i);
+        memcpy(buff + i, p, n);
+    }
+    __atomic_store_n(&dev->rp, dev->rp + size, __ATOMIC_RELEASE);
+    return size;
+}
+
+//------------------------------------------------------------------------------
+//  Peek IF data in the raw data buffer without copy (non-block). The data
+//  should be released by sdr_dev_consume() after use. Data size returned can
+//  be less than the requested size at the wrap-around of the buffer or at the
+//  end of the frame with the frame headers.
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size requested (bytes)
+//      data        (O)   pointer to IF data in the raw data buffer
+//
+//  return
+//      data size available as contiguous bytes (0: no data) (bytes)
+//
+int sdr_dev_peek(sdr_dev_t *dev, int size, uint8_t **data)
+{
+    int64_t n = get_unread(dev);
+    int m;
     
-    if (wp < dev->rp + size) {
+    if (n <= 0) {
         return 0;
     }
-    int rp = (int)(dev->rp % BUFF_SIZE);
+    *data = buff_ptr(dev, dev->rp, &m);
+    return (int)MIN(MIN(n, (int64_t)size), (int64_t)m);
+}
+
+//------------------------------------------------------------------------------
+//  Skip unread IF data on overrun of the raw data buffer. The read pointer is
+//  advanced to the half of the buffer in multiples of the alignment to keep
+//  the boundaries of the IF data cycles. The skipped size is accumulated to
+//  dev->nskip.
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      align       (I)   alignment of skipped data (bytes)
+//
+//  return
+//      skipped data size (0: no overrun) (bytes)
+//
+int64_t sdr_dev_sync(sdr_dev_t *dev, int align)
+{
+    int64_t n = get_unread(dev);
     
-    if (rp + size <= BUFF_SIZE) {
-        memcpy(buff, dev->buff + rp, size);
+    if (n <= MAX_UNREAD(dev)) {
+        return 0;
+    }
+    int64_t skip = (n - BUFF_SIZE(dev) / 2 + align - 1) / align * align;
+    skip = MIN(skip, n / align * align);
+    __atomic_store_n(&dev->rp, dev->rp + skip, __ATOMIC_RELEASE);
+    dev->nskip += skip;
+    return skip;
+}
+
+//------------------------------------------------------------------------------
+//  Check IF data peeked by sdr_dev_peek() before release. The data is invalid
+//  if any of the transfers carrying the data failed or the data has been
+//  overwritten by the transfers after the overrun of the raw data buffer.
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size peeked (bytes)
+//
+//  return
+//      status (1: valid, 0: invalid)
+//
+int sdr_dev_check(sdr_dev_t *dev, int size)
+{
+    if (get_wp(dev) - dev->rp > BUFF_SIZE(dev)) {
+        return 0;
     }
-    else {
-        memcpy(buff, dev->buff + rp, BUFF_SIZE - rp);
-        memcpy(buff + BUFF_SIZE - rp, dev->buff, size - BUFF_SIZE + rp);
+    for (int64_t p = dev->rp - dev->rp % dev->size_data; p < dev->rp + size;
+        p += dev->size_data) {
+        if (dev->err[(p / dev->size_data) % dev->nbuff]) return 0;
     }
-    dev->rp += size;
-    return size;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Release IF data peeked by sdr_dev_peek().
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size to be released (bytes)
+//
+//  return
+//      none
+//
+void sdr_dev_consume(sdr_dev_t *dev, int size)
+{
+    __atomic_store_n(&dev->rp, dev->rp + size, __ATOMIC_RELEASE);
+}
+
+//------------------------------------------------------------------------------
+//  Wait for IF data received. It returns immediately if enough data already
+//  received.
+//
+//  args:
+//      dev         (I)   USB device pointer
+//      size        (I)   IF data size to be read (bytes)
+//      msec        (I)   timeout (ms)
+//
+//  return
+//      status (1: data received, 0: timeout)
+//
+int sdr_dev_wait(sdr_dev_t *dev, int size, int msec)
+{
+    if (__atomic_load_n(&dev->wp, __ATOMIC_ACQUIRE) >= dev->rp + size) {
+        return 1;
+    }
+    pthread_mutex_lock(&dev->mtx);
+    __atomic_store_n(&dev->wait, 1, __ATOMIC_SEQ_CST);
+    int stat = __atomic_load_n(&dev->wp, __ATOMIC_SEQ_CST) >= dev->rp + size;
+    if (!stat && sdr_cond_wait(&dev->cond, &dev->mtx, msec)) {
+        if ((stat = __atomic_load_n(&dev->wp, __ATOMIC_ACQUIRE) >=
+                dev->rp + size)) {
+            double t = (double)(sdr_get_tick_us() -
+                __atomic_load_n(&dev->lat.t, __ATOMIC_RELAXED));
+            dev->lat.n++;
+            dev->lat.sum += t;
+            if (t > dev->lat.max) dev->lat.max = t;
+        }
+    }
+    __atomic_store_n(&dev->wait, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&dev->mtx);
+    return stat;
 }
 
 //------------------------------------------------------------------------------
@@ -385,12 +1744,32 @@ int sdr_dev_read(sdr_dev_t *dev, uint8_t *buff, int size)
 //
 int sdr_dev_get_info(sdr_dev_t *dev, int *fmt, double *fs, double *fo, int *IQ)
 {
+    const uint8_t *data;
     double fss;
-    uint8_t data[6];
     int nch = 0;
     
+#ifndef WIN32
+    if (dev->shm_rd) { // IF broker reader
+        *fmt = dev->shm->fmt;
+        *fs = dev->shm->fs;
+        for (int i = 0; i < dev->shm->nch; i++) {
+            fo[i] = dev->shm->fo[i];
+            IQ[i] = dev->shm->IQ[i];
+        }
+        return dev->shm->nch;
+    }
+    if (dev->net_rd) { // network IF stream reader
+        *fmt = dev->net->fmt;
+        *fs = dev->net->fs;
+        for (int i = 0; i < dev->net->nch; i++) {
+            fo[i] = dev->net->fo[i];
+            IQ[i] = dev->net->IQ[i];
+        }
+        return dev->net->nch;
+    }
+#endif
     // read device info and status
-    if (!sdr_usb_req(dev->usb, 0, SDR_VR_STAT, 0, data, 6)) {
+    if (!(data = read_info(dev))) {
         return 0;
     }
     int type = (data[3] >> 4) & 1; // 0: Pocket SDR, 1: Spider SDR
@@ -429,12 +1808,13 @@ int sdr_dev_get_info(sdr_dev_t *dev, int *fmt, double *fs, double *fo, int *IQ)
 //
 int sdr_dev_set_gain(sdr_dev_t *dev, int ch, int gain)
 {
-    uint8_t data[6], reg1[4], reg2[4];
+    const uint8_t *data;
+    uint32_t reg[2];
     
-    if (!dev->state) return 0;
+    if (!dev->state || !dev->usb) return 0;
     
     // read device info
-    if (!sdr_usb_req(dev->usb, 0, SDR_VR_STAT, 0, data, 6)) {
+    if (!(data = read_info(dev))) {
         return 0;
     }
     int ver = data[0] >> 4, nch = (ver <= 2) ? 2 : 4;
@@ -443,21 +1823,19 @@ int sdr_dev_set_gain(sdr_dev_t *dev, int ch, int gain)
         return 0;
     }
     // read MAX2771 registers
-    if (!sdr_usb_req(dev->usb, 0, SDR_VR_REG_READ, (ch << 8) + 1, reg1, 4) ||
-        !sdr_usb_req(dev->usb, 0, SDR_VR_REG_READ, (ch << 8) + 2, reg2, 4)) {
+    if (!sdr_dev_read_regs(dev, ch, 1, 2, reg)) {
         return 0;
     }
     if (gain > 0) { // manual gain
-        reg1[2] = (reg1[2] & ~0x18) + (2 << 3); // AGCMODE = 2
-        reg2[0] = (reg2[0] & ~0x0F) + (((gain - 1) >> 2) & 0x0F); // GAININ[5:2]
-        reg2[1] = (reg2[1] & ~0xC0) + (((gain - 1) << 6) & 0xC0); // GAININ[1:0]
+        reg[0] = (reg[0] & ~(0x3u << 11)) + (2u << 11); // AGCMODE = 2
+        reg[1] = (reg[1] & ~(0x3Fu << 22)) +
+            (((uint32_t)(gain - 1) & 0x3F) << 22); // GAININ
     }
     else { // AGC
-        reg1[2] = (reg1[2] & ~0x18); // AGCMODE = 0
+        reg[0] = (reg[0] & ~(0x3u << 11)); // AGCMODE = 0
     }
     // write MAX2771 registers
-    return sdr_usb_req(dev->usb, 1, SDR_VR_REG_WRITE, (ch << 8) + 1, reg1, 4) &&
-           sdr_usb_req(dev->usb, 1, SDR_VR_REG_WRITE, (ch << 8) + 2, reg2, 4);
+    return sdr_dev_write_regs(dev, ch, 1, 2, reg);
 }
 
 //------------------------------------------------------------------------------
@@ -472,12 +1850,14 @@ int sdr_dev_set_gain(sdr_dev_t *dev, int ch, int gain)
 //
 int sdr_dev_get_gain(sdr_dev_t *dev, int ch)
 {
-    uint8_t data[6], reg1[4], reg2[4];
+    const uint8_t *data;
+    uint32_t reg[2];
     
     if (!dev->state) return 0;
+    if (!dev->usb) return -1;
     
     // read device info
-    if (!sdr_usb_req(dev->usb, 0, SDR_VR_STAT, 0, data, 6)) {
+    if (!(data = read_info(dev))) {
         return -1;
     }
     int ver = data[0] >> 4, nch = (ver <= 2) ? 2 : 4;
@@ -486,14 +1866,94 @@ int sdr_dev_get_gain(sdr_dev_t *dev, int ch)
         return -1;
     }
     // read MAX2771 registers
-    if (!sdr_usb_req(dev->usb, 0, SDR_VR_REG_READ, (ch << 8) + 1, reg1, 4) ||
-        !sdr_usb_req(dev->usb, 0, SDR_VR_REG_READ, (ch << 8) + 2, reg2, 4)) {
+    if (!sdr_dev_read_regs(dev, ch, 1, 2, reg)) {
         return -1;
     }
-    if (((reg1[2] >> 3) & 0x03) == 2) { // manual gain
-        return ((reg2[0] & 0x0F) << 2) + (reg2[1] >> 6) + 1;
+    if (((reg[0] >> 11) & 0x3) == 2) { // manual gain
+        return ((reg[1] >> 22) & 0x3F) + 1;
     }
     else { // AGC
         return 0;
     }
 }
+
+//------------------------------------------------------------------------------
+//  Read registers of SDR device. The registers are read from the register
+//  shadow cache of the device. The registers not in the cache are read from
+//  the device by a vendor request of the register block, if the device F/W
+//  supports it, or by vendor requests of each register.
+//
+//  args:
+//      dev         (I)   SDR device
+//      ch          (I)   RF channel (0:CH1, 1:CH2, ...)
+//      addr        (I)   start register address
+//      n           (I)   number of registers
+//      regs        (O)   register values {reg[addr],...,reg[addr+n-1]}
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_read_regs(sdr_dev_t *dev, int ch, int addr, int n, uint32_t *regs)
+{
+    if (!dev->usb || ch < 0 || ch >= SDR_MAX_RFCH || addr < 0 || n < 1 ||
+        addr + n > SDR_MAX_REG) {
+        return 0;
+    }
+    uint32_t mask = (((uint32_t)1 << n) - 1) << addr;
+    
+    if ((dev->regs_ok[ch] & mask) != mask) {
+        if (!req_regs(dev, 0, ch, addr, n, dev->regs[ch] + addr)) {
+            fprintf(stderr, "register read error. [CH%d] 0x%X\n", ch + 1, addr);
+            return 0;
+        }
+        dev->regs_ok[ch] |= mask;
+    }
+    memcpy(regs, dev->regs[ch] + addr, sizeof(uint32_t) * n);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Write registers of SDR device. Only the registers changed from the register
+//  shadow cache of the device are written to the device, by vendor requests
+//  of the register block for each run of the changed registers if the device
+//  F/W supports it. The cache is updated by the written registers.
+//
+//  args:
+//      dev         (I)   SDR device
+//      ch          (I)   RF channel (0:CH1, 1:CH2, ...)
+//      addr        (I)   start register address
+//      n           (I)   number of registers
+//      regs        (I)   register values {reg[addr],...,reg[addr+n-1]}
+//
+//  return
+//      status (1: OK, 0: error)
+//
+int sdr_dev_write_regs(sdr_dev_t *dev, int ch, int addr, int n,
+    const uint32_t *regs)
+{
+    uint32_t val[SDR_MAX_REG];
+    
+    if (!dev->usb || ch < 0 || ch >= SDR_MAX_RFCH || addr < 0 || n < 1 ||
+        addr + n > SDR_MAX_REG) {
+        return 0;
+    }
+    for (int i = 0, j; i < n; i = j) {
+        if (same_reg(dev, ch, addr + i, regs[i])) {
+            j = i + 1;
+            continue;
+        }
+        for (j = i + 1; j < n && !same_reg(dev, ch, addr + j, regs[j]); j++) ;
+        uint32_t mask = (((uint32_t)1 << (j - i)) - 1) << (addr + i);
+        memcpy(val, regs + i, sizeof(uint32_t) * (j - i));
+        
+        if (!req_regs(dev, 1, ch, addr + i, j - i, val)) {
+            fprintf(stderr, "register write error. [CH%d] 0x%X\n", ch + 1,
+                addr + i);
+            dev->regs_ok[ch] &= ~mask;
+            return 0;
+        }
+        memcpy(dev->regs[ch] + addr + i, regs + i, sizeof(uint32_t) * (j - i));
+        dev->regs_ok[ch] |= mask;
+    }
+    return 1;
+}
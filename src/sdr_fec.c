@@ -11,27 +11,294 @@
 //  History:
 //  2022-07-08  1.0  port sdr_fec.py to C
 //  2024-01-26  1.1  sdr_decode_rs() returns number of error bits
+//  2026-10-15  1.2  replace Viterbi decoder of LIBFEC by reentrant SIMD
+//                   decoder with incremental update and sliding window,
+//                   add APIs sdr_vit_init(), sdr_vit_update(),
+//                   sdr_vit_chainback()
 //
 #include "pocket_sdr.h"
 
+#if defined(AVX2)
+#include <immintrin.h>
+#elif defined(NEON)
+#include <arm_neon.h>
+#endif
+
+// constants -------------------------------------------------------------------
+#define NS_VIT      64          // number of states of Viterbi decoder (K=7)
+#define NT_VIT      6           // number of tail bits (K-1)
+#define BM_MAX      510         // max branch metric of a symbol pair
+#define M_START     63          // initial path metric of non-starting states
+#define NORM_INT    32          // interval of path metric normalization (steps)
+
 // function prototype of LIBFEC ([1]) ------------------------------------------
 #ifdef __cplusplus
 extern "C" {
 #endif
 int decode_rs_ccsds(uint8_t *data, int *eras_pos, int no_eras, int pad);
-void *create_viterbi27(int len);
-void set_viterbi27_polynomial(int polys[2]);
-int init_viterbi27(void *vp, int starting_state);
-int update_viterbi27_blk(void *vp, unsigned char sym[], int npairs);
-int chainback_viterbi27(void *vp, unsigned char *data, unsigned int nbits,
-    unsigned int endstate);
-void delete_viterbi27(void *vp);
 #ifdef __cplusplus
 }
 #endif
 
+// branch tables of butterflies (G1:0x4F, G2:0x6D) -----------------------------
+//  BR_G1[i] = parity((2 * i) & 0x4F) * 255, BR_G2[i] = parity((2 * i) & 0x6D)
+//  * 255 for the old states i and i + 32 to the new states 2 * i, 2 * i + 1.
+static const uint16_t BR_G1[NS_VIT/2] = {
+    0, 255, 255, 0, 255, 0, 0, 255, 0, 255, 255, 0, 255, 0, 0, 255,
+    0, 255, 255, 0, 255, 0, 0, 255, 0, 255, 255, 0, 255, 0, 0, 255
+};
+static const uint16_t BR_G2[NS_VIT/2] = {
+    0, 0, 255, 255, 255, 255, 0, 0, 0, 0, 255, 255, 255, 255, 0, 0,
+    255, 255, 0, 0, 0, 0, 255, 255, 255, 255, 0, 0, 0, 0, 255, 255
+};
+
+// type definitions ------------------------------------------------------------
+typedef uint64_t (*acs_t)(const uint16_t *m0, uint16_t *m1, uint8_t s1,
+    uint8_t s2);
+
+// add-compare-select of butterflies -------------------------------------------
+//  The path metrics m1 of the new states are updated by the path metrics m0 of
+//  the old states and the soft-decision symbol pair (s1, s2). The decisions
+//  (1: the old state i + 32 selected) of the new states are returned.
+static uint64_t acs_c(const uint16_t *m0, uint16_t *m1, uint8_t s1, uint8_t s2)
+{
+    uint64_t dec = 0;
+    
+    for (int i = 0; i < NS_VIT / 2; i++) {
+        int bm = (BR_G1[i] ^ s1) + (BR_G2[i] ^ s2);
+        int p0 = m0[i] + bm, p1 = m0[i+32] + BM_MAX - bm;
+        int p2 = m0[i] + BM_MAX - bm, p3 = m0[i+32] + bm;
+        m1[2*i  ] = (uint16_t)(p0 > p1 ? p1 : p0);
+        m1[2*i+1] = (uint16_t)(p2 > p3 ? p3 : p2);
+        dec |= (uint64_t)(p0 > p1) << (2 * i);
+        dec |= (uint64_t)(p2 > p3) << (2 * i + 1);
+    }
+    return dec;
+}
+
+#if defined(AVX2)
+// add-compare-select of butterflies (SSE4) ------------------------------------
+//  The metrics of new states are interleaved by PUNPCKLWD/PUNPCKHWD and the
+//  decisions are packed by PACKSSWB and PMOVMSKB.
+SDR_TARGET_SSE4
+static uint64_t acs_sse4(const uint16_t *m0, uint16_t *m1, uint8_t s1,
+    uint8_t s2)
+{
+    __m128i x1 = _mm_set1_epi16(s1), x2 = _mm_set1_epi16(s2);
+    __m128i xmax = _mm_set1_epi16(BM_MAX);
+    uint64_t dec = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        __m128i o0 = _mm_loadu_si128((__m128i *)(m0 + i * 8));
+        __m128i o1 = _mm_loadu_si128((__m128i *)(m0 + i * 8 + 32));
+        __m128i bm = _mm_add_epi16(
+            _mm_xor_si128(_mm_loadu_si128((__m128i *)(BR_G1 + i * 8)), x1),
+            _mm_xor_si128(_mm_loadu_si128((__m128i *)(BR_G2 + i * 8)), x2));
+        __m128i bc = _mm_sub_epi16(xmax, bm);
+        __m128i p0 = _mm_adds_epu16(o0, bm), p1 = _mm_adds_epu16(o1, bc);
+        __m128i p2 = _mm_adds_epu16(o0, bc), p3 = _mm_adds_epu16(o1, bm);
+        __m128i n0 = _mm_min_epu16(p0, p1), n1 = _mm_min_epu16(p2, p3);
+        __m128i d0 = _mm_cmpeq_epi16(n0, p0), d1 = _mm_cmpeq_epi16(n1, p2);
+        _mm_storeu_si128((__m128i *)(m1 + i * 16), _mm_unpacklo_epi16(n0, n1));
+        _mm_storeu_si128((__m128i *)(m1 + i * 16 + 8),
+            _mm_unpackhi_epi16(n0, n1));
+        __m128i d = _mm_packs_epi16(_mm_unpacklo_epi16(d0, d1),
+            _mm_unpackhi_epi16(d0, d1));
+        dec |= (uint64_t)(uint16_t)~_mm_movemask_epi8(d) << (i * 16);
+    }
+    return dec;
+}
+
+// add-compare-select of butterflies (AVX2) ------------------------------------
+//  The interleaved metrics in 128-bit lanes are reordered by VPERM2I128.
+SDR_TARGET_AVX2
+static uint64_t acs_avx2(const uint16_t *m0, uint16_t *m1, uint8_t s1,
+    uint8_t s2)
+{
+    __m256i y1 = _mm256_set1_epi16(s1), y2 = _mm256_set1_epi16(s2);
+    __m256i ymax = _mm256_set1_epi16(BM_MAX);
+    uint64_t dec = 0;
+    
+    for (int i = 0; i < 2; i++) {
+        __m256i o0 = _mm256_loadu_si256((__m256i *)(m0 + i * 16));
+        __m256i o1 = _mm256_loadu_si256((__m256i *)(m0 + i * 16 + 32));
+        __m256i g1 = _mm256_loadu_si256((__m256i *)(BR_G1 + i * 16));
+        __m256i g2 = _mm256_loadu_si256((__m256i *)(BR_G2 + i * 16));
+        __m256i bm = _mm256_add_epi16(_mm256_xor_si256(g1, y1),
+            _mm256_xor_si256(g2, y2));
+        __m256i bc = _mm256_sub_epi16(ymax, bm);
+        __m256i p0 = _mm256_adds_epu16(o0, bm), p1 = _mm256_adds_epu16(o1, bc);
+        __m256i p2 = _mm256_adds_epu16(o0, bc), p3 = _mm256_adds_epu16(o1, bm);
+        __m256i n0 = _mm256_min_epu16(p0, p1), n1 = _mm256_min_epu16(p2, p3);
+        __m256i d0 = _mm256_cmpeq_epi16(n0, p0);
+        __m256i d1 = _mm256_cmpeq_epi16(n1, p2);
+        __m256i lo = _mm256_unpacklo_epi16(n0, n1);
+        __m256i hi = _mm256_unpackhi_epi16(n0, n1);
+        _mm256_storeu_si256((__m256i *)(m1 + i * 32),
+            _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(m1 + i * 32 + 16),
+            _mm256_permute2x128_si256(lo, hi, 0x31));
+        __m256i d = _mm256_packs_epi16(_mm256_unpacklo_epi16(d0, d1),
+            _mm256_unpackhi_epi16(d0, d1));
+        dec |= (uint64_t)(uint32_t)~_mm256_movemask_epi8(d) << (i * 32);
+    }
+    return dec;
+}
+
+#elif defined(NEON)
+// add-compare-select of butterflies (NEON) ------------------------------------
+static uint64_t acs_neon(const uint16_t *m0, uint16_t *m1, uint8_t s1,
+    uint8_t s2)
+{
+    static const uint8_t bit[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128
+    };
+    uint16x8_t x1 = vdupq_n_u16(s1), x2 = vdupq_n_u16(s2);
+    uint16x8_t xmax = vdupq_n_u16(BM_MAX);
+    uint8x16_t xb = vld1q_u8(bit);
+    uint64_t dec = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        uint16x8_t o0 = vld1q_u16(m0 + i * 8), o1 = vld1q_u16(m0 + i * 8 + 32);
+        uint16x8_t bm = vaddq_u16(veorq_u16(vld1q_u16(BR_G1 + i * 8), x1),
+            veorq_u16(vld1q_u16(BR_G2 + i * 8), x2));
+        uint16x8_t bc = vsubq_u16(xmax, bm);
+        uint16x8_t p0 = vqaddq_u16(o0, bm), p1 = vqaddq_u16(o1, bc);
+        uint16x8_t p2 = vqaddq_u16(o0, bc), p3 = vqaddq_u16(o1, bm);
+        uint16x8_t n0 = vminq_u16(p0, p1), n1 = vminq_u16(p2, p3);
+        uint16x8_t d0 = vcgtq_u16(p0, p1), d1 = vcgtq_u16(p2, p3);
+        vst1q_u16(m1 + i * 16    , vzip1q_u16(n0, n1));
+        vst1q_u16(m1 + i * 16 + 8, vzip2q_u16(n0, n1));
+        uint8x16_t d = vandq_u8(vcombine_u8(vmovn_u16(vzip1q_u16(d0, d1)),
+            vmovn_u16(vzip2q_u16(d0, d1))), xb);
+        dec |= (uint64_t)vaddv_u8(vget_low_u8(d)) << (i * 16);
+        dec |= (uint64_t)vaddv_u8(vget_high_u8(d)) << (i * 16 + 8);
+    }
+    return dec;
+}
+#endif // AVX2, NEON
+
+// select ACS kernel by SIMD variant -------------------------------------------
+static acs_t sel_acs(void)
+{
+    int simd = sdr_get_simd();
+    
+#if defined(AVX2)
+    if (simd >= SDR_SIMD_AVX2) return acs_avx2;
+    if (simd >= SDR_SIMD_SSE4) return acs_sse4;
+#elif defined(NEON)
+    if (simd >= SDR_SIMD_NEON) return acs_neon;
+#endif
+    return acs_c;
+}
+
+// normalize path metrics ------------------------------------------------------
+static void norm_metric(uint16_t *m)
+{
+    uint16_t min = m[0];
+    
+    for (int i = 1; i < NS_VIT; i++) {
+        if (m[i] < min) min = m[i];
+    }
+    for (int i = 0; i < NS_VIT; i++) {
+        m[i] -= min;
+    }
+}
+
 //------------------------------------------------------------------------------
-//  Decode convolution code (K=7, R=1/2, Poly=G1:0x4F,G2:0x6D).
+//  Initialize Viterbi decoder of convolution code (K=7, R=1/2, Poly=G1:0x4F,
+//  G2:0x6D).
+//
+//  args:
+//      vit      (O) Viterbi decoder
+//      state    (I) Starting state of encoder (0-63, -1: unknown)
+//
+//  return:
+//      none
+//
+void sdr_vit_init(sdr_vit_t *vit, int state)
+{
+    for (int i = 0; i < NS_VIT; i++) {
+        vit->metric[i] = (state < 0 || i == state) ? 0 : M_START;
+    }
+    vit->n = 0;
+}
+
+//------------------------------------------------------------------------------
+//  Update Viterbi decoder with soft-decision symbols. The decoder keeps the
+//  decisions of the latest SDR_MAX_VIT steps in a ring buffer, so that it can
+//  be updated incrementally by new symbols and decoded as a sliding window by
+//  sdr_vit_chainback(). The add-compare-select kernel is selected by the SIMD
+//  variant (see sdr_set_simd()). No memory is allocated.
+//
+//  args:
+//      vit      (IO) Viterbi decoder
+//      syms     (I)  Symbols as uint8_t array (0 to 255 for soft-decision)
+//                    (G1 and G2 symbols interleaved)
+//      N        (I)  Number of symbols (N / 2 steps)
+//
+//  return:
+//      none
+//
+void sdr_vit_update(sdr_vit_t *vit, const uint8_t *syms, int N)
+{
+    acs_t acs = sel_acs();
+    uint16_t m[2][NS_VIT];
+    int k = 0;
+    
+    memcpy(m[0], vit->metric, sizeof(m[0]));
+    
+    for (int i = 0; i + 1 < N; i += 2, k ^= 1) {
+        vit->dec[vit->n % SDR_MAX_VIT] = acs(m[k], m[k^1], syms[i], syms[i+1]);
+        if (++vit->n % NORM_INT == 0) {
+            norm_metric(m[k^1]);
+        }
+    }
+    memcpy(vit->metric, m[k], sizeof(m[0]));
+}
+
+//------------------------------------------------------------------------------
+//  Decode bits by chainback of Viterbi decoder. The bits of the steps
+//  n - ntail - nbits, ..., n - ntail - 1 are decoded, where n is the number of
+//  the updated steps of the decoder.
+//
+//  args:
+//      vit      (I) Viterbi decoder
+//      state    (I) Ending state of the chainback (0-63, -1: best state)
+//      nbits    (I) Number of decoded bits
+//      ntail    (I) Number of skipped tail steps
+//      bits     (O) Decoded bits as uint8_t array (0 or 1)
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_vit_chainback(const sdr_vit_t *vit, int state, int nbits, int ntail,
+    uint8_t *bits)
+{
+    int n0 = vit->n - ntail - nbits;
+    
+    if (nbits <= 0 || ntail < 0 || n0 < 0 || nbits + ntail > SDR_MAX_VIT) {
+        return 0;
+    }
+    if (state < 0) {
+        state = 0;
+        for (int i = 1; i < NS_VIT; i++) {
+            if (vit->metric[i] < vit->metric[state]) state = i;
+        }
+    }
+    for (int i = vit->n - 1; i >= n0; i--) {
+        int d = (int)(vit->dec[i % SDR_MAX_VIT] >> state) & 1;
+        if (i < n0 + nbits) {
+            bits[i - n0] = (uint8_t)(state & 1);
+        }
+        state = (state >> 1) | (d << 5);
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Decode convolution code (K=7, R=1/2, Poly=G1:0x4F,G2:0x6D). The encoder is
+//  assumed to start at the state 0 and to be terminated by the tail bits.
 //
 //  args:
 //      data     (I) Data as uint8_t array (0 to 255 for soft-decision).
@@ -43,40 +310,16 @@ void delete_viterbi27(void *vp);
 //
 void sdr_decode_conv(const uint8_t *data, int N, uint8_t *dec_data)
 {
-    static int poly[] = {0x4F, 0x6D};
-    int n = N / 2 - 6;
-    void *dec;
-    
-    // initialize Viterbi decoder
-    if (n <= 0 || !(dec = create_viterbi27(n))) {
-        fprintf(stderr, "create_viterbi27() error n=%d\n", n);
-        return;
-    }
-    // set polynomial
-    set_viterbi27_polynomial(poly);
+    sdr_vit_t vit;
+    int n = N / 2 - NT_VIT;
     
-    // update decoder with demodulated symbols
-    if (update_viterbi27_blk(dec, (unsigned char *)data, n + 6)) {
-        fprintf(stderr, "update_viterbi27_blk() error\n");
-        delete_viterbi27(dec);
+    if (n <= 0 || n + NT_VIT > SDR_MAX_VIT) {
+        fprintf(stderr, "sdr_decode_conv() error n=%d\n", n);
         return;
     }
-    uint8_t *bits = (uint8_t *)sdr_malloc((n + 7) / 8);
-    
-    // Viterbi chainback
-    if (chainback_viterbi27(dec, (unsigned char *)bits, n, 0)) {
-        fprintf(stderr, "chainback_viterbi27() error\n");
-        delete_viterbi27(dec);
-        sdr_free(bits);
-        return;
-    }
-    // delete decoder
-    delete_viterbi27(dec);
-    
-    for (int i = 0; i < n; i++) {
-        dec_data[i] = (bits[i / 8] >> (7 - i % 8)) & 1;
-    }
-    sdr_free(bits);
+    sdr_vit_init(&vit, 0);
+    sdr_vit_update(&vit, data, (n + NT_VIT) * 2);
+    sdr_vit_chainback(&vit, 0, n, NT_VIT, dec_data);
 }
 
 // count bits of "1" -----------------------------------------------------------
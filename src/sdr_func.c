@@ -25,6 +25,62 @@
 //                   support ARM and NEON
 //  2024-05-13  1.13 add API sdr_str_open(), sdr_str_close()
 //  2024-06-29  1.14 add API sdr_psd_cpx()
+//  2026-10-14  1.15 sdr_search_code(): share data DFT among Doppler bins and
+//                   batch IFFTs
+//                   use per-thread scratch arena for correlator buffers
+//                   fused carrier mixer and standard correlator
+//                   add API sdr_set_simd(), sdr_get_simd()
+//                   runtime dispatch of SIMD kernels (SSE4, AVX2, AVX-512,
+//                   NEON)
+//                   unbounded lock-free FFTW plan cache using wisdom file
+//                   sdr_read_data(): read memory-mapped file in chunks and
+//                   support 64-bit file offsets
+//                   sdr_str_open(): fix crash by file path without options
+//                   add API sdr_code_nco()
+//                   add API sdr_search_code_max()
+//                   SIMD kernels of correlation power accumulation
+//                   add API sdr_acq_batch()
+//                   add APIs sdr_dft_cache_new(), sdr_dft_cache_free(),
+//                   sdr_dft_cache_inval()
+//                   sdr_search_code(): share data DFTs by data DFT cache
+//                   add API sdr_atan2_blk()
+//                   add API sdr_corr_std_multi()
+//                   add polynomial carrier NCO mixer and API sdr_set_mix()
+//                   add APIs sdr_buff_new_pack(), sdr_buff_get() and mix
+//                   packed 2-bit IF data
+//  2026-10-15  1.16 add APIs sdr_ostr_open(), sdr_ostr_close(),
+//                   sdr_ostr_write() of asynchronous output streams
+//                   output log by asynchronous output stream
+//                   add APIs sdr_log_format(), sdr_log_conv() and binary log
+//                   format with per-thread log buffers
+//                   add API sdr_par_for()
+//                   add IF data monitor and APIs sdr_mon_new(), sdr_mon_free(),
+//                   sdr_mon_update(), sdr_mon_psd(), sdr_mon_hist()
+//                   add API sdr_file_read_data()
+//                   add API sdr_search_code_cpx()
+//                   allocate IF data buffers by sdr_mem_alloc()
+//                   replicate carrier-mixed-data LUT on NUMA nodes
+//                   add GLONASS FDMA channelizer and APIs sdr_fdma_new(),
+//                   sdr_fdma_free(), sdr_fdma_buff(), sdr_fdma_update()
+//                   replace GLONASS FDMA channelizer by sub-band DDC and APIs
+//                   sdr_ddc_new(), sdr_ddc_free(), sdr_ddc_dec(),
+//                   sdr_ddc_update()
+//                   share mixed tile of correlator jobs with same carrier
+//                   NCO in sdr_corr_std_multi()
+//                   add CSK demodulator by chip-rate FFT correlator and APIs
+//                   sdr_csk_new(), sdr_csk_free(), sdr_csk_corr()
+//                   sdr_ostr_open(): fan out to multiple streams by paths
+//                   separated by '+'
+//                   add API sdr_search_code_buff_cpx() for Python API
+//                   add API sdr_search_code_dec() of partial code search in
+//                   decimated IF data
+//                   sdr_par_for(): dispatch to persistent thread pool
+//                   sdr_search_code(): use cached data DFT in place
+//                   measure FFTW plans, add APIs sdr_fftw_plan(),
+//                   sdr_search_plan(), sdr_fftw_import(), sdr_fftw_export()
+//                   flush per-thread log buffers by buffer lock and by output
+//                   stream writer thread if idle, identify binary log
+//                   formats by contents
 //
 #include <math.h>
 #include <stdarg.h>
@@ -42,23 +98,84 @@
 // constants and macros --------------------------------------------------------
 #define NTBL          256   // carrier-mixed-data LUT size
 #define DOP_STEP      0.5   // Doppler frequency search step (* 1 / code cycle)
-#define MAX_FFTW_PLAN 32    // max number of FFTW plans
+#define MAX_FFT_BATCH (1<<20) // max size of batched IFFT in code search
+#define CORR_TILE     1024  // tile size of fused mixer and correlator (samples)
+#define CODE_BLK      8     // block size of code NCO (samples)
 #define MAX_LOG_BUFF  32768 // max sizeof log buffer
-#define FFTW_FLAG     FFTW_ESTIMATE // FFTW flag
+#define LOG_STR_SIZE  (1<<22) // size of log output stream buffer (bytes)
+#define OSTR_CYC      10    // write cycle of output stream writer (ms)
+#define LOG_TBUF_SIZE 32768 // size of per-thread binary log buffer (bytes)
+#define LOG_MAX_REC   4096  // max size of binary log record (bytes)
+#define LOG_MAX_FMT   1024  // max number of binary log formats
+#define LOG_FLUSH     200   // flush interval of per-thread log buffer (ms)
+#define READ_CHUNK    (1<<20) // chunk size to read IF data file (samples)
+#define MAX_POOL_THREAD 64  // max number of threads of parallel for pool
+#define MON_NSEG      8     // number of PSD segments per burst of IF monitor
+#define MON_RATE      1000.0 // max rate of IF monitor segments (segments/s)
+#define MON_N_HIST    1024  // segment size of IF monitor for histogram only
+#define DDC_SIG       1.5f  // sigma of quantized DDC sub-band samples
+#define DDC_QMAX      3     // max level of quantized DDC sub-band samples
+#define DDC_AGC       0.1f  // smoothing factor of DDC sub-band AGC
+#define FFTW_FLAG     FFTW_MEASURE // FFTW planner flag
 
 #define SQR(x)        ((x) * (x))
 #define MIN(x, y)     ((x) < (y) ? (x) : (y))
+#define MAX(x, y)     ((x) > (y) ? (x) : (y))
 #define ROUND(x)      floor(x + 0.5)
+#define NCO_BLK       256   // block size of polynomial NCO in mixer (samples)
+#define NCO_SCALE     ((float)(2.0 * PI / 4294967296.0)) // NCO phase (rad/LSB)
+#define NCO_C1        (-1.0f / 2.0f)    // cos polynomial coefficients
+#define NCO_C2        (1.0f / 24.0f)
+#define NCO_C3        (-1.0f / 720.0f)
+#define NCO_S1        (-1.0f / 6.0f)    // sin polynomial coefficients
+#define NCO_S2        (1.0f / 120.0f)
+#define NCO_S3        (-1.0f / 5040.0f)
+#define T3P8          2.41421356237309504880 // tan(3 * PI / 8)
+#define MOREBITS      6.123233995736765886130E-17 // PI / 2 - double(PI / 2)
+
+// type definitions ------------------------------------------------------------
+typedef struct fftw_plan_tag {  // FFTW plan cache entry type
+    int N, M;                   // FFT size and number of batched transforms
+    fftwf_plan plan[2];         // FFTW plans {forward, backward}
+    struct fftw_plan_tag *next; // next entry
+} fftw_plan_t;
+
+typedef struct log_tbuf_tag {   // per-thread binary log buffer type
+    uint8_t buff[LOG_TBUF_SIZE]; // buffered log records
+    int n;                      // size of buffered log records (bytes)
+    int used;                   // used by a thread
+    int lock;                   // locked by owner or flusher
+    uint32_t tick;              // tick of last flush (ms)
+    struct log_tbuf_tag *next;  // next buffer
+} log_tbuf_t;
 
 // global variables ------------------------------------------------------------
 static sdr_cpx16_t mix_tbl[NTBL*256] = {{0,0}}; // carrier-mixed-data LUT
-static fftwf_plan fftw_plans[MAX_FFTW_PLAN][2] = {{0}}; // FFTW plan buffer
-static int fftw_size[MAX_FFTW_PLAN] = {0}; // FFTW plan sizes
+static sdr_cpx16_t *mix_tbls[SDR_MAX_NODE] = {0}; // LUT replicas on NUMA nodes
+static __thread const sdr_cpx16_t *mix_tbl_th = NULL; // LUT of this thread
+static fftw_plan_t *fftw_plans = NULL; // FFTW plan cache (lock-free list)
+static __thread fftw_plan_t *fftw_plan_last = NULL; // last FFTW plan used
+static pthread_mutex_t fftw_mtx = PTHREAD_MUTEX_INITIALIZER; // FFTW planner
+static char fftw_wisdom[1024] = ""; // FFTW wisdom file
+static int fftw_wisdom_new = 0;   // new wisdom not exported
 static int log_lvl = 3;           // log level
-static stream_t *log_str = NULL;  // log stream
+static sdr_ostr_t *log_str = NULL; // log stream
+static sdr_ostr_t *ostr_list = NULL; // output streams of writer thread
+static int ostr_run = 0;          // output stream writer thread running
+static pthread_mutex_t ostr_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ostr_cond = PTHREAD_COND_INITIALIZER;
 static char log_buff[MAX_LOG_BUFF]; // log buffer
 static int log_buff_p = 0;        // log buffer pointer
 static pthread_mutex_t log_buff_mtx = PTHREAD_MUTEX_INITIALIZER;
+static int log_fmt = SDR_LOG_TEXT; // log format (SDR_LOG_???)
+static char *log_fmts[LOG_MAX_FMT] = {0}; // binary log formats (hash)
+static uint8_t log_fdef[LOG_MAX_FMT] = {0}; // binary log format defined flags
+static log_tbuf_t *log_tbufs = NULL; // per-thread log buffers (lock-free list)
+static __thread log_tbuf_t *log_tbuf = NULL; // log buffer of this thread
+static pthread_key_t log_tbuf_key; // key to release log buffer at thread exit
+static pthread_once_t log_tbuf_once = PTHREAD_ONCE_INIT;
+extern int64_t sdr_n_heap[2];     // number of heap allocations and frees
+extern int sdr_mem_numa;          // NUMA-local placement (0:off,1:on)
 
 // enable escape sequence for Windows console ----------------------------------
 static void enable_console_esc(void)
@@ -74,362 +191,273 @@ static void enable_console_esc(void)
 #endif
 }
 
-// initialize GNSS SDR functions -----------------------------------------------
-void sdr_func_init(const char *file)
+// carrier-mixed-data LUT of this thread ---------------------------------------
+//  With the option mem_numa, the LUT is replicated on the NUMA node of the
+//  thread at the first call. The threads are assumed to be pinned to CPU cores.
+static const sdr_cpx16_t *mix_lut(void)
 {
-    // initilize log stream
-    strinitcom();
+    if (mix_tbl_th) return mix_tbl_th;
     
-    // import FFTW wisdom 
-    if (*file && !fftwf_import_wisdom_from_filename(file)) {
-        fprintf(stderr, "FFTW wisdom import error %s\n", file);
+    int node = sdr_mem_numa && sdr_mem_nnode() > 1 ? sdr_mem_node(-1) : -1;
+    if (node < 0 || node >= SDR_MAX_NODE) {
+        return mix_tbl_th = mix_tbl;
     }
-    // generate carrier-mixed-data LUT
-    for (int i = 0; i < NTBL; i++) {
-        int8_t carr_I = (int8_t)ROUND(cos(-2.0 * PI * i / NTBL) / SDR_CSCALE);
-        int8_t carr_Q = (int8_t)ROUND(sin(-2.0 * PI * i / NTBL) / SDR_CSCALE);
-        for (int j = 0; j < 256; j++) {
-            int8_t I = SDR_CPX8_I(j), Q = SDR_CPX8_Q(j);
-            mix_tbl[(j << 8) + i].I = I * carr_I - Q * carr_Q;
-            mix_tbl[(j << 8) + i].Q = I * carr_Q + Q * carr_I;
+    sdr_cpx16_t *tbl = __atomic_load_n(&mix_tbls[node], __ATOMIC_ACQUIRE);
+    if (!tbl) {
+        sdr_cpx16_t *p = (sdr_cpx16_t *)sdr_mem_alloc(sizeof(mix_tbl), node);
+        memcpy(p, mix_tbl, sizeof(mix_tbl));
+        if (__atomic_compare_exchange_n(&mix_tbls[node], &tbl, p, 0,
+                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            tbl = p;
+        }
+        else {
+            sdr_mem_free(p); // replicated by another thread
         }
     }
-    // enable escape sequence for Windows console
-    enable_console_esc();
+    return mix_tbl_th = tbl;
 }
 
-//------------------------------------------------------------------------------
-//  Allocate memory for complex array. If no memory allocated, it exits the AP
-//  immediately with an error message.
-//  
-//  args:
-//      N        (I)  Size of complex array
-//
-//  return:
-//      Complex array allocated.
-//
-sdr_cpx_t *sdr_cpx_malloc(int N)
+// mix carrier with phase p and phase step s -----------------------------------
+static void mix_carr_c(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
 {
-    sdr_cpx_t *cpx;
+    const sdr_cpx16_t *tbl = mix_lut();
     
-    if (!(cpx = (sdr_cpx_t *)fftwf_malloc(sizeof(sdr_cpx_t) * N))) {
-        fprintf(stderr, "sdr_cpx_t memory allocation error N=%d\n", N);
-        exit(-1);
+    for (int i = 0; i < N; i++, p += s) {
+        int idx = ((int)data[i] << 8) + (p >> 24);
+        IQ[i] = tbl[idx];
     }
-    return cpx;
 }
 
-//------------------------------------------------------------------------------
-//  Free memory allocated by sdr_cpx_malloc().
-//  
-//  args:
-//      cpx      (I)  Complex array
-//
-//  return:
-//      None
-//
-void sdr_cpx_free(sdr_cpx_t *cpx)
+// carrier by polynomial NCO ---------------------------------------------------
+//  The carrier exp(-j * 2 * PI * p / 2^32) / SDR_CSCALE is evaluated by
+//  polynomials of the phase x in [-PI/4, PI/4) rotated by the quadrant q.
+static void carr_nco(uint32_t p, float *cI, float *cQ)
 {
-    fftwf_free(cpx);
+    uint32_t q = (p + (1u << 29)) >> 30;
+    float x = (float)(int32_t)(p - (q << 30)) * NCO_SCALE;
+    float x2 = x * x;
+    float c = 1.0f + x2 * (NCO_C1 + x2 * (NCO_C2 + x2 * NCO_C3));
+    float s = x * (1.0f + x2 * (NCO_S1 + x2 * (NCO_S2 + x2 * NCO_S3)));
+    float cr = (q & 1) ? s : c, ci = (q & 1) ? c : s;
+    if ((q + 1) & 2) cr = -cr;
+    if (!(q & 2)) ci = -ci; // Q = -sin(phase)
+    *cI = cr * (1.0f / SDR_CSCALE);
+    *cQ = ci * (1.0f / SDR_CSCALE);
 }
 
-//------------------------------------------------------------------------------
-//  Absolute value of a complex.
-//  
-//  args:
-//      cpx      (I)  Complex value
-//
-//  return:
-//      | cpx |
-//
-float sdr_cpx_abs(sdr_cpx_t cpx)
+// mix carrier by polynomial NCO with phase p and phase step s -----------------
+//  The products of the 4-bit IQ samples and the carrier are rounded to the
+//  nearest integers without quantization of the carrier.
+static void mix_nco_c(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
 {
-    return sqrtf(SQR(cpx[0]) + SQR(cpx[1]));
+    for (int i = 0; i < N; i++, p += s) {
+        int I = SDR_CPX8_I(data[i]), Q = SDR_CPX8_Q(data[i]);
+        float cI, cQ;
+        carr_nco(p, &cI, &cQ);
+        IQ[i].I = (int8_t)lrintf(I * cI - Q * cQ);
+        IQ[i].Q = (int8_t)lrintf(I * cQ + Q * cI);
+    }
 }
 
-//------------------------------------------------------------------------------
-//  Multiplication of two complex arrays.
-//  
-//  args:
-//      a, b     (I)  Complex arrays
-//      N        (I)  Size of complex arrays
-//      s        (I)  Scale
-//      c        (O)  Multiplication of a and b (c[i] = a[i] * b[i] * s)
-//
-//  return:
-//      None
-//
-void sdr_cpx_mul(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
-    sdr_cpx_t *c)
+// integer inner product of IQ data and code (N <= CORR_TILE) ------------------
+static void dot_IQ_code_c(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, int32_t *sum)
 {
-    int i = 0;
-#if defined(AVX2)
-    __m256 yr = _mm256_set_ps(-1, 1, -1, 1, -1, 1, -1, 1);
-    __m256 ys = _mm256_set1_ps(s);
-    
-    for ( ; i < N - 3; i += 4) {
-         __m256 ya = _mm256_loadu_ps((float *)(a + i));
-         __m256 yb = _mm256_loadu_ps((float *)(b + i));
-         __m256 yc = _mm256_mul_ps(ya, _mm256_mul_ps(yb, yr));
-         __m256 yd = _mm256_mul_ps(ya, _mm256_permute_ps(yb, 0xB1));
-         __m256 ye = _mm256_permute_ps(_mm256_hadd_ps(yc, yd), 0xD8);
-         _mm256_storeu_ps((float *)(c + i), _mm256_mul_ps(ye, ys));
+    for (int i = 0; i < N; i++) {
+        sum[0] += IQ[i].I * code[i].I;
+        sum[1] += IQ[i].Q * code[i].Q;
     }
-#endif
-    for ( ; i < N; i++) {
+}
+
+// multiplication of two complex arrays ----------------------------------------
+static void cpx_mul_c(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
+    sdr_cpx_t *c)
+{
+    for (int i = 0; i < N; i++) {
         c[i][0] = (a[i][0] * b[i][0] - a[i][1] * b[i][1]) * s;
         c[i][1] = (a[i][0] * b[i][1] + a[i][1] * b[i][0]) * s;
     }
 }
 
-//------------------------------------------------------------------------------
-//  Generate a new IF data buffer.
-//
-//  args:
-//      N        (I)  Size of IF data buffer
-//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
-//
-//  return:
-//      IF data buffer
-//
-sdr_buff_t *sdr_buff_new(int N, int IQ)
+// accumulate correlation powers -----------------------------------------------
+//  P[i] += |C[i]|^2 for i = 0,...,N-1. The max and the sum of the accumulated
+//  P[i] for i = 0,...,M-1 are output by *P_max and *P_sum.
+static void pow_acc_c(const sdr_cpx_t *C, int N, int M, float *P, float *P_max,
+    double *P_sum)
 {
-    sdr_buff_t *buff = (sdr_buff_t *)sdr_malloc(sizeof(sdr_buff_t));
-    buff->data = (sdr_cpx8_t *)sdr_malloc(sizeof(sdr_cpx8_t *) * N);
-    buff->N = N;
-    buff->IQ = IQ;
-    return buff;
+    float P_m = 0.0f;
+    double P_s = 0.0;
+    
+    for (int i = 0; i < N; i++) {
+        P[i] += SQR(C[i][0]) + SQR(C[i][1]);
+        if (i >= M) continue;
+        if (P[i] > P_m) P_m = P[i];
+        P_s += P[i];
+    }
+    *P_max = P_m;
+    *P_sum = P_s;
 }
 
-//------------------------------------------------------------------------------
-//  Free IF data buffer.
-//
-//  args:
-//      buff     (I)  IF data buffer
-//
-//  return:
-//      none
-//
-void sdr_buff_free(sdr_buff_t *buff)
+// max and sum of partial block of correlation powers --------------------------
+static void pow_max_sum(const float *P, int M, float *P_max, double *P_sum)
 {
-    if (!buff) return;
-    sdr_free(buff->data);
-    sdr_free(buff);
+    for (int i = 0; i < M; i++) {
+        if (P[i] > *P_max) *P_max = P[i];
+        *P_sum += P[i];
+    }
 }
 
-//------------------------------------------------------------------------------
-//  Read digitalized IF (inter-frequency) data from file. Supported file format
-//  is signed byte (int8) for I-sampling (real-sampling) or interleaved singned
-//  byte for IQ-sampling (complex-sampling).
-//
-//  args:
-//      file     (I) Digitalized IF data file path
-//      fs       (I) Sampling frequency (Hz)
-//      IQ       (I) Sampling type (1: I-sampling, 2: IQ-sampling)
-//      T        (I) Sample period (s) (0: all samples)
-//      toff     (I) Time offset from the beginning (s)
-//
-//  return:
-//      IF data buffer (NULL: read error)
-//
-sdr_buff_t *sdr_read_data(const char *file, double fs, int IQ, double T,
-    double toff)
+// code NCO for a block of CODE_BLK samples -----------------------------------
+//  The code phase p of the block start is 32.32 fixed-point chips. Chips in the
+//  block are offsets from p with 24 fractional bits, so all SIMD variants
+//  generate the same replica.
+static void code_nco_blk(const sdr_code_pack_t *code, uint64_t p, uint32_t s,
+    int N, sdr_cpx16_t *code_res)
 {
-    size_t cnt = (T > 0.0) ? (size_t)(fs * T * IQ) : 0;
-    size_t off = (size_t)(fs * toff * IQ);
-    FILE *fp;
-    
-    if (!(fp = fopen(file, "rb"))) {
-        fprintf(stderr, "data read error %s\n", file);
-        return NULL;
-    }
-    // get file size
-    fseek(fp, 0, SEEK_END);
-#if defined(WIN32) || defined(MACOS)
-    fpos_t pos = 0;
-    fgetpos(fp, &pos);
-    size_t size = (size_t)pos;
-#else
-    fpos_t pos;
-    fgetpos(fp, &pos);
-    size_t size = (size_t)(pos.__pos);
-#endif
-    rewind(fp);
-    
-    if (cnt <= 0) {
-        cnt = size - off;
-    }
-    if (size < off + cnt) {
-        fclose(fp);
-        return NULL;
-    }
-    int8_t *raw = (int8_t *)sdr_malloc(cnt);
-#if defined(WIN32) || defined(MACOS)
-    pos = (size_t)off;
-    fsetpos(fp, &pos);
-#else
-    pos.__pos = (__off_t)off;
-    fsetpos(fp, &pos);
-#endif
-    
-    if (fread(raw, 1, cnt, fp) < cnt) {
-        fprintf(stderr, "data read error %s\n", file);
-        fclose(fp);
-        return NULL;
-    }
-    sdr_buff_t *buff = sdr_buff_new(cnt / IQ, IQ);
+    uint32_t f = (uint32_t)p >> 8;
+    int c0 = (int)(p >> 32);
     
-    if (IQ == 1) { // I-sampling
-        for (int i = 0; i < buff->N; i++) {
-            buff->data[i] = SDR_CPX8(raw[i], 0);
-        }
-    }
-    else { // IQ-sampling
-        for (int i = 0; i < buff->N; i++) {
-            buff->data[i] = SDR_CPX8(raw[i*2], raw[i*2+1]);
-        }
+    for (int i = 0; i < N; i++, f += s) {
+        int j = c0 + (int)(f >> 24);
+        if (j >= code->N) j -= code->N;
+        code_res[i].I = code_res[i].Q = (int8_t)SDR_CODE_CHIP(code, j);
     }
-    sdr_free(raw);
-    fclose(fp);
-    return buff;
 }
 
-//------------------------------------------------------------------------------
-//  Parallel code search in digitized IF data.
-//
-//  args:
-//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
-//      T        (I) Code cycle (period) (s)
-//      buff     (I) IF data buffer
-//      ix       (I) Index of sample data
-//      N        (I) length of sample data
-//      fs       (I) Sampling frequency (Hz)
-//      fi       (I) IF frequency (Hz)
-//      fds      (I) Doppler frequency bins as ndarray (Hz)
-//      len_fds  (I) length of Doppler frequency bins
-//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
-//                   space as float 2D-array (N x len_fs, N = (int)(fs * T))
-//
-//  return:
-//      none
-//
-void sdr_search_code(const sdr_cpx_t *code_fft, double T,
-    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
-    const float *fds, int len_fds, float *P)
+// code NCO --------------------------------------------------------------------
+static void code_nco_c(const sdr_code_pack_t *code, uint64_t p, uint64_t s,
+    int N, sdr_cpx16_t *code_res)
 {
-    sdr_cpx_t *C = sdr_cpx_malloc(N);
+    uint64_t L = (uint64_t)code->N << 32;
     
-    for (int i = 0; i < len_fds; i++) {
-        
-        // FFT correlator
-        sdr_corr_fft(buff, ix, N, fs, fi + fds[i], 0.0, code_fft, C);
-        
-        // add correlation power
-        for (int j = 0; j < N; j++) {
-            P[i*N+j] += SQR(C[j][0]) + SQR(C[j][1]); // abs(C[j]) ** 2
-        }
-        if (i % 22 == 21) { // release cpu
-            sdr_sleep_msec(1);
-        }
+    for (int i = 0; i < N; i += CODE_BLK) {
+        code_nco_blk(code, p, (uint32_t)(s >> 8), MIN(CODE_BLK, N - i),
+            code_res + i);
+        if ((p += s * CODE_BLK) >= L) p -= L;
     }
-    sdr_cpx_free(C);
 }
 
-// max correlation power and C/N0 ----------------------------------------------
-float sdr_corr_max(const float *P, int N, int Nmax, int M, double T, int *ix)
+// arctangent polynomial (Cephes) ---------------------------------------------
+//  atan(x) = x + x * z * P(z) / Q(z) with z = x^2 for |x| <= 0.66
+static const double atan_P[] = {
+    -8.750608600031904122785E-01, -1.615753718733365076637E+01,
+    -7.500855792314704667340E+01, -1.228866684490136173410E+02,
+    -6.485021904942025371773E+01
+};
+static const double atan_Q[] = {
+     2.485846490142306297962E+01,  1.650270098316988542046E+02,
+     4.328810604912902668951E+02,  4.853903996359136964868E+02,
+     1.945506571482613964425E+02
+};
+
+// four-quadrant arctangent ----------------------------------------------------
+//  z[i] = atan2(y[i], x[i]) for x[i] != 0 by range reduction to |t| <= 0.66
+//  and the rational polynomial. All SIMD variants evaluate the same
+//  operations.
+static void atan2_c(const double *y, const double *x, int n, double *z)
 {
-    double P_max = 0.0, P_ave = 0.0;
-    int n = 0;
-    
-    for (int i = 0; i < M; i++) {
-        for (int j = 0; j < Nmax; j++) {
-            P_ave += (P[i*N+j] - P_ave) / ++n;
-            if (P[i*N+j] <= P_max) continue;
-            P_max = P[i*N+j];
-            ix[0] = i; // index of doppler freq.
-            ix[1] = j; // index of code offset
+    for (int i = 0; i < n; i++) {
+        double t = fabs(y[i] / x[i]), a = 0.0, b = 0.0;
+        if (t > T3P8) {
+            a = PI / 2.0; b = MOREBITS; t = -1.0 / t;
+        }
+        else if (t > 0.66) {
+            a = PI / 4.0; b = 0.5 * MOREBITS; t = (t - 1.0) / (t + 1.0);
         }
+        double u = t * t;
+        double p = (((atan_P[0] * u + atan_P[1]) * u + atan_P[2]) * u +
+            atan_P[3]) * u + atan_P[4];
+        double q = ((((u + atan_Q[0]) * u + atan_Q[1]) * u + atan_Q[2]) * u +
+            atan_Q[3]) * u + atan_Q[4];
+        double r = a + (t * (u * p / q) + t + b);
+        r = (signbit(y[i]) != signbit(x[i])) ? -r : r;
+        if (x[i] < 0.0) r += signbit(y[i]) ? -PI : PI;
+        z[i] = r;
     }
-    return (P_ave > 0.0) ?
-        (float)(10.0 * log10((P_max - P_ave) / P_ave / T)) : 0.0f;
 }
 
-// polynomial fitting ----------------------------------------------------------
-static int poly_fit(const double *x, const double *y, int nx, int np, double *p)
+// unpack packed IF data -------------------------------------------------------
+//  Sample j of packed IF data is the 4-bit code in the low (j even) or high
+//  (j odd) nibble of data[j/2] converted to complex by LUT.
+static void unpack_pk_c(const uint8_t *data, const sdr_cpx8_t *LUT, int ix,
+    int N, sdr_cpx8_t *out)
 {
-    if (nx < np) {
-        return 0;
-    }
-    double *V = mat(np, nx), *Q = mat(np, np);
-    
-    for (int i = 0; i < nx; i++) { // Vandermonde matrix
-        for (int j = 0; j < np; j++) {
-            V[i*np+j] = (j == 0) ? 1.0 : V[i*np+j-1] * x[i];
-        }
+    for (int i = 0, j = ix; i < N; i++, j++) {
+        out[i] = LUT[(data[j >> 1] >> ((j & 1) << 2)) & 0xF];
     }
-    int stat = lsq(V, y, np, nx, p, Q);
-    free(V);
-    free(Q);
-    return !stat;
 }
 
-// fine Doppler frequency by quadratic fitting ---------------------------------
-double sdr_fine_dop(const float *P, int N, const float *fds, int len_fds,
-    const int *ix)
+// window IF data --------------------------------------------------------------
+//  out[i] = (I(data[i]) * w[i], Q(data[i]) * w[i]) for i = 0,...,N-1.
+static void win_cpx8_c(const sdr_cpx8_t *data, const float *w, int N,
+    sdr_cpx_t *out)
 {
-    if (ix[0] == 0 || ix[0] == len_fds - 1) {
-        return fds[ix[0]];
-    }
-    double x[3], y[3], p[3];
-    
-    for (int i = 0; i < 3; i++) {
-        x[i] = fds[ix[0]-1+i];
-        y[i] = P[(ix[0]-1+i)*N+ix[1]];
-    }
-    if (!poly_fit(x, y, 3, 3, p)) {
-        return fds[ix[0]];
+    for (int i = 0; i < N; i++) {
+        out[i][0] = SDR_CPX8_I(data[i]) * w[i];
+        out[i][1] = SDR_CPX8_Q(data[i]) * w[i];
     }
-    return -p[1] / (2.0 * p[2]);
 }
 
-// shift IF frequency for GLONASS FDMA -----------------------------------------
-double sdr_shift_freq(const char *sig, int fcn, double fi)
+// SIMD kernel dispatch --------------------------------------------------------
+static int simd_var = SDR_SIMD_C; // SIMD variant of kernels
+static int mix_var = SDR_MIX_LUT; // carrier mixer
+static const char *simd_name[] = {"c", "sse4", "avx2", "avx512", "neon"};
+static void (*mix_carr_p)(const uint8_t *, int, uint32_t, uint32_t,
+    sdr_cpx16_t *) = mix_carr_c;
+static void (*dot_IQ_code)(const sdr_cpx16_t *, const sdr_cpx16_t *, int,
+    int32_t *) = dot_IQ_code_c;
+static void (*cpx_mul)(const sdr_cpx_t *, const sdr_cpx_t *, int, float,
+    sdr_cpx_t *) = cpx_mul_c;
+static void (*code_nco)(const sdr_code_pack_t *, uint64_t, uint64_t, int,
+    sdr_cpx16_t *) = code_nco_c;
+static void (*pow_acc)(const sdr_cpx_t *, int, int, float *, float *,
+    double *) = pow_acc_c;
+static void (*atan2_p)(const double *, const double *, int, double *) =
+    atan2_c;
+static void (*unpack_pk_p)(const uint8_t *, const sdr_cpx8_t *, int, int,
+    sdr_cpx8_t *) = unpack_pk_c;
+static void (*win_cpx8)(const sdr_cpx8_t *, const float *, int, sdr_cpx_t *) =
+    win_cpx8_c;
+
+#if defined(AVX2)
+// mix carrier (SSE4) ----------------------------------------------------------
+SDR_TARGET_SSE4
+static void mix_carr_sse4(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
 {
-    if (!strcmp(sig, "G1CA")) {
-        fi += 0.5625e6 * fcn;
-    }
-    else if (!strcmp(sig, "G2CA")) {
-        fi += 0.4375e6 * fcn;
+    __m128i xp = _mm_set_epi32(p+s*3, p+s*2, p+s, p);
+    __m128i xs = _mm_set1_epi32(s*4);
+    const sdr_cpx16_t *tbl = mix_lut();
+    int i = 0;
+    
+    for ( ; i < N - 16; i += 4) {
+        int idx[4];
+        int dat;
+        memcpy(&dat, data + i, 4);
+        __m128i xdat = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(dat));
+        __m128i xidx = _mm_add_epi32(_mm_slli_epi32(xdat, 8),
+            _mm_srli_epi32(xp, 24));
+        _mm_storeu_si128((__m128i *)idx, xidx);
+        IQ[i  ] = tbl[idx[0]];
+        IQ[i+1] = tbl[idx[1]];
+        IQ[i+2] = tbl[idx[2]];
+        IQ[i+3] = tbl[idx[3]];
+        xp = _mm_add_epi32(xp, xs);
     }
-    return fi;
+    mix_carr_c(data + i, N - i, p + s * i, s, IQ + i);
 }
 
-// doppler search bins ---------------------------------------------------------
-float *sdr_dop_bins(double T, float dop, float max_dop, int *len_fds)
+// mix carrier (AVX2) ----------------------------------------------------------
+SDR_TARGET_AVX2
+static void mix_carr_avx2(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
 {
-    float *fds, step = DOP_STEP / T;
-    
-    *len_fds = (int)(2.0 * max_dop / step) + 1;
-    fds = (float *)sdr_malloc(sizeof(float) * (*len_fds));
-    
-    for (int i = 0; i < *len_fds; i++) {
-        fds[i] = dop - max_dop + i * step;
-    }
-    return fds;
-}
-
-// mix carrier -----------------------------------------------------------------
-static void mix_carr(const sdr_buff_t *buff, int ix, int N, double phi,
-    double step, sdr_cpx16_t *IQ)
-{
-    const uint8_t *data = buff->data + ix;
-    double scale = (double)(1 << 24) * NTBL;
-    uint32_t p = (uint32_t)((phi - floor(phi)) * scale);
-    uint32_t s = (uint32_t)(int)(step * scale);
-    int i = 0;
-#if defined(AVX2)
-    __m256i yp = _mm256_set_epi32(p+s*7, p+s*6, p+s*5, p+s*4, p+s*3, p+s*2, p+s, p);
-    __m256i ys = _mm256_set1_epi32(s*8);
+    __m256i yp = _mm256_set_epi32(p+s*7, p+s*6, p+s*5, p+s*4, p+s*3, p+s*2, p+s, p);
+    __m256i ys = _mm256_set1_epi32(s*8);
+    const sdr_cpx16_t *tbl = mix_lut();
+    int i = 0;
     
     for ( ; i < N - 16; i += 8) {
         int idx[8];
@@ -438,81 +466,136 @@ static void mix_carr(const sdr_buff_t *buff, int ix, int N, double phi,
         __m256i yidx = _mm256_add_epi32(_mm256_slli_epi32(ydat, 8),
             _mm256_srli_epi32(yp, 24));
         _mm256_storeu_si256((__m256i *)idx, yidx);
-        IQ[i  ] = mix_tbl[idx[0]];
-        IQ[i+1] = mix_tbl[idx[1]];
-        IQ[i+2] = mix_tbl[idx[2]];
-        IQ[i+3] = mix_tbl[idx[3]];
-        IQ[i+4] = mix_tbl[idx[4]];
-        IQ[i+5] = mix_tbl[idx[5]];
-        IQ[i+6] = mix_tbl[idx[6]];
-        IQ[i+7] = mix_tbl[idx[7]];
+        IQ[i  ] = tbl[idx[0]];
+        IQ[i+1] = tbl[idx[1]];
+        IQ[i+2] = tbl[idx[2]];
+        IQ[i+3] = tbl[idx[3]];
+        IQ[i+4] = tbl[idx[4]];
+        IQ[i+5] = tbl[idx[5]];
+        IQ[i+6] = tbl[idx[6]];
+        IQ[i+7] = tbl[idx[7]];
         yp = _mm256_add_epi32(yp, ys);
     }
-#endif
-    for (p += s * i; i < N; i++, p += s) {
-        int idx = ((int)data[i] << 8) + (p >> 24);
-        IQ[i] = mix_tbl[idx];
-    }
+    mix_carr_c(data + i, N - i, p + s * i, s, IQ + i);
 }
 
-void sdr_mix_carr(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
-    double phi, sdr_cpx16_t *IQ)
+// carrier of 8 samples by polynomial NCO (AVX2) ------------------------------
+SDR_TARGET_AVX2
+static void carr_nco_avx2(__m256i yp, __m256 *ycI, __m256 *ycQ)
 {
-    double step = fc / fs;
+    __m256i y1 = _mm256_set1_epi32(1), y2 = _mm256_set1_epi32(2);
+    __m256 yone = _mm256_set1_ps(1.0f);
     
-    if (ix + N <= buff->N) {
-        mix_carr(buff, ix, N, phi, step, IQ);
-    }
-    else { // across IF buffer boundary
-        int n = buff->N - ix;
-        mix_carr(buff, ix, n, phi, step, IQ);
-        mix_carr(buff, 0, N - n, phi + step * n, step, IQ + n);
-    }
+    __m256i yq = _mm256_srli_epi32(_mm256_add_epi32(yp,
+        _mm256_set1_epi32(1 << 29)), 30);
+    __m256 yx = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(yp,
+        _mm256_slli_epi32(yq, 30))), _mm256_set1_ps(NCO_SCALE));
+    __m256 yx2 = _mm256_mul_ps(yx, yx);
+    __m256 yc = _mm256_fmadd_ps(yx2, _mm256_set1_ps(NCO_C3),
+        _mm256_set1_ps(NCO_C2));
+    yc = _mm256_fmadd_ps(yx2, yc, _mm256_set1_ps(NCO_C1));
+    yc = _mm256_fmadd_ps(yx2, yc, yone);
+    __m256 ys = _mm256_fmadd_ps(yx2, _mm256_set1_ps(NCO_S3),
+        _mm256_set1_ps(NCO_S2));
+    ys = _mm256_fmadd_ps(yx2, ys, _mm256_set1_ps(NCO_S1));
+    ys = _mm256_mul_ps(yx, _mm256_fmadd_ps(yx2, ys, yone));
+    
+    // rotate by quadrant and negate sin for Q
+    __m256 ym = _mm256_castsi256_ps(_mm256_slli_epi32(yq, 31));
+    __m256 ycr = _mm256_blendv_ps(yc, ys, ym);
+    __m256 yci = _mm256_blendv_ps(ys, yc, ym);
+    ycr = _mm256_xor_ps(ycr, _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_and_si256(_mm256_add_epi32(yq, y1), y2), 30)));
+    yci = _mm256_xor_ps(yci, _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_xor_si256(_mm256_and_si256(yq, y2), y2), 30)));
+    *ycI = _mm256_mul_ps(ycr, _mm256_set1_ps(1.0f / SDR_CSCALE));
+    *ycQ = _mm256_mul_ps(yci, _mm256_set1_ps(1.0f / SDR_CSCALE));
 }
 
-// mix carrier for complex buffer ----------------------------------------------
-static void mix_carr_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
-    double fs, double fc, double phi, sdr_cpx16_t *IQ)
+// mix carrier by polynomial NCO (AVX2) ----------------------------------------
+//  The carrier of 8 samples is generated by the polynomial NCO at every
+//  NCO_BLK samples and rotated by the phase step of 8 samples in between.
+SDR_TARGET_AVX2
+static void mix_nco_avx2(const uint8_t *data, int N, uint32_t p, uint32_t s,
+    sdr_cpx16_t *IQ)
 {
-    sdr_buff_t *buff_cpx8 = sdr_buff_new(N, 2);
-    for (int i = 0, j = ix; i < N; i++, j = (j + 1) % len_buff) {
-        buff_cpx8->data[i] = SDR_CPX8((int8_t)buff[j][0], (int8_t)buff[j][1]);
+    __m256i yk = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32((int)s));
+    __m256i yff = _mm256_set1_epi32(0xFF);
+    float rI, rQ;
+    int i = 0;
+    
+    carr_nco(s * 8, &rI, &rQ); // rotator of 8 samples
+    __m256 yrI = _mm256_set1_ps(rI * SDR_CSCALE);
+    __m256 yrQ = _mm256_set1_ps(rQ * SDR_CSCALE);
+    __m256 ycI = _mm256_setzero_ps(), ycQ = _mm256_setzero_ps();
+    
+    for ( ; i < N - 7; i += 8) {
+        if (i % NCO_BLK == 0) {
+            carr_nco_avx2(_mm256_add_epi32(yk, _mm256_set1_epi32(
+                (int)(p + s * i))), &ycI, &ycQ);
+        }
+        // mix 4-bit IQ samples with carrier
+        __m256i yd = _mm256_cvtepu8_epi32(_mm_loadl_epi64((__m128i *)
+            (data + i)));
+        __m256 yI = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(yd,
+            28), 28));
+        __m256 yQ = _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(yd,
+            24), 28));
+        __m256i yoI = _mm256_cvtps_epi32(_mm256_fmsub_ps(yI, ycI,
+            _mm256_mul_ps(yQ, ycQ)));
+        __m256i yoQ = _mm256_cvtps_epi32(_mm256_fmadd_ps(yI, ycQ,
+            _mm256_mul_ps(yQ, ycI)));
+        __m256i yo = _mm256_or_si256(_mm256_and_si256(yoI, yff),
+            _mm256_slli_epi32(yoQ, 8));
+        yo = _mm256_permute4x64_epi64(_mm256_packs_epi32(yo, yo), 0x08);
+        _mm_storeu_si128((__m128i *)(IQ + i), _mm256_castsi256_si128(yo));
+        
+        // rotate carrier by phase step of 8 samples
+        __m256 ytI = _mm256_fmsub_ps(ycI, yrI, _mm256_mul_ps(ycQ, yrQ));
+        ycQ = _mm256_fmadd_ps(ycI, yrQ, _mm256_mul_ps(ycQ, yrI));
+        ycI = ytI;
     }
-    mix_carr(buff_cpx8, 0, N, phi, fc / fs, IQ);
-    sdr_buff_free(buff_cpx8);
+    mix_nco_c(data + i, N - i, p + s * i, s, IQ + i);
 }
 
-// sum of int16 fields ---------------------------------------------------------
-#if defined(AVX2)
-#define sum_s16(ymm, sum) { \
-    int16_t s[16]; \
-    _mm256_storeu_si256((__m256i *)s, ymm); \
-    ymm = _mm256_setzero_si256(); \
-    sum += s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7] + s[8] + s[9] \
-        + s[10] + s[11] + s[12] + s[13] + s[14] + s[15]; \
-}
-#elif defined(NEON)
-#define sum_s16(ymm, sum) { \
-    int16_t s[8]; \
-    vst1q_s16(s, ymm); \
-    ymm = vdupq_n_s16(0); \
-    sum += s[0] + s[1] + s[2] + s[3] + s[4] + s[5] + s[6] + s[7]; \
+// integer inner product of IQ data and code (SSE4) ----------------------------
+SDR_TARGET_SSE4
+static void dot_IQ_code_sse4(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, int32_t *sum)
+{
+    __m128i xsumI = _mm_setzero_si128();
+    __m128i xsumQ = _mm_setzero_si128();
+    __m128i xextI = _mm_set1_epi16(0x0001);
+    __m128i xextQ = _mm_set1_epi16(0x0100);
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        __m128i xdata = _mm_loadu_si128((__m128i *)(IQ + i));
+        __m128i xcode = _mm_loadu_si128((__m128i *)(code + i)); // {-1,0,1}
+        __m128i xcorr = _mm_sign_epi8(xdata, xcode); // IQ * code
+        xsumI = _mm_add_epi16(xsumI, _mm_maddubs_epi16(xextI, xcorr));
+        xsumQ = _mm_add_epi16(xsumQ, _mm_maddubs_epi16(xextQ, xcorr));
+    }
+    int32_t s[4];
+    __m128i xone = _mm_set1_epi16(1);
+    _mm_storeu_si128((__m128i *)s, _mm_hadd_epi32(_mm_madd_epi16(xsumI, xone),
+        _mm_madd_epi16(xsumQ, xone)));
+    sum[0] += s[0] + s[1];
+    sum[1] += s[2] + s[3];
+    dot_IQ_code_c(IQ + i, code + i, N - i, sum);
 }
-#endif
 
-// inner product of IQ data and code -------------------------------------------
-static void dot_IQ_code(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
-    float s, sdr_cpx_t *c)
+// integer inner product of IQ data and code (AVX2) ----------------------------
+SDR_TARGET_AVX2
+static void dot_IQ_code_avx2(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, int32_t *sum)
 {
-    int i = 0;
-    (*c)[0] = (*c)[1] = 0.0f;
-#if defined(AVX2)
     __m256i ysumI = _mm256_setzero_si256();
     __m256i ysumQ = _mm256_setzero_si256();
-    __m256i yextI = _mm256_set_epi8(0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1,
-        0,1,0,1,0,1,0,1, 0,1,0,1,0,1,0,1);
-    __m256i yextQ = _mm256_set_epi8(1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0,
-        1,0,1,0,1,0,1,0, 1,0,1,0,1,0,1,0);
+    __m256i yextI = _mm256_set1_epi16(0x0001);
+    __m256i yextQ = _mm256_set1_epi16(0x0100);
+    int i = 0;
     
     for ( ; i < N - 15; i += 16) {
         __m256i ydata = _mm256_loadu_si256((__m256i *)(IQ + i));
@@ -520,223 +603,2961 @@ static void dot_IQ_code(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
         __m256i ycorr = _mm256_sign_epi8(ydata, ycode); // IQ * code
         ysumI = _mm256_add_epi16(ysumI, _mm256_maddubs_epi16(yextI, ycorr));
         ysumQ = _mm256_add_epi16(ysumQ, _mm256_maddubs_epi16(yextQ, ycorr));
-        if (i % (16 * 256) == 0) {
-            sum_s16(ysumI, (*c)[0])
-            sum_s16(ysumQ, (*c)[1])
+    }
+    int32_t s[8];
+    __m256i yone = _mm256_set1_epi16(1);
+    __m256i ysum = _mm256_hadd_epi32(_mm256_madd_epi16(ysumI, yone),
+        _mm256_madd_epi16(ysumQ, yone));
+    _mm256_storeu_si256((__m256i *)s, ysum);
+    sum[0] += s[0] + s[1] + s[4] + s[5];
+    sum[1] += s[2] + s[3] + s[6] + s[7];
+    dot_IQ_code_c(IQ + i, code + i, N - i, sum);
+}
+
+// integer inner product of IQ data and code (AVX-512BW) -----------------------
+SDR_TARGET_AVX512
+static void dot_IQ_code_avx512(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, int32_t *sum)
+{
+    __m512i zsumI = _mm512_setzero_si512();
+    __m512i zsumQ = _mm512_setzero_si512();
+    __m512i zextI = _mm512_set1_epi16(0x0001);
+    __m512i zextQ = _mm512_set1_epi16(0x0100);
+    int i = 0;
+    
+    for ( ; i < N - 31; i += 32) {
+        __m512i zdata = _mm512_loadu_si512((__m512i *)(IQ + i));
+        __m512i zcode = _mm512_loadu_si512((__m512i *)(code + i)); // {-1,0,1}
+        __mmask64 mneg = _mm512_movepi8_mask(zcode);
+        __mmask64 mnz = _mm512_test_epi8_mask(zcode, zcode);
+        __m512i zcorr = _mm512_mask_sub_epi8(zdata, mneg,
+            _mm512_setzero_si512(), zdata);
+        zcorr = _mm512_maskz_mov_epi8(mnz, zcorr); // IQ * code
+        zsumI = _mm512_add_epi16(zsumI, _mm512_maddubs_epi16(zextI, zcorr));
+        zsumQ = _mm512_add_epi16(zsumQ, _mm512_maddubs_epi16(zextQ, zcorr));
+    }
+    __m512i zone = _mm512_set1_epi16(1);
+    int32_t s[2][16];
+    _mm512_storeu_si512((__m512i *)s[0], _mm512_madd_epi16(zsumI, zone));
+    _mm512_storeu_si512((__m512i *)s[1], _mm512_madd_epi16(zsumQ, zone));
+    for (int j = 0; j < 16; j++) {
+        sum[0] += s[0][j];
+        sum[1] += s[1][j];
+    }
+    dot_IQ_code_avx2(IQ + i, code + i, N - i, sum);
+}
+
+// multiplication of two complex arrays (SSE4) ---------------------------------
+SDR_TARGET_SSE4
+static void cpx_mul_sse4(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    __m128 xr = _mm_set_ps(-1, 1, -1, 1);
+    __m128 xs = _mm_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 1; i += 2) {
+        __m128 xa = _mm_loadu_ps((float *)(a + i));
+        __m128 xb = _mm_loadu_ps((float *)(b + i));
+        __m128 xc = _mm_mul_ps(xa, _mm_mul_ps(xb, xr));
+        __m128 xd = _mm_mul_ps(xa, _mm_shuffle_ps(xb, xb, 0xB1));
+        __m128 xh = _mm_hadd_ps(xc, xd);
+        __m128 xe = _mm_shuffle_ps(xh, xh, 0xD8);
+        _mm_storeu_ps((float *)(c + i), _mm_mul_ps(xe, xs));
+    }
+    cpx_mul_c(a + i, b + i, N - i, s, c + i);
+}
+
+// multiplication of two complex arrays (AVX2) ---------------------------------
+SDR_TARGET_AVX2
+static void cpx_mul_avx2(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    __m256 yr = _mm256_set_ps(-1, 1, -1, 1, -1, 1, -1, 1);
+    __m256 ys = _mm256_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 3; i += 4) {
+         __m256 ya = _mm256_loadu_ps((float *)(a + i));
+         __m256 yb = _mm256_loadu_ps((float *)(b + i));
+         __m256 yc = _mm256_mul_ps(ya, _mm256_mul_ps(yb, yr));
+         __m256 yd = _mm256_mul_ps(ya, _mm256_permute_ps(yb, 0xB1));
+         __m256 ye = _mm256_permute_ps(_mm256_hadd_ps(yc, yd), 0xD8);
+         _mm256_storeu_ps((float *)(c + i), _mm256_mul_ps(ye, ys));
+    }
+    cpx_mul_c(a + i, b + i, N - i, s, c + i);
+}
+
+// multiplication of two complex arrays (AVX-512) ------------------------------
+//  The zero-masked forms of the shuffles with the full mask are used instead
+//  of the unmasked ones, which merge an uninitialized vector falsely warned by
+//  GCC 12 (-Wmaybe-uninitialized).
+SDR_TARGET_AVX512
+static void cpx_mul_avx512(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    __m512 zs = _mm512_set1_ps(s);
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        __m512 za = _mm512_loadu_ps((float *)(a + i));
+        __m512 zb = _mm512_loadu_ps((float *)(b + i));
+        __m512 zc = _mm512_mul_ps(za,
+            _mm512_maskz_moveldup_ps(0xFFFF, zb)); // ar*br,ai*br
+        __m512 zd = _mm512_mul_ps(_mm512_maskz_permute_ps(0xFFFF, za, 0xB1),
+            _mm512_maskz_movehdup_ps(0xFFFF, zb)); // ai*bi,ar*bi
+        __m512 ze = _mm512_mask_add_ps(_mm512_sub_ps(zc, zd), 0xAAAA, zc, zd);
+        _mm512_storeu_ps((float *)(c + i), _mm512_mul_ps(ze, zs));
+    }
+    cpx_mul_avx2(a + i, b + i, N - i, s, c + i);
+}
+
+// accumulate correlation powers (AVX2) ----------------------------------------
+SDR_TARGET_AVX2
+static void pow_acc_avx2(const sdr_cpx_t *C, int N, int M, float *P,
+    float *P_max, double *P_sum)
+{
+    __m256 ymax = _mm256_setzero_ps();
+    __m256d ysum = _mm256_setzero_pd();
+    float P_m = 0.0f, m[8];
+    double P_s = 0.0, d[4];
+    int i = 0;
+    
+    for ( ; i < N - 7; i += 8) {
+        __m256 ya = _mm256_loadu_ps((float *)(C + i));
+        __m256 yb = _mm256_loadu_ps((float *)(C + i + 4));
+        __m256 yp = _mm256_hadd_ps(_mm256_mul_ps(ya, ya),
+            _mm256_mul_ps(yb, yb));
+        yp = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(yp),
+            0xD8)); // |C[i]|^2,...,|C[i+7]|^2
+        yp = _mm256_add_ps(_mm256_loadu_ps(P + i), yp);
+        _mm256_storeu_ps(P + i, yp);
+        if (i + 8 <= M) {
+            ymax = _mm256_max_ps(ymax, yp);
+            ysum = _mm256_add_pd(ysum, _mm256_add_pd(
+                _mm256_cvtps_pd(_mm256_castps256_ps128(yp)),
+                _mm256_cvtps_pd(_mm256_extractf128_ps(yp, 1))));
+        }
+        else if (i < M) {
+            pow_max_sum(P + i, M - i, &P_m, &P_s);
+        }
+    }
+    _mm256_storeu_ps(m, ymax);
+    _mm256_storeu_pd(d, ysum);
+    for (int j = 0; j < 8; j++) P_m = m[j] > P_m ? m[j] : P_m;
+    P_s += d[0] + d[1] + d[2] + d[3];
+    pow_acc_c(C + i, N - i, MAX(M - i, 0), P + i, P_max, P_sum);
+    *P_max = MAX(*P_max, P_m);
+    *P_sum += P_s;
+}
+
+// accumulate correlation powers (AVX-512) -------------------------------------
+//  The zero-masked forms with the full mask are used as cpx_mul_avx512().
+SDR_TARGET_AVX512
+static void pow_acc_avx512(const sdr_cpx_t *C, int N, int M, float *P,
+    float *P_max, double *P_sum)
+{
+    __m512i zie = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22,
+        24, 26, 28, 30);
+    __m512i zio = _mm512_add_epi32(zie, _mm512_set1_epi32(1));
+    __m512 zmax = _mm512_setzero_ps();
+    __m512d zsum = _mm512_setzero_pd();
+    float P_m = 0.0f;
+    double P_s = 0.0;
+    int i = 0;
+    
+    for ( ; i < N - 15; i += 16) {
+        __m512 za = _mm512_loadu_ps((float *)(C + i));
+        __m512 zb = _mm512_loadu_ps((float *)(C + i + 8));
+        __m512 zre = _mm512_permutex2var_ps(za, zie, zb);
+        __m512 zim = _mm512_permutex2var_ps(za, zio, zb);
+        __m512 zp = _mm512_add_ps(_mm512_mul_ps(zre, zre),
+            _mm512_mul_ps(zim, zim));
+        zp = _mm512_add_ps(_mm512_loadu_ps(P + i), zp);
+        _mm512_storeu_ps(P + i, zp);
+        if (i + 16 <= M) {
+            zmax = _mm512_maskz_max_ps(0xFFFF, zmax, zp);
+            __m512d zd = _mm512_castps_pd(zp);
+            __m256 ylo = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF,
+                zd, 0));
+            __m256 yhi = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF,
+                zd, 1));
+            zsum = _mm512_add_pd(zsum, _mm512_add_pd(
+                _mm512_maskz_cvtps_pd(0xFF, ylo),
+                _mm512_maskz_cvtps_pd(0xFF, yhi)));
+        }
+        else if (i < M) {
+            pow_max_sum(P + i, M - i, &P_m, &P_s);
         }
     }
-    sum_s16(ysumI, (*c)[0])
-    sum_s16(ysumQ, (*c)[1])
+    float m[16];
+    double d[8];
+    _mm512_storeu_ps(m, zmax);
+    _mm512_storeu_pd(d, zsum);
+    for (int j = 0; j < 16; j++) P_m = m[j] > P_m ? m[j] : P_m;
+    for (int j = 0; j < 8; j++) P_s += d[j];
+    pow_acc_avx2(C + i, N - i, MAX(M - i, 0), P + i, P_max, P_sum);
+    *P_max = MAX(*P_max, P_m);
+    *P_sum += P_s;
+}
+
 #elif defined(NEON)
+// integer inner product of IQ data and code (NEON) ----------------------------
+static void dot_IQ_code_neon(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code,
+    int N, int32_t *sum)
+{
     int16x8_t ysumI = vdupq_n_s16(0);
     int16x8_t ysumQ = vdupq_n_s16(0);
+    int i = 0;
     
     for ( ; i < N - 7; i += 8) {
         int8x8x2_t ydata = vld2_s8((int8_t *)(IQ + i));
         int8x8x2_t ycode = vld2_s8((int8_t *)(code + i));
         ysumI = vmlal_s8(ysumI, ydata.val[0], ycode.val[0]);
         ysumQ = vmlal_s8(ysumQ, ydata.val[1], ycode.val[1]);
-        if (i % (8 * 256) == 0) {
-            sum_s16(ysumI, (*c)[0])
-            sum_s16(ysumQ, (*c)[1])
-        }
     }
-    sum_s16(ysumI, (*c)[0])
-    sum_s16(ysumQ, (*c)[1])
-#endif
-    for ( ; i < N; i++) {
-        (*c)[0] += IQ[i].I * code[i].I;
-        (*c)[1] += IQ[i].Q * code[i].Q;
+    sum[0] += vaddlvq_s16(ysumI);
+    sum[1] += vaddlvq_s16(ysumQ);
+    dot_IQ_code_c(IQ + i, code + i, N - i, sum);
+}
+
+// multiplication of two complex arrays (NEON) ---------------------------------
+static void cpx_mul_neon(const sdr_cpx_t *a, const sdr_cpx_t *b, int N,
+    float s, sdr_cpx_t *c)
+{
+    int i = 0;
+    
+    for ( ; i < N - 3; i += 4) {
+        float32x4x2_t ya = vld2q_f32((float *)(a + i));
+        float32x4x2_t yb = vld2q_f32((float *)(b + i)), yc;
+        yc.val[0] = vmulq_n_f32(vsubq_f32(vmulq_f32(ya.val[0], yb.val[0]),
+            vmulq_f32(ya.val[1], yb.val[1])), s);
+        yc.val[1] = vmulq_n_f32(vaddq_f32(vmulq_f32(ya.val[0], yb.val[1]),
+            vmulq_f32(ya.val[1], yb.val[0])), s);
+        vst2q_f32((float *)(c + i), yc);
     }
-    (*c)[0] *= s * SDR_CSCALE;
-    (*c)[1] *= s * SDR_CSCALE;
+    cpx_mul_c(a + i, b + i, N - i, s, c + i);
 }
 
-// standard correlator ---------------------------------------------------------
-static void corr_std(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
-    const int *pos, int n, sdr_cpx_t *corr)
+// accumulate correlation powers (NEON) ----------------------------------------
+static void pow_acc_neon(const sdr_cpx_t *C, int N, int M, float *P,
+    float *P_max, double *P_sum)
 {
-    for (int i = 0; i < n; i++) {
-        if (pos[i] > 0) {
-            int M = N - pos[i];
-            dot_IQ_code(IQ + pos[i], code, M, 1.0f / M, corr + i);
-        }
-        else if (pos[i] < 0) {
-            int M = N + pos[i];
-            dot_IQ_code(IQ, code - pos[i], M, 1.0f / M, corr + i);
+    float32x4_t ymax = vdupq_n_f32(0.0f);
+    float P_m = 0.0f, m[4], p[4];
+    double P_s = 0.0;
+    int i = 0;
+    
+    for ( ; i < N - 3; i += 4) {
+        float32x4x2_t yc = vld2q_f32((float *)(C + i));
+        float32x4_t yp = vaddq_f32(vmulq_f32(yc.val[0], yc.val[0]),
+            vmulq_f32(yc.val[1], yc.val[1]));
+        yp = vaddq_f32(vld1q_f32(P + i), yp);
+        vst1q_f32(P + i, yp);
+        if (i + 4 <= M) {
+            ymax = vmaxq_f32(ymax, yp);
+            vst1q_f32(p, yp);
+            P_s += (double)p[0] + p[1] + p[2] + p[3];
         }
-        else {
-            dot_IQ_code(IQ, code, N, 1.0f / N, corr + i);
+        else if (i < M) {
+            pow_max_sum(P + i, M - i, &P_m, &P_s);
         }
     }
+    vst1q_f32(m, ymax);
+    for (int j = 0; j < 4; j++) P_m = m[j] > P_m ? m[j] : P_m;
+    pow_acc_c(C + i, N - i, MAX(M - i, 0), P + i, P_max, P_sum);
+    *P_max = MAX(*P_max, P_m);
+    *P_sum += P_s;
 }
+#endif // AVX2, NEON
 
-// mix carrier and standard correlator -----------------------------------------
-void sdr_corr_std(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
-    double phi, const sdr_cpx16_t *code, const int *pos, int n, sdr_cpx_t *corr)
+#if defined(AVX2)
+// code NCO (AVX2) -------------------------------------------------------------
+//  The code bits are gathered by 32 bits. The packed code has 4 bytes padding.
+SDR_TARGET_AVX2
+static void code_nco_avx2(const sdr_code_pack_t *code, uint64_t p, uint64_t s,
+    int N, sdr_cpx16_t *code_res)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
-    sdr_mix_carr(buff, ix, N, fs, fc, phi, IQ);
-    corr_std(IQ, code, N, pos, n, corr);
-    sdr_free(IQ);
+    uint64_t L = (uint64_t)code->N << 32;
+    uint32_t s8 = (uint32_t)(s >> 8);
+    __m256i yk = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32((int)s8));
+    __m256i yN = _mm256_set1_epi32(code->N);
+    __m256i yN1 = _mm256_set1_epi32(code->N - 1);
+    __m256i y1 = _mm256_set1_epi32(1), y7 = _mm256_set1_epi32(7);
+    __m256i yff = _mm256_set1_epi32(0xFF);
+    int i = 0;
+    
+    if (code->nz > 1 || code->zero) { // zero chips
+        code_nco_c(code, p, s, N, code_res);
+        return;
+    }
+    for ( ; i + CODE_BLK <= N; i += CODE_BLK) {
+        __m256i yf = _mm256_add_epi32(yk,
+            _mm256_set1_epi32((int)((uint32_t)p >> 8)));
+        __m256i yj = _mm256_add_epi32(_mm256_set1_epi32((int)(p >> 32)),
+            _mm256_srli_epi32(yf, 24));
+        yj = _mm256_sub_epi32(yj, _mm256_and_si256(_mm256_cmpgt_epi32(yj, yN1),
+            yN));
+        __m256i yw = _mm256_i32gather_epi32((const int *)code->bits,
+            _mm256_srli_epi32(yj, 3), 1);
+        __m256i yb = _mm256_and_si256(_mm256_srlv_epi32(yw,
+            _mm256_and_si256(yj, y7)), y1);
+        __m256i yc = _mm256_and_si256(_mm256_sub_epi32(_mm256_slli_epi32(yb, 1),
+            y1), yff); // I = Q = +1 or -1
+        yc = _mm256_or_si256(yc, _mm256_slli_epi32(yc, 8));
+        yc = _mm256_permute4x64_epi64(_mm256_packus_epi32(yc, yc), 0x08);
+        _mm_storeu_si128((__m128i *)(code_res + i), _mm256_castsi256_si128(yc));
+        if ((p += s * CODE_BLK) >= L) p -= L;
+    }
+    code_nco_c(code, p, s, N - i, code_res + i);
 }
 
-// mix carrier and standard correlator for complex buffer ----------------------
-void sdr_corr_std_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
-    double fs, double fc, double phi, const float *code, const int *pos, int n,
-    sdr_cpx_t *corr)
+// four-quadrant arctangent (AVX2) ---------------------------------------------
+SDR_TARGET_AVX2
+static void atan2_avx2(const double *y, const double *x, int n, double *z)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N * 2);
-    mix_carr_cpx(buff, len_buff, ix, N, fs, fc, phi, IQ);
-    for (int i = 0; i < N; i++) {
-        IQ[N+i].I = IQ[N+i].Q = (int8_t)code[i];
+    __m256d ysgn = _mm256_set1_pd(-0.0), yone = _mm256_set1_pd(1.0);
+    __m256d yzero = _mm256_setzero_pd(), ypi = _mm256_set1_pd(PI);
+    int i = 0;
+    
+    for ( ; i < n - 3; i += 4) {
+        __m256d yy = _mm256_loadu_pd(y + i), yx = _mm256_loadu_pd(x + i);
+        __m256d yt = _mm256_andnot_pd(ysgn, _mm256_div_pd(yy, yx)); // |y / x|
+        __m256d m1 = _mm256_cmp_pd(yt, _mm256_set1_pd(T3P8), _CMP_GT_OQ);
+        __m256d m2 = _mm256_andnot_pd(m1, _mm256_cmp_pd(yt,
+            _mm256_set1_pd(0.66), _CMP_GT_OQ));
+        __m256d ya = _mm256_blendv_pd(_mm256_blendv_pd(yzero,
+            _mm256_set1_pd(PI / 4.0), m2), _mm256_set1_pd(PI / 2.0), m1);
+        __m256d yb = _mm256_blendv_pd(_mm256_blendv_pd(yzero,
+            _mm256_set1_pd(0.5 * MOREBITS), m2), _mm256_set1_pd(MOREBITS), m1);
+        yt = _mm256_blendv_pd(_mm256_blendv_pd(yt,
+            _mm256_div_pd(_mm256_sub_pd(yt, yone), _mm256_add_pd(yt, yone)),
+            m2), _mm256_div_pd(_mm256_set1_pd(-1.0), yt), m1);
+        __m256d yu = _mm256_mul_pd(yt, yt);
+        __m256d yp = _mm256_set1_pd(atan_P[0]), yq = yu;
+        for (int j = 1; j < 5; j++) {
+            yp = _mm256_add_pd(_mm256_mul_pd(yp, yu),
+                _mm256_set1_pd(atan_P[j]));
+        }
+        for (int j = 0; j < 5; j++) {
+            yq = _mm256_add_pd(yq, _mm256_set1_pd(atan_Q[j]));
+            if (j < 4) yq = _mm256_mul_pd(yq, yu);
+        }
+        __m256d yr = _mm256_div_pd(_mm256_mul_pd(yu, yp), yq);
+        yr = _mm256_add_pd(ya, _mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(yt, yr), yt), yb));
+        yr = _mm256_or_pd(yr, _mm256_and_pd(ysgn, _mm256_xor_pd(yy, yx)));
+        __m256d mx = _mm256_cmp_pd(yx, yzero, _CMP_LT_OQ);
+        __m256d yadd = _mm256_or_pd(ypi, _mm256_and_pd(ysgn, yy)); // +/-PI
+        yr = _mm256_add_pd(yr, _mm256_and_pd(mx, yadd));
+        _mm256_storeu_pd(z + i, yr);
     }
-    corr_std(IQ, IQ + N, N, pos, n, corr);
-    sdr_free(IQ);
+    atan2_c(y + i, x + i, n - i, z + i);
+}
+
+// unpack packed IF data (AVX2) ------------------------------------------------
+SDR_TARGET_AVX2
+static void unpack_pk_avx2(const uint8_t *data, const sdr_cpx8_t *LUT, int ix,
+    int N, sdr_cpx8_t *out)
+{
+    int i = 0;
+    if ((ix & 1) && N > 0) { // align to byte of packed IF data
+        out[i++] = LUT[data[ix >> 1] >> 4];
+    }
+    __m256i yT = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *)LUT));
+    __m256i ymask = _mm256_set1_epi8(0x0F);
+    
+    for ( ; i < N - 63; i += 64) {
+        __m256i y = _mm256_loadu_si256((__m256i *)(data + ((ix + i) >> 1)));
+        __m256i ylo = _mm256_shuffle_epi8(yT, _mm256_and_si256(y, ymask));
+        __m256i yhi = _mm256_shuffle_epi8(yT,
+            _mm256_and_si256(_mm256_srli_epi16(y, 4), ymask));
+        __m256i y0 = _mm256_unpacklo_epi8(ylo, yhi);
+        __m256i y1 = _mm256_unpackhi_epi8(ylo, yhi);
+        _mm256_storeu_si256((__m256i *)(out + i),
+            _mm256_permute2x128_si256(y0, y1, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + i + 32),
+            _mm256_permute2x128_si256(y0, y1, 0x31));
+    }
+    unpack_pk_c(data, LUT, ix + i, N - i, out + i);
 }
 
-// get FFTW plan ---------------------------------------------------------------
-static int get_fftw_plan(int N, fftwf_plan *plan)
+// window IF data (AVX2) -------------------------------------------------------
+SDR_TARGET_AVX2
+static void win_cpx8_avx2(const sdr_cpx8_t *data, const float *w, int N,
+    sdr_cpx_t *out)
 {
-    static pthread_mutex_t mtx = PTHREAD_MUTEX_INITIALIZER;
+    int i = 0;
     
-    pthread_mutex_lock(&mtx);
+    for ( ; i < N - 7; i += 8) {
+        __m256i y = _mm256_cvtepi8_epi32(_mm_loadl_epi64(
+            (__m128i *)(data + i)));
+        __m256 yw = _mm256_loadu_ps(w + i);
+        __m256 yI = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(
+            _mm256_slli_epi32(y, 28), 28)), yw);
+        __m256 yQ = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(
+            _mm256_slli_epi32(y, 24), 28)), yw);
+        __m256 y0 = _mm256_unpacklo_ps(yI, yQ);
+        __m256 y1 = _mm256_unpackhi_ps(yI, yQ);
+        _mm256_storeu_ps((float *)(out + i),
+            _mm256_permute2f128_ps(y0, y1, 0x20));
+        _mm256_storeu_ps((float *)(out + i + 4),
+            _mm256_permute2f128_ps(y0, y1, 0x31));
+    }
+    win_cpx8_c(data + i, w + i, N - i, out + i);
+}
+#endif // AVX2
+
+// test CPU support of SIMD variant --------------------------------------------
+static int cpu_simd(int simd)
+{
+    switch (simd) {
+        case SDR_SIMD_C     : return 1;
+#if defined(AVX2)
+        case SDR_SIMD_SSE4  : return __builtin_cpu_supports("sse4.1");
+        case SDR_SIMD_AVX2  : return __builtin_cpu_supports("avx2") &&
+                                  __builtin_cpu_supports("fma");
+        case SDR_SIMD_AVX512: return __builtin_cpu_supports("avx512f") &&
+                                  __builtin_cpu_supports("avx512bw");
+#elif defined(NEON)
+        case SDR_SIMD_NEON  : return 1;
+#endif
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//  Set SIMD variant of carrier mixer, correlator and complex multiplication
+//  kernels. It should be called before starting any receiver threads.
+//
+//  args:
+//      simd     (I)  SIMD variant (SDR_SIMD_???, -1: best supported by CPU)
+//
+//  return:
+//      status (1: OK, 0: variant not supported by the library or CPU)
+//
+int sdr_set_simd(int simd)
+{
+    if (simd < 0) {
+        for (simd = SDR_SIMD_NEON; simd > SDR_SIMD_C && !cpu_simd(simd); ) {
+            simd--;
+        }
+    }
+    else if (!cpu_simd(simd)) {
+        return 0;
+    }
+    mix_carr_p  = mix_var == SDR_MIX_NCO ? mix_nco_c : mix_carr_c;
+    dot_IQ_code = dot_IQ_code_c;
+    cpx_mul     = cpx_mul_c;
+    code_nco    = code_nco_c;
+    pow_acc     = pow_acc_c;
+    atan2_p     = atan2_c;
+    unpack_pk_p = unpack_pk_c;
+    win_cpx8    = win_cpx8_c;
+#if defined(AVX2)
+    if (simd >= SDR_SIMD_SSE4 && mix_var == SDR_MIX_LUT) {
+        mix_carr_p  = mix_carr_sse4;
+    }
+    if (simd >= SDR_SIMD_SSE4) {
+        dot_IQ_code = dot_IQ_code_sse4;
+        cpx_mul     = cpx_mul_sse4;
+    }
+    if (simd >= SDR_SIMD_AVX2) {
+        mix_carr_p  = mix_var == SDR_MIX_NCO ? mix_nco_avx2 : mix_carr_avx2;
+        dot_IQ_code = dot_IQ_code_avx2;
+        cpx_mul     = cpx_mul_avx2;
+        code_nco    = code_nco_avx2;
+        pow_acc     = pow_acc_avx2;
+        atan2_p     = atan2_avx2;
+        unpack_pk_p = unpack_pk_avx2;
+        win_cpx8    = win_cpx8_avx2;
+    }
+    if (simd >= SDR_SIMD_AVX512) {
+        dot_IQ_code = dot_IQ_code_avx512;
+        cpx_mul     = cpx_mul_avx512;
+        pow_acc     = pow_acc_avx512;
+    }
+#elif defined(NEON)
+    if (simd >= SDR_SIMD_NEON) {
+        dot_IQ_code = dot_IQ_code_neon;
+        cpx_mul     = cpx_mul_neon;
+        pow_acc     = pow_acc_neon;
+    }
+#endif
+    simd_var = simd;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Get SIMD variant of kernels.
+//
+//  args:
+//      none
+//
+//  return:
+//      SIMD variant (SDR_SIMD_???)
+//
+int sdr_get_simd(void)
+{
+    return simd_var;
+}
+
+//------------------------------------------------------------------------------
+//  Set carrier mixer. The LUT mixer looks up the carrier-mixed data by the
+//  8-bit carrier phase. The polynomial NCO mixer generates the carrier by
+//  polynomials of the full 32-bit phase in SIMD registers and multiplies with
+//  the 4-bit IQ samples.
+//
+//  args:
+//      mix      (I)  Carrier mixer (SDR_MIX_LUT: LUT, SDR_MIX_NCO: NCO)
+//
+//  return:
+//      status (1: OK, 0: error)
+//
+int sdr_set_mix(int mix)
+{
+    if (mix != SDR_MIX_LUT && mix != SDR_MIX_NCO) return 0;
+    mix_var = mix;
+    return sdr_set_simd(simd_var);
+}
+
+// initialize SIMD kernels -----------------------------------------------------
+static void init_simd(void)
+{
+    const char *env = getenv("POCKET_SDR_SIMD");
     
-    for (int i = 0; i < MAX_FFTW_PLAN; i++) {
-        if (fftw_size[i] == 0) {
-            sdr_cpx_t *cpx1 = sdr_cpx_malloc(N);
-            sdr_cpx_t *cpx2 = sdr_cpx_malloc(N);
-            fftw_plans[i][0] = fftwf_plan_dft_1d(N, cpx1, cpx2, FFTW_FORWARD,  FFTW_FLAG);
-            fftw_plans[i][1] = fftwf_plan_dft_1d(N, cpx2, cpx1, FFTW_BACKWARD, FFTW_FLAG);
-            fftw_size[i] = N;
-            sdr_cpx_free(cpx1);
-            sdr_cpx_free(cpx2);
+    if (env && *env) {
+        int i = 0;
+        while (i <= SDR_SIMD_NEON && strcmp(env, simd_name[i])) i++;
+        if (i > SDR_SIMD_NEON) {
+            fprintf(stderr, "invalid SIMD variant: %s\n", env);
         }
-        if (fftw_size[i] == N) {
-            plan[0] = fftw_plans[i][0];
-            plan[1] = fftw_plans[i][1];
-            pthread_mutex_unlock(&mtx);
-            return 1;
+        else if (sdr_set_simd(i)) {
+            return;
+        }
+        else {
+            fprintf(stderr, "SIMD variant not supported: %s\n", env);
         }
     }
-    fprintf(stderr, "fftw plan buffer overflow N=%d\n", N);
-    pthread_mutex_unlock(&mtx);
-    return 0;
+    sdr_set_simd(-1);
 }
 
-// FFT correlator --------------------------------------------------------------
-static void corr_fft(const sdr_cpx16_t *IQ, const sdr_cpx_t *code_fft, int N,
-    sdr_cpx_t *corr)
+// initialize GNSS SDR functions -----------------------------------------------
+void sdr_func_init(const char *file)
 {
-    fftwf_plan plan[2];
+    // initilize log stream
+    strinitcom();
     
-    if (!get_fftw_plan(N, plan)) return;
-    sdr_cpx_t *cpx = sdr_cpx_malloc(N * 2);
-    for (int i = 0; i < N; i++) {
-        cpx[i][0] = IQ[i].I * SDR_CSCALE;
-        cpx[i][1] = IQ[i].Q * SDR_CSCALE;
+    // import FFTW wisdom
+    sdr_fftw_import(file);
+    
+    // generate carrier-mixed-data LUT
+    for (int i = 0; i < NTBL; i++) {
+        int8_t carr_I = (int8_t)ROUND(cos(-2.0 * PI * i / NTBL) / SDR_CSCALE);
+        int8_t carr_Q = (int8_t)ROUND(sin(-2.0 * PI * i / NTBL) / SDR_CSCALE);
+        for (int j = 0; j < 256; j++) {
+            int8_t I = SDR_CPX8_I(j), Q = SDR_CPX8_Q(j);
+            mix_tbl[(j << 8) + i].I = I * carr_I - Q * carr_Q;
+            mix_tbl[(j << 8) + i].Q = I * carr_Q + Q * carr_I;
+        }
     }
-    // ifft(fft(data) * code_fft) / N^2 
-    fftwf_execute_dft(plan[0], cpx, cpx + N);
-    sdr_cpx_mul(cpx + N, code_fft, N, 1.0f / N / N, cpx);
-    fftwf_execute_dft(plan[1], cpx, corr);
+    // select SIMD variant of kernels
+    init_simd();
     
-    sdr_cpx_free(cpx);
+    // enable escape sequence for Windows console
+    enable_console_esc();
 }
 
-// mix carrier and FFT correlator ----------------------------------------------
-void sdr_corr_fft(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
-    double phi, const sdr_cpx_t *code_fft, sdr_cpx_t *corr)
-{
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
-    sdr_mix_carr(buff, ix, N, fs, fc, phi, IQ);
-    corr_fft(IQ, code_fft, N, corr);
-    sdr_free(IQ);
+//------------------------------------------------------------------------------
+//  Allocate memory for complex array. If no memory allocated, it exits the AP
+//  immediately with an error message.
+//  
+//  args:
+//      N        (I)  Size of complex array
+//
+//  return:
+//      Complex array allocated.
+//
+sdr_cpx_t *sdr_cpx_malloc(int N)
+{
+    sdr_cpx_t *cpx;
+    
+    if (!(cpx = (sdr_cpx_t *)fftwf_malloc(sizeof(sdr_cpx_t) * N))) {
+        fprintf(stderr, "sdr_cpx_t memory allocation error N=%d\n", N);
+        exit(-1);
+    }
+    __atomic_add_fetch(&sdr_n_heap[0], 1, __ATOMIC_RELAXED);
+    return cpx;
+}
+
+//------------------------------------------------------------------------------
+//  Free memory allocated by sdr_cpx_malloc().
+//  
+//  args:
+//      cpx      (I)  Complex array
+//
+//  return:
+//      None
+//
+void sdr_cpx_free(sdr_cpx_t *cpx)
+{
+    if (!cpx) return;
+    __atomic_add_fetch(&sdr_n_heap[1], 1, __ATOMIC_RELAXED);
+    fftwf_free(cpx);
+}
+
+//------------------------------------------------------------------------------
+//  Absolute value of a complex.
+//  
+//  args:
+//      cpx      (I)  Complex value
+//
+//  return:
+//      | cpx |
+//
+float sdr_cpx_abs(sdr_cpx_t cpx)
+{
+    return sqrtf(SQR(cpx[0]) + SQR(cpx[1]));
+}
+
+//------------------------------------------------------------------------------
+//  Multiplication of two complex arrays.
+//  
+//  args:
+//      a, b     (I)  Complex arrays
+//      N        (I)  Size of complex arrays
+//      s        (I)  Scale
+//      c        (O)  Multiplication of a and b (c[i] = a[i] * b[i] * s)
+//
+//  return:
+//      None
+//
+void sdr_cpx_mul(const sdr_cpx_t *a, const sdr_cpx_t *b, int N, float s,
+    sdr_cpx_t *c)
+{
+    cpx_mul(a, b, N, s, c);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new IF data buffer.
+//
+//  args:
+//      N        (I)  Size of IF data buffer
+//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
+//
+//  return:
+//      IF data buffer
+//
+sdr_buff_t *sdr_buff_new(int N, int IQ)
+{
+    sdr_buff_t *buff = (sdr_buff_t *)sdr_malloc(sizeof(sdr_buff_t));
+    buff->data = (sdr_cpx8_t *)sdr_mem_alloc(sizeof(sdr_cpx8_t) * N, -1);
+    buff->N = N;
+    buff->IQ = IQ;
+    return buff;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new packed IF data buffer. Each sample is stored as a 4-bit code
+//  of 2-bit I and 2-bit Q (RAW8/RAW16 nibble format of Pocket SDR FE) and two
+//  samples are packed in a byte, sample j in the low (j even) or high (j odd)
+//  nibble of buff->data[j/2]. The carrier mixers read the packed IF data
+//  directly with half the memory and the memory bandwidth of sdr_buff_new().
+//
+//  args:
+//      N        (I)  Size of IF data buffer (samples)
+//      IQ       (I)  Sampling type (1: I-sampling, 2: IQ-sampling)
+//
+//  return:
+//      IF data buffer
+//
+sdr_buff_t *sdr_buff_new_pack(int N, int IQ)
+{
+    static const int8_t valI[] = {1, 3, -1, -3}, valQ[] = {-1, -3, 1, 3};
+    sdr_buff_t *buff = (sdr_buff_t *)sdr_malloc(sizeof(sdr_buff_t));
+    buff->data = (sdr_cpx8_t *)sdr_mem_alloc((N + 1) / 2, -1);
+    buff->N = N;
+    buff->IQ = IQ;
+    buff->pack = 1;
+    for (int i = 0; i < 16; i++) {
+        buff->LUT[i] = SDR_CPX8(valI[i & 0x3], IQ == 1 ? 0 : valQ[i >> 2]);
+    }
+    return buff;
+}
+
+//------------------------------------------------------------------------------
+//  Get a sample of IF data buffer.
+//
+//  args:
+//      buff     (I)  IF data buffer
+//      ix       (I)  Index of sample
+//
+//  return:
+//      IF data sample
+//
+sdr_cpx8_t sdr_buff_get(const sdr_buff_t *buff, int ix)
+{
+    if (!buff->pack) return buff->data[ix];
+    return buff->LUT[(buff->data[ix >> 1] >> ((ix & 1) << 2)) & 0xF];
+}
+
+//------------------------------------------------------------------------------
+//  Free IF data buffer.
+//
+//  args:
+//      buff     (I)  IF data buffer
+//
+//  return:
+//      none
+//
+void sdr_buff_free(sdr_buff_t *buff)
+{
+    if (!buff) return;
+    sdr_dft_cache_free(buff->dft);
+    sdr_mem_free(buff->data);
+    sdr_free(buff);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new data DFT cache. The data DFT cache is attached to an IF data
+//  buffer as buff->dft to share the data DFTs of the code search among the
+//  signals searched in the same window of the IF data buffer.
+//
+//  args:
+//      n        (I)  Number of cache slots
+//
+//  return:
+//      Data DFT cache
+//
+sdr_dft_cache_t *sdr_dft_cache_new(int n)
+{
+    sdr_dft_cache_t *cache = (sdr_dft_cache_t *)sdr_malloc(
+        sizeof(sdr_dft_cache_t));
+    cache->slot = (sdr_dft_slot_t *)sdr_malloc(sizeof(sdr_dft_slot_t) * n);
+    cache->n = n;
+    pthread_mutex_init(&cache->mtx, NULL);
+    pthread_cond_init(&cache->cond, NULL);
+    return cache;
+}
+
+//------------------------------------------------------------------------------
+//  Free data DFT cache.
+//
+//  args:
+//      cache    (I)  Data DFT cache (NULL: no operation)
+//
+//  return:
+//      none
+//
+void sdr_dft_cache_free(sdr_dft_cache_t *cache)
+{
+    if (!cache) return;
+    for (int i = 0; i < cache->n; i++) {
+        sdr_cpx_free(cache->slot[i].X);
+    }
+    pthread_mutex_destroy(&cache->mtx);
+    pthread_cond_destroy(&cache->cond);
+    sdr_free(cache->slot);
+    sdr_free(cache);
+}
+
+//------------------------------------------------------------------------------
+//  Invalidate data DFTs in data DFT cache of IF data buffer. It should be
+//  called before writing IF data to the IF data buffer.
+//
+//  args:
+//      buff     (I)  IF data buffer
+//      ix       (I)  Index of IF data to write
+//      N        (I)  Number of IF data to write
+//
+//  return:
+//      none
+//
+void sdr_dft_cache_inval(sdr_buff_t *buff, int ix, int N)
+{
+    sdr_dft_cache_t *cache = buff->dft;
+    
+    if (!cache) return;
+    pthread_mutex_lock(&cache->mtx);
+    for (int i = 0; i < cache->n; i++) {
+        sdr_dft_slot_t *slot = cache->slot + i;
+        if (slot->stat == 0 || slot->stat == 3) continue;
+        
+        // overlap of ring buffer ranges
+        if ((ix - slot->ix + buff->N) % buff->N < slot->N ||
+            (slot->ix - ix + buff->N) % buff->N < N) {
+            slot->stat = slot->stat == 1 ? 3 : 0;
+        }
+    }
+    pthread_mutex_unlock(&cache->mtx);
+}
+
+//------------------------------------------------------------------------------
+//  Read digitalized IF (inter-frequency) data from file. Supported file format
+//  is signed byte (int8) for I-sampling (real-sampling) or interleaved singned
+//  byte for IQ-sampling (complex-sampling).
+//
+//  args:
+//      file     (I) Digitalized IF data file path
+//      fs       (I) Sampling frequency (Hz)
+//      IQ       (I) Sampling type (1: I-sampling, 2: IQ-sampling)
+//      T        (I) Sample period (s) (0: all samples)
+//      toff     (I) Time offset from the beginning (s)
+//
+//  return:
+//      IF data buffer (NULL: read error)
+//
+sdr_buff_t *sdr_read_data(const char *file, double fs, int IQ, double T,
+    double toff)
+{
+    sdr_file_t *fp;
+    
+    if (!(fp = sdr_file_open(file))) {
+        fprintf(stderr, "data read error %s\n", file);
+        return NULL;
+    }
+    sdr_buff_t *buff = sdr_file_read_data(fp, fs, IQ, T, toff);
+    sdr_file_close(fp);
+    return buff;
+}
+
+//------------------------------------------------------------------------------
+//  Read digitalized IF (inter-frequency) data from opened IF data file as
+//  sdr_read_data(). The file read position is moved.
+//
+//  args:
+//      fp       (I) IF data file opened by sdr_file_open()
+//      fs       (I) Sampling frequency (Hz)
+//      IQ       (I) Sampling type (1: I-sampling, 2: IQ-sampling)
+//      T        (I) Sample period (s) (0: all samples)
+//      toff     (I) Time offset from the beginning (s)
+//
+//  return:
+//      IF data buffer (NULL: read error)
+//
+sdr_buff_t *sdr_file_read_data(sdr_file_t *fp, double fs, int IQ, double T,
+    double toff)
+{
+    int64_t cnt = (T > 0.0) ? (int64_t)(fs * T * IQ) : 0;
+    int64_t off = (int64_t)(fs * toff * IQ);
+    uint8_t *raw;
+    
+    if (cnt <= 0) {
+        cnt = fp->size - off;
+    }
+    if (fp->size < off + cnt || cnt / IQ > INT32_MAX ||
+        !sdr_file_seek(fp, off)) {
+        return NULL;
+    }
+    sdr_buff_t *buff = sdr_buff_new((int)(cnt / IQ), IQ);
+    
+    // convert data in chunks without a copy of whole raw data
+    for (int i = 0, n; i < buff->N; i += n) {
+        int size = MIN(buff->N - i, READ_CHUNK) * IQ;
+        
+        if (sdr_file_read(fp, size, &raw) < size) {
+            fprintf(stderr, "data read error\n");
+            sdr_buff_free(buff);
+            return NULL;
+        }
+        const int8_t *p = (const int8_t *)raw;
+        n = size / IQ;
+        if (IQ == 1) { // I-sampling
+            for (int j = 0; j < n; j++) {
+                buff->data[i+j] = SDR_CPX8(p[j], 0);
+            }
+        }
+        else { // IQ-sampling
+            for (int j = 0; j < n; j++) {
+                buff->data[i+j] = SDR_CPX8(p[j*2], p[j*2+1]);
+            }
+        }
+    }
+    return buff;
+}
+
+// new FFTW plan of N-point x M DFTs ------------------------------------------
+static fftwf_plan new_fftw_plan(int N, int M, int sign)
+{
+    sdr_cpx_t *cpx1 = sdr_cpx_malloc(N * M);
+    sdr_cpx_t *cpx2 = sdr_cpx_malloc(N * M);
+    int flag = FFTW_FLAG;
+    
+    if (N % 4) flag |= FFTW_UNALIGNED; // sub-arrays not SIMD-aligned
+    
+    // use wisdom if available, otherwise measure plan and add to wisdom
+    fftwf_plan plan = fftwf_plan_many_dft(1, &N, M, cpx1, NULL, 1, N, cpx2,
+        NULL, 1, N, sign, flag | FFTW_WISDOM_ONLY);
+    if (!plan) {
+        plan = fftwf_plan_many_dft(1, &N, M, cpx1, NULL, 1, N, cpx2, NULL, 1,
+            N, sign, flag);
+        fftw_wisdom_new = 1;
+    }
+    sdr_cpx_free(cpx1);
+    sdr_cpx_free(cpx2);
+    return plan;
+}
+
+// get FFTW plan (M: number of batched transforms) -----------------------------
+//  Cached plans are looked up without lock. New plans are measured and added to
+//  the head of the cache under lock. The plans of the FFT sizes in use are
+//  created by sdr_fftw_plan() or sdr_search_plan() when the channels and code
+//  books are generated, so the worker threads find them in the cache.
+static int get_fftw_plan(int N, int M, fftwf_plan *plan)
+{
+    fftw_plan_t *p = fftw_plan_last;
+    
+    if (!p || p->N != N || p->M != M) {
+        for (p = __atomic_load_n(&fftw_plans, __ATOMIC_ACQUIRE); p &&
+            (p->N != N || p->M != M); p = p->next) ;
+    }
+    if (!p) {
+        pthread_mutex_lock(&fftw_mtx);
+        for (p = fftw_plans; p && (p->N != N || p->M != M); p = p->next) ;
+        if (!p) {
+            p = (fftw_plan_t *)sdr_malloc(sizeof(fftw_plan_t));
+            p->N = N;
+            p->M = M;
+            p->plan[0] = new_fftw_plan(N, M, FFTW_FORWARD);
+            p->plan[1] = new_fftw_plan(N, M, FFTW_BACKWARD);
+            if (!p->plan[0] || !p->plan[1]) {
+                fprintf(stderr, "fftw plan error N=%d M=%d\n", N, M);
+                sdr_free(p);
+                pthread_mutex_unlock(&fftw_mtx);
+                return 0;
+            }
+            p->next = fftw_plans;
+            __atomic_store_n(&fftw_plans, p, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&fftw_mtx);
+    }
+    fftw_plan_last = p;
+    if (plan) {
+        plan[0] = p->plan[0];
+        plan[1] = p->plan[1];
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Get FFTW plans of N-point x M DFTs. The plans are measured at the first call
+//  and cached. Call it for the FFT sizes in use before the worker threads run.
+//
+//  args:
+//      N        (I) FFT size
+//      M        (I) Number of batched transforms
+//      plan     (O) FFTW plans {forward, backward} (NULL: no output)
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_fftw_plan(int N, int M, fftwf_plan *plan)
+{
+    return get_fftw_plan(N, M, plan);
+}
+
+// number of batched IFFTs in code search --------------------------------------
+//  It is rounded down to a power of 2 to bound the FFTW plans in use.
+static int batch_size(int N, int len_fds)
+{
+    int M = 1, M_max = N > 0 ? MIN(len_fds, MAX_FFT_BATCH / N + 1) : 1;
+    
+    while (M * 2 <= M_max) M *= 2;
+    return M;
+}
+
+//------------------------------------------------------------------------------
+//  Generate FFTW plans of parallel code search by sdr_search_code() or
+//  sdr_search_code_dec() for up to len_fds Doppler bins.
+//
+//  args:
+//      N        (I) FFT size (N for sdr_search_code(), N / D for
+//                   sdr_search_code_dec())
+//      len_fds  (I) Max number of Doppler bins
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_search_plan(int N, int len_fds)
+{
+    if (N <= 0 || !get_fftw_plan(N, 1, NULL)) return 0;
+    
+    for (int M = 2; M <= batch_size(N, len_fds); M *= 2) {
+        if (!get_fftw_plan(N, M, NULL)) return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Import FFTW wisdom file. The file is imported once and exported by
+//  sdr_fftw_export() with the wisdom of the plans measured after the import.
+//
+//  args:
+//      file     (I) FFTW wisdom file ("": no wisdom file)
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_fftw_import(const char *file)
+{
+    int stat = 1;
+    
+    pthread_mutex_lock(&fftw_mtx);
+    if (*file && strcmp(file, fftw_wisdom)) {
+        snprintf(fftw_wisdom, sizeof(fftw_wisdom), "%s", file);
+        if (!(stat = fftwf_import_wisdom_from_filename(file))) {
+            fprintf(stderr, "FFTW wisdom import error %s\n", file);
+        }
+    }
+    pthread_mutex_unlock(&fftw_mtx);
+    return stat;
+}
+
+//------------------------------------------------------------------------------
+//  Export FFTW wisdom to the file imported by sdr_fftw_import() if new plans
+//  were measured. The wisdom is written to a temporary file and renamed.
+//
+//  args:
+//      none
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_fftw_export(void)
+{
+    char tmp[1040];
+    int stat = 1;
+    
+    pthread_mutex_lock(&fftw_mtx);
+    if (*fftw_wisdom && fftw_wisdom_new) {
+        snprintf(tmp, sizeof(tmp), "%s.tmp", fftw_wisdom);
+#if defined(WIN32)
+        stat = fftwf_export_wisdom_to_filename(tmp) &&
+            (remove(fftw_wisdom), !rename(tmp, fftw_wisdom));
+#else
+        stat = fftwf_export_wisdom_to_filename(tmp) &&
+            !rename(tmp, fftw_wisdom);
+#endif
+        if (stat) {
+            fftw_wisdom_new = 0;
+        }
+        else {
+            fprintf(stderr, "FFTW wisdom export error %s\n", fftw_wisdom);
+            remove(tmp);
+        }
+    }
+    pthread_mutex_unlock(&fftw_mtx);
+    return stat;
+}
+
+// data DFT of IF data mixed with carrier --------------------------------------
+static void data_dft(const sdr_buff_t *buff, int ix, int N, double fs,
+    double fc, fftwf_plan plan, sdr_cpx16_t *IQ, sdr_cpx_t *X, sdr_cpx_t *Y)
+{
+    sdr_mix_carr(buff, ix, N, fs, fc, 0.0, IQ);
+    for (int j = 0; j < N; j++) {
+        X[j][0] = IQ[j].I * SDR_CSCALE;
+        X[j][1] = IQ[j].Q * SDR_CSCALE;
+    }
+    fftwf_execute_dft(plan, X, Y);
+}
+
+// get data DFT from data DFT cache -------------------------------------------
+//  A cached data DFT mixed with carrier frequency fc' is used for fc if
+//  (fc - fc') / df is an integer. The shift (fc - fc') / df is output by *sft.
+//  A data DFT not in cache is computed directly into a free slot. The return
+//  value points to the cached data DFT in the slot *p_slot, which stays valid
+//  until released by dft_put(). NULL is returned if no slot is free.
+static const sdr_cpx_t *dft_get(const sdr_buff_t *buff, int ix, int N,
+    double fs, double fc, fftwf_plan plan, sdr_cpx16_t *IQ, sdr_cpx_t *X,
+    sdr_dft_slot_t **p_slot, int *sft)
+{
+    sdr_dft_cache_t *cache = buff->dft;
+    sdr_dft_slot_t *slot = NULL;
+    double df = fs / N;
+    
+    pthread_mutex_lock(&cache->mtx);
+    for (int retry = 1; retry; ) {
+        retry = 0;
+        slot = NULL;
+        for (int i = 0; i < cache->n; i++) {
+            sdr_dft_slot_t *p = cache->slot + i;
+            double s = (fc - p->fc) / df;
+            if ((p->stat == 1 || p->stat == 2) && p->ix == ix && p->N == N &&
+                fabs(s - ROUND(s)) <= 1E-3) {
+                *sft = (((int)ROUND(s) % N) + N) % N;
+                slot = p;
+                break;
+            }
+        }
+        if (slot) {
+            slot->ref++;
+            while (slot->stat == 1) {
+                pthread_cond_wait(&cache->cond, &cache->mtx);
+            }
+            if (slot->stat != 2) { // invalidated while computing
+                slot->ref--;
+                retry = 1;
+                continue;
+            }
+            slot->tick = ++cache->tick;
+            cache->nhit++;
+            pthread_mutex_unlock(&cache->mtx);
+            *p_slot = slot;
+            return slot->X;
+        }
+    }
+    // least recently used free slot
+    for (int i = 0; i < cache->n; i++) {
+        sdr_dft_slot_t *p = cache->slot + i;
+        if (p->ref > 0 || p->stat == 1 || p->stat == 3) continue;
+        if (!slot || p->stat == 0 || (slot->stat != 0 &&
+            (int32_t)(p->tick - slot->tick) < 0)) {
+            slot = p;
+        }
+    }
+    cache->nmiss++;
+    if (!slot) { // no free slot
+        pthread_mutex_unlock(&cache->mtx);
+        return NULL;
+    }
+    slot->ix = ix;
+    slot->N = N;
+    slot->fc = fc;
+    slot->stat = 1;
+    slot->ref = 1;
+    slot->tick = ++cache->tick;
+    pthread_mutex_unlock(&cache->mtx);
+    
+    // compute data DFT out of lock
+    if (slot->size < N) {
+        sdr_cpx_free(slot->X);
+        slot->X = sdr_cpx_malloc(N);
+        slot->size = N;
+    }
+    data_dft(buff, ix, N, fs, fc, plan, IQ, X, slot->X);
+    *sft = 0;
+    
+    pthread_mutex_lock(&cache->mtx);
+    slot->stat = slot->stat == 1 ? 2 : 0;
+    pthread_cond_broadcast(&cache->cond);
+    pthread_mutex_unlock(&cache->mtx);
+    *p_slot = slot;
+    return slot->X;
+}
+
+// release data DFT of data DFT cache ------------------------------------------
+static void dft_put(const sdr_buff_t *buff, sdr_dft_slot_t *slot)
+{
+    pthread_mutex_lock(&buff->dft->mtx);
+    slot->ref--;
+    pthread_mutex_unlock(&buff->dft->mtx);
+}
+
+// code-shifted data DFT multiplied by code DFT --------------------------------
+static void shift_mul(const sdr_cpx_t *X, const sdr_cpx_t *code_fft, int N,
+    int s, sdr_cpx_t *c)
+{
+    sdr_cpx_mul(X + s, code_fft, N - s, 1.0f / N / N, c);
+    sdr_cpx_mul(X, code_fft + N - s, s, 1.0f / N / N, c + N - s);
+}
+
+// first max correlation power in Doppler bins and C/N0 ------------------------
+static float corr_max_bins(const float *P, int N, int Nmax, int len_fds,
+    const float *P_max, const double *P_sum, double T, int *ixp)
+{
+    float P_m = 0.0f;
+    double P_s = 0.0;
+    
+    // first max in the order of Doppler bins and code offsets
+    for (int i = 0; i < len_fds; i++) {
+        P_s += P_sum[i];
+        if (P_max[i] <= P_m) continue;
+        P_m = P_max[i];
+        ixp[0] = i;
+        for (ixp[1] = 0; P[i*N+ixp[1]] != P_m; ixp[1]++) ;
+    }
+    double P_ave = P_s / ((double)len_fds * Nmax);
+    
+    return (P_ave > 0.0) ?
+        (float)(10.0 * log10((P_m - P_ave) / P_ave / T)) : 0.0f;
+}
+
+// parallel code search -------------------------------------------------------
+//  The max and the sum of the accumulated correlation powers P[i*N+j] for
+//  j = 0,...,Nmax-1 are output by P_max[i] and P_sum[i] for Doppler bin i.
+//  If C_out is not NULL, the complex correlations are output by
+//  C_out[i*Nmax+j] instead of accumulating the correlation powers.
+static void search_code(const sdr_cpx_t *code_fft, const sdr_buff_t *buff,
+    int ix, int N, double fs, double fi, const float *fds, int len_fds,
+    float *P, int Nmax, float *P_max, double *P_sum, sdr_cpx_t *C_out)
+{
+    fftwf_plan plan[2], plan_b[2];
+    int M = batch_size(N, len_fds);
+    
+    if (len_fds <= 0 || !get_fftw_plan(N, 1, plan) ||
+        !get_fftw_plan(N, M, plan_b)) {
+        return;
+    }
+    double df = fs / N; // FFT bin width (Hz)
+    sdr_cpx_t *X = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 2);
+    sdr_cpx_t *C = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) *
+        N * M * 2);
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
+    int *bin = (int *)sdr_scratch_alloc(sizeof(int) * len_fds * 3);
+    int *sft = bin + len_fds, *done = bin + len_fds * 2;
+    memset(done, 0, sizeof(int) * len_fds);
+    
+    for (int i = 0; i < len_fds; i++) {
+        if (done[i]) continue;
+        
+        // data DFT for the residual-frequency sub-bin of fds[i]
+        sdr_dft_slot_t *slot = NULL;
+        const sdr_cpx_t *Xd;
+        int sft0 = 0;
+        if (!buff->dft || !(Xd = dft_get(buff, ix, N, fs, fi + fds[i],
+            plan[0], IQ, X, &slot, &sft0))) {
+            data_dft(buff, ix, N, fs, fi + fds[i], plan[0], IQ, X, X + N);
+            Xd = X + N;
+        }
+        
+        // Doppler bins in the sub-bin as circular shifts of the data DFT
+        int n = 0;
+        for (int j = i; j < len_fds; j++) {
+            double s = (fds[j] - fds[i]) / df;
+            if (done[j] || fabs(s - ROUND(s)) > 1E-3) continue;
+            bin[n] = j;
+            sft[n++] = (((int)ROUND(s) % N) + N + sft0) % N;
+            done[j] = 1;
+        }
+        // batched ifft(shift(fft(data)) * code_fft) / N^2
+        for (int j = 0; j < n; j += M) {
+            int m = MIN(n - j, M);
+            for (int k = 0; k < m; k++) {
+                shift_mul(Xd, code_fft, N, sft[j+k], C + N * k);
+            }
+            if (m == M) {
+                fftwf_execute_dft(plan_b[1], C, C + N * M);
+            }
+            else {
+                for (int k = 0; k < m; k++) {
+                    fftwf_execute_dft(plan[1], C + N * k, C + N * (M + k));
+                }
+            }
+            // accumulate correlation powers with max and sum
+            for (int k = 0; k < m; k++) {
+                int b = bin[j+k];
+                if (C_out) {
+                    memcpy(C_out + b * Nmax, C + N * (M + k),
+                        sizeof(sdr_cpx_t) * Nmax);
+                    continue;
+                }
+                pow_acc(C + N * (M + k), N, Nmax, P + b * N, P_max + b,
+                    P_sum + b);
+            }
+        }
+        if (slot) dft_put(buff, slot);
+    }
+    sdr_scratch_free(X);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in digitized IF data.
+//
+//  args:
+//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
+//      T        (I) Code cycle (period) (s)
+//      buff     (I) IF data buffer
+//      ix       (I) Index of sample data
+//      N        (I) length of sample data
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz)
+//      fds      (I) Doppler frequency bins as ndarray (Hz)
+//      len_fds  (I) length of Doppler frequency bins
+//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
+//                   space as float 2D-array (N x len_fs, N = (int)(fs * T))
+//
+//  return:
+//      none
+//
+void sdr_search_code(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P)
+{
+    float *P_max = (float *)sdr_scratch_alloc(sizeof(float) * len_fds);
+    double *P_sum = (double *)sdr_scratch_alloc(sizeof(double) * len_fds);
+    
+    search_code(code_fft, buff, ix, N, fs, fi, fds, len_fds, P, 0, P_max,
+        P_sum, NULL);
+    sdr_scratch_free(P_max);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in digitized IF data with max correlation power. The
+//  max correlation power is searched in the accumulation of the correlation
+//  powers without another sweep of P. It gives the same results as
+//  sdr_search_code() followed by sdr_corr_max().
+//
+//  args:
+//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
+//      T        (I) Code cycle (period) (s)
+//      buff     (I) IF data buffer
+//      ix       (I) Index of sample data
+//      N        (I) length of sample data
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz)
+//      fds      (I) Doppler frequency bins as ndarray (Hz)
+//      len_fds  (I) length of Doppler frequency bins
+//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
+//                   space as float 2D-array (N x len_fs, N = (int)(fs * T))
+//      Nmax     (I) Max number of code offsets to search max power
+//      ixp      (O) Index of max correlation power (ixp[0]: Doppler bin,
+//                   ixp[1]: code offset)
+//
+//  return:
+//      C/N0 (dB-Hz)
+//
+float sdr_search_code_max(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P, int Nmax, int *ixp)
+{
+    float *P_max = (float *)sdr_scratch_alloc(sizeof(float) * len_fds);
+    double *P_sum = (double *)sdr_scratch_alloc(sizeof(double) * len_fds);
+    
+    memset(P_max, 0, sizeof(float) * len_fds);
+    memset(P_sum, 0, sizeof(double) * len_fds);
+    search_code(code_fft, buff, ix, N, fs, fi, fds, len_fds, P, Nmax, P_max,
+        P_sum, NULL);
+    float cn0 = corr_max_bins(P, N, Nmax, len_fds, P_max, P_sum, T, ixp);
+    sdr_scratch_free(P_max);
+    return cn0;
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in digitized IF data with complex correlations. The
+//  complex correlations are output instead of the correlation powers for the
+//  coherent integration over code cycles. The carrier phase of the
+//  correlations is referenced to the first sample of the IF data.
+//
+//  args:
+//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
+//      T        (I) Code cycle (period) (s)
+//      buff     (I) IF data buffer
+//      ix       (I) Index of sample data
+//      N        (I) length of sample data
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz)
+//      fds      (I) Doppler frequency bins as ndarray (Hz)
+//      len_fds  (I) length of Doppler frequency bins
+//      Nmax     (I) Number of code offsets output (Nmax <= N)
+//      C        (O) Complex correlations in the Doppler frequencies - Code
+//                   offset space as complex 2D-array (Nmax x len_fds)
+//
+//  return:
+//      none
+//
+void sdr_search_code_cpx(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, int Nmax, sdr_cpx_t *C)
+{
+    search_code(code_fft, buff, ix, N, fs, fi, fds, len_fds, NULL, Nmax, NULL,
+        NULL, C);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search in complex IF data array. The IF data is converted to
+//  the IF data buffer once and all of the Doppler frequency bins are searched
+//  by sdr_search_code() in a call. The correlation powers are accumulated to
+//  P for the non-coherent integration.
+//
+//  args:
+//      code_fft (I) Code DFT (with or w/o zero-padding) as complex array
+//      T        (I) Code cycle (period) (s)
+//      buff     (I) IF data as complex array
+//      len_buff (I) Length of IF data
+//      ix       (I) Index of sample data
+//      N        (I) length of sample data
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz)
+//      fds      (I) Doppler frequency bins (Hz)
+//      len_fds  (I) length of Doppler frequency bins
+//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
+//                   space as float 2D-array (M x len_fs, M = (int)(fs * T))
+//
+//  return:
+//      none
+//
+void sdr_search_code_buff_cpx(const sdr_cpx_t *code_fft, double T,
+    const sdr_cpx_t *buff, int len_buff, int ix, int N, double fs, double fi,
+    const float *fds, int len_fds, float *P)
+{
+    int M = MIN((int)(fs * T), N);
+    
+    if (N <= 0 || len_buff <= 0 || len_fds <= 0) return;
+    sdr_buff_t buff_cpx8 = {0};
+    buff_cpx8.data = (sdr_cpx8_t *)sdr_scratch_alloc(sizeof(sdr_cpx8_t) * N);
+    buff_cpx8.N = N;
+    buff_cpx8.IQ = 2;
+    for (int i = 0, j = ix % len_buff; i < N; i++, j = (j + 1) % len_buff) {
+        buff_cpx8.data[i] = SDR_CPX8((int8_t)buff[j][0], (int8_t)buff[j][1]);
+    }
+    float *P_N = (float *)sdr_scratch_alloc(sizeof(float) * N * len_fds);
+    memset(P_N, 0, sizeof(float) * N * len_fds);
+    sdr_search_code(code_fft, T, &buff_cpx8, 0, N, fs, fi, fds, len_fds, P_N);
+    for (int i = 0; i < len_fds; i++) {
+        for (int j = 0; j < M; j++) {
+            P[i*M+j] += P_N[i*N+j];
+        }
+    }
+    sdr_scratch_free(buff_cpx8.data);
+}
+
+// decimated data DFT of IF data mixed with carrier ----------------------------
+//  The IF data is decimated by the sums of D samples after mixed with carrier.
+static void data_dft_dec(const sdr_buff_t *buff, int ix, int N, int D,
+    double fs, double fc, fftwf_plan plan, sdr_cpx16_t *IQ, sdr_cpx_t *X)
+{
+    int M = N / D;
+    
+    sdr_mix_carr(buff, ix, N, fs, fc, 0.0, IQ);
+    for (int j = 0; j < M; j++) {
+        int I = 0, Q = 0;
+        for (int k = j * D; k < (j + 1) * D; k++) {
+            I += IQ[k].I;
+            Q += IQ[k].Q;
+        }
+        X[j][0] = I * SDR_CSCALE;
+        X[j][1] = Q * SDR_CSCALE;
+    }
+    fftwf_execute_dft(plan, X, X + M);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search of partial code in decimated IF data. The IF data is
+//  mixed with the carrier of the first Doppler bin and decimated by D. The
+//  decimated data is correlated with the partial code of the first part of
+//  the code cycle. The other Doppler bins are searched by the circular shifts
+//  of the data DFT, so the differences of the Doppler bins should be integer
+//  multiples of fs / N. The correlation powers are accumulated to P for the
+//  non-coherent integration. The cost of the search is reduced by the
+//  decimation and the wider Doppler bins of the partial code.
+//
+//  args:
+//      code_fft (I) DFT of partial code resampled in fs / D and zero-padded to
+//                   N / D as complex array
+//      T        (I) Partial code length (s)
+//      buff     (I) IF data buffer
+//      ix       (I) Index of sample data
+//      N        (I) length of sample data (multiple of D)
+//      D        (I) Decimation factor
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz)
+//      fds      (I) Doppler frequency bins (Hz)
+//      len_fds  (I) length of Doppler frequency bins
+//      P        (IO) Correlation powers in the Doppler frequencies - Code offset
+//                   space as float 2D-array (N / D x len_fds). The code
+//                   offsets are in decimated samples.
+//      Nmax     (I) Max number of code offsets to search max power
+//      ixp      (O) Index of max correlation power (ixp[0]: Doppler bin,
+//                   ixp[1]: code offset) (NULL: no search of max power)
+//
+//  return:
+//      C/N0 (dB-Hz) (0.0: no search of max power)
+//
+float sdr_search_code_dec(const sdr_cpx_t *code_fft, double T,
+    const sdr_buff_t *buff, int ix, int N, int D, double fs, double fi,
+    const float *fds, int len_fds, float *P, int Nmax, int *ixp)
+{
+    fftwf_plan plan[2], plan_b[2];
+    int M = N / D, L = batch_size(M, len_fds);
+    float cn0 = 0.0f;
+    
+    if (M <= 0 || len_fds <= 0 || !get_fftw_plan(M, 1, plan) ||
+        !get_fftw_plan(M, L, plan_b)) {
+        return 0.0f;
+    }
+    double df = fs / N; // DFT bin width (Hz)
+    sdr_cpx_t *X = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * M * 2);
+    sdr_cpx_t *C = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) *
+        M * L * 2);
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
+    float *P_max = (float *)sdr_scratch_alloc(sizeof(float) * len_fds);
+    double *P_sum = (double *)sdr_scratch_alloc(sizeof(double) * len_fds);
+    
+    data_dft_dec(buff, ix, N, D, fs, fi + fds[0], plan[0], IQ, X);
+    
+    // batched ifft(shift(fft(data)) * code_fft) / M^2
+    for (int i = 0; i < len_fds; i += L) {
+        int m = MIN(len_fds - i, L);
+        for (int k = 0; k < m; k++) {
+            int s = (int)ROUND((fds[i+k] - fds[0]) / df);
+            shift_mul(X + M, code_fft, M, (s % M + M) % M, C + M * k);
+        }
+        if (m == L) {
+            fftwf_execute_dft(plan_b[1], C, C + M * L);
+        }
+        else {
+            for (int k = 0; k < m; k++) {
+                fftwf_execute_dft(plan[1], C + M * k, C + M * (L + k));
+            }
+        }
+        for (int k = 0; k < m; k++) {
+            pow_acc(C + M * (L + k), M, Nmax, P + (i + k) * M, P_max + i + k,
+                P_sum + i + k);
+        }
+    }
+    if (ixp) {
+        cn0 = corr_max_bins(P, M, Nmax, len_fds, P_max, P_sum, T, ixp);
+    }
+    sdr_scratch_free(X);
+    return cn0;
+}
+
+// parallel for type -----------------------------------------------------------
+typedef struct par_for_tag {    // parallel for type
+    void (*func)(void *, int);  // function for index
+    void *arg;                  // argument of function
+    int n;                      // number of indices
+    int next;                   // next index
+    int nthread;                // max number of threads running job
+    int nrun;                   // number of threads running job
+    struct par_for_tag *link;   // next job in pool
+} par_for_t;
+
+// parallel for pool -----------------------------------------------------------
+static par_for_t *pool_jobs = NULL; // jobs in parallel for pool
+static int pool_nthread = 0;        // number of threads of parallel for pool
+static pthread_mutex_t pool_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_cond = PTHREAD_COND_INITIALIZER; // job posted
+static pthread_cond_t pool_cond_done = PTHREAD_COND_INITIALIZER; // job left
+
+// run indices of parallel for job ---------------------------------------------
+static void par_for_run(par_for_t *pf)
+{
+    int i;
+    
+    while ((i = __atomic_fetch_add(&pf->next, 1, __ATOMIC_RELAXED)) < pf->n) {
+        pf->func(pf->arg, i);
+    }
+}
+
+// parallel for pool thread ----------------------------------------------------
+//  The pool threads are started on demand and kept for the process. A thread
+//  joins a posted job with indices left and a free thread slot.
+static void *pool_thread(void *arg)
+{
+    pthread_mutex_lock(&pool_mtx);
+    for (;;) {
+        par_for_t *pf = pool_jobs;
+        for ( ; pf && (pf->next >= pf->n || pf->nrun >= pf->nthread);
+            pf = pf->link) ;
+        if (!pf) {
+            pthread_cond_wait(&pool_cond, &pool_mtx);
+            continue;
+        }
+        pf->nrun++;
+        pthread_mutex_unlock(&pool_mtx);
+        par_for_run(pf);
+        pthread_mutex_lock(&pool_mtx);
+        if (--pf->nrun == 0) pthread_cond_broadcast(&pool_cond_done);
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+//  Parallel for by threads. The function is called for indices 0 to n - 1 by
+//  the calling thread and up to nthread - 1 threads of the parallel for pool.
+//  The indices are scheduled dynamically. The pool threads are started on the
+//  first use and reused by the following calls. The function may be nested in
+//  the function called, as the calling thread always runs its own indices.
+//
+//  args:
+//      n        (I) Number of indices
+//      nthread  (I) Number of threads
+//      func     (I) Function called as func(arg, index)
+//      arg      (I) Argument of function
+//
+//  return:
+//      none
+//
+void sdr_par_for(int n, int nthread, void (*func)(void *, int), void *arg)
+{
+    par_for_t pf = {func, arg, n, 0, MIN(MIN(nthread, n), MAX_POOL_THREAD), 1,
+        NULL};
+    
+    if (pf.nthread <= 1) {
+        par_for_run(&pf);
+        return;
+    }
+    // post job to pool and start pool threads on demand
+    pthread_mutex_lock(&pool_mtx);
+    while (pool_nthread < pf.nthread - 1) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, pool_thread, NULL)) break;
+        pthread_detach(thread);
+        pool_nthread++;
+    }
+    pf.link = pool_jobs;
+    pool_jobs = &pf;
+    pthread_cond_broadcast(&pool_cond);
+    pthread_mutex_unlock(&pool_mtx);
+    
+    par_for_run(&pf);
+    
+    // remove job from pool and wait for pool threads running job
+    pthread_mutex_lock(&pool_mtx);
+    par_for_t **p = &pool_jobs;
+    for ( ; *p != &pf; p = &(*p)->link) ;
+    *p = pf.link;
+    pf.nrun--;
+    while (pf.nrun > 0) {
+        pthread_cond_wait(&pool_cond_done, &pool_mtx);
+    }
+    pthread_mutex_unlock(&pool_mtx);
+}
+
+// signal acquisition batch types ----------------------------------------------
+typedef struct {                // acquisition group type
+    int N, Nz;                  // number of samples and zero-padding
+    double fi;                  // IF frequency (Hz)
+    int nstep;                  // number of integration steps
+    int nbase, nmax;            // number of sub-bin base frequencies
+    double *base;               // sub-bin base frequencies (Hz)
+    sdr_cpx_t *X;               // data DFTs ((N + Nz) x nbase x nstep)
+} acq_grp_t;
+
+typedef struct {                // acquisition task type
+    sdr_code_book_t *book;      // code book of code FFT
+    float *fds;                 // Doppler bins (Hz)
+    int len_fds;                // number of Doppler bins
+    int grp;                    // acquisition group index
+    int *base, *sft;            // sub-bin base index and shift of bins
+} acq_tsk_t;
+
+typedef struct {                // signal acquisition batch type
+    sdr_acq_job_t *jobs;        // acquisition jobs
+    acq_tsk_t *tsk;             // acquisition tasks
+    acq_grp_t *grp;             // acquisition groups
+    int ngrp;                   // number of acquisition groups
+    int *idx;                   // data DFT indices (group, base, step)
+    const sdr_buff_t *buff;     // IF data buffer
+    double fs;                  // sampling frequency (Hz)
+} acq_batch_t;
+
+// add acquisition group -------------------------------------------------------
+static int add_acq_grp(acq_batch_t *b, int N, int Nz, double fi, int len_buff)
+{
+    int i;
+    
+    for (i = 0; i < b->ngrp; i++) {
+        if (b->grp[i].N == N && b->grp[i].Nz == Nz && b->grp[i].fi == fi) {
+            return i;
+        }
+    }
+    acq_grp_t *g = b->grp + b->ngrp++;
+    g->N = N;
+    g->Nz = Nz;
+    g->fi = fi;
+    for (g->nstep = 0; g->nstep * N < len_buff - 2 * N + 1; g->nstep++) ;
+    return i;
+}
+
+// add sub-bin base frequency to acquisition group -----------------------------
+static int add_acq_base(acq_grp_t *g, double fs, float fd, int *sft)
+{
+    double df = fs / (g->N + g->Nz); // FFT bin width (Hz)
+    int i;
+    
+    for (i = 0; i < g->nbase; i++) {
+        double s = (fd - g->base[i]) / df;
+        if (fabs(s - ROUND(s)) > 1E-3) continue;
+        *sft = (((int)ROUND(s) % (g->N + g->Nz)) + g->N + g->Nz) %
+            (g->N + g->Nz);
+        return i;
+    }
+    if (g->nbase >= g->nmax) {
+        double *base = (double *)sdr_malloc(sizeof(double) * (g->nmax =
+            g->nmax <= 0 ? 4 : g->nmax * 2));
+        if (g->nbase > 0) memcpy(base, g->base, sizeof(double) * g->nbase);
+        sdr_free(g->base);
+        g->base = base;
+    }
+    g->base[g->nbase++] = fd;
+    *sft = 0;
+    return i;
+}
+
+// data DFT of acquisition group -----------------------------------------------
+static void acq_data_dft(void *arg, int i)
+{
+    acq_batch_t *b = (acq_batch_t *)arg;
+    acq_grp_t *g = b->grp + b->idx[i*3];
+    int base = b->idx[i*3+1], step = b->idx[i*3+2], N = g->N + g->Nz;
+    fftwf_plan plan[2];
+    
+    if (!get_fftw_plan(N, 1, plan)) return;
+    sdr_cpx_t *X = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N);
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
+    sdr_cpx_t *Y = g->X + (size_t)N * (step * g->nbase + base);
+    
+    // out-of-place DFT into the shared data DFTs
+    sdr_mix_carr(b->buff, step * g->N, N, b->fs, g->fi + g->base[base], 0.0,
+        IQ);
+    for (int j = 0; j < N; j++) {
+        X[j][0] = IQ[j].I * SDR_CSCALE;
+        X[j][1] = IQ[j].Q * SDR_CSCALE;
+    }
+    fftwf_execute_dft(plan[0], X, Y);
+    sdr_scratch_free(X);
+}
+
+// run acquisition job ---------------------------------------------------------
+static void acq_run_job(void *arg, int i)
+{
+    acq_batch_t *b = (acq_batch_t *)arg;
+    sdr_acq_job_t *job = b->jobs + i;
+    acq_tsk_t *t = b->tsk + i;
+    
+    if (!t->book) return;
+    acq_grp_t *g = b->grp + t->grp;
+    int N = g->N + g->Nz, n = t->len_fds, ix[2] = {0};
+    double T = sdr_code_cyc(job->sig);
+    fftwf_plan plan[2];
+    
+    if (!get_fftw_plan(N, 1, plan)) return;
+    float *P = (float *)sdr_malloc(sizeof(float) * N * n);
+    sdr_cpx_t *C = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 2);
+    float *P_max = (float *)sdr_scratch_alloc(sizeof(float) * n);
+    double *P_sum = (double *)sdr_scratch_alloc(sizeof(double) * n);
+    
+    // non-coherent integration with max correlation power in the last step
+    for (int step = 0; step < g->nstep; step++) {
+        int Nmax = step == g->nstep - 1 ? g->N : 0;
+        for (int k = 0; k < n; k++) {
+            const sdr_cpx_t *X = g->X + (size_t)N * (step * g->nbase +
+                t->base[k]);
+            shift_mul(X, t->book->code_fft, N, t->sft[k], C);
+            fftwf_execute_dft(plan[1], C, C + N);
+            pow_acc(C + N, N, Nmax, P + k * N, P_max + k, P_sum + k);
+        }
+    }
+    job->cn0 = g->nstep > 0 ?
+        corr_max_bins(P, N, g->N, n, P_max, P_sum, T, ix) : 0.0f;
+    job->fd = sdr_fine_dop(P, N, t->fds, n, ix);
+    job->coff = ix[1] / b->fs;
+    for (int j = 0; j < 3; j++) {
+        job->P[j] = P[ix[0] * N + (ix[1] + j - 1 + g->N) % g->N];
+    }
+    job->stat = 1;
+    sdr_scratch_free(C);
+    sdr_free(P);
+}
+
+//------------------------------------------------------------------------------
+//  Parallel code search of signal acquisition jobs in digitized IF data in a
+//  batch. The jobs are scheduled across threads. The data DFTs are shared among
+//  the jobs with the same code length, the same IF frequency and the same
+//  residual frequency of Doppler bins. The correlation powers are integrated
+//  non-coherently over the IF data buffer by the code cycle steps. The results
+//  are deterministic and independent of the number of threads.
+//
+//  args:
+//      jobs     (IO) Signal acquisition jobs (input: sig, prn, dop, max_dop,
+//                   output: stat, cn0, fd, coff, P)
+//      n        (I)  Number of signal acquisition jobs
+//      buff     (I)  IF data buffer
+//      fs       (I)  Sampling frequency (Hz)
+//      fi       (I)  IF frequency (Hz)
+//      zero_pad (I)  Zero-padding for circular correlation (1: on, 0: off)
+//      nthread  (I)  Number of threads (0: number of CPU cores)
+//
+//  return:
+//      Number of jobs with status OK
+//
+int sdr_acq_batch(sdr_acq_job_t *jobs, int n, const sdr_buff_t *buff,
+    double fs, double fi, int zero_pad, int nthread)
+{
+    acq_batch_t b = {0};
+    int nidx = 0, nok = 0;
+    
+    if (n <= 0) return 0;
+    nthread = nthread > 0 ? nthread : sdr_get_ncpu();
+    b.jobs = jobs;
+    b.buff = buff;
+    b.fs = fs;
+    b.tsk = (acq_tsk_t *)sdr_malloc(sizeof(acq_tsk_t) * n);
+    b.grp = (acq_grp_t *)sdr_malloc(sizeof(acq_grp_t) * n);
+    
+    // code FFTs, Doppler bins, groups and sub-bin base frequencies of jobs
+    for (int i = 0; i < n; i++) {
+        sdr_acq_job_t *job = jobs + i;
+        acq_tsk_t *t = b.tsk + i;
+        double T = sdr_code_cyc(job->sig);
+        int N = (int)(fs * T), Nz = zero_pad ? N : 0;
+        
+        job->stat = 0;
+        job->cn0 = 0.0f;
+        job->fd = job->coff = 0.0;
+        memset(job->P, 0, sizeof(job->P));
+        if (T <= 0.0 || N <= 0 || !(t->book = sdr_code_book_get(job->sig,
+            job->prn, fs, N, Nz, 1, SDR_CODE_FFT))) {
+            continue;
+        }
+        t->fds = sdr_dop_bins(T, job->dop, job->max_dop, &t->len_fds);
+        t->grp = add_acq_grp(&b, N, Nz, sdr_shift_freq(job->sig, job->prn, fi),
+            buff->N);
+        t->base = (int *)sdr_malloc(sizeof(int) * t->len_fds * 2);
+        t->sft = t->base + t->len_fds;
+        for (int k = 0; k < t->len_fds; k++) {
+            t->base[k] = add_acq_base(b.grp + t->grp, fs, t->fds[k],
+                t->sft + k);
+        }
+    }
+    // shared data DFTs in parallel
+    for (int i = 0; i < b.ngrp; i++) {
+        acq_grp_t *g = b.grp + i;
+        g->X = sdr_cpx_malloc((g->N + g->Nz) * g->nbase * g->nstep);
+        get_fftw_plan(g->N + g->Nz, 1, NULL); // plan before parallel jobs
+        nidx += g->nbase * g->nstep;
+    }
+    b.idx = (int *)sdr_malloc(sizeof(int) * 3 * (nidx + 1));
+    for (int i = 0, k = 0; i < b.ngrp; i++) {
+        for (int j = 0; j < b.grp[i].nbase * b.grp[i].nstep; j++, k++) {
+            b.idx[k*3  ] = i;
+            b.idx[k*3+1] = j % b.grp[i].nbase;
+            b.idx[k*3+2] = j / b.grp[i].nbase;
+        }
+    }
+    sdr_par_for(nidx, nthread, acq_data_dft, &b);
+    
+    // acquisition jobs in parallel
+    sdr_par_for(n, nthread, acq_run_job, &b);
+    
+    for (int i = 0; i < n; i++) {
+        nok += jobs[i].stat;
+        sdr_code_book_put(b.tsk[i].book);
+        sdr_free(b.tsk[i].fds);
+        sdr_free(b.tsk[i].base);
+    }
+    for (int i = 0; i < b.ngrp; i++) {
+        sdr_cpx_free(b.grp[i].X);
+        sdr_free(b.grp[i].base);
+    }
+    sdr_free(b.idx);
+    sdr_free(b.grp);
+    sdr_free(b.tsk);
+    return nok;
+}
+
+// max correlation power and C/N0 ----------------------------------------------
+float sdr_corr_max(const float *P, int N, int Nmax, int M, double T, int *ix)
+{
+    double P_max = 0.0, P_ave = 0.0;
+    int n = 0;
+    
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < Nmax; j++) {
+            P_ave += (P[i*N+j] - P_ave) / ++n;
+            if (P[i*N+j] <= P_max) continue;
+            P_max = P[i*N+j];
+            ix[0] = i; // index of doppler freq.
+            ix[1] = j; // index of code offset
+        }
+    }
+    return (P_ave > 0.0) ?
+        (float)(10.0 * log10((P_max - P_ave) / P_ave / T)) : 0.0f;
+}
+
+// polynomial fitting ----------------------------------------------------------
+static int poly_fit(const double *x, const double *y, int nx, int np, double *p)
+{
+    if (nx < np) {
+        return 0;
+    }
+    double *V = mat(np, nx), *Q = mat(np, np);
+    
+    for (int i = 0; i < nx; i++) { // Vandermonde matrix
+        for (int j = 0; j < np; j++) {
+            V[i*np+j] = (j == 0) ? 1.0 : V[i*np+j-1] * x[i];
+        }
+    }
+    int stat = lsq(V, y, np, nx, p, Q);
+    free(V);
+    free(Q);
+    return !stat;
+}
+
+// fine Doppler frequency by quadratic fitting ---------------------------------
+double sdr_fine_dop(const float *P, int N, const float *fds, int len_fds,
+    const int *ix)
+{
+    if (ix[0] == 0 || ix[0] == len_fds - 1) {
+        return fds[ix[0]];
+    }
+    double x[3], y[3], p[3];
+    
+    for (int i = 0; i < 3; i++) {
+        x[i] = fds[ix[0]-1+i];
+        y[i] = P[(ix[0]-1+i)*N+ix[1]];
+    }
+    if (!poly_fit(x, y, 3, 3, p)) {
+        return fds[ix[0]];
+    }
+    return -p[1] / (2.0 * p[2]);
+}
+
+// four-quadrant arctangent of arrays ------------------------------------------
+//  z[i] = atan2(y[i], x[i]) for i = 0,...,n-1 (x[i] != 0)
+void sdr_atan2_blk(const double *y, const double *x, int n, double *z)
+{
+    atan2_p(y, x, n, z);
+}
+
+// shift IF frequency for GLONASS FDMA -----------------------------------------
+double sdr_shift_freq(const char *sig, int fcn, double fi)
+{
+    if (!strcmp(sig, "G1CA")) {
+        fi += 0.5625e6 * fcn;
+    }
+    else if (!strcmp(sig, "G2CA")) {
+        fi += 0.4375e6 * fcn;
+    }
+    return fi;
+}
+
+// doppler search bins ---------------------------------------------------------
+float *sdr_dop_bins(double T, float dop, float max_dop, int *len_fds)
+{
+    float *fds, step = DOP_STEP / T;
+    
+    *len_fds = (int)(2.0 * max_dop / step) + 1;
+    fds = (float *)sdr_malloc(sizeof(float) * (*len_fds));
+    
+    for (int i = 0; i < *len_fds; i++) {
+        fds[i] = dop - max_dop + i * step;
+    }
+    return fds;
+}
+
+// carrier phase and phase step for mixing ------------------------------------
+static void carr_phase(double phi, double step, uint32_t *p, uint32_t *s)
+{
+    double scale = (double)(1 << 24) * NTBL;
+    *p = (uint32_t)((phi - floor(phi)) * scale);
+    *s = (uint32_t)(int)(step * scale);
+}
+
+// mix carrier of IF data buffer -----------------------------------------------
+//  Packed IF data is unpacked by tiles of CORR_TILE samples staying in L1
+//  cache. Tiles are multiples of NCO_BLK to keep NCO mixer outputs same.
+static void mix_buff(const sdr_buff_t *buff, int ix, int N, uint32_t p,
+    uint32_t s, sdr_cpx16_t *IQ)
+{
+    if (!buff->pack) {
+        mix_carr_p(buff->data + ix, N, p, s, IQ);
+        return;
+    }
+    sdr_cpx8_t data[CORR_TILE];
+    for (int i = 0; i < N; i += CORR_TILE) {
+        int m = MIN(CORR_TILE, N - i);
+        unpack_pk_p(buff->data, buff->LUT, ix + i, m, data);
+        mix_carr_p(data, m, p + s * i, s, IQ + i);
+    }
+}
+
+// mix carrier -----------------------------------------------------------------
+static void mix_carr(const sdr_buff_t *buff, int ix, int N, double phi,
+    double step, sdr_cpx16_t *IQ)
+{
+    uint32_t p, s;
+    carr_phase(phi, step, &p, &s);
+    mix_buff(buff, ix, N, p, s, IQ);
+}
+
+void sdr_mix_carr(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
+    double phi, sdr_cpx16_t *IQ)
+{
+    double step = fc / fs;
+    
+    if (ix + N <= buff->N) {
+        mix_carr(buff, ix, N, phi, step, IQ);
+    }
+    else { // across IF buffer boundary
+        int n = buff->N - ix;
+        mix_carr(buff, ix, n, phi, step, IQ);
+        mix_carr(buff, 0, N - n, phi + step * n, step, IQ + n);
+    }
+}
+
+// mix carrier for complex buffer ----------------------------------------------
+static void mix_carr_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
+    double fs, double fc, double phi, sdr_cpx16_t *IQ)
+{
+    sdr_buff_t buff_cpx8 = {0};
+    buff_cpx8.data = (sdr_cpx8_t *)sdr_scratch_alloc(sizeof(sdr_cpx8_t) * N);
+    buff_cpx8.N = N;
+    buff_cpx8.IQ = 2;
+    for (int i = 0, j = ix; i < N; i++, j = (j + 1) % len_buff) {
+        buff_cpx8.data[i] = SDR_CPX8((int8_t)buff[j][0], (int8_t)buff[j][1]);
+    }
+    mix_carr(&buff_cpx8, 0, N, phi, fc / fs, IQ);
+    sdr_scratch_free(buff_cpx8.data);
+}
+
+// standard correlator ---------------------------------------------------------
+static void corr_std(const sdr_cpx16_t *IQ, const sdr_cpx16_t *code, int N,
+    const int *pos, int n, sdr_cpx_t *corr)
+{
+    for (int i = 0; i < n; i++) {
+        int M = N - abs(pos[i]);
+        const sdr_cpx16_t *IQ_i = pos[i] > 0 ? IQ + pos[i] : IQ;
+        const sdr_cpx16_t *code_i = pos[i] < 0 ? code - pos[i] : code;
+        int32_t sum[2] = {0};
+        for (int j = 0; j < M; j += CORR_TILE) {
+            dot_IQ_code(IQ_i + j, code_i + j, MIN(CORR_TILE, M - j), sum);
+        }
+        float scale = 1.0f / M;
+        corr[i][0] = (float)sum[0] * (scale * SDR_CSCALE);
+        corr[i][1] = (float)sum[1] * (scale * SDR_CSCALE);
+    }
+}
+
+// scale integer sums of standard correlator ----------------------------------
+//  The correlators scale the sums only by this function to give the same
+//  correlations for the same sums. It is not inlined since the float scaling
+//  inlined in each caller may be rounded differently by -Ofast.
+__attribute__((noinline))
+static void scale_corr(const int32_t *sum, int N, const int *pos, int n,
+    sdr_cpx_t *corr)
+{
+    for (int j = 0; j < n; j++) {
+        float scale = 1.0f / (N - abs(pos[j]));
+        corr[j][0] = (float)sum[2*j  ] * (scale * SDR_CSCALE);
+        corr[j][1] = (float)sum[2*j+1] * (scale * SDR_CSCALE);
+    }
+}
+
+// fused carrier mixer and standard correlator ---------------------------------
+//  The IF data is mixed by tiles of CORR_TILE samples and each tile is
+//  correlated with all code positions while it stays in L1 cache. Integer sums
+//  give the same correlations as corr_std() with no intermediate IQ array.
+static void corr_std_fused(const sdr_buff_t *buff, int ix, int N, double phi,
+    double step, const sdr_cpx16_t *code, const int *pos, int n,
+    sdr_cpx_t *corr)
+{
+    sdr_cpx16_t IQ[CORR_TILE];
+    int32_t *sum = (int32_t *)sdr_scratch_alloc(sizeof(int32_t) * 2 * n);
+    int n1 = MIN(N, buff->N - ix); // samples before IF buffer boundary
+    uint32_t p[2], s;
+    
+    carr_phase(phi, step, p, &s);
+    carr_phase(phi + step * n1, step, p + 1, &s);
+    memset(sum, 0, sizeof(int32_t) * 2 * n);
+    
+    for (int i = 0; i < N; i += CORR_TILE) {
+        int m = MIN(CORR_TILE, N - i);
+        
+        // mix carrier for a tile
+        if (i + m <= n1) {
+            mix_buff(buff, ix + i, m, p[0] + s * i, s, IQ);
+        }
+        else if (i >= n1) {
+            mix_buff(buff, i - n1, m, p[1] + s * (i - n1), s, IQ);
+        }
+        else {
+            mix_buff(buff, ix + i, n1 - i, p[0] + s * i, s, IQ);
+            mix_buff(buff, 0, i + m - n1, p[1], s, IQ + n1 - i);
+        }
+        // correlate the tile with each code position
+        for (int j = 0; j < n; j++) {
+            int a = MAX(i, MAX(0, pos[j])), b = MIN(i + m, MIN(N, N + pos[j]));
+            if (a >= b) continue;
+            dot_IQ_code(IQ + a - i, code + a - pos[j], b - a, sum + 2 * j);
+        }
+    }
+    scale_corr(sum, N, pos, n, corr);
+    sdr_scratch_free(sum);
+}
+
+// mix carrier and standard correlator -----------------------------------------
+void sdr_corr_std(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
+    double phi, const sdr_cpx16_t *code, const int *pos, int n, sdr_cpx_t *corr)
+{
+    corr_std_fused(buff, ix, N, phi, fc / fs, code, pos, n, corr);
+}
+
+// mix carrier of segment of correlator job -----------------------------------
+//  Samples a,...,b-1 of the job are mixed to IQ. Sample j is read at ix + j
+//  before IF buffer boundary (j < n1) and at j - n1 after the boundary with
+//  the same carrier phases as corr_std_fused().
+static void mix_carr_job(const sdr_buff_t *buff, int ix, int n1,
+    const uint32_t *p, uint32_t s, int a, int b, sdr_cpx16_t *IQ)
+{
+    if (a < n1) {
+        int m = MIN(b, n1) - a;
+        mix_buff(buff, ix + a, m, p[0] + s * a, s, IQ);
+        IQ += m;
+        a += m;
+    }
+    if (a < b) {
+        mix_buff(buff, a - n1, b - a, p[1] + s * (a - n1), s, IQ);
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Mix carrier and standard correlator of multiple channels sharing an IF data
+//  buffer. The IF data is swept once by tiles of CORR_TILE samples. Each tile
+//  is mixed with the carrier of every job overlapping it and correlated with
+//  the code positions of the job while the tile stays in L1 cache. The
+//  correlations are the same as sdr_corr_std() for each job. A job with the
+//  same sample range and carrier NCO as the previous job (e.g. data and pilot
+//  components of a signal tracked jointly) shares the mixed tile of it.
+//
+//  args:
+//      buff     (I)  IF data buffer
+//      jobs     (IO) Correlator jobs (jobs[k].corr: output)
+//      n        (I)  Number of jobs
+//
+//  return:
+//      none
+//
+void sdr_corr_std_multi(const sdr_buff_t *buff, sdr_corr_job_t *jobs, int n)
+{
+    sdr_cpx16_t IQ[CORR_TILE];
+    uint32_t *p = (uint32_t *)sdr_scratch_alloc(sizeof(uint32_t) * 3 * n);
+    int *ix = (int *)sdr_scratch_alloc(sizeof(int) * 3 * n), *n1 = ix + n;
+    int *shr = n1 + n;
+    int *off = (int *)sdr_scratch_alloc(sizeof(int) * (n + 1));
+    int u0 = 0, u1 = 0;
+    
+    // carrier NCOs, sample ranges and offsets of sums of jobs
+    off[0] = 0;
+    for (int k = 0; k < n; k++) {
+        const sdr_corr_job_t *job = jobs + k;
+        double step = job->fc / job->fs;
+        ix[k] = job->ix % buff->N;
+        n1[k] = MIN(job->N, buff->N - ix[k]);
+        carr_phase(job->phi, step, p + 3 * k, p + 3 * k + 2);
+        carr_phase(job->phi + step * n1[k], step, p + 3 * k + 1, p + 3 * k + 2);
+        off[k+1] = off[k] + 2 * job->npos;
+        shr[k] = k > 0 && ix[k] == ix[k-1] && job->N == job[-1].N &&
+            !memcmp(p + 3 * k, p + 3 * (k - 1), sizeof(uint32_t) * 3);
+        if (k == 0 || ix[k] < u0) u0 = ix[k];
+        if (k == 0 || ix[k] + job->N > u1) u1 = ix[k] + job->N;
+    }
+    int32_t *sum = (int32_t *)sdr_scratch_alloc(sizeof(int32_t) *
+        MAX(off[n], 1));
+    memset(sum, 0, sizeof(int32_t) * off[n]);
+    
+    for (int t = u0; t < u1; t += CORR_TILE) {
+        for (int k = 0; k < n; k++) {
+            const sdr_corr_job_t *job = jobs + k;
+            int a = MAX(t, ix[k]) - ix[k];
+            int b = MIN(t + CORR_TILE, ix[k] + job->N) - ix[k];
+            if (a >= b) continue;
+            
+            // mix carrier for the tile of the job unless shared
+            if (!shr[k]) {
+                mix_carr_job(buff, ix[k], n1[k], p + 3 * k, p[3*k+2], a, b,
+                    IQ);
+            }
+            
+            // correlate the tile with each code position
+            for (int j = 0; j < job->npos; j++) {
+                int pos = job->pos[j];
+                int c = MAX(a, MAX(0, pos)), d = MIN(b, MIN(job->N,
+                    job->N + pos));
+                if (c >= d) continue;
+                dot_IQ_code(IQ + c - a, job->code + c - pos, d - c,
+                    sum + off[k] + 2 * j);
+            }
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        scale_corr(sum + off[k], jobs[k].N, jobs[k].pos, jobs[k].npos,
+            jobs[k].corr);
+    }
+    sdr_scratch_free(sum);
+    sdr_scratch_free(off);
+    sdr_scratch_free(ix);
+    sdr_scratch_free(p);
+}
+
+//------------------------------------------------------------------------------
+//  Generate resampled code replica by code NCO from packed code. The chip of
+//  sample i is floor(phi + step * i) modulo the code length.
+//
+//  args:
+//      code     (I) Packed code
+//      phi      (I) Code phase of the first sample (chips)
+//      step     (I) Code phase step (chips / sample) (0 < step < 32)
+//      N        (I) Number of samples
+//      code_res (O) Resampled code as sdr_cpx16_t array (N)
+//
+//  return:
+//      none
+//
+void sdr_code_nco(const sdr_code_pack_t *code, double phi, double step, int N,
+    sdr_cpx16_t *code_res)
+{
+    phi = fmod(phi, code->N);
+    if (phi < 0.0) phi += code->N;
+    uint64_t p = (uint64_t)(phi * 4294967296.0);
+    uint64_t s = (uint64_t)(step * 4294967296.0);
+    if (p >= (uint64_t)code->N << 32) p = 0;
+    code_nco(code, p, s, N, code_res);
+}
+
+// mix carrier and standard correlator for complex buffer ----------------------
+void sdr_corr_std_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
+    double fs, double fc, double phi, const float *code, const int *pos, int n,
+    sdr_cpx_t *corr)
+{
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) *
+        N * 2);
+    mix_carr_cpx(buff, len_buff, ix, N, fs, fc, phi, IQ);
+    for (int i = 0; i < N; i++) {
+        IQ[N+i].I = IQ[N+i].Q = (int8_t)code[i];
+    }
+    corr_std(IQ, IQ + N, N, pos, n, corr);
+    sdr_scratch_free(IQ);
+}
+
+// FFT correlator --------------------------------------------------------------
+static void corr_fft(const sdr_cpx16_t *IQ, const sdr_cpx_t *code_fft, int N,
+    sdr_cpx_t *corr)
+{
+    fftwf_plan plan[2];
+    
+    if (!get_fftw_plan(N, 1, plan)) return;
+    sdr_cpx_t *cpx = (sdr_cpx_t *)sdr_scratch_alloc(sizeof(sdr_cpx_t) * N * 2);
+    for (int i = 0; i < N; i++) {
+        cpx[i][0] = IQ[i].I * SDR_CSCALE;
+        cpx[i][1] = IQ[i].Q * SDR_CSCALE;
+    }
+    // ifft(fft(data) * code_fft) / N^2 
+    fftwf_execute_dft(plan[0], cpx, cpx + N);
+    sdr_cpx_mul(cpx + N, code_fft, N, 1.0f / N / N, cpx);
+    fftwf_execute_dft(plan[1], cpx, corr);
+    
+    sdr_scratch_free(cpx);
+}
+
+// mix carrier and FFT correlator ----------------------------------------------
+void sdr_corr_fft(const sdr_buff_t *buff, int ix, int N, double fs, double fc,
+    double phi, const sdr_cpx_t *code_fft, sdr_cpx_t *corr)
+{
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
+    sdr_mix_carr(buff, ix, N, fs, fc, phi, IQ);
+    corr_fft(IQ, code_fft, N, corr);
+    sdr_scratch_free(IQ);
+}
+
+// mix carrier and FFT correlator for complex input ----------------------------
+void sdr_corr_fft_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
+    double fs, double fc, double phi, const sdr_cpx_t *code_fft,
+    sdr_cpx_t *corr)
+{
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * N);
+    mix_carr_cpx(buff, len_buff, ix, N, fs, fc, phi, IQ);
+    corr_fft(IQ, code_fft, N, corr);
+    sdr_scratch_free(IQ);
+}
+
+// CSK chip of primary code ----------------------------------------------------
+static int csk_chip(const sdr_code_pack_t *code, int i)
+{
+    int chip = 0;
+    for (int j = 0; j < code->nz; j++) {
+        chip += SDR_CODE_CHIP(code, i * code->nz + j);
+    }
+    return chip;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new CSK demodulator. A CSK chip is a period of the zero-chip
+//  pattern of the primary code (2 chips for the TDM codes of L6D/L6E). The
+//  buffers of the demodulator are allocated to be reused for each code cycle.
+//  The DFT of the chip-rate code is generated for the FFT correlator of lags
+//  -(nsym - 1), ..., nsym - 1 (CSK chips) without wrap-around.
+//
+//  args:
+//      code     (I) primary code (packed)
+//      N        (I) code cycle (samples)
+//      nsym     (I) number of CSK symbols (256 for L6D/L6E)
+//
+//  return:
+//      CSK demodulator (NULL: error)
+//
+sdr_csk_t *sdr_csk_new(const sdr_code_pack_t *code, int N, int nsym)
+{
+    int L = code->N / code->nz, M = 1;
+    fftwf_plan plan[2];
+    
+    if (N <= 0 || nsym < 1 || code->N % code->nz || L <= 2 * nsym) {
+        return NULL;
+    }
+    while (M < L + 2 * (nsym - 1)) M <<= 1;
+    if (!get_fftw_plan(M, 1, plan)) return NULL;
+    
+    sdr_csk_t *csk = (sdr_csk_t *)sdr_malloc(sizeof(sdr_csk_t));
+    csk->code = code;
+    csk->N = N;
+    csk->L = L;
+    csk->nsym = nsym;
+    csk->M = M;
+    csk->code_fft = sdr_cpx_malloc(M);
+    csk->X = sdr_cpx_malloc(M * 2);
+    csk->IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    csk->code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    csk->P = (float *)sdr_malloc(sizeof(float) * 2 * nsym);
+    
+    // chip-rate code shifted by nsym - 1 with negative lags at the end
+    sdr_cpx_t *f = csk->X;
+    memset(f, 0, sizeof(sdr_cpx_t) * M);
+    for (int i = 0; i < L; i++) {
+        f[i][0] = csk_chip(code, (i + nsym - 1) % L);
+    }
+    for (int i = M - 2 * (nsym - 1); i < M; i++) {
+        f[i][0] = csk_chip(code, (i - M + nsym - 1 + L) % L);
+    }
+    fftwf_execute_dft(plan[0], f, csk->code_fft);
+    for (int i = 0; i < M; i++) {
+        csk->code_fft[i][1] = -csk->code_fft[i][1];
+    }
+    return csk;
+}
+
+//------------------------------------------------------------------------------
+//  Free a CSK demodulator.
+//
+//  args:
+//      csk      (I) CSK demodulator generated by sdr_csk_new()
+//
+//  return:
+//      none
+//
+void sdr_csk_free(sdr_csk_t *csk)
+{
+    if (!csk) return;
+    sdr_cpx_free(csk->code_fft);
+    sdr_cpx_free(csk->X);
+    sdr_free(csk->IQ);
+    sdr_free(csk->code_res);
+    sdr_free(csk->P);
+    sdr_free(csk);
+}
+
+//------------------------------------------------------------------------------
+//  Demodulate CSK symbol of a code cycle and correlate it. The carrier-mixed
+//  IF data are integrated and dumped over the CSK chips into the chip-rate
+//  data without the zero chips (TDM), which are correlated with the chip-rate
+//  code by FFT of csk->M points instead of the FFT of the code cycle samples.
+//  The symbol is detected by the peak of the correlation powers over the
+//  lags of the symbol hypotheses. Then the standard correlator is run with the
+//  code replica shifted by the detected lag for the tracking loops.
+//
+//  args:
+//      csk      (I) CSK demodulator
+//      buff     (I) IF data buffer
+//      ix       (I) index of IF data buffer
+//      fs       (I) sampling rate (sps)
+//      fc       (I) IF carrier frequency with Doppler (Hz)
+//      phi      (I) carrier phase at ix (cyc)
+//      chip     (I) code phase at ix (chips) (-step < chip <= 0)
+//      step     (I) code phase step (chips/sample)
+//      pos      (I) correlator positions (samples) {n}
+//      n        (I) number of correlator positions
+//      corr     (O) correlations {n}
+//
+//  return:
+//      lag of detected symbol (CSK chips) (-(nsym - 1), ..., nsym - 1)
+//
+int sdr_csk_corr(sdr_csk_t *csk, const sdr_buff_t *buff, int ix, double fs,
+    double fc, double phi, double chip, double step, const int *pos, int n,
+    sdr_cpx_t *corr)
+{
+    const sdr_code_pack_t *code = csk->code;
+    int N = csk->N, M = csk->M, nl = 2 * csk->nsym - 1;
+    sdr_cpx_t *X = csk->X;
+    fftwf_plan plan[2];
+    
+    if (!get_fftw_plan(M, 1, plan)) return 0;
+    sdr_mix_carr(buff, ix, N, fs, fc, phi, csk->IQ);
+    
+    // integrate and dump IF data over CSK chips (chip j = u * nz + r)
+    memset(X, 0, sizeof(sdr_cpx_t) * M);
+    for (int i = 0, j = 0, u = 0, r = 0; i < N; i++) {
+        double c = chip + step * i;
+        if (c < 0.0) continue;
+        for ( ; j + 1 <= c; j++) {
+            if (++r < code->nz) continue;
+            r = 0;
+            u++;
+        }
+        if (j >= code->N) break;
+        if ((code->zero >> r) & 1) continue;
+        X[u][0] += csk->IQ[i].I;
+        X[u][1] += csk->IQ[i].Q;
+    }
+    // chip-rate correlation: ifft(fft(X) * code_fft) / M
+    fftwf_execute_dft(plan[0], X, X + M);
+    cpx_mul(X + M, csk->code_fft, M, 1.0f / M, X);
+    fftwf_execute_dft(plan[1], X, X + M);
+    
+    // peak of correlation powers over lags of symbol hypotheses
+    float P_max = 0.0f;
+    double P_sum = 0.0;
+    memset(csk->P, 0, sizeof(float) * nl);
+    pow_acc(X + M, nl, nl, csk->P, &P_max, &P_sum);
+    int d = 0;
+    while (d < nl - 1 && csk->P[d] < P_max) d++;
+    int lag = d - (csk->nsym - 1);
+    
+    // standard correlator with code replica shifted by lag
+    sdr_code_nco(code, chip - lag * code->nz, step, N, csk->code_res);
+    corr_std(csk->IQ, csk->code_res, N, pos, n, corr);
+    return lag;
+}
+
+// hanning window function -----------------------------------------------------
+static float hann_window(int N, float *w)
+{
+    float w_ave = 0.0;
+    
+    for (int i = 0; i < N; i++) {
+        w[i] = 0.5 + 0.5 * cos(2.0 * PI * (i - 0.5 * (N - 1)) / (N - 1));
+        w_ave += w[i] / N;
+    }
+    return w_ave;
+}
+
+//------------------------------------------------------------------------------
+//  Power spectral density of digitalized IF (inter-frequency) data.
+//
+//  args:
+//      buff     (I) digitalized IF data buffer
+//      len_buff (I) length of buffer
+//      N        (I) FFT size
+//      fs       (I) sampling frequency (Hz)
+//      IQ       (I) sampling type (1: I-sampling, 2: IQ-sampling)
+//      psd      (O) PSD (dB/Hz) size: N/2 (IQ=1), N (IQ=2)
+//
+//  return:
+//      none
+//
+void sdr_psd_cpx(const sdr_cpx_t *buff, int len_buff, int N, double fs, int IQ,
+    float *psd)
+{
+    fftwf_plan plan[2];
+    
+    if (!get_fftw_plan(N, 1, plan)) return;
+    
+    float *p = (float *)sdr_malloc(sizeof(float) * N);
+    float *w = (float *)sdr_malloc(sizeof(float) * N);
+    sdr_cpx_t *cpx1 = sdr_cpx_malloc(N);
+    sdr_cpx_t *cpx2 = sdr_cpx_malloc(N);
+    
+    float w_ave = hann_window(N, w);
+    
+    // Welch's method without overlap
+    int M = len_buff / N;
+    for (int i = 0; i < M; i++) {
+        for (int j = 0; j < N; j++) {
+            cpx1[j][0] = buff[N*i+j][0] * w[j];
+            cpx1[j][1] = buff[N*i+j][1] * w[j];
+        }
+        fftwf_execute_dft(plan[0], cpx1, cpx2);
+        for (int j = 0; j < N; j++) {
+            p[j] += SQR(cpx2[j][0]) + SQR(cpx2[j][1]);
+        }
+    }
+    // scale complies with matplotlib.psd()
+    float scale = 1.333 / N / M / w_ave / fs;
+    
+    if (IQ == 1) { // I
+        for (int i = 0; i < N / 2; i++) {
+            psd[i] = 10.0f * log10f(p[i] * scale * 2.0);
+        }
+    }
+    else { // IQ
+        for (int i = 0; i < N / 2; i++) {
+            psd[i] = 10.0f * log10f(p[N/2+i] * scale);
+        }
+        for (int i = N / 2; i < N; i++) {
+            psd[i] = 10.0f * log10f(p[i-N/2] * scale);
+        }
+    }
+    sdr_free(p);
+    sdr_free(w);
+    sdr_cpx_free(cpx1);
+    sdr_cpx_free(cpx2);
+}
+
+// set up segments of IF data monitor ------------------------------------------
+static void mon_setup(sdr_mon_t *mon, int N)
+{
+    sdr_free(mon->w);
+    sdr_free(mon->p);
+    sdr_free(mon->p_ave);
+    sdr_free(mon->data);
+    sdr_cpx_free(mon->cpx);
+    mon->w = mon->p = mon->p_ave = NULL;
+    mon->data = NULL;
+    mon->cpx = NULL;
+    mon->N = 0;
+    mon->L = N > 0 ? N : MON_N_HIST;
+    if (N > 0 && get_fftw_plan(N, 1, mon->plan)) {
+        mon->N = N;
+        mon->w = (float *)sdr_malloc(sizeof(float) * N);
+        mon->p = (float *)sdr_malloc(sizeof(float) * N);
+        mon->p_ave = (float *)sdr_malloc(sizeof(float) * N);
+        mon->cpx = sdr_cpx_malloc(N * 2);
+        mon->w_ave = hann_window(N, mon->w);
+    }
+    mon->N_req = mon->N;
+    mon->data = (sdr_cpx8_t *)sdr_malloc(mon->L);
+    mon->per = MAX(MON_NSEG * (mon->L / 2),
+        (int)(mon->fs * MON_NSEG / MON_RATE)); // burst period
+    mon->nseg = mon->nskip = mon->nave = mon->nava = 0;
+    mon->ix_end = -1; // restart segments
+    memset(mon->cnt, 0, sizeof(mon->cnt));
+    memset(mon->hist, 0, sizeof(mon->hist));
+}
+
+// add segment of IF data to IF data monitor -----------------------------------
+static void mon_seg(sdr_mon_t *mon, const sdr_buff_t *buff)
+{
+    const sdr_cpx8_t *data[2];
+    int m[2];
+    
+    m[0] = MIN(mon->L, buff->N - mon->ix);
+    m[1] = mon->L - m[0];
+    if (buff->pack) {
+        unpack_pk_p(buff->data, buff->LUT, mon->ix, m[0], mon->data);
+        unpack_pk_p(buff->data, buff->LUT, 0, m[1], mon->data + m[0]);
+        data[0] = mon->data;
+        data[1] = mon->data + m[0];
+    }
+    else {
+        data[0] = buff->data + mon->ix;
+        data[1] = buff->data;
+    }
+    // histogram of samples not overlapped with next segment
+    for (int i = 0, n = mon->L / 2; i < 2; n -= m[i++]) {
+        for (int j = 0; j < MIN(m[i], n); j++) {
+            mon->cnt[data[i][j]]++;
+        }
+    }
+    if (mon->N <= 0) return;
+    
+    // windowed segment FFT and PSD accumulation
+    float P_max;
+    double P_sum;
+    win_cpx8(data[0], mon->w, m[0], mon->cpx);
+    win_cpx8(data[1], mon->w + m[0], m[1], mon->cpx + m[0]);
+    fftwf_execute_dft(mon->plan[0], mon->cpx, mon->cpx + mon->N);
+    pow_acc(mon->cpx + mon->N, mon->N, 0, mon->p, &P_max, &P_sum);
+}
+
+// average burst of segments in IF data monitor --------------------------------
+static void mon_ave(sdr_mon_t *mon)
+{
+    double a = 1.0, sum = 0.0;
+    
+    if (mon->nave > 0 && mon->tave > 0.0) {
+        a = MIN(1.0, mon->per / mon->fs / mon->tave);
+    }
+    for (int i = 0; i < mon->N; i++) {
+        mon->p_ave[i] += (float)(a * (mon->p[i] / MON_NSEG - mon->p_ave[i]));
+        mon->p[i] = 0.0f;
+    }
+    for (int i = 0; i < 256; i++) {
+        sum += mon->cnt[i];
+    }
+    for (int i = 0; i < 256; i++) {
+        mon->hist[i] += a * (mon->cnt[i] / sum - mon->hist[i]);
+        mon->cnt[i] = 0;
+    }
+    mon->nskip = mon->per - MON_NSEG * (mon->L / 2);
+    mon->nseg = 0;
+    mon->nave++;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new IF data monitor. The monitor accumulates the PSD by Welch's
+//  method with 50% overlapped Hann-windowed segments and the histogram of the
+//  IF data incrementally as the IF data are written to the IF data buffer.
+//  To limit the CPU load, the segments are taken in bursts of MON_NSEG
+//  segments at the rate up to MON_RATE segments/s. The PSDs and the
+//  histograms of the bursts are averaged exponentially with the time constant
+//  of the last query. The accumulation is enabled by the first query.
+//
+//  args:
+//      fs       (I) sampling frequency (Hz)
+//      IQ       (I) sampling type (1: I-sampling, 2: IQ-sampling)
+//
+//  return:
+//      IF data monitor (NULL: error)
+//
+sdr_mon_t *sdr_mon_new(double fs, int IQ)
+{
+    if (fs <= 0.0 || IQ < 1 || IQ > 2) return NULL;
+    sdr_mon_t *mon = (sdr_mon_t *)sdr_malloc(sizeof(sdr_mon_t));
+    mon->fs = fs;
+    mon->IQ = IQ;
+    mon->ix_end = -1;
+    pthread_mutex_init(&mon->mtx, NULL);
+    return mon;
+}
+
+//------------------------------------------------------------------------------
+//  Free an IF data monitor.
+//
+//  args:
+//      mon      (I) IF data monitor generated by sdr_mon_new()
+//
+//  return:
+//      none
+//
+void sdr_mon_free(sdr_mon_t *mon)
+{
+    if (!mon) return;
+    sdr_free(mon->w);
+    sdr_free(mon->p);
+    sdr_free(mon->p_ave);
+    sdr_free(mon->data);
+    sdr_cpx_free(mon->cpx);
+    pthread_mutex_destroy(&mon->mtx);
+    sdr_free(mon);
+}
+
+//------------------------------------------------------------------------------
+//  Update an IF data monitor with IF data written to the IF data buffer. The
+//  IF data should be written contiguously. Otherwise the segments are
+//  restarted at the written IF data.
+//
+//  args:
+//      mon      (I) IF data monitor
+//      buff     (I) IF data buffer
+//      ix       (I) index of IF data written in the buffer
+//      n        (I) number of samples written
+//
+//  return:
+//      none
+//
+void sdr_mon_update(sdr_mon_t *mon, const sdr_buff_t *buff, int ix, int n)
+{
+    if (!mon || !__atomic_load_n(&mon->ena, __ATOMIC_ACQUIRE)) return;
+    
+    pthread_mutex_lock(&mon->mtx);
+    if (!mon->L || mon->N != mon->N_req) {
+        mon_setup(mon, mon->N_req);
+    }
+    if (ix != mon->ix_end) { // restart segments
+        mon->ix = ix;
+        mon->nava = mon->nseg = mon->nskip = 0;
+        memset(mon->cnt, 0, sizeof(mon->cnt));
+        if (mon->N > 0) memset(mon->p, 0, sizeof(float) * mon->N);
+    }
+    mon->ix_end = (ix + n) % buff->N;
+    mon->nava += n;
+    
+    while (mon->nava >= (mon->nskip > 0 ? 1 : mon->L)) {
+        int m = mon->nskip > 0 ? MIN(mon->nskip, mon->nava) : mon->L / 2;
+        if (mon->nskip > 0) {
+            mon->nskip -= m;
+        }
+        else {
+            mon_seg(mon, buff);
+            if (++mon->nseg >= MON_NSEG) mon_ave(mon);
+        }
+        mon->ix = (mon->ix + m) % buff->N;
+        mon->nava -= m;
+    }
+    pthread_mutex_unlock(&mon->mtx);
+}
+
+//------------------------------------------------------------------------------
+//  Get PSD of IF data monitor. If the FFT size is changed, the PSD is reset and
+//  available after the next burst of segments.
+//
+//  args:
+//      mon      (I) IF data monitor
+//      tave     (I) averaging time constant (s)
+//      N        (I) FFT size
+//      psd      (O) PSD (dB/Hz) size: N/2 (IQ=1), N (IQ=2)
+//
+//  return:
+//      PSD size (0: not available)
+//
+int sdr_mon_psd(sdr_mon_t *mon, double tave, int N, float *psd)
+{
+    int n = 0;
+    
+    if (!mon || N <= 0) return 0;
+    
+    pthread_mutex_lock(&mon->mtx);
+    mon->tave = tave;
+    if (mon->N != N) {
+        mon->N_req = N;
+        __atomic_store_n(&mon->ena, 1, __ATOMIC_RELEASE);
+    }
+    else if (mon->nave > 0) {
+        // scale complies with matplotlib.psd()
+        float scale = 1.333 / N / mon->w_ave / mon->fs;
+        
+        if (mon->IQ == 1) { // I
+            for (int i = 0; i < N / 2; i++) {
+                psd[i] = 10.0f * log10f(mon->p_ave[i] * scale * 2.0f);
+            }
+            n = N / 2;
+        }
+        else { // IQ
+            for (int i = 0; i < N / 2; i++) {
+                psd[i] = 10.0f * log10f(mon->p_ave[N/2+i] * scale);
+            }
+            for (int i = N / 2; i < N; i++) {
+                psd[i] = 10.0f * log10f(mon->p_ave[i-N/2] * scale);
+            }
+            n = N;
+        }
+    }
+    pthread_mutex_unlock(&mon->mtx);
+    return n;
+}
+
+//------------------------------------------------------------------------------
+//  Get histogram of IF data monitor.
+//
+//  args:
+//      mon      (I) IF data monitor
+//      tave     (I) averaging time constant (s)
+//      val      (O) sample values
+//      hist1    (O) histogram of I samples
+//      hist2    (O) histogram of Q samples (IQ=2)
+//
+//  return:
+//      number of sample values (0: not available)
+//
+int sdr_mon_hist(sdr_mon_t *mon, double tave, int *val, double *hist1,
+    double *hist2)
+{
+    double h[2][256] = {{0}};
+    int nval = 0;
+    
+    if (!mon) return 0;
+    
+    pthread_mutex_lock(&mon->mtx);
+    mon->tave = tave;
+    __atomic_store_n(&mon->ena, 1, __ATOMIC_RELEASE);
+    if (mon->nave > 0) {
+        for (int i = 0; i < 256; i++) {
+            h[0][SDR_CPX8_I(i)+128] += mon->hist[i];
+            h[1][SDR_CPX8_Q(i)+128] += mon->hist[i];
+        }
+    }
+    pthread_mutex_unlock(&mon->mtx);
+    
+    for (int i = 0; i < 256; i++) {
+        if (h[0][i] == 0.0 && h[1][i] == 0.0) continue;
+        hist1[nval] = h[0][i];
+        if (mon->IQ == 2) {
+            hist2[nval] = h[1][i];
+        }
+        val[nval++] = i - 128;
+    }
+    return nval;
+}
+
+// quantize sub-band sample of DDC ---------------------------------------------
+static int quant_ddc(float x)
+{
+    x = x < -DDC_QMAX ? -DDC_QMAX : (x > DDC_QMAX ? DDC_QMAX : x);
+    return (int)(x + (DDC_QMAX + 0.5f)) - DDC_QMAX;
+}
+
+// CIC filter of DDC ---------------------------------------------------------
+//  The 2nd-order CIC (triangle of 2D-1 samples) with decimation D is computed
+//  by the sums of blocks of D samples as y[m] = D * b[m] - c[m] + c[m-1],
+//  b[m] = sum(x[m*D+s]) and c[m] = sum(s * x[m*D+s]) (s = 0, ..., D-1), where
+//  x[s] = IQ[D-1+s]. It returns the power sum of the outputs.
+static inline double cic_ddc(const sdr_cpx16_t *IQ, int M, int D, float *y)
+{
+    int32_t cI = 0, cQ = 0;
+    double pow = 0.0;
+    
+    // c[-1] of D-1 samples of the previous cycle
+    for (int s = 1; s < D; s++) {
+        cI += s * IQ[s-1].I;
+        cQ += s * IQ[s-1].Q;
+    }
+    for (int m = 0; m < M; m++) {
+        const sdr_cpx16_t *x = IQ + (D - 1) + m * D;
+        int32_t bI = 0, bQ = 0, dI = 0, dQ = 0;
+        for (int s = 0; s < D; s++) {
+            bI += x[s].I;
+            bQ += x[s].Q;
+            dI += s * x[s].I;
+            dQ += s * x[s].Q;
+        }
+        int32_t yI = D * bI - dI + cI, yQ = D * bQ - dQ + cQ;
+        cI = dI;
+        cQ = dQ;
+        y[m*2  ] = (float)yI;
+        y[m*2+1] = (float)yQ;
+        pow += (double)yI * yI + (double)yQ * yQ;
+    }
+    return pow;
+}
+
+// down-convert IF data cycle into sub-band of DDC -----------------------------
+//  The IF data are mixed to the center frequency and filtered by a 2nd-order
+//  CIC (triangle of 2D-1 samples centered at output samples) with decimation
+//  D. The output sample m of the cycle ix is at the input sample N*ix+m*D
+//  without group delay and the filter reads D-1 samples of the previous cycle.
+static void ddc_cyc(sdr_ddc_t *ddc, int64_t ix)
+{
+    const sdr_buff_t *buff = ddc->src;
+    int N = ddc->N, D = ddc->D, M = N / D, L = N + D - 1;
+    int i = (N * (int)(ix % ddc->depth) - (D - 1) + buff->N) % buff->N;
+    double phi = ddc->fc / ddc->fs * (double)(ix * N - (D - 1));
+    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_scratch_alloc(sizeof(sdr_cpx16_t) * L);
+    float *y = (float *)sdr_scratch_alloc(sizeof(float) * M * 2);
+    double pow;
+    
+    sdr_mix_carr(buff, i, L, ddc->fs, ddc->fc, phi - floor(phi), IQ);
+    
+    // CIC filter unrolled for small decimation ratios
+    switch (D) {
+        case 2 : pow = cic_ddc(IQ, M, 2, y); break;
+        case 3 : pow = cic_ddc(IQ, M, 3, y); break;
+        case 4 : pow = cic_ddc(IQ, M, 4, y); break;
+        case 5 : pow = cic_ddc(IQ, M, 5, y); break;
+        case 6 : pow = cic_ddc(IQ, M, 6, y); break;
+        case 8 : pow = cic_ddc(IQ, M, 8, y); break;
+        default: pow = cic_ddc(IQ, M, D, y); break;
+    }
+    // quantize sub-band IF data by AGC
+    if (pow > 0.0) {
+        float s = (float)(DDC_SIG / sqrt(pow / (2 * M)));
+        ddc->scale = ddc->scale > 0.0f ? ddc->scale + DDC_AGC *
+            (s - ddc->scale) : s;
+    }
+    sdr_cpx8_t *data = ddc->buff->data + M * (int)(ix % ddc->depth);
+    sdr_dft_cache_inval(ddc->buff, M * (int)(ix % ddc->depth), M);
+    for (int m = 0; m < M; m++) {
+        data[m] = SDR_CPX8(quant_ddc(y[m*2] * ddc->scale),
+            quant_ddc(y[m*2+1] * ddc->scale));
+    }
+    sdr_scratch_free(y);
+    sdr_scratch_free(IQ);
+}
+
+//------------------------------------------------------------------------------
+//  Get the decimation ratio of a sub-band DDC (digital down converter). The
+//  ratio is the max divisor D of the IF data cycle N with the sub-band
+//  sampling rate fs / D >= fs_min.
+//
+//  args:
+//      fs       (I) sampling rate of IF data (sps)
+//      N        (I) IF data cycle (samples)
+//      fs_min   (I) min sampling rate of sub-band (sps)
+//
+//  return:
+//      decimation ratio (1: no decimation)
+//
+int sdr_ddc_dec(double fs, int N, double fs_min)
+{
+    int D = 1;
+    
+    for (int d = 2; d <= N && fs / d >= fs_min; d++) {
+        if (N % d == 0) D = d;
+    }
+    return D;
 }
 
-// mix carrier and FFT correlator for complex input ----------------------------
-void sdr_corr_fft_cpx(const sdr_cpx_t *buff, int len_buff, int ix, int N,
-    double fs, double fc, double phi, const sdr_cpx_t *code_fft,
-    sdr_cpx_t *corr)
+//------------------------------------------------------------------------------
+//  Generate a new sub-band DDC (digital down converter). The DDC shifts the
+//  IF data in the IF data buffer by the center frequency of the sub-band,
+//  filters and decimates them by the ratio D into the complex sub-band IF data
+//  with the sampling rate of fs / D. The sub-band IF data are stored in the
+//  sub-band IF data buffer ddc->buff of the same depth cycles as the IF data
+//  buffer.
+//
+//  args:
+//      buff     (I) IF data buffer of N * depth samples
+//      fs       (I) sampling rate of IF data (sps)
+//      fc       (I) center frequency of sub-band in IF data (Hz)
+//      N        (I) IF data cycle (samples)
+//      D        (I) decimation ratio (>= 2, N % D = 0)
+//
+//  return:
+//      sub-band DDC (NULL: error)
+//
+sdr_ddc_t *sdr_ddc_new(const sdr_buff_t *buff, double fs, double fc, int N,
+    int D)
 {
-    sdr_cpx16_t *IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
-    mix_carr_cpx(buff, len_buff, ix, N, fs, fc, phi, IQ);
-    corr_fft(IQ, code_fft, N, corr);
-    sdr_free(IQ);
+    int depth = N > 0 ? buff->N / N : 0;
+    
+    if (fs <= 0.0 || D < 2 || N % D != 0 || depth < 2) return NULL;
+    sdr_ddc_t *ddc = (sdr_ddc_t *)sdr_malloc(sizeof(sdr_ddc_t));
+    ddc->src = buff;
+    ddc->fs = fs;
+    ddc->fc = fc;
+    ddc->N = N;
+    ddc->D = D;
+    ddc->depth = depth;
+    ddc->buff = sdr_buff_new(N / D * depth, 2);
+    pthread_mutex_init(&ddc->mtx, NULL);
+    return ddc;
 }
 
-// hanning window function -----------------------------------------------------
-static float hann_window(int N, float *w)
+//------------------------------------------------------------------------------
+//  Free a sub-band DDC.
+//
+//  args:
+//      ddc      (I) sub-band DDC generated by sdr_ddc_new()
+//
+//  return:
+//      none
+//
+void sdr_ddc_free(sdr_ddc_t *ddc)
 {
-    float w_ave = 0.0;
-    
-    for (int i = 0; i < N; i++) {
-        w[i] = 0.5 + 0.5 * cos(2.0 * PI * (i - 0.5 * (N - 1)) / (N - 1));
-        w_ave += w[i] / N;
-    }
-    return w_ave;
+    if (!ddc) return;
+    sdr_buff_free(ddc->buff);
+    pthread_mutex_destroy(&ddc->mtx);
+    sdr_free(ddc);
 }
 
 //------------------------------------------------------------------------------
-//  Power spectral density of digitalized IF (inter-frequency) data.
+//  Update a sub-band DDC to down-convert the IF data cycles ix, ..., ix + n - 1
+//  in the IF data buffer. The cycles down-converted are kept to share the
+//  sub-band IF data among the channels of the sub-band. The function is
+//  thread-safe.
 //
 //  args:
-//      buff     (I) digitalized IF data buffer
-//      len_buff (I) length of buffer
-//      N        (I) FFT size
-//      fs       (I) sampling frequency (Hz)
-//      IQ       (I) sampling type (1: I-sampling, 2: IQ-sampling)
-//      psd      (O) PSD (dB/Hz) size: N/2 (IQ=1), N (IQ=2)
+//      ddc      (I) sub-band DDC
+//      ix       (I) first IF data cycle
+//      n        (I) number of IF data cycles
 //
 //  return:
 //      none
 //
-void sdr_psd_cpx(const sdr_cpx_t *buff, int len_buff, int N, double fs, int IQ,
-    float *psd)
+void sdr_ddc_update(sdr_ddc_t *ddc, int64_t ix, int n)
 {
-    fftwf_plan plan[2];
-    
-    if (!get_fftw_plan(N, plan)) return;
-    
-    float *p = (float *)sdr_malloc(sizeof(float) * N);
-    float *w = (float *)sdr_malloc(sizeof(float) * N);
-    sdr_cpx_t *cpx1 = sdr_cpx_malloc(N);
-    sdr_cpx_t *cpx2 = sdr_cpx_malloc(N);
-    
-    float w_ave = hann_window(N, w);
-    
-    // Welch's method without overlap
-    int M = len_buff / N;
-    for (int i = 0; i < M; i++) {
-        for (int j = 0; j < N; j++) {
-            cpx1[j][0] = buff[N*i+j][0] * w[j];
-            cpx1[j][1] = buff[N*i+j][1] * w[j];
-        }
-        fftwf_execute_dft(plan[0], cpx1, cpx2);
-        for (int j = 0; j < N; j++) {
-            p[j] += SQR(cpx2[j][0]) + SQR(cpx2[j][1]);
-        }
-    }
-    // scale complies with matplotlib.psd()
-    float scale = 1.333 / N / M / w_ave / fs;
+    if (!ddc) return;
     
-    if (IQ == 1) { // I
-        for (int i = 0; i < N / 2; i++) {
-            psd[i] = 10.0f * log10f(p[i] * scale * 2.0);
-        }
+    pthread_mutex_lock(&ddc->mtx);
+    if (ix < ddc->ix[0] || ix > ddc->ix[1]) { // restart down-converted cycles
+        ddc->ix[0] = ddc->ix[1] = ix;
     }
-    else { // IQ
-        for (int i = 0; i < N / 2; i++) {
-            psd[i] = 10.0f * log10f(p[N/2+i] * scale);
-        }
-        for (int i = N / 2; i < N; i++) {
-            psd[i] = 10.0f * log10f(p[i-N/2] * scale);
-        }
+    for ( ; ddc->ix[1] < ix + n; ddc->ix[1]++) {
+        ddc_cyc(ddc, ddc->ix[1]);
     }
-    sdr_free(p);
-    sdr_free(w);
-    sdr_cpx_free(cpx1);
-    sdr_cpx_free(cpx2);
+    ddc->ix[0] = MAX(ddc->ix[0], ddc->ix[1] - ddc->depth + 1);
+    pthread_mutex_unlock(&ddc->mtx);
 }
 
 // open stream -----------------------------------------------------------------
@@ -753,7 +3574,7 @@ stream_t *sdr_str_open(const char *path)
     if (p == path) { // TCP server (path = :port)
         stat = stropen(str, STR_TCPSVR, STR_MODE_W, path);
     }
-    else if (sscanf(p, ":%d", &port) == 1) { // TCP client (path = addr:port)
+    else if (p && sscanf(p, ":%d", &port) == 1) { // TCP client (addr:port)
         stat = stropen(str, STR_TCPCLI, STR_MODE_W, path);
     }
     else { // file (path = file[::opt...])
@@ -786,23 +3607,479 @@ int sdr_str_write(stream_t *str, uint8_t *data, int size)
     return strwrite(str, data, size);
 }
 
+// flush output stream ---------------------------------------------------------
+//  The data in the ring buffer are written to each stream in up to 2 writes.
+static void flush_ostr(sdr_ostr_t *ostr)
+{
+    int64_t rp = ostr->rp, wp = __atomic_load_n(&ostr->wp, __ATOMIC_ACQUIRE);
+    
+    while (rp < wp) {
+        int off = (int)(rp % ostr->size);
+        int n = (int)MIN(wp - rp, (int64_t)(ostr->size - off));
+        for (int i = 0; i < ostr->nstr; i++) {
+            strwrite(ostr->strs[i], ostr->buff + off, n);
+        }
+        rp += n;
+    }
+    __atomic_store_n(&ostr->rp, rp, __ATOMIC_RELEASE);
+}
+
+static void flush_log_idle(void);
+
+// output stream writer thread -------------------------------------------------
+//  The thread exits if all of the output streams are closed. The per-thread
+//  log buffers of idle threads are also flushed by the thread.
+static void *ostr_thread(void *arg)
+{
+    pthread_mutex_lock(&ostr_mtx);
+    while (ostr_list) {
+        flush_log_idle();
+        for (sdr_ostr_t *p = ostr_list; p; p = p->next) {
+            flush_ostr(p);
+        }
+        sdr_cond_wait(&ostr_cond, &ostr_mtx, OSTR_CYC);
+    }
+    ostr_run = 0;
+    pthread_mutex_unlock(&ostr_mtx);
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+//  Open an output stream. The data written to the output stream are queued to
+//  the ring buffer of the stream and written to the stream in batch by the
+//  output stream writer thread. So the writers are not blocked by slow TCP
+//  clients or disk flushes. The data are fanned out to multiple streams by the
+//  stream paths separated by '+' without copies.
+//
+//  args:
+//      path     (I)  stream path (see sdr_str_open()) or stream paths
+//                    separated by '+' (up to SDR_MAX_OSTR)
+//      size     (I)  size of ring buffer (bytes)
+//      opt      (I)  options (OR of the followings)
+//                      SDR_OSTR_DROP: drop data if the ring buffer is full
+//                                     (default: wait for space)
+//                      SDR_OSTR_MP  : multiple producers (lock among them)
+//
+//  returns:
+//      output stream (NULL: error)
+//
+sdr_ostr_t *sdr_ostr_open(const char *path, int size, int opt)
+{
+    stream_t *strs[SDR_MAX_OSTR];
+    char buff[1024], *p = buff, *q;
+    int nstr = 0;
+    
+    snprintf(buff, sizeof(buff), "%s", path);
+    do {
+        if ((q = strchr(p, '+'))) *q = '\0';
+        if (nstr >= SDR_MAX_OSTR || !(strs[nstr] = sdr_str_open(p))) {
+            for (int i = 0; i < nstr; i++) {
+                sdr_str_close(strs[i]);
+                sdr_free(strs[i]);
+            }
+            return NULL;
+        }
+        nstr++;
+        p = q + 1;
+    } while (q);
+    
+    sdr_ostr_t *ostr = (sdr_ostr_t *)sdr_malloc(sizeof(sdr_ostr_t));
+    memcpy(ostr->strs, strs, sizeof(stream_t *) * nstr);
+    ostr->nstr = nstr;
+    ostr->buff = (uint8_t *)sdr_malloc(size);
+    ostr->size = size;
+    ostr->opt = opt;
+    pthread_mutex_init(&ostr->mtx, NULL);
+    
+    pthread_mutex_lock(&ostr_mtx);
+    ostr->next = ostr_list;
+    ostr_list = ostr;
+    if (!ostr_run) {
+        pthread_t thread;
+        if (!pthread_create(&thread, NULL, ostr_thread, NULL)) {
+            pthread_detach(thread);
+            ostr_run = 1;
+        }
+    }
+    pthread_mutex_unlock(&ostr_mtx);
+    return ostr;
+}
+
+//------------------------------------------------------------------------------
+//  Close an output stream. The queued data are written before closed.
+//
+//  args:
+//      ostr     (I)  output stream (NULL: no operation)
+//
+//  returns:
+//      none
+//
+void sdr_ostr_close(sdr_ostr_t *ostr)
+{
+    if (!ostr) return;
+    
+    pthread_mutex_lock(&ostr_mtx);
+    flush_ostr(ostr);
+    for (sdr_ostr_t **p = &ostr_list; *p; p = &(*p)->next) {
+        if (*p != ostr) continue;
+        *p = ostr->next;
+        break;
+    }
+    pthread_cond_signal(&ostr_cond);
+    pthread_mutex_unlock(&ostr_mtx);
+    
+    for (int i = 0; i < ostr->nstr; i++) {
+        sdr_str_close(ostr->strs[i]);
+        sdr_free(ostr->strs[i]);
+    }
+    sdr_free(ostr->buff);
+    pthread_mutex_destroy(&ostr->mtx);
+    sdr_free(ostr);
+}
+
+//------------------------------------------------------------------------------
+//  Write data to an output stream. The data are queued to the ring buffer
+//  without lock for a single producer. The writer thread is woken up if the
+//  ring buffer is more than half full.
+//
+//  args:
+//      ostr     (IO) output stream (NULL: no operation)
+//      data     (I)  data
+//      size     (I)  size of data (bytes)
+//
+//  returns:
+//      size of data queued (bytes) (0: dropped)
+//
+int sdr_ostr_write(sdr_ostr_t *ostr, const uint8_t *data, int size)
+{
+    if (!ostr || size <= 0) return 0;
+    
+    if (size > ostr->size) {
+        __atomic_add_fetch(&ostr->ndrop, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+    if (ostr->opt & SDR_OSTR_MP) {
+        pthread_mutex_lock(&ostr->mtx);
+    }
+    int64_t wp = __atomic_load_n(&ostr->wp, __ATOMIC_RELAXED), nq;
+    
+    while ((nq = wp + size - __atomic_load_n(&ostr->rp, __ATOMIC_ACQUIRE)) >
+           ostr->size) {
+        if (ostr->opt & SDR_OSTR_DROP) {
+            __atomic_add_fetch(&ostr->ndrop, 1, __ATOMIC_RELAXED);
+            size = 0;
+            break;
+        }
+        pthread_cond_signal(&ostr_cond);
+        sdr_sleep_msec(1);
+    }
+    if (size > 0) {
+        int off = (int)(wp % ostr->size), n = MIN(size, ostr->size - off);
+        memcpy(ostr->buff + off, data, n);
+        memcpy(ostr->buff, data + n, size - n);
+        __atomic_store_n(&ostr->wp, wp + size, __ATOMIC_RELEASE);
+        
+        // wake up writer thread if ring buffer half full
+        if (nq > ostr->size / 2) {
+            pthread_cond_signal(&ostr_cond);
+        }
+    }
+    if (ostr->opt & SDR_OSTR_MP) {
+        pthread_mutex_unlock(&ostr->mtx);
+    }
+    return size;
+}
+
+// lock and unlock per-thread binary log buffer -------------------------------
+//  The buffer is handed over between the owner thread and the flusher (the
+//  output stream writer thread or sdr_log_close()) by the lock. The lock is
+//  held only while records are appended or written to the log stream.
+static int trylock_log_tbuf(log_tbuf_t *tb)
+{
+    int unlocked = 0;
+    return __atomic_compare_exchange_n(&tb->lock, &unlocked, 1, 0,
+        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static void lock_log_tbuf(log_tbuf_t *tb)
+{
+    while (!trylock_log_tbuf(tb)) ;
+}
+
+static void unlock_log_tbuf(log_tbuf_t *tb)
+{
+    __atomic_store_n(&tb->lock, 0, __ATOMIC_RELEASE);
+}
+
+// flush per-thread binary log buffer -----------------------------------------
+//  The buffer shall be locked.
+static void flush_log_tbuf(log_tbuf_t *tb)
+{
+    if (tb->n > 0) {
+        sdr_ostr_write(log_str, tb->buff, tb->n);
+    }
+    tb->n = 0;
+    tb->tick = sdr_get_tick();
+}
+
+// flush per-thread binary log buffers of idle threads -------------------------
+//  Called by the output stream writer thread with ostr_mtx locked, so log_str
+//  is not closed while flushed. The buffers locked by the owners are skipped.
+static void flush_log_idle(void)
+{
+    uint32_t tick = sdr_get_tick();
+    
+    if (!log_str) return;
+    
+    for (log_tbuf_t *tb = __atomic_load_n(&log_tbufs, __ATOMIC_ACQUIRE); tb;
+         tb = tb->next) {
+        if (!trylock_log_tbuf(tb)) continue;
+        if (tb->n > 0 && (int)(tick - tb->tick) >= LOG_FLUSH) {
+            flush_log_tbuf(tb);
+        }
+        unlock_log_tbuf(tb);
+    }
+}
+
+// release per-thread binary log buffer at thread exit -------------------------
+//  The buffer is flushed by the owner thread.
+static void free_log_tbuf(void *arg)
+{
+    log_tbuf_t *tb = (log_tbuf_t *)arg;
+    lock_log_tbuf(tb);
+    flush_log_tbuf(tb);
+    __atomic_store_n(&tb->used, 0, __ATOMIC_RELEASE);
+    unlock_log_tbuf(tb);
+}
+
+static void init_log_tbuf(void)
+{
+    pthread_key_create(&log_tbuf_key, free_log_tbuf);
+}
+
+// get per-thread binary log buffer --------------------------------------------
+//  The buffers released by exited threads are reused by new threads.
+static log_tbuf_t *get_log_tbuf(void)
+{
+    log_tbuf_t *tb;
+    
+    if (log_tbuf) return log_tbuf;
+    
+    pthread_once(&log_tbuf_once, init_log_tbuf);
+    
+    for (tb = __atomic_load_n(&log_tbufs, __ATOMIC_ACQUIRE); tb; tb = tb->next) {
+        int unused = 0;
+        if (__atomic_compare_exchange_n(&tb->used, &unused, 1, 0,
+                __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) break;
+    }
+    if (!tb) {
+        tb = (log_tbuf_t *)sdr_malloc(sizeof(log_tbuf_t));
+        tb->used = 1;
+        tb->lock = 0;
+        tb->n = 0;
+        tb->next = __atomic_load_n(&log_tbufs, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&log_tbufs, &tb->next, tb, 0,
+                   __ATOMIC_RELEASE, __ATOMIC_RELAXED)) ;
+    }
+    lock_log_tbuf(tb);
+    tb->tick = sdr_get_tick();
+    unlock_log_tbuf(tb);
+    pthread_setspecific(log_tbuf_key, tb);
+    return log_tbuf = tb;
+}
+
+// put binary log record header ------------------------------------------------
+static int put_log_head(uint8_t *buff, int type, int len, int id)
+{
+    uint16_t u[2] = {(uint16_t)len, (uint16_t)id};
+    buff[0] = SDR_LOG_SYNC;
+    buff[1] = (uint8_t)type;
+    memcpy(buff + 2, u, 4);
+    return 6;
+}
+
+// parse conversion specification of log format --------------------------------
+//  The argument types are returned as 'i' (int), 'l' (long), 'q' (long long),
+//  'z' (size_t), 'd' (double), 's' (string) or 'p' (pointer) with '*' for the
+//  width and the precision.
+static const char *log_spec(const char *p, char *types)
+{
+    int n = 0, nl = 0, nz = 0;
+    
+    p += strspn(p + 1, "-+ #0'") + 1;
+    if (*p == '*') types[n++] = '*', p++;
+    while (*p >= '0' && *p <= '9') p++;
+    if (*p == '.') {
+        if (*++p == '*') types[n++] = '*', p++;
+        while (*p >= '0' && *p <= '9') p++;
+    }
+    for ( ; *p && strchr("hlLqjzt", *p); p++) {
+        if (*p == 'l') nl++;
+        else if (*p == 'q' || *p == 'j') nl += 2;
+        else if (*p == 'z' || *p == 't') nz++;
+    }
+    switch (*p) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+            types[n++] = nz ? 'z' : (nl > 1 ? 'q' : (nl ? 'l' : 'i')); break;
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a':
+        case 'A':
+            types[n++] = 'd'; break;
+        case 's': types[n++] = 's'; break;
+        case 'p': types[n++] = 'p'; break;
+        case '\0': types[0] = '\0'; return p;
+        default: n = 0; break; // %%
+    }
+    types[n] = '\0';
+    return p + 1;
+}
+
+// get binary log format ID ----------------------------------------------------
+//  The format string is identified by the contents (FNV-1a hash) in a
+//  lock-free hash table of the copies of the format strings. So the same
+//  formats at different addresses share an ID and the formats in non-static
+//  buffers are not confused. The format definition record is written to the
+//  log stream before the first log record by the format.
+static int log_fmt_id(const char *fmt)
+{
+    uint32_t h = 2166136261u;
+    char *copy = NULL;
+    
+    for (const char *p = fmt; *p; p++) {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+    }
+    for (int i = 0; i < LOG_MAX_FMT; i++) {
+        int id = (int)((h + i) % LOG_MAX_FMT);
+        char *p = __atomic_load_n(&log_fmts[id], __ATOMIC_ACQUIRE);
+        if (!p) {
+            if (!copy) {
+                copy = (char *)sdr_malloc(strlen(fmt) + 1);
+                strcpy(copy, fmt);
+            }
+            if (__atomic_compare_exchange_n(&log_fmts[id], &p, copy, 0,
+                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                p = copy;
+                copy = NULL;
+            }
+        }
+        if (strcmp(p, fmt)) continue;
+        sdr_free(copy);
+        if (!__atomic_load_n(&log_fdef[id], __ATOMIC_ACQUIRE)) {
+            uint8_t buff[LOG_MAX_REC];
+            int len = MIN((int)strlen(fmt), LOG_MAX_REC - 6);
+            put_log_head(buff, SDR_LOG_FDEF, len, id);
+            memcpy(buff + 6, fmt, len);
+            if (!sdr_ostr_write(log_str, buff, len + 6)) return -1;
+            __atomic_store_n(&log_fdef[id], 1, __ATOMIC_RELEASE);
+        }
+        return id;
+    }
+    sdr_free(copy);
+    return -1;
+}
+
+// encode binary log record ----------------------------------------------------
+static int encode_log(uint8_t *buff, int id, const char *fmt, va_list ap)
+{
+    char types[4];
+    int n = 6;
+    
+    for (const char *p = fmt; (p = strchr(p, '%')); ) {
+        p = log_spec(p, types);
+        for (int i = 0; types[i] && n <= LOG_MAX_REC - 8; i++) {
+            if (types[i] == 'i' || types[i] == '*') {
+                int32_t v = va_arg(ap, int);
+                memcpy(buff + n, &v, 4); n += 4;
+            }
+            else if (strchr("lqz", types[i])) {
+                int64_t v = types[i] == 'l' ? (int64_t)va_arg(ap, long) :
+                    types[i] == 'q' ? (int64_t)va_arg(ap, long long) :
+                    (int64_t)va_arg(ap, size_t);
+                memcpy(buff + n, &v, 8); n += 8;
+            }
+            else if (types[i] == 'd') {
+                double v = va_arg(ap, double);
+                memcpy(buff + n, &v, 8); n += 8;
+            }
+            else if (types[i] == 'p') {
+                uint64_t v = (uint64_t)(uintptr_t)va_arg(ap, void *);
+                memcpy(buff + n, &v, 8); n += 8;
+            }
+            else {
+                const char *str = va_arg(ap, const char *);
+                uint16_t len = (uint16_t)MIN(strlen(str),
+                    (size_t)(LOG_MAX_REC - 8 - n));
+                memcpy(buff + n, &len, 2);
+                memcpy(buff + n + 2, str, len);
+                n += len + 2;
+            }
+        }
+    }
+    put_log_head(buff, SDR_LOG_DATA, n - 6, id);
+    return n;
+}
+
+// output binary log -----------------------------------------------------------
+//  The log record is encoded without formatting into the per-thread log buffer
+//  and the buffer is written to the log stream if nearly full or by LOG_FLUSH.
+//  The buffer of a thread idle after logging is flushed by flush_log_idle().
+static void out_log_bin(const char *fmt, va_list ap)
+{
+    log_tbuf_t *tb = get_log_tbuf();
+    int id = log_fmt_id(fmt);
+    
+    if (id < 0) return;
+    
+    lock_log_tbuf(tb);
+    if (tb->n + LOG_MAX_REC > LOG_TBUF_SIZE) {
+        flush_log_tbuf(tb);
+    }
+    tb->n += encode_log(tb->buff + tb->n, id, fmt, ap);
+    
+    if (tb->n + LOG_MAX_REC > LOG_TBUF_SIZE ||
+        (int)(sdr_get_tick() - tb->tick) >= LOG_FLUSH) {
+        flush_log_tbuf(tb);
+    }
+    unlock_log_tbuf(tb);
+}
+
 // open log --------------------------------------------------------------------
 int sdr_log_open(const char *path)
 {
     if (!*path || log_str) return 0;
     
-    if (!(log_str = sdr_str_open(path))) {
+    if (!(log_str = sdr_ostr_open(path, LOG_STR_SIZE,
+        SDR_OSTR_DROP | SDR_OSTR_MP))) {
         fprintf(stderr, "log stream open error %s\n", path);
         return 0;
     }
+    // format definitions written again to new log stream
+    for (int i = 0; i < LOG_MAX_FMT; i++) {
+        __atomic_store_n(&log_fdef[i], 0, __ATOMIC_RELEASE);
+    }
     return 1;
 }
 
 // close log -------------------------------------------------------------------
+//  The per-thread log buffers of exited threads were flushed by the threads at
+//  exit. The buffers of running threads are flushed after the owners release
+//  them by the buffer locks. The log should be closed after stopping the
+//  threads to output log.
 void sdr_log_close(void)
 {
-    sdr_str_close(log_str);
+    sdr_ostr_t *str = log_str;
+    
+    if (!str) return;
+    
+    for (log_tbuf_t *tb = __atomic_load_n(&log_tbufs, __ATOMIC_ACQUIRE); tb;
+         tb = tb->next) {
+        lock_log_tbuf(tb);
+        flush_log_tbuf(tb);
+        unlock_log_tbuf(tb);
+    }
+    pthread_mutex_lock(&ostr_mtx);
     log_str = NULL;
+    pthread_mutex_unlock(&ostr_mtx);
+    sdr_ostr_close(str);
 }
 
 // set log level ---------------------------------------------------------------
@@ -811,6 +4088,29 @@ void sdr_log_level(int level)
     log_lvl = level;
 }
 
+//------------------------------------------------------------------------------
+//  Set log format. In the binary format, the log records are output without
+//  formatting as follows and converted to the text format by sdr_log_conv().
+//  The log formats are identified by the contents of the format strings and
+//  the log buffer by sdr_get_log() is not available in the binary format.
+//
+//    format definition: SYNC(1) SDR_LOG_FDEF(1) LEN(2) ID(2) FORMAT(LEN)
+//    log data         : SYNC(1) SDR_LOG_DATA(1) LEN(2) ID(2) ARGS(LEN)
+//
+//    (SYNC: SDR_LOG_SYNC, ARGS: int as int32, long and long long as int64,
+//     double as float64 and string as length(uint16) + chars, little-endian)
+//
+//  args:
+//      format    (I)  log format (SDR_LOG_TEXT: text, SDR_LOG_BIN: binary)
+//
+//  returns:
+//      none
+//
+void sdr_log_format(int format)
+{
+    log_fmt = format;
+}
+
 // output log ------------------------------------------------------------------
 void sdr_log(int level, const char *msg, ...)
 {
@@ -821,13 +4121,16 @@ void sdr_log(int level, const char *msg, ...)
     if (log_lvl == 0) {
         vprintf(msg, ap);
     }
+    else if (level <= log_lvl && log_fmt == SDR_LOG_BIN) {
+        if (log_str) out_log_bin(msg, ap);
+    }
     else if (level <= log_lvl) {
         char buff[1024];
         int len = vsnprintf(buff, sizeof(buff) - 2, msg, ap);
         len = MIN(len, (int)sizeof(buff) - 3);
         if (log_str) {
             sprintf(buff + len, "\r\n");
-            strwrite(log_str, (uint8_t *)buff, len + 2);
+            sdr_ostr_write(log_str, (uint8_t *)buff, len + 2);
         }
         pthread_mutex_lock(&log_buff_mtx);
         if (log_buff_p + len + 1 < MAX_LOG_BUFF) {
@@ -838,6 +4141,152 @@ void sdr_log(int level, const char *msg, ...)
     va_end(ap);
 }
 
+// decode binary log record to text --------------------------------------------
+static int decode_log(const uint8_t *buff, int len, const char *fmt, char *str,
+    int size)
+{
+    char types[4], spec[64], arg[LOG_MAX_REC];
+    const char *p = fmt, *q;
+    int n = 0, m = 0;
+    
+    while ((q = strchr(p, '%')) && m < size) {
+        int k = MIN((int)(q - p), size - m - 1);
+        memcpy(str + m, p, k);
+        m += k;
+        p = log_spec(q, types);
+        snprintf(spec, sizeof(spec), "%.*s", (int)(p - q), q);
+        int w[2] = {0}, nw = 0;
+        for (int i = 0; types[i]; i++) {
+            int32_t vi;
+            int64_t vl;
+            double vd;
+            uint16_t ns;
+            char *out = str + m;
+            int rem = size - m;
+            
+            if (types[i] == '*') {
+                if (n + 4 > len) return 0;
+                memcpy(&vi, buff + n, 4); n += 4;
+                w[nw++ & 1] = vi;
+                continue;
+            }
+            if (types[i] == 'i') {
+                if (n + 4 > len) return 0;
+                memcpy(&vi, buff + n, 4); n += 4;
+                k = nw == 0 ? snprintf(out, rem, spec, vi) :
+                    nw == 1 ? snprintf(out, rem, spec, w[0], vi) :
+                    snprintf(out, rem, spec, w[0], w[1], vi);
+            }
+            else if (types[i] == 'p') {
+                if (n + 8 > len) return 0;
+                memcpy(&vl, buff + n, 8); n += 8;
+                k = snprintf(out, rem, "0x%llx", (unsigned long long)vl);
+            }
+            else if (types[i] == 'l') {
+                if (n + 8 > len) return 0;
+                memcpy(&vl, buff + n, 8); n += 8;
+                k = nw == 0 ? snprintf(out, rem, spec, (long)vl) :
+                    nw == 1 ? snprintf(out, rem, spec, w[0], (long)vl) :
+                    snprintf(out, rem, spec, w[0], w[1], (long)vl);
+            }
+            else if (types[i] == 'q' || types[i] == 'z') {
+                if (n + 8 > len) return 0;
+                memcpy(&vl, buff + n, 8); n += 8;
+                if (types[i] == 'z') {
+                    size_t v = (size_t)vl;
+                    k = nw == 0 ? snprintf(out, rem, spec, v) :
+                        nw == 1 ? snprintf(out, rem, spec, w[0], v) :
+                        snprintf(out, rem, spec, w[0], w[1], v);
+                }
+                else {
+                    long long v = (long long)vl;
+                    k = nw == 0 ? snprintf(out, rem, spec, v) :
+                        nw == 1 ? snprintf(out, rem, spec, w[0], v) :
+                        snprintf(out, rem, spec, w[0], w[1], v);
+                }
+            }
+            else if (types[i] == 'd') {
+                if (n + 8 > len) return 0;
+                memcpy(&vd, buff + n, 8); n += 8;
+                k = nw == 0 ? snprintf(out, rem, spec, vd) :
+                    nw == 1 ? snprintf(out, rem, spec, w[0], vd) :
+                    snprintf(out, rem, spec, w[0], w[1], vd);
+            }
+            else {
+                if (n + 2 > len) return 0;
+                memcpy(&ns, buff + n, 2);
+                if (n + 2 + ns > len) return 0;
+                memcpy(arg, buff + n + 2, ns);
+                arg[ns] = '\0';
+                n += ns + 2;
+                k = nw == 0 ? snprintf(out, rem, spec, arg) :
+                    nw == 1 ? snprintf(out, rem, spec, w[0], arg) :
+                    snprintf(out, rem, spec, w[0], w[1], arg);
+            }
+            m += MIN(MAX(k, 0), rem - 1);
+        }
+        if (!types[0] && *q && q[1] == '%' && m < size - 1) {
+            str[m++] = '%';
+        }
+    }
+    m += snprintf(str + m, size - m, "%s", p);
+    return MIN(m, size - 1);
+}
+
+//------------------------------------------------------------------------------
+//  Convert binary log to text log. The log records in the binary format (see
+//  sdr_log_format()) are converted to the text lines as same as the log in the
+//  text format. The broken records are skipped by searching the sync code.
+//  The log records are buffered per thread and the buffers are written to the
+//  log in flush order. So the records are in order within a thread but the
+//  records of different threads are interleaved by the flushes (up to
+//  LOG_FLUSH ms) and are not in global time order.
+//
+//  args:
+//      ifp       (I)  input file pointer of binary log
+//      ofp       (I)  output file pointer of text log
+//
+//  returns:
+//      number of converted log records
+//
+int sdr_log_conv(FILE *ifp, FILE *ofp)
+{
+    char *fmts[LOG_MAX_FMT] = {0}, str[LOG_MAX_REC * 4];
+    uint8_t buff[LOG_MAX_REC + 6];
+    int c, nrec = 0;
+    
+    while ((c = fgetc(ifp)) != EOF) {
+        uint16_t u[2];
+        if (c != SDR_LOG_SYNC) continue;
+        buff[0] = (uint8_t)c;
+        if (fread(buff + 1, 5, 1, ifp) < 1) break;
+        memcpy(u, buff + 2, 4);
+        int len = u[0], id = u[1];
+        if ((buff[1] != SDR_LOG_FDEF && buff[1] != SDR_LOG_DATA) ||
+            len > LOG_MAX_REC - 6 || id >= LOG_MAX_FMT) {
+            fseek(ifp, -5, SEEK_CUR); // resync
+            continue;
+        }
+        if (fread(buff + 6, 1, len, ifp) < (size_t)len) break;
+        
+        if (buff[1] == SDR_LOG_FDEF) {
+            sdr_free(fmts[id]);
+            fmts[id] = (char *)sdr_malloc(len + 1);
+            memcpy(fmts[id], buff + 6, len);
+            fmts[id][len] = '\0';
+        }
+        else if (fmts[id]) {
+            int n = decode_log(buff + 6, len, fmts[id], str, sizeof(str) - 2);
+            fprintf(ofp, "%.*s\r\n", n, str);
+            nrec++;
+        }
+    }
+    for (int i = 0; i < LOG_MAX_FMT; i++) {
+        sdr_free(fmts[i]);
+    }
+    return nrec;
+}
+
 // get log buffer --------------------------------------------------------------
 int sdr_get_log(char *buff, int size)
 {
@@ -24,39 +24,40 @@
 //  2023-01-07  1.1  support IRNV1_SF2 and IRNV1_SF3 in decode_LDPC()
 //  2023-01-09  1.2  support BCNV1_SF2, BCNV1_SF3, BCNV2, BCNV3 in decode_LDPC()
 //  2023-01-16  1.3  fix memory leak and unable decoding of LDPC
+//  2026-10-14  1.4  replace probability propagation decoder of binary LDPC by
+//                   layered normalized min-sum decoder with fixed-point LLR
+//                   add API sdr_decode_LDPC_soft()
 //
 #include "pocket_sdr.h"
+#if defined(AVX2)
+#include <immintrin.h>
+#endif
 
 // constants -------------------------------------------------------------------
-#define MAX_ITER  250
-#define ERR_PROB  1e-5
+#define MAX_ITER  50          // max number of iterations
+#define MAX_N     1200        // max length of codes
+#define MAX_EDGE  8192        // max number of edges
+#define MAX_DEG   32          // max degree of check nodes
+#define LLR_SYM   16          // max LLR of input binary code
+#define LLR_MAX   0x3FFF      // max LLR of variable nodes
+#define MSG_MAX   127         // max check node messages
 
-// function prototypes of LDPC-codes ([1],[2]) ---------------------------------
-#ifdef __cplusplus
-extern "C" {
-#endif
-extern int max_iter;
-void *mod2sparse_allocate(int, int);
-void *mod2sparse_insert(void *, int, int);
-void mod2sparse_free(void *);
-void prprp_decode_setup(void);
-unsigned int prprp_decode(void *, double *, char *, char *, double *);
-int check(void *, char *, char *);
-double changed(double *, char *, int);
-#ifdef __cplusplus
-}
-#endif
+#define MIN(x, y) ((x) < (y) ? (x) : (y))
 
-// global variables ------------------------------------------------------------
-static const double RATIO[] = {
-    (1.0 - ERR_PROB) / ERR_PROB, ERR_PROB / (1.0 - ERR_PROB)
-};
+// type definitions ------------------------------------------------------------
+typedef struct {              // binary LDPC parity check matrix
+    int m, n;                 // number of check nodes and variable nodes
+    int ne;                   // number of edges
+    uint16_t *row;            // edge index of check nodes (m + 1)
+    uint16_t *col;            // variable node index of edges (ne)
+} ldpc_H_t;
 
 // LDPC H-matrix cache ---------------------------------------------------------
-static void *H_CNV2_SF2  = NULL;
-static void *H_CNV2_SF3  = NULL;
-static void *H_IRNV1_SF2 = NULL;
-static void *H_IRNV1_SF3 = NULL;
+static ldpc_H_t *H_CNV2_SF2  = NULL;
+static ldpc_H_t *H_CNV2_SF3  = NULL;
+static ldpc_H_t *H_IRNV1_SF2 = NULL;
+static ldpc_H_t *H_IRNV1_SF3 = NULL;
+static pthread_mutex_t H_mtx = PTHREAD_MUTEX_INITIALIZER;
 
 // CNAV-2 LDPC H-matrix table ([3]) --------------------------------------------
 
@@ -2192,105 +2193,260 @@ static const uint16_t H_IRNV1_SF3_T[][2] = { // [7] table 41
     {179,179}, {212,189}, {200,200}, {233,210}, {221,221}, {234,234}
 };
 
+// add edge to binary LDPC parity check matrix --------------------------------
+static void add_edge(uint16_t (*E)[2], int *ne, int i, int j)
+{
+    E[*ne][0] = (uint16_t)i;
+    E[*ne][1] = (uint16_t)j;
+    (*ne)++;
+}
+
 // generate binary LDPC parity check matrix ------------------------------------
-static void *gen_B_LDPC_H(int m, int n, int g, const uint16_t H_A[][2],
+//  The matrix is stored as edge lists of check nodes. Duplicated edges are
+//  ignored.
+static ldpc_H_t *gen_B_LDPC_H(int m, int n, int g, const uint16_t H_A[][2],
     const uint16_t H_B[][2], const uint16_t H_C[][2], const uint16_t H_D[][2],
     const uint16_t H_E[][2], const uint16_t H_T[][2], int na, int nb, int nc,
     int nd, int ne, int nt)
 {
-    void *H = mod2sparse_allocate(m, n);
+    int nmax = na + nb + nc + nd + ne + nt, k = 0;
+    uint16_t (*E)[2] = (uint16_t (*)[2])sdr_malloc(sizeof(uint16_t) * 2 *
+        nmax);
     
     for (int i = 0; i < na; i++) {
-        mod2sparse_insert(H, H_A[i][0] - 1, H_A[i][1] - 1);
+        add_edge(E, &k, H_A[i][0] - 1, H_A[i][1] - 1);
     }
     for (int i = 0; i < nb; i++) {
-        mod2sparse_insert(H, H_B[i][0] - 1, m + H_B[i][1] - 1);
+        add_edge(E, &k, H_B[i][0] - 1, m + H_B[i][1] - 1);
     }
     for (int i = 0; i < nc; i++) {
-        mod2sparse_insert(H, m - g + H_C[i][0] - 1, H_C[i][1] - 1);
+        add_edge(E, &k, m - g + H_C[i][0] - 1, H_C[i][1] - 1);
     }
     for (int i = 0; i < nd; i++) {
-        mod2sparse_insert(H, m - g + H_D[i][0] - 1, m + H_D[i][1] - 1);
+        add_edge(E, &k, m - g + H_D[i][0] - 1, m + H_D[i][1] - 1);
     }
     for (int i = 0; i < ne; i++) {
-        mod2sparse_insert(H, m - g + H_E[i][0] - 1, m + g + H_E[i][1] - 1);
+        add_edge(E, &k, m - g + H_E[i][0] - 1, m + g + H_E[i][1] - 1);
     }
     for (int i = 0; i < nt; i++) {
-        mod2sparse_insert(H, H_T[i][0] - 1, m + g + H_T[i][1] - 1);
+        add_edge(E, &k, H_T[i][0] - 1, m + g + H_T[i][1] - 1);
+    }
+    ldpc_H_t *H = (ldpc_H_t *)sdr_malloc(sizeof(ldpc_H_t));
+    H->m = m;
+    H->n = n;
+    H->ne = 0;
+    H->row = (uint16_t *)sdr_malloc(sizeof(uint16_t) * (m + 1));
+    H->col = (uint16_t *)sdr_malloc(sizeof(uint16_t) * nmax);
+    
+    for (int i = 0; i < m; i++) {
+        H->row[i] = (uint16_t)H->ne;
+        for (int j = 0; j < k; j++) {
+            if (E[j][0] != i) continue;
+            int dup = 0;
+            for (int e = H->row[i]; e < H->ne && !dup; e++) {
+                dup = H->col[e] == E[j][1];
+            }
+            if (!dup && H->ne - H->row[i] < MAX_DEG && H->ne < MAX_EDGE) {
+                H->col[H->ne++] = E[j][1];
+            }
+        }
     }
+    H->row[m] = (uint16_t)H->ne;
+    sdr_free(E);
     return H;
 }
 
-// free binary LDPC parity check matrix ----------------------------------------
-#if 0
-static void free_B_LDPC_H(void *H)
+// saturate LLR ----------------------------------------------------------------
+static int16_t sat_llr(int x)
 {
-    mod2sparse_free(H);
+    return (int16_t)(x > LLR_MAX ? LLR_MAX : (x < -LLR_MAX ? -LLR_MAX : x));
+}
+
+// normalize check node message (x 0.75) ---------------------------------------
+static int norm_msg(int x)
+{
+    return MIN((x * 3) >> 2, MSG_MAX);
+}
+
+// update check node -----------------------------------------------------------
+//  The check node messages R are updated by the normalized min-sum and the
+//  LLRs L of the variable nodes are updated by the messages.
+static void update_chk_c(const uint16_t *col, int deg, int16_t *L, int8_t *R)
+{
+    int16_t Q[MAX_DEG];
+    int min1 = LLR_MAX, min2 = LLR_MAX, imin = 0, sgn = 0;
+    
+    for (int i = 0; i < deg; i++) {
+        Q[i] = sat_llr(L[col[i]] - R[i]);
+        int a = Q[i] < 0 ? -Q[i] : Q[i];
+        sgn ^= Q[i] < 0;
+        if (a < min1) {
+            min2 = min1;
+            min1 = a;
+            imin = i;
+        }
+        else if (a < min2) {
+            min2 = a;
+        }
+    }
+    int r1 = norm_msg(min1), r2 = norm_msg(min2);
+    
+    for (int i = 0; i < deg; i++) {
+        int r = i == imin ? r2 : r1;
+        R[i] = (int8_t)(sgn ^ (Q[i] < 0) ? -r : r);
+        L[col[i]] = sat_llr(Q[i] + R[i]);
+    }
+}
+
+#if defined(AVX2)
+// update check node (SSE4) ----------------------------------------------------
+//  The check node of degree <= 8 is updated as 8 x 16-bit lanes. The min and
+//  the index of |Q| are searched by PHMINPOSUW.
+SDR_TARGET_SSE4
+static void update_chk_sse4(const uint16_t *col, int deg, int16_t *L,
+    int8_t *R)
+{
+    int16_t q[8], r[8];
+    
+    for (int i = 0; i < deg; i++) {
+        q[i] = sat_llr(L[col[i]] - R[i]);
+    }
+    for (int i = deg; i < 8; i++) {
+        q[i] = LLR_MAX;
+    }
+    __m128i xq = _mm_loadu_si128((__m128i *)q);
+    __m128i xa = _mm_abs_epi16(xq);
+    __m128i xm1 = _mm_minpos_epu16(xa);
+    int min1 = _mm_extract_epi16(xm1, 0), imin = _mm_extract_epi16(xm1, 1);
+    __m128i xi = _mm_cmpeq_epi16(_mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm_set1_epi16((int16_t)imin));
+    __m128i xm2 = _mm_minpos_epu16(_mm_or_si128(xa, xi));
+    int min2 = MIN(_mm_extract_epi16(xm2, 0), LLR_MAX);
+    __m128i xs = _mm_srai_epi16(xq, 15);
+    int sgn = __builtin_popcount(_mm_movemask_epi8(xs)) / 2 % 2;
+    __m128i xr = _mm_blendv_epi8(_mm_set1_epi16((int16_t)norm_msg(min1)),
+        _mm_set1_epi16((int16_t)norm_msg(min2)), xi);
+    xs = _mm_xor_si128(xs, _mm_set1_epi16((int16_t)-sgn));
+    xr = _mm_sign_epi16(xr, _mm_or_si128(xs, _mm_set1_epi16(1)));
+    __m128i xl = _mm_adds_epi16(xq, xr);
+    xl = _mm_max_epi16(_mm_min_epi16(xl, _mm_set1_epi16(LLR_MAX)),
+        _mm_set1_epi16(-LLR_MAX));
+    _mm_storeu_si128((__m128i *)q, xl);
+    _mm_storeu_si128((__m128i *)r, xr);
+    
+    for (int i = 0; i < deg; i++) {
+        R[i] = (int8_t)r[i];
+        L[col[i]] = q[i];
+    }
+}
+#endif // AVX2
+
+// test parity checks ----------------------------------------------------------
+static int test_chk(const ldpc_H_t *H, const int16_t *L)
+{
+    for (int i = 0; i < H->m; i++) {
+        int p = 0;
+        for (int e = H->row[i]; e < H->row[i+1]; e++) {
+            p ^= L[H->col[e]] < 0;
+        }
+        if (p) return 0;
+    }
+    return 1;
 }
-#endif
 
 // decode binary LDPC ----------------------------------------------------------
-static int decode_B_LDPC(void *H, int m, int n, const uint8_t *syms,
+//  The code is decoded by the layered normalized min-sum decoder with 16-bit
+//  LLRs of variable nodes and 8-bit check node messages. The decoding is
+//  terminated when all of the parity checks are satisfied. The input LLRs are
+//  the soft-decision symbols (0-255) scaled to +/-LLR_SYM. No memory is
+//  allocated and no global variable is modified.
+static int decode_B_LDPC(const ldpc_H_t *H, int m, int n, const uint8_t *syms,
     uint8_t *syms_dec)
 {
-    double *lratio = (double *)sdr_malloc(sizeof(double) * n);
-    char   *dblk   = (char   *)sdr_malloc(sizeof(char)   * n);
-    char   *pchk   = (char   *)sdr_malloc(sizeof(char)   * n);
-    double *bitpr  = (double *)sdr_malloc(sizeof(double) * n);
+    int16_t L[MAX_N];
+    int8_t R[MAX_EDGE];
+    int valid = 0, nerr = 0;
+#if defined(AVX2)
+    int simd = sdr_get_simd() >= SDR_SIMD_SSE4;
+#endif
     
     for (int i = 0; i < n; i++) {
-        lratio[i] = RATIO[syms[i]];
+        L[i] = (int16_t)((255 - 2 * syms[i]) * LLR_SYM / 255);
     }
-    // setup decoder
-    max_iter = MAX_ITER;
-    prprp_decode_setup();
+    memset(R, 0, H->ne);
     
-    // decode LDPC by probability propagation
-    prprp_decode(H, lratio, dblk, pchk, bitpr);
-    int valid = check(H, dblk, pchk) == 0;
-    int nerr = (int)changed(lratio, dblk, n);
-    
-    memcpy(syms_dec, dblk, m);
-    
-    sdr_free(lratio);
-    sdr_free(dblk);
-    sdr_free(pchk);
-    sdr_free(bitpr);
+    for (int k = 0; k < MAX_ITER && !(valid = test_chk(H, L)); k++) {
+        for (int i = 0; i < m; i++) {
+            const uint16_t *col = H->col + H->row[i];
+            int deg = H->row[i+1] - H->row[i];
+#if defined(AVX2)
+            if (simd && deg <= 8) {
+                update_chk_sse4(col, deg, L, R + H->row[i]);
+                continue;
+            }
+#endif
+            update_chk_c(col, deg, L, R + H->row[i]);
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        uint8_t bit = L[i] < 0;
+        if (i < m) syms_dec[i] = bit;
+        nerr += bit != (syms[i] >= 128);
+    }
     return valid ? nerr : -1;
 }
 
+// get binary LDPC parity check matrix -----------------------------------------
+//  The matrix is generated at the first call.
+static const ldpc_H_t *get_B_LDPC_H(ldpc_H_t **H, int m, int n, int g,
+    const uint16_t H_A[][2], const uint16_t H_B[][2], const uint16_t H_C[][2],
+    const uint16_t H_D[][2], const uint16_t H_E[][2], const uint16_t H_T[][2],
+    int na, int nb, int nc, int nd, int ne, int nt)
+{
+    ldpc_H_t *H0 = __atomic_load_n(H, __ATOMIC_ACQUIRE);
+    
+    if (!H0) {
+        pthread_mutex_lock(&H_mtx);
+        if (!(H0 = *H)) {
+            H0 = gen_B_LDPC_H(m, n, g, H_A, H_B, H_C, H_D, H_E, H_T, na, nb,
+                nc, nd, ne, nt);
+            __atomic_store_n(H, H0, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(&H_mtx);
+    }
+    return H0;
+}
+
 // decode LDPC(1200,600) of CNAV-2 subframe 2 ----------------------------------
 static int decode_LDPC_CNV2_SF2(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_CNV2_SF2) {
-        int na = (int)sizeof(H_CNV2_SF2_A) / 4;
-        int nb = (int)sizeof(H_CNV2_SF2_B) / 4;
-        int nc = (int)sizeof(H_CNV2_SF2_C) / 4;
-        int nd = (int)sizeof(H_CNV2_SF2_D) / 4;
-        int ne = (int)sizeof(H_CNV2_SF2_E) / 4;
-        int nt = (int)sizeof(H_CNV2_SF2_T) / 4;
-        H_CNV2_SF2 = gen_B_LDPC_H(600, 1200, 1, H_CNV2_SF2_A, H_CNV2_SF2_B,
-            H_CNV2_SF2_C, H_CNV2_SF2_D, H_CNV2_SF2_E, H_CNV2_SF2_T, na, nb, nc,
-            nd, ne, nt);
-    }
-    return decode_B_LDPC(H_CNV2_SF2, 600, 1200, syms, syms_dec);
+    int na = (int)sizeof(H_CNV2_SF2_A) / 4;
+    int nb = (int)sizeof(H_CNV2_SF2_B) / 4;
+    int nc = (int)sizeof(H_CNV2_SF2_C) / 4;
+    int nd = (int)sizeof(H_CNV2_SF2_D) / 4;
+    int ne = (int)sizeof(H_CNV2_SF2_E) / 4;
+    int nt = (int)sizeof(H_CNV2_SF2_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_CNV2_SF2, 600, 1200, 1,
+        H_CNV2_SF2_A, H_CNV2_SF2_B, H_CNV2_SF2_C, H_CNV2_SF2_D,
+        H_CNV2_SF2_E, H_CNV2_SF2_T, na, nb, nc, nd, ne, nt);
+    
+    return decode_B_LDPC(H, 600, 1200, syms, syms_dec);
 }
 
 // decode LDPC(548,274) of CNAV-2 subframe 3 -----------------------------------
 static int decode_LDPC_CNV2_SF3(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_CNV2_SF3) {
-        int na = (int)sizeof(H_CNV2_SF3_A) / 4;
-        int nb = (int)sizeof(H_CNV2_SF3_B) / 4;
-        int nc = (int)sizeof(H_CNV2_SF3_C) / 4;
-        int nd = (int)sizeof(H_CNV2_SF3_D) / 4;
-        int ne = (int)sizeof(H_CNV2_SF3_E) / 4;
-        int nt = (int)sizeof(H_CNV2_SF3_T) / 4;
-        H_CNV2_SF3 = gen_B_LDPC_H(274, 548, 1, H_CNV2_SF3_A, H_CNV2_SF3_B,
-            H_CNV2_SF3_C, H_CNV2_SF3_D, H_CNV2_SF3_E, H_CNV2_SF3_T, na, nb, nc,
-            nd, ne, nt);
-    }
-    return decode_B_LDPC(H_CNV2_SF3, 274, 548, syms, syms_dec);
+    int na = (int)sizeof(H_CNV2_SF3_A) / 4;
+    int nb = (int)sizeof(H_CNV2_SF3_B) / 4;
+    int nc = (int)sizeof(H_CNV2_SF3_C) / 4;
+    int nd = (int)sizeof(H_CNV2_SF3_D) / 4;
+    int ne = (int)sizeof(H_CNV2_SF3_E) / 4;
+    int nt = (int)sizeof(H_CNV2_SF3_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_CNV2_SF3, 274, 548, 1,
+        H_CNV2_SF3_A, H_CNV2_SF3_B, H_CNV2_SF3_C, H_CNV2_SF3_D,
+        H_CNV2_SF3_E, H_CNV2_SF3_T, na, nb, nc, nd, ne, nt);
+    
+    return decode_B_LDPC(H, 274, 548, syms, syms_dec);
 }
 
 // decode NB-LDPC(200,100) of B-CNAV1 subframe 2 -------------------------------
@@ -2299,7 +2455,7 @@ static int decode_LDPC_BCNV1_SF2(const uint8_t *syms, uint8_t *syms_dec)
     uint8_t syms_rev[1200];
     
     for (int i = 0; i < 1200; i++) {
-        syms_rev[i] = syms[i] ^ (uint8_t)1;
+        syms_rev[i] = (uint8_t)~syms[i];
     }
     return sdr_decode_NB_LDPC(H_BCNV1_SF2_idx, H_BCNV1_SF2_ele, 100, 200,
         syms_rev, syms_dec);
@@ -2311,7 +2467,7 @@ static int decode_LDPC_BCNV1_SF3(const uint8_t *syms, uint8_t *syms_dec)
     uint8_t syms_rev[528];
     
     for (int i = 0; i < 528; i++) {
-        syms_rev[i] = syms[i] ^ (uint8_t)1;
+        syms_rev[i] = (uint8_t)~syms[i];
     }
     return sdr_decode_NB_LDPC(H_BCNV1_SF3_idx, H_BCNV1_SF3_ele, 44, 88,
         syms_rev, syms_dec);
@@ -2333,39 +2489,38 @@ static int decode_LDPC_BCNV3(const uint8_t *syms, uint8_t *syms_dec)
 // decode LDPC(1200,600) of NavIC L1-SPS NAV subframe 2 ------------------------
 static int decode_LDPC_IRNV1_SF2(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_IRNV1_SF2) {
-        int na = (int)sizeof(H_IRNV1_SF2_A) / 4;
-        int nb = (int)sizeof(H_IRNV1_SF2_B) / 4;
-        int nc = (int)sizeof(H_IRNV1_SF2_C) / 4;
-        int nd = (int)sizeof(H_IRNV1_SF2_D) / 4;
-        int ne = (int)sizeof(H_IRNV1_SF2_E) / 4;
-        int nt = (int)sizeof(H_IRNV1_SF2_T) / 4;
-        H_IRNV1_SF2 = gen_B_LDPC_H(600, 1200, 50, H_IRNV1_SF2_A, H_IRNV1_SF2_B,
-            H_IRNV1_SF2_C, H_IRNV1_SF2_D, H_IRNV1_SF2_E, H_IRNV1_SF2_T, na, nb,
-            nc, nd, ne, nt);
-    }
-    return decode_B_LDPC(H_IRNV1_SF2, 600, 1200, syms, syms_dec);
+    int na = (int)sizeof(H_IRNV1_SF2_A) / 4;
+    int nb = (int)sizeof(H_IRNV1_SF2_B) / 4;
+    int nc = (int)sizeof(H_IRNV1_SF2_C) / 4;
+    int nd = (int)sizeof(H_IRNV1_SF2_D) / 4;
+    int ne = (int)sizeof(H_IRNV1_SF2_E) / 4;
+    int nt = (int)sizeof(H_IRNV1_SF2_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_IRNV1_SF2, 600, 1200, 50,
+        H_IRNV1_SF2_A, H_IRNV1_SF2_B, H_IRNV1_SF2_C, H_IRNV1_SF2_D,
+        H_IRNV1_SF2_E, H_IRNV1_SF2_T, na, nb, nc, nd, ne, nt);
+    
+    return decode_B_LDPC(H, 600, 1200, syms, syms_dec);
 }
 
 // decode LDPC(548,274) of NavIC L1-SPS NAV subframe 3 -------------------------
 static int decode_LDPC_IRNV1_SF3(const uint8_t *syms, uint8_t *syms_dec)
 {
-    if (!H_IRNV1_SF3) {
-        int na = (int)sizeof(H_IRNV1_SF3_A) / 4;
-        int nb = (int)sizeof(H_IRNV1_SF3_B) / 4;
-        int nc = (int)sizeof(H_IRNV1_SF3_C) / 4;
-        int nd = (int)sizeof(H_IRNV1_SF3_D) / 4;
-        int ne = (int)sizeof(H_IRNV1_SF3_E) / 4;
-        int nt = (int)sizeof(H_IRNV1_SF3_T) / 4;
-        H_IRNV1_SF3 = gen_B_LDPC_H(274, 548, 23, H_IRNV1_SF3_A, H_IRNV1_SF3_B,
-            H_IRNV1_SF3_C, H_IRNV1_SF3_D, H_IRNV1_SF3_E, H_IRNV1_SF3_T, na, nb,
-            nc, nd, ne, nt);
-    }
-    return decode_B_LDPC(H_IRNV1_SF3, 274, 548, syms, syms_dec);
+    int na = (int)sizeof(H_IRNV1_SF3_A) / 4;
+    int nb = (int)sizeof(H_IRNV1_SF3_B) / 4;
+    int nc = (int)sizeof(H_IRNV1_SF3_C) / 4;
+    int nd = (int)sizeof(H_IRNV1_SF3_D) / 4;
+    int ne = (int)sizeof(H_IRNV1_SF3_E) / 4;
+    int nt = (int)sizeof(H_IRNV1_SF3_T) / 4;
+    const ldpc_H_t *H = get_B_LDPC_H(&H_IRNV1_SF3, 274, 548, 23,
+        H_IRNV1_SF3_A, H_IRNV1_SF3_B, H_IRNV1_SF3_C, H_IRNV1_SF3_D,
+        H_IRNV1_SF3_E, H_IRNV1_SF3_T, na, nb, nc, nd, ne, nt);
+    
+    return decode_B_LDPC(H, 274, 548, syms, syms_dec);
 }
 
 //------------------------------------------------------------------------------
-//  Decode LDPC (Low Density Parity Check) codes and correct errors.
+//  Decode LDPC (Low Density Parity Check) codes with soft-decision symbols and
+//  correct errors.
 //
 //  args:
 //      type     (I) LDPC type
@@ -2377,14 +2532,16 @@ static int decode_LDPC_IRNV1_SF3(const uint8_t *syms, uint8_t *syms_dec)
 //                     'BCNV3'    : BDS B2b-I BCNAV-3/B2b-PPP SF
 //                     'IRNV1_SF2': NavIC L1-SPS-D NAV SF2
 //                     'IRNV1_SF3': NavIC L1-SPS-D NAV SF3
-//      syms     (I) Binary codes with LDPC parity as uint8_t array (0 or 1)
+//      syms     (I) Soft-decision binary codes with LDPC parity as uint8_t
+//                   array (0-255) (0: strong 0, 255: strong 1, 128: erasure)
 //      N        (I) Size of binary codes
 //      syms_dec (O) Decoded binary codes w/o parity as uint8_t array (0 or 1)
 //
 //  returns:
-//      Number of corrected error bits (-1: Unable error correction)
+//      Number of corrected error bits of hard-decision symbols (-1: Unable
+//      error correction)
 //
-int sdr_decode_LDPC(const char *type, const uint8_t *syms, int N,
+int sdr_decode_LDPC_soft(const char *type, const uint8_t *syms, int N,
     uint8_t *syms_dec)
 {
     if (!strcmp(type, "CNV2_SF2")) {
@@ -2414,3 +2571,28 @@ int sdr_decode_LDPC(const char *type, const uint8_t *syms, int N,
     return -1;
 }
 
+
+//------------------------------------------------------------------------------
+//  Decode LDPC (Low Density Parity Check) codes and correct errors.
+//
+//  args:
+//      type     (I) LDPC type (see sdr_decode_LDPC_soft())
+//      syms     (I) Binary codes with LDPC parity as uint8_t array (0 or 1)
+//      N        (I) Size of binary codes
+//      syms_dec (O) Decoded binary codes w/o parity as uint8_t array (0 or 1)
+//
+//  returns:
+//      Number of corrected error bits (-1: Unable error correction)
+//
+int sdr_decode_LDPC(const char *type, const uint8_t *syms, int N,
+    uint8_t *syms_dec)
+{
+    uint8_t ssyms[MAX_N];
+    
+    if (N > MAX_N) return -1;
+    
+    for (int i = 0; i < N; i++) {
+        ssyms[i] = syms[i] ? 255 : 0;
+    }
+    return sdr_decode_LDPC_soft(type, ssyms, N, syms_dec);
+}
@@ -48,12 +48,26 @@
 //  2024-01-12  1.3  support B1CD, B2AD, B2BI
 //  2024-01-19  1.4  support G1OCD
 //  2024-05-22  1.5  support tow update for pseudorange generation
+//  2026-10-14  1.6  dispatch navigation data decoders by signal ID
+//                   ring buffers of nav symbols and P correlation history,
+//                   add API sdr_nav_add_sym()
+//                   defer FEC decoding and frame search to decoder threads,
+//                   add API sdr_nav_async()
+//  2026-10-15  1.7  soft-decision nav symbols input to FEC decoders,
+//                   add API sdr_nav_add_ssym()
+//                   incremental Viterbi decoders for search of frames
+//                   bit-packed nav symbols and frame sync by popcount
+//                   count performance of decoding, add API sdr_nav_queue()
+//                   defer decoders only at frame candidates or synced frame
+//                   boundaries by job buffers of channel
 //
 #include "pocket_sdr.h"
 
 // constants -------------------------------------------------------------------
 #define THRES_SYNC  0.02      // threshold for symbol sync
 #define THRES_LOST  0.002     // threshold for symbol lost
+#define SSYM_SCALE  64.0      // scale of soft-decision symbol by mean amplitude
+#define SSYM_TC     0.01      // smoothing gain of mean amplitude
 #define GPST_OFF_W  2048      // GPST offset (week) (2019-4-7 ~ 2038-11-20)
 #define GPST_GST_W  1024      // GPST - GST (week)
 #define GPST_BDT_W  1356      // GPST - BDT (week)
@@ -90,22 +104,77 @@
 #define TOFF_B2BI   1.016     // time offset (s) B2BI
 #define TOFF_I1SD  18.511     // time offset (s) I1SD
 #define TOFF_I5S    0.320     // time offset (s) I5S
+#define MAX_DEC_TH  8         // max number of decoder threads
+#define MAX_DEC_JOB 256       // max number of queued decoder jobs
+#define MAX_CH_JOB  2         // max number of pending decoder jobs of channel
+#define DEC_SBAS    1         // deferred decoders: search SBAS message
+#define DEC_CNV2    2         // decode CNAV-2 frame
+#define DEC_CNAV    3         // search CNAV subframe
+#define DEC_L5SBAS  4         // search L5 SBAS message
+#define DEC_L6      5         // sync and decode L6 frame
+#define DEC_G1OCD   6         // search GLONASS L1OCD nav string
+#define DEC_G3OCD   7         // search GLONASS L3OCD nav string
+#define DEC_INAV    8         // decode Galileo I/NAV pages
+#define DEC_FNAV    9         // decode Galileo F/NAV page
+#define DEC_GCNAV   10        // decode Galileo C/NAV page
+#define DEC_BCNV1   11        // decode B-CNAV1 frame
+#define DEC_BCNV2   12        // decode B-CNAV2 frame
+#define DEC_BCNV3   13        // decode B-CNAV3 frame
+#define DEC_IRNV1   14        // decode NavIC L1-SPS NAV frame
+#define DEC_IRNAV   15        // decode IRNSS SPS NAV frame
+
+#define MIN(x, y)   ((x) < (y) ? (x) : (y))
+
+// type definitions ------------------------------------------------------------
+typedef struct nav_job_tag {    // deferred decoder job type
+    sdr_ch_t ch;                // snapshot of channel
+    sdr_nav_t nav;              // snapshot of navigation data
+    int type, off, rev, arg;    // decoder type, offset of symbols, arguments
+    int lock, lost, fsync;      // lock, lost counts and frame sync at deferral
+    int ssync0, fsync0, rev0;   // symbol sync, frame sync and polarity and
+    int count0[2];              // navigation data counts before decoding
+    int done;                   // decoding done (atomic)
+    int busy;                   // used by channel and decoder thread (atomic)
+    struct nav_pool_tag *pool;  // job buffers including the job
+    struct nav_job_tag *next;   // next job in decoder queue
+    struct nav_job_tag *link;   // next pending job of channel
+} nav_job_t;
+
+typedef struct nav_pool_tag {   // decoder job buffers of channel type
+    nav_job_t job[MAX_CH_JOB];  // job buffers
+    int ref;                    // reference count (atomic)
+} nav_pool_t;
 
 // function prototypes in sdr_code.c -------------------------------------------
 int32_t rev_reg(int32_t R, int N);
 int8_t *LFSR(int N, int32_t R, int32_t tap, int n);
 
+// function prototypes ---------------------------------------------------------
+static void defer_dec(sdr_ch_t *ch, int type, const uint8_t *syms, int rev,
+    int arg);
+
 // BCH(15,11,1) error correction table ([7] Table 5-2) -------------------------
 static uint32_t BCH_CORR_TBL[] = {
     0x0000, 0x0001, 0x0002, 0x0010, 0x0004, 0x0100, 0x0020, 0x0400,
     0x0008, 0x4000, 0x0200, 0x0080, 0x0040, 0x2000, 0x0800, 0x1000
 };
 
-// code caches -----------------------------------------------------------------
-static uint8_t *CNV2_SF1  [400] = {NULL};
-static uint8_t *BCNV1_SF1A[ 63] = {NULL};
-static uint8_t *BCNV1_SF1B[200] = {NULL};
-static uint8_t *IRNV1_SF1 [400] = {NULL};
+// code caches (bit-packed, bit i: symbol i) -----------------------------------
+static uint64_t CNV2_SF1  [400];
+static uint64_t BCNV1_SF1A[ 63];
+static uint64_t BCNV1_SF1B[200];
+static uint64_t IRNV1_SF1 [400];
+static pthread_once_t code_once = PTHREAD_ONCE_INIT;
+
+// decoder threads and job queue -----------------------------------------------
+static nav_job_t *job_head = NULL, *job_tail = NULL; // decoder job queue
+static int job_nq = 0;          // number of queued jobs (atomic)
+static int dec_nth = 0;         // number of decoder threads (atomic)
+static int dec_state = 0;       // state of decoder threads
+static pthread_t dec_th[MAX_DEC_TH]; // decoder threads
+static pthread_mutex_t job_mtx = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_cond = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t dec_mtx = PTHREAD_MUTEX_INITIALIZER;
 
 // average of IP correlation ---------------------------------------------------
 static float mean_IP(const sdr_ch_t *ch, int N)
@@ -113,7 +182,7 @@ static float mean_IP(const sdr_ch_t *ch, int N)
     float P = 0.0;
     
     for (int i = 0; i < N; i++) {
-        P += (ch->trk->P[SDR_N_HIST-N+i][0] - P) / (i + 1);
+        P += (SDR_TRK_P(ch->trk, SDR_N_HIST-N+i)[0] - P) / (i + 1);
     }
     return P;
 }
@@ -126,8 +195,8 @@ static int sync_symb(sdr_ch_t *ch, int N)
         int n = (N <= 2) ? 1 : N - 1;
         for (int i = 0; i < 2 * n; i++) {
             int8_t code = (i < n) ? -1 : 1;
-            P += ch->trk->P[SDR_N_HIST-2*n+i][0] * code / (2 * n);
-            R += fabsf(ch->trk->P[SDR_N_HIST-2*n+i][0]) / (2 * n);
+            P += SDR_TRK_P(ch->trk, SDR_N_HIST-2*n+i)[0] * code / (2 * n);
+            R += fabsf(SDR_TRK_P(ch->trk, SDR_N_HIST-2*n+i)[0]) / (2 * n);
         }
         if (fabsf(P) >= R && R >= THRES_SYNC) {
             ch->nav->ssync = ch->lock - n;
@@ -138,8 +207,7 @@ static int sync_symb(sdr_ch_t *ch, int N)
     else if ((ch->lock - ch->nav->ssync) % N == 0) {
         float P = mean_IP(ch, N);
         if (fabsf(P) >= THRES_LOST) {
-            uint8_t sym = (P >= 0.0) ? 1 : 0;
-            sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+            sdr_nav_add_ssym(ch->nav, P);
             return 1;
         }
         else {
@@ -160,8 +228,7 @@ static int sync_sec_code(sdr_ch_t *ch)
        (ch->lock - ch->trk->sec_sync) % N != 0) {
         return 0;
     }
-    uint8_t sym = (mean_IP(ch, N) >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+    sdr_nav_add_ssym(ch->nav, mean_IP(ch, N));
     return 1;
 }
 
@@ -183,21 +250,122 @@ static int bmatch_r(const uint8_t *bits0, const uint8_t *bits1, int n, int m)
     return 1;
 }
 
-// sync nav frame by 2 preambles -----------------------------------------------
-static int sync_frame(sdr_ch_t *ch, const uint8_t *preamb, int n, int m,
-    const uint8_t *bits, int N)
+// pack bits (n <= 64) (bit i: bits[i]) ----------------------------------------
+static uint64_t pack_bits64(const uint8_t *bits, int n)
+{
+    uint64_t x = 0;
+    for (int i = 0; i < n; i++) {
+        x |= (uint64_t)(bits[i] & 1) << i;
+    }
+    return x;
+}
+
+// pack code (n <= 64) (bit i: code[i] > 0) ------------------------------------
+static uint64_t pack_code64(const int8_t *code, int n)
 {
-    if (bmatch_n(preamb, bits, n, m) && bmatch_n(preamb, bits + N, n, m)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N)", ch->time, ch->sig, ch->prn);
+    uint64_t x = 0;
+    for (int i = 0; i < n; i++) {
+        x |= (uint64_t)(code[i] > 0) << i;
+    }
+    return x;
+}
+
+// bit-packed nav symbols of nav symbols (n <= 64) -----------------------------
+//  The n symbols from syms in SDR_NAV_SYMS(ch->nav) are extracted from the
+//  bit-packed nav symbols buffer without a scan of the symbols.
+static uint64_t packed_syms(const sdr_ch_t *ch, const uint8_t *syms, int n)
+{
+    int i = (int)(syms - ch->nav->syms), k = i % 64;
+    uint64_t x = ch->nav->psyms[i/64] >> k;
+    
+    if (k > 0) {
+        x |= ch->nav->psyms[i/64+1] << (64 - k);
+    }
+    return n < 64 ? x & ((1ull << n) - 1) : x;
+}
+
+// number of unmatched nav symbols to bit-packed code (n <= 128) ---------------
+static int nerr_code(const sdr_ch_t *ch, const uint8_t *syms,
+    const uint64_t *code, int n)
+{
+    uint64_t x = packed_syms(ch, syms, MIN(n, 64)) ^ code[0];
+    int nerr = __builtin_popcountll(x);
+    
+    if (n > 64) {
+        x = packed_syms(ch, syms + 64, n - 64) ^ code[1];
+        nerr += __builtin_popcountll(x);
+    }
+    return nerr;
+}
+
+// sync nav frame by 2 bit-packed preambles ------------------------------------
+static int sync_frame_pack(sdr_ch_t *ch, int n, int m, uint64_t preamb,
+    uint64_t bits0, uint64_t bits1)
+{
+    int nerr0 = __builtin_popcountll(bits0 ^ preamb);
+    int nerr1 = __builtin_popcountll(bits1 ^ preamb);
+    
+    if (nerr0 <= m && nerr1 <= m) {
+        if (ch) {
+            sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N)", ch->time, ch->sig,
+                ch->prn);
+        }
         return 0; // normal
     }
-    if (bmatch_r(preamb, bits, n, m) && bmatch_r(preamb, bits + N, n, m)) {
-        sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R)", ch->time, ch->sig, ch->prn);
+    if (n - nerr0 <= m && n - nerr1 <= m) {
+        if (ch) {
+            sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R)", ch->time, ch->sig,
+                ch->prn);
+        }
         return 1; // reversed
     }
     return -1;
 }
 
+// sync nav frame by 2 preambles in nav symbols (n <= 64) ----------------------
+static int sync_frame(sdr_ch_t *ch, const uint8_t *preamb, int n, int m,
+    const uint8_t *syms, int N)
+{
+    return sync_frame_pack(ch, n, m, pack_bits64(preamb, n),
+        packed_syms(ch, syms, n), packed_syms(ch, syms + N, n));
+}
+
+// sync nav frame by 2 preambles in decoded bits (n <= 64) ---------------------
+static int sync_frame_bits(sdr_ch_t *ch, const uint8_t *preamb, int n, int m,
+    const uint8_t *bits, int N)
+{
+    return sync_frame_pack(ch, n, m, pack_bits64(preamb, n),
+        pack_bits64(bits, n), pack_bits64(bits + N, n));
+}
+
+// generate code caches --------------------------------------------------------
+static void init_codes(void)
+{
+    for (int t = 0; t < 400; t++) {
+        // CNAV-2 subframe 1 symbols ([12])
+        int8_t *code = LFSR(51, rev_reg(t & 0xFF, 8), 0x9F, 8);
+        uint64_t bit9 = (t >> 8) & 1 ? (1ull << 52) - 1 : 0;
+        CNV2_SF1[t] = (pack_code64(code, 51) << 1) ^ bit9;
+        sdr_free(code);
+        
+        // NavIC L1-SPS subframe 1 symbols ([17])
+        code = LFSR(52, rev_reg(t+1, 9), 0x1BF, 9);
+        IRNV1_SF1[t] = pack_code64(code, 52);
+        sdr_free(code);
+    }
+    // B-CNAV1 subframe 1 symbols (PRN and SOH)
+    for (int prn = 1; prn <= 63; prn++) {
+        int8_t *code = LFSR(21, rev_reg(prn, 6), 0x17, 6);
+        BCNV1_SF1A[prn-1] = pack_code64(code, 21);
+        sdr_free(code);
+    }
+    for (int soh = 0; soh < 200; soh++) {
+        int8_t *code = LFSR(51, rev_reg(soh, 8), 0x9F, 8);
+        BCNV1_SF1B[soh] = pack_code64(code, 51);
+        sdr_free(code);
+    }
+}
+
 // test CRC24Q -----------------------------------------------------------------
 int test_CRC(const uint8_t *bits, int len_bits)
 {
@@ -255,26 +423,162 @@ static void unsync_nav(sdr_ch_t *ch)
 // new nav data ----------------------------------------------------------------
 sdr_nav_t *sdr_nav_new(void)
 {
+    pthread_once(&code_once, init_codes);
     return (sdr_nav_t *)sdr_malloc(sizeof(sdr_nav_t));
 }
 
+// release decoder job buffers -------------------------------------------------
+//  The job buffers are referenced by the channel and the decoder threads
+//  running the jobs, and freed after the channel freed and the jobs done.
+static void pool_release(nav_pool_t *pool)
+{
+    if (pool && __atomic_sub_fetch(&pool->ref, 1, __ATOMIC_ACQ_REL) == 0) {
+        sdr_free(pool);
+    }
+}
+
+// release decoder job ---------------------------------------------------------
+//  The job buffer is reused after released by both the channel and the decoder
+//  thread.
+static void job_release(nav_job_t *job)
+{
+    __atomic_sub_fetch(&job->busy, 1, __ATOMIC_RELEASE);
+}
+
+// release pending decoder jobs of nav data ------------------------------------
+static void free_jobs(sdr_nav_t *nav)
+{
+    while (nav->job) {
+        nav_job_t *job = nav->job;
+        nav->job = job->link;
+        job_release(job);
+    }
+}
+
 // free nav data ---------------------------------------------------------------
 void sdr_nav_free(sdr_nav_t *nav)
 {
     if (!nav) return;
+    free_jobs(nav);
+    pool_release(nav->pool);
     sdr_free(nav);
 }
 
 // initialize nav data ---------------------------------------------------------
 void sdr_nav_init(sdr_nav_t *nav)
 {
+    free_jobs(nav);
     nav->ssync = nav->fsync = nav->rev = nav->seq = nav->type = nav->stat = 0;
     nav->nerr = 0;
     nav->coff = 0.0;
-    memset(nav->syms, 0, SDR_MAX_NSYM);
+    memset(nav->syms, 0, sizeof(nav->syms));
+    memset(nav->ssyms, 128, sizeof(nav->ssyms));
+    memset(nav->psyms, 0, sizeof(nav->psyms));
+    nav->amp = 0.0f;
+    nav->isym = 0;
+    sdr_vit_init(nav->vit, -1);
+    sdr_vit_init(nav->vit + 1, -1);
+    nav->ivit = 0;
     memset(nav->data, 0, SDR_MAX_DATA);
 }
 
+// set nav symbol to bit-packed nav symbols buffer -----------------------------
+static void set_psym(sdr_nav_t *nav, int i, int sym)
+{
+    uint64_t mask = 1ull << (i % 64);
+    
+    if (sym) nav->psyms[i/64] |= mask; else nav->psyms[i/64] &= ~mask;
+}
+
+//------------------------------------------------------------------------------
+//  Add a nav symbol to the nav symbols buffer. The buffer is a ring buffer
+//  mirrored to the second half, so that the latest SDR_MAX_NSYM symbols are
+//  always accessed as a contiguous array SDR_NAV_SYMS(nav).
+//
+//  args:
+//      nav      (IO) SDR receiver navigation data
+//      sym      (I)  nav symbol
+//
+//  returns:
+//      none
+//
+//  notes:
+//      The soft-decision symbol of a binary nav symbol is set to 0 or 255.
+//      The LSB of the nav symbol is also set to the bit-packed nav symbols
+//      buffer, which is used for fast matching of preambles.
+//
+void sdr_nav_add_sym(sdr_nav_t *nav, uint8_t sym)
+{
+    uint8_t ssym = sym ? 255 : 0;
+    nav->syms[nav->isym] = nav->syms[nav->isym+SDR_MAX_NSYM] = sym;
+    nav->ssyms[nav->isym] = nav->ssyms[nav->isym+SDR_MAX_NSYM] = ssym;
+    set_psym(nav, nav->isym, sym & 1);
+    set_psym(nav, nav->isym + SDR_MAX_NSYM, sym & 1);
+    nav->isym = (nav->isym + 1) % SDR_MAX_NSYM;
+}
+
+//------------------------------------------------------------------------------
+//  Add a binary nav symbol by the prompt correlation to the nav symbols
+//  buffer. The hard-decision symbol (P >= 0) is added to the nav symbols
+//  buffer and the soft-decision symbol, the correlation normalized by the
+//  running mean of amplitudes, is added to the soft-decision nav symbols
+//  buffer SDR_NAV_SSYMS(nav) (0-255, 0: strong 0, 255: strong 1).
+//
+//  args:
+//      nav      (IO) SDR receiver navigation data
+//      P        (I)  prompt correlation (in-phase) of nav symbol
+//
+//  returns:
+//      none
+//
+void sdr_nav_add_ssym(sdr_nav_t *nav, float P)
+{
+    float A = fabsf(P);
+    
+    nav->amp = nav->amp <= 0.0f ? A : nav->amp + (A - nav->amp) * SSYM_TC;
+    int v = nav->amp > 0.0f ? (int)(A / nav->amp * SSYM_SCALE) : 0;
+    uint8_t ssym = P >= 0.0f ? 128 + MIN(v, 127) : 127 - MIN(v, 127);
+    nav->syms[nav->isym] = nav->syms[nav->isym+SDR_MAX_NSYM] = P >= 0.0f;
+    nav->ssyms[nav->isym] = nav->ssyms[nav->isym+SDR_MAX_NSYM] = ssym;
+    set_psym(nav, nav->isym, P >= 0.0f);
+    set_psym(nav, nav->isym + SDR_MAX_NSYM, P >= 0.0f);
+    nav->isym = (nav->isym + 1) % SDR_MAX_NSYM;
+}
+
+// soft-decision nav symbols of nav symbols ------------------------------------
+static const uint8_t *soft_syms(const sdr_ch_t *ch, const uint8_t *syms)
+{
+    return ch->nav->ssyms + (syms - ch->nav->syms);
+}
+
+// reverse polarity of soft-decision nav symbol --------------------------------
+static uint8_t ssym_rev(uint8_t ssym, int rev)
+{
+    return rev ? (uint8_t)~ssym : ssym;
+}
+
+// update Viterbi decoders by latest nav symbol pair ---------------------------
+//  The decoders of even and odd symbol pairs are updated alternately, so that
+//  the frames are searched at every symbol by the chainback of the decoder
+//  updated last without decoding the whole frame. (swap: swap G1 and G2)
+static void update_vit(sdr_nav_t *nav, int swap)
+{
+    const uint8_t *ssyms = SDR_NAV_SSYMS(nav) + SDR_MAX_NSYM - 2;
+    uint8_t pair[2] = {ssyms[swap], ssyms[1-swap]};
+    
+    sdr_vit_update(nav->vit + nav->ivit, pair, 2);
+    nav->ivit ^= 1;
+}
+
+// decode 1/2 FEC of latest nav symbols by Viterbi decoder ---------------------
+//  The bits of the latest (nbits + ntail) * 2 syms are decoded.
+static int decode_vit(const sdr_nav_t *nav, int nbits, int ntail,
+    uint8_t *bits)
+{
+    return sdr_vit_chainback(nav->vit + (nav->ivit ^ 1), -1, nbits, ntail,
+        bits);
+}
+
 // sync SBAS message -----------------------------------------------------------
 static int sync_SBAS_msgs(const uint8_t *bits, int N)
 {
@@ -299,7 +603,7 @@ static int sync_SBAS_msgs(const uint8_t *bits, int N)
 // decode SBAS message ---------------------------------------------------------
 static void decode_SBAS_msgs(sdr_ch_t *ch, const uint8_t *bits, int rev)
 {
-    double toff = !strcmp(ch->sig, "L1CA") ? TOFF_L1CA_S : TOFF_L5I_S;
+    double toff = ch->sig_id == SDR_SIG_L1CA ? TOFF_L1CA_S : TOFF_L5I_S;
     double time = ch->time - toff;
     uint8_t buff[250];
     
@@ -311,7 +615,7 @@ static void decode_SBAS_msgs(sdr_ch_t *ch, const uint8_t *bits, int rev)
         ch->nav->rev = rev;
         ch->tow = (int)(toff / 1e-3);
         ch->tow_v = 2;
-        int off = !strcmp(ch->sig, "L1CA") ? 8 : 6;
+        int off = ch->sig_id == SDR_SIG_L1CA ? 8 : 6;
         ch->nav->type = getbitu(ch->nav->data, off, 6); // SBAS message type
         sdr_pack_bits(buff, 250, 0, ch->nav->data); // SBAS message (250 bits)
         ch->nav->stat = 1;
@@ -328,21 +632,20 @@ static void decode_SBAS_msgs(sdr_ch_t *ch, const uint8_t *bits, int rev)
 }
 
 // search SBAS message ---------------------------------------------------------
-static void search_SBAS_msgs(sdr_ch_t *ch)
+//  With cand = 1, only the frame candidate is tested without decoding.
+static int search_SBAS_msgs(sdr_ch_t *ch, int cand)
 {
-    uint8_t syms[544], bits[266];
+    uint8_t bits[266];
     
     // decode 1/2 FEC (544 syms -> 258 + 8 bits)
-    for (int i = 0; i < 544; i++) {
-        syms[i] = ch->nav->syms[SDR_MAX_NSYM-544+i] * 255;
-    }
-    sdr_decode_conv(syms, 544, bits);
+    if (!decode_vit(ch->nav, 266, 6, bits)) return 0;
     
     // search and decode SBAS message
     int rev = sync_SBAS_msgs(bits, 250);
-    if (rev >= 0) {
+    if (rev >= 0 && !cand) {
         decode_SBAS_msgs(ch, bits, rev);
     }
+    return rev >= 0;
 }
 
 // decode SBAS nav data --------------------------------------------------------
@@ -351,16 +654,18 @@ static void decode_SBAS(sdr_ch_t *ch)
     if (!sync_symb(ch, 2)) { // sync symbol
         return;
     }
+    update_vit(ch->nav, 0);
+    
     if (ch->nav->fsync > 0) { // sync SBAS message
         if (ch->lock == ch->nav->fsync + 1000) {
-            search_SBAS_msgs(ch);
+            defer_dec(ch, DEC_SBAS, NULL, 0, 0);
         }
         else if (ch->lock > ch->nav->fsync + 1000) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock > 1088 + 1000) {
-        search_SBAS_msgs(ch);
+    else if (ch->lock > 1088 + 1000 && search_SBAS_msgs(ch, 1)) {
+        defer_dec(ch, DEC_SBAS, NULL, 0, 0);
     }
 }
 
@@ -435,7 +740,7 @@ static void decode_L1CA(sdr_ch_t *ch)
     if (!sync_symb(ch, 20)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 308;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 308;
     
     if (ch->nav->fsync > 0) { // sync LNAV subframe
         if (ch->lock == ch->nav->fsync + 6000) {
@@ -472,28 +777,19 @@ static void decode_L1CB(sdr_ch_t *ch)
 // sync CNAV-2 frame by subframe 1 symbols ([12]) ------------------------------
 static int sync_CNV2_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
 {
-    // generate CNAV-2 subframe 1 symbols
-    if (!CNV2_SF1[0]) {
-        for (int t = 0; t < 400; t++) {
-            CNV2_SF1[t] = (uint8_t *)sdr_malloc(52);
-            int8_t *code = LFSR(51, rev_reg(t & 0xFF, 8), 0x9F, 8);
-            uint8_t bit9 = (uint8_t)((t >> 8) & 1);
-            CNV2_SF1[t][0] = bit9;
-            for (int i = 1; i < 52; i++) {
-                CNV2_SF1[t][i] = (uint8_t)((code[i-1] + 1) / 2) ^ bit9;
-            }
-            sdr_free(code);
-        }
+    int nerr0 = nerr_code(ch, syms, CNV2_SF1 + toi, 52);
+    
+    if (nerr0 > 2 && nerr0 < 50) {
+        return -1;
     }
-    uint8_t *SF1 = CNV2_SF1[toi];
-    uint8_t *SFn = CNV2_SF1[(toi + 1) % 400];
+    int nerr1 = nerr_code(ch, syms + 1800, CNV2_SF1 + (toi + 1) % 400, 52);
     
-    if (bmatch_n(syms, SF1, 52, 2) && bmatch_n(syms + 1800, SFn, 52, 2)) {
+    if (nerr0 <= 2 && nerr1 <= 2) {
         sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N) TOI=%d", ch->time, ch->sig,
             ch->prn, toi);
         return 1; // normal
     }
-    if (bmatch_r(syms, SF1, 52, 2) && bmatch_r(syms + 1800, SFn, 52, 2)) {
+    if (52 - nerr0 <= 2 && 52 - nerr1 <= 2) {
         sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R) TOI=%d", ch->time, ch->sig,
             ch->prn, toi);
         return 0; // reversed
@@ -505,17 +801,18 @@ static int sync_CNV2_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
 static void decode_CNV2(sdr_ch_t *ch, const uint8_t *syms, int rev, int toi)
 {
     double time = ch->time - TOFF_L1CD;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[1748], bits[883], data[111];
     
     // decode block-interleave (38 x 46 = 1748 syms)
     for (int i = 0, k = 0; i < 38; i++) {
         for (int j = 0; j < 46; j++) {
-            buff[k++] = syms[52+j*38+i] ^ (uint8_t)rev;
+            buff[k++] = ssym_rev(ssyms[52+j*38+i], rev);
         }
     }
     // decode LDPC (1200 + 548 syms -> 600 + 274 bits)
-    int nerr1 = sdr_decode_LDPC("CNV2_SF2", buff, 1200, bits + 9);
-    int nerr2 = sdr_decode_LDPC("CNV2_SF3", buff + 1200, 548, bits + 609);
+    int nerr1 = sdr_decode_LDPC_soft("CNV2_SF2", buff, 1200, bits + 9);
+    int nerr2 = sdr_decode_LDPC_soft("CNV2_SF3", buff + 1200, 548, bits + 609);
     
     if (nerr1 >= 0 && nerr2 >= 0 && test_CRC(bits + 9, 600) &&
         test_CRC(bits + 609, 274)) {
@@ -547,9 +844,8 @@ static void decode_CNV2(sdr_ch_t *ch, const uint8_t *syms, int rev, int toi)
 static void decode_L1CD(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = ch->trk->P[SDR_N_HIST-1][0] >= 0.0 ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1852;
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 1852;
     
     if (ch->nav->fsync > 0) { // sync CNAV-2 frame
         if (ch->lock == ch->nav->fsync + 1800) {
@@ -557,7 +853,7 @@ static void decode_L1CD(sdr_ch_t *ch)
             int rev = sync_CNV2_frame(ch, syms, toi);
             uint8_t sym = syms[52]; // WN MSB in SF2
             if (rev == ch->nav->rev && (sym ^ rev)) {
-                decode_CNV2(ch, syms, rev, toi);
+                defer_dec(ch, DEC_CNV2, syms, rev, toi);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1800) {
@@ -570,7 +866,7 @@ static void decode_L1CD(sdr_ch_t *ch)
             int rev = sync_CNV2_frame(ch, syms, toi);
             uint8_t sym = syms[52];
             if (rev >= 0 && (sym ^ rev)) {
-                decode_CNV2(ch, syms, rev, toi);
+                defer_dec(ch, DEC_CNV2, syms, rev, toi);
                 break;
             }
         }
@@ -593,7 +889,7 @@ static void decode_L1CP(sdr_ch_t *ch)
 // decode CNAV subframe ([13]) -------------------------------------------------
 static void decode_CNAV(sdr_ch_t *ch, const uint8_t *bits, int rev)
 {
-    double toff = (!strcmp(ch->sig, "L2CM")) ? TOFF_L2CM : TOFF_L5I;
+    double toff = ch->sig_id == SDR_SIG_L2CM ? TOFF_L2CM : TOFF_L5I;
     double time = ch->time - toff;
     uint8_t buff[300], data[38];
     
@@ -625,41 +921,39 @@ static void decode_CNAV(sdr_ch_t *ch, const uint8_t *bits, int rev)
 }
 
 // search CNAV subframe ([13]) -------------------------------------------------
-static void search_CNAV_frame(sdr_ch_t *ch)
+static int search_CNAV_frame(sdr_ch_t *ch, int cand)
 {
     static const uint8_t preamb[] = {1, 0, 0, 0, 1, 0, 1, 1};
-    uint8_t buff[644], bits[316];
+    uint8_t bits[316];
     
     // decode 1/2 FEC (644 syms -> 308 + 8 bits)
-    for (int i = 0; i < 644; i++) {
-        buff[i] = ch->nav->syms[SDR_MAX_NSYM-644+i] * 255;
-    }
-    sdr_decode_conv(buff, 644, bits);
+    if (!decode_vit(ch->nav, 316, 6, bits)) return 0;
     
     // search and decode CNAV subframe
-    int rev = sync_frame(ch, preamb, 8, 0, bits, 300);
-    if (rev >= 0) {
+    int rev = sync_frame_bits(cand ? NULL : ch, preamb, 8, 0, bits, 300);
+    if (rev >= 0 && !cand) {
         decode_CNAV(ch, bits, rev);
     }
+    return rev >= 0;
 }
 
 // decode L2CM nav data --------------------------------------------------------
 static void decode_L2CM(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    update_vit(ch->nav, 0);
     
     if (ch->nav->fsync > 0) { // sync CNAV subframe
         if (ch->lock == ch->nav->fsync + 600) {
-            search_CNAV_frame(ch);
+            defer_dec(ch, DEC_CNAV, NULL, 0, 0);
         }
         else if (ch->lock > ch->nav->fsync + 600) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock > 644 + 50) {
-        search_CNAV_frame(ch);
+    else if (ch->lock > 644 + 50 && search_CNAV_frame(ch, 1)) {
+        defer_dec(ch, DEC_CNAV, NULL, 0, 0);
     }
 }
 
@@ -689,21 +983,19 @@ static int sync_L5_SBAS_msgs(const uint8_t *bits, int N)
 }
 
 // search L5 SBAS message ------------------------------------------------------
-static void search_L5_SBAS_msgs(sdr_ch_t *ch)
+static int search_L5_SBAS_msgs(sdr_ch_t *ch, int cand)
 {
-    uint8_t syms[1546], bits[766];
+    uint8_t bits[766];
     
     // decode 1/2 FEC (1546 syms -> 758 + 8 bits)
-    for (int i = 0; i < 1546; i++) {
-        syms[i] = ch->nav->syms[SDR_MAX_NSYM-1546+i] * 255;
-    }
-    sdr_decode_conv(syms, 1546, bits);
+    if (!decode_vit(ch->nav, 766, 7, bits)) return 0;
     
     // search and decode SBAS message
     int rev = sync_L5_SBAS_msgs(bits, 250);
-    if (rev >= 0) {
+    if (rev >= 0 && !cand) {
         decode_SBAS_msgs(ch, bits + 500, rev);
     }
+    return rev >= 0;
 }
 
 // decode L5 SBAS nav data ----------------------------------------------------
@@ -712,16 +1004,18 @@ static void decode_L5_SBAS(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
+    update_vit(ch->nav, 0);
+    
     if (ch->nav->fsync > 0) { // sync L5 SBAS message
         if (ch->lock == ch->nav->fsync + 1000) {
-            search_L5_SBAS_msgs(ch);
+            defer_dec(ch, DEC_L5SBAS, NULL, 0, 0);
         }
         else if (ch->lock > ch->nav->fsync + 1000) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock >= 3093 + 1000) {
-        search_L5_SBAS_msgs(ch);
+    else if (ch->lock >= 3093 + 1000 && search_L5_SBAS_msgs(ch, 1)) {
+        defer_dec(ch, DEC_L5SBAS, NULL, 0, 0);
     }
 }
 
@@ -735,16 +1029,18 @@ static void decode_L5I(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
+    update_vit(ch->nav, 0);
+    
     if (ch->nav->fsync > 0) { // sync CNAV subframe
         if (ch->lock == ch->nav->fsync + 6000) {
-            search_CNAV_frame(ch);
+            defer_dec(ch, DEC_CNAV, NULL, 0, 0);
         }
         else if (ch->lock > ch->nav->fsync + 6000) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock > 6440 + 1000) {
-        search_CNAV_frame(ch);
+    else if (ch->lock > 6440 + 1000 && search_CNAV_frame(ch, 1)) {
+        defer_dec(ch, DEC_CNAV, NULL, 0, 0);
     }
 }
 
@@ -787,14 +1083,13 @@ static void decode_L5SQV(sdr_ch_t *ch)
 {
 }
 
-// sync and decode L6 frame ([5]) ----------------------------------------------
-static void decode_L6_frame(sdr_ch_t *ch, const uint8_t *syms, int N)
+// sync L6 frame by 2 preamble differences ------------------------------------
+static int sync_L6_frame(const sdr_ch_t *ch, const uint8_t *syms, int N)
 {
     uint8_t preamb[5] = {0x1A, 0xCF, 0xFC, 0x1D};
     
     preamb[4] = ch->prn;
     
-    // sync 2 preamble differences
     int n1 = 0, n2 = 0;
     for (int i = 1; i < 5; i++) {
         if ((uint8_t)(syms[i] - syms[0]) == (uint8_t)(preamb[i] - preamb[0])) n1++;
@@ -802,7 +1097,15 @@ static void decode_L6_frame(sdr_ch_t *ch, const uint8_t *syms, int N)
     for (int i = 0; i < 5; i++) {
         if ((uint8_t)(syms[i+N] - syms[0]) == (uint8_t)(preamb[i] - preamb[0])) n2++;
     }
-    if (n1 + n2 < 9) { // test # of symbol matches
+    return n1 + n2 >= 9; // test # of symbol matches
+}
+
+// sync and decode L6 frame ([5]) ----------------------------------------------
+static void decode_L6_frame(sdr_ch_t *ch, const uint8_t *syms, int N)
+{
+    static const uint8_t preamb[] = {0x1A, 0xCF, 0xFC, 0x1D};
+    
+    if (!sync_L6_frame(ch, syms, N)) {
         unsync_nav(ch);
         return;
     }
@@ -842,18 +1145,18 @@ static void decode_L6_frame(sdr_ch_t *ch, const uint8_t *syms, int N)
 // decode L6D nav data ([5]) ---------------------------------------------------
 static void decode_L6D(sdr_ch_t *ch)
 {
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 255;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 255;
     
     if (ch->nav->fsync > 0) { // sync L6 frame
         if (ch->lock == ch->nav->fsync + 250) {
-            decode_L6_frame(ch, syms, 250);
+            defer_dec(ch, DEC_L6, syms, 0, 250);
         }
         else if (ch->lock > ch->nav->fsync + 250) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock >= 255) { // sync and decode L6 frame
-        decode_L6_frame(ch, syms, 250);
+    else if (ch->lock >= 255 && sync_L6_frame(ch, syms, 250)) {
+        defer_dec(ch, DEC_L6, syms, 0, 250); // sync and decode L6 frame
     }
 }
 
@@ -915,7 +1218,7 @@ static void decode_G1CA(sdr_ch_t *ch)
     if (!sync_symb(ch, 10)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 230;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 230;
     
     if (ch->nav->fsync > 0) { // sync GLONASS nav string
         if (ch->lock == ch->nav->fsync + 2000) {
@@ -974,24 +1277,20 @@ static void decode_glo_L1OCD_str(sdr_ch_t *ch, const uint8_t *bits, int rev)
 }
 
 // search GLONASS L1OCD nav string ---------------------------------------------
-static void search_glo_L1OCD_str(sdr_ch_t *ch)
+static int search_glo_L1OCD_str(sdr_ch_t *ch, int cand)
 {
     static uint8_t preamb[] = {0, 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 1};
-    uint8_t syms[668], bits[328];
+    uint8_t bits[270];
     
-    // swap convolutional code G1 and G2
-    for (int i = 0; i < 552; i += 2) {
-        syms[i  ] = ch->nav->syms[SDR_MAX_NSYM-552+i+1] * 255;
-        syms[i+1] = ch->nav->syms[SDR_MAX_NSYM-552+i  ] * 255;
-    }
     // decode 1/2 FEC (552 syms -> 262 + 8 bits)
-    sdr_decode_conv(syms, 552, bits);
+    if (!decode_vit(ch->nav, 270, 6, bits)) return 0;
     
     // search and decode GLONASS L1OCD nav string
-    int rev = sync_frame(ch, preamb, 12, 0, bits, 250);
-    if (rev >= 0) {
+    int rev = sync_frame_bits(cand ? NULL : ch, preamb, 12, 0, bits, 250);
+    if (rev >= 0 && !cand) {
         decode_glo_L1OCD_str(ch, bits, rev);
     }
+    return rev >= 0;
 }
 
 // decode G1OCD nav data ([18]) ------------------------------------------------
@@ -1000,16 +1299,19 @@ static void decode_G1OCD(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
+    update_vit(ch->nav, 1); // swap G1 and G2
+    
     if (ch->nav->fsync > 0) { // sync GLONASS L1OCD nav string
         if (ch->lock == ch->nav->fsync + 1000) {
-            search_glo_L1OCD_str(ch);
+            defer_dec(ch, DEC_G1OCD, NULL, 0, 0);
         }
         else if (ch->lock > ch->nav->fsync + 1000) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock > ch->nav->ssync + 1104) {
-        search_glo_L1OCD_str(ch);
+    else if (ch->lock > ch->nav->ssync + 1104 &&
+        search_glo_L1OCD_str(ch, 1)) {
+        defer_dec(ch, DEC_G1OCD, NULL, 0, 0);
     }
 }
 
@@ -1050,26 +1352,22 @@ static void decode_glo_L3OCD_str(sdr_ch_t *ch, const uint8_t *bits, int rev)
 }
 
 // search GLONASS L3OCD nav string ---------------------------------------------
-static void search_glo_L3OCD_str(sdr_ch_t *ch)
+static int search_glo_L3OCD_str(sdr_ch_t *ch, int cand)
 {
     static uint8_t preamb[] = {
         0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0
     };
-    uint8_t syms[668], bits[328];
+    uint8_t bits[328];
     
-    // swap convolutional code G1 and G2
-    for (int i = 0; i < 668; i += 2) {
-        syms[i  ] = ch->nav->syms[SDR_MAX_NSYM-668+i+1] * 255;
-        syms[i+1] = ch->nav->syms[SDR_MAX_NSYM-668+i  ] * 255;
-    }
     // decode 1/2 FEC (668 syms -> 320 + 8 bits)
-    sdr_decode_conv(syms, 668, bits);
+    if (!decode_vit(ch->nav, 328, 6, bits)) return 0;
     
     // search and decode GLONASS L3OCD nav string
-    int rev = sync_frame(ch, preamb, 20, 1, bits, 300);
-    if (rev >= 0) {
+    int rev = sync_frame_bits(cand ? NULL : ch, preamb, 20, 1, bits, 300);
+    if (rev >= 0 && !cand) {
         decode_glo_L3OCD_str(ch, bits, rev);
     }
+    return rev >= 0;
 }
 
 // decode G3OCD nav data ([16]) ------------------------------------------------
@@ -1078,16 +1376,19 @@ static void decode_G3OCD(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
+    update_vit(ch->nav, 1); // swap G1 and G2
+    
     if (ch->nav->fsync > 0) { // sync GLONASS L3OCD nav string
         if (ch->lock == ch->nav->fsync + 3000) {
-            search_glo_L3OCD_str(ch);
+            defer_dec(ch, DEC_G3OCD, NULL, 0, 0);
         }
         else if (ch->lock > ch->nav->fsync + 3000) {
             unsync_nav(ch);
         }
     }
-    else if (ch->lock > ch->nav->ssync + 6680) {
-        search_glo_L3OCD_str(ch);
+    else if (ch->lock > ch->nav->ssync + 6680 &&
+        search_glo_L3OCD_str(ch, 1)) {
+        defer_dec(ch, DEC_G3OCD, NULL, 0, 0);
     }
 }
 
@@ -1104,33 +1405,32 @@ static void decode_G3OCP(sdr_ch_t *ch)
     }
 }
 
-// decode Galileo symbols ([2]) ------------------------------------------------
+// decode Galileo soft-decision symbols ([2]) ----------------------------------
 static void decode_gal_syms(const uint8_t *syms, int ncol, int nrow,
     uint8_t *bits)
 {
-    uint8_t *buff = (uint8_t *)sdr_malloc(ncol * nrow);
+    uint8_t buff[1000];
     
     // decode block-interleave and invert G2
     for (int i = 0, k = 0; i < ncol; i++) {
         for (int j = 0; j < nrow; j++) {
-            buff[k++] = (syms[j*ncol+i] ^ ((j % 2) ? 1 : 0)) * 255;
+            buff[k++] = ssym_rev(syms[j*ncol+i], j % 2);
         }
     }
     // decode 1/2 FEC
     sdr_decode_conv(buff, ncol * nrow, bits);
-    
-    sdr_free(buff);
 }
 
 // decode Galileo I/NAV pages ([2]) --------------------------------------------
 static void decode_gal_INAV(sdr_ch_t *ch, const uint8_t *syms, int rev)
 {
-    double toff = (!strcmp(ch->sig, "E1B")) ? TOFF_E1B : TOFF_E5BI;
+    double toff = ch->sig_id == SDR_SIG_E1B ? TOFF_E1B : TOFF_E5BI;
     double time = ch->time - toff;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[500], bits[114*2], data[16];
     
     for (int i = 0; i < 500; i++) {
-        buff[i] = syms[i] ^ (uint8_t)rev;
+        buff[i] = ssym_rev(ssyms[i], rev);
     }
     // decode Galileo symbols (240 syms x 2 -> 114 bits x 2)
     decode_gal_syms(buff +  10, 30, 8, bits);
@@ -1174,15 +1474,14 @@ static void decode_E1B(sdr_ch_t *ch)
     static const uint8_t preamb[] = {0, 1, 0, 1, 1, 0, 0, 0, 0, 0};
     
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 510;
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 510;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 500) {
             int rev = sync_frame(ch, preamb, 10, 0, syms, 500);
             if (rev == ch->nav->rev) {
-                decode_gal_INAV(ch, syms, rev);
+                defer_dec(ch, DEC_INAV, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 500) {
@@ -1193,7 +1492,7 @@ static void decode_E1B(sdr_ch_t *ch)
         // sync and decode Galileo I/NAV pages
         int rev = sync_frame(ch, preamb, 10, 0, syms, 500);
         if (rev >= 0) {
-            decode_gal_INAV(ch, syms, rev);
+            defer_dec(ch, DEC_INAV, syms, rev, 0);
         }
     }
 }
@@ -1215,10 +1514,11 @@ static void decode_E1C(sdr_ch_t *ch)
 static void decode_gal_FNAV(sdr_ch_t *ch, const uint8_t *syms, int rev)
 {
     double time = ch->time - TOFF_E5AI;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[500], bits[238], data[30];
     
     for (int i = 0; i < 500; i++) {
-        buff[i] = syms[i] ^ (uint8_t)rev;
+        buff[i] = ssym_rev(ssyms[i], rev);
     }
     // decode Galileo symbols (488 syms -> 238 bits)
     decode_gal_syms(buff + 12, 61, 8, bits);
@@ -1261,13 +1561,13 @@ static void decode_E5AI(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 512;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 512;
     
     if (ch->nav->fsync > 0) { // sync Galileo F/NAV page
         if (ch->lock == ch->nav->fsync + 10000) {
             int rev = sync_frame(ch, preamb, 12, 0, syms, 500);
             if (rev == ch->nav->rev) {
-                decode_gal_FNAV(ch, syms, rev);
+                defer_dec(ch, DEC_FNAV, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 10000) {
@@ -1278,7 +1578,7 @@ static void decode_E5AI(sdr_ch_t *ch)
         // sync and decode Galileo F/NAV page
         int rev = sync_frame(ch, preamb, 12, 0, syms, 500);
         if (rev >= 0) {
-            decode_gal_FNAV(ch, syms, rev);
+            defer_dec(ch, DEC_FNAV, syms, rev, 0);
         }
     }
 }
@@ -1304,13 +1604,13 @@ static void decode_E5BI(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 510;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 510;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 2000) {
             int rev = sync_frame(ch, preamb, 10, 0, syms, 500);
             if (rev == ch->nav->rev) {
-                decode_gal_INAV(ch, syms, rev);
+                defer_dec(ch, DEC_INAV, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 2000) {
@@ -1321,7 +1621,7 @@ static void decode_E5BI(sdr_ch_t *ch)
         // sync and decode Galileo I/NAV pages
         int rev = sync_frame(ch, preamb, 10, 0, syms, 500);
         if (rev >= 0) {
-            decode_gal_INAV(ch, syms, rev);
+            defer_dec(ch, DEC_INAV, syms, rev, 0);
         }
     }
 }
@@ -1343,10 +1643,11 @@ static void decode_E5BQ(sdr_ch_t *ch)
 static void decode_gal_CNAV(sdr_ch_t *ch, const uint8_t *syms, int rev)
 {
     double time = ch->time - TOFF_E6B;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[1000], bits[486], data[61];
     
     for (int i = 0; i < 1000; i++) {
-        buff[i] = syms[i] ^ (uint8_t)rev;
+        buff[i] = ssym_rev(ssyms[i], rev);
     }
     // decode Galileo symbols (984 syms -> 486 bits)
     decode_gal_syms(buff + 16, 123, 8, bits);
@@ -1379,15 +1680,14 @@ static void decode_E6B(sdr_ch_t *ch)
         1, 0, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 0, 0, 0
     };
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1016;
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 1016;
     
     if (ch->nav->fsync > 0) { // sync Galileo C/NAV page
         if (ch->lock == ch->nav->fsync + 1000) {
             int rev = sync_frame(ch, preamb, 16, 0, syms, 1000);
             if (rev == ch->nav->rev) {
-                decode_gal_CNAV(ch, syms, rev);
+                defer_dec(ch, DEC_GCNAV, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1000) {
@@ -1398,7 +1698,7 @@ static void decode_E6B(sdr_ch_t *ch)
         // sync and decode Galileo C/NAV page
         int rev = sync_frame(ch, preamb, 16, 0, syms, 1000);
         if (rev >= 0) {
-            decode_gal_CNAV(ch, syms, rev);
+            defer_dec(ch, DEC_GCNAV, syms, rev, 0);
         }
     }
 }
@@ -1497,7 +1797,7 @@ static void decode_B1I_D1(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 311;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 311;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 6000) {
@@ -1527,7 +1827,7 @@ static void decode_B1I_D2(sdr_ch_t *ch)
     if (!sync_symb(ch, 2)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 311;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 311;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 600) {
@@ -1563,37 +1863,25 @@ static void decode_B1I(sdr_ch_t *ch)
 // sync B1CD B-CNAV1 frame by subframe 1 symbols -------------------------------
 static int sync_BCNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int soh)
 {
-    // generate CNAV-1 subframe 1 symbols
-    if (!BCNV1_SF1A[ch->prn-1]) {
-        BCNV1_SF1A[ch->prn-1] = (uint8_t *)sdr_malloc(21);
-        int8_t *code = LFSR(21, rev_reg(ch->prn, 6), 0x17, 6);
-        for (int i = 0; i < 21; i++) {
-            BCNV1_SF1A[ch->prn-1][i] = (code[i] + 1) / 2;
-        }
-        sdr_free(code);
-    }
-    if (!BCNV1_SF1B[0]) {
-        for (int soh = 0; soh < 200; soh++) {
-            BCNV1_SF1B[soh] = (uint8_t *)sdr_malloc(51);
-            int8_t *code = LFSR(51, rev_reg(soh, 8), 0x9F, 8);
-            for (int i = 0; i < 51; i++) {
-                BCNV1_SF1B[soh][i] = (code[i] + 1) / 2;
-            }
-            sdr_free(code);
-        }
+    uint64_t SFA = BCNV1_SF1A[ch->prn-1];
+    uint64_t SF1[2], SFn[2];
+    SF1[0] = SFA | (BCNV1_SF1B[soh] << 21);
+    SF1[1] = BCNV1_SF1B[soh] >> 43;
+    int nerr0 = nerr_code(ch, syms, SF1, 72);
+    
+    if (nerr0 > 3 && nerr0 < 69) {
+        return -1;
     }
-    uint8_t SF1[72], SFn[72];
-    memcpy(SF1, BCNV1_SF1A[ch->prn-1], 21);
-    memcpy(SFn, BCNV1_SF1A[ch->prn-1], 21);
-    memcpy(SF1 + 21, BCNV1_SF1B[soh], 51);
-    memcpy(SFn + 21, BCNV1_SF1B[(soh + 1) % 200], 51);
+    SFn[0] = SFA | (BCNV1_SF1B[(soh + 1) % 200] << 21);
+    SFn[1] = BCNV1_SF1B[(soh + 1) % 200] >> 43;
+    int nerr1 = nerr_code(ch, syms + 1800, SFn, 72);
     
-    if (bmatch_n(syms, SF1, 72, 3) && bmatch_n(syms + 1800, SFn, 72, 3)) {
+    if (nerr0 <= 3 && nerr1 <= 3) {
         sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N) SOH=%d", ch->time, ch->sig,
             ch->prn, soh);
         return 1; // normal
     }
-    if (bmatch_r(syms, SF1, 72, 3) && bmatch_r(syms + 1800, SFn, 72, 3)) {
+    if (72 - nerr0 <= 3 && 72 - nerr1 <= 3) {
         sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R) SOH=%d", ch->time, ch->sig,
             ch->prn, soh);
         return 0; // reversed
@@ -1605,12 +1893,13 @@ static int sync_BCNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int soh)
 static void decode_BCNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int soh)
 {
     double time = ch->time - TOFF_B1CD;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t symsr[1728], syms2[1200], syms3[528], bits[878], data[110];
     
     // decode block interleave of SF2,3 (36 x 48 = 1728 syms)
     for (int i = 0, k = 0; i < 36; i++) {
         for (int j = 0; j < 48; j++) {
-            symsr[k++] = syms[72+j*36+i] ^ (uint8_t)rev;
+            symsr[k++] = ssym_rev(ssyms[72+j*36+i], rev);
         }
     }
     for (int i = 0; i < 11; i++) {
@@ -1622,8 +1911,8 @@ static void decode_BCNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int soh)
         memcpy(syms2 + i*48   , symsr + (i+11 )*48, 48);
     }
     // decode LDPC (1200 + 528 syms -> 600 + 264 bits)
-    int nerr1 = sdr_decode_LDPC("BCNV1_SF2", syms2, 1200, bits + 14);
-    int nerr2 = sdr_decode_LDPC("BCNV1_SF3", syms3, 528 , bits + 614);
+    int nerr1 = sdr_decode_LDPC_soft("BCNV1_SF2", syms2, 1200, bits + 14);
+    int nerr2 = sdr_decode_LDPC_soft("BCNV1_SF3", syms3, 528 , bits + 614);
     sdr_unpack_data(ch->prn, 6, bits);
     sdr_unpack_data(soh, 8, bits + 6);
     
@@ -1656,16 +1945,15 @@ static void decode_BCNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int soh)
 static void decode_B1CD(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1872;
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 1872;
     
     if (ch->nav->fsync > 0) { // sync B-CNAV1 frame
         if (ch->lock == ch->nav->fsync + 1800) {
             int soh = (ch->nav->seq + 1) % 200;
             int rev = sync_BCNV1_frame(ch, syms, soh);
             if (rev == ch->nav->rev) {
-                decode_BCNV1(ch, syms, rev, soh);
+                defer_dec(ch, DEC_BCNV1, syms, rev, soh);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1800) {
@@ -1677,7 +1965,7 @@ static void decode_B1CD(sdr_ch_t *ch)
         for (int soh = 0; soh < 200; soh++) {
             int rev = sync_BCNV1_frame(ch, syms, soh);
             if (rev >= 0) {
-                decode_BCNV1(ch, syms, rev, soh);
+                defer_dec(ch, DEC_BCNV1, syms, rev, soh);
                 break;
             }
         }
@@ -1707,13 +1995,14 @@ static void decode_B2I(sdr_ch_t *ch)
 static void decode_BCNV2(sdr_ch_t *ch, const uint8_t *syms, int rev)
 {
     double time = ch->time - TOFF_B2AD;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[600], bits[288], data[36];
     
     for (int i = 0; i < 600; i++) {
-        buff[i] = syms[i] ^ (uint8_t)rev;
+        buff[i] = ssym_rev(ssyms[i], rev);
     }
     // decode LDPC (576 syms -> 288 bits)
-    int nerr = sdr_decode_LDPC("BCNV2", buff + 24, 576, bits);
+    int nerr = sdr_decode_LDPC_soft("BCNV2", buff + 24, 576, bits);
      
     if (nerr >= 0 && test_CRC(bits, 288)) {
         ch->nav->ssync = ch->nav->fsync = ch->lock;
@@ -1749,14 +2038,14 @@ static void decode_B2AD(sdr_ch_t *ch)
     if (!sync_sec_code(ch)) { // sync secondary code
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 624;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 624;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 3000) {
             // sync and decode B-CNAV2 frame
             int rev = sync_frame(ch, preamb, 24, 1, syms, 600);
             if (rev == ch->nav->rev) {
-                decode_BCNV2(ch, syms, rev);
+                defer_dec(ch, DEC_BCNV2, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 3000) {
@@ -1767,7 +2056,7 @@ static void decode_B2AD(sdr_ch_t *ch)
         // sync and decode B-CNAV2 frame
         int rev = sync_frame(ch, preamb, 24, 1, syms, 600);
         if (rev >= 0) {
-            decode_BCNV2(ch, syms, rev);
+            defer_dec(ch, DEC_BCNV2, syms, rev, 0);
         }
     }
 }
@@ -1789,13 +2078,14 @@ static void decode_B2AP(sdr_ch_t *ch)
 static void decode_BCNV3(sdr_ch_t *ch, const uint8_t *syms, int rev)
 {
     double time = ch->time - TOFF_B2BI;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[1000], bits[486], data[61];
     
     for (int i = 0; i < 1000; i++) {
-        buff[i] = syms[i] ^ (uint8_t)rev;
+        buff[i] = ssym_rev(ssyms[i], rev);
     }
     // decode LDPC (972 syms -> 486 bits)
-    int nerr = sdr_decode_LDPC("BCNV3", buff + 28, 972, bits);
+    int nerr = sdr_decode_LDPC_soft("BCNV3", buff + 28, 972, bits);
      
     if (nerr >= 0 && test_CRC(bits, 486)) {
         ch->nav->ssync = ch->nav->fsync = ch->lock;
@@ -1834,15 +2124,14 @@ static void decode_B2BI(sdr_ch_t *ch)
     uint8_t preamb[] = {1, 1, 1, 0, 1, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0};
     
     // add symbol buffer
-    uint8_t sym = (ch->trk->P[SDR_N_HIST-1][0] >= 0.0) ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1016;
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 1016;
     
     if (ch->nav->fsync > 0) { // sync frame
         if (ch->lock == ch->nav->fsync + 1000) {
             int rev = sync_frame(ch, preamb, 16, 0, syms, 1000);
             if (rev == ch->nav->rev) {
-                decode_BCNV3(ch, syms, rev);
+                defer_dec(ch, DEC_BCNV3, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1000) {
@@ -1853,7 +2142,7 @@ static void decode_B2BI(sdr_ch_t *ch)
         // sync and decode B-CNAV3 frame
         int rev = sync_frame(ch, preamb, 16, 0, syms, 1000);
         if (rev >= 0) {
-            decode_BCNV3(ch, syms, rev);
+            defer_dec(ch, DEC_BCNV3, syms, rev, 0);
         }
     }
 }
@@ -1867,26 +2156,19 @@ static void decode_B3I(sdr_ch_t *ch)
 // sync I1SD NavIC L1-SPS NAV frame by subframe 1 symbols ([17]) --------------
 static int sync_IRNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
 {
-    // generate NavIC L1-SPS subframe 1 symbols
-    if (!IRNV1_SF1[0]) {
-        for (int t = 0; t < 400; t++) {
-            IRNV1_SF1[t] = (uint8_t *)sdr_malloc(52);
-            int8_t *code = LFSR(52, rev_reg(t+1, 9), 0x1BF, 9);
-            for (int i = 0; i < 52; i++) {
-                IRNV1_SF1[t][i] = (uint8_t)((code[i] + 1) / 2);
-            }
-            sdr_free(code);
-        }
+    int nerr0 = nerr_code(ch, syms, IRNV1_SF1 + toi, 52);
+    
+    if (nerr0 > 2 && nerr0 < 50) {
+        return -1;
     }
-    uint8_t *SF1 = IRNV1_SF1[toi];
-    uint8_t *SFn = IRNV1_SF1[(toi + 1) % 400];
+    int nerr1 = nerr_code(ch, syms + 1800, IRNV1_SF1 + (toi + 1) % 400, 52);
     
-    if (bmatch_n(syms, SF1, 52, 2) && bmatch_n(syms + 1800, SFn, 52, 2)) {
+    if (nerr0 <= 2 && nerr1 <= 2) {
         sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (N) TOI=%d", ch->time, ch->sig,
             ch->prn, toi+1);
         return 1; // normal
     }
-    if (bmatch_r(syms, SF1, 52, 2) && bmatch_r(syms + 1800, SFn, 52, 2)) {
+    if (52 - nerr0 <= 2 && 52 - nerr1 <= 2) {
         sdr_log(4, "$LOG,%.3f,%s,%d,FRAME SYNC (R) TOI=%d", ch->time, ch->sig,
             ch->prn, toi+1);
         return 0; // reversed
@@ -1898,17 +2180,18 @@ static int sync_IRNV1_frame(sdr_ch_t *ch, const uint8_t *syms, int toi)
 static void decode_IRNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int toi)
 {
     double time = ch->time - TOFF_I1SD;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[1748], bits[883], data[111];
     
     // decode block-interleave (38 x 46 = 1748 syms)
     for (int i = 0, k = 0; i < 38; i++) {
         for (int j = 0; j < 46; j++) {
-            buff[k++] = syms[52+j*38+i] ^ (uint8_t)rev;
+            buff[k++] = ssym_rev(ssyms[52+j*38+i], rev);
         }
     }
     // decode LDPC (1200 + 548 syms -> 600 + 274 bits)
-    int nerr1 = sdr_decode_LDPC("IRNV1_SF2", buff, 1200, bits + 9);
-    int nerr2 = sdr_decode_LDPC("IRNV1_SF3", buff + 1200, 548, bits + 609);
+    int nerr1 = sdr_decode_LDPC_soft("IRNV1_SF2", buff, 1200, bits + 9);
+    int nerr2 = sdr_decode_LDPC_soft("IRNV1_SF3", buff + 1200, 548, bits + 609);
     sdr_unpack_data(toi, 9, bits);
     
     if (nerr1 >= 0 && nerr2 >= 0 && test_CRC(bits + 9, 600) &&
@@ -1939,16 +2222,15 @@ static void decode_IRNV1(sdr_ch_t *ch, const uint8_t *syms, int rev, int toi)
 static void decode_I1SD(sdr_ch_t *ch)
 {
     // add symbol buffer
-    uint8_t sym = ch->trk->P[SDR_N_HIST-1][0] >= 0.0 ? 1 : 0;
-    sdr_add_buff(ch->nav->syms, SDR_MAX_NSYM, &sym, sizeof(sym));
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 1852;
+    sdr_nav_add_ssym(ch->nav, SDR_TRK_P(ch->trk, SDR_N_HIST-1)[0]);
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 1852;
     
     if (ch->nav->fsync > 0) { // sync NavIC L1-SPS NAV frame
         if (ch->lock == ch->nav->fsync + 1800) {
             int toi = (ch->nav->seq + 1) % 400;
             int rev = sync_IRNV1_frame(ch, syms, toi);
             if (rev == ch->nav->rev) {
-                decode_IRNV1(ch, syms, rev, toi);
+                defer_dec(ch, DEC_IRNV1, syms, rev, toi);
             }
         }
         else if (ch->lock > ch->nav->fsync + 1800) {
@@ -1960,7 +2242,7 @@ static void decode_I1SD(sdr_ch_t *ch)
         for (int toi = 0; toi < 400; toi++) {
             int rev = sync_IRNV1_frame(ch, syms, toi);
             if (rev >= 0) {
-                decode_IRNV1(ch, syms, rev, toi);
+                defer_dec(ch, DEC_IRNV1, syms, rev, toi);
                 break;
             }
         }
@@ -1976,12 +2258,13 @@ static void decode_I1SP(sdr_ch_t *ch)
 static void decode_IRN_NAV(sdr_ch_t *ch, const uint8_t *syms, int rev)
 {
     double time = ch->time - TOFF_I5S;
+    const uint8_t *ssyms = soft_syms(ch, syms);
     uint8_t buff[584], bits[297] = {0}, data[36];
     
     // decode block-interleave (73 x 8)
     for (int i = 0, k = 0; i < 73; i++) {
         for (int j = 0; j < 8; j++) {
-            buff[k++] = (syms[16+j*73+i] ^ (uint8_t)rev) * 255;
+            buff[k++] = ssym_rev(ssyms[16+j*73+i], rev);
         }
     }
     // decode 1/2 FEC (584 syms -> 297 bits -> 286 bits)
@@ -2022,13 +2305,13 @@ static void decode_I5S(sdr_ch_t *ch)
     if (!sync_symb(ch, 20)) { // sync symbol
         return;
     }
-    uint8_t *syms = ch->nav->syms + SDR_MAX_NSYM - 616;
+    uint8_t *syms = SDR_NAV_SYMS(ch->nav) + SDR_MAX_NSYM - 616;
     
     if (ch->nav->fsync > 0) { // sync IRNSS SPS NAV subframe
         if (ch->lock == ch->nav->fsync + 12000) {
             int rev = sync_frame(ch, preamb, 16, 0, syms, 600);
             if (rev == ch->nav->rev) {
-                decode_IRN_NAV(ch, syms, rev);
+                defer_dec(ch, DEC_IRNAV, syms, rev, 0);
             }
         }
         else if (ch->lock > ch->nav->fsync + 12000) {
@@ -2039,7 +2322,7 @@ static void decode_I5S(sdr_ch_t *ch)
         // sync and decode IRNSS SPS NAV subframe
         int rev = sync_frame(ch, preamb, 16, 0, syms, 600);
         if (rev >= 0) {
-            decode_IRN_NAV(ch, syms, rev);
+            defer_dec(ch, DEC_IRNAV, syms, rev, 0);
         }
     }
 }
@@ -2050,10 +2333,245 @@ static void decode_ISS(sdr_ch_t *ch)
     decode_I5S(ch);
 }
 
+// run deferred decoder --------------------------------------------------------
+static void run_dec(sdr_ch_t *ch, int type, const uint8_t *syms, int rev,
+    int arg)
+{
+    switch (type) {
+        case DEC_SBAS  : search_SBAS_msgs(ch, 0); break;
+        case DEC_CNV2  : decode_CNV2(ch, syms, rev, arg); break;
+        case DEC_CNAV  : search_CNAV_frame(ch, 0); break;
+        case DEC_L5SBAS: search_L5_SBAS_msgs(ch, 0); break;
+        case DEC_L6    : decode_L6_frame(ch, syms, arg); break;
+        case DEC_G1OCD : search_glo_L1OCD_str(ch, 0); break;
+        case DEC_G3OCD : search_glo_L3OCD_str(ch, 0); break;
+        case DEC_INAV  : decode_gal_INAV(ch, syms, rev); break;
+        case DEC_FNAV  : decode_gal_FNAV(ch, syms, rev); break;
+        case DEC_GCNAV : decode_gal_CNAV(ch, syms, rev); break;
+        case DEC_BCNV1 : decode_BCNV1(ch, syms, rev, arg); break;
+        case DEC_BCNV2 : decode_BCNV2(ch, syms, rev); break;
+        case DEC_BCNV3 : decode_BCNV3(ch, syms, rev); break;
+        case DEC_IRNV1 : decode_IRNV1(ch, syms, rev, arg); break;
+        case DEC_IRNAV : decode_IRN_NAV(ch, syms, rev); break;
+    }
+}
+
+// defer decoder to decoder threads --------------------------------------------
+//  The decoder runs on a snapshot of the channel and the nav data in a job
+//  buffer of the channel. It is deferred only at frame candidates or synced
+//  frame boundaries. The frame sync of the synced channel is held at the
+//  current lock count until the result is applied. The decoder is run
+//  immediately without decoder threads, with the job queue full or without
+//  free job buffer of the channel.
+static void defer_dec(sdr_ch_t *ch, int type, const uint8_t *syms, int rev,
+    int arg)
+{
+    int off = syms ? (int)(syms - ch->nav->syms) : -1;
+    nav_job_t *job = NULL;
+    
+    if (__atomic_load_n(&dec_nth, __ATOMIC_ACQUIRE) &&
+        __atomic_load_n(&job_nq, __ATOMIC_RELAXED) < MAX_DEC_JOB &&
+        off < SDR_MAX_NSYM * 2) {
+        if (!ch->nav->pool) {
+            ch->nav->pool = (nav_pool_t *)sdr_malloc(sizeof(nav_pool_t));
+            ch->nav->pool->ref = 1; // channel
+        }
+        for (int i = 0; i < MAX_CH_JOB && !job; i++) {
+            if (!__atomic_load_n(&ch->nav->pool->job[i].busy,
+                __ATOMIC_ACQUIRE)) {
+                job = ch->nav->pool->job + i;
+            }
+        }
+    }
+    if (!job) {
+        run_dec(ch, type, syms, rev, arg);
+        return;
+    }
+    job->ch = *ch;
+    job->nav = *ch->nav;
+    job->ch.nav = &job->nav;
+    job->nav.job = NULL;
+    job->nav.pool = NULL;
+    job->type = type;
+    job->off = off;
+    job->rev = rev;
+    job->arg = arg;
+    job->lock = ch->lock;
+    job->lost = ch->lost;
+    job->ssync0 = ch->nav->ssync;
+    job->fsync0 = ch->nav->fsync;
+    job->rev0 = ch->nav->rev;
+    job->count0[0] = ch->nav->count[0];
+    job->count0[1] = ch->nav->count[1];
+    job->done = 0;
+    job->busy = 2; // channel and decoder thread
+    job->pool = ch->nav->pool;
+    job->next = job->link = NULL;
+    __atomic_add_fetch(&job->pool->ref, 1, __ATOMIC_RELAXED);
+    
+    // hold frame sync of synced channel
+    if (ch->nav->fsync > 0) ch->nav->fsync = ch->lock;
+    job->fsync = ch->nav->fsync;
+    
+    // add job to pending jobs of channel
+    nav_job_t **p = &ch->nav->job;
+    while (*p) p = &(*p)->link;
+    *p = job;
+    
+    // add job to decoder queue
+    pthread_mutex_lock(&job_mtx);
+    if (job_tail) job_tail->next = job;
+    else job_head = job;
+    job_tail = job;
+    __atomic_add_fetch(&job_nq, 1, __ATOMIC_RELAXED);
+    pthread_cond_signal(&job_cond);
+    pthread_mutex_unlock(&job_mtx);
+}
+
+// apply result of decoder job to channel --------------------------------------
+//  The result is discarded if the channel is lost or the frame sync is changed
+//  after the deferral, or if the decoder did not change the nav states. The TOW
+//  decoded is advanced by the code cycles after the deferral.
+static void apply_dec(sdr_ch_t *ch, const nav_job_t *job)
+{
+    const sdr_ch_t *sch = &job->ch;
+    const sdr_nav_t *nav = &job->nav;
+    
+    if (ch->lost != job->lost || ch->nav->fsync != job->fsync) return;
+    if (nav->ssync == job->ssync0 && nav->fsync == job->fsync0 &&
+        nav->rev == job->rev0 && nav->count[0] == job->count0[0] &&
+        nav->count[1] == job->count0[1]) {
+        return;
+    }
+    ch->nav->ssync = nav->ssync;
+    ch->nav->fsync = nav->fsync;
+    ch->nav->rev = nav->rev;
+    ch->nav->nerr = nav->nerr;
+    ch->nav->seq = nav->seq;
+    ch->nav->type = nav->type;
+    ch->nav->coff = nav->coff;
+    memcpy(ch->nav->data, nav->data, SDR_MAX_DATA);
+    ch->nav->count[0] += nav->count[0] - job->count0[0];
+    ch->nav->count[1] += nav->count[1] - job->count0[1];
+    if (nav->count[0] > job->count0[0]) ch->nav->stat = 1;
+    if (sch->tow >= 0) {
+        int dt = (ch->lock - job->lock) * (int)(ch->T / 1e-3);
+        ch->tow = (sch->tow + dt) % (86400 * 7 * 1000);
+    }
+    else {
+        ch->tow = -1;
+    }
+    ch->tow_v = sch->tow_v;
+    ch->week = sch->week;
+    memcpy(ch->sat, sch->sat, sizeof(ch->sat));
+}
+
+// apply results of decoder jobs done in order ---------------------------------
+static void poll_dec(sdr_ch_t *ch)
+{
+    nav_job_t *job;
+    
+    while ((job = ch->nav->job) && __atomic_load_n(&job->done,
+        __ATOMIC_ACQUIRE)) {
+        ch->nav->job = job->link;
+        apply_dec(ch, job);
+        job_release(job);
+    }
+}
+
+// decoder thread --------------------------------------------------------------
+//  The jobs queued are drained before the thread exits.
+static void *dec_thread(void *arg)
+{
+    while (1) {
+        pthread_mutex_lock(&job_mtx);
+        while (dec_state && !job_head) {
+            pthread_cond_wait(&job_cond, &job_mtx);
+        }
+        nav_job_t *job = job_head;
+        if (job) {
+            if (!(job_head = job->next)) job_tail = NULL;
+            __atomic_sub_fetch(&job_nq, 1, __ATOMIC_RELAXED);
+        }
+        pthread_mutex_unlock(&job_mtx);
+        if (!job) break;
+        
+        const uint8_t *syms = job->off >= 0 ? job->nav.syms + job->off : NULL;
+        int64_t t0 = sdr_get_tick_ns();
+        run_dec(&job->ch, job->type, syms, job->rev, job->arg);
+        sdr_perf_add(SDR_PERF_DEC, t0);
+        nav_pool_t *pool = job->pool;
+        __atomic_store_n(&job->done, 1, __ATOMIC_RELEASE);
+        job_release(job);
+        pool_release(pool);
+    }
+    return NULL;
+}
+
+// stop decoder threads --------------------------------------------------------
+static void dec_stop(void)
+{
+    int n = dec_nth;
+    
+    __atomic_store_n(&dec_nth, 0, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&job_mtx);
+    dec_state = 0;
+    pthread_cond_broadcast(&job_cond);
+    pthread_mutex_unlock(&job_mtx);
+    for (int i = 0; i < n; i++) {
+        pthread_join(dec_th[i], NULL);
+    }
+}
+
+//------------------------------------------------------------------------------
+//  Start or stop navigation data decoder threads. With the decoder threads, the
+//  FEC decoding and the frame search of navigation data in sdr_nav_decode()
+//  are deferred to the threads with snapshots of the nav symbols and the
+//  results are applied to the channel by the following sdr_nav_decode(). It
+//  keeps the channel tracking during the decoding. Without the decoder threads
+//  (default), they are decoded in sdr_nav_decode() synchronously.
+//
+//  args:
+//      nth      (I)  number of decoder threads (0: stop decoder threads)
+//
+//  returns:
+//      status (1: OK, 0: error)
+//
+int sdr_nav_async(int nth)
+{
+    int stat = 1;
+    
+    nth = MIN(nth, MAX_DEC_TH);
+    pthread_mutex_lock(&dec_mtx);
+    if (nth != dec_nth) {
+        if (dec_nth > 0) dec_stop();
+        dec_state = 1;
+        int n = 0;
+        for ( ; n < nth; n++) {
+            if (pthread_create(&dec_th[n], NULL, dec_thread, NULL)) {
+                fprintf(stderr, "decoder thread create error\n");
+                stat = 0;
+                break;
+            }
+        }
+        __atomic_store_n(&dec_nth, n, __ATOMIC_RELEASE);
+        if (n == 0) dec_state = 0;
+    }
+    pthread_mutex_unlock(&dec_mtx);
+    return stat;
+}
+
+// number of jobs queued to decoder threads ------------------------------------
+int sdr_nav_queue(void)
+{
+    return __atomic_load_n(&job_nq, __ATOMIC_RELAXED);
+}
+
 //------------------------------------------------------------------------------
 //  Decode navigation data in the correlation history of the tracking GNSS
 //  signals. The decoded subframe or message in the navigation data are saved to
-//  ch->nav->data asi the packed bits format.
+//  ch->nav->data asi the packed bits format. The results of the decoders
+//  deferred to the decoder threads are applied before decoding.
 //
 //  args:
 //      ch       (IO) SDR receiver channel
@@ -2063,125 +2581,25 @@ static void decode_ISS(sdr_ch_t *ch)
 //
 void sdr_nav_decode(sdr_ch_t *ch)
 {
-    if (!strcmp(ch->sig, "L1CA")) {
-        decode_L1CA(ch);
-    }
-    else if (!strcmp(ch->sig, "L1S")) {
-        decode_L1S(ch);
-    }
-    else if (!strcmp(ch->sig, "L1CB")) {
-        decode_L1CB(ch);
-    }
-    else if (!strcmp(ch->sig, "L1CD")) {
-        decode_L1CD(ch);
-    }
-    else if (!strcmp(ch->sig, "L1CP")) {
-        decode_L1CP(ch);
-    }
-    else if (!strcmp(ch->sig, "L2CM")) {
-        decode_L2CM(ch);
-    }
-    else if (!strcmp(ch->sig, "L5I")) {
-        decode_L5I(ch);
-    }
-    else if (!strcmp(ch->sig, "L5Q")) {
-        decode_L5Q(ch);
-    }
-    else if (!strcmp(ch->sig, "L6D")) {
-        decode_L6D(ch);
-    }
-    else if (!strcmp(ch->sig, "L6E")) {
-        decode_L6E(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SI")) {
-        decode_L5SI(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SQ")) {
-        decode_L5SQ(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SIV")) {
-        decode_L5SIV(ch);
-    }
-    else if (!strcmp(ch->sig, "L5SQV")) {
-        decode_L5SQV(ch);
-    }
-    else if (!strcmp(ch->sig, "G1CA")) {
-        decode_G1CA(ch);
-    }
-    else if (!strcmp(ch->sig, "G2CA")) {
-        decode_G2CA(ch);
-    }
-    else if (!strcmp(ch->sig, "G1OCD")) {
-        decode_G1OCD(ch);
-    }
-    else if (!strcmp(ch->sig, "G1OCP")) {
-        decode_G1OCP(ch);
-    }
-    else if (!strcmp(ch->sig, "G3OCD")) {
-        decode_G3OCD(ch);
-    }
-    else if (!strcmp(ch->sig, "G3OCP")) {
-        decode_G3OCP(ch);
-    }
-    else if (!strcmp(ch->sig, "E1B")) {
-        decode_E1B(ch);
-    }
-    else if (!strcmp(ch->sig, "E1C")) {
-        decode_E1C(ch);
-    }
-    else if (!strcmp(ch->sig, "E5AI")) {
-        decode_E5AI(ch);
-    }
-    else if (!strcmp(ch->sig, "E5AQ")) {
-        decode_E5AQ(ch);
-    }
-    else if (!strcmp(ch->sig, "E5BI")) {
-        decode_E5BI(ch);
-    }
-    else if (!strcmp(ch->sig, "E5BQ")) {
-        decode_E5BQ(ch);
-    }
-    else if (!strcmp(ch->sig, "E6B")) {
-        decode_E6B(ch);
-    }
-    else if (!strcmp(ch->sig, "E6C")) {
-        decode_E6C(ch);
-    }
-    else if (!strcmp(ch->sig, "B1I")) {
-        decode_B1I(ch);
-    }
-    else if (!strcmp(ch->sig, "B1CD")) {
-        decode_B1CD(ch);
-    }
-    else if (!strcmp(ch->sig, "B1CP")) {
-        decode_B1CP(ch);
-    }
-    else if (!strcmp(ch->sig, "B2I")) {
-        decode_B2I(ch);
-    }
-    else if (!strcmp(ch->sig, "B2AD")) {
-        decode_B2AD(ch);
-    }
-    else if (!strcmp(ch->sig, "B2AP")) {
-        decode_B2AP(ch);
-    }
-    else if (!strcmp(ch->sig, "B2BI")) {
-        decode_B2BI(ch);
-    }
-    else if (!strcmp(ch->sig, "B3I")) {
-        decode_B3I(ch);
-    }
-    else if (!strcmp(ch->sig, "I1SD")) {
-        decode_I1SD(ch);
-    }
-    else if (!strcmp(ch->sig, "I1SP")) {
-        decode_I1SP(ch);
-    }
-    else if (!strcmp(ch->sig, "I5S")) {
-        decode_I5S(ch);
-    }
-    else if (!strcmp(ch->sig, "ISS")) {
-        decode_ISS(ch);
+    // navigation data decoders indexed by signal ID (SDR_SIG_???)
+    static void (*const decode[SDR_NUM_SIG])(sdr_ch_t *) = {
+        NULL, decode_L1CA, decode_L1S, decode_L1CB, decode_L1CP, decode_L1CD,
+        decode_L2CM, NULL, decode_L5I, decode_L5Q, decode_L5SI, decode_L5SQ,
+        decode_L5SIV, decode_L5SQV, decode_L6D, decode_L6E, decode_G1CA,
+        decode_G2CA, decode_G1OCD, decode_G1OCP, NULL, decode_G3OCD,
+        decode_G3OCP, decode_E1B, decode_E1C, decode_E5AI, decode_E5AQ,
+        decode_E5BI, decode_E5BQ, decode_E6B, decode_E6C, decode_B1I,
+        decode_B1CD, decode_B1CP, decode_B2I, decode_B2AD, decode_B2AP,
+        decode_B2BI, decode_B3I, decode_I1SD, decode_I1SP, decode_I5S,
+        decode_ISS
+    };
+    int64_t t0 = sdr_get_tick_ns();
+    
+    poll_dec(ch);
+    
+    if (ch->sig_id > 0 && ch->sig_id < SDR_NUM_SIG && decode[ch->sig_id]) {
+        decode[ch->sig_id](ch);
     }
+    sdr_perf_add(SDR_PERF_NAV, t0);
 }
 
@@ -12,20 +12,28 @@
 //
 //  History:
 //  2024-01-25  1.0  port sdr_nb_ldpc.py to C
+//  2026-10-15  1.1  16-bit integer LLRs and SIMD kernels of node updates
+//                   allocation-free decoder with node edge lists
+//                   soft-decision input symbols
 //
-#include <math.h>
 #include "pocket_sdr.h"
+#if defined(AVX2)
+#include <immintrin.h>
+#elif defined(NEON)
+#include <arm_neon.h>
+#endif
 
 // constants --------------------------------------------------------------------
 #define N_GF        6           // number of GF(q) bits
 #define Q_GF        (1<<N_GF)   // number of GF(q) elements
 #define MAX_ITER    15          // max number of iterations
 #define NM_EMS      4           // LLR truncation size of EMS
-#define ERR_PROB    1e-5        // error probability of input codes
+#define LLR_MAX     0xFFFF      // max LLR (saturated)
+#define LLR_BIT     4           // max LLR of a binary code
 
 #define MAX_H_M     128         // max rows of H-matrix
 #define MAX_H_N     256         // max columns of H-matrix
-#define MAX_EDGE    1024        // max number of Tanner graph edges
+#define MAX_EDGE    (MAX_H_M*4) // max number of Tanner graph edges
 
 // GF(q) tables -----------------------------------------------------------------
 static const uint8_t GF_VEC[Q_GF] = { // power -> vector ([1])
@@ -41,61 +49,32 @@ static const uint8_t GF_POW[Q_GF] = { // vector -> power ([1])
     10, 61, 46, 30, 50, 22, 39, 43, 29, 60, 42, 21, 20, 59, 57, 58
 };
 static uint8_t GF_MUL[Q_GF][Q_GF] = {{0}}; // multiply
+static uint8_t GF_INV[Q_GF] = {0};         // inverse
+static pthread_mutex_t GF_mtx = PTHREAD_MUTEX_INITIALIZER;
+static int GF_init = 0;
 
-// get index of min value in array ---------------------------------------------
-static int argmin(const float *L, int n)
-{
-    int j = 0;
-    for (int i = 1; i < n; i++) {
-        if (L[i] < L[j]) j = i;
-    }
-    return j;
-}
-
-// swap index ------------------------------------------------------------------
-static void swap_idx(int *idx, int i, int j)
-{
-    int idx_tmp = idx[i];
-    idx[i] = idx[j];
-    idx[j] = idx_tmp;
-}
-
-// get index of sorted array ---------------------------------------------------
-static void argsort(const float *L, int n, int *idx)
-{
-    for (int i = 0; i < n; i++) {
-        idx[i] = i;
-    }
-    for (int i = 0; i < n - 1; i++) { // bubble sort
-        for (int j = n - 2; j >= i; j--) {
-            if (L[idx[j]] > L[idx[j+1]]) swap_idx(idx, j, j + 1);
-        }
-    }
-}
+// type definitions ------------------------------------------------------------
+typedef void (*add_LLR_t)(uint16_t *L1, const uint16_t *L2);
+typedef int (*norm_LLR_t)(uint16_t *L);
+typedef void (*min_idx_t)(const uint16_t *L, uint8_t *idx);
 
 // initialize GF(q) table ------------------------------------------------------
 static void init_table(void)
 {
-    if (GF_MUL[1][1]) {
+    if (__atomic_load_n(&GF_init, __ATOMIC_ACQUIRE)) {
         return;
     }
-    for (int i = 1; i < Q_GF; i++) {
-        for (int j = 1; j < Q_GF; j++) {
-            GF_MUL[i][j] = GF_VEC[(GF_POW[i] + GF_POW[j]) % (Q_GF - 1)];
-        }
-    }
-}
-
-// convert binary codes to GF(q) codes -----------------------------------------
-static void bin2gf(const uint8_t *syms, int n, uint8_t *code)
-{
-    memset(code, 0, n);
-    
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < N_GF; j++) {
-            code[i] = (code[i] << 1) + (syms[i*N_GF+j] & 1);
+    pthread_mutex_lock(&GF_mtx);
+    if (!GF_init) {
+        for (int i = 1; i < Q_GF; i++) {
+            for (int j = 1; j < Q_GF; j++) {
+                GF_MUL[i][j] = GF_VEC[(GF_POW[i] + GF_POW[j]) % (Q_GF - 1)];
+                if (GF_MUL[i][j] == 1) GF_INV[i] = (uint8_t)j;
+            }
         }
+        __atomic_store_n(&GF_init, 1, __ATOMIC_RELEASE);
     }
+    pthread_mutex_unlock(&GF_mtx);
 }
 
 // convert GF(q) codes to binary codes -----------------------------------------
@@ -109,200 +88,474 @@ static void gf2bin(const uint8_t *code, int n, uint8_t *syms)
 }
 
 // Tanner graph edges ----------------------------------------------------------
+//  The edges of check node i are 4*i,...,4*i+3. The edges of variable node j
+//  are vn_edge[vn_idx[j]],...,vn_edge[vn_idx[j+1]-1].
 static int graph_edge(const uint8_t H_idx[][4], const uint8_t H_ele[][4], int m,
-    int *ie, int *je, uint8_t *he)
+    int n, uint8_t *je, uint8_t *he, uint16_t *vn_idx, uint16_t *vn_edge)
 {
-    int ne = 0;
+    int ne = 0, k[MAX_H_N] = {0};
     
     for (int i = 0; i < m; i++) {
-        for (int j = 0; j < 4 && ne < MAX_EDGE; j++) {
-            ie[ne] = i;
+        for (int j = 0; j < 4; j++) {
             je[ne] = H_idx[i][j];
             he[ne++] = H_ele[i][j];
         }
     }
+    memset(vn_idx, 0, sizeof(uint16_t) * (n + 1));
+    for (int i = 0; i < ne; i++) {
+        vn_idx[je[i]+1]++;
+    }
+    for (int j = 0; j < n; j++) {
+        vn_idx[j+1] += vn_idx[j];
+    }
+    for (int i = 0; i < ne; i++) {
+        vn_edge[vn_idx[je[i]] + k[je[i]]++] = (uint16_t)i;
+    }
     return ne;
 }
 
-// copy LLR (L1 = L2.copy()) ---------------------------------------------------
-static void copy_LLR(float *L1, const float *L2)
+// insert index to indices of NM_EMS min values --------------------------------
+//  The indices are sorted by the values and by the indices for equal values.
+//  The index should be inserted in ascending order.
+static void ins_idx(const uint16_t *L, int i, uint8_t *idx, int *n)
 {
+    if (*n == NM_EMS && L[i] >= L[idx[NM_EMS-1]]) return;
+    int j = *n < NM_EMS ? (*n)++ : NM_EMS - 1;
+    for ( ; j > 0 && L[idx[j-1]] > L[i]; j--) {
+        idx[j] = idx[j-1];
+    }
+    idx[j] = (uint8_t)i;
+}
+
+// get indices of NM_EMS min values in LLR -------------------------------------
+static void min_idx_c(const uint16_t *L, uint8_t *idx)
+{
+    int n = 0;
+    
     for (int i = 0; i < Q_GF; i++) {
-        L1[i] = L2[i];
+        ins_idx(L, i, idx, &n);
     }
 }
 
-// add LLR (L1 += L2) ----------------------------------------------------------
-static void add_LLR(float *L1, const float *L2)
+// add LLR (L1 = sat(L1 + L2)) -------------------------------------------------
+static void add_LLR_c(uint16_t *L1, const uint16_t *L2)
 {
     for (int i = 0; i < Q_GF; i++) {
-        L1[i] += L2[i];
+        int L = L1[i] + L2[i];
+        L1[i] = (uint16_t)(L < LLR_MAX ? L : LLR_MAX);
     }
 }
 
-// normalize LLR (L -= min(L)) -------------------------------------------------
-static void norm_LLR(float *L)
+// normalize LLR (L -= min(L)) and return index of min value -------------------
+static int norm_LLR_c(uint16_t *L)
 {
-    float minL = L[argmin(L, Q_GF)];
+    int j = 0;
+    
+    for (int i = 1; i < Q_GF; i++) {
+        if (L[i] < L[j]) j = i;
+    }
+    uint16_t minL = L[j];
     
     for (int i = 0; i < Q_GF; i++) {
         L[i] -= minL;
     }
+    return j;
 }
 
-// initialize LLR --------------------------------------------------------------
-static void init_LLR(const uint8_t *code, int n, float err_prob, float **L)
+#if defined(AVX2)
+// add LLR (SSE4) --------------------------------------------------------------
+SDR_TARGET_SSE4
+static void add_LLR_sse4(uint16_t *L1, const uint16_t *L2)
+{
+    for (int i = 0; i < Q_GF; i += 8) {
+        __m128i x1 = _mm_loadu_si128((__m128i *)(L1 + i));
+        __m128i x2 = _mm_loadu_si128((__m128i *)(L2 + i));
+        _mm_storeu_si128((__m128i *)(L1 + i), _mm_adds_epu16(x1, x2));
+    }
+}
+
+// normalize LLR (SSE4) --------------------------------------------------------
+//  The min of LLRs is searched by PHMINPOSUW.
+SDR_TARGET_SSE4
+static int norm_LLR_sse4(uint16_t *L)
+{
+    __m128i x[8], xm = _mm_set1_epi16(-1), xz = _mm_setzero_si128();
+    
+    for (int i = 0; i < 8; i++) {
+        x[i] = _mm_loadu_si128((__m128i *)(L + i * 8));
+        xm = _mm_min_epu16(xm, x[i]);
+    }
+    xm = _mm_set1_epi16((int16_t)_mm_extract_epi16(_mm_minpos_epu16(xm), 0));
+    int j = -1;
+    
+    for (int i = 0; i < 8; i++) {
+        x[i] = _mm_subs_epu16(x[i], xm);
+        _mm_storeu_si128((__m128i *)(L + i * 8), x[i]);
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(x[i], xz));
+        if (j < 0 && mask) j = i * 8 + __builtin_ctz(mask) / 2;
+    }
+    return j;
+}
+
+// get indices of NM_EMS min values in LLR (SSE4) ------------------------------
+//  The min is searched by PHMINPOSUW and the first index of the min is
+//  searched in the mask of equal values. The found LLR is masked by 0xFFFF.
+SDR_TARGET_SSE4
+static void min_idx_sse4(const uint16_t *L, uint8_t *idx)
+{
+    const __m128i xi = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    __m128i x[8];
+    uint64_t used = 0;
+    
+    for (int i = 0; i < 8; i++) {
+        x[i] = _mm_loadu_si128((__m128i *)(L + i * 8));
+    }
+    for (int k = 0; k < NM_EMS; k++) {
+        __m128i xm = _mm_min_epu16(_mm_min_epu16(_mm_min_epu16(x[0], x[1]),
+            _mm_min_epu16(x[2], x[3])), _mm_min_epu16(_mm_min_epu16(x[4],
+            x[5]), _mm_min_epu16(x[6], x[7])));
+        xm = _mm_set1_epi16((int16_t)_mm_extract_epi16(_mm_minpos_epu16(xm),
+            0));
+        uint64_t mask = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i xe = _mm_packs_epi16(_mm_cmpeq_epi16(x[i*2], xm),
+                _mm_cmpeq_epi16(x[i*2+1], xm));
+            mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(xe) << (i * 16);
+        }
+        int j = __builtin_ctzll(mask & ~used);
+        idx[k] = (uint8_t)j;
+        used |= 1ull << j;
+        x[j/8] = _mm_or_si128(x[j/8], _mm_cmpeq_epi16(xi,
+            _mm_set1_epi16((int16_t)(j % 8))));
+    }
+}
+
+// add LLR (AVX2) --------------------------------------------------------------
+SDR_TARGET_AVX2
+static void add_LLR_avx2(uint16_t *L1, const uint16_t *L2)
+{
+    for (int i = 0; i < Q_GF; i += 16) {
+        __m256i y1 = _mm256_loadu_si256((__m256i *)(L1 + i));
+        __m256i y2 = _mm256_loadu_si256((__m256i *)(L2 + i));
+        _mm256_storeu_si256((__m256i *)(L1 + i), _mm256_adds_epu16(y1, y2));
+    }
+}
+
+// normalize LLR (AVX2) --------------------------------------------------------
+SDR_TARGET_AVX2
+static int norm_LLR_avx2(uint16_t *L)
+{
+    __m256i y[4], yz = _mm256_setzero_si256();
+    
+    for (int i = 0; i < 4; i++) {
+        y[i] = _mm256_loadu_si256((__m256i *)(L + i * 16));
+    }
+    __m256i ym = _mm256_min_epu16(_mm256_min_epu16(y[0], y[1]),
+        _mm256_min_epu16(y[2], y[3]));
+    __m128i xm = _mm_minpos_epu16(_mm_min_epu16(_mm256_castsi256_si128(ym),
+        _mm256_extracti128_si256(ym, 1)));
+    ym = _mm256_set1_epi16((int16_t)_mm_extract_epi16(xm, 0));
+    int j = -1;
+    
+    for (int i = 0; i < 4; i++) {
+        y[i] = _mm256_subs_epu16(y[i], ym);
+        _mm256_storeu_si256((__m256i *)(L + i * 16), y[i]);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi16(y[i], yz));
+        if (j < 0 && mask) j = i * 16 + __builtin_ctz(mask) / 2;
+    }
+    return j;
+}
+
+// add LLR (AVX-512) -----------------------------------------------------------
+SDR_TARGET_AVX512
+static void add_LLR_avx512(uint16_t *L1, const uint16_t *L2)
+{
+    for (int i = 0; i < Q_GF; i += 32) {
+        __m512i z1 = _mm512_loadu_si512(L1 + i);
+        __m512i z2 = _mm512_loadu_si512(L2 + i);
+        _mm512_storeu_si512(L1 + i, _mm512_adds_epu16(z1, z2));
+    }
+}
+
+// normalize LLR (AVX-512) -----------------------------------------------------
+//  The halves are extracted by the zero-masked form with the full mask as the
+//  unmasked one merges an uninitialized vector warned by GCC 12.
+SDR_TARGET_AVX512
+static int norm_LLR_avx512(uint16_t *L)
+{
+    __m512i z0 = _mm512_loadu_si512(L), z1 = _mm512_loadu_si512(L + 32);
+    __m512i zm = _mm512_min_epu16(z0, z1), zz = _mm512_setzero_si512();
+    __m256i ym = _mm256_min_epu16(_mm512_maskz_extracti64x4_epi64(0xF, zm, 0),
+        _mm512_maskz_extracti64x4_epi64(0xF, zm, 1));
+    __m128i xm = _mm_minpos_epu16(_mm_min_epu16(_mm256_castsi256_si128(ym),
+        _mm256_extracti128_si256(ym, 1)));
+    zm = _mm512_set1_epi16((int16_t)_mm_extract_epi16(xm, 0));
+    z0 = _mm512_subs_epu16(z0, zm);
+    z1 = _mm512_subs_epu16(z1, zm);
+    _mm512_storeu_si512(L, z0);
+    _mm512_storeu_si512(L + 32, z1);
+    uint64_t mask = (uint64_t)_mm512_cmpeq_epi16_mask(z0, zz) |
+        ((uint64_t)_mm512_cmpeq_epi16_mask(z1, zz) << 32);
+    return __builtin_ctzll(mask);
+}
+
+#elif defined(NEON)
+// add LLR (NEON) --------------------------------------------------------------
+static void add_LLR_neon(uint16_t *L1, const uint16_t *L2)
+{
+    for (int i = 0; i < Q_GF; i += 8) {
+        vst1q_u16(L1 + i, vqaddq_u16(vld1q_u16(L1 + i), vld1q_u16(L2 + i)));
+    }
+}
+
+// normalize LLR (NEON) --------------------------------------------------------
+static int norm_LLR_neon(uint16_t *L)
+{
+    uint16x8_t x[8], xm = vdupq_n_u16(LLR_MAX);
+    int j = 0;
+    
+    for (int i = 0; i < 8; i++) {
+        x[i] = vld1q_u16(L + i * 8);
+        xm = vminq_u16(xm, x[i]);
+    }
+    xm = vdupq_n_u16(vminvq_u16(xm));
+    
+    for (int i = 0; i < 8; i++) {
+        vst1q_u16(L + i * 8, vqsubq_u16(x[i], xm));
+    }
+    while (L[j]) j++;
+    return j;
+}
+#endif // AVX2, NEON
+
+// select LLR kernels by SIMD variant ------------------------------------------
+static void sel_kern(add_LLR_t *add_LLR, norm_LLR_t *norm_LLR,
+    min_idx_t *min_idx)
+{
+    int simd = sdr_get_simd();
+    
+    *add_LLR = add_LLR_c;
+    *norm_LLR = norm_LLR_c;
+    *min_idx = min_idx_c;
+#if defined(AVX2)
+    if (simd >= SDR_SIMD_SSE4) {
+        *min_idx = min_idx_sse4;
+    }
+    if (simd >= SDR_SIMD_AVX512) {
+        *add_LLR = add_LLR_avx512;
+        *norm_LLR = norm_LLR_avx512;
+    }
+    else if (simd >= SDR_SIMD_AVX2) {
+        *add_LLR = add_LLR_avx2;
+        *norm_LLR = norm_LLR_avx2;
+    }
+    else if (simd >= SDR_SIMD_SSE4) {
+        *add_LLR = add_LLR_sse4;
+        *norm_LLR = norm_LLR_sse4;
+    }
+#elif defined(NEON)
+    if (simd >= SDR_SIMD_NEON) {
+        *add_LLR = add_LLR_neon;
+        *norm_LLR = norm_LLR_neon;
+    }
+#endif
+}
+
+// initialize LLR and hard-decision GF(q) codes --------------------------------
+//  The LLR of a binary code is the soft-decision symbol (0-255) quantized to
+//  0-LLR_BIT and the LLR of a GF(q) symbol is the sum of LLRs of the bits
+//  different from the hard-decision. The scale of LLRs does not affect the
+//  min-sum decoding.
+static void init_LLR(const uint8_t *syms, int n, uint16_t (*L)[Q_GF],
+    uint8_t *code)
 {
     for (int i = 0; i < n; i++) {
+        uint16_t w[N_GF];
+        code[i] = 0;
+        for (int j = 0; j < N_GF; j++) {
+            int s = syms[i*N_GF+j];
+            code[i] = (code[i] << 1) + (s >= 128);
+            w[N_GF-1-j] = (uint16_t)((abs(2 * s - 255) + 1) * LLR_BIT / 256);
+        }
         for (int j = 0; j < Q_GF; j++) {
-            int nerr = 0;
+            uint16_t Lj = 0;
             for (int k = 0; k < N_GF; k++) {
-                if ((code[i] ^ j) & (1<<k)) nerr++;
+                if (((code[i] ^ j) >> k) & 1) Lj += w[k];
             }
-            L[i][j] = -logf(err_prob) * nerr;
+            L[i][j] = Lj;
         }
     }
 }
 
 // NB-LDPC parity check --------------------------------------------------------
-static int check_parity(const int *ie, const int *je, const uint8_t *he, int ne,
-    int m, const uint8_t *code)
+static int check_parity(const uint8_t *je, const uint8_t *he, int m,
+    const uint8_t *code)
 {
-    uint8_t s[MAX_H_M] = {0};
-    
-    for (int i = 0; i < ne; i++) {
-        s[ie[i]] ^= GF_MUL[he[i]][code[je[i]]];
-    }
     for (int i = 0; i < m; i++) {
-        if (s[i] != 0) return 0;
+        uint8_t s = 0;
+        for (int j = i * 4; j < i * 4 + 4; j++) {
+            s ^= GF_MUL[he[j]][code[je[j]]];
+        }
+        if (s != 0) return 0;
     }
     return 1;
 }
 
-// permute VN->CN message ------------------------------------------------------
-static void permute_V2C(uint8_t h, const float *V2C, float *V2C_p)
+// permute VN->CN message (V2C_p[h * i] = V2C[i]) ------------------------------
+static void permute_V2C(uint8_t h, const uint16_t *V2C, uint16_t *V2C_p)
 {
+    const uint8_t *mul = GF_MUL[GF_INV[h]];
+    
     for (int i = 0; i < Q_GF; i++) {
-        V2C_p[GF_MUL[h][i]] = V2C[i];
+        V2C_p[i] = V2C[mul[i]];
     }
 }
 
-// permute CN->VN message ------------------------------------------------------
-static void permute_C2V(uint8_t h, const float *C2V, float *C2V_p)
+// permute CN->VN message (C2V_p[i] = C2V[h * i]) ------------------------------
+static void permute_C2V(uint8_t h, const uint16_t *C2V, uint16_t *C2V_p)
 {
+    const uint8_t *mul = GF_MUL[h];
+    
     for (int i = 0; i < Q_GF; i++) {
-        C2V_p[i] = C2V[GF_MUL[h][i]];
+        C2V_p[i] = C2V[mul[i]];
     }
 }
 
-// extended-min-sum (EMS) of LLRs (L1 = min(L1 + L2)) ([2]) --------------------
-static void ext_min_sum(float *L1, const float *L2)
+// extended-min-sum (EMS) of LLRs (Ls = min(L1 + L2)) ([2]) --------------------
+//  idx1 and idx2 are the indices of NM_EMS min values of L1 and L2. The indices
+//  of NM_EMS min values of Ls are searched only in the updated elements
+//  because the others are max values.
+static void ext_min_sum(const uint16_t *L1, const uint8_t *idx1,
+    const uint16_t *L2, const uint8_t *idx2, uint16_t *Ls, uint8_t *idxs)
 {
-    float Ls[Q_GF], maxL;
-    int idx1[Q_GF], idx2[Q_GF];
+    int maxL = L1[idx1[NM_EMS-1]] + L2[idx2[NM_EMS-1]], n = 0;
+    uint64_t upd = 0;
     
-    if (L1[0] < 0.0) { // first sum
-        copy_LLR(L1, L2);
-        return;
-    }
-    argsort(L1, Q_GF, idx1);
-    argsort(L2, Q_GF, idx2);
-    maxL = L1[idx1[NM_EMS-1]] + L2[idx2[NM_EMS-1]];
+    if (maxL > LLR_MAX) maxL = LLR_MAX;
     
     for (int i = 0; i < Q_GF; i++) {
-        Ls[i] = maxL;
+        Ls[i] = (uint16_t)maxL;
     }
+    
     for (int k = 0; k < NM_EMS; k++) {
         for (int m = 0; m < NM_EMS; m++) {
             int i = idx1[k], j = idx2[m];
             if (L1[i] + L2[j] < Ls[i^j]) {
-                Ls[i^j] = L1[i] + L2[j];
+                Ls[i^j] = (uint16_t)(L1[i] + L2[j]);
+                upd |= 1ull << (i^j);
             }
         }
     }
-    copy_LLR(L1, Ls);
+    if (!idxs) return;
+    for (uint64_t mask = upd; mask; mask &= mask - 1) {
+        ins_idx(Ls, __builtin_ctzll(mask), idxs, &n);
+    }
+    for (int i = 0; n < NM_EMS; i++) {
+        if (!((upd >> i) & 1)) idxs[n++] = (uint8_t)i;
+    }
 }
 
-// decode NB-LDPC --------------------------------------------------------------
+//------------------------------------------------------------------------------
+//  Decode NB-LDPC code over GF(64) by the extended min-sum (EMS) decoder ([2]).
+//  The LLRs and the messages are 16-bit saturated integers and the LLR kernels
+//  are selected by the SIMD variant (see sdr_set_simd()). The decoding is
+//  terminated when the parity check is satisfied. No memory is allocated and
+//  no global variable is modified except GF(q) tables at the first call.
+//
+//  args:
+//      H_idx    (I)  column indices of H-matrix nonzero elements (m x 4)
+//      H_ele    (I)  H-matrix nonzero elements (m x 4)
+//      m, n     (I)  rows and columns of H-matrix (m <= 128, n <= 256)
+//      syms     (I)  soft-decision binary codes (n * 6 bits) (0-255)
+//                    (0: strong 0, 255: strong 1, 128: erasure)
+//      syms_dec (O)  decoded binary codes (m * 6 bits)
+//
+//  return:
+//      number of corrected bit errors (-1: decoding failed)
+//
 int sdr_decode_NB_LDPC(const uint8_t H_idx[][4], const uint8_t H_ele[][4],
     int m, int n, const uint8_t *syms, uint8_t *syms_dec)
 {
-    float *V2C[MAX_EDGE], *C2V[MAX_EDGE], *L[MAX_H_N], Ls[Q_GF];
-    uint8_t code[MAX_H_N], he[MAX_EDGE];
-    int iter, ne, ie[MAX_EDGE], je[MAX_EDGE], nerr = -1;
+    uint16_t V2C[MAX_EDGE][Q_GF], C2V[MAX_EDGE][Q_GF];
+    uint16_t L[MAX_H_N][Q_GF], Ls[2][Q_GF];
+    uint8_t code[MAX_H_N], je[MAX_EDGE], he[MAX_EDGE];
+    uint8_t idx[MAX_EDGE][NM_EMS], idx_s[2][NM_EMS];
+    uint16_t vn_idx[MAX_H_N+1], vn_edge[MAX_EDGE];
+    add_LLR_t add_LLR;
+    norm_LLR_t norm_LLR;
+    min_idx_t min_idx;
+    int ne, nerr = -1;
     
-    // initialize GF(q) tables
+    if (m > MAX_H_M || n > MAX_H_N) {
+        return -1;
+    }
+    // initialize GF(q) tables and LLR kernels
     init_table();
-    
-    // convert binary codes to GF(q) codes
-    bin2gf(syms, n, code);
+    sel_kern(&add_LLR, &norm_LLR, &min_idx);
     
     // Tanner graph edges
-    ne = graph_edge(H_idx, H_ele, m, ie, je, he);
-    for (int i = 0; i < ne; i++) {
-        V2C[i] = (float *)sdr_malloc(sizeof(float) * Q_GF);
-        C2V[i] = (float *)sdr_malloc(sizeof(float) * Q_GF);
-    }
-    // initialize LLR and VN->CN messages
-    for (int i = 0; i < n; i++) {
-        L[i] = (float *)sdr_malloc(sizeof(float) * Q_GF);
-    }
-    init_LLR(code, n, ERR_PROB, L);
+    ne = graph_edge(H_idx, H_ele, m, n, je, he, vn_idx, vn_edge);
+    
+    // initialize LLR, hard-decision GF(q) codes and VN->CN messages
+    init_LLR(syms, n, L, code);
     
     for (int i = 0; i < ne; i++) {
         permute_V2C(he[i], L[je[i]], V2C[i]);
+        min_idx(V2C[i], idx[i]);
     }
-    for (iter = 0; iter < MAX_ITER; iter++) {
+    for (int iter = 0; iter < MAX_ITER; iter++) {
         // parity check
-        if (check_parity(ie, je, he, ne, m, code)) {
+        if (check_parity(je, he, m, code)) {
             nerr = 0;
             for (int i = 0; i < n * N_GF; i++) {
                 uint8_t sym = (code[i/N_GF] >> (N_GF-1-i%N_GF)) & 1;
-                if (sym != syms[i]) nerr++;
+                if (sym != (syms[i] >= 128)) nerr++;
             }
             gf2bin(code, m, syms_dec);
             break;
         }
         // update check nodes
         for (int i = 0; i < ne; i++) {
-            Ls[0] = -1.0; // initial LLR
-            for (int j = 0; j < ne; j++) {
-                if (ie[i] == ie[j] && i != j) {
-                    ext_min_sum(Ls, V2C[j]);
+            const uint16_t *L1 = NULL;
+            const uint8_t *idx1 = NULL;
+            uint16_t *Lc = NULL;
+            int j0 = i & ~3, j1 = i == j0 + 3 ? j0 + 2 : j0 + 3; // last sum
+            for (int j = j0, k = 0; j < j0 + 4; j++) {
+                if (j == i) continue;
+                if (!L1) { // first sum
+                    L1 = V2C[j];
+                    idx1 = idx[j];
+                    continue;
                 }
+                Lc = Ls[k];
+                ext_min_sum(L1, idx1, V2C[j], idx[j], Lc, j < j1 ? idx_s[k] : NULL);
+                L1 = Lc;
+                idx1 = idx_s[k];
+                k ^= 1;
             }
-            norm_LLR(Ls);
-            permute_C2V(he[i], Ls, C2V[i]);
+            norm_LLR(Lc);
+            permute_C2V(he[i], Lc, C2V[i]);
         }
         // update variable nodes
         for (int i = 0; i < ne; i++) {
-            copy_LLR(Ls, L[je[i]]);
-            for (int j = 0; j < ne; j++) {
-                if (je[i] == je[j] && i != j) {
-                    add_LLR(Ls, C2V[j]);
-                }
+            const uint16_t *edge = vn_edge + vn_idx[je[i]];
+            int deg = vn_idx[je[i]+1] - vn_idx[je[i]];
+            memcpy(Ls[0], L[je[i]], sizeof(Ls[0]));
+            for (int j = 0; j < deg; j++) {
+                if (edge[j] != i) add_LLR(Ls[0], C2V[edge[j]]);
             }
-            norm_LLR(Ls);
-            permute_V2C(he[i], Ls, V2C[i]);
+            norm_LLR(Ls[0]);
+            permute_V2C(he[i], Ls[0], V2C[i]);
+            min_idx(V2C[i], idx[i]);
         }
         // update LLR and GF(q) codes
         for (int i = 0; i < n; i++) {
-            for (int j = 0; j < ne; j++) {
-                if (i == je[j]) {
-                    add_LLR(L[i], C2V[j]);
-                }
+            for (int j = vn_idx[i]; j < vn_idx[i+1]; j++) {
+                add_LLR(L[i], C2V[vn_edge[j]]);
             }
-            norm_LLR(L[i]);
-            code[i] = (uint8_t)argmin(L[i], Q_GF);
+            code[i] = (uint8_t)norm_LLR(L[i]);
         }
     }
-    for (int i = 0; i < ne; i++) {
-        sdr_free(V2C[i]);
-        sdr_free(C2V[i]);
-    }
-    for (int i = 0; i < n; i++) {
-        sdr_free(L[i]);
-    }
     return nerr;
 }
-
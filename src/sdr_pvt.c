@@ -6,6 +6,33 @@
 //
 //  History:
 //  2024-04-28  1.0  new
+//  2026-10-14  1.1  output only within output window of receiver
+//                   predict Doppler and visibility of satellites for
+//                   acquisition assist, add API sdr_pvt_pred_dop()
+//                   use signal ID and descriptor of channel
+//                   no observation data of channels coasting across IF data
+//                   gaps
+//                   lock-free observation slots of channels, queue of
+//                   navigation data and PVT thread, add API sdr_pvt_start()
+//                   output NMEA and RTCM3 to asynchronous output streams
+//                   count performance of PVT solution update, add API
+//                   sdr_pvt_nav_queue()
+//                   predict range acceleration of satellites and Doppler at
+//                   IF data cycle, modify API sdr_pvt_pred_dop()
+//                   point positioning by satellite position cache of Chebyshev
+//                   polynomial fits instead of RTKLIB pntpos()
+//                   add fast-rate PVT solution by observation data extrapolated
+//                   from latest tracking states of channels
+//                   encode RTCM3 MSM7 messages of epoch directly from
+//                   observation data to a buffer written by a write
+//                   add warm-start state file of receiver position, clock
+//                   drift, ephemerides and range rates of channels, add APIs
+//                   sdr_pvt_save_state(), sdr_pvt_load_state()
+//                   publish PVT status snapshot by seqlock, sdr_pvt_solstr():
+//                   format solution string from snapshot without lock
+//                   publish satellite status snapshot by seqlock
+//                   set and load warm-start seed for receivers of batch, add
+//                   API sdr_pvt_load_seed()
 //
 #include "pocket_sdr.h"
 
@@ -14,13 +41,69 @@
 #define LAG_EPOCH      0.05     // max PVT epoch lag (s)
 #define EL_MASK        15.0     // elavation mask (deg)
 #define FILE_NAV       ".pocket_navdata.csv" // navigation data file
+#define MIN_LOCK_PRED  2.0      // min lock time to estimate clock drift (s)
+#define TO_PRED        30.0     // timeout of satellite prediction (s)
+#define NAVQ_SIZE      128      // size of navigation data message queue
+#define WAIT_PVT       10       // max wait time of PVT thread (ms)
+#define SPAN_EPH       300.0    // time span of satellite position fit (s)
+#define NX             (4+4)    // number of estimated parameters
+#define MAX_ITR        10       // max number of iterations of point positioning
+#define ERR_CBIAS      0.3      // code bias error std (m)
+#define LAG_FAST       2        // lag of fast-rate epoch update (cyc)
+#define MAX_AGE_FAST   0.1      // max age of observation for fast-rate epoch (s)
+#define N_ITR_FAST     2        // number of iterations of fast-rate solution
+#define FAST_SYNC      0xF5     // sync code of fast-rate PVT record
+#define FAST_LEN       56       // length of fast-rate PVT record (bytes)
+#define RTCM3_PREAMB   0xD3     // RTCM3 frame preamble
+#define MAX_MSG_RTCM   (1024+6) // max length of RTCM3 message (bytes)
+#define MAX_RTCM_EP    65536    // max length of RTCM3 messages of epoch (bytes)
+#define RANGE_MS       (CLIGHT * 1e-3) // range in 1 ms (m)
+#define P2_10          0.0009765625 // 2^-10
+#define STATE_ID       "PSDRSTAT" // ID of warm-start state file
+#define STATE_VER      1        // version of warm-start state file
+#define STATE_CYC      60.0     // interval to save warm-start state (s)
+#define TO_WARM        60.0     // timeout of warm-start prediction (s)
+#define MAX_AGE_RATE   60.0     // max age of range rates of warm-start (s)
 
+#define SQR(x)     ((x) * (x))
+#define MIN(x, y)  ((x) < (y) ? (x) : (y))
+#define MAX(x, y)  ((x) > (y) ? (x) : (y))
 #define ROUND(x)   (int)floor((x) + 0.5)
 
 // global variable -------------------------------------------------------------
 double sdr_epoch     = SDR_EPOCH;
 double sdr_lag_epoch = LAG_EPOCH;
 double sdr_el_mask   = EL_MASK;
+double sdr_t_fast    = 0.0;     // fast-rate epoch interval (s) (0: off)
+char sdr_state_file[1024] = ""; // warm-start state file ("": no)
+
+// type definitions ------------------------------------------------------------
+typedef struct {                // warm-start state header type
+    char id[8];                 // file ID (STATE_ID)
+    int32_t ver;                // version (STATE_VER)
+    int32_t size[2];            // size of eph_t and geph_t (bytes)
+    int32_t n[3];               // number of ephemerides, GLONASS ephemerides
+                                // and range rates
+    gtime_t time;               // time of saving (GPST)
+    double rr[6];               // receiver position and velocity (ECEF) (m)
+    double drift;               // receiver clock drift (m/s)
+} state_head_t;
+
+typedef struct {                // warm-start state range rate type
+    int32_t sat;                // satellite number
+    float rate;                 // range rate with receiver clock drift (m/s)
+} state_rate_t;
+
+// output stream within output window of receiver -----------------------------
+static sdr_ostr_t *out_str(const sdr_pvt_t *pvt, int64_t ix, int i)
+{
+    const sdr_rcv_t *rcv = pvt->rcv;
+    
+    if (ix < rcv->ix_out || (rcv->ix_end > 0 && ix >= rcv->ix_end)) {
+        return NULL;
+    }
+    return rcv->strs[i];
+}
 
 // system index ----------------------------------------------------------------
 static int sys_idx(int sat)
@@ -37,31 +120,6 @@ static int sys_idx(int sat)
     return -1;
 }
 
-// signal ID to signal code -----------------------------------------------------
-static uint8_t sig2code(const char *sig)
-{
-    static const char *sigs[] = {
-        "L1CA" , "L1S"  , "L1CB" , "L1CP" , "L1CD" , "L2CM" , "L2CL" ,
-        "L5I"  , "L5Q"  , "L5SI" , "L5SQ" , "L5SIV", "L5SQV", "L6D"  ,
-        "L6E"  , "G1CA" , "G2CA" , "G1OCD", "G1OCP", "G2OCP", "G3OCD",
-        "G3OCP", "E1B"  , "E1C"  , "E5AI" , "E5AQ" , "E5BI" , "E5BQ" ,
-        "E6B"  , "E6C"  , "B1I"  , "B1CD" , "B1CP" , "B2I"  , "B2AD" ,
-        "B2AP" , "B2BI" , "B3I"  , "I1SD" , "I1SP" , "I5S"  , "ISS"  , NULL
-    };
-    static const uint8_t codes[] = {
-        CODE_L1C, CODE_L1Z, CODE_L1E, CODE_L1L, CODE_L1S, CODE_L2S, CODE_L2L,
-        CODE_L5I, CODE_L5Q, CODE_L5D, CODE_L5P, CODE_L5D, CODE_L5P, CODE_L6S,
-        CODE_L6E, CODE_L1C, CODE_L2C, CODE_L4A, CODE_L4B, CODE_L6B, CODE_L3I,
-        CODE_L3Q, CODE_L1B, CODE_L1C, CODE_L5I, CODE_L5Q, CODE_L7I, CODE_L7Q,
-        CODE_L6B, CODE_L6C, CODE_L2I, CODE_L1D, CODE_L1P, CODE_L7I, CODE_L5D,
-        CODE_L5P, CODE_L7D, CODE_L6I, CODE_L1D, CODE_L1P, CODE_L5A, CODE_L9A
-    };
-    for (int i = 0; sigs[i]; i++) {
-        if (!strcmp(sig, sigs[i])) return codes[i];
-    }
-    return 0;
-}
-
 //------------------------------------------------------------------------------
 //  Output log $OBS.
 //
@@ -120,7 +178,7 @@ static void out_log_pos(double time, const sol_t *sol, int nsat)
 }
 
 // output NMEA RMC, GGA, GSA and GSV -------------------------------------------
-static void out_nmea(const sol_t *sol, const ssat_t *ssat, stream_t *str)
+static void out_nmea(const sol_t *sol, const ssat_t *ssat, sdr_ostr_t *str)
 {
     uint8_t buff[4096];
     int n = 0;
@@ -129,7 +187,7 @@ static void out_nmea(const sol_t *sol, const ssat_t *ssat, stream_t *str)
     n += outnmea_gga(buff + n, sol);
     n += outnmea_gsa(buff + n, sol, ssat);
     n += outnmea_gsv(buff + n, sol, ssat);
-    sdr_str_write(str, buff, n);
+    sdr_ostr_write(str, buff, n);
 }
 
 // count number of signals -----------------------------------------------------
@@ -149,12 +207,258 @@ static int num_sigs(int idx, const obs_t *obs)
     return nsig;
 }
 
+// MSM satellite ID ------------------------------------------------------------
+static int msm_sat_id(int sat)
+{
+    int prn, sys = satsys(sat, &prn);
+    
+    if      (sys == SYS_QZS) prn -= MINPRNQZS - 1;
+    else if (sys == SYS_SBS) prn -= MINPRNSBS - 1;
+    return (prn >= 1 && prn <= 64) ? prn : 0;
+}
+
+// MSM signal ID ---------------------------------------------------------------
+static int msm_sig_id(int sat, uint8_t code)
+{
+    extern const char *msm_sig_gps[32], *msm_sig_glo[32], *msm_sig_gal[32];
+    extern const char *msm_sig_qzs[32], *msm_sig_cmp[32], *msm_sig_irn[32];
+    extern const char *msm_sig_sbs[32];
+    static const char **msm_sig[] = {msm_sig_gps, msm_sig_glo, msm_sig_gal,
+        msm_sig_qzs, msm_sig_cmp, msm_sig_irn, msm_sig_sbs};
+    const char *obs = code2obs(code);
+    int idx = sys_idx(sat);
+    
+    if (idx < 0 || !*obs) return 0;
+    for (int i = 0; i < 32; i++) {
+        if (!strcmp(obs, msm_sig[idx][i])) return i + 1;
+    }
+    return 0;
+}
+
+// MSM lock time indicator with extended range and resolution ------------------
+static int msm_lock(double lock)
+{
+    int ms = (int)(lock * 1000.0);
+    
+    if (ms < 64) return MAX(ms, 0);
+    for (int k = 1; k <= 20; k++) {
+        if (ms < (64 << k)) return (ms + (64 << (k - 1)) * k) >> k;
+    }
+    return 704;
+}
+
+// MSM epoch time --------------------------------------------------------------
+static uint32_t msm_epoch(gtime_t time, int sys)
+{
+    if (sys == SYS_GLO) { // day of week and time of day (ms) in GLONASS time
+        double tow = time2gpst(timeadd(gpst2utc(time), 10800.0), NULL);
+        return ((uint32_t)(tow / 86400.0) << 27) +
+            (uint32_t)floor(fmod(tow, 86400.0) * 1e3 + 0.5);
+    }
+    if (sys == SYS_CMP) { // BDT TOW (ms)
+        time = gpst2bdt(time);
+    }
+    return (uint32_t)floor(time2gpst(time, NULL) * 1e3 + 0.5);
+}
+
+// set bits to zero-cleared buffer ---------------------------------------------
+static void put_bits(uint8_t *buff, int pos, int len, uint32_t data)
+{
+    uint64_t v = (uint64_t)(data & (0xFFFFFFFFu >> (32 - len))) <<
+        (64 - len - pos % 8);
+    
+    for (uint8_t *p = buff + pos / 8; v; v <<= 8) {
+        *p++ |= (uint8_t)(v >> 56);
+    }
+}
+
+// MSM fine field value --------------------------------------------------------
+static int32_t msm_val(double x, double unit, double lim, int32_t inv)
+{
+    return (x == 0.0 || fabs(x) > lim) ? inv : ROUND(x / unit);
+}
+
+//------------------------------------------------------------------------------
+//  Encode a RTCM3 MSM7 message of observation data. The message is encoded
+//  directly from the observation data to the output buffer with the RTCM3
+//  frame (preamble, length and CRC-24Q). The integer cycle offsets of the
+//  phase-ranges and the lock times of the signals are kept in the RTCM control.
+//
+//  args:
+//      rtcm     (IO) RTCM control
+//      data     (I)  observation data
+//      idx      (I)  indices of observation data of the system in the message
+//      n        (I)  number of indices (nsat x nsig <= 64)
+//      type     (I)  MSM7 message type (1077, 1087, ...)
+//      sync     (I)  multiple message bit
+//      nav      (I)  navigation data
+//      buff     (O)  output buffer
+//      size     (I)  size of output buffer (bytes)
+//
+//  returns:
+//      length of the message (bytes) (0: error)
+//
+static int encode_msm7(rtcm_t *rtcm, const obsd_t *data, const int *idx,
+    int n, int type, int sync, const nav_t *nav, uint8_t *buff, int size)
+{
+    double rrng[64] = {0}, rrate[64] = {0}, psrng[64], phrng[64], rate[64];
+    double lock[64];
+    float cnr[64];
+    uint8_t sat_ind[64] = {0}, sig_ind[32] = {0}, cell[64] = {0}, info[64];
+    uint8_t half[64], sigs[64][NFREQ+NEXOBS];
+    int sys = satsys(data[idx[0]].sat, NULL), nsat = 0, nsig = 0, i = 24;
+    
+    if (size < MAX_MSG_RTCM) return 0;
+    memset(buff, 0, MAX_MSG_RTCM);
+    
+    // satellite and signal masks
+    for (int k = 0; k < n; k++) {
+        const obsd_t *d = data + idx[k];
+        int sat = msm_sat_id(d->sat), sig;
+        for (int j = 0; j < NFREQ + NEXOBS; j++) {
+            sigs[k][j] = sat ? (uint8_t)msm_sig_id(d->sat, d->code[j]) : 0;
+            if (!(sig = sigs[k][j])) continue;
+            sat_ind[sat-1] = sig_ind[sig-1] = 1;
+        }
+    }
+    for (int k = 0; k < 64; k++) {
+        if (sat_ind[k]) sat_ind[k] = (uint8_t)++nsat;
+    }
+    for (int k = 0; k < 32; k++) {
+        if (sig_ind[k]) sig_ind[k] = (uint8_t)++nsig;
+    }
+    if (nsat <= 0 || nsat * nsig > 64) return 0;
+    
+    // satellite and cell data
+    for (int k = 0; k < n; k++) {
+        const obsd_t *d = data + idx[k];
+        int prn, sat = msm_sat_id(d->sat), sig;
+        if (!sat || !sat_ind[sat-1]) continue;
+        int s = sat_ind[sat-1] - 1;
+        satsys(d->sat, &prn);
+        info[s] = sys != SYS_GLO ? 0 : (nav->geph[prn-1].sat == d->sat ?
+            (uint8_t)(nav->geph[prn-1].frq + 7) : 15);
+        
+        for (int j = 0; j < NFREQ + NEXOBS; j++) {
+            if (!sigs[k][j]) continue;
+            double freq = sat2freq(d->sat, d->code[j], nav);
+            if (rrng[s] == 0.0 && d->P[j] != 0.0) {
+                rrng[s] = ROUND(d->P[j] / RANGE_MS / P2_10) * RANGE_MS * P2_10;
+            }
+            if (rrate[s] == 0.0 && d->D[j] != 0.0 && freq > 0.0) {
+                rrate[s] = ROUND(-d->D[j] * CLIGHT / freq);
+            }
+        }
+        for (int j = 0; j < NFREQ + NEXOBS; j++) {
+            if (!(sig = sigs[k][j])) continue;
+            double freq = sat2freq(d->sat, d->code[j], nav);
+            double lam = freq > 0.0 ? CLIGHT / freq : 0.0;
+            int c = s * nsig + sig_ind[sig-1] - 1, LLI = d->LLI[j];
+            cell[c] = 1;
+            psrng[c] = d->P[j] == 0.0 ? 0.0 : d->P[j] - rrng[s];
+            phrng[c] = d->L[j] == 0.0 || lam <= 0.0 ? 0.0 :
+                d->L[j] * lam - rrng[s];
+            rate[c] = d->D[j] == 0.0 || lam <= 0.0 ? 0.0 :
+                -d->D[j] * lam - rrate[s];
+            
+            // subtract integer cycle offset of phase-range to pseudorange
+            // (reset offset and lock time if no phase-range)
+            double *cp = rtcm->cp[d->sat-1] + j;
+            if ((LLI & 1) || fabs(phrng[c] - *cp) > 1171.0) {
+                *cp = lam > 0.0 ? ROUND(phrng[c] / lam) * lam : 0.0;
+                LLI |= 1;
+            }
+            if (phrng[c] != 0.0) phrng[c] -= *cp;
+            gtime_t *lltime = rtcm->lltime[d->sat-1] + j;
+            if (!lltime->time || (LLI & 1)) *lltime = d->time;
+            lock[c] = timediff(d->time, *lltime);
+            half[c] = (d->LLI[j] & 2) ? 1 : 0;
+            cnr[c] = (float)(d->SNR[j] * SNR_UNIT);
+        }
+    }
+    // RTCM3 frame header and MSM header
+    put_bits(buff,  0,  8, RTCM3_PREAMB);
+    put_bits(buff,  8,  6, 0);
+    put_bits(buff, i, 12, type); i += 12;
+    put_bits(buff, i, 12, rtcm->staid); i += 12;
+    put_bits(buff, i, 30, msm_epoch(rtcm->time, sys)); i += 30;
+    put_bits(buff, i,  1, sync); i += 1;
+    put_bits(buff, i,  3, rtcm->seqno); i += 3;
+    put_bits(buff, i, 15, 0); i += 15; // reserved, clock steering, external
+                                      // clock, smoothing and interval
+    for (int k = 0; k < 64; k++) {
+        put_bits(buff, i++, 1, sat_ind[k] ? 1 : 0);
+    }
+    for (int k = 0; k < 32; k++) {
+        put_bits(buff, i++, 1, sig_ind[k] ? 1 : 0);
+    }
+    for (int k = 0; k < nsat * nsig; k++) {
+        put_bits(buff, i++, 1, cell[k]);
+    }
+    // satellite data
+    for (int k = 0; k < nsat; k++) { // rough range integer ms
+        int valid = rrng[k] > 0.0 && rrng[k] <= RANGE_MS * 255.0;
+        put_bits(buff, i, 8, valid ? ROUND(rrng[k] / RANGE_MS / P2_10) >> 10 :
+            255); i += 8;
+    }
+    for (int k = 0; k < nsat; k++) { // extended satellite info
+        put_bits(buff, i, 4, info[k]); i += 4;
+    }
+    for (int k = 0; k < nsat; k++) { // rough range modulo 1 ms
+        int valid = rrng[k] > 0.0 && rrng[k] <= RANGE_MS * 255.0;
+        put_bits(buff, i, 10, valid ? ROUND(rrng[k] / RANGE_MS / P2_10) &
+            0x3FF : 0); i += 10;
+    }
+    for (int k = 0; k < nsat; k++) { // rough phase-range-rate
+        put_bits(buff, i, 14, fabs(rrate[k]) > 8191.0 ? -8192 :
+            ROUND(rrate[k])); i += 14;
+    }
+    // signal data
+    for (int k = 0; k < nsat * nsig; k++) { // fine pseudorange
+        if (!cell[k]) continue;
+        put_bits(buff, i, 20, msm_val(psrng[k], RANGE_MS * P2_29, 292.7,
+            -524288)); i += 20;
+    }
+    for (int k = 0; k < nsat * nsig; k++) { // fine phase-range
+        if (!cell[k]) continue;
+        put_bits(buff, i, 24, msm_val(phrng[k], RANGE_MS * P2_31, 1171.0,
+            -8388608)); i += 24;
+    }
+    for (int k = 0; k < nsat * nsig; k++) { // lock time indicator
+        if (!cell[k]) continue;
+        put_bits(buff, i, 10, msm_lock(lock[k])); i += 10;
+    }
+    for (int k = 0; k < nsat * nsig; k++) { // half-cycle ambiguity indicator
+        if (!cell[k]) continue;
+        put_bits(buff, i, 1, half[k]); i += 1;
+    }
+    for (int k = 0; k < nsat * nsig; k++) { // CNR
+        if (!cell[k]) continue;
+        put_bits(buff, i, 10, ROUND(cnr[k] / 0.0625)); i += 10;
+    }
+    for (int k = 0; k < nsat * nsig; k++) { // fine phase-range-rate
+        if (!cell[k]) continue;
+        put_bits(buff, i, 15, msm_val(rate[k], 0.0001, 1.6384, -16384));
+        i += 15;
+    }
+    // message length and CRC-24Q
+    int len = (i + 7) / 8;
+    if (len >= 3 + 1024) return 0;
+    put_bits(buff, 14, 10, len - 3);
+    put_bits(buff, len * 8, 24, rtk_crc24q(buff, len));
+    return len + 3;
+}
+
 // output RTCM3 observation data -----------------------------------------------
-static void out_rtcm3_obs(rtcm_t *rtcm, const obs_t *obs, stream_t *str)
+//  The MSM7 messages of an epoch are encoded to a contiguous buffer and queued
+//  to the output stream by a write.
+static void out_rtcm3_obs(rtcm_t *rtcm, const obs_t *obs, const nav_t *nav,
+    sdr_ostr_t *str)
 {
     // RTCM3 MSM message types
     static const int msgs[] = {1077, 1087, 1097, 1117, 1127, 1137, 1107, 0};
-    int nsig[7] = {0}, idx_tail = 0;
+    uint8_t buff[MAX_RTCM_EP];
+    int nsig[7] = {0}, idx_tail = 0, idx[64], len = 0;
     
     if (!str || obs->n <= 0) return;
     
@@ -162,30 +466,30 @@ static void out_rtcm3_obs(rtcm_t *rtcm, const obs_t *obs, stream_t *str)
     for (int i = 0; msgs[i]; i++) {
         if ((nsig[i] = num_sigs(i, obs))) idx_tail = i;
     }
-    for (int i = 0; i < msgs[i]; i++) {
-        rtcm->obs.n = 0;
+    for (int i = 0; msgs[i]; i++) {
+        int n = 0;
         for (int j = 0; j < obs->n; j++) {
-            obsd_t *data = obs->data + j;
-            if (sys_idx(data->sat) != i) continue;
+            if (sys_idx(obs->data[j].sat) != i) continue;
             
             // separate messages if nsat x nsig > 64
-            if ((rtcm->obs.n + 1) * nsig[i] > 64) {
-                if (gen_rtcm3(rtcm, msgs[i], 0, 1)) {
-                    sdr_str_write(str, rtcm->buff, rtcm->nbyte);
-                }
-                rtcm->obs.n = 0;
+            if ((n + 1) * nsig[i] > 64) {
+                len += encode_msm7(rtcm, obs->data, idx, n, msgs[i], 1, nav,
+                    buff + len, MAX_RTCM_EP - len);
+                n = 0;
             }
-            rtcm->obs.data[rtcm->obs.n++] = *data;
+            idx[n++] = j;
         }
-        if (rtcm->obs.n > 0 && gen_rtcm3(rtcm, msgs[i], 0, i < idx_tail)) {
-            sdr_str_write(str, rtcm->buff, rtcm->nbyte);
+        if (n > 0) {
+            len += encode_msm7(rtcm, obs->data, idx, n, msgs[i], i < idx_tail,
+                nav, buff + len, MAX_RTCM_EP - len);
         }
     }
+    sdr_ostr_write(str, buff, len);
 }
 
 // output RTCM3 navigation data ------------------------------------------------
 static void out_rtcm3_nav(rtcm_t *rtcm, int sat, int type, const nav_t *nav,
-    stream_t *str)
+    sdr_ostr_t *str)
 {
     // RTCM3 navigation message types
     static const int msgs[] = {1019, 1020, 1046, 1044, 1042, 1041, 0, 0};
@@ -201,7 +505,7 @@ static void out_rtcm3_nav(rtcm_t *rtcm, int sat, int type, const nav_t *nav,
     rtcm->ephsat = sat;
     int msg = (sys == SYS_GAL && type == 1) ? 1045 : msgs[idx];
     if (gen_rtcm3(rtcm, msg, 0, 0)) {
-        sdr_str_write(str, rtcm->buff, rtcm->nbyte);
+        sdr_ostr_write(str, rtcm->buff, rtcm->nbyte);
     }
 }
 
@@ -227,16 +531,40 @@ sdr_pvt_t *sdr_pvt_new(sdr_rcv_t *rcv)
     pvt->nav->ng = pvt->nav->ngmax = MAXPRNGLO;
     pvt->sol = (sol_t *)sdr_malloc(sizeof(sol_t));
     pvt->ssat = (ssat_t *)sdr_malloc(sizeof(ssat_t) * MAXSAT);
+    pvt->ssat_w = (ssat_t *)sdr_malloc(sizeof(ssat_t) * MAXSAT);
+    pvt->slot = (sdr_pvt_obs_t *)sdr_malloc(sizeof(sdr_pvt_obs_t) *
+        SDR_MAX_NCH);
+    pvt->slot_f = (sdr_pvt_obs_t *)sdr_malloc(sizeof(sdr_pvt_obs_t) *
+        SDR_MAX_NCH);
+    pvt->obs_f = (obs_t *)sdr_malloc(sizeof(obs_t));
+    pvt->obs_f->data = (obsd_t *)sdr_malloc(sizeof(obsd_t) * MAXSAT);
+    pvt->obs_f->nmax = MAXSAT;
+    pvt->sol_f = (sol_t *)sdr_malloc(sizeof(sol_t));
+    pvt->navq = (sdr_pvt_nav_t *)sdr_malloc(sizeof(sdr_pvt_nav_t) * NAVQ_SIZE);
+    pvt->sats = (sdr_pvt_sat_t *)sdr_malloc(sizeof(sdr_pvt_sat_t) * MAXSAT);
+    pvt->opt = (prcopt_t *)sdr_malloc(sizeof(prcopt_t));
+    *pvt->opt = prcopt_default;
+    pvt->opt->navsys |= SYS_GLO | SYS_GAL | SYS_QZS | SYS_CMP | SYS_IRN;
+    pvt->opt->err[1] = pvt->opt->err[2] = 0.03;
+    pvt->opt->ionoopt = IONOOPT_BRDC;
+    pvt->opt->tropopt = TROPOPT_SAAS;
     pvt->rtcm = (rtcm_t *)sdr_malloc(sizeof(rtcm_t));
     init_rtcm(pvt->rtcm);
     pvt->rcv = rcv;
     pthread_mutex_init(&pvt->mtx, NULL);
+    pthread_cond_init(&pvt->cond, NULL);
     readnav(FILE_NAV, pvt->nav); // load navigation data
+    if (*sdr_state_file) {
+        sdr_pvt_load_state(pvt, sdr_state_file);
+    }
+    if (rcv->seed) {
+        sdr_pvt_load_seed(pvt, rcv->seed);
+    }
     return pvt;
 }
 
 //------------------------------------------------------------------------------
-//  Free a SDR PVT.
+//  Free a SDR PVT. The PVT thread is stopped if it was started.
 //
 //  args:
 //      pvt      (I)  SDR PVT generated by sdr_pvt_new()
@@ -247,7 +575,15 @@ sdr_pvt_t *sdr_pvt_new(sdr_rcv_t *rcv)
 void sdr_pvt_free(sdr_pvt_t *pvt)
 {
     if (!pvt) return;
+    if (pvt->state) {
+        __atomic_store_n(&pvt->state, 0, __ATOMIC_RELEASE);
+        pthread_cond_signal(&pvt->cond);
+        pthread_join(pvt->thread, NULL);
+    }
     savenav(FILE_NAV, pvt->nav); // save navigation data
+    if (*sdr_state_file) {
+        sdr_pvt_save_state(pvt, sdr_state_file);
+    }
     sdr_free(pvt->obs->data);
     sdr_free(pvt->obs);
     sdr_free(pvt->nav->eph);
@@ -255,6 +591,15 @@ void sdr_pvt_free(sdr_pvt_t *pvt)
     sdr_free(pvt->nav);
     sdr_free(pvt->sol);
     sdr_free(pvt->ssat);
+    sdr_free(pvt->ssat_w);
+    sdr_free(pvt->slot);
+    sdr_free(pvt->slot_f);
+    sdr_free(pvt->obs_f->data);
+    sdr_free(pvt->obs_f);
+    sdr_free(pvt->sol_f);
+    sdr_free(pvt->navq);
+    sdr_free(pvt->sats);
+    sdr_free(pvt->opt);
     free_rtcm(pvt->rtcm);
     sdr_free(pvt->rtcm);
     sdr_free(pvt);
@@ -266,8 +611,9 @@ static void init_epoch(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch)
     if (!ch->week) return;
     double tow = floor(ch->tow * 1e-3 / sdr_epoch) * sdr_epoch + sdr_epoch;
     pvt->time = gpst2time(ch->week, tow);
-    pvt->ix = ix + ROUND((tow - ch->tow * 1e-3 - 0.07) / SDR_CYC);
-    pvt->ix = (pvt->ix / 20) * 20; // round by 20 ms
+    ix += ROUND((tow - ch->tow * 1e-3 - 0.07) / SDR_CYC);
+    __atomic_store_n(&pvt->ix, (ix / 20) * 20, __ATOMIC_RELEASE); // round by
+                                // 20 ms
 }
 
 // get observation data index --------------------------------------------------
@@ -282,34 +628,35 @@ static int data_idx(int sat, obsd_t *data, uint8_t code)
 }
 
 // generate pseudorange --------------------------------------------------------
-static double gen_prng(gtime_t time, const sdr_ch_t *ch)
+static double gen_prng(gtime_t time, const sdr_pvt_obs_t *slot)
 {
     int week;
     double tau = 0.0, tow = time2gpst(time, &week);
     
-    if (ch->week > 0) {
-        tau = (week - ch->week) * 86400.0 * 7 + tow - ch->tow * 1e-3 + ch->coff;
+    if (slot->week > 0) {
+        tau = (week - slot->week) * 86400.0 * 7 + tow - slot->tow * 1e-3 +
+            slot->coff;
     }
-    else if (ch->tow_v == 2) { // resolve 100 ms ambiguity (0.05 <= tau < 0.15)
-        tau = tow - ch->tow * 1e-3 + ch->coff + ch->nav->coff;
+    else if (slot->tow_v == 2) { // resolve 100 ms ambiguity
+                                 // (0.05 <= tau < 0.15)
+        tau = tow - slot->tow * 1e-3 + slot->coff + slot->coff_nav;
         tau -= floor(tau / 0.1) * 0.1;
         if (tau < 0.05) tau += 0.1;
     }
 #if 1 // for debug
-    trace(2, "%s %-5s %3d %4d %10.3f %10.3f %12.9f %12.9f\n", ch->sat, ch->sig,
-        ch->prn, ch->week, tow, ch->tow * 1e-3, ch->coff, tau);
+    char sat[16];
+    satno2id(slot->sat, sat);
+    trace(2, "%s %-5s %4d %10.3f %10.3f %12.9f %12.9f\n", sat, slot->desc->sig,
+        slot->week, tow, slot->tow * 1e-3, slot->coff, tau);
 #endif
     return CLIGHT * tau;
 }
 
-// update observation data -----------------------------------------------------
-static void update_obs(gtime_t time, obs_t *obs, sdr_ch_t *ch)
+// update observation data by observation slot ---------------------------------
+static void update_obs(gtime_t time, obs_t *obs, const sdr_pvt_obs_t *slot)
 {
-    uint8_t code = sig2code(ch->sig);
-    int i, j, sat;
-    
-    if (strstr(ch->sat, "R-") || strstr(ch->sat, "R+")) return;
-    if (!(sat = satid2no(ch->sat))) return;
+    uint8_t code = slot->desc->code;
+    int i, j, sat = slot->sat;
     
     for (i = 0; i < obs->n; i++) {
         if (sat == obs->data[i].sat) break;
@@ -321,24 +668,76 @@ static void update_obs(gtime_t time, obs_t *obs, sdr_ch_t *ch)
         obs->data[i].rcv = 1;
         obs->n++;
     }
-    double P = gen_prng(time, ch);
+    double P = gen_prng(time, slot);
     if (P > 0.0 && (j = data_idx(sat, obs->data + i, code)) >= 0) {
         obs->data[i].code[j] = code;
         obs->data[i].P[j] = P;
-        obs->data[i].L[j] = -ch->adr + (ch->nav->rev ? 0.5 : 0.0);
-        obs->data[i].D[j] = ch->fd;
-        obs->data[i].SNR[j] = (uint16_t)(ch->cn0 / SNR_UNIT + 0.5);
-        if (ch->lock * ch->T <= 2.0 || fabs(ch->trk->err_phas) > 0.2) {
-            obs->data[i].LLI[j] |= 1; // PLL unlock
-        }
-        if (ch->nav->fsync <= 0 && ch->trk->sec_sync <= 0) {
-            obs->data[i].LLI[j] |= 2; // half-cyc-amb unresolved
-        }
+        obs->data[i].L[j] = slot->L;
+        obs->data[i].D[j] = slot->D;
+        obs->data[i].SNR[j] = (uint16_t)(slot->cn0 / SNR_UNIT + 0.5);
+        obs->data[i].LLI[j] |= slot->LLI;
     }
 }
 
+// set observation slot by channel ---------------------------------------------
+static void set_slot(sdr_pvt_obs_t *slot, sdr_ch_t *ch)
+{
+    slot->stat = 0;
+    
+    if (ch->state != SDR_STATE_LOCK || ch->tow < 0 || ch->tow_v <= 0 ||
+        (ch->nav->fsync <= 0 && ch->trk->sec_sync <= 0) || ch->coast ||
+        ch->coast_v) {
+        return;
+    }
+    if (strstr(ch->sat, "R-") || strstr(ch->sat, "R+")) return;
+    if (!(slot->sat = satid2no(ch->sat))) return;
+    
+    slot->desc = ch->desc;
+    slot->week = ch->week;
+    slot->tow = ch->tow;
+    slot->tow_v = ch->tow_v;
+    slot->coff = SDR_CH_COFF(ch);
+    slot->coff_nav = ch->nav->coff;
+    slot->L = -SDR_CH_ADR(ch) + (ch->nav->rev ? 0.5 : 0.0);
+    slot->D = SDR_CH_FD(ch);
+    slot->fc = ch->fc;
+    slot->cn0 = SDR_CH_CN0(ch);
+    slot->LLI = 0;
+    if (ch->lock * ch->T <= 2.0 || fabs(ch->blk->err_phas[ch->ib]) > 0.2 ||
+        (ch->t_rec > 0.0 && ch->time - ch->t_rec <= 2.0)) {
+        slot->LLI |= 1; // PLL unlock
+    }
+    if (ch->nav->fsync <= 0 && ch->trk->sec_sync <= 0) {
+        slot->LLI |= 2; // half-cyc-amb unresolved
+    }
+    slot->stat = 1;
+}
+
+// write observation slot by channel (seqlock by cycle) ------------------------
+static void write_slot(sdr_pvt_obs_t *slot, int64_t ix, sdr_ch_t *ch)
+{
+    __atomic_store_n(&slot->ix, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    set_slot(slot, ch);
+    __atomic_store_n(&slot->ix, ix, __ATOMIC_RELEASE);
+}
+
+// read observation slot written by write_slot() -------------------------------
+static int read_slot(const sdr_pvt_obs_t *p, sdr_pvt_obs_t *slot)
+{
+    int64_t ix = __atomic_load_n(&p->ix, __ATOMIC_ACQUIRE);
+    if (ix <= 0) return 0;
+    *slot = *p;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&p->ix, __ATOMIC_RELAXED) == ix;
+}
+
 //------------------------------------------------------------------------------
-//  Update observation data.
+//  Update observation data. The observation data of the channel at the epoch
+//  is written to the observation slot of the channel without lock. The slot is
+//  collected by the PVT epoch update. In the fast-rate mode, the observation
+//  data of the channel at every update is also written to the latest
+//  observation slot of the channel for the fast-rate epoch update.
 //
 //  args:
 //      pvt      (IO) SDR PVT
@@ -350,23 +749,27 @@ static void update_obs(gtime_t time, obs_t *obs, sdr_ch_t *ch)
 //
 void sdr_pvt_udobs(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch)
 {
-    pthread_mutex_lock(&pvt->mtx);
+    int64_t ix_ep = __atomic_load_n(&pvt->ix, __ATOMIC_ACQUIRE);
     
-    if (pvt->ix <= 0) { // initialize epoch time and cycle
-        init_epoch(pvt, ix, ch);
-    }
-    if (ix == pvt->ix) { // update observation data
-        if (ch->state == SDR_STATE_LOCK && ch->tow >= 0 && ch->tow_v > 0 &&
-            (ch->nav->fsync > 0 || ch->trk->sec_sync > 0)) {
-            update_obs(pvt->time, pvt->obs, ch);
+    if (ix_ep <= 0) { // initialize epoch time and cycle
+        pthread_mutex_lock(&pvt->mtx);
+        if (pvt->ix <= 0) {
+            init_epoch(pvt, ix, ch);
         }
-        pvt->nch++;
+        pthread_mutex_unlock(&pvt->mtx);
+        ix_ep = __atomic_load_n(&pvt->ix, __ATOMIC_ACQUIRE);
+    }
+    if (sdr_t_fast > 0.0) {
+        write_slot(pvt->slot_f + ch->no - 1, ix, ch);
+    }
+    if (ix == ix_ep) {
+        write_slot(pvt->slot + ch->no - 1, ix, ch);
     }
-    pthread_mutex_unlock(&pvt->mtx);
 }
 
 //------------------------------------------------------------------------------
-//  Update navigation data.
+//  Update navigation data. The navigation data of the channel is queued to the
+//  navigation data message queue and is decoded by the PVT epoch update.
 //
 //  args:
 //      pvt      (IO) SDR PVT
@@ -377,79 +780,158 @@ void sdr_pvt_udobs(sdr_pvt_t *pvt, int64_t ix, sdr_ch_t *ch)
 //
 void sdr_pvt_udnav(sdr_pvt_t *pvt, sdr_ch_t *ch)
 {
-    uint8_t *data = ch->nav->data;
-    int prn, sat = satid2no(ch->sat), sys = satsys(sat, &prn);
+    int sat = satid2no(ch->sat), sys = satsys(sat, NULL);
     
     if (sys == SYS_NONE || sys == SYS_SBS) return;
     
     pthread_mutex_lock(&pvt->mtx);
     
-    if (!strcmp(ch->sig, "L1CA") || !strcmp(ch->sig, "L1CB")) { // GPS/QZS LNAV
-        if (ch->nav->type == 3 &&
+    int w = (pvt->navq_w + 1) % NAVQ_SIZE;
+    if (w == pvt->navq_r) { // queue overflow
+        pthread_mutex_unlock(&pvt->mtx);
+        sdr_log(3, "$LOG,%.3f,%s,%d,NAV DATA QUEUE OVERFLOW", ch->time,
+            ch->sig, ch->prn);
+        return;
+    }
+    sdr_pvt_nav_t *msg = pvt->navq + pvt->navq_w;
+    msg->ix = (int64_t)ROUND(ch->time / SDR_CYC);
+    msg->sat = sat;
+    msg->prn = ch->prn;
+    msg->sig_id = ch->sig_id;
+    msg->type = ch->nav->type;
+    memcpy(msg->data, ch->nav->data, SDR_MAX_DATA);
+    pvt->navq_w = w;
+    pthread_mutex_unlock(&pvt->mtx);
+}
+
+// number of navigation data messages queued -----------------------------------
+int sdr_pvt_nav_queue(sdr_pvt_t *pvt)
+{
+    pthread_mutex_lock(&pvt->mtx);
+    int n = (pvt->navq_w - pvt->navq_r + NAVQ_SIZE) % NAVQ_SIZE;
+    pthread_mutex_unlock(&pvt->mtx);
+    return n;
+}
+
+// output new ephemeris and invalidate satellite position cache ----------------
+static void new_eph(sdr_pvt_t *pvt, int sat, int type, sdr_ostr_t *str)
+{
+    out_rtcm3_nav(pvt->rtcm, sat, type, pvt->nav, str);
+    pvt->sats[sat-1].stat = 0;
+    pvt->count[2]++;
+}
+
+// decode navigation data message ----------------------------------------------
+static void decode_nav(sdr_pvt_t *pvt, const sdr_pvt_nav_t *msg)
+{
+    const uint8_t *data = msg->data;
+    int prn, sat = msg->sat, id = msg->sig_id, type = msg->type;
+    sdr_ostr_t *str = out_str(pvt, msg->ix, 1);
+    
+    satsys(sat, &prn);
+    
+    if (id == SDR_SIG_L1CA || id == SDR_SIG_L1CB) { // GPS/QZS LNAV
+        if (type == 3 &&
             decode_frame(data, pvt->nav->eph + sat - 1, NULL, NULL, NULL)) {
             pvt->nav->eph[sat-1].sat = sat;
-            out_rtcm3_nav(pvt->rtcm, sat, 0, pvt->nav, pvt->rcv->strs[1]);
-            pvt->count[2]++;
+            new_eph(pvt, sat, 0, str);
         }
-        if (ch->nav->type == 4) {
+        if (type == 4) {
             decode_frame(data, NULL, NULL, pvt->nav->ion_gps, NULL);
         }
     }
-    else if (!strcmp(ch->sig, "G1CA") || !strcmp(ch->sig, "G2CA")) { // GLO NAV
+    else if (id == SDR_SIG_G1CA || id == SDR_SIG_G2CA) { // GLO NAV
         pvt->nav->geph[prn-1].tof = pvt->time;
-        if (ch->nav->type == 3 &&
+        if (type == 3 &&
             decode_glostr(data, pvt->nav->geph + prn - 1, NULL)) {
             pvt->nav->geph[prn-1].sat = sat;
-            pvt->nav->geph[prn-1].frq = ch->prn; // FCN
-            out_rtcm3_nav(pvt->rtcm, sat, 0, pvt->nav, pvt->rcv->strs[1]);
-            pvt->count[2]++;
+            pvt->nav->geph[prn-1].frq = msg->prn; // FCN
+            new_eph(pvt, sat, 0, str);
         }
     }
-    else if (!strcmp(ch->sig, "E1B") || !strcmp(ch->sig, "E5BI")) { // GAL I/NAV
-        if (ch->nav->type == 4 &&
+    else if (id == SDR_SIG_E1B || id == SDR_SIG_E5BI) { // GAL I/NAV
+        if (type == 4 &&
             decode_gal_inav(data, pvt->nav->eph + sat - 1, NULL, NULL)) {
             pvt->nav->eph[sat-1].sat = sat;
-            out_rtcm3_nav(pvt->rtcm, sat, 0, pvt->nav, pvt->rcv->strs[1]);
-            pvt->count[2]++;
+            new_eph(pvt, sat, 0, str);
         }
     }
-    else if (!strcmp(ch->sig, "E5AI")) { // GAL F/NAV
-        if (ch->nav->type == 4 &&
+    else if (id == SDR_SIG_E5AI) { // GAL F/NAV
+        if (type == 4 &&
             decode_gal_fnav(data, pvt->nav->eph + MAXSAT + sat - 1, NULL,
                 NULL)) {
             pvt->nav->eph[MAXSAT+sat-1].sat = sat;
-            out_rtcm3_nav(pvt->rtcm, sat, 1, pvt->nav, pvt->rcv->strs[1]);
-            pvt->count[2]++;
+            new_eph(pvt, sat, 1, str);
         }
     }
-    else if (!strcmp(ch->sig, "B1I") || !strcmp(ch->sig, "B2I") ||
-             !strcmp(ch->sig, "B3I")) {
-        if (ch->prn >= 6 && ch->prn <= 58) { // BDS D1 NAV
-            if (ch->nav->type == 5 &&
+    else if (id == SDR_SIG_B1I || id == SDR_SIG_B2I ||
+             id == SDR_SIG_B3I) {
+        if (msg->prn >= 6 && msg->prn <= 58) { // BDS D1 NAV
+            if (type == 5 &&
                 decode_bds_d1(data, pvt->nav->eph + sat - 1, NULL, NULL)) {
                 pvt->nav->eph[sat-1].sat = sat;
-                out_rtcm3_nav(pvt->rtcm, sat, 0, pvt->nav, pvt->rcv->strs[1]);
-                pvt->count[2]++;
+                new_eph(pvt, sat, 0, str);
             }
         }
         else { // BDS D2 NAV
-            if (ch->nav->type == 10 &&
+            if (type == 10 &&
                 decode_bds_d2(data, pvt->nav->eph + sat - 1, NULL)) {
                 pvt->nav->eph[sat-1].sat = sat;
-                out_rtcm3_nav(pvt->rtcm, sat, 0, pvt->nav, pvt->rcv->strs[1]);
-                pvt->count[2]++;
+                new_eph(pvt, sat, 0, str);
             }
         }
     }
-    else if (!strcmp(ch->sig, "I5S") || !strcmp(ch->sig, "ISS")) { // NavIC NAV
-        if (ch->nav->type == 2 &&
+    else if (id == SDR_SIG_I5S || id == SDR_SIG_ISS) { // NavIC NAV
+        if (type == 2 &&
             decode_irn_nav(data, pvt->nav->eph + sat - 1, NULL, NULL)) {
             pvt->nav->eph[sat-1].sat = sat;
-            out_rtcm3_nav(pvt->rtcm, sat, 0, pvt->nav, pvt->rcv->strs[1]);
-            pvt->count[2]++;
+            new_eph(pvt, sat, 0, str);
+        }
+    }
+}
+
+// decode queued navigation data messages --------------------------------------
+//  The message at the read index is not overwritten until the index advances,
+//  so it is decoded without lock.
+static void update_nav(sdr_pvt_t *pvt)
+{
+    while (1) {
+        pthread_mutex_lock(&pvt->mtx);
+        int r = pvt->navq_r, w = pvt->navq_w;
+        pthread_mutex_unlock(&pvt->mtx);
+        if (r == w) break;
+        
+        decode_nav(pvt, pvt->navq + r);
+        
+        pthread_mutex_lock(&pvt->mtx);
+        pvt->navq_r = (r + 1) % NAVQ_SIZE;
+        pthread_mutex_unlock(&pvt->mtx);
+    }
+}
+
+// number of observation slots updated at epoch --------------------------------
+static int num_slot(const sdr_pvt_t *pvt, int64_t ix)
+{
+    int n = 0;
+    
+    for (int i = 0; i < pvt->rcv->nch; i++) {
+        n += __atomic_load_n(&pvt->slot[i].ix, __ATOMIC_ACQUIRE) == ix;
+    }
+    return n;
+}
+
+// collect observation data from observation slots at epoch --------------------
+static void collect_obs(sdr_pvt_t *pvt, int64_t ix)
+{
+    pvt->obs->n = 0;
+    
+    for (int i = 0; i < pvt->rcv->nch; i++) {
+        sdr_pvt_obs_t slot;
+        if (!read_slot(pvt->slot + i, &slot) || slot.ix != ix) continue;
+        if (slot.stat) {
+            update_obs(pvt->time, pvt->obs, &slot);
         }
     }
-    pthread_mutex_unlock(&pvt->mtx);
 }
 
 // correct solution time -------------------------------------------------------
@@ -466,38 +948,501 @@ static void corr_sol_time(sol_t *sol)
     }
 }
 
+// fit satellite position and clock by Chebyshev polynomials -------------------
+//  The satellite positions and clocks are computed by the broadcast ephemeris
+//  selected at the center of the fit span at the Chebyshev nodes.
+static void fit_sat(const nav_t *nav, int sat, gtime_t time, sdr_pvt_sat_t *s)
+{
+    double rs[6], dts[2], f[4][SDR_N_CHEB];
+    int N = SDR_N_CHEB;
+    
+    s->t0 = timeadd(time, -SPAN_EPH * 0.1);
+    s->stat = -1;
+    gtime_t teph = timeadd(s->t0, SPAN_EPH * 0.5);
+    
+    for (int k = 0; k < N; k++) {
+        double x = cos(PI * (k + 0.5) / N);
+        gtime_t t = timeadd(s->t0, (x + 1.0) * 0.5 * SPAN_EPH);
+        if (!satpos(t, teph, sat, EPHOPT_BRDC, nav, rs, dts, &s->var,
+                &s->svh) || norm(rs, 3) < 1e-3) {
+            return;
+        }
+        for (int i = 0; i < 3; i++) {
+            f[i][k] = rs[i];
+        }
+        f[3][k] = dts[0];
+    }
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < N; j++) {
+            double c = 0.0;
+            for (int k = 0; k < N; k++) {
+                c += f[i][k] * cos(PI * j * (k + 0.5) / N);
+            }
+            s->c[i][j] = c * (j == 0 ? 1.0 : 2.0) / N;
+        }
+    }
+    s->stat = 1;
+}
+
+// evaluate satellite position, velocity and clock by Chebyshev polynomials ----
+static void eval_sat(const sdr_pvt_sat_t *s, double dt, double *rs,
+    double *dts)
+{
+    double x = dt * 2.0 / SPAN_EPH - 1.0, T[SDR_N_CHEB], dT[SDR_N_CHEB];
+    
+    T[0] = 1.0;
+    T[1] = x;
+    dT[0] = 0.0;
+    dT[1] = 1.0;
+    for (int j = 2; j < SDR_N_CHEB; j++) {
+        T[j] = 2.0 * x * T[j-1] - T[j-2];
+        dT[j] = 2.0 * T[j-1] + 2.0 * x * dT[j-1] - dT[j-2];
+    }
+    for (int i = 0; i < 4; i++) {
+        double f = 0.0, df = 0.0;
+        for (int j = 0; j < SDR_N_CHEB; j++) {
+            f += s->c[i][j] * T[j];
+            df += s->c[i][j] * dT[j];
+        }
+        df *= 2.0 / SPAN_EPH;
+        if (i < 3) {
+            rs[i] = f;
+            rs[3+i] = df;
+        }
+        else {
+            dts[0] = f;
+            dts[1] = df;
+        }
+    }
+}
+
+// satellite position, velocity and clock by satellite position cache ----------
+//  The cache of the satellite is fitted again if the time is out of the fit
+//  span. If the fit failed, the broadcast ephemeris is used directly.
+static int sat_pos(sdr_pvt_t *pvt, int sat, gtime_t time, double *rs,
+    double *dts, double *var, int *svh)
+{
+    sdr_pvt_sat_t *s = pvt->sats + sat - 1;
+    double dt = timediff(time, s->t0);
+    
+    if (s->stat == 0 || dt < 0.0 || dt > SPAN_EPH) {
+        fit_sat(pvt->nav, sat, time, s);
+        dt = timediff(time, s->t0);
+    }
+    if (s->stat < 0) {
+        return satpos(time, time, sat, EPHOPT_BRDC, pvt->nav, rs, dts, var,
+            svh) && norm(rs, 3) >= 1e-3;
+    }
+    eval_sat(s, dt, rs, dts);
+    *var = s->var;
+    *svh = s->svh;
+    return 1;
+}
+
+// satellite positions, velocities and clocks at transmission time -------------
+static void sat_poss(sdr_pvt_t *pvt, const obsd_t *obs, int n, double *rs,
+    double *dts, double *var, int *svh)
+{
+    for (int i = 0; i < n; i++) {
+        double pr = 0.0;
+        for (int j = 0; j < 6; j++) rs[j+i*6] = 0.0;
+        dts[i*2] = dts[1+i*2] = var[i] = 0.0;
+        svh[i] = 0;
+        for (int j = 0; j < NFREQ && pr == 0.0; j++) {
+            pr = obs[i].P[j];
+        }
+        if (pr == 0.0) continue;
+        
+        // correct transmission time by satellite clock
+        gtime_t time = timeadd(obs[i].time, -pr / CLIGHT);
+        if (!sat_pos(pvt, obs[i].sat, time, rs + i * 6, dts + i * 2, var + i,
+                svh + i)) {
+            continue;
+        }
+        time = timeadd(time, -dts[i*2]);
+        if (!sat_pos(pvt, obs[i].sat, time, rs + i * 6, dts + i * 2, var + i,
+                svh + i)) {
+            dts[i*2] = 0.0;
+            for (int j = 0; j < 6; j++) rs[j+i*6] = 0.0;
+        }
+    }
+}
+
+// L1 pseudorange with code bias and group delay correction --------------------
+static double corr_prng(const obsd_t *obs, const nav_t *nav, double *var)
+{
+    const eph_t *eph = nav->eph + obs->sat - 1;
+    double P = obs->P[0], gamma;
+    int prn, sat = obs->sat, sys = satsys(sat, &prn);
+    
+    *var = 0.0;
+    if (P == 0.0) return 0.0;
+    *var = SQR(ERR_CBIAS);
+    if ((sys == SYS_GPS || sys == SYS_GLO) && obs->code[0] == CODE_L1C) {
+        P += nav->cbias[sat-1][1]; // C1->P1
+    }
+    if (sys == SYS_GPS || sys == SYS_QZS) { // L1
+        return P - eph->tgd[0] * CLIGHT;
+    }
+    else if (sys == SYS_GLO) { // G1
+        gamma = SQR(FREQ1_GLO / FREQ2_GLO);
+        return P + nav->geph[prn-1].dtaun * CLIGHT / (gamma - 1.0);
+    }
+    else if (sys == SYS_GAL) { // E1 (BGD_E1E5b, or BGD_E1E5a for F/NAV only)
+        if (eph->sat != sat) eph = nav->eph + MAXSAT + sat - 1;
+        return P - eph->tgd[1] * CLIGHT;
+    }
+    else if (sys == SYS_CMP) { // B1I, B1Cp or B1Cd
+        if      (obs->code[0] == CODE_L2I) return P - eph->tgd[0] * CLIGHT;
+        else if (obs->code[0] == CODE_L1P) return P - eph->tgd[2] * CLIGHT;
+        return P - (eph->tgd[2] + eph->tgd[4]) * CLIGHT;
+    }
+    else if (sys == SYS_IRN) { // L5
+        gamma = SQR(FREQ9 / FREQ5);
+        return P - gamma * eph->tgd[0] * CLIGHT;
+    }
+    return P;
+}
+
+// pseudorange residuals -------------------------------------------------------
+//  The corrections and the masks are applied from the first iteration if the
+//  initial receiver position is given.
+static int res_prng(int corr, const obsd_t *obs, int n, const double *rs,
+    const double *dts, const double *vare, const int *svh, const nav_t *nav,
+    const double *x, const prcopt_t *opt, double *v, double *H, double *var,
+    double *azel, int *vsat, double *resp, int *ns)
+{
+    double pos[3], e[3], r, P, freq, dion = 0.0, vion = 0.0, dtrp = 0.0;
+    double vtrp = 0.0, vmeas, fact;
+    int sys, nv = 0, mask[NX-3] = {0};
+    
+    ecef2pos(x, pos);
+    *ns = 0;
+    
+    for (int i = 0; i < n; i++) {
+        vsat[i] = 0;
+        azel[i*2] = azel[1+i*2] = resp[i] = 0.0;
+        
+        if (!(sys = satsys(obs[i].sat, NULL)) ||
+            satexclude(obs[i].sat, vare[i], svh[i], opt) ||
+            (r = geodist(rs + i * 6, x, e)) <= 0.0) {
+            continue;
+        }
+        if (corr) {
+            if (satazel(pos, e, azel + i * 2) < opt->elmin ||
+                testsnr(0, 0, azel[1+i*2], obs[i].SNR[0] * SNR_UNIT,
+                    &opt->snrmask) ||
+                !ionocorr(obs[i].time, nav, obs[i].sat, pos, azel + i * 2,
+                    opt->ionoopt, &dion, &vion) ||
+                (freq = sat2freq(obs[i].sat, obs[i].code[0], nav)) == 0.0 ||
+                !tropcorr(obs[i].time, nav, pos, azel + i * 2, opt->tropopt,
+                    &dtrp, &vtrp)) {
+                continue;
+            }
+            dion *= SQR(FREQ1 / freq);
+            vion *= SQR(FREQ1 / freq);
+        }
+        if ((P = corr_prng(obs + i, nav, &vmeas)) == 0.0) continue;
+        
+        // residual and design matrix
+        v[nv] = P - (r + x[3] - CLIGHT * dts[i*2] + dion + dtrp);
+        for (int j = 0; j < NX; j++) {
+            H[j+nv*NX] = j < 3 ? -e[j] : (j == 3 ? 1.0 : 0.0);
+        }
+        // time system offset
+        int k = sys == SYS_GLO ? 1 : (sys == SYS_GAL ? 2 : (sys == SYS_CMP ?
+            3 : (sys == SYS_IRN ? 4 : 0)));
+        if (k > 0) {
+            v[nv] -= x[3+k];
+            H[3+k+nv*NX] = 1.0;
+        }
+        mask[k] = 1;
+        vsat[i] = 1;
+        resp[i] = v[nv];
+        (*ns)++;
+        
+        // variance of pseudorange error
+        double el = MAX(azel[1+i*2], 5.0 * D2R);
+        fact = sys == SYS_GLO ? EFACT_GLO : (sys == SYS_SBS ? EFACT_SBS :
+            EFACT_GPS);
+        var[nv++] = SQR(fact * opt->err[0]) * (SQR(opt->err[1]) +
+            SQR(opt->err[2]) / sin(el)) + vare[i] + vmeas + vion + vtrp;
+    }
+    // constraints of time system offsets without satellite
+    for (int i = 0; i < NX - 3; i++) {
+        if (mask[i]) continue;
+        v[nv] = -x[3+i];
+        for (int j = 0; j < NX; j++) {
+            H[j+nv*NX] = j == i + 3 ? 1.0 : 0.0;
+        }
+        var[nv++] = 0.01;
+    }
+    return nv;
+}
+
+// validate solution by chi-square test of residuals and GDOP ------------------
+static int val_sol(const double *azel, const int *vsat, int n,
+    const prcopt_t *opt, const double *v, int nv, char *msg)
+{
+    double azels[MAXOBS*2], dop[4], vv = dot(v, v, nv);
+    int ns = 0;
+    
+    if (nv > NX && vv > chisqr[nv-NX-1]) {
+        sprintf(msg, "chi-square error nv=%d vv=%.1f cs=%.1f", nv, vv,
+            chisqr[nv-NX-1]);
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!vsat[i]) continue;
+        azels[ns*2] = azel[i*2];
+        azels[1+ns*2] = azel[1+i*2];
+        ns++;
+    }
+    dops(ns, azels, opt->elmin, dop);
+    if (dop[0] <= 0.0 || dop[0] > opt->maxgdop) {
+        sprintf(msg, "gdop error nv=%d gdop=%.1f", nv, dop[0]);
+        return 0;
+    }
+    return 1;
+}
+
+// update receiver position by least squares of pseudorange residuals ----------
+static int upd_pos(int corr, const obsd_t *obs, int n, const double *rs,
+    const double *dts, const double *vare, const int *svh, const nav_t *nav,
+    const prcopt_t *opt, double *x, double *dx, double *Q, double *v,
+    double *azel, int *vsat, double *resp, int *ns, char *msg)
+{
+    double H[NX*(MAXOBS+NX)], var[MAXOBS+NX];
+    
+    int nv = res_prng(corr, obs, n, rs, dts, vare, svh, nav, x, opt, v, H, var,
+        azel, vsat, resp, ns);
+    if (nv < NX) {
+        sprintf(msg, "lack of valid sats ns=%d", nv);
+        return 0;
+    }
+    for (int j = 0; j < nv; j++) {
+        double sig = sqrt(var[j]);
+        v[j] /= sig;
+        for (int k = 0; k < NX; k++) H[k+j*NX] /= sig;
+    }
+    int info = lsq(H, v, NX, nv, dx, Q);
+    if (info) {
+        sprintf(msg, "lsq error info=%d", info);
+        return 0;
+    }
+    for (int j = 0; j < NX; j++) {
+        x[j] += dx[j];
+    }
+    return nv;
+}
+
+// set receiver position, clock bias and time offsets to solution --------------
+static void set_pos(gtime_t time, const double *x, const double *Q, int ns,
+    sol_t *sol)
+{
+    sol->type = 0;
+    sol->time = timeadd(time, -x[3] / CLIGHT);
+    for (int j = 0; j < 5; j++) {
+        sol->dtr[j] = x[3+j] / CLIGHT; // receiver clock bias and GLO, GAL, BDS
+                                       // and IRN time offsets (s)
+    }
+    for (int j = 0; j < 6; j++) {
+        sol->rr[j] = j < 3 ? x[j] : 0.0;
+    }
+    for (int j = 0; j < 3; j++) {
+        sol->qr[j] = (float)Q[j+j*NX];
+    }
+    sol->qr[3] = (float)Q[1];    // cov xy
+    sol->qr[4] = (float)Q[2+NX]; // cov yz
+    sol->qr[5] = (float)Q[2];    // cov zx
+    sol->ns = (uint8_t)ns;
+    sol->age = sol->ratio = 0.0;
+}
+
+// estimate receiver position by pseudoranges ----------------------------------
+//  The least squares are warm-started by the receiver position of the previous
+//  solution.
+static int est_pos(const obsd_t *obs, int n, const double *rs,
+    const double *dts, const double *vare, const int *svh, const nav_t *nav,
+    const prcopt_t *opt, sol_t *sol, double *azel, int *vsat, double *resp,
+    char *msg)
+{
+    double x[NX] = {0}, dx[NX], Q[NX*NX], v[MAXOBS+NX];
+    int ns, warm = norm(sol->rr, 3) > 0.0;
+    
+    for (int i = 0; i < 3; i++) {
+        x[i] = sol->rr[i];
+    }
+    for (int i = 0; i < MAX_ITR; i++) {
+        int nv = upd_pos(warm || i > 0, obs, n, rs, dts, vare, svh, nav, opt,
+            x, dx, Q, v, azel, vsat, resp, &ns, msg);
+        if (!nv) return 0;
+        if (norm(dx, NX) >= 1e-4) continue;
+        
+        set_pos(obs[0].time, x, Q, ns, sol);
+        if (!val_sol(azel, vsat, n, opt, v, nv, msg)) return 0;
+        sol->stat = SOLQ_SINGLE;
+        return 1;
+    }
+    sprintf(msg, "iteration divergent i=%d", MAX_ITR);
+    return 0;
+}
+
+// estimate receiver velocity by Doppler ---------------------------------------
+static void est_vel(const obsd_t *obs, int n, const double *rs,
+    const double *dts, const nav_t *nav, const prcopt_t *opt, sol_t *sol,
+    const double *azel, const int *vsat)
+{
+    double x[4] = {0}, dx[4], Q[16], v[MAXOBS], H[4*MAXOBS], pos[3], E[9];
+    double a[3], e[3], vs[3], err = opt->err[4];
+    
+    ecef2pos(sol->rr, pos);
+    xyz2enu(pos, E);
+    
+    for (int i = 0; i < MAX_ITR; i++) {
+        int nv = 0;
+        
+        // range rate residuals and design matrix
+        for (int j = 0; j < n; j++) {
+            const double *r = rs + j * 6;
+            double freq = sat2freq(obs[j].sat, obs[j].code[0], nav);
+            if (obs[j].D[0] == 0.0 || freq == 0.0 || !vsat[j] ||
+                norm(r + 3, 3) <= 0.0) {
+                continue;
+            }
+            double cosel = cos(azel[1+j*2]);
+            a[0] = sin(azel[j*2]) * cosel;
+            a[1] = cos(azel[j*2]) * cosel;
+            a[2] = sin(azel[1+j*2]);
+            matmul("TN", 3, 1, 3, 1.0, E, a, 0.0, e);
+            for (int k = 0; k < 3; k++) {
+                vs[k] = r[3+k] - x[k];
+            }
+            double rate = dot(vs, e, 3) + OMGE / CLIGHT * (r[4] * sol->rr[0] +
+                r[1] * x[0] - r[3] * sol->rr[1] - r[0] * x[1]);
+            double sig = err <= 0.0 ? 1.0 : err * CLIGHT / freq;
+            v[nv] = (-obs[j].D[0] * CLIGHT / freq - (rate + x[3] -
+                CLIGHT * dts[1+j*2])) / sig;
+            for (int k = 0; k < 4; k++) {
+                H[k+nv*4] = (k < 3 ? -e[k] : 1.0) / sig;
+            }
+            nv++;
+        }
+        if (nv < 4 || lsq(H, v, 4, nv, dx, Q)) break;
+        for (int j = 0; j < 4; j++) {
+            x[j] += dx[j];
+        }
+        if (norm(dx, 4) < 1e-6) {
+            matcpy(sol->rr + 3, x, 3, 1);
+            sol->qv[0] = (float)Q[0];  // xx
+            sol->qv[1] = (float)Q[5];  // yy
+            sol->qv[2] = (float)Q[10]; // zz
+            sol->qv[3] = (float)Q[1];  // xy
+            sol->qv[4] = (float)Q[6];  // yz
+            sol->qv[5] = (float)Q[2];  // zx
+            break;
+        }
+    }
+}
+
+// point positioning -----------------------------------------------------------
+//  The point positioning is the same as RTKLIB pntpos() without RAIM-FDE
+//  except that the satellite positions are evaluated by the satellite
+//  position cache and the estimation is warm-started by the previous solution.
+static int pnt_pos(sdr_pvt_t *pvt, sol_t *sol, ssat_t *ssat, char *msg)
+{
+    const obsd_t *obs = pvt->obs->data;
+    double rs[6*MAXOBS], dts[2*MAXOBS], var[MAXOBS], azel[2*MAXOBS] = {0};
+    double resp[MAXOBS] = {0};
+    int n = MIN(pvt->obs->n, MAXOBS), svh[MAXOBS], vsat[MAXOBS] = {0}, stat;
+    
+    sol->stat = SOLQ_NONE;
+    if (n <= 0) {
+        strcpy(msg, "no observation data");
+        return 0;
+    }
+    sol->time = obs[0].time;
+    
+    // satellite positions, velocities and clocks
+    sat_poss(pvt, obs, n, rs, dts, var, svh);
+    
+    // estimate receiver position and velocity
+    stat = est_pos(obs, n, rs, dts, var, svh, pvt->nav, pvt->opt, sol, azel,
+        vsat, resp, msg);
+    if (stat) {
+        est_vel(obs, n, rs, dts, pvt->nav, pvt->opt, sol, azel, vsat);
+    }
+    // satellite status
+    for (int i = 0; i < MAXSAT; i++) {
+        ssat[i].vs = 0;
+        ssat[i].azel[0] = ssat[i].azel[1] = 0.0;
+        ssat[i].resp[0] = ssat[i].resc[0] = 0.0;
+        ssat[i].snr[0] = 0;
+    }
+    for (int i = 0; i < n; i++) {
+        ssat_t *s = ssat + obs[i].sat - 1;
+        s->azel[0] = azel[i*2];
+        s->azel[1] = azel[1+i*2];
+        s->snr[0] = obs[i].SNR[0];
+        if (!vsat[i]) continue;
+        s->vs = 1;
+        s->resp[0] = resp[i];
+    }
+    return stat;
+}
+
+// update satellite status snapshot -------------------------------------------
+//  The snapshot of satellites above horizon is written by the PVT epoch update
+//  and read without lock.
+static void update_sat_stat(sdr_pvt_t *pvt)
+{
+    sdr_pvt_sat_stat_t *stat = &pvt->sat_stat;
+    int n = 0;
+    
+    sdr_seq_begin(&stat->seq);
+    for (int i = 0; i < MAXSAT; i++) {
+        const ssat_t *ssat = pvt->ssat_w + i;
+        if (ssat->azel[1] <= 0.0) continue;
+        stat->sat[n] = i + 1;
+        stat->az[n] = (float)(ssat->azel[0] * R2D);
+        stat->el[n] = (float)(ssat->azel[1] * R2D);
+        stat->vs[n++] = ssat->vs;
+    }
+    stat->n = n;
+    sdr_seq_end(&stat->seq);
+}
+
 // update PVT solution ---------------------------------------------------------
+//  The point positioning is done on the copy of the solution and the satellite
+//  status, which are published under lock.
 static void update_sol(sdr_pvt_t *pvt)
 {
-    prcopt_t opt = prcopt_default;
-    opt.navsys |= SYS_GLO | SYS_GAL | SYS_QZS | SYS_CMP | SYS_IRN;
-    opt.err[1] = opt.err[2] = 0.03;
-    opt.ionoopt = IONOOPT_BRDC;
-    opt.tropopt = TROPOPT_SAAS;
-    opt.elmin = sdr_el_mask * D2R;
-#if 0 // RAIM-FDE on
-    opt.posopt[4] = 1;
-#endif
     double time = pvt->ix * SDR_CYC;
     char msg[128] = "";
+    sol_t sol = *pvt->sol;
     
     // point positioning with L1 pseudorange
-    if (pntpos(pvt->obs->data, pvt->obs->n, pvt->nav, &opt, pvt->sol, NULL,
-             pvt->ssat, msg)) {
+    pvt->opt->elmin = sdr_el_mask * D2R;
+    if (pnt_pos(pvt, &sol, pvt->ssat_w, msg)) {
         
         // correct solution time
-        corr_sol_time(pvt->sol);
+        corr_sol_time(&sol);
         
         // output log $POS and NMEA RMC, GGA, GSA and GSV
-        out_log_pos(time, pvt->sol, pvt->obs->n);
-        out_nmea(pvt->sol, pvt->ssat, pvt->rcv->strs[0]);
+        out_log_pos(time, &sol, pvt->obs->n);
+        out_nmea(&sol, pvt->ssat_w, out_str(pvt, pvt->ix, 0));
         pvt->count[0]++;
     }
     else {
-        pvt->sol->ns = 0;
+        sol.ns = 0;
         sdr_log(3, "$LOG,%.3f,PNTPOS ERROR,%s", time, msg);
     }
+    pthread_mutex_lock(&pvt->mtx);
+    *pvt->sol = sol;
+    memcpy(pvt->ssat, pvt->ssat_w, sizeof(ssat_t) * MAXSAT);
     pvt->nsat = pvt->obs->n;
+    pthread_mutex_unlock(&pvt->mtx);
+    update_sat_stat(pvt);
     
 #if 1 // for debug
     double pos[3];
@@ -518,6 +1463,97 @@ static void update_sol(sdr_pvt_t *pvt)
 #endif
 }
 
+// range rate of satellite -----------------------------------------------------
+static double range_rate(const double *rs, const double *rr, double *e)
+{
+    double vs[3];
+    
+    geodist(rs, rr, e);
+    for (int i = 0; i < 3; i++) {
+        vs[i] = rs[3+i] - rr[3+i];
+    }
+    return dot(vs, e, 3);
+}
+
+// predict satellite range rate, range acceleration and elevation -------------
+//  The range acceleration is the difference of the range rates 1 s apart with
+//  the receiver velocity kept.
+static int pred_sat(sdr_pvt_t *pvt, int sat, gtime_t time, double *rate,
+    double *acc)
+{
+    double rs[6], dts[2], var, e[3], pos[3], azel[2], rr[6];
+    int svh = 0;
+    
+    if (!sat_pos(pvt, sat, time, rs, dts, &var, &svh)) {
+        return 0; // no ephemeris
+    }
+    if (satsys(sat, NULL) == SYS_QZS) svh &= 0xFE; // L6 mask
+    if (svh) return 2;
+    *rate = range_rate(rs, pvt->sol->rr, e);
+    ecef2pos(pvt->sol->rr, pos);
+    satazel(pos, e, azel);
+    
+    for (int i = 0; i < 3; i++) {
+        rr[i] = pvt->sol->rr[i] + pvt->sol->rr[3+i];
+        rr[3+i] = pvt->sol->rr[3+i];
+    }
+    *acc = sat_pos(pvt, sat, timeadd(time, 1.0), rs, dts, &var, &svh) ?
+        range_rate(rs, rr, e) - *rate : 0.0;
+    return azel[1] < sdr_el_mask * D2R ? 2 : 1;
+}
+
+// update satellite prediction of receiver channels ----------------------------
+//  The receiver clock drift is estimated by the Doppler residuals of the
+//  locked channels. In warm-start, the clock drift and the range rates of the
+//  satellites w/o ephemeris are substituted by the warm-start state.
+static void update_pred(sdr_pvt_t *pvt, gtime_t time, int64_t ix)
+{
+    double rate[MAXSAT], acc[MAXSAT];
+    double drift = 0.0;
+    uint8_t pred[MAXSAT] = {0};
+    int n = 0;
+    
+    for (int i = 0; i < pvt->rcv->nch; i++) {
+        int sat = satid2no(pvt->rcv->th[i]->ch->sat);
+        if (sat <= 0 || pred[sat-1]) continue;
+        pred[sat-1] = pred_sat(pvt, sat, time, rate + sat - 1, acc + sat - 1);
+    }
+    for (int i = 0; i < pvt->rcv->nch; i++) {
+        sdr_ch_t *ch = pvt->rcv->th[i]->ch;
+        int sat = satid2no(ch->sat);
+        if (sat <= 0 || pred[sat-1] != 1 ||
+            ch->state != SDR_STATE_LOCK || ch->lock * ch->T < MIN_LOCK_PRED) {
+            continue;
+        }
+        drift += -SDR_CH_FD(ch) * CLIGHT / ch->fc - rate[sat-1];
+        n++;
+    }
+    if (n > 0) {
+        pvt->drift = drift / n;
+    }
+    if (pvt->ix_warm > 0) { // warm-start
+        for (int i = 0; i < MAXSAT; i++) {
+            if (pred[i] || pvt->rate_warm[i] == 0.0f) continue;
+            pred[i] = 1;
+            rate[i] = pvt->rate_warm[i] - pvt->drift;
+            acc[i] = 0.0;
+        }
+    }
+    pthread_mutex_lock(&pvt->mtx);
+    memcpy(pvt->pred, pred, sizeof(pred));
+    if (n == 0 && pvt->ix_warm <= 0) { // no clock drift estimation
+        pvt->ix_pred = 0;
+    }
+    else {
+        for (int i = 0; i < MAXSAT; i++) {
+            pvt->pred_rate[i] = pred[i] == 1 ? rate[i] + pvt->drift : 0.0f;
+            pvt->pred_acc[i] = pred[i] == 1 ? acc[i] : 0.0f;
+        }
+        pvt->ix_pred = ix;
+    }
+    pthread_mutex_unlock(&pvt->mtx);
+}
+
 // resolve msec ambiguity in pseudorange ---------------------------------------
 static void res_obs_amb(obs_t *obs, int sys, uint8_t code, double sec)
 {
@@ -547,8 +1583,329 @@ static void res_obs_amb(obs_t *obs, int sys, uint8_t code, double sec)
     }
 }
 
+// resolve msec ambiguities in pseudoranges ------------------------------------
+static void res_amb(obs_t *obs)
+{
+    res_obs_amb(obs, SYS_GPS | SYS_QZS, CODE_L5Q, 20e-3); // L5Q
+    res_obs_amb(obs, SYS_QZS, CODE_L5P, 20e-3); // L5SQ, L5SQV
+    res_obs_amb(obs, SYS_GLO, CODE_L3Q, 10e-3); // G3OCP
+    res_obs_amb(obs, SYS_SBS, CODE_L5Q, 2e-3);  // L5Q SBAS
+}
+
+// update PVT status snapshot --------------------------------------------------
+//  The snapshot is written by the PVT epoch update and read without lock.
+static void update_stat(sdr_pvt_t *pvt)
+{
+    sdr_pvt_stat_t *stat = &pvt->stat;
+    const sol_t *sol = pvt->sol;
+    
+    pthread_mutex_lock(&pvt->mtx);
+    gtime_t time = pvt->time;
+    pthread_mutex_unlock(&pvt->mtx);
+    
+    sdr_seq_begin(&stat->seq);
+    if (norm(sol->rr, 3) > 1e-6) {
+        ecef2pos(sol->rr, stat->pos);
+        stat->pos[0] *= R2D;
+        stat->pos[1] *= R2D;
+        stat->stat = sol->stat != SOLQ_NONE;
+        time = sol->time;
+    }
+    else {
+        stat->pos[0] = stat->pos[1] = stat->pos[2] = 0.0;
+        stat->stat = 0;
+    }
+    stat->ns = sol->ns;
+    stat->nsat = pvt->nsat;
+    stat->time = time.time + time.sec;
+    for (int i = 0; i < 6; i++) {
+        stat->rr[i] = sol->rr[i];
+    }
+    stat->dtr = sol->dtr[0];
+    stat->drift = pvt->drift;
+    for (int i = 0; i < 4; i++) {
+        stat->count[i] = pvt->count[i];
+    }
+    sdr_seq_end(&stat->seq);
+}
+
+// set warm-start seed for receivers of batch ----------------------------------
+//  The seed is set once by the first PVT solution within the max receiver
+//  cycle, or expired after the cycle. It is published to the other receivers
+//  by the release of the status.
+static void set_seed(sdr_pvt_t *pvt, int64_t ix)
+{
+    sdr_pvt_seed_t *seed = pvt->rcv->seed;
+    
+    if (__atomic_load_n(&seed->stat, __ATOMIC_ACQUIRE)) return;
+    if (ix > seed->ix_max) {
+        __atomic_store_n(&seed->stat, -1, __ATOMIC_RELEASE);
+        return;
+    }
+    if (!pvt->sol->stat) return;
+    seed->time = pvt->sol->time;
+    seed->ix = pvt->rcv->ix_file + ix;
+    for (int i = 0; i < 6; i++) seed->rr[i] = pvt->sol->rr[i];
+    seed->drift = pvt->drift;
+    memcpy(seed->eph, pvt->nav->eph, sizeof(eph_t) *
+        MIN(pvt->nav->n, MAXSAT * 4));
+    memcpy(seed->geph, pvt->nav->geph, sizeof(geph_t) *
+        MIN(pvt->nav->ng, MAXPRNGLO));
+    __atomic_store_n(&seed->stat, 1, __ATOMIC_RELEASE);
+}
+
+// update PVT epoch ------------------------------------------------------------
+//  The epoch is updated if all of the channels updated the observation slots
+//  or the received IF data cycle passes the max PVT epoch lag.
+static void update_epoch(sdr_pvt_t *pvt, int64_t ix)
+{
+    int64_t ix_ep = __atomic_load_n(&pvt->ix, __ATOMIC_ACQUIRE);
+    
+    if (ix_ep <= 0 || (num_slot(pvt, ix_ep) < pvt->rcv->nch &&
+        ix < ix_ep + (int)(sdr_lag_epoch / SDR_CYC))) {
+        return;
+    }
+    // collect observation data
+    collect_obs(pvt, ix_ep);
+    
+    // resolve msec ambiguity in pseudorange
+    res_amb(pvt->obs);
+    
+    // output log $OBS and RTCM3 observation data
+    out_log_obs(ix_ep * SDR_CYC, pvt->obs);
+    out_rtcm3_obs(pvt->rtcm, pvt->obs, pvt->nav, out_str(pvt, ix_ep, 1));
+    if (pvt->obs->n > 0) pvt->count[1]++;
+    
+    // update PVT solution and satellite prediction
+    int64_t t0 = sdr_get_tick_ns();
+    update_sol(pvt);
+    if (pvt->sol->stat) update_pred(pvt, pvt->sol->time, pvt->ix);
+    update_stat(pvt);
+    sdr_perf_add(SDR_PERF_PVT, t0);
+    
+    // save warm-start state
+    if (*sdr_state_file && pvt->sol->stat &&
+        ix_ep >= pvt->ix_state + (int64_t)(STATE_CYC / SDR_CYC)) {
+        sdr_pvt_save_state(pvt, sdr_state_file);
+        pvt->ix_state = ix_ep;
+    }
+    
+    // set warm-start seed for receivers of batch
+    if (pvt->rcv->seed) set_seed(pvt, ix_ep);
+    
+    // start fast-rate epochs by the first PVT solution
+    if (sdr_t_fast > 0.0 && pvt->sol->stat && pvt->ix_fast <= 0) {
+        __atomic_store_n(&pvt->ix_fast, ix_ep, __ATOMIC_RELEASE);
+    }
+    
+    // set next epoch time and cycle
+    ix_ep += (int)(sdr_epoch / SDR_CYC);
+    
+    // adjust epoch cycle within 20 ms
+    if (pvt->sol->stat) {
+        double dtr = ROUND(pvt->sol->dtr[0] / 0.02) * 0.02;
+        ix_ep += (int)(dtr / SDR_CYC);
+    }
+    pthread_mutex_lock(&pvt->mtx);
+    pvt->time = timeadd(pvt->time, sdr_epoch);
+    pthread_mutex_unlock(&pvt->mtx);
+    __atomic_store_n(&pvt->ix, ix_ep, __ATOMIC_RELEASE);
+}
+
+// update satellite prediction by warm-start state -----------------------------
+//  The prediction is updated every epoch interval until the first PVT
+//  solution or the timeout of warm-start.
+static void update_warm(sdr_pvt_t *pvt, int64_t ix)
+{
+    if (pvt->ix_warm <= 0) return;
+    if (pvt->sol->stat || ix > pvt->ix_warm + (int64_t)(TO_WARM / SDR_CYC)) {
+        pvt->ix_warm = 0; // end of warm-start
+        return;
+    }
+    if (ix < pvt->ix_pred + (int64_t)(sdr_epoch / SDR_CYC)) return;
+    update_pred(pvt, timeadd(pvt->time_warm, (ix - pvt->ix_warm) * SDR_CYC),
+        ix);
+}
+
 //------------------------------------------------------------------------------
-//  Update PVT solution.
+//  Output fast-rate PVT record.
+//
+//  format (little-endian):
+//      SYNC(1) LEN(1) WEEK(2) TOW(8) POS(24) VEL(12) DTR(4) STAT(1) NS(1)
+//      CRC(2)
+//          SYNC  sync code (0xF5)
+//          LEN   record length (56)
+//          WEEK  solution GPS week (uint16)
+//          TOW   solution GPS TOW (s) (float64)
+//          POS   receiver position ECEF X, Y, Z (m) (float64 x 3)
+//          VEL   receiver velocity ECEF X, Y, Z (m/s) (float32 x 3)
+//          DTR   receiver clock bias (s) (float32)
+//          STAT  solution status (SOLQ_???)
+//          NS    number of valid satellites
+//          CRC   CRC-16 of the preceding bytes by rtk_crc16()
+//
+static void out_fast(const sol_t *sol, sdr_ostr_t *str)
+{
+    uint8_t buff[FAST_LEN];
+    float vel[3], dtr = (float)sol->dtr[0];
+    int week;
+    double tow = time2gpst(sol->time, &week);
+    uint16_t wk = (uint16_t)week, crc;
+    
+    if (!str) return;
+    for (int i = 0; i < 3; i++) {
+        vel[i] = (float)sol->rr[3+i];
+    }
+    buff[0] = FAST_SYNC;
+    buff[1] = FAST_LEN;
+    memcpy(buff + 2, &wk, 2);
+    memcpy(buff + 4, &tow, 8);
+    memcpy(buff + 12, sol->rr, 24);
+    memcpy(buff + 36, vel, 12);
+    memcpy(buff + 48, &dtr, 4);
+    buff[52] = sol->stat;
+    buff[53] = sol->ns;
+    crc = rtk_crc16(buff, 54);
+    memcpy(buff + 54, &crc, 2);
+    sdr_ostr_write(str, buff, FAST_LEN);
+}
+
+// collect observation data extrapolated to fast-rate epoch --------------------
+//  The code offset and the carrier phase of the latest observation slot of the
+//  channel are extrapolated to the epoch by the Doppler frequency.
+static void collect_fast(sdr_pvt_t *pvt, int64_t ix, gtime_t time)
+{
+    pvt->obs_f->n = 0;
+    
+    for (int i = 0; i < pvt->rcv->nch; i++) {
+        sdr_pvt_obs_t slot;
+        if (!read_slot(pvt->slot_f + i, &slot) || !slot.stat) continue;
+        double dt = (ix - slot.ix) * SDR_CYC;
+        if (fabs(dt) > MAX_AGE_FAST) continue;
+        slot.coff -= dt * (1.0 + slot.D / slot.fc);
+        slot.L -= dt * slot.D;
+        update_obs(time, pvt->obs_f, &slot);
+    }
+}
+
+// fast-rate point positioning -------------------------------------------------
+//  The position is updated by fixed iterations of the least squares started
+//  from the previous solution propagated by the velocity. The solution is not
+//  validated.
+static int fast_pos(sdr_pvt_t *pvt, sol_t *sol, char *msg)
+{
+    const obsd_t *obs = pvt->obs_f->data;
+    double rs[6*MAXOBS], dts[2*MAXOBS], var[MAXOBS], azel[2*MAXOBS] = {0};
+    double resp[MAXOBS], x[NX] = {0}, dx[NX], Q[NX*NX], v[MAXOBS+NX];
+    int n = MIN(pvt->obs_f->n, MAXOBS), svh[MAXOBS], vsat[MAXOBS] = {0};
+    int ns = 0;
+    
+    if (n <= 0 || norm(sol->rr, 3) <= 0.0) {
+        strcpy(msg, "no observation data or no solution");
+        return 0;
+    }
+    sat_poss(pvt, obs, n, rs, dts, var, svh);
+    
+    double dt = timediff(obs[0].time, sol->time);
+    for (int i = 0; i < 3; i++) {
+        x[i] = sol->rr[i] + sol->rr[3+i] * dt;
+    }
+    for (int i = 0; i < N_ITR_FAST; i++) {
+        if (!upd_pos(1, obs, n, rs, dts, var, svh, pvt->nav, pvt->opt, x, dx,
+                Q, v, azel, vsat, resp, &ns, msg)) {
+            return 0;
+        }
+    }
+    set_pos(obs[0].time, x, Q, ns, sol);
+    sol->stat = SOLQ_SINGLE;
+    est_vel(obs, n, rs, dts, pvt->nav, pvt->opt, sol, azel, vsat);
+    corr_sol_time(sol);
+    return 1;
+}
+
+// update fast-rate PVT epoch --------------------------------------------------
+//  The fast-rate epoch is updated LAG_FAST cycles after the epoch cycle without
+//  waiting for the channels. The epochs missed by the delay are skipped. The
+//  fast-rate solution is restarted from the PVT solution if lost.
+static void update_fast(sdr_pvt_t *pvt, int64_t ix)
+{
+    int64_t ix_f = __atomic_load_n(&pvt->ix_fast, __ATOMIC_ACQUIRE);
+    int nf = MAX(1, ROUND(sdr_t_fast / SDR_CYC));
+    char msg[128] = "";
+    
+    if (ix_f <= 0 || ix < ix_f + LAG_FAST) return;
+    
+    ix_f += (ix - LAG_FAST - ix_f) / nf * nf;
+    gtime_t time = timeadd(pvt->time, (ix_f - pvt->ix) * SDR_CYC);
+    int64_t t0 = sdr_get_tick_ns();
+    
+    // collect observation data and resolve msec ambiguity in pseudorange
+    collect_fast(pvt, ix_f, time);
+    res_amb(pvt->obs_f);
+    
+    // update fast-rate PVT solution and output fast-rate PVT record
+    if (pvt->sol_f->stat == SOLQ_NONE) {
+        *pvt->sol_f = *pvt->sol;
+    }
+    if (fast_pos(pvt, pvt->sol_f, msg)) {
+        out_fast(pvt->sol_f, out_str(pvt, ix_f, 4));
+        pvt->count[3]++;
+        update_stat(pvt);
+    }
+    else {
+        pvt->sol_f->stat = SOLQ_NONE;
+        sdr_log(3, "$LOG,%.3f,FAST PVT ERROR,%s", ix_f * SDR_CYC, msg);
+    }
+    sdr_perf_add(SDR_PERF_PVT, t0);
+    __atomic_store_n(&pvt->ix_fast, ix_f + nf, __ATOMIC_RELEASE);
+}
+
+// PVT thread ------------------------------------------------------------------
+static void *pvt_thread(void *arg)
+{
+    sdr_pvt_t *pvt = (sdr_pvt_t *)arg;
+    
+    while (__atomic_load_n(&pvt->state, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&pvt->mtx);
+        sdr_cond_wait(&pvt->cond, &pvt->mtx, WAIT_PVT);
+        pthread_mutex_unlock(&pvt->mtx);
+        
+        int64_t ix = __atomic_load_n(&pvt->ix_rcv, __ATOMIC_ACQUIRE);
+        update_nav(pvt);
+        update_warm(pvt, ix);
+        update_epoch(pvt, ix);
+        update_fast(pvt, ix);
+    }
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+//  Start the PVT thread of a SDR PVT. After started, the PVT epoch update by
+//  sdr_pvt_udsol() is done by the PVT thread. Without the PVT thread, it is
+//  done in the caller of sdr_pvt_udsol() as deterministic results for max
+//  speed replay of IF data file.
+//
+//  args:
+//      pvt      (IO) SDR PVT
+//
+//  returns:
+//      Status (1:OK, 0:error)
+//
+int sdr_pvt_start(sdr_pvt_t *pvt)
+{
+    if (pvt->state) return 0;
+    pvt->state = 1;
+    if (pthread_create(&pvt->thread, NULL, pvt_thread, pvt)) {
+        pvt->state = 0;
+        return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Update PVT solution. If the PVT thread is started, the received IF data
+//  cycle is notified to the PVT thread without lock or wait. Otherwise,
+//  navigation data and PVT epoch are updated in the caller.
 //
 //  args:
 //      pvt      (IO) SDR PVT
@@ -559,41 +1916,25 @@ static void res_obs_amb(obs_t *obs, int sys, uint8_t code, double sec)
 //
 void sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix)
 {
-    pthread_mutex_lock(&pvt->mtx);
-    
-    if (pvt->ix > 0 && (pvt->nch >= pvt->rcv->nch ||
-        ix >= pvt->ix + (int)(sdr_lag_epoch / SDR_CYC))) {
-        
-        // resolve msec ambiguity in pseudorange
-        res_obs_amb(pvt->obs, SYS_GPS | SYS_QZS, CODE_L5Q, 20e-3); // L5Q
-        res_obs_amb(pvt->obs, SYS_QZS, CODE_L5P, 20e-3); // L5SQ, L5SQV
-        res_obs_amb(pvt->obs, SYS_GLO, CODE_L3Q, 10e-3); // G3OCP
-        res_obs_amb(pvt->obs, SYS_SBS, CODE_L5Q, 2e-3);  // L5Q SBAS
-        
-        // output log $OBS and RTCM3 observation data
-        out_log_obs(pvt->ix * SDR_CYC, pvt->obs);
-        out_rtcm3_obs(pvt->rtcm, pvt->obs, pvt->rcv->strs[1]);
-        if (pvt->obs->n > 0) pvt->count[1]++;
-        
-        // update PVT solution
-        update_sol(pvt);
-        
-        // set next epoch time and cycle
-        pvt->time = timeadd(pvt->time, sdr_epoch);
-        pvt->ix += (int)(sdr_epoch / SDR_CYC);
-        pvt->nch = pvt->obs->n = 0; 
-        
-        // adjust epoch cycle within 20 ms
-        if (pvt->sol->stat) {
-            double dtr = ROUND(pvt->sol->dtr[0] / 0.02) * 0.02;
-            pvt->ix += (int)(dtr / SDR_CYC);
+    if (pvt->state) {
+        __atomic_store_n(&pvt->ix_rcv, ix, __ATOMIC_RELEASE);
+        int64_t ix_ep = __atomic_load_n(&pvt->ix, __ATOMIC_ACQUIRE);
+        int64_t ix_f = __atomic_load_n(&pvt->ix_fast, __ATOMIC_ACQUIRE);
+        if ((ix_ep > 0 && ix >= ix_ep) || (ix_f > 0 && ix >= ix_f + LAG_FAST)) {
+            pthread_cond_signal(&pvt->cond);
         }
     }
-    pthread_mutex_unlock(&pvt->mtx);
+    else {
+        update_nav(pvt);
+        update_warm(pvt, ix);
+        update_epoch(pvt, ix);
+        update_fast(pvt, ix);
+    }
 }
 
 //------------------------------------------------------------------------------
-//  Get PVT solution string.
+//  Get PVT solution string. The solution is read from the PVT status snapshot
+//  without lock.
 //
 //  args:
 //      pvt      (I)  SDR PVT
@@ -604,23 +1945,276 @@ void sdr_pvt_udsol(sdr_pvt_t *pvt, int64_t ix)
 //
 void sdr_pvt_solstr(sdr_pvt_t *pvt, char *buff)
 {
+    sdr_pvt_stat_t stat = {0};
     char tstr[32];
-    double pos[3] = {0};
-    int stat = 0;
+    
+    if (!sdr_seq_read(&pvt->stat.seq, &stat, &pvt->stat, sizeof(stat))) {
+        memset(&stat, 0, sizeof(stat));
+    }
+    gtime_t time = {(time_t)floor(stat.time), stat.time - floor(stat.time)};
+    time2str(time, tstr, 3);
+    tstr[4] = tstr[7] = '-';
+    sprintf(buff, "%23s %11.7f %12.7f %8.2f %2d/%2d %s", tstr, stat.pos[0],
+        stat.pos[1], stat.pos[2], stat.ns, stat.nsat,
+        stat.stat ? "FIX" : "---");
+}
+
+//------------------------------------------------------------------------------
+//  Get predicted Doppler frequency of a satellite by the PVT solution and the
+//  navigation data for acquisition assist and Doppler aiding of tracking
+//  loops. The Doppler frequency is predicted at the IF data cycle by the range
+//  acceleration.
+//
+//  args:
+//      pvt      (I)  SDR PVT
+//      ix       (I)  received IF data cycle (cyc)
+//      sat      (I)  satellite ID
+//      fc       (I)  carrier frequency (Hz)
+//      fd       (O)  predicted Doppler frequency (Hz)
+//      fdot     (O)  predicted Doppler frequency rate (Hz/s) (NULL: no output)
+//
+//  returns:
+//      Status (1: visible, 0: below elevation mask or unhealthy, -1: no
+//      prediction)
+//
+int sdr_pvt_pred_dop(sdr_pvt_t *pvt, int64_t ix, const char *sat, double fc,
+    float *fd, float *fdot)
+{
+    int s = satid2no(sat), stat = -1;
     
     pthread_mutex_lock(&pvt->mtx);
     
-    if (norm(pvt->sol->rr, 3) > 1e-6) {
-        time2str(pvt->sol->time, tstr, 3);
-        ecef2pos(pvt->sol->rr, pos);
-        stat = pvt->sol->stat;
-    }
-    else {
-        time2str(pvt->time, tstr, 3);
+    if (s > 0 && pvt->ix_pred > 0 &&
+        ix <= pvt->ix_pred + (int64_t)(TO_PRED / SDR_CYC)) {
+        if (pvt->pred[s-1] == 1) {
+            double t = (ix - pvt->ix_pred) * SDR_CYC;
+            double rate = pvt->pred_rate[s-1] + pvt->pred_acc[s-1] * t;
+            *fd = (float)(-rate * fc / CLIGHT);
+            if (fdot) *fdot = (float)(-pvt->pred_acc[s-1] * fc / CLIGHT);
+            stat = 1;
+        }
+        else if (pvt->pred[s-1] == 2) {
+            stat = 0;
+        }
     }
     pthread_mutex_unlock(&pvt->mtx);
+    return stat;
+}
+
+//------------------------------------------------------------------------------
+//  Save warm-start state of a SDR PVT to a binary file. The state contains the
+//  receiver position and velocity of the last PVT solution, the receiver clock
+//  drift, the valid ephemerides and the range rates of the locked channels. The
+//  file is written to <file>.tmp and renamed to be replaced atomically. It
+//  should be called by the PVT thread or after the PVT thread is stopped.
+//
+//  args:
+//      pvt      (I)  SDR PVT
+//      file     (I)  warm-start state file
+//
+//  returns:
+//      Status (1:OK, 0:error)
+//
+int sdr_pvt_save_state(sdr_pvt_t *pvt, const char *file)
+{
+    state_rate_t rates[MAXSAT];
+    state_head_t head;
+    uint8_t done[MAXSAT] = {0};
+    char path[1024+4];
+    FILE *fp;
     
-    tstr[4] = tstr[7] = '-';
-    sprintf(buff, "%23s %11.7f %12.7f %8.2f %2d/%2d %s", tstr, pos[0] * R2D,
-        pos[1] * R2D, pos[2], pvt->sol->ns, pvt->nsat, stat ? "FIX" : "---");
+    if (norm(pvt->sol->rr, 3) <= 0.0) return 0; // no PVT solution
+    
+    memset(&head, 0, sizeof(head));
+    memcpy(head.id, STATE_ID, sizeof(head.id));
+    head.ver = STATE_VER;
+    head.size[0] = (int32_t)sizeof(eph_t);
+    head.size[1] = (int32_t)sizeof(geph_t);
+    head.time = utc2gpst(timeget());
+    for (int i = 0; i < 6; i++) head.rr[i] = pvt->sol->rr[i];
+    head.drift = pvt->drift;
+    for (int i = 0; i < pvt->nav->n; i++) {
+        if (pvt->nav->eph[i].sat > 0) head.n[0]++;
+    }
+    for (int i = 0; i < pvt->nav->ng; i++) {
+        if (pvt->nav->geph[i].sat > 0) head.n[1]++;
+    }
+    for (int i = 0; i < pvt->rcv->nch; i++) {
+        sdr_ch_t *ch = pvt->rcv->th[i]->ch;
+        int sat = satid2no(ch->sat);
+        if (sat <= 0 || done[sat-1] || ch->state != SDR_STATE_LOCK ||
+            ch->lock * ch->T < MIN_LOCK_PRED) {
+            continue;
+        }
+        rates[head.n[2]].sat = sat;
+        rates[head.n[2]++].rate = (float)(-SDR_CH_FD(ch) * CLIGHT / ch->fc);
+        done[sat-1] = 1;
+    }
+    snprintf(path, sizeof(path), "%s.tmp", file);
+    
+    if (!(fp = fopen(path, "wb"))) {
+        fprintf(stderr, "state file open error %s\n", path);
+        return 0;
+    }
+    int stat = fwrite(&head, sizeof(head), 1, fp) == 1;
+    for (int32_t i = 0; stat && i < pvt->nav->n; i++) {
+        if (pvt->nav->eph[i].sat <= 0) continue;
+        stat = fwrite(&i, sizeof(i), 1, fp) == 1 &&
+            fwrite(pvt->nav->eph + i, sizeof(eph_t), 1, fp) == 1;
+    }
+    for (int32_t i = 0; stat && i < pvt->nav->ng; i++) {
+        if (pvt->nav->geph[i].sat <= 0) continue;
+        stat = fwrite(&i, sizeof(i), 1, fp) == 1 &&
+            fwrite(pvt->nav->geph + i, sizeof(geph_t), 1, fp) == 1;
+    }
+    if (stat && head.n[2] > 0) {
+        stat = fwrite(rates, sizeof(state_rate_t), head.n[2], fp) ==
+            (size_t)head.n[2];
+    }
+    if (fclose(fp) || !stat || rename(path, file)) {
+        fprintf(stderr, "state file write error %s\n", file);
+        remove(path);
+        return 0;
+    }
+    return 1;
+}
+
+// restore ephemeris newer than current one ------------------------------------
+static int restore_eph(sdr_pvt_t *pvt, int idx, const eph_t *eph)
+{
+    if (idx < 0 || idx >= pvt->nav->n || eph->sat <= 0 || eph->sat > MAXSAT) {
+        return 0;
+    }
+    eph_t *e = pvt->nav->eph + idx;
+    if (e->sat > 0 && timediff(eph->toe, e->toe) <= 0.0) return 0;
+    *e = *eph;
+    pvt->sats[eph->sat-1].stat = 0;
+    return 1;
+}
+
+// restore GLONASS ephemeris newer than current one ----------------------------
+static int restore_geph(sdr_pvt_t *pvt, int idx, const geph_t *geph)
+{
+    if (idx < 0 || idx >= pvt->nav->ng || geph->sat <= 0 ||
+        geph->sat > MAXSAT) {
+        return 0;
+    }
+    geph_t *g = pvt->nav->geph + idx;
+    if (g->sat > 0 && timediff(geph->toe, g->toe) <= 0.0) return 0;
+    *g = *geph;
+    pvt->sats[geph->sat-1].stat = 0;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Load warm-start state of a SDR PVT from a binary file saved by
+//  sdr_pvt_save_state(). The ephemerides newer than the current ones are
+//  restored. The satellite prediction for the acquisition assist is started by
+//  the receiver position, the clock drift and the current time by the system
+//  clock without PVT solution, and the range rates are used for the satellites
+//  w/o ephemeris if the state is not older than MAX_AGE_RATE. The prediction is
+//  updated until the first PVT solution or the timeout TO_WARM. It should be
+//  called before the PVT thread is started.
+//
+//  args:
+//      pvt      (IO) SDR PVT
+//      file     (I)  warm-start state file
+//
+//  returns:
+//      Status (1:OK, 0:error)
+//
+int sdr_pvt_load_state(sdr_pvt_t *pvt, const char *file)
+{
+    state_head_t head;
+    state_rate_t rate;
+    eph_t eph;
+    geph_t geph;
+    int32_t idx;
+    FILE *fp;
+    
+    if (!(fp = fopen(file, "rb"))) {
+        return 0;
+    }
+    if (fread(&head, sizeof(head), 1, fp) != 1 ||
+        memcmp(head.id, STATE_ID, sizeof(head.id)) || head.ver != STATE_VER ||
+        head.size[0] != (int32_t)sizeof(eph_t) ||
+        head.size[1] != (int32_t)sizeof(geph_t) || head.n[0] < 0 ||
+        head.n[1] < 0 || head.n[2] < 0 || head.n[2] > MAXSAT) {
+        fprintf(stderr, "state file format error %s\n", file);
+        fclose(fp);
+        return 0;
+    }
+    int stat = 1;
+    for (int i = 0; stat && i < head.n[0]; i++) {
+        if (!(stat = fread(&idx, sizeof(idx), 1, fp) == 1 &&
+            fread(&eph, sizeof(eph), 1, fp) == 1)) break;
+        restore_eph(pvt, idx, &eph);
+    }
+    for (int i = 0; stat && i < head.n[1]; i++) {
+        if (!(stat = fread(&idx, sizeof(idx), 1, fp) == 1 &&
+            fread(&geph, sizeof(geph), 1, fp) == 1)) break;
+        restore_geph(pvt, idx, &geph);
+    }
+    gtime_t time = utc2gpst(timeget());
+    double age = timediff(time, head.time);
+    for (int i = 0; stat && i < head.n[2]; i++) {
+        if (!(stat = fread(&rate, sizeof(rate), 1, fp) == 1)) break;
+        if (rate.sat <= 0 || rate.sat > MAXSAT || age < 0.0 ||
+            age > MAX_AGE_RATE) continue;
+        pvt->rate_warm[rate.sat-1] = rate.rate;
+    }
+    fclose(fp);
+    
+    if (!stat) {
+        fprintf(stderr, "state file read error %s\n", file);
+        return 0;
+    }
+    for (int i = 0; i < 6; i++) pvt->sol->rr[i] = head.rr[i];
+    pvt->drift = head.drift;
+    pvt->time_warm = time;
+    pvt->ix_warm = MAX(pvt->rcv->ix, 1);
+    update_pred(pvt, pvt->time_warm, pvt->ix_warm);
+    
+    sdr_log(3, "$LOG,%.3f,%s,%d,WARM START AGE=%.0f NEPH=%d NRATE=%d",
+        pvt->ix_warm * SDR_CYC, "", 0, age, head.n[0] + head.n[1], head.n[2]);
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Load warm-start seed of a SDR PVT set by the first PVT solution of another
+//  receiver of the same IF data file. The ephemerides newer than the current
+//  ones are restored. The satellite prediction for the acquisition assist is
+//  started by the receiver position, the clock drift and the time of the seed
+//  solution shifted by the IF data file cycles from the solution. It should be
+//  called before the PVT thread is started.
+//
+//  args:
+//      pvt      (IO) SDR PVT
+//      seed     (I)  warm-start seed (status should be set)
+//
+//  returns:
+//      Status (1:OK, 0:error)
+//
+int sdr_pvt_load_seed(sdr_pvt_t *pvt, const sdr_pvt_seed_t *seed)
+{
+    int neph = 0;
+    
+    if (__atomic_load_n(&seed->stat, __ATOMIC_ACQUIRE) != 1) return 0;
+    
+    for (int i = 0; i < MAXSAT * 4; i++) {
+        neph += restore_eph(pvt, i, seed->eph + i);
+    }
+    for (int i = 0; i < MAXPRNGLO; i++) {
+        neph += restore_geph(pvt, i, seed->geph + i);
+    }
+    for (int i = 0; i < 6; i++) pvt->sol->rr[i] = seed->rr[i];
+    pvt->drift = seed->drift;
+    pvt->ix_warm = MAX(pvt->rcv->ix, 1);
+    double dt = (pvt->rcv->ix_file + pvt->ix_warm - seed->ix) * SDR_CYC;
+    pvt->time_warm = timeadd(seed->time, dt);
+    update_pred(pvt, pvt->time_warm, pvt->ix_warm);
+    
+    sdr_log(3, "$LOG,%.3f,%s,%d,WARM START SEED DT=%.0f NEPH=%d",
+        pvt->ix_warm * SDR_CYC, "", 0, dt, neph);
+    return 1;
 }
@@ -13,25 +13,159 @@
 //  2024-06-21  1.5  add API sdr_rcv_open_dev(), sdr_rcv_open_file()
 //                   sdr_rcv_close()
 //  2024-06-28  1.6  modify API sdr_rcv_open_file()
+//  2026-10-14  1.7  run channels on a worker thread pool
+//                   wait IF data buffer update by condition variable
+//                   add API sdr_rcv_lat_stat()
+//                   output log of dropped USB transfers
+//                   unpack IF data in USB transfer buffers without copy
+//                   SIMD unpack of IF data for AVX2 and NEON
+//                   output memory allocation stats in stop log
+//                   runtime dispatch of AVX2 unpack functions
+//                   read memory-mapped IF data file without copy
+//                   add max speed replay of IF data file (tscale = 0) with
+//                   back-pressure to channel threads
+//                   add API sdr_rcv_batch()
+//                   share data DFTs of code search by data DFT cache
+//                   search signals in parallel slots by priority
+//                   assist acquisition by Doppler predicted by PVT
+//                   run channels in channel blocks on worker threads
+//                   add option mix_nco to select polynomial NCO mixer
+//                   add option pack_buff to pack 2-bit IF data in buffers
+//                   size IF data buffers and USB transfer buffers by sampling
+//                   rate and format, add options n_buff, usb_nbuff, usb_size
+//                   output peak buffer usage in receiver status
+//                   account IF data gaps by overrun, USB transfer error and
+//                   lapped channel, coast channels across gaps
+//                   add options usb_cpu, usb_pri, rcv_cpu, rcv_pri, work_cpu,
+//                   work_pri for CPU affinity and priority of threads
+//                   decode navigation data on decoder threads, add option n_nav
+//                   update PVT solution on PVT thread
+//                   asynchronous output streams with drop counters in
+//                   receiver status
+//                   per-stage performance counters, add API
+//                   sdr_rcv_perf_stat()
+//                   incremental PSD and histogram of RF channels by IF data
+//                   monitors
+//                   add options of long integration acquisition
+//                   track GLONASS FDMA channels on decimated sub-bands of
+//                   GLONASS FDMA channelizers, add option fdma
+//                   track narrowband signals and GLONASS FDMA channels on
+//                   decimated sub-bands by sub-band DDCs, replace option fdma
+//                   by ddc
+//                   track data channels jointly with pilot channels of
+//                   signals, add option joint
+//                   aid tracking loops of channels by Doppler predicted by PVT,
+//                   add option vt
+//                   coherent integration of channels over multiple code cycles
+//                   aligned to PVT epochs, add option t_int
+//                   fast-rate PVT solutions stream, add option t_fast
+//                   aggregate multiple SDR devices into a receiver, add API
+//                   sdr_rcv_open_devs()
+//                   publish or attach shared memory IF broker, add APIs
+//                   sdr_rcv_open_shm(), sdr_rcv_setopt_str()
+//                   stream or connect network IF stream, add API
+//                   sdr_rcv_open_net()
+//                   add string option state for warm-start state file
+//                   put channels of invisible satellites to sleep in budget of
+//                   live channels, add option n_live
+//                   blind search of long code signals by decimated search
+//                   frame headers of USB transfers, add option usb_frame
+//                   publish status snapshots of receiver and channels by
+//                   seqlock, add API sdr_rcv_get_stat(), sdr_rcv_ch_stat():
+//                   format channel status from snapshots without lock
+//                   place IF data buffers on NUMA nodes of worker threads,
+//                   add options mem_huge, mem_numa, mem_lock, add memory
+//                   placement stats to sdr_rcv_perf_stat()
+//                   run searching channels of channel block as separate tasks
+//                   sdr_rcv_rcv_stat(), sdr_rcv_sat_stat(): format status from
+//                   snapshots without lock to caller buffers
+//                   export FFTW wisdom of measured plans at receiver stop
+//                   decode nav data synchronously in max speed replay of IF
+//                   data file, stop decoder threads at receiver stop
+//                   warm-start receivers of batch segments by PVT seed of
+//                   first segment
+//                   save generated code books at receiver stop
 //
 #include "pocket_sdr.h"
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+#if defined(AVX2)
+#include <immintrin.h>
+#elif defined(NEON)
+#include <arm_neon.h>
+#endif
+
 // constants and macros ---------------------------------------------------------
-#define MAX_BUFF   8000         // max number of IF data buffer (* SDR_CYC)
+#define MAX_BUFF   8000         // max depth of IF data buffers (* SDR_CYC)
+#define MIN_BUFF   2000         // min depth of IF data buffers (* SDR_CYC)
+#define MEM_BUFF   256.0        // memory for IF data buffers (MB)
+#define T_USB_BUFF 0.2          // time span of USB transfer buffers (s)
+#define MIN_USB_BUFF 16         // min number of USB transfer buffers
+#define LAP_MARGIN 10           // margin to detect lapped channel (cyc)
 #define LOG_CYC    1000         // receiver channel log cycle (* SDR_CYC)
-#define TH_CYC     10           // receiver channel thread cycle (ms)
+#define TH_CYC     10           // receiver worker thread idle cycle (ms)
 #define TO_REACQ   60.0         // re-acquisition timeout (s)
 #define MIN_LOCK   2.0          // min lock time to show channel status (s)
 #define NUM_COL    110          // number of channel status columns
 #define MAX_ACQ    4e-3         // max code length w/o acqusition assist (s)
+#define MAX_DOP_PVT 250.0       // Doppler window of PVT assist (Hz)
 #define MAX_BUFF_USE 90         // max buffer usage rate (%)
+#define N_DFT_CACHE 16          // number of data DFT cache slots
+#define SEG_LAG    100          // lag to flush PVT epoch at segment end (cyc)
+#define SEG_TMP    "%s/%s.%d.seg%03d.%s" // temporary output file of segment
+#define OSTR_SIZE  (1<<20)      // size of NMEA and RTCM3 output stream buffer
+#define OSTR_SIZE_IF (1<<26)    // size of IF data log output stream buffer
+#define DDC_OSR    4.0          // min sampling rate of sub-band DDC (* chip)
+#define AID_CYC    100          // Doppler aiding cycle of channels (* SDR_CYC)
+#define LIVE_CYC   1000         // update cycle of live channels (* SDR_CYC)
+#define STAT_CYC   100          // update cycle of receiver status (* SDR_CYC)
 
 #define MIN(x, y)  ((x) < (y) ? (x) : (y))
+#define MAX(x, y)  ((x) > (y) ? (x) : (y))
 
 // global variables ------------------------------------------------------------
-static char rcv_rcv_stat_buff[2048];
+int sdr_n_work = 0;             // number of worker threads (0:CPU cores)
+int sdr_n_srch = 4;             // max number of signal search slots
+int sdr_n_live = 0;             // max number of live channels (0:all)
+int sdr_pack_buff = 0;          // pack 2-bit IF data in buffers (RAW8/RAW16)
+int sdr_n_buff = 0;             // depth of IF data buffers (cyc) (0:auto)
+int sdr_usb_nbuff = 0;          // number of USB transfer buffers (0:auto)
+int sdr_usb_size = 0;           // USB transfer buffer size (bytes) (0:default)
+int sdr_usb_frame = 0;          // frame headers of USB transfers (0:off,1:on)
+int sdr_usb_cpu = -1;           // CPU core of USB event handler (-1:any)
+int sdr_usb_pri = 99;           // priority of USB event handler (0:default)
+int sdr_rcv_cpu = -1;           // CPU core of receiver thread (-1:any)
+int sdr_rcv_pri = 0;            // priority of receiver thread (0:default)
+int sdr_work_cpu = -1;          // first CPU core of worker threads (-1:any)
+int sdr_work_pri = 0;           // priority of worker threads (0:default)
+int sdr_n_nav = 1;              // number of nav data decoder threads (0:sync)
+int sdr_ddc = 1;                // sub-band DDC of signals (0:off,1:on)
+int sdr_joint = 1;              // joint tracking of data and pilot (0:off,1:on)
+int sdr_vt = 0;                 // vector aided tracking by PVT (0:off,1:on)
+char sdr_shm_pub[48] = "";      // name of IF broker to publish ("":no)
+char sdr_net_pub[128] = "";     // address of network IF stream ("":no)
+extern int sdr_mem_huge, sdr_mem_numa, sdr_mem_lock; // large memory options
+
+// narrowband signals and chip rates for sub-band DDC --------------------------
+static const struct {
+    const char *sig;            // signal type
+    double chip;                // chip rate (chip/s)
+} ddc_sigs[] = {
+    {"L1CA", 1.023e6}, {"L1S" , 1.023e6}, {"L2CM", 1.023e6}, {"L2CL", 1.023e6},
+    {"G1CA", 0.511e6}, {"G2CA", 0.511e6}, {"B1I" , 2.046e6}, {"B2I" , 2.046e6},
+    {"I5S" , 1.023e6}, {"ISS" , 1.023e6}
+};
+
+// data and pilot signals for joint tracking ----------------------------------
+static const char *joint_sigs[][2] = {
+    {"L1CD", "L1CP"}, {"L5I" , "L5Q" }, {"G3OCD", "G3OCP"}, {"E1B" , "E1C" },
+    {"E5AI", "E5AQ"}, {"E5BI", "E5BQ"}, {"E6B" , "E6C" }, {"B1CD", "B1CP"},
+    {"B2AD", "B2AP"}, {"I1SD", "I1SP"}
+};
+
 static char rcv_ch_stat_buff[120 * (SDR_MAX_NCH + 2)];
-static char rcv_sat_stat_buff[1024];
 
 // get IF data buffer pointer --------------------------------------------------
 static int64_t get_buff_ix(sdr_rcv_t *rcv)
@@ -42,12 +176,67 @@ static int64_t get_buff_ix(sdr_rcv_t *rcv)
     return ix;
 }
 
-// set IF data buffer pointer --------------------------------------------------
+// set IF data buffer pointer and notify to worker threads ---------------------
 static void set_buff_ix(sdr_rcv_t *rcv, int64_t ix)
 {
     pthread_mutex_lock(&rcv->mtx);
     rcv->ix = ix;
+    rcv->lat.t = sdr_get_tick_us();
+    pthread_cond_broadcast(&rcv->cond);
+    pthread_mutex_unlock(&rcv->mtx);
+}
+
+// test IF data buffer read by channels up to cycle ix - lag -----------------
+static int test_buff_rd(sdr_rcv_t *rcv, int64_t ix, int lag)
+{
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_th_t *th = rcv->th[i];
+        int n = lag > 0 ? lag : 2 * th->ch->N / th->N;
+        if (th->state && ix - __atomic_load_n(&th->ix, __ATOMIC_ACQUIRE) >= n) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// wait for IF data buffer read by channels (lag = 0: all available data) ------
+static void wait_buff_rd(sdr_rcv_t *rcv, int64_t ix, int lag)
+{
+    pthread_mutex_lock(&rcv->mtx);
+    while (rcv->state && !test_buff_rd(rcv, ix, lag)) {
+        sdr_cond_wait(&rcv->cond_rd, &rcv->mtx, TH_CYC);
+    }
+    pthread_mutex_unlock(&rcv->mtx);
+}
+
+// notify IF data buffer read to receiver thread -------------------------------
+static void notify_buff_rd(sdr_rcv_t *rcv)
+{
+    pthread_mutex_lock(&rcv->mtx);
+    pthread_cond_broadcast(&rcv->cond_rd);
+    pthread_mutex_unlock(&rcv->mtx);
+}
+
+// update wakeup latency -------------------------------------------------------
+static void update_lat(sdr_lat_t *lat)
+{
+    double t = (double)(sdr_get_tick_us() - lat->t);
+    lat->n++;
+    lat->sum += t;
+    if (t > lat->max) lat->max = t;
+}
+
+// wait for IF data buffer pointer updated -------------------------------------
+static int64_t wait_buff_ix(sdr_rcv_t *rcv, int64_t ix, int msec)
+{
+    pthread_mutex_lock(&rcv->mtx);
+    if (rcv->ix == ix && sdr_cond_wait(&rcv->cond, &rcv->mtx, msec) &&
+        rcv->ix != ix) {
+        update_lat(&rcv->lat);
+    }
+    ix = rcv->ix;
     pthread_mutex_unlock(&rcv->mtx);
+    return ix;
 }
 
 // C/N0 bar --------------------------------------------------------------------
@@ -61,11 +250,10 @@ static void cn0_bar(float cn0, char *bar)
 }
 
 // SDR receiver channel sync status --------------------------------------------
-static void sync_stat(sdr_ch_t *ch, char *stat)
+static void sync_stat(int sync, char *stat)
 {
-    sprintf(stat, "%s%s%s%s", (ch->trk->sec_sync > 0) ? "S" : "-",
-        (ch->nav->ssync > 0) ? "B" : "-", (ch->nav->fsync > 0) ? "F" : "-",
-        (ch->nav->rev) ? "R" : "-");
+    sprintf(stat, "%c%c%c%c", (sync & 1) ? 'S' : '-', (sync & 2) ? 'B' : '-',
+        (sync & 4) ? 'F' : '-', (sync & 8) ? 'R' : '-');
 }
 
 // get number of tracking channels ---------------------------------------------
@@ -87,19 +275,17 @@ static int get_nch_trk(sdr_rcv_t *rcv, char *sys)
 // print SDR receiver status header --------------------------------------------
 static int print_head(char *buff, sdr_rcv_t *rcv)
 {
-    char *p = buff, solstr[128] = "", sys[16] = "";
-    int nch_bb = 0, nch_trk = 0, ch_srch = 0;
-    double buff_use = 0.0;
+    sdr_rcv_stat_t stat = {0};
+    char *p = buff, solstr[128] = "";
     
     if (rcv) {
-        nch_bb = rcv->nch;
-        nch_trk = get_nch_trk(rcv, sys);
-        ch_srch = rcv->ich + 1;
-        buff_use = rcv->buff_use;
-        sdr_pvt_solstr(rcv->pvt, solstr);
+        if (sdr_rcv_get_stat(rcv, &stat, NULL, NULL, 0) < 0) {
+            memset(&stat, 0, sizeof(stat));
+        }
+        if (rcv->pvt) sdr_pvt_solstr(rcv->pvt, solstr);
     }
     p += sprintf(p, " %-*s BUFF:%3.0f%% SRCH:%3d LOCK:%3d/%3d\n", NUM_COL - 38,
-        solstr, buff_use, ch_srch, nch_trk, nch_bb);
+        solstr, stat.buff_use, stat.nsrch, stat.ntrk, stat.nch);
     p += sprintf(p, "%3s %2s %4s %5s %3s %8s %4s %-12s %11s %7s %11s %4s %5s "
         "%4s %4s %3s\n", "CH", "RF", "SAT", "SIG", "PRN", "LOCK(s)", "C/N0",
         "(dB-Hz)", "COFF(ms)", "DOP(Hz)", "ADR(cyc)", "SYNC", "#NAV", "#ERR",
@@ -108,16 +294,15 @@ static int print_head(char *buff, sdr_rcv_t *rcv)
 }
 
 // print SDR receiver channel status -------------------------------------------
-static int print_ch_stat(char *buff, sdr_ch_t *ch)
+static int print_ch_stat(char *buff, const sdr_ch_stat_t *ch)
 {
     char *p = buff, bar[16], stat[16];
-    cn0_bar(ch->cn0, bar);
-    sync_stat(ch, stat);
+    cn0_bar((float)ch->cn0, bar);
+    sync_stat(ch->sync, stat);
     p += sprintf(p, "%3d %2d %4s %5s %3d %8.2f %4.1f %-13s%11.7f %7.1f %11.1f"
-        " %s %5d %4d %4d %3d\n", ch->no, ch->rf_ch + 1, ch->sat, ch->sig,
-        ch->prn, ch->lock * ch->T, ch->cn0, bar, ch->coff * 1e3, ch->fd,
-        ch->adr, stat, ch->nav->count[0], ch->nav->count[1], ch->lost,
-        ch->nav->nerr);
+        " %s %5d %4d %4d %3d\n", ch->no, ch->rfch, ch->sat, ch->sig, ch->prn,
+        ch->lock, ch->cn0, bar, ch->coff * 1e3, ch->fd, ch->adr, stat,
+        ch->nnav, ch->nerr, ch->lost, ch->fec);
     return (int)(p - buff);
 }
 
@@ -136,7 +321,8 @@ static int sat_select(const char *sat, const char *sys)
 }
 
 //------------------------------------------------------------------------------
-//  Get SDR receiver channel status as string.
+//  Get SDR receiver channel status as string. The status is formatted from the
+//  status snapshots of the receiver and the channels without lock.
 //
 //  args:
 //      rcv       (I)  SDR receiver
@@ -152,71 +338,128 @@ char *sdr_rcv_ch_stat(sdr_rcv_t *rcv, const char *sys, int all)
     
     p += print_head(p, rcv);
     for (int i = 0; rcv && i < rcv->nch; i++) {
-        sdr_ch_t *ch = rcv->th[i]->ch;
-        if (!sat_select(ch->sat, sys)) continue;
-        if (all || (ch->state == SDR_STATE_LOCK &&
-            ch->lock * ch->T >= MIN_LOCK)) {
-            p += print_ch_stat(p, ch);
+        const sdr_ch_stat_t *stat = &rcv->th[i]->stat;
+        sdr_ch_stat_t ch;
+        if (!sdr_seq_read(&stat->seq, &ch, stat, sizeof(ch))) continue;
+        if (!sat_select(ch.sat, sys)) continue;
+        if (all || (ch.state == SDR_STATE_LOCK && ch.lock >= MIN_LOCK)) {
+            p += print_ch_stat(p, &ch);
         }
     }
     return rcv_ch_stat_buff;
 }
 
-// get receiver status as sting ------------------------------------------------
-char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv)
+// peak usage of USB transfer buffers (%) --------------------------------------
+static double usb_buff_max(sdr_rcv_t *rcv)
+{
+    double use = 0.0;
+    
+    if (rcv->dev != SDR_DEV_USB) return 0.0;
+    for (int i = 0; i < rcv->ndev; i++) {
+        sdr_dev_t *dev = (sdr_dev_t *)rcv->dps[i];
+        int64_t n = __atomic_load_n(&dev->unread_max, __ATOMIC_RELAXED);
+        use = MAX(use, n * 100.0 / ((double)dev->nbuff * dev->size_data));
+    }
+    return use;
+}
+
+// get output streams status as string -----------------------------------------
+//  The numbers of dropped writes of NMEA, RTCM3 and IF data log streams are
+//  output as n/n/n (-: no stream).
+static const char *ostr_stat(const sdr_rcv_stat_t *stat, char *buff)
+{
+    char *p = buff;
+    
+    for (int i = 0; i < 3; i++) {
+        if (i > 0) *p++ = '/';
+        if (stat->ndrop[i] >= 0) {
+            p += sprintf(p, "%lld", (long long)stat->ndrop[i]);
+        }
+        else {
+            p += sprintf(p, "-");
+        }
+    }
+    return buff;
+}
+
+//------------------------------------------------------------------------------
+//  Get SDR receiver status as string. The status is formatted from the status
+//  snapshots of the receiver and the PVT without lock. IF data buffer usage is
+//  output as current/peak/peak of USB transfer buffers.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//      buff      (O)  receiver status string buffer (>= 1024 bytes)
+//
+//  returns:
+//      receiver status string (buff)
+//
+char *sdr_rcv_rcv_stat(sdr_rcv_t *rcv, char *buff)
 {
     static const char *src_str[] = {"---", "IF Data", "RF Frontend"};
     static const char *fmt_str[] = {"---", "INT8", "INT8X2", "RAW8", "RAW16"};
     static const char *IQ_str[] = {"---", "I", "IQ"};
-    char *p = rcv_rcv_stat_buff;
+    sdr_rcv_stat_t stat = {0};
+    sdr_pvt_stat_t pvt = {0};
+    char *p = buff;
     
-    if (rcv && rcv->state) {
-        char solstr[128] = "", sys[16] = "";
-        int nch_trk = get_nch_trk(rcv, sys);
-        sdr_pvt_solstr(rcv->pvt, solstr);
+    if (rcv && sdr_rcv_get_stat(rcv, &stat, &pvt, NULL, 0) >= 0 &&
+        stat.state) {
+        char solstr[128] = "", ostr[64];
+        if (rcv->pvt) sdr_pvt_solstr(rcv->pvt, solstr);
         p += sprintf(p, "%.3f,%s,%s,%d,%.3f/%.3f,%.3f/%.3f,%s/%s/%s/%s,%.3f,"
-            "%d/%d,%.3f,%.1f,", get_buff_ix(rcv) * SDR_CYC, src_str[rcv->dev],
-            fmt_str[rcv->fmt], rcv->nbuff, rcv->fo[0] * 1e-6, rcv->fo[1] * 1e-6,
-            rcv->fo[2] * 1e-6, rcv->fo[3] * 1e-6, IQ_str[rcv->IQ[0]],
-            IQ_str[rcv->IQ[1]], IQ_str[rcv->IQ[2]], IQ_str[rcv->IQ[3]],
-            rcv->fs * 1e-6, nch_trk, rcv->nch, rcv->data_rate * 1e-6,
-            rcv->buff_use);
-        p += sprintf(p, "%.21s,%.3s,%.11s,%.12s,%.8s,%s,%.5s,,%d,%d/%d,%.1f,",
-            solstr, solstr + 64, solstr + 24, solstr + 36, solstr + 49, sys,
-            solstr + 58, rcv->pvt->count[0], rcv->pvt->count[1],
-            rcv->pvt->count[2], rcv->data_sum);
-       }
+            "%d/%d,%.3f,%.1f/%.1f/%.1f,", stat.time, src_str[stat.dev],
+            fmt_str[stat.fmt], stat.nrf, stat.fo[0] * 1e-6, stat.fo[1] * 1e-6,
+            stat.fo[2] * 1e-6, stat.fo[3] * 1e-6, IQ_str[stat.IQ[0]],
+            IQ_str[stat.IQ[1]], IQ_str[stat.IQ[2]], IQ_str[stat.IQ[3]],
+            stat.fs * 1e-6, stat.ntrk, stat.nch, stat.data_rate, stat.buff_use,
+            stat.buff_max, stat.usb_max);
+        p += sprintf(p, "%.21s,%.3s,%.11s,%.12s,%.8s,%.7s,%.5s,%s,%d,%d/%d,"
+            "%.1f,", solstr, solstr + 64, solstr + 24, solstr + 36,
+            solstr + 49, stat.sys, solstr + 58, ostr_stat(&stat, ostr),
+            pvt.count[0], pvt.count[1], pvt.count[2], stat.data_sum);
+    }
     else {
         p += sprintf(p, "%.3f,---,---,%d,%.3f/%.3f,%.3f/%.3f,---/---/---/---,"
-            "%.3f,%d/%d,%.3f,%.1f,", 0.0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0.0,
-            0.0);
+            "%.3f,%d/%d,%.3f,%.1f/%.1f/%.1f,", 0.0, 0, 0.0, 0.0, 0.0, 0.0, 0.0,
+            0, 0, 0.0, 0.0, 0.0, 0.0);
         p += sprintf(p, "1970-01-01 00:00:00.0,---,%.7f,%.7f,%.2f,,%d/%d,,%d,"
             "%d/%d,%.1f,", 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, 0.0);
     }
-    return rcv_rcv_stat_buff;
+    return buff;
 }
 
-// get satellite status as sting -----------------------------------------------
-char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys)
+//------------------------------------------------------------------------------
+//  Get satellite status as string. The azimuth and elevation angles of the
+//  satellites above horizon are formatted from the PVT satellite status
+//  snapshot without lock.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//      sys       (I)  system
+//      buff      (O)  satellite status string buffer (>= 32 * MAXSAT bytes)
+//
+//  returns:
+//      satellite status string (buff)
+//
+char *sdr_rcv_sat_stat(sdr_rcv_t *rcv, const char *sys, char *buff)
 {
-    char *p = rcv_sat_stat_buff;
+    sdr_pvt_sat_stat_t stat;
+    char *p = buff;
     
     *p = '\0';
-    if (rcv) {
-        pthread_mutex_lock(&rcv->pvt->mtx);
-        
-        for (int i = 0; i < MAXSAT; i++) {
-            char sat[16];
-            satno2id(i+1, sat);
-            if (!sat_select(sat, sys)) continue;
-            ssat_t *ssat = rcv->pvt->ssat + i;
-            if (ssat->azel[1] <= 0.0) continue;
-            p += sprintf(p, "%s %.1f %.1f %d\n", sat, ssat->azel[0] * R2D,
-                ssat->azel[1] * R2D, ssat->vs);
-        }
-        pthread_mutex_unlock(&rcv->pvt->mtx);
+    if (!rcv || !rcv->pvt || !sdr_seq_read(&rcv->pvt->sat_stat.seq, &stat,
+        &rcv->pvt->sat_stat, sizeof(stat))) {
+        return buff;
     }
-    return rcv_sat_stat_buff;
+    for (int i = 0; i < stat.n && i < MAXSAT; i++) {
+        char sat[16];
+        satno2id(stat.sat[i], sat);
+        if (!sat_select(sat, sys)) continue;
+        p += sprintf(p, "%s %.1f %.1f %d\n", sat, stat.az[i], stat.el[i],
+            stat.vs[i]);
+    }
+    return buff;
 }
 
 // select channel for correlator status ----------------------------------------
@@ -228,6 +471,143 @@ void sdr_rcv_sel_ch(sdr_rcv_t *rcv, int ch)
     }
 }
 
+// get wakeup latency status ---------------------------------------------------
+// stat = {n, ave (us), max (us)} of IF data reader and of worker threads
+int sdr_rcv_lat_stat(sdr_rcv_t *rcv, double *stat)
+{
+    sdr_lat_t lat[2] = {{0}};
+    
+    if (!rcv || !rcv->state) return 0;
+    for (int i = 0; rcv->dev == SDR_DEV_USB && i < rcv->ndev; i++) {
+        sdr_dev_t *dev = (sdr_dev_t *)rcv->dps[i];
+        pthread_mutex_lock(&dev->mtx);
+        lat[0].n += dev->lat.n;
+        lat[0].sum += dev->lat.sum;
+        lat[0].max = MAX(lat[0].max, dev->lat.max);
+        pthread_mutex_unlock(&dev->mtx);
+    }
+    pthread_mutex_lock(&rcv->mtx);
+    lat[1] = rcv->lat;
+    pthread_mutex_unlock(&rcv->mtx);
+    
+    for (int i = 0; i < 2; i++) {
+        stat[i*3  ] = (double)lat[i].n;
+        stat[i*3+1] = lat[i].n > 0 ? lat[i].sum / lat[i].n : 0.0;
+        stat[i*3+2] = lat[i].max;
+    }
+    return 1;
+}
+
+// percentile of performance histogram (us) -----------------------------------
+static double perf_pct(const sdr_perf_t *perf, double pct)
+{
+    int64_t n = 0;
+    
+    for (int i = 0; i < SDR_N_PERF_BIN; i++) {
+        if ((n += perf->hist[i]) >= perf->n * pct / 100.0) {
+            return MIN((double)(2ll << i), (double)perf->max) * 1e-3;
+        }
+    }
+    return perf->max * 1e-3;
+}
+
+// get performance status ------------------------------------------------------
+//  The elapsed times of the stages are summed over threads of the process. The
+//  CPU load of the channel is the CPU time for the channel per elapsed time.
+//
+//  stat = {n, ave, p50, p99, max} (us) of stages SDR_PERF_??? {SDR_N_PERF},
+//         IF buffer usage (%), peak IF buffer usage (%), decoder thread jobs,
+//         PVT nav data queue, max queued bytes of output streams,
+//         memory placement stats {SDR_N_MEM} (see sdr_mem_stat()),
+//         CPU load of channels (%) {nch}
+//
+//  returns number of stat (0: error)
+//
+int sdr_rcv_perf_stat(sdr_rcv_t *rcv, double *stat)
+{
+    sdr_perf_t perf[SDR_N_PERF];
+    double *p = stat;
+    
+    if (!rcv || !rcv->pvt) return 0;
+    
+    sdr_perf_get(perf);
+    for (int i = 0; i < SDR_N_PERF; i++) {
+        *p++ = (double)perf[i].n;
+        *p++ = perf[i].n > 0 ? perf[i].sum * 1e-3 / perf[i].n : 0.0;
+        *p++ = perf_pct(perf + i, 50.0);
+        *p++ = perf_pct(perf + i, 99.0);
+        *p++ = perf[i].max * 1e-3;
+    }
+    *p++ = rcv->buff_use;
+    *p++ = rcv->buff_max;
+    *p++ = sdr_nav_queue();
+    *p++ = sdr_pvt_nav_queue(rcv->pvt);
+    int64_t nq = 0;
+    for (int i = 0; i < 5; i++) {
+        sdr_ostr_t *ostr = rcv->strs[i];
+        if (!ostr) continue;
+        int64_t n = __atomic_load_n(&ostr->wp, __ATOMIC_RELAXED) -
+            __atomic_load_n(&ostr->rp, __ATOMIC_RELAXED);
+        if (n > nq) nq = n;
+    }
+    *p++ = (double)nq;
+    sdr_mem_stat(p);
+    p += SDR_N_MEM;
+    double t = (double)(sdr_get_tick_ns() - rcv->perf_t0);
+    for (int i = 0; i < rcv->nch; i++) {
+        int64_t tcpu = __atomic_load_n(&rcv->th[i]->ch->tcpu, __ATOMIC_RELAXED);
+        *p++ = t > 0.0 ? tcpu * 100.0 / t : 0.0;
+    }
+    return (int)(p - stat);
+}
+
+//------------------------------------------------------------------------------
+//  Get SDR receiver status snapshots. The status of the receiver, the PVT and
+//  the channels are copied without lock from the snapshots written by the
+//  receiver thread, the PVT thread and the channel updates. Each snapshot is
+//  consistent by itself. Polling the status never blocks the channels.
+//
+//  args:
+//      rcv       (I)  SDR receiver
+//      stat      (O)  receiver status (NULL: no output)
+//      pvt       (O)  PVT status (NULL: no output)
+//      chs       (O)  channel status {nmax} (NULL: no output)
+//      nmax      (I)  max number of channel status
+//
+//  returns:
+//      number of channel status (-1: error)
+//
+int sdr_rcv_get_stat(sdr_rcv_t *rcv, sdr_rcv_stat_t *stat, sdr_pvt_stat_t *pvt,
+    sdr_ch_stat_t *chs, int nmax)
+{
+    int n = 0;
+    
+    if (!rcv) return -1;
+    if (stat) {
+        if (!sdr_seq_read(&rcv->stat.seq, stat, &rcv->stat, sizeof(*stat))) {
+            return -1;
+        }
+        stat->ver = SDR_STAT_VER;
+        stat->size[0] = (uint32_t)sizeof(sdr_rcv_stat_t);
+        stat->size[1] = (uint32_t)sizeof(sdr_pvt_stat_t);
+        stat->size[2] = (uint32_t)sizeof(sdr_ch_stat_t);
+    }
+    if (pvt) {
+        const sdr_pvt_t *p = rcv->pvt;
+        if (!p) {
+            memset(pvt, 0, sizeof(*pvt));
+        }
+        else if (!sdr_seq_read(&p->stat.seq, pvt, &p->stat, sizeof(*pvt))) {
+            return -1;
+        }
+    }
+    for (int i = 0; chs && i < rcv->nch && n < nmax; i++) {
+        const sdr_ch_stat_t *s = &rcv->th[i]->stat;
+        if (!sdr_seq_read(&s->seq, chs + n++, s, sizeof(*s))) return -1;
+    }
+    return n;
+}
+
 // get correlator status -------------------------------------------------------
 int sdr_rcv_corr_stat(sdr_rcv_t *rcv, int ch, double *stat, int *pos,
     sdr_cpx_t *C)
@@ -260,19 +640,7 @@ int sdr_rcv_rfch_stat(sdr_rcv_t *rcv, int ch, double *stat)
 int sdr_rcv_rfch_psd(sdr_rcv_t *rcv, int ch, double tave, int N, float *psd)
 {
     if (!rcv || !rcv->state || ch < 1 || ch > rcv->nbuff) return 0;
-    int n = (int)(rcv->fs * tave);
-    int64_t ix = get_buff_ix(rcv);
-    if (ix * rcv->N < n) return 0;
-    sdr_cpx_t *buff = sdr_cpx_malloc(n);
-    for (int i = 0; i < n; i++) {
-        int j = (int)((ix * rcv->N - n + i) % rcv->buff[ch-1]->N);
-        sdr_cpx8_t data = rcv->buff[ch-1]->data[j];
-        buff[i][0] = SDR_CPX8_I(data);
-        buff[i][1] = SDR_CPX8_Q(data);
-    }
-    sdr_psd_cpx(buff, n, N, rcv->fs, rcv->buff[ch-1]->IQ, psd);
-    sdr_cpx_free(buff);
-    return rcv->buff[ch-1]->IQ == 1 ? N / 2 : N; // PSD size
+    return sdr_mon_psd(rcv->mon[ch-1], tave, N, psd);
 }
 
 // get RF channel histgram -----------------------------------------------------
@@ -280,29 +648,9 @@ int sdr_rcv_rfch_hist(sdr_rcv_t *rcv, int ch, double tave, int *val,
     double *hist1, double *hist2)
 {
     if (!rcv || !rcv->state || ch < 1 || ch > rcv->nbuff) return 0;
-    int n = (int)(rcv->fs * tave), cnt[2][256] = {{0}}, sum[2] = {0}, nval = 0;
-    int64_t ix = get_buff_ix(rcv);
-    if (ix * rcv->N < n) return 0;
-    for (int i = 0; i < n; i++) {
-        int j = (int)((ix * rcv->N - n + i) % rcv->buff[ch-1]->N);
-        sdr_cpx8_t data = rcv->buff[ch-1]->data[j];
-        cnt[0][SDR_CPX8_I(data)+128]++;
-        cnt[1][SDR_CPX8_Q(data)+128]++;
-    }
-    for (int i = 0; i < 256; i++) {
-        sum[0] += cnt[0][i];
-        sum[1] += cnt[1][i];
-    }
-    for (int i = 0; i < 256; i++) {
-        if (cnt[0][i] == 0 && cnt[1][i] == 0) continue;
-        hist1[nval] = sum[0] > 0 ? (double)cnt[0][i] / sum[0] : 0.0;
-        if (rcv->IQ[ch-1] == 2) {
-            hist2[nval] = sum[1] > 0 ? (double)cnt[1][i] / sum[1] : 0.0;
-        }
-        val[nval++] = i - 128;
-    }
-    return nval;
+    return sdr_mon_hist(rcv->mon[ch-1], tave, val, hist1, hist2);
 }
+
 // output log $TIME ------------------------------------------------------------
 static void out_log_time(double time)
 {
@@ -316,20 +664,63 @@ static void out_log_time(double time)
 static void out_log_ch(sdr_ch_t *ch)
 {
     sdr_log(4, "$CH,%.3f,%s,%d,%d,%.1f,%.9f,%.3f,%.3f,%d,%d", ch->time, ch->sig,
-        ch->prn, ch->lock, ch->cn0, ch->coff * 1e3, ch->fd, ch->adr,
-        ch->nav->count[0], ch->nav->count[1]);
+        ch->prn, ch->lock, SDR_CH_CN0(ch), SDR_CH_COFF(ch) * 1e3, SDR_CH_FD(ch),
+        SDR_CH_ADR(ch), ch->nav->count[0], ch->nav->count[1]);
+}
+
+// sub-band DDC of RF channel for signal --------------------------------------
+//  The sub-band sampling rate is the lowest rate >= DDC_OSR * chip rate of the
+//  narrowband signal. The DDC is shared by the channels of the same RF channel,
+//  center frequency and decimation ratio.
+static sdr_ddc_t *rcv_ddc(sdr_rcv_t *rcv, int rfch, const char *sig, double fc)
+{
+    double chip = 0.0;
+    
+    if (!sdr_ddc) return NULL;
+    for (int i = 0; i < (int)(sizeof(ddc_sigs) / sizeof(ddc_sigs[0])); i++) {
+        if (!strcmp(sig, ddc_sigs[i].sig)) chip = ddc_sigs[i].chip;
+    }
+    if (chip <= 0.0) return NULL;
+    int D = sdr_ddc_dec(rcv->fs, rcv->N, chip * DDC_OSR);
+    for (int i = 0; i < rcv->nddc; i++) {
+        sdr_ddc_t *ddc = rcv->ddc[i];
+        if (ddc->src == rcv->buff[rfch] && ddc->fc == fc && ddc->D == D) {
+            return ddc;
+        }
+    }
+    sdr_ddc_t *ddc = sdr_ddc_new(rcv->buff[rfch], rcv->fs, fc, rcv->N, D);
+    if (!ddc) return NULL;
+    ddc->buff->dft = sdr_dft_cache_new(N_DFT_CACHE);
+    rcv->ddc[rcv->nddc++] = ddc;
+    return ddc;
 }
 
 // new SDR receiver channel thread ---------------------------------------------
-static sdr_ch_th_t *ch_th_new(const char *sig, int prn, double fi, double fs,
+//  The channel of narrowband signal is run on the decimated sub-band centered
+//  at the signal (the FCN for GLONASS FDMA) by the sub-band DDC if available.
+static sdr_ch_th_t *ch_th_new(const char *sig, int prn, double fi, int rfch,
     sdr_rcv_t *rcv)
 {
     sdr_ch_th_t *th = (sdr_ch_th_t *)sdr_malloc(sizeof(sdr_ch_th_t));
+    double fc = sdr_shift_freq(sig, prn, fi);
+    sdr_ddc_t *ddc = rcv_ddc(rcv, rfch, sig, fc);
     
-    if (!(th->ch = sdr_ch_new(sig, prn, fs, fi))) {
+    if (ddc) { // sub-band with IF frequency 0 Hz for the signal
+        th->ch = sdr_ch_new(sig, prn, rcv->fs / ddc->D, fi - fc);
+        th->buff = ddc->buff;
+        th->N = rcv->N / ddc->D;
+        th->ddc = ddc;
+    }
+    else {
+        th->ch = sdr_ch_new(sig, prn, rcv->fs, fi);
+        th->buff = rcv->buff[rfch];
+        th->N = rcv->N;
+    }
+    if (!th->ch) {
         sdr_free(th);
         return NULL;
     }
+    th->ch->rf_ch = rfch;
     th->rcv = rcv;
     return th;
 }
@@ -342,276 +733,1365 @@ static void ch_th_free(sdr_ch_th_t *th)
     sdr_free(th);
 }
 
-// SDR receiver channel thread ------------------------------------------------
-static void *ch_thread(void *arg)
+// code cycles of next correlation interval of SDR receiver channel ------------
+//  The interval is ended at the PVT epoch to update the observation data.
+static int ncyc_ch(sdr_ch_th_t *th)
 {
-    sdr_ch_th_t *th = (sdr_ch_th_t *)arg;
-    sdr_ch_t *ch = th->ch;
-    int n = ch->N / th->rcv->N;
+    int n = th->ch->N / th->N, m = sdr_ch_ncyc(th->ch);
+    int64_t ix_ep = __atomic_load_n(&th->rcv->pvt->ix, __ATOMIC_ACQUIRE);
     
-    while (th->state) {
-        int64_t ix = get_buff_ix(th->rcv);
-        for ( ; th->ix + 2 * n <= ix && th->state; th->ix += n) {
-            
-            // update SDR receiver channel
-            sdr_ch_update(ch, th->ix * SDR_CYC, th->rcv->buff[ch->rf_ch],
-                th->rcv->N * (int)(th->ix % MAX_BUFF));
-            
-            // update navigation data
-            if (ch->nav->stat) {
-                sdr_pvt_udnav(th->rcv->pvt, ch);
-                ch->nav->stat = 0;
-            }
-            // update observation data
-            sdr_pvt_udobs(th->rcv->pvt, th->ix, ch);
-            
-            // output channel log
-            if (ch->state == SDR_STATE_LOCK && th->ix % LOG_CYC == 0) {
-                out_log_ch(ch);
-            }
-        }
-        sdr_sleep_msec(TH_CYC);
+    if (m > 1 && ix_ep > th->ix && (ix_ep - th->ix) % n == 0) {
+        m = (int)MIN(m, (ix_ep - th->ix) / n + 1);
     }
-    return NULL;
+    return m;
 }
 
-// start SDR receiver channel ----------------------------------------------------
-static int ch_th_start(sdr_ch_th_t *th)
+// test SDR receiver channel due to update ------------------------------------
+//  The channel is due if the IF data of the correlation interval and the next
+//  code cycle are available.
+static int due_ch(sdr_ch_th_t *th, int64_t ix)
 {
-    if (th->state) return 0;
-    th->state = 1;
-    return !pthread_create(&th->thread, NULL, ch_thread, th);
+    int n = th->ch->N / th->N;
+    
+    return th->state && __atomic_load_n(&th->ix, __ATOMIC_ACQUIRE) +
+        (ncyc_ch(th) + 1) * n <= ix;
 }
 
-// stop SDR receiver channel ---------------------------------------------------
-static void ch_th_stop(sdr_ch_th_t *th)
+// mask of channels due to update in channel block task ------------------------
+static uint32_t due_mask(sdr_blk_th_t *bt, int64_t ix)
 {
-    th->state = 0;
+    uint32_t mask = 0;
+    
+    for (int k = 0; k < bt->nth; k++) {
+        if (due_ch(bt->th[k], ix)) mask |= 1u << k;
+    }
+    return mask;
 }
 
-// set RF channel and IF frequency ---------------------------------------------
-static int set_rfch(int fmt, double fs, const double *fo, const int *IQ,
-    const char *sig, double *fi)
+// mask of searching channels in channel block task ----------------------------
+static uint32_t srch_mask(sdr_blk_th_t *bt, uint32_t mask)
 {
-    double freq = sdr_sig_freq(sig);
-    int rfch = 0;
+    uint32_t srch = 0;
     
-    if (fmt == SDR_FMT_RAW8) { // FE 2CH
-        rfch = freq > 1.4e9 ? 0 : 1;
-    }
-    else if (fmt == SDR_FMT_RAW16) { // FE 4CH
-        for (int i = 1; i < 4; i++) {
-            if (fabs(freq - fo[i]) < fabs(freq - fo[rfch])) rfch = i;
+    for (int k = 0; k < bt->nth; k++) {
+        if ((mask & (1u << k)) && bt->th[k]->ch->state == SDR_STATE_SRCH) {
+            srch |= 1u << k;
         }
     }
-    *fi = fo[rfch] > 0.0 ? freq - fo[rfch] : (IQ[rfch] == 1 ? fs * 0.5 : 0.0);
-    return rfch;
+    return srch;
 }
 
-//------------------------------------------------------------------------------
-//  Generate a new SDR receiver.
-//
-//  args:
-//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
-//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
-//      n         (I)  number of sigs and prns
-//      fmt       (I)  IF data format (SDR_FMT_???)
-//      fs        (I)  sampling rate (sps)
-//      fo        (I)  LO frequency for each RFCH (Hz)
-//      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
-//
-//  returns:
-//      SDR receiver (NULL: error)
-//
-sdr_rcv_t *sdr_rcv_new(const char **sigs, const int *prns, int n, int fmt,
-    double fs, const double *fo, const int *IQ)
+// claim channel lanes of channel block task -----------------------------------
+//  The lanes still due after claimed are returned. A lane is updated only by
+//  the worker claiming it.
+static uint32_t claim_lanes(sdr_blk_th_t *bt, uint32_t mask, int64_t ix)
 {
-    sdr_rcv_t *rcv = (sdr_rcv_t *)sdr_malloc(sizeof(sdr_rcv_t));
+    uint32_t claim = 0;
     
-    rcv->fmt = fmt;
-    rcv->fs = fs;
-    for (int i = 0; i < SDR_MAX_RFCH; i++) {
-        rcv->fo[i] = fo[i];
-        rcv->IQ[i] = IQ[i];
-    }
-    rcv->N = (int)(SDR_CYC * fs);
-    for (int i = 0; i < n && rcv->nch < SDR_MAX_NCH; i++) {
-        double fi = 0.0;
-        int rfch = set_rfch(fmt, fs, fo, IQ, sigs[i], &fi);
-        sdr_ch_th_t *th = ch_th_new(sigs[i], prns[i], fi, fs, rcv);
-        if (th) {
-            th->ch->no = rcv->nch + 1;
-            th->ch->rf_ch = rfch;
-            rcv->th[rcv->nch++] = th;
+    for (int k = 0; k < bt->nth; k++) {
+        if (!(mask & (1u << k)) ||
+            __atomic_exchange_n(&bt->lane[k], 1, __ATOMIC_ACQUIRE)) continue;
+        if (due_ch(bt->th[k], ix)) {
+            claim |= 1u << k;
         }
         else {
-            fprintf(stderr, "signal / prn error: %s / %d\n", sigs[i], prns[i]);
+            __atomic_store_n(&bt->lane[k], 0, __ATOMIC_RELEASE);
         }
     }
-    rcv->nbuff = fmt == SDR_FMT_RAW16 ? 4 : (fmt == SDR_FMT_RAW8 ? 2 : 1);
-    for (int i = 0; i < rcv->nbuff; i++) {
-        rcv->buff[i] = sdr_buff_new(rcv->N * MAX_BUFF, rcv->IQ[i]);
+    return claim;
+}
+
+// release channel lanes of channel block task ---------------------------------
+static void release_lanes(sdr_blk_th_t *bt, uint32_t mask)
+{
+    for (int k = 0; k < bt->nth; k++) {
+        if (!(mask & (1u << k))) continue;
+        __atomic_store_n(&bt->lane[k], 0, __ATOMIC_RELEASE);
     }
-    rcv->ich = -1;
-    pthread_mutex_init(&rcv->mtx, NULL);
-    return rcv;
 }
 
-//------------------------------------------------------------------------------
-//  Free a SDR receiver.
-//
-//  args:
-//      rcv       (I)  SDR receiver generated by sdr_rcv_new()
-//
-//  returns:
-//      none
-//
-void sdr_rcv_free(sdr_rcv_t *rcv)
+// aid tracking loops of SDR receiver channel by PVT --------------------------
+static void aid_ch(sdr_ch_th_t *th)
 {
-    if (!rcv) return;
+    sdr_ch_t *ch = th->ch;
+    float fd, fdot;
     
-    for (int i = 0; i < rcv->nch; i++) {
-        ch_th_free(rcv->th[i]);
+    if (sdr_pvt_pred_dop(th->rcv->pvt, th->ix, ch->sat, ch->fc, &fd,
+        &fdot) == 1) {
+        sdr_ch_aid(ch, th->ix * SDR_CYC, fd, fdot);
     }
-    for (int i = 0; i < rcv->nbuff; i++) {
-        sdr_buff_free(rcv->buff[i]);
-    }
-    sdr_free(rcv);
 }
 
-// read IF data ----------------------------------------------------------------
-static int read_data(sdr_rcv_t *rcv, uint8_t *raw, int N)
+// update status snapshot of SDR receiver channel ------------------------------
+static void update_ch_stat(sdr_ch_th_t *th)
 {
-    if (rcv->dev == SDR_DEV_FILE) { // file input
-        if (fread(raw, N, 1, (FILE *)rcv->dp) < 1) {
-            return 0; // end of file
-        }
+    sdr_ch_t *ch = th->ch;
+    sdr_ch_stat_t *stat = &th->stat;
+    
+    sdr_seq_begin(&stat->seq);
+    stat->state = ch->state;
+    stat->sleep = ch->sleep;
+    stat->sync = (ch->trk->sec_sync > 0) | ((ch->nav->ssync > 0) << 1) |
+        ((ch->nav->fsync > 0) << 2) | ((ch->nav->rev != 0) << 3);
+    stat->time = ch->time;
+    stat->lock = ch->lock * ch->T;
+    stat->cn0 = SDR_CH_CN0(ch);
+    stat->coff = SDR_CH_COFF(ch);
+    stat->fd = SDR_CH_FD(ch);
+    stat->adr = SDR_CH_ADR(ch);
+    stat->nnav = ch->nav->count[0];
+    stat->nerr = ch->nav->count[1];
+    stat->lost = ch->lost;
+    stat->fec = ch->nav->nerr;
+    sdr_seq_end(&stat->seq);
+}
+
+// post-process updated SDR receiver channel -----------------------------------
+//  The channel is updated in nc code cycles (n cycles of IF data per code
+//  cycle).
+static void post_ch(sdr_ch_th_t *th, int nc)
+{
+    sdr_ch_t *ch = th->ch;
+    int n = ch->N / th->N;
+    int64_t ix = th->ix + (int64_t)(nc - 1) * n; // cycle of last code cycle
+    
+    // update navigation data
+    if (ch->nav->stat) {
+        sdr_pvt_udnav(th->rcv->pvt, ch);
+        ch->nav->stat = 0;
     }
-    else { // USB device
-        while (!sdr_dev_read((sdr_dev_t *)rcv->dp, raw, N)) {
-            if (!rcv->state) return 0;
-            sdr_sleep_msec(1);
-        }
+    // update observation data
+    sdr_pvt_udobs(th->rcv->pvt, ix, ch);
+    
+    // output channel log
+    if (ch->state == SDR_STATE_LOCK &&
+        (ix + n - 1) / LOG_CYC > (th->ix - 1) / LOG_CYC) {
+        out_log_ch(ch);
     }
-    return N;
+    // aid tracking loops by PVT in Doppler aiding cycle
+    if (sdr_vt && ch->state == SDR_STATE_LOCK &&
+        (ix + n) / AID_CYC > th->ix / AID_CYC) {
+        aid_ch(th);
+    }
+    update_ch_stat(th);
+    __atomic_store_n(&th->ix, ix + n, __ATOMIC_RELEASE);
 }
 
-// generate lookup table -------------------------------------------------------
-static void gen_LUT(sdr_buff_t **buff, int nbuff, sdr_cpx8_t LUT[][256])
+// test IF data gap in cycles ix, ..., ix + n - 1 ----------------------------
+static int test_gap(sdr_rcv_t *rcv, int64_t ix, int n)
 {
-    static const int8_t valI[] = {1, 3, -1, -3}, valQ[] = {-1, -3, 1, 3};
+    for (int i = 0; i < n; i++) {
+        if (rcv->gap[(ix + i) % rcv->depth]) return 1;
+    }
+    return 0;
+}
+
+// mask of channels with IF data gap in channel block task ---------------------
+static uint32_t gap_mask(sdr_blk_th_t *bt, uint32_t mask, const int *nc)
+{
+    uint32_t gap = 0;
     
-    for (int i = 0; i < 256; i++) {
-        int8_t I[] = {valI[(i>>0) & 0x3], valI[(i>>4) & 0x3]};
-        int8_t Q[] = {valQ[(i>>2) & 0x3], valQ[(i>>6) & 0x3]};
-        for (int j = 0; j < nbuff; j++) {
-            LUT[j][i] = SDR_CPX8(I[j%2], buff[j]->IQ == 1 ? 0 : Q[j%2]);
+    for (int k = 0; k < bt->nth; k++) {
+        sdr_ch_th_t *th = bt->th[k];
+        int n = th->ch->N / th->N;
+        if ((mask & (1u << k)) && test_gap(th->rcv, th->ix, (nc[k] + 1) * n)) {
+            gap |= 1u << k;
         }
     }
+    return gap;
 }
 
-// write IF data buffer ---------------------------------------------------------
-static void write_buff(sdr_rcv_t *rcv, const uint8_t *raw, int64_t ix)
+// recover lapped SDR receiver channel -----------------------------------------
+//  If the IF data to be read by the channel is being overwritten by the
+//  receiver thread, the channel skips to the middle of the IF data buffers in
+//  code cycles with the NCOs coasted.
+static void lap_ch(sdr_ch_th_t *th, int64_t ix)
 {
-    static sdr_cpx8_t LUT[4][256] = {{0}};
-    int i = rcv->N * (int)(ix % MAX_BUFF);
+    sdr_rcv_t *rcv = th->rcv;
+    int n = th->ch->N / th->N;
     
-    if (!LUT[0][0] && (rcv->fmt == SDR_FMT_RAW8 || rcv->fmt == SDR_FMT_RAW16)) {
-        gen_LUT(rcv->buff, rcv->nbuff, LUT);
-    }
-    if (rcv->fmt == SDR_FMT_INT8) { // int8
-        for (int j = 0; j < rcv->N; i++, j++) {
-            rcv->buff[0]->data[i] = SDR_CPX8(raw[j], 0);
+    if (!th->state || ix - th->ix <= rcv->depth - LAP_MARGIN) return;
+    int64_t m = (ix - th->ix - rcv->depth / 2) / n * n; // cycles skipped
+    sdr_ch_coast(th->ch, (th->ix + m - n) * SDR_CYC);
+    __atomic_fetch_add(&rcv->ngap[2], m, __ATOMIC_RELAXED);
+    sdr_log(3, "$LOG,%.3f,%s,%d,CHANNEL LAPPED CH=%d N=%lld", th->ix * SDR_CYC,
+        th->ch->sig, th->ch->prn, th->ch->no, (long long)m * rcv->N);
+    __atomic_store_n(&th->ix, th->ix + m, __ATOMIC_RELEASE);
+}
+
+// update claimed channel lanes of channel block task -------------------------
+static int update_lanes(sdr_blk_th_t *bt, uint32_t mask, int64_t ix)
+{
+    double time[SDR_CH_BLK];
+    const sdr_buff_t *buff[SDR_CH_BLK];
+    int ixs[SDR_CH_BLK], ncyc[SDR_CH_BLK], nc = 0;
+    
+    // recover channels lapped by USB device input without back-pressure
+    for (int k = 0; k < bt->nth; k++) {
+        if ((mask & (1u << k)) && bt->th[k]->rcv->dev == SDR_DEV_USB) {
+            lap_ch(bt->th[k], ix);
         }
     }
-    else if (rcv->fmt == SDR_FMT_INT8X2) { // int8 x 2 complex
-        for (int j = 0; j < rcv->N * 2; i++, j += 2) {
-            rcv->buff[0]->data[i] = SDR_CPX8(raw[j], -raw[j+1]);
-        }
+    for (int k = 0; k < bt->nth; k++) {
+        ncyc[k] = (mask & (1u << k)) ? ncyc_ch(bt->th[k]) : 1;
     }
-    else if (rcv->fmt == SDR_FMT_RAW8) { // packed 8 bit raw (2CH)
-        for (int j = 0; j < rcv->N; i++, j++) {
-            rcv->buff[0]->data[i] = LUT[0][raw[j]];
-            rcv->buff[1]->data[i] = LUT[1][raw[j]];
+    uint32_t gap = gap_mask(bt, mask, ncyc);
+    
+    for (int k = 0; k < bt->nth; k++) {
+        if (!(mask & ~gap & (1u << k))) continue;
+        sdr_ch_th_t *th = bt->th[k];
+        time[k] = th->ix * SDR_CYC;
+        buff[k] = th->buff;
+        ixs[k] = th->N * (int)(th->ix % th->rcv->depth);
+        
+        // down-convert sub-band of IF data to be read
+        if (th->ddc) {
+            sdr_ddc_update(th->ddc, th->ix, (ncyc[k] + 1) * th->ch->N / th->N);
         }
     }
-    else if (rcv->fmt == SDR_FMT_RAW16) { // packed 16 bit raw (4CH)
-        for (int j = 0; j < rcv->N * 2; i++, j += 2) {
-            rcv->buff[0]->data[i] = LUT[0][raw[j  ]];
-            rcv->buff[1]->data[i] = LUT[1][raw[j  ]];
-            rcv->buff[2]->data[i] = LUT[2][raw[j+1]];
-            rcv->buff[3]->data[i] = LUT[3][raw[j+1]];
+    // update SDR receiver channels in channel block
+    if (mask & ~gap) {
+        sdr_ch_blk_update(bt->blk, mask & ~gap, time, buff, ixs, ncyc);
+    }
+    for (int k = 0; k < bt->nth; k++) {
+        if (!(mask & (1u << k))) continue;
+        if (gap & (1u << k)) { // coast channel across IF data gap
+            sdr_ch_coast(bt->th[k]->ch, bt->th[k]->ix * SDR_CYC);
+            ncyc[k] = 1;
         }
+        post_ch(bt->th[k], ncyc[k]);
+        nc++;
     }
-    set_buff_ix(rcv, ix); // update IF data buffer write pointer
+    return nc;
+}
+
+// run SDR receiver channel block task -----------------------------------------
+//  The tracking lanes of the channel block are claimed as a block to keep the
+//  update order of the channels on a worker. Each searching lane is run as a
+//  separate task claimed by its lane flag, so the signal searches of a channel
+//  block are spread over the workers and do not stall the tracking lanes.
+static int run_blk_task(sdr_blk_th_t *bt, int64_t ix)
+{
+    uint32_t mask = due_mask(bt, ix), lanes;
+    int nc = 0;
+    
+    if (!mask) return 0;
+    
+    // tracking lanes as a block
+    if ((mask & ~srch_mask(bt, mask)) &&
+        !__atomic_exchange_n(&bt->busy, 1, __ATOMIC_ACQUIRE)) {
+        while ((mask = due_mask(bt, ix)) &&
+            (lanes = claim_lanes(bt, mask & ~srch_mask(bt, mask), ix))) {
+            nc += update_lanes(bt, lanes, ix);
+            release_lanes(bt, lanes);
+        }
+        __atomic_store_n(&bt->busy, 0, __ATOMIC_RELEASE);
+    }
+    // a searching lane as a task, then yield worker to other tasks
+    mask = due_mask(bt, ix);
+    mask = srch_mask(bt, mask);
+    for (int k = 0; k < bt->nth; k++) {
+        if (!(mask & (1u << k)) || !(lanes = claim_lanes(bt, 1u << k, ix))) {
+            continue;
+        }
+        nc += update_lanes(bt, lanes, ix);
+        release_lanes(bt, lanes);
+        break;
+    }
+    return nc;
+}
+
+// start SDR receiver channel --------------------------------------------------
+static void ch_th_start(sdr_ch_th_t *th)
+{
+    sdr_ch_stat_t *stat = &th->stat;
+    
+    sdr_seq_begin(&stat->seq);
+    stat->no = th->ch->no;
+    stat->rfch = th->ch->rf_ch + 1;
+    snprintf(stat->sat, sizeof(stat->sat), "%s", th->ch->sat);
+    snprintf(stat->sig, sizeof(stat->sig), "%s", th->ch->sig);
+    stat->prn = th->ch->prn;
+    sdr_seq_end(&stat->seq);
+    update_ch_stat(th);
+    th->state = 1;
+}
+
+// stop SDR receiver channel ---------------------------------------------------
+static void ch_th_stop(sdr_ch_th_t *th)
+{
+    th->state = 0;
+}
+
+// SDR receiver worker thread --------------------------------------------------
+//  The channel block tasks are assigned to the workers in round-robin as fixed
+//  task lists shared by all workers. A worker runs the due tasks of its own
+//  list, then scans the lists of the other workers from the tail and runs the
+//  due tasks not claimed by their owners. The tracking lanes of a task are
+//  claimed by its busy flag and each searching lane by its lane flag.
+//  There are no per-worker deques and no tasks are moved among the workers.
+static void *work_thread(void *arg)
+{
+    sdr_work_t *work = (sdr_work_t *)arg;
+    sdr_rcv_t *rcv = work->rcv;
+    
+    // pin worker threads to consecutive CPU cores
+    sdr_set_thread(sdr_work_cpu < 0 ? -1 :
+        (sdr_work_cpu + work->no) % sdr_get_ncpu(), sdr_work_pri);
+    
+    while (work->state) {
+        int64_t ix = get_buff_ix(rcv);
+        int nc = 0;
+        
+        // run own channel block tasks
+        for (int i = 0; i < work->nbt; i++) {
+            nc += run_blk_task(work->bt[i], ix);
+        }
+        // scan channel block tasks of other workers from tail
+        for (int i = 1; i < rcv->nwork && work->state; i++) {
+            sdr_work_t *w = rcv->work[(work->no + i) % rcv->nwork];
+            for (int j = w->nbt - 1; j >= 0; j--) {
+                nc += run_blk_task(w->bt[j], ix);
+            }
+        }
+        if (nc == 0) {
+            wait_buff_ix(rcv, ix, TH_CYC);
+        }
+        else if (rcv->dev == SDR_DEV_FILE) {
+            notify_buff_rd(rcv);
+        }
+    }
+    sdr_scratch_clear();
+    return NULL;
+}
+
+// number of SDR receiver worker threads --------------------------------------
+static int num_work(int nch)
+{
+    int n = sdr_n_work > 0 ? sdr_n_work : sdr_get_ncpu();
+    
+    return MIN(MIN(n, nch), SDR_MAX_WORK);
+}
+
+// join data channels to pilot channels for joint tracking -------------------
+static void join_ch(sdr_rcv_t *rcv)
+{
+    int n = (int)(sizeof(joint_sigs) / sizeof(joint_sigs[0]));
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        const char *sig = NULL;
+        for (int k = 0; k < n; k++) {
+            if (!strcmp(ch->sig, joint_sigs[k][0])) sig = joint_sigs[k][1];
+        }
+        for (int j = 0; sig && j < rcv->nch && !ch->pilot; j++) {
+            sdr_ch_t *pilot = rcv->th[j]->ch;
+            if (strcmp(pilot->sig, sig) || pilot->prn != ch->prn ||
+                rcv->th[j]->buff != rcv->th[i]->buff) continue;
+            sdr_ch_join(ch, pilot);
+        }
+    }
+}
+
+// group SDR receiver channels into channel blocks -----------------------------
+//  A data channel joined to a pilot channel is put next to the pilot channel
+//  in the same channel block.
+static void blk_new(sdr_rcv_t *rcv)
+{
+    sdr_ch_t *chs[SDR_MAX_NCH];
+    int n = 0, npair = 0;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (ch->pilot) continue;
+        chs[n++] = ch;
+        for (int j = 0; j < rcv->nch; j++) {
+            if (rcv->th[j]->ch->pilot != ch) continue;
+            chs[n++] = rcv->th[j]->ch;
+            npair++;
+            break;
+        }
+    }
+    // unpaired data channels joined to the same pilot channel
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (!ch->pilot) continue;
+        int j;
+        for (j = 0; j < n && chs[j] != ch; j++) ;
+        if (j < n) continue;
+        sdr_ch_join(ch, NULL);
+        chs[n++] = ch;
+    }
+    // at least 2 channel blocks per worker to balance loads by task scan
+    int nblk = MAX((rcv->nch + SDR_CH_BLK - 1) / SDR_CH_BLK,
+        MIN(rcv->nch - npair, 2 * num_work(rcv->nch)));
+    if (nblk <= 0) return;
+    int m = MAX((rcv->nch + nblk - 1) / nblk, npair > 0 ? 2 : 1);
+    
+    for (int i = 0; i < n; i++) {
+        int pair = i + 1 < n && chs[i+1]->pilot == chs[i];
+        if (rcv->nblk == 0 || rcv->blk[rcv->nblk-1]->n + 1 + pair > m) {
+            rcv->blk[rcv->nblk++] = sdr_ch_blk_new();
+        }
+        sdr_ch_blk_add(rcv->blk[rcv->nblk-1], chs[i]);
+        if (pair) sdr_ch_blk_add(rcv->blk[rcv->nblk-1], chs[++i]);
+    }
+}
+
+// new SDR receiver worker threads ---------------------------------------------
+static void work_new(sdr_rcv_t *rcv)
+{
+    int n = num_work(rcv->nch);
+    
+    if (n <= 0) return;
+    
+    for (int i = 0; i < n; i++) {
+        sdr_work_t *work = (sdr_work_t *)sdr_malloc(sizeof(sdr_work_t));
+        work->no = i;
+        work->bt = (sdr_blk_th_t **)sdr_malloc(sizeof(sdr_blk_th_t *) *
+            (rcv->nblk / n + 1));
+        work->rcv = rcv;
+        rcv->work[i] = work;
+    }
+    // assign channel blocks to workers in round-robin
+    for (int i = 0; i < rcv->nblk; i++) {
+        sdr_work_t *work = rcv->work[i % n];
+        sdr_blk_th_t *bt = (sdr_blk_th_t *)sdr_malloc(sizeof(sdr_blk_th_t));
+        bt->blk = rcv->blk[i];
+        for (int k = 0; k < bt->blk->n; k++) {
+            bt->th[bt->nth++] = rcv->th[bt->blk->ch[k]->no - 1];
+        }
+        work->bt[work->nbt++] = bt;
+    }
+    rcv->nwork = n;
+}
+
+// free SDR receiver worker threads --------------------------------------------
+static void work_free(sdr_rcv_t *rcv)
+{
+    for (int i = 0; i < rcv->nwork; i++) {
+        for (int j = 0; j < rcv->work[i]->nbt; j++) {
+            sdr_free(rcv->work[i]->bt[j]);
+        }
+        sdr_free(rcv->work[i]->bt);
+        sdr_free(rcv->work[i]);
+    }
+    rcv->nwork = 0;
+}
+
+// NUMA node of most worker threads reading IF data buffer ---------------------
+static int buff_node(sdr_rcv_t *rcv, const sdr_buff_t *buff)
+{
+    int n[SDR_MAX_NODE] = {0}, node = -1;
+    
+    for (int i = 0; i < rcv->nwork; i++) {
+        sdr_work_t *work = rcv->work[i];
+        int k = sdr_mem_node((sdr_work_cpu + work->no) % sdr_get_ncpu());
+        if (k < 0 || k >= SDR_MAX_NODE) continue;
+        for (int j = 0; j < work->nbt; j++) {
+            for (int m = 0; m < work->bt[j]->nth; m++) {
+                sdr_ch_th_t *th = work->bt[j]->th[m];
+                if (th->buff == buff || (th->ddc && th->ddc->src == buff)) {
+                    n[k]++;
+                }
+            }
+        }
+    }
+    for (int k = 0; k < SDR_MAX_NODE; k++) {
+        if (n[k] > 0 && (node < 0 || n[k] > n[node])) node = k;
+    }
+    return node;
+}
+
+// place IF data buffers on NUMA nodes -----------------------------------------
+//  With the option mem_numa and the worker threads pinned to CPU cores, the IF
+//  data buffer of each RF channel and the sub-band DDC buffers are bound to the
+//  NUMA node of most worker threads reading them. The raw data buffers of the
+//  devices are bound to the NUMA node of the receiver thread.
+static void place_buff(sdr_rcv_t *rcv)
+{
+    static const char *pages[] = {"HEAP", "4K", "THP", "2M", "1G"};
+    int numa = sdr_mem_numa && sdr_work_cpu >= 0 && sdr_mem_nnode() > 1;
+    
+    for (int i = 0; i < rcv->nbuff + rcv->nddc; i++) {
+        sdr_buff_t *buff = i < rcv->nbuff ? rcv->buff[i] :
+            rcv->ddc[i - rcv->nbuff]->buff;
+        int node = numa ? buff_node(rcv, buff) : -1;
+        if (node >= 0 && !sdr_mem_bind(buff->data, node)) node = -1;
+        double size = (buff->pack ? (buff->N + 1) / 2 : buff->N) * 1e-6;
+        sdr_log(3, "$LOG,%.3f,%s,%d,MEM %s=%d SIZE=%.1fMB PAGE=%s NODE=%d",
+            0.0, "", 0, i < rcv->nbuff ? "RF" : "DDC", i < rcv->nbuff ? i + 1 :
+            i - rcv->nbuff + 1, size, pages[sdr_mem_page(buff->data)], node);
+    }
+    for (int i = 0; rcv->dev == SDR_DEV_USB && i < rcv->ndev; i++) {
+        sdr_dev_t *dev = (sdr_dev_t *)rcv->dps[i];
+        if (dev->dma || dev->shm) continue;
+        int node = numa && sdr_rcv_cpu >= 0 ? sdr_mem_node(sdr_rcv_cpu) : -1;
+        if (node >= 0 && !sdr_mem_bind(dev->buff, node)) node = -1;
+        sdr_log(3, "$LOG,%.3f,%s,%d,MEM USB=%d SIZE=%.1fMB PAGE=%s NODE=%d",
+            0.0, "", 0, i + 1, (double)dev->size_buff * dev->nbuff * 1e-6,
+            pages[sdr_mem_page(dev->buff)], node);
+    }
+}
+
+// start SDR receiver worker threads -------------------------------------------
+static void work_start(sdr_rcv_t *rcv)
+{
+    for (int i = 0; i < rcv->nwork; i++) {
+        rcv->work[i]->state = 1;
+        pthread_create(&rcv->work[i]->thread, NULL, work_thread, rcv->work[i]);
+    }
+}
+
+// stop SDR receiver worker threads --------------------------------------------
+static void work_stop(sdr_rcv_t *rcv)
+{
+    for (int i = 0; i < rcv->nwork; i++) {
+        rcv->work[i]->state = 0;
+    }
+    pthread_mutex_lock(&rcv->mtx);
+    pthread_cond_broadcast(&rcv->cond);
+    pthread_mutex_unlock(&rcv->mtx);
+    for (int i = 0; i < rcv->nwork; i++) {
+        pthread_join(rcv->work[i]->thread, NULL);
+    }
+}
+
+// set RF channel and IF frequency ---------------------------------------------
+static int set_rfch(int fmt, double fs, const double *fo, const int *IQ,
+    int nrfch, const char *sig, double *fi)
+{
+    double freq = sdr_sig_freq(sig);
+    int rfch = 0;
+    
+    if (fmt == SDR_FMT_RAW8 && nrfch <= 2) { // FE 2CH
+        rfch = freq > 1.4e9 ? 0 : 1;
+    }
+    else if (fmt == SDR_FMT_RAW8 || fmt == SDR_FMT_RAW16) { // FE 4CH or FEs
+        for (int i = 1; i < nrfch; i++) {
+            if (fabs(freq - fo[i]) < fabs(freq - fo[rfch])) rfch = i;
+        }
+    }
+    *fi = fo[rfch] > 0.0 ? freq - fo[rfch] : (IQ[rfch] == 1 ? fs * 0.5 : 0.0);
+    return rfch;
+}
+
+// depth of IF data buffers ----------------------------------------------------
+//  The depth is sized to MEM_BUFF MB of IF data buffers within MIN_BUFF and
+//  MAX_BUFF cycles if not specified by the option n_buff.
+static int buff_depth(int N, int nbuff, int pack)
+{
+    double size = (double)N * nbuff * (pack ? 0.5 : 1.0); // bytes / cyc
+    int depth = sdr_n_buff > 0 ? sdr_n_buff :
+        MAX(MIN_BUFF, MIN(MAX_BUFF, (int)(MEM_BUFF * 1e6 / size)));
+    return MAX(2, MIN(depth, INT32_MAX / N));
+}
+
+// generate a new SDR receiver with IF data buffers of devices -----------------
+//  The RF channels of the devices are ordered by the devices.
+static sdr_rcv_t *rcv_new(const char **sigs, const int *prns, int n, int fmt,
+    double fs, const double *fo, const int *IQ, int ndev)
+{
+    sdr_rcv_t *rcv = (sdr_rcv_t *)sdr_malloc(sizeof(sdr_rcv_t));
+    
+    rcv->fmt = fmt;
+    rcv->fs = fs;
+    for (int i = 0; i < SDR_MAX_RFCH; i++) {
+        rcv->fo[i] = fo[i];
+        rcv->IQ[i] = IQ[i];
+    }
+    rcv->N = (int)(SDR_CYC * fs);
+    rcv->ndev = ndev;
+    rcv->nbuff = ndev * (fmt == SDR_FMT_RAW16 ? 4 : (fmt == SDR_FMT_RAW8 ? 2 :
+        1));
+    
+    // pack 2-bit raw IF data of even samples per cycle
+    int pack = sdr_pack_buff && rcv->nbuff > 1 && rcv->N % 2 == 0;
+    rcv->depth = buff_depth(rcv->N, rcv->nbuff, pack);
+    rcv->gap = (uint8_t *)sdr_malloc(rcv->depth);
+    for (int i = 0; i < rcv->nbuff; i++) {
+        int N = rcv->N * rcv->depth;
+        rcv->buff[i] = pack ? sdr_buff_new_pack(N, rcv->IQ[i]) :
+            sdr_buff_new(N, rcv->IQ[i]);
+        rcv->buff[i]->dft = sdr_dft_cache_new(N_DFT_CACHE);
+        rcv->mon[i] = sdr_mon_new(fs, rcv->IQ[i]);
+    }
+    for (int i = 0; i < n && rcv->nch < SDR_MAX_NCH; i++) {
+        double fi = 0.0;
+        int rfch = set_rfch(fmt, fs, fo, IQ, rcv->nbuff, sigs[i], &fi);
+        sdr_ch_th_t *th = ch_th_new(sigs[i], prns[i], fi, rfch, rcv);
+        if (th) {
+            th->ch->no = rcv->nch + 1;
+            rcv->th[rcv->nch++] = th;
+            
+            // channel woken for signal search in budget of live channels
+            if (sdr_n_live <= 0 || !sdr_ch_sleep(th->ch)) rcv->nlive++;
+        }
+        else {
+            fprintf(stderr, "signal / prn error: %s / %d\n", sigs[i], prns[i]);
+        }
+    }
+    if (sdr_joint) join_ch(rcv);
+    blk_new(rcv);
+    rcv->ich = -1;
+    pthread_mutex_init(&rcv->mtx, NULL);
+    pthread_cond_init(&rcv->cond, NULL);
+    pthread_cond_init(&rcv->cond_rd, NULL);
+    return rcv;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      fmt       (I)  IF data format (SDR_FMT_???)
+//      fs        (I)  sampling rate (sps)
+//      fo        (I)  LO frequency for each RFCH (Hz)
+//      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_new(const char **sigs, const int *prns, int n, int fmt,
+    double fs, const double *fo, const int *IQ)
+{
+    return rcv_new(sigs, prns, n, fmt, fs, fo, IQ, 1);
+}
+
+//------------------------------------------------------------------------------
+//  Free a SDR receiver.
+//
+//  args:
+//      rcv       (I)  SDR receiver generated by sdr_rcv_new()
+//
+//  returns:
+//      none
+//
+void sdr_rcv_free(sdr_rcv_t *rcv)
+{
+    if (!rcv) return;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        ch_th_free(rcv->th[i]);
+    }
+    for (int i = 0; i < rcv->nblk; i++) {
+        sdr_ch_blk_free(rcv->blk[i]);
+    }
+    for (int i = 0; i < rcv->nbuff; i++) {
+        sdr_buff_free(rcv->buff[i]);
+        sdr_mon_free(rcv->mon[i]);
+    }
+    for (int i = 0; i < rcv->nddc; i++) {
+        sdr_ddc_free(rcv->ddc[i]);
+    }
+    sdr_free(rcv->gap);
+    sdr_free(rcv);
+}
+
+// generate lookup table -------------------------------------------------------
+static void gen_LUT(sdr_buff_t **buff, int nbuff, sdr_cpx8_t LUT[][256])
+{
+    static const int8_t valI[] = {1, 3, -1, -3}, valQ[] = {-1, -3, 1, 3};
+    
+    for (int i = 0; i < 256; i++) {
+        int8_t I[] = {valI[(i>>0) & 0x3], valI[(i>>4) & 0x3]};
+        int8_t Q[] = {valQ[(i>>2) & 0x3], valQ[(i>>6) & 0x3]};
+        for (int j = 0; j < nbuff; j++) {
+            LUT[j][i] = SDR_CPX8(I[j%2], buff[j]->IQ == 1 ? 0 : Q[j%2]);
+        }
+    }
+}
+
+#if defined(AVX2)
+// unpack int8 IF data (AVX2) --------------------------------------------------
+SDR_TARGET_AVX2
+static int unpack_int8_avx2(const uint8_t *raw, int N, sdr_cpx8_t *data)
+{
+    int i = 0;
+    __m256i ymask = _mm256_set1_epi8(0x0F);
+    
+    for ( ; i < N - 31; i += 32) {
+        __m256i yraw = _mm256_loadu_si256((__m256i *)(raw + i));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_and_si256(yraw, ymask));
+    }
+    return i;
+}
+
+// unpack int8 x 2 complex IF data (AVX2) --------------------------------------
+SDR_TARGET_AVX2
+static int unpack_int8x2_avx2(const uint8_t *raw, int N, sdr_cpx8_t *data)
+{
+    int i = 0;
+    __m256i yidx = _mm256_set_epi8(15,13,11,9,7,5,3,1, 14,12,10,8,6,4,2,0,
+        15,13,11,9,7,5,3,1, 14,12,10,8,6,4,2,0);
+    __m128i xmaskI = _mm_set1_epi8(0x0F), xmaskQ = _mm_set1_epi8((char)0xF0);
+    
+    for ( ; i < N - 15; i += 16) {
+        __m256i yraw = _mm256_loadu_si256((__m256i *)(raw + i * 2));
+        yraw = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(yraw, yidx), 0xD8);
+        __m128i xI = _mm256_castsi256_si128(yraw);
+        __m128i xQ = _mm_sub_epi8(_mm_setzero_si128(),
+            _mm256_extracti128_si256(yraw, 1));
+        xQ = _mm_and_si128(_mm_slli_epi16(xQ, 4), xmaskQ);
+        _mm_storeu_si128((__m128i *)(data + i),
+            _mm_or_si128(_mm_and_si128(xI, xmaskI), xQ));
+    }
+    return i;
+}
+
+// unpack packed 8 bits raw IF data (2CH, AVX2) -------------------------------
+SDR_TARGET_AVX2
+static int unpack_raw8_avx2(const uint8_t *raw, int N, sdr_cpx8_t LUT[][256],
+    sdr_cpx8_t **data)
+{
+    int i = 0;
+    uint8_t T[2][16];
+    for (int j = 0; j < 16; j++) {
+        T[0][j] = LUT[0][j];
+        T[1][j] = LUT[1][j << 4];
+    }
+    __m256i yT0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *)T[0]));
+    __m256i yT1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i *)T[1]));
+    __m256i ymask = _mm256_set1_epi8(0x0F);
+    
+    for ( ; i < N - 31; i += 32) {
+        __m256i yraw = _mm256_loadu_si256((__m256i *)(raw + i));
+        __m256i ylo = _mm256_and_si256(yraw, ymask);
+        __m256i yhi = _mm256_and_si256(_mm256_srli_epi16(yraw, 4), ymask);
+        _mm256_storeu_si256((__m256i *)(data[0] + i), _mm256_shuffle_epi8(yT0, ylo));
+        _mm256_storeu_si256((__m256i *)(data[1] + i), _mm256_shuffle_epi8(yT1, yhi));
+    }
+    return i;
+}
+
+// unpack packed 16 bits raw IF data (4CH, AVX2) ------------------------------
+SDR_TARGET_AVX2
+static int unpack_raw16_avx2(const uint8_t *raw, int N, sdr_cpx8_t LUT[][256],
+    sdr_cpx8_t **data)
+{
+    int i = 0;
+    uint8_t T[4][16];
+    for (int j = 0; j < 16; j++) {
+        T[0][j] = LUT[0][j];
+        T[1][j] = LUT[1][j << 4];
+        T[2][j] = LUT[2][j];
+        T[3][j] = LUT[3][j << 4];
+    }
+    __m256i yidx = _mm256_set_epi8(15,13,11,9,7,5,3,1, 14,12,10,8,6,4,2,0,
+        15,13,11,9,7,5,3,1, 14,12,10,8,6,4,2,0);
+    __m256i yTlo = _mm256_loadu2_m128i((__m128i *)T[2], (__m128i *)T[0]);
+    __m256i yThi = _mm256_loadu2_m128i((__m128i *)T[3], (__m128i *)T[1]);
+    __m256i ymask = _mm256_set1_epi8(0x0F);
+    
+    for ( ; i < N - 15; i += 16) {
+        __m256i yraw = _mm256_loadu_si256((__m256i *)(raw + i * 2));
+        yraw = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(yraw, yidx), 0xD8);
+        __m256i ylo = _mm256_shuffle_epi8(yTlo, _mm256_and_si256(yraw, ymask));
+        __m256i yhi = _mm256_shuffle_epi8(yThi,
+            _mm256_and_si256(_mm256_srli_epi16(yraw, 4), ymask));
+        _mm_storeu_si128((__m128i *)(data[0] + i), _mm256_castsi256_si128(ylo));
+        _mm_storeu_si128((__m128i *)(data[1] + i), _mm256_castsi256_si128(yhi));
+        _mm_storeu_si128((__m128i *)(data[2] + i), _mm256_extracti128_si256(ylo, 1));
+        _mm_storeu_si128((__m128i *)(data[3] + i), _mm256_extracti128_si256(yhi, 1));
+    }
+    return i;
+}
+#endif // AVX2
+
+// unpack int8 IF data ---------------------------------------------------------
+static void unpack_int8(const uint8_t *raw, int N, sdr_cpx8_t *data)
+{
+    int i = 0;
+#if defined(AVX2)
+    if (sdr_get_simd() >= SDR_SIMD_AVX2) {
+        i = unpack_int8_avx2(raw, N, data);
+    }
+#elif defined(NEON)
+    uint8x16_t ymask = vdupq_n_u8(0x0F);
+    
+    for ( ; i < N - 15; i += 16) {
+        vst1q_u8(data + i, vandq_u8(vld1q_u8(raw + i), ymask));
+    }
+#endif
+    for ( ; i < N; i++) {
+        data[i] = SDR_CPX8(raw[i], 0);
+    }
+}
+
+// unpack int8 x 2 complex IF data ---------------------------------------------
+static void unpack_int8x2(const uint8_t *raw, int N, sdr_cpx8_t *data)
+{
+    int i = 0;
+#if defined(AVX2)
+    if (sdr_get_simd() >= SDR_SIMD_AVX2) {
+        i = unpack_int8x2_avx2(raw, N, data);
+    }
+#elif defined(NEON)
+    uint8x16_t ymask = vdupq_n_u8(0x0F);
+    
+    for ( ; i < N - 15; i += 16) {
+        uint8x16x2_t yraw = vld2q_u8(raw + i * 2);
+        uint8x16_t yQ = vreinterpretq_u8_s8(vnegq_s8(vreinterpretq_s8_u8(
+            yraw.val[1])));
+        vst1q_u8(data + i, vorrq_u8(vandq_u8(yraw.val[0], ymask),
+            vshlq_n_u8(yQ, 4)));
+    }
+#endif
+    for ( ; i < N; i++) {
+        data[i] = SDR_CPX8(raw[i*2], -raw[i*2+1]);
+    }
+}
+
+// unpack packed 8 bits raw IF data (2CH) --------------------------------------
+static void unpack_raw8(const uint8_t *raw, int N, sdr_cpx8_t LUT[][256],
+    sdr_cpx8_t **data)
+{
+    int i = 0;
+#if defined(AVX2)
+    if (sdr_get_simd() >= SDR_SIMD_AVX2) {
+        i = unpack_raw8_avx2(raw, N, LUT, data);
+    }
+#elif defined(NEON)
+    uint8_t T[2][16];
+    for (int j = 0; j < 16; j++) {
+        T[0][j] = LUT[0][j];
+        T[1][j] = LUT[1][j << 4];
+    }
+    uint8x16_t yT0 = vld1q_u8(T[0]), yT1 = vld1q_u8(T[1]);
+    uint8x16_t ymask = vdupq_n_u8(0x0F);
+    
+    for ( ; i < N - 15; i += 16) {
+        uint8x16_t yraw = vld1q_u8(raw + i);
+        vst1q_u8(data[0] + i, vqtbl1q_u8(yT0, vandq_u8(yraw, ymask)));
+        vst1q_u8(data[1] + i, vqtbl1q_u8(yT1, vshrq_n_u8(yraw, 4)));
+    }
+#endif
+    for ( ; i < N; i++) {
+        data[0][i] = LUT[0][raw[i]];
+        data[1][i] = LUT[1][raw[i]];
+    }
+}
+
+// unpack packed 16 bits raw IF data (4CH) -------------------------------------
+static void unpack_raw16(const uint8_t *raw, int N, sdr_cpx8_t LUT[][256],
+    sdr_cpx8_t **data)
+{
+    int i = 0;
+#if defined(AVX2)
+    if (sdr_get_simd() >= SDR_SIMD_AVX2) {
+        i = unpack_raw16_avx2(raw, N, LUT, data);
+    }
+#elif defined(NEON)
+    uint8_t T[4][16];
+    for (int j = 0; j < 16; j++) {
+        T[0][j] = LUT[0][j];
+        T[1][j] = LUT[1][j << 4];
+        T[2][j] = LUT[2][j];
+        T[3][j] = LUT[3][j << 4];
+    }
+    uint8x16_t yT0 = vld1q_u8(T[0]), yT1 = vld1q_u8(T[1]);
+    uint8x16_t yT2 = vld1q_u8(T[2]), yT3 = vld1q_u8(T[3]);
+    uint8x16_t ymask = vdupq_n_u8(0x0F);
+    
+    for ( ; i < N - 15; i += 16) {
+        uint8x16x2_t yraw = vld2q_u8(raw + i * 2);
+        vst1q_u8(data[0] + i, vqtbl1q_u8(yT0, vandq_u8(yraw.val[0], ymask)));
+        vst1q_u8(data[1] + i, vqtbl1q_u8(yT1, vshrq_n_u8(yraw.val[0], 4)));
+        vst1q_u8(data[2] + i, vqtbl1q_u8(yT2, vandq_u8(yraw.val[1], ymask)));
+        vst1q_u8(data[3] + i, vqtbl1q_u8(yT3, vshrq_n_u8(yraw.val[1], 4)));
+    }
+#endif
+    for ( ; i < N; i++) {
+        data[0][i] = LUT[0][raw[i*2  ]];
+        data[1][i] = LUT[1][raw[i*2  ]];
+        data[2][i] = LUT[2][raw[i*2+1]];
+        data[3][i] = LUT[3][raw[i*2+1]];
+    }
+}
+
+// pack packed 8 bits raw IF data (2CH) ---------------------------------------
+//  Nibbles of raw IF data are copied to two samples per byte of packed IF data
+//  buffers. The loop of bitwise operations is auto-vectorized by compiler.
+static void pack_raw8(const uint8_t *raw, int N, uint8_t **data)
+{
+    for (int i = 0; i < N / 2; i++) {
+        uint8_t r0 = raw[i*2], r1 = raw[i*2+1];
+        data[0][i] = (uint8_t)((r0 & 0x0F) | (r1 << 4));
+        data[1][i] = (uint8_t)((r0 >> 4) | (r1 & 0xF0));
+    }
+}
+
+// pack packed 16 bits raw IF data (4CH) ---------------------------------------
+static void pack_raw16(const uint8_t *raw, int N, uint8_t **data)
+{
+    for (int i = 0; i < N / 2; i++) {
+        uint8_t r0 = raw[i*4], r1 = raw[i*4+1], r2 = raw[i*4+2];
+        uint8_t r3 = raw[i*4+3];
+        data[0][i] = (uint8_t)((r0 & 0x0F) | (r2 << 4));
+        data[1][i] = (uint8_t)((r0 >> 4) | (r2 & 0xF0));
+        data[2][i] = (uint8_t)((r1 & 0x0F) | (r3 << 4));
+        data[3][i] = (uint8_t)((r1 >> 4) | (r3 & 0xF0));
+    }
+}
+
+// update IF data monitors of device d -----------------------------------------
+static void update_mon(sdr_rcv_t *rcv, int d, int i, int n)
+{
+    int nb = rcv->nbuff / rcv->ndev;
+    
+    for (int j = d * nb; j < (d + 1) * nb; j++) {
+        sdr_mon_update(rcv->mon[j], rcv->buff[j], i, n);
+    }
+}
+
+// write IF data buffer ---------------------------------------------------------
+//  The IF data of device d are written to the IF data buffers of the device.
+static void write_buff(sdr_rcv_t *rcv, int d, const uint8_t *raw, int size,
+    int i)
+{
+    static sdr_cpx8_t LUT[SDR_MAX_RFCH][256] = {{0}};
+    sdr_cpx8_t *data[4];
+    int n = rcv->fmt == SDR_FMT_INT8X2 || rcv->fmt == SDR_FMT_RAW16 ? size / 2 :
+        size; // number of samples
+    int nb = rcv->nbuff / rcv->ndev;
+    sdr_buff_t **buff = rcv->buff + d * nb;
+    
+    if (buff[0]->pack) { // packed IF data buffers (i, size: even)
+        for (int j = 0; j < nb; j++) {
+            data[j] = buff[j]->data + i / 2;
+        }
+        if (rcv->fmt == SDR_FMT_RAW8) {
+            pack_raw8(raw, size, data);
+        }
+        else {
+            pack_raw16(raw, size / 2, data);
+        }
+        update_mon(rcv, d, i, n);
+        return;
+    }
+    if (!LUT[0][0] && (rcv->fmt == SDR_FMT_RAW8 || rcv->fmt == SDR_FMT_RAW16)) {
+        gen_LUT(rcv->buff, rcv->nbuff, LUT);
+    }
+    for (int j = 0; j < nb; j++) {
+        data[j] = buff[j]->data + i;
+    }
+    if (rcv->fmt == SDR_FMT_INT8) { // int8
+        unpack_int8(raw, size, data[0]);
+    }
+    else if (rcv->fmt == SDR_FMT_INT8X2) { // int8 x 2 complex
+        unpack_int8x2(raw, size / 2, data[0]);
+    }
+    else if (rcv->fmt == SDR_FMT_RAW8) { // packed 8 bit raw (2CH)
+        unpack_raw8(raw, size, LUT + d * nb, data);
+    }
+    else if (rcv->fmt == SDR_FMT_RAW16) { // packed 16 bit raw (4CH)
+        unpack_raw16(raw, size / 2, LUT + d * nb, data);
+    }
+    update_mon(rcv, d, i, n);
+}
+
+// read IF data and write IF data buffer ---------------------------------------
+static int read_data(sdr_rcv_t *rcv, uint8_t *raw, int size, int64_t ix)
+{
+    int i = rcv->N * (int)(ix % rcv->depth), ns = size / rcv->N;
+    
+    // invalidate data DFTs overlapping IF data to write
+    for (int j = 0; j < rcv->nbuff; j++) {
+        sdr_dft_cache_inval(rcv->buff[j], i, rcv->N);
+    }
+    if (rcv->dev == SDR_DEV_FILE) { // file input
+        uint8_t *data;
+        int64_t t0 = sdr_get_tick_ns();
+        
+        if (sdr_file_read((sdr_file_t *)rcv->dp, size, &data) < size) {
+            return 0; // end of file
+        }
+        sdr_perf_add(SDR_PERF_READ, t0);
+        t0 = sdr_get_tick_ns();
+        write_buff(rcv, 0, data, size, i);
+        sdr_perf_add(SDR_PERF_WRITE, t0);
+        rcv->gap[ix % rcv->depth] = 0;
+        
+        // write IF data log stream
+        rcv->data_sum += sdr_ostr_write(rcv->strs[3], data, size) * 1e-6;
+    }
+    else { // USB devices (unpack IF data in transfer buffers without copy)
+        int err = 0;
+        
+        for (int d = 0; d < rcv->ndev; d++) {
+            sdr_dev_t *dev = (sdr_dev_t *)rcv->dps[d];
+            uint8_t *data;
+            int n;
+            int64_t t0 = sdr_get_tick_ns();
+            
+            while (!sdr_dev_wait(dev, size, 100)) {
+                if (!rcv->state) return 0;
+            }
+            sdr_perf_add(SDR_PERF_READ, t0);
+            for (int j = 0; j < size && (n = sdr_dev_peek(dev, size - j,
+                &data)); j += n) {
+                t0 = sdr_get_tick_ns();
+                write_buff(rcv, d, data, n, i + j / ns);
+                sdr_perf_add(SDR_PERF_WRITE, t0);
+                
+                // IF data log stream of the first device
+                if (d == 0) {
+                    rcv->data_sum += sdr_ostr_write(rcv->strs[3], data, n) *
+                        1e-6;
+                }
+                err |= !sdr_dev_check(dev, n);
+                sdr_dev_consume(dev, n);
+            }
+        }
+        // mark IF data cycle with transfer error or overwritten as gap
+        rcv->gap[ix % rcv->depth] = (uint8_t)err;
+        rcv->ngap[1] += err;
+    }
+    set_buff_ix(rcv, ix); // update IF data buffer write pointer
+    return size;
 }
 
 // re-acquisition --------------------------------------------------------------
-static int re_acq(sdr_rcv_t *rcv, sdr_ch_t *ch)
+static int re_acq(sdr_rcv_t *rcv, sdr_ch_t *ch, float *fd)
 {
     if (ch->lock * ch->T >= MIN_LOCK &&
         get_buff_ix(rcv) * SDR_CYC < ch->time + TO_REACQ) {
-        ch->acq->fd_ext = ch->fd;
+        *fd = (float)SDR_CH_FD(ch);
         return 1;
     }
     return 0;
 }
 
 // assisted acquisition --------------------------------------------------------
-static int assist_acq(sdr_rcv_t *rcv, sdr_ch_t *ch)
+static int assist_acq(sdr_rcv_t *rcv, sdr_ch_t *ch, float *fd)
 {
     for (int i = 0; i < rcv->nch; i++) {
         sdr_ch_t *ch_i = rcv->th[i]->ch;
         if (strcmp(ch->sat, ch_i->sat) || ch_i->state != SDR_STATE_LOCK ||
             ch_i->lock * ch_i->T < MIN_LOCK) continue;
-        ch->acq->fd_ext = ch_i->fd * ch->fc / ch_i->fc;
+        *fd = (float)(SDR_CH_FD(ch_i) * ch->fc / ch_i->fc);
         return 1;
     }
-    return 0;
+    return 0;
+}
+
+// update IF data rate ---------------------------------------------------------
+static uint32_t update_data_rate(sdr_rcv_t *rcv, uint32_t tick, int sum_size)
+{
+    uint32_t tick_a = sdr_get_tick();
+    if (tick_a == tick) return tick;
+    rcv->data_rate = (double)sum_size / ((tick_a - tick) * 1e-3);
+    return tick_a;
+}
+
+// IF data buffer usage rate ---------------------------------------------------
+static double buff_use(sdr_rcv_t *rcv, int64_t ix)
+{
+    double use_max = 0.0;
+    for (int i = 0; i < rcv->nch; i++) {
+        double use = (ix - rcv->th[i]->ix) * 100.0 / rcv->depth;
+        if (use > use_max) use_max = use;
+    }
+    return use_max;
+}
+
+// update IF data buffer usage rate --------------------------------------------
+static void update_buff_use(sdr_rcv_t *rcv)
+{
+    rcv->buff_use = buff_use(rcv, get_buff_ix(rcv));
+}
+
+// update peak IF data buffer usage rate ---------------------------------------
+static void update_buff_max(sdr_rcv_t *rcv, int64_t ix)
+{
+    double use = buff_use(rcv, ix);
+    if (use > rcv->buff_max) rcv->buff_max = use;
+}
+
+// update SDR receiver status snapshot -----------------------------------------
+static void update_rcv_stat(sdr_rcv_t *rcv, int64_t ix)
+{
+    static const int idx[] = {0, 1, 3};
+    sdr_rcv_stat_t *stat = &rcv->stat;
+    
+    sdr_seq_begin(&stat->seq);
+    stat->state = rcv->state;
+    stat->dev = rcv->dev;
+    stat->fmt = rcv->fmt;
+    stat->nrf = rcv->nbuff;
+    stat->time = ix * SDR_CYC;
+    stat->fs = rcv->fs;
+    for (int i = 0; i < SDR_MAX_RFCH; i++) {
+        stat->fo[i] = rcv->fo[i];
+        stat->IQ[i] = rcv->IQ[i];
+    }
+    memset(stat->sys, 0, sizeof(stat->sys));
+    stat->nch = rcv->nch;
+    stat->ntrk = get_nch_trk(rcv, stat->sys);
+    stat->nsrch = rcv->nsrch;
+    stat->nlive = rcv->nlive;
+    stat->data_rate = rcv->data_rate * 1e-6;
+    stat->data_sum = rcv->data_sum;
+    stat->buff_use = rcv->buff_use;
+    stat->buff_max = rcv->buff_max;
+    stat->usb_max = usb_buff_max(rcv);
+    for (int i = 0; i < 3; i++) {
+        const sdr_ostr_t *ostr = rcv->strs[idx[i]];
+        stat->ngap[i] = __atomic_load_n(&rcv->ngap[i], __ATOMIC_RELAXED);
+        stat->ndrop[i] = ostr ? __atomic_load_n(&ostr->ndrop,
+            __ATOMIC_RELAXED) : -1;
+    }
+    sdr_seq_end(&stat->seq);
+}
+
+// PVT-assisted acquisition ----------------------------------------------------
+static int pvt_acq(sdr_rcv_t *rcv, sdr_ch_t *ch, float *fd)
+{
+    if (!rcv->pvt) return -1;
+    return sdr_pvt_pred_dop(rcv->pvt, get_buff_ix(rcv), ch->sat, ch->fc, fd,
+        NULL);
+}
+
+// signal search priority ------------------------------------------------------
+//  0: re-acquisition, 1: assisted-acquisition, 2: PVT-assisted acquisition,
+//  3: blind search of short code cycle or long code cycle by decimated search,
+//  -1: not searchable
+static int srch_prio(sdr_rcv_t *rcv, sdr_ch_t *ch, float *fd)
+{
+    *fd = 0.0f;
+    if (ch->state != SDR_STATE_IDLE || ch->pilot) return -1;
+    if (re_acq(rcv, ch, fd)) return 0;
+    if (assist_acq(rcv, ch, fd)) return 1;
+    switch (pvt_acq(rcv, ch, fd)) {
+        case 1: return 2;
+        case 0: return -1; // below elevation mask or unhealthy
+    }
+    *fd = 0.0f;
+    return (ch->T <= MAX_ACQ || ch->acq->D > 0) ? 3 : -1;
+}
+
+// number of signal search slots -----------------------------------------------
+//  The max number of slots is reduced linearly by the IF data buffer usage.
+static int srch_slots(sdr_rcv_t *rcv)
+{
+    if (rcv->buff_use > MAX_BUFF_USE) return 0; // IF data buffer full ?
+    int n = (int)ceil((double)sdr_n_srch * (MAX_BUFF_USE - rcv->buff_use) /
+        MAX_BUFF_USE);
+    return MAX(1, MIN(n, sdr_n_srch));
+}
+
+// number of sleeping channels of SDR receiver channel and joined channels -----
+static int num_sleep(sdr_rcv_t *rcv, const sdr_ch_t *ch)
+{
+    int n = ch->sleep;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        const sdr_ch_t *ch_i = rcv->th[i]->ch;
+        if (ch_i->pilot == ch && ch_i->sleep) n++;
+    }
+    return n;
+}
+
+// put SDR receiver channel to sleep with joined data channels -----------------
+//  The channel is not put to sleep until the joined data channels are IDLE.
+static int sleep_ch(sdr_rcv_t *rcv, sdr_ch_t *ch)
+{
+    for (int i = 0; i < rcv->nch; i++) {
+        const sdr_ch_t *ch_i = rcv->th[i]->ch;
+        if (ch_i->pilot == ch && ch_i->state != SDR_STATE_IDLE) return 0;
+    }
+    if (!sdr_ch_sleep(ch)) return 0;
+    rcv->nlive--;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch_i = rcv->th[i]->ch;
+        if (ch_i->pilot == ch && sdr_ch_sleep(ch_i)) rcv->nlive--;
+    }
+    return 1;
+}
+
+// test SDR receiver channel to be put to sleep --------------------------------
+static int test_sleep(sdr_rcv_t *rcv, sdr_ch_t *ch)
+{
+    float fd;
+    
+    return !ch->pilot && !ch->sleep && ch->state == SDR_STATE_IDLE &&
+        !re_acq(rcv, ch, &fd);
+}
+
+// wake SDR receiver channel with joined data channels -------------------------
+//  If the live channels are over the budget, IDLE channels not to be
+//  re-acquired are put to sleep to make room for the channels.
+static int wake_ch(sdr_rcv_t *rcv, sdr_ch_t *ch)
+{
+    int n = num_sleep(rcv, ch);
+    
+    if (n == 0) return 1;
+    
+    for (int i = 0; i < rcv->nch && rcv->nlive + n > sdr_n_live; i++) {
+        sdr_ch_t *ch_i = rcv->th[i]->ch;
+        if (ch_i != ch && test_sleep(rcv, ch_i)) sleep_ch(rcv, ch_i);
+    }
+    if (rcv->nlive + n > sdr_n_live || !sdr_ch_wake(ch)) return 0;
+    rcv->nlive++;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch_i = rcv->th[i]->ch;
+        if (ch_i->pilot == ch && ch_i->sleep && sdr_ch_wake(ch_i)) {
+            rcv->nlive++;
+        }
+    }
+    return 1;
+}
+
+// update live channels --------------------------------------------------------
+//  The IDLE channels of the satellites predicted below the elevation mask or
+//  unhealthy by PVT are put to sleep except for the re-acquisition. The
+//  channels are woken by the signal search in the budget of live channels.
+static void update_live_ch(sdr_rcv_t *rcv)
+{
+    float fd;
+    
+    if (sdr_n_live <= 0) return;
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        sdr_ch_t *ch = rcv->th[i]->ch;
+        if (test_sleep(rcv, ch) && pvt_acq(rcv, ch, &fd) == 0) {
+            sleep_ch(rcv, ch);
+        }
+    }
+}
+
+// update signal search channels -----------------------------------------------
+static void update_srch_ch(sdr_rcv_t *rcv)
+{
+    int nsrch = 0, ich[4][SDR_MAX_NCH], n[4] = {0};
+    float fd[4][SDR_MAX_NCH];
+    
+    for (int i = 0; i < rcv->nch; i++) {
+        if (rcv->th[i]->ch->state == SDR_STATE_SRCH) nsrch++;
+    }
+    int slots = srch_slots(rcv) - nsrch;
+    
+    // priority queue of IDLE channels in round-robin order
+    for (int i = 0; i < rcv->nch && slots > 0; i++) {
+        int j = (rcv->ich + 1 + i) % rcv->nch, k;
+        float fd_j;
+        if ((k = srch_prio(rcv, rcv->th[j]->ch, &fd_j)) < 0) continue;
+        fd[k][n[k]] = fd_j;
+        ich[k][n[k]++] = j;
+    }
+    for (int k = 0; k < 4 && slots > 0; k++) {
+        for (int i = 0; i < n[k] && slots > 0; i++) {
+            sdr_ch_t *ch = rcv->th[ich[k][i]]->ch;
+            if (sdr_n_live > 0 && !wake_ch(rcv, ch)) continue;
+            ch->acq->ext = k < 3;
+            ch->acq->fd_ext = fd[k][i];
+            ch->acq->max_dop_ext = k == 2 ? MAX_DOP_PVT : 0.0f;
+            ch->state = SDR_STATE_SRCH;
+            if (k == 3) rcv->ich = ich[k][i]; // next blind search
+            nsrch++;
+            slots--;
+        }
+    }
+    rcv->nsrch = nsrch;
+}
+
+// output log of dropped USB transfers and IF data errors ----------------------
+//  cnt: counts of dropped and out-of-sequence transfers and IF data error
+//  cycles at the last output
+static void out_log_drop(sdr_rcv_t *rcv, int64_t ix, int64_t *cnt)
+{
+    if (rcv->dev != SDR_DEV_USB) return;
+    int64_t n[3] = {0, 0, rcv->ngap[1]};
+    for (int i = 0; i < rcv->ndev; i++) {
+        sdr_dev_t *dev = (sdr_dev_t *)rcv->dps[i];
+        n[0] += __atomic_load_n(&dev->ndrop, __ATOMIC_RELAXED);
+        n[1] += __atomic_load_n(&dev->nseq, __ATOMIC_RELAXED);
+    }
+    if (n[0] > cnt[0]) {
+        sdr_log(3, "$LOG,%.3f,%s,%d,USB TRANSFER DROPPED N=%d", ix * SDR_CYC,
+            "", 0, (int)(n[0] - cnt[0]));
+    }
+    if (n[1] > cnt[1]) {
+        sdr_log(3, "$LOG,%.3f,%s,%d,USB TRANSFER OUT OF SEQUENCE N=%d",
+            ix * SDR_CYC, "", 0, (int)(n[1] - cnt[1]));
+    }
+    if (n[2] > cnt[2]) {
+        sdr_log(3, "$LOG,%.3f,%s,%d,IF DATA GAP (ERROR) N=%lld", ix * SDR_CYC,
+            "", 0, (long long)(n[2] - cnt[2]) * rcv->N);
+    }
+    memcpy(cnt, n, sizeof(n));
 }
 
-// update IF data rate ---------------------------------------------------------
-static uint32_t update_data_rate(sdr_rcv_t *rcv, uint32_t tick, int sum_size)
+// drop IF data of device -----------------------------------------------------
+static void drop_data(sdr_rcv_t *rcv, sdr_dev_t *dev, int64_t size)
 {
-    uint32_t tick_a = sdr_get_tick();
-    if (tick_a == tick) return tick;
-    rcv->data_rate = (double)sum_size / ((tick_a - tick) * 1e-3);
-    return tick_a;
+    while (size > 0 && rcv->state) {
+        int n = (int)MIN(size, (int64_t)SDR_SIZE_BUFF);
+        if (!sdr_dev_wait(dev, n, 100)) continue;
+        sdr_dev_consume(dev, n);
+        size -= n;
+    }
 }
 
-// update IF data buffer usage rate --------------------------------------------
-static void update_buff_use(sdr_rcv_t *rcv)
+// align IF data of devices by time of first USB transfers ---------------------
+//  The devices should share the reference clock. The IF data of the devices
+//  started earlier are dropped by the start time differences to align the
+//  sample clocks within the jitter of the USB transfers.
+static void align_dev(sdr_rcv_t *rcv, int ns)
 {
-    rcv->buff_use = 0.0;
-    int64_t ix = get_buff_ix(rcv);
-    for (int i = 0; i < rcv->nch; i++) {
-        double use = (ix - rcv->th[i]->ix) * 100.0 / MAX_BUFF;
-        if (use > rcv->buff_use) rcv->buff_use = use;
+    int64_t t0[SDR_MAX_DEV], t_max = 0;
+    
+    for (int i = 0; i < rcv->ndev; i++) {
+        sdr_dev_t *dev = (sdr_dev_t *)rcv->dps[i];
+        while (!sdr_dev_wait(dev, 1, 100)) {
+            if (!rcv->state) return;
+        }
+        t0[i] = __atomic_load_n(&dev->t0, __ATOMIC_RELAXED);
+        t_max = MAX(t_max, t0[i]);
+    }
+    for (int i = 0; i < rcv->ndev; i++) {
+        int64_t n = (int64_t)((t_max - t0[i]) * 1e-9 * rcv->fs) / 2 * 2;
+        drop_data(rcv, (sdr_dev_t *)rcv->dps[i], n * ns);
+        sdr_log(3, "$LOG,%.3f,%s,%d,DEVICE %d ALIGNED SKIP=%lld", 0.0, "", 0,
+            i + 1, (long long)n);
     }
 }
 
-// update signal search channel ------------------------------------------------
-static void update_srch_ch(sdr_rcv_t *rcv)
+// skip IF data cycles lost by overrun of USB transfer buffers -----------------
+//  The cycles skipped are marked as gaps and the IF data buffer pointer is
+//  advanced to keep the sample count of the receiver time. The same cycles are
+//  skipped in all devices to keep the devices aligned.
+static int64_t skip_gap(sdr_rcv_t *rcv, int64_t ix, int size)
 {
-    if (rcv->buff_use > MAX_BUFF_USE) { // IF data buffer full ?
-        return;
+    int64_t skip[SDR_MAX_DEV];
+    int n = 0;
+    
+    for (int i = 0; i < rcv->ndev; i++) {
+        skip[i] = sdr_dev_sync((sdr_dev_t *)rcv->dps[i], size) / size;
+        n = MAX(n, (int)skip[i]);
     }
-    // signal search channel busy ?
-    if (rcv->ich >= 0 && rcv->th[rcv->ich]->ch->state == SDR_STATE_SRCH) {
-        return;
+    for (int i = 0; i < rcv->ndev && n > 0; i++) {
+        drop_data(rcv, (sdr_dev_t *)rcv->dps[i], (n - skip[i]) * size);
     }
-    for (int i = 0; i < rcv->nch; i++) {
-        // search next IDLE channel
-        rcv->ich = (rcv->ich + 1) % rcv->nch;
-        sdr_ch_t *ch = rcv->th[rcv->ich]->ch;
-        if (ch->state != SDR_STATE_IDLE) continue;
-        
-        // re-acquisition, assisted-acquisition or short code cycle
-        if (re_acq(rcv, ch) || assist_acq(rcv, ch) || ch->T <= MAX_ACQ) {
-            ch->state = SDR_STATE_SRCH;
-            break;
+    for (int i = 0; i < n; i++, ix++) {
+        for (int j = 0; j < rcv->nbuff; j++) {
+            sdr_dft_cache_inval(rcv->buff[j], rcv->N * (int)(ix % rcv->depth),
+                rcv->N);
         }
+        rcv->gap[ix % rcv->depth] = 1;
+        set_buff_ix(rcv, ix);
+    }
+    if (n > 0) {
+        rcv->ngap[0] += n;
+        sdr_log(3, "$LOG,%.3f,%s,%d,IF DATA GAP (OVERRUN) N=%lld",
+            (ix - n) * SDR_CYC, "", 0, (long long)n * rcv->N);
     }
+    return ix;
 }
 
 // SDR receiver thread ---------------------------------------------------------
@@ -622,51 +2102,101 @@ static void *rcv_thread(void *arg)
     int size, sum_size = 0;
     uint8_t *raw = (uint8_t *)sdr_malloc(ns * rcv->N);
     uint32_t tick = sdr_get_tick(), tick_r = tick;
+    int64_t cnt[3] = {0};
+    
+    sdr_set_thread(sdr_rcv_cpu, sdr_rcv_pri);
     
     sdr_log(3, "$LOG,%.3f,%s,%d,START NCH=%d FMT=%d", 0.0, "", 0, rcv->nch,
         rcv->fmt);
     
     if (rcv->dev == SDR_DEV_USB) {
-        sdr_dev_start((sdr_dev_t *)rcv->dp);
+        for (int i = 0; i < rcv->ndev; i++) {
+            sdr_dev_start((sdr_dev_t *)rcv->dps[i]);
+        }
+        if (rcv->ndev > 1) align_dev(rcv, ns);
     }
     rcv->data_sum = 0.0;
     
     for (int64_t ix = 0; rcv->state; ix++) {
+        // wait for IF data buffer read not to overwrite unread data
+        if (rcv->dev == SDR_DEV_FILE) {
+            wait_buff_rd(rcv, ix, rcv->depth - 1);
+        }
         if (ix % LOG_CYC == 0) {
             update_buff_use(rcv);
             tick_r = update_data_rate(rcv, tick_r, sum_size);
             sum_size = 0;
             out_log_time(ix * SDR_CYC);
+            out_log_drop(rcv, ix, cnt);
+        }
+        if (ix % STAT_CYC == 0) {
+            update_rcv_stat(rcv, ix);
+        }
+        // end of output window of file replay
+        if (rcv->ix_end > 0 && ix >= rcv->ix_end + SEG_LAG) {
+            rcv->state = 0;
+            continue;
+        }
+        // skip IF data lost by overrun of USB transfer buffers
+        if (rcv->dev == SDR_DEV_USB) {
+            ix = skip_gap(rcv, ix, ns * rcv->N);
         }
-        // read IF data
-        if (!(size = read_data(rcv, raw, ns * rcv->N))) {
+        // read IF data and write IF data buffer
+        if (!(size = read_data(rcv, raw, ns * rcv->N, ix))) {
             sdr_sleep_msec(500);
             rcv->state = 0;
             continue;
         }
         sum_size += size;
+        update_buff_max(rcv, ix);
         
-        // write IF data buffer
-        write_buff(rcv, raw, ix);
-        
-        // write IF data log stream
-        rcv->data_sum += sdr_str_write(rcv->strs[3], raw, size) * 1e-6;
-        
-        // update signal search channel
+        // wait for all channels updated in max speed replay of file to get
+        // deterministic results as real-time
+        if (rcv->dev == SDR_DEV_FILE && rcv->tscale <= 0.0) {
+            wait_buff_rd(rcv, ix, 0);
+        }
+        // update live channels and signal search channels
+        if (ix % LIVE_CYC == 0) {
+            update_live_ch(rcv);
+        }
         update_srch_ch(rcv);
         
         // update PVT solution
         sdr_pvt_udsol(rcv->pvt, ix);
         
         // sleep if reading file
-        if (rcv->dev == SDR_DEV_FILE) {
+        if (rcv->dev == SDR_DEV_FILE && rcv->tscale > 0.0) {
             sdr_sleep_msec((int)(ix - (sdr_get_tick() - tick) * rcv->tscale));
         }
     }
-    if (rcv->dev == SDR_DEV_USB) {
-        sdr_dev_stop((sdr_dev_t *)rcv->dp);
+    for (int i = 0; rcv->dev == SDR_DEV_USB && i < rcv->ndev; i++) {
+        sdr_dev_stop((sdr_dev_t *)rcv->dps[i]);
+    }
+    update_rcv_stat(rcv, get_buff_ix(rcv));
+    int64_t stat[4];
+    sdr_alloc_stat(stat);
+    sdr_log(3, "$LOG,%.3f,%s,%d,STOP HEAP=%d/%d SCRATCH=%d/%d",
+        get_buff_ix(rcv) * SDR_CYC, "", 0, (int)stat[0], (int)stat[1],
+        (int)stat[2], (int)stat[3]);
+    double mem[SDR_N_MEM];
+    sdr_mem_stat(mem);
+    sdr_log(3, "$LOG,%.3f,%s,%d,MEM TOTAL=%.1fMB 4K=%.1fMB THP=%.1fMB "
+        "2M=%.1fMB 1G=%.1fMB LOCK=%.1fMB NUMA=%.1fMB NODE=%d",
+        get_buff_ix(rcv) * SDR_CYC, "", 0, mem[0], mem[1], mem[2], mem[3],
+        mem[4], mem[5], mem[6], (int)mem[7]);
+    sdr_log(3, "$LOG,%.3f,%s,%d,BUFF DEPTH=%d PEAK=%.1f%% USB PEAK=%.1f%%",
+        get_buff_ix(rcv) * SDR_CYC, "", 0, rcv->depth, rcv->buff_max,
+        usb_buff_max(rcv));
+    sdr_log(3, "$LOG,%.3f,%s,%d,IF DATA GAP OVERRUN=%lld ERROR=%lld "
+        "LAPPED=%lld", get_buff_ix(rcv) * SDR_CYC, "", 0,
+        (long long)rcv->ngap[0] * rcv->N, (long long)rcv->ngap[1] * rcv->N,
+        (long long)rcv->ngap[2] * rcv->N);
+    for (int i = 0; i < rcv->nbuff; i++) {
+        sdr_dft_cache_t *dft = rcv->buff[i]->dft;
+        sdr_log(3, "$LOG,%.3f,%s,%d,DFT CACHE RF=%d HIT=%d MISS=%d",
+            get_buff_ix(rcv) * SDR_CYC, "", 0, i + 1, (int)dft->nhit,
+            (int)dft->nmiss);
     }
-    sdr_log(3, "$LOG,%.3f,%s,%d,STOP", get_buff_ix(rcv) * SDR_CYC, "", 0);
     sdr_free(raw);
     return NULL;
 }
@@ -677,12 +2207,13 @@ static void *rcv_thread(void *arg)
 //  args:
 //      rcv       (I)  SDR receiver
 //      dev       (I)  SDR device type (SDR_DEV_???)
-//      dp        (I)  SDR device pointer
+//      dp        (I)  SDR device pointer (sdr_dev_t * or sdr_file_t *)
 //      paths     (I)  output stream paths ("": no output)
 //                       paths[0]: NMEA PVT solutions stream
 //                       paths[1]: RTCM3 OBS and NAV data stream
 //                       paths[2]: log stream
 //                       paths[3]: IF data log stream
+//                       paths[4]: fast-rate PVT solutions stream
 //
 //  returns:
 //      Status (1:OK, 0:error)
@@ -693,18 +2224,36 @@ int sdr_rcv_start(sdr_rcv_t *rcv, int dev, void *dp, const char **paths)
     
     sdr_log_open(paths[2]);
     
+    // decode nav data synchronously for max speed replay of IF data file
+    sdr_nav_async(dev == SDR_DEV_FILE && rcv->tscale <= 0.0 ? 0 : sdr_n_nav);
+    
     for (int i = 0; i < rcv->nch; i++) {
         ch_th_start(rcv->th[i]);
     }
     rcv->dev = dev;
-    rcv->dp = dp;
+    rcv->dp = rcv->dps[0] = dp;
     rcv->pvt = sdr_pvt_new(rcv);
-    for (int i = 0; i < 4; i++) {
-        if (i != 2 && *paths[i] && !(rcv->strs[i] = sdr_str_open(paths[i]))) {
+    work_new(rcv);
+    place_buff(rcv);
+    work_start(rcv);
+    sdr_perf_reset();
+    rcv->perf_t0 = sdr_get_tick_ns();
+    
+    // PVT thread except for max speed replay of IF data file
+    if (dev != SDR_DEV_FILE || rcv->tscale > 0.0) {
+        sdr_pvt_start(rcv->pvt);
+    }
+    // output streams (drop data if full for RF frontend)
+    int opt = dev == SDR_DEV_USB ? SDR_OSTR_DROP : 0;
+    for (int i = 0; i < 5; i++) {
+        int size = i == 3 ? OSTR_SIZE_IF : OSTR_SIZE;
+        if (i != 2 && *paths[i] &&
+            !(rcv->strs[i] = sdr_ostr_open(paths[i], size, opt))) {
             fprintf(stderr, "stream open error: %s", paths[i+1]);
         }
     }
     rcv->state = 1;
+    update_rcv_stat(rcv, 0);
     return !pthread_create(&rcv->thread, NULL, rcv_thread, rcv);
 }
 
@@ -722,29 +2271,105 @@ void sdr_rcv_stop(sdr_rcv_t *rcv)
     for (int i = 0; i < rcv->nch; i++) {
         ch_th_stop(rcv->th[i]);
     }
-    for (int i = 0; i < rcv->nch; i++) {
-        pthread_join(rcv->th[i]->thread, NULL);
-    }
+    work_stop(rcv);
+    work_free(rcv);
     rcv->state = 0;
     pthread_join(rcv->thread, NULL);
-    for (int i = 0; i < 4; i++) {
-        sdr_str_close(rcv->strs[i]);
-    }
+    sdr_nav_async(0);
     sdr_pvt_free(rcv->pvt);
+    rcv->pvt = NULL;
+    for (int i = 0; i < 5; i++) {
+        sdr_ostr_close(rcv->strs[i]);
+        rcv->strs[i] = NULL;
+    }
+    sdr_fftw_export();
+    sdr_code_book_save();
     sdr_log_close();
 }
 
 // get and set LNA gain of RF frontend -----------------------------------------
+//  The RF channels of the devices are numbered in the order of the devices.
 int sdr_rcv_get_gain(sdr_rcv_t *rcv, int ch)
 {
-    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB) return -1;
-    return sdr_dev_get_gain((sdr_dev_t *)rcv->dp, ch);
+    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB || ch < 0 ||
+        ch >= rcv->nbuff) {
+        return -1;
+    }
+    int nb = rcv->nbuff / rcv->ndev;
+    return sdr_dev_get_gain((sdr_dev_t *)rcv->dps[ch / nb], ch % nb);
 }
 
 int sdr_rcv_set_gain(sdr_rcv_t *rcv, int ch, int gain)
 {
-    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB) return -1;
-    return sdr_dev_set_gain((sdr_dev_t *)rcv->dp, ch, gain);
+    if (!rcv || !rcv->state || rcv->dev != SDR_DEV_USB || ch < 0 ||
+        ch >= rcv->nbuff) {
+        return -1;
+    }
+    int nb = rcv->nbuff / rcv->ndev;
+    return sdr_dev_set_gain((sdr_dev_t *)rcv->dps[ch / nb], ch % nb, gain);
+}
+
+// set USB transfer buffers and event handler thread --------------------------
+//  The transfer buffers span T_USB_BUFF s of raw IF data at the sampling rate
+//  if not specified by the options usb_nbuff and usb_size. The event handler
+//  threads of multiple devices are assigned to consecutive CPUs. The frame
+//  headers of the USB transfers are requested by the option usb_frame.
+static int set_usb_buff(sdr_dev_t *dev, int fmt, double fs, int d)
+{
+    double rate = fs * (fmt == SDR_FMT_RAW8 ? 1 : 2); // bytes / s
+    int size = sdr_usb_size > 0 ? sdr_usb_size : SDR_SIZE_BUFF;
+    int nbuff = sdr_usb_nbuff > 0 ? sdr_usb_nbuff :
+        MAX(MIN_USB_BUFF, (int)ceil(rate * T_USB_BUFF / size));
+    sdr_dev_set_thread(dev, sdr_usb_cpu >= 0 ? sdr_usb_cpu + d : sdr_usb_cpu,
+        sdr_usb_pri);
+    sdr_dev_set_frame(dev, sdr_usb_frame);
+    return sdr_dev_set_buff(dev, nbuff, size);
+}
+
+// open SDR device and get device info -----------------------------------------
+static sdr_dev_t *open_dev(int bus, int port, const char *conf_file, int d,
+    int *fmt, double *fs, double *fo, int *IQ)
+{
+    sdr_dev_t *dev;
+    
+    if (!(dev = sdr_dev_open(bus, port))) {
+        return NULL;
+    }
+    if (*conf_file) {
+        if (!sdr_conf_write(dev, conf_file, 0)) {
+            sdr_dev_close(dev);
+            return NULL;
+        }
+        sdr_sleep_msec(50);
+    }
+    if (!sdr_dev_get_info(dev, fmt, fs, fo, IQ) ||
+        !set_usb_buff(dev, *fmt, *fs, d)) {
+        sdr_dev_close(dev);
+        return NULL;
+    }
+    // publish IF data of device as IF broker (name, name_2, name_3, ...)
+    if (*sdr_shm_pub) {
+        char name[64];
+        snprintf(name, sizeof(name), d == 0 ? "%s" : "%s_%d", sdr_shm_pub,
+            d + 1);
+        if (!sdr_dev_share(dev, name)) {
+            sdr_dev_close(dev);
+            return NULL;
+        }
+    }
+    // stream IF data of device to network (port, port + 1, port + 2, ...)
+    if (*sdr_net_pub) {
+        char addr[160];
+        const char *p = strrchr(sdr_net_pub, ':');
+        int len = p ? (int)(p - sdr_net_pub) : (int)strlen(sdr_net_pub);
+        snprintf(addr, sizeof(addr), "%.*s:%d", len, sdr_net_pub,
+            p ? atoi(p + 1) + d : 0);
+        if (!sdr_dev_stream(dev, addr)) {
+            sdr_dev_close(dev);
+            return NULL;
+        }
+    }
+    return dev;
 }
 
 //------------------------------------------------------------------------------
@@ -764,22 +2389,146 @@ int sdr_rcv_set_gain(sdr_rcv_t *rcv, int ch, int gain)
 //
 sdr_rcv_t *sdr_rcv_open_dev(const char **sigs, int *prns, int n, int bus,
     int port, const char *conf_file, const char **paths)
+{
+    return sdr_rcv_open_devs(sigs, prns, n, &bus, &port, 1, &conf_file, paths);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver by multiple SDR devices and start receiver.
+//  The RF channels of the devices are numbered in the order of the devices.
+//  The devices should have the same IF data format and sampling frequency,
+//  and should share the reference clock. The IF data of the devices are
+//  aligned by the time of the first USB transfers at the start of receiver.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      bus       (I)  USB bus numbers of SDR devices (-1:any)
+//      port      (I)  USB port numbers of SDR devices (-1:any)
+//      ndev      (I)  number of SDR devices (1-SDR_MAX_DEV)
+//      conf_files (I) configration files for SDR devices ("": no config)
+//      paths     (I)  output stream paths as same as sdr_rcv_start()
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_open_devs(const char **sigs, int *prns, int n,
+    const int *bus, const int *port, int ndev, const char **conf_files,
+    const char **paths)
+{
+    sdr_dev_t *devs[SDR_MAX_DEV] = {0};
+    double fs = 0.0, fo[SDR_MAX_RFCH] = {0};
+    int fmt = 0, nb = 0, IQ[SDR_MAX_RFCH] = {0};
+    
+    if (ndev < 1 || ndev > SDR_MAX_DEV) {
+        fprintf(stderr, "number of SDR devices error: %d\n", ndev);
+        return NULL;
+    }
+    for (int i = 0; i < ndev; i++) {
+        double fs_d, fo_d[SDR_MAX_RFCH] = {0};
+        int fmt_d, IQ_d[SDR_MAX_RFCH] = {0};
+        
+        if (!(devs[i] = open_dev(bus[i], port[i], conf_files[i], i, &fmt_d,
+            &fs_d, fo_d, IQ_d))) {
+            break;
+        }
+        if (i == 0) {
+            fmt = fmt_d;
+            fs = fs_d;
+            nb = fmt == SDR_FMT_RAW16 ? 4 : (fmt == SDR_FMT_RAW8 ? 2 : 1);
+        }
+        else if (fmt_d != fmt || fs_d != fs || (i + 1) * nb > SDR_MAX_RFCH) {
+            fprintf(stderr, "SDR device %d format or sampling rate mismatch\n",
+                i + 1);
+            sdr_dev_close(devs[i]);
+            devs[i] = NULL;
+            break;
+        }
+        for (int j = 0; j < nb; j++) {
+            fo[i * nb + j] = fo_d[j];
+            IQ[i * nb + j] = IQ_d[j];
+        }
+    }
+    if (!devs[ndev - 1]) {
+        for (int i = 0; i < ndev; i++) {
+            if (devs[i]) sdr_dev_close(devs[i]);
+        }
+        return NULL;
+    }
+    sdr_rcv_t *rcv = rcv_new(sigs, prns, n, fmt, fs, fo, IQ, ndev);
+    for (int i = 1; i < ndev; i++) {
+        rcv->dps[i] = devs[i];
+    }
+    sdr_rcv_start(rcv, SDR_DEV_USB, (void *)devs[0], paths);
+    
+    return rcv;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver by a shared memory IF broker and start receiver.
+//  The IF broker is published by another receiver with the option shm_pub or
+//  by sdr_dev_share(). The receiver reads the IF data of the SDR device
+//  without its own USB claim in parallel with the other readers.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      name      (I)  name of shared memory segment of IF broker
+//      paths     (I)  output stream paths as same as sdr_rcv_start()
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_open_shm(const char **sigs, int *prns, int n,
+    const char *name, const char **paths)
 {
     sdr_dev_t *dev;
     double fs, fo[SDR_MAX_RFCH] = {0};
-    int fmt, nch, IQ[SDR_MAX_RFCH] = {0};
+    int fmt, IQ[SDR_MAX_RFCH] = {0};
     
-    if (!(dev = sdr_dev_open(bus, port))) {
+    if (!(dev = sdr_dev_attach(name))) {
         return NULL;
     }
-    if (*conf_file) {
-        if (!sdr_conf_write(dev, conf_file, 0)) {
-            sdr_dev_close(dev);
-            return NULL;
-        }
-        sdr_sleep_msec(50);
+    if (!sdr_dev_get_info(dev, &fmt, &fs, fo, IQ)) {
+        sdr_dev_close(dev);
+        return NULL;
+    }
+    sdr_rcv_t *rcv = sdr_rcv_new(sigs, prns, n, fmt, fs, fo, IQ);
+    sdr_rcv_start(rcv, SDR_DEV_USB, (void *)dev, paths);
+    
+    return rcv;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new SDR receiver by a network IF stream and start receiver. The
+//  network IF stream is streamed by another receiver with the option net_pub
+//  or by sdr_dev_stream(). The IF data lost in the network are marked as gaps
+//  of the receiver as the errors of the USB transfers.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      addr      (I)  address of network IF stream (see sdr_dev_connect())
+//      paths     (I)  output stream paths as same as sdr_rcv_start()
+//
+//  returns:
+//      SDR receiver (NULL: error)
+//
+sdr_rcv_t *sdr_rcv_open_net(const char **sigs, int *prns, int n,
+    const char *addr, const char **paths)
+{
+    sdr_dev_t *dev;
+    double fs, fo[SDR_MAX_RFCH] = {0};
+    int fmt, IQ[SDR_MAX_RFCH] = {0};
+    
+    if (!(dev = sdr_dev_connect(addr))) {
+        return NULL;
     }
-    if (!(nch = sdr_dev_get_info(dev, &fmt, &fs, fo, IQ))) {
+    if (!sdr_dev_get_info(dev, &fmt, &fs, fo, IQ) ||
+        !set_usb_buff(dev, fmt, fs, 0)) {
         sdr_dev_close(dev);
         return NULL;
     }
@@ -789,6 +2538,13 @@ sdr_rcv_t *sdr_rcv_open_dev(const char **sigs, int *prns, int n, int bus,
     return rcv;
 }
 
+// number of RF channels of IF data format -------------------------------------
+static int rfch_num(int fmt)
+{
+    return (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_INT8X2) ? 1 :
+        (fmt == SDR_FMT_RAW8 ? 2 : (fmt == SDR_FMT_RAW16 ? 4 : 8));
+}
+
 // read tag for IF data dump file ----------------------------------------------
 static void read_tag(const char *file, int *fmt, double *fs, double *fo,
     int *IQ)
@@ -822,15 +2578,49 @@ static void read_tag(const char *file, int *fmt, double *fs, double *fo,
                 IQ + 4, IQ + 5, IQ + 6, IQ + 7);
         }
     }
-    int nch = (*fmt == SDR_FMT_INT8 || *fmt == SDR_FMT_INT8X2) ? 1 :
-        (*fmt == SDR_FMT_RAW8 ? 2 : (*fmt == SDR_FMT_RAW16 ? 4 : 8));
-    for (int i = nch; i < SDR_MAX_RFCH; i++) {
+    for (int i = rfch_num(*fmt); i < SDR_MAX_RFCH; i++) {
         fo[i] = 0.0;
         IQ[i] = 0;
     }
     fclose(fp);
 }
 
+// open SDR receiver by IF data file with output window -----------------------
+static sdr_rcv_t *open_file(const char **sigs, int *prns, int n, int fmt,
+    double fs, const double *fo, const int *IQ, double toff, double tscale,
+    const char *file, const char **paths, int64_t ix_out, int64_t ix_end,
+    sdr_pvt_seed_t *seed)
+{
+    sdr_file_t *fp;
+    double fo_t[SDR_MAX_RFCH] = {0};
+    int IQ_t[SDR_MAX_RFCH] = {0};
+    
+    if (!(fp = sdr_file_open(file))) {
+        fprintf(stderr, "file open error: %s\n", file);
+        return NULL;
+    }
+    // read tag file
+    memcpy(fo_t, fo, sizeof(double) * rfch_num(fmt));
+    memcpy(IQ_t, IQ, sizeof(int) * rfch_num(fmt));
+    read_tag(file, &fmt, &fs, fo_t, IQ_t);
+    
+    int ns = (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_RAW8) ? 1 : 2;
+    if (!sdr_file_seek(fp, (int64_t)(toff * fs * ns))) {
+        fprintf(stderr, "file seek error: %s\n", file);
+        sdr_file_close(fp);
+        return NULL;
+    }
+    sdr_rcv_t *rcv = sdr_rcv_new(sigs, prns, n, fmt, fs, fo_t, IQ_t);
+    rcv->tscale = tscale;
+    rcv->ix_out = ix_out;
+    rcv->ix_end = ix_end;
+    rcv->ix_file = (int64_t)(toff / SDR_CYC + 0.5);
+    rcv->seed = seed;
+    sdr_rcv_start(rcv, SDR_DEV_FILE, (void *)fp, paths);
+    
+    return rcv;
+}
+
 //------------------------------------------------------------------------------
 //  Generate a new SDR receiver by IF data file and start receiver.
 //
@@ -843,7 +2633,7 @@ static void read_tag(const char *file, int *fmt, double *fs, double *fo,
 //      fo        (I)  LO frequency for each RFCH (Hz)
 //      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
 //      toff      (I)  time offset of IF data file (s)
-//      tscale    (I)  time scale of replay IF data file
+//      tscale    (I)  time scale of replay IF data file (0: max speed)
 //      file      (I)  IF data file
 //      paths     (I)  output stream paths as same as sdr_rcv_start()
 //
@@ -858,27 +2648,181 @@ sdr_rcv_t *sdr_rcv_open_file(const char **sigs, int *prns, int n, int fmt,
     double fs, const double *fo, const int *IQ, double toff, double tscale,
     const char *file, const char **paths)
 {
+    return open_file(sigs, prns, n, fmt, fs, fo, IQ, toff, tscale, file, paths,
+        0, 0, NULL);
+}
+
+// temporary output file path of segment ---------------------------------------
+static void seg_tmp(char *path, int size, const char *file, int seg,
+    const char *ext)
+{
+    const char *dir, *p;
+    
+    if ((p = strrchr(file, '/'))) file = p + 1;
+#ifdef WIN32
+    if ((p = strrchr(file, '\\'))) file = p + 1;
+    if (!(dir = getenv("TEMP")) || !*dir) dir = ".";
+    snprintf(path, size, SEG_TMP, dir, file, (int)GetCurrentProcessId(), seg,
+        ext);
+#else
+    if (!(dir = getenv("TMPDIR")) || !*dir) dir = "/tmp";
+    snprintf(path, size, SEG_TMP, dir, file, (int)getpid(), seg, ext);
+#endif
+}
+
+// merge temporary output file of segment to output stream ---------------------
+static void merge_seg(stream_t *str, const char *path)
+{
+    uint8_t buff[65536];
     FILE *fp;
+    int n;
+    
+    if (!(fp = fopen(path, "rb"))) return;
+    while ((n = (int)fread(buff, 1, sizeof(buff), fp)) > 0) {
+        sdr_str_write(str, buff, n);
+    }
+    fclose(fp);
+    remove(path);
+}
+
+//------------------------------------------------------------------------------
+//  Process IF data file by SDR receivers in parallel over time segments. The
+//  IF data file is split into segments of tseg s and each segment is processed
+//  by an independent SDR receiver replaying the file at max speed. The
+//  receiver of a segment starts tovl s before the segment to acquire and track
+//  signals and decode navigation data, and outputs only within the segment.
+//  The outputs of segments are merged into the output streams in time order.
+//  The receivers of the segments after the first are warm-started by the seed
+//  of the first PVT solution of the first segment within tovl s of the segment
+//  (the receiver position, the clock drift and the ephemerides) to predict
+//  Doppler of satellites for the acquisition assist. They are held until the
+//  seed is set or expired, so that all of them are started by the same seed.
+//
+//  args:
+//      sigs      (I)  signal types as a string array {sig1, sig2, ..., sign}
+//      prns      (I)  PRN numbers as int array {prn1, prn2, ..., prnn}
+//      n         (I)  number of sigs and prns
+//      fmt       (I)  IF data format as same as sdr_rcv_new()
+//      fs        (I)  sampling rate (sps)
+//      fo        (I)  LO frequency for each RFCH (Hz)
+//      IQ        (I)  sampling type for each RFCH (1:I, 2:IQ)
+//      toff      (I)  time offset of IF data file (s)
+//      tseg      (I)  time length of segment (s)
+//      tovl      (I)  time overlap with previous segment (s)
+//      nrun      (I)  max number of segments in parallel (0: CPU cores)
+//      file      (I)  IF data file
+//      paths     (I)  output stream paths as same as sdr_rcv_start()
+//
+//  returns:
+//      number of processed segments (0: error)
+//
+//  notes:
+//      If the tag file exists, fmt, fs, fo, IQ are obtained from the tag file.
+//      The log stream, the IF data log stream and the fast-rate PVT solutions
+//      stream are not supported. The outputs of segments are written to
+//      temporary files SEG_TMP in the temporary directory ($TMPDIR or /tmp,
+//      %TEMP% on Windows) until merged. If the receiver of a segment cannot be
+//      opened, no more segments are started and the function returns 0 after
+//      the running segments finish.
+//
+int sdr_rcv_batch(const char **sigs, int *prns, int n, int fmt, double fs,
+    const double *fo, const int *IQ, double toff, double tseg, double tovl,
+    int nrun, const char *file, const char **paths)
+{
+    static const char *ext[] = {"nmea", "rtcm3"};
+    sdr_file_t *fp;
     double fo_t[SDR_MAX_RFCH] = {0};
-    int IQ_t[SDR_MAX_RFCH] = {0};
+    int IQ_t[SDR_MAX_RFCH] = {0}, n_work = sdr_n_work, ncpu = sdr_get_ncpu();
+    int err = 0;
     
-    if (!(fp = fopen(file, "rb"))) {
+    if (tseg <= 0.0 || !(fp = sdr_file_open(file))) {
         fprintf(stderr, "file open error: %s\n", file);
-        return NULL;
+        return 0;
     }
-    // read tag file
-    memcpy(fo_t, fo, sizeof(double) * SDR_MAX_RFCH);
-    memcpy(IQ_t, IQ, sizeof(int) * SDR_MAX_RFCH);
-    read_tag(file, &fmt, &fs, fo_t, IQ_t);
+    int64_t size = fp->size;
+    sdr_file_close(fp);
     
+    // read tag file to get time length of IF data file
+    memcpy(fo_t, fo, sizeof(double) * rfch_num(fmt));
+    memcpy(IQ_t, IQ, sizeof(int) * rfch_num(fmt));
+    read_tag(file, &fmt, &fs, fo_t, IQ_t);
     int ns = (fmt == SDR_FMT_INT8 || fmt == SDR_FMT_RAW8) ? 1 : 2;
-    fseek(fp, (long)(toff * fs * ns), SEEK_SET);
+    int nseg = (int)ceil((size / (fs * ns) - toff) / tseg - 1e-9);
+    if (nseg <= 0) return 0;
     
-    sdr_rcv_t *rcv = sdr_rcv_new(sigs, prns, n, fmt, fs, fo_t, IQ_t);
-    rcv->tscale = tscale;
-    sdr_rcv_start(rcv, SDR_DEV_FILE, (void *)fp, paths);
+    nrun = MIN(nrun > 0 ? nrun : ncpu, nseg);
+    sdr_rcv_t **rcvs = (sdr_rcv_t **)sdr_malloc(sizeof(sdr_rcv_t *) * nseg);
+    uint8_t *done = (uint8_t *)sdr_malloc(nseg);
+    sdr_pvt_seed_t *seed = (sdr_pvt_seed_t *)sdr_malloc(sizeof(sdr_pvt_seed_t));
+    stream_t *strs[2] = {NULL, NULL};
+    char tmp[2][1024];
     
-    return rcv;
+    for (int i = 0; i < 2; i++) {
+        if (*paths[i] && !(strs[i] = sdr_str_open(paths[i]))) {
+            fprintf(stderr, "stream open error: %s\n", paths[i]);
+        }
+    }
+    // share CPU cores among receivers of segments in parallel
+    sdr_n_work = MAX(1, (n_work > 0 ? n_work : ncpu) / nrun);
+    
+    for (int k = 0, next = 0, nact = 0; next < (err ? k : nseg); ) {
+        int stat = 0;
+        
+        // close receivers of finished segments
+        for (int i = next; i < k; i++) {
+            if (done[i] || (rcvs[i] && rcvs[i]->state)) continue;
+            sdr_rcv_close(rcvs[i]);
+            done[i] = 1;
+            nact--;
+            stat = 1;
+        }
+        // merge outputs of finished segments in time order (discard by error)
+        for ( ; next < k && done[next]; next++) {
+            for (int i = 0; i < 2; i++) {
+                if (!strs[i]) continue;
+                seg_tmp(tmp[i], sizeof(tmp[i]), file, next, ext[i]);
+                if (err) remove(tmp[i]);
+                else merge_seg(strs[i], tmp[i]);
+            }
+        }
+        // start receivers of next segments (held after the first segment
+        // until the warm-start seed is set or expired)
+        int seed_stat = __atomic_load_n(&seed->stat, __ATOMIC_ACQUIRE);
+        for ( ; !err && k < nseg && nact < nrun &&
+            (k == 0 || seed_stat || done[0]); k++, nact++) {
+            double ts = toff + k * tseg, tw = MIN(tovl, ts);
+            const char *paths_k[5] = {"", "", "", "", ""};
+            
+            if (k == 0) {
+                seed->ix_max = (int64_t)((tw + tovl) / SDR_CYC + 0.5);
+            }
+            for (int i = 0; i < 2; i++) {
+                if (!strs[i]) continue;
+                seg_tmp(tmp[i], sizeof(tmp[i]), file, k, ext[i]);
+                paths_k[i] = tmp[i];
+            }
+            rcvs[k] = open_file(sigs, prns, n, fmt, fs, fo, IQ, ts - tw, 0.0,
+                file, paths_k, (int64_t)(tw / SDR_CYC + 0.5),
+                (int64_t)((tw + tseg) / SDR_CYC + 0.5),
+                k == 0 || seed_stat == 1 ? seed : NULL);
+            stat = 1;
+            if (!rcvs[k]) {
+                fprintf(stderr, "segment open error: seg=%d %s\n", k, file);
+                done[k] = 1;
+                nact--;
+                err = 1;
+            }
+        }
+        if (!stat) sdr_sleep_msec(10);
+    }
+    sdr_n_work = n_work;
+    for (int i = 0; i < 2; i++) {
+        sdr_str_close(strs[i]);
+    }
+    sdr_free(rcvs);
+    sdr_free(done);
+    sdr_free(seed);
+    return err ? 0 : nseg;
 }
 
 //------------------------------------------------------------------------------
@@ -898,10 +2842,12 @@ void sdr_rcv_close(sdr_rcv_t *rcv)
     sdr_rcv_stop(rcv);
     
     if (rcv->dev == SDR_DEV_USB) {
-        sdr_dev_close((sdr_dev_t *)rcv->dp);
+        for (int i = 0; i < rcv->ndev; i++) {
+            sdr_dev_close((sdr_dev_t *)rcv->dps[i]);
+        }
     }
     else {
-        fclose((FILE *)rcv->dp);
+        sdr_file_close((sdr_file_t *)rcv->dp);
     }
     sdr_rcv_free(rcv);
 }
@@ -921,6 +2867,8 @@ void sdr_rcv_setopt(const char *opt, double value)
     extern double sdr_epoch, sdr_lag_epoch, sdr_el_mask, sdr_sp_corr, sdr_t_acq;
     extern double sdr_t_dll, sdr_b_dll, sdr_b_pll, sdr_b_fll_w, sdr_b_fll_n;
     extern double sdr_max_dop, sdr_thres_cn0_l, sdr_thres_cn0_u;
+    extern double sdr_t_acq_l, sdr_t_coh, sdr_thres_cn0_w, sdr_t_int;
+    extern double sdr_t_fast;
     if      (!strcmp(opt, "epoch"      )) sdr_epoch       = value;
     else if (!strcmp(opt, "lag_epoch"  )) sdr_lag_epoch   = value;
     else if (!strcmp(opt, "el_mask"    )) sdr_el_mask     = value;
@@ -934,6 +2882,59 @@ void sdr_rcv_setopt(const char *opt, double value)
     else if (!strcmp(opt, "max_dop"    )) sdr_max_dop     = value;
     else if (!strcmp(opt, "thres_cn0_l")) sdr_thres_cn0_l = value;
     else if (!strcmp(opt, "thres_cn0_u")) sdr_thres_cn0_u = value;
+    else if (!strcmp(opt, "t_acq_l"    )) sdr_t_acq_l     = value;
+    else if (!strcmp(opt, "t_coh"      )) sdr_t_coh       = value;
+    else if (!strcmp(opt, "thres_cn0_w")) sdr_thres_cn0_w = value;
+    else if (!strcmp(opt, "t_int"      )) sdr_t_int       = value;
+    else if (!strcmp(opt, "t_fast"     )) sdr_t_fast      = value;
+    else if (!strcmp(opt, "n_work"     )) sdr_n_work      = (int)value;
+    else if (!strcmp(opt, "n_srch"     )) sdr_n_srch      = MAX(1, (int)value);
+    else if (!strcmp(opt, "n_live"     )) sdr_n_live      = MAX(0, (int)value);
+    else if (!strcmp(opt, "mix_nco"    )) sdr_set_mix(value ? SDR_MIX_NCO :
+        SDR_MIX_LUT);
+    else if (!strcmp(opt, "pack_buff"  )) sdr_pack_buff   = (int)value;
+    else if (!strcmp(opt, "n_buff"     )) sdr_n_buff      = (int)value;
+    else if (!strcmp(opt, "usb_nbuff"  )) sdr_usb_nbuff   = (int)value;
+    else if (!strcmp(opt, "usb_size"   )) sdr_usb_size    = (int)value;
+    else if (!strcmp(opt, "usb_frame"  )) sdr_usb_frame   = (int)value;
+    else if (!strcmp(opt, "usb_cpu"    )) sdr_usb_cpu     = (int)value;
+    else if (!strcmp(opt, "usb_pri"    )) sdr_usb_pri     = (int)value;
+    else if (!strcmp(opt, "rcv_cpu"    )) sdr_rcv_cpu     = (int)value;
+    else if (!strcmp(opt, "rcv_pri"    )) sdr_rcv_pri     = (int)value;
+    else if (!strcmp(opt, "work_cpu"   )) sdr_work_cpu    = (int)value;
+    else if (!strcmp(opt, "work_pri"   )) sdr_work_pri    = (int)value;
+    else if (!strcmp(opt, "n_nav"      )) sdr_n_nav       = (int)value;
+    else if (!strcmp(opt, "ddc"        )) sdr_ddc         = (int)value;
+    else if (!strcmp(opt, "joint"      )) sdr_joint       = (int)value;
+    else if (!strcmp(opt, "vt"         )) sdr_vt          = (int)value;
+    else if (!strcmp(opt, "mem_huge"   )) sdr_mem_huge    = (int)value;
+    else if (!strcmp(opt, "mem_numa"   )) sdr_mem_numa    = (int)value;
+    else if (!strcmp(opt, "mem_lock"   )) sdr_mem_lock    = (int)value;
     else fprintf(stderr, "sdr_rcv_setopt error opt=%s\n", opt);
 }
 
+//------------------------------------------------------------------------------
+//  Set SDR receiver string options.
+//
+//  args:
+//      opt       (I)  option string
+//      str       (I)  option value
+//
+//  returns:
+//      none
+//
+void sdr_rcv_setopt_str(const char *opt, const char *str)
+{
+    extern char sdr_state_file[1024];
+    if (!strcmp(opt, "shm_pub")) {
+        snprintf(sdr_shm_pub, sizeof(sdr_shm_pub), "%s", str);
+    }
+    else if (!strcmp(opt, "net_pub")) {
+        snprintf(sdr_net_pub, sizeof(sdr_net_pub), "%s", str);
+    }
+    else if (!strcmp(opt, "state")) {
+        snprintf(sdr_state_file, sizeof(sdr_state_file), "%s", str);
+    }
+    else fprintf(stderr, "sdr_rcv_setopt_str error opt=%s\n", opt);
+}
+
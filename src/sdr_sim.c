@@ -0,0 +1,419 @@
+//
+//  Pocket SDR C Library - IF Signal Simulator Functions
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new
+//
+#include <math.h>
+#include "pocket_sdr.h"
+
+// constants and macros --------------------------------------------------------
+#define SIM_BLK     4096        // number of samples of simulation block
+#define LUT_BITS    10          // number of bits of carrier lookup table
+#define NMAX_SAT    64          // initial max number of satellites
+
+#define MIN(x, y)   ((x) < (y) ? (x) : (y))
+#define MAX(x, y)   ((x) > (y) ? (x) : (y))
+
+// carrier lookup table --------------------------------------------------------
+static float COS_LUT[1 << LUT_BITS], SIN_LUT[1 << LUT_BITS];
+
+// simulation job type ---------------------------------------------------------
+typedef struct {
+    sdr_sim_t *sim;             // IF signal simulator
+    int N;                      // number of samples
+    uint8_t *raw;               // raw IF data
+    int64_t blk0;               // index of first simulation block
+} sim_job_t;
+
+// generate carrier lookup table -----------------------------------------------
+static void gen_LUT(void)
+{
+    if (COS_LUT[0] != 0.0f) return;
+    
+    for (int i = 0; i < (1 << LUT_BITS); i++) {
+        double phi = 2.0 * PI * i / (1 << LUT_BITS);
+        COS_LUT[i] = (float)cos(phi);
+        SIN_LUT[i] = (float)sin(phi);
+    }
+}
+
+// number of RF channels and bytes per sample of IF data format ----------------
+static int fmt_nrfch(int fmt)
+{
+    return fmt == SDR_FMT_RAW8 ? 2 : (fmt == SDR_FMT_RAW16 ? 4 : 1);
+}
+
+static int fmt_size(int fmt)
+{
+    return (fmt == SDR_FMT_INT8X2 || fmt == SDR_FMT_RAW16) ? 2 : 1;
+}
+
+// set RF channel and IF frequency (as same as receiver) -----------------------
+static int set_rfch(const sdr_sim_t *sim, double freq, double *fi)
+{
+    int rfch = 0;
+    
+    if (sim->fmt == SDR_FMT_RAW8) { // FE 2CH
+        rfch = freq > 1.4e9 ? 0 : 1;
+    }
+    else if (sim->fmt == SDR_FMT_RAW16) { // FE 4CH
+        for (int i = 1; i < 4; i++) {
+            if (fabs(freq - sim->fo[i]) < fabs(freq - sim->fo[rfch])) rfch = i;
+        }
+    }
+    *fi = sim->fo[rfch] > 0.0 ? freq - sim->fo[rfch] :
+        (sim->IQ[rfch] == 1 ? sim->fs * 0.5 : 0.0);
+    return rfch;
+}
+
+// seed of noise of simulation block -------------------------------------------
+static uint32_t blk_seed(uint32_t seed, int64_t blk, int rfch)
+{
+    uint64_t h = (uint64_t)blk * 0x9E3779B97F4A7C15ull ^ seed ^
+        ((uint64_t)rfch << 56);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return (uint32_t)h ? (uint32_t)h : 1;
+}
+
+// generate noise with unit variance -------------------------------------------
+//  The Gaussian noise is approximated by the sum of 4 uniform random bytes of
+//  8 interleaved xorshift32 generators. n is rounded up to a multiple of 8.
+static void gen_noise(uint32_t seed, int n, float *x)
+{
+    const float scale = 1.0f / 147.78f; // 1 / sqrt(4 * (256^2 - 1) / 12)
+    uint32_t r[8];
+    
+    for (int j = 0; j < 8; j++) {
+        r[j] = blk_seed(seed, j, 0);
+    }
+    for (int i = 0; i < n; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            r[j] ^= r[j] << 13;
+            r[j] ^= r[j] >> 17;
+            r[j] ^= r[j] << 5;
+            int s = (int)(r[j] & 0xFF) + (int)((r[j] >> 8) & 0xFF) +
+                (int)((r[j] >> 16) & 0xFF) + (int)(r[j] >> 24) - 510;
+            x[i+j] = s * scale;
+        }
+    }
+}
+
+// positive modulo -------------------------------------------------------------
+static int64_t mod_pos(int64_t a, int64_t n)
+{
+    int64_t r = a % n;
+    return r < 0 ? r + n : r;
+}
+
+// sign of signal by secondary code and nav data in code cycle -----------------
+static float sat_sign(const sdr_sim_sat_t *sat, int64_t cyc)
+{
+    float sign = sat->sec_code[mod_pos(cyc, sat->len_sec_code)];
+    
+    if (sat->data && sat->len_data > 0) {
+        int64_t isym = cyc >= 0 ? cyc / sat->ncyc :
+            -((-cyc + sat->ncyc - 1) / sat->ncyc);
+        if (sat->data[mod_pos(isym, sat->len_data)]) sign = -sign;
+    }
+    return sign;
+}
+
+// add satellite signal to IF data ---------------------------------------------
+//  The carrier and the code Doppler are constant in the block. The carrier is
+//  generated by the 32-bit phase accumulator with the lookup table and the code
+//  by the 32.32 fixed-point chip phase from the start of the block ix. The
+//  first skip samples of the block are skipped.
+static void add_sig(const sdr_sim_t *sim, const sdr_sim_sat_t *sat, int64_t ix,
+    int skip, int n, float *I, float *Q)
+{
+    double t = ix / sim->fs;
+    double fchip = sat->len_code / sat->T;
+    double fd = sat->dop + sat->rate * t; // Doppler (Hz)
+    double cyc_carr = sat->phi + (sat->fi + sat->dop) * t +
+        0.5 * sat->rate * t * t;
+    double chip = fchip * ((t - sat->coff) + (sat->dop * t +
+        0.5 * sat->rate * t * t) / sat->fc);
+    int64_t cyc = (int64_t)floor(chip / sat->len_code);
+    double chip_c = chip - (double)cyc * sat->len_code;
+    uint32_t p = (uint32_t)(int64_t)floor((cyc_carr - floor(cyc_carr)) *
+        4294967296.0);
+    uint32_t dp = (uint32_t)(int64_t)llround((sat->fi + fd) / sim->fs *
+        4294967296.0);
+    uint64_t lenfp = (uint64_t)sat->len_code << 32;
+    uint64_t cp = (uint64_t)(chip_c * 4294967296.0);
+    uint64_t dcp = (uint64_t)(fchip * (1.0 + fd / sat->fc) / sim->fs *
+        4294967296.0);
+    const int8_t *code = sat->code;
+    
+    if (cp >= lenfp) cp = lenfp - 1;
+    p += dp * (uint32_t)skip;
+    cp += dcp * (uint64_t)skip;
+    cyc += (int64_t)(cp / lenfp);
+    cp %= lenfp;
+    float amp = sat->amp * sat_sign(sat, cyc);
+    
+    for (int i = 0; i < n; ) {
+        if (cp >= lenfp) {
+            cp -= lenfp;
+            amp = sat->amp * sat_sign(sat, ++cyc);
+        }
+        // samples to the end of code cycle
+        int m = (int)MIN((uint64_t)(n - i), (lenfp - cp + dcp - 1) / dcp);
+        if (Q) {
+            for (int j = i; j < i + m; j++, p += dp, cp += dcp) {
+                float v = amp * code[cp >> 32];
+                I[j] += v * COS_LUT[p >> (32 - LUT_BITS)];
+                Q[j] += v * SIN_LUT[p >> (32 - LUT_BITS)];
+            }
+        }
+        else {
+            for (int j = i; j < i + m; j++, p += dp, cp += dcp) {
+                I[j] += amp * code[cp >> 32] * COS_LUT[p >> (32 - LUT_BITS)];
+            }
+        }
+        i += m;
+    }
+}
+
+// quantize IF data to 2-bit I/Q of receiver (1, 3, -1, -3) --------------------
+static uint8_t quant_I(float x)
+{
+    return (uint8_t)((x < 0.0f ? 2 : 0) | (fabsf(x) >= 1.0f ? 1 : 0));
+}
+
+static uint8_t quant_Q(float x)
+{
+    return (uint8_t)((x > 0.0f ? 2 : 0) | (fabsf(x) >= 1.0f ? 1 : 0));
+}
+
+static int8_t quant_val(float x)
+{
+    return (int8_t)(fabsf(x) >= 1.0f ? (x < 0.0f ? -3 : 3) :
+        (x < 0.0f ? -1 : 1));
+}
+
+// pack IF data to raw IF data -------------------------------------------------
+static void pack_data(const sdr_sim_t *sim, float (*I)[SIM_BLK],
+    float (*Q)[SIM_BLK], int skip, int n, uint8_t *raw)
+{
+    uint8_t nib[4];
+    
+    for (int i = skip; i < skip + n; i++, raw += fmt_size(sim->fmt)) {
+        if (sim->fmt == SDR_FMT_INT8) {
+            raw[0] = (uint8_t)quant_val(I[0][i]);
+        }
+        else if (sim->fmt == SDR_FMT_INT8X2) {
+            raw[0] = (uint8_t)quant_val(I[0][i]);
+            raw[1] = (uint8_t)-quant_val(Q[0][i]);
+        }
+        else {
+            for (int j = 0; j < sim->nrfch; j++) {
+                nib[j] = quant_I(I[j][i]) |
+                    (sim->IQ[j] == 2 ? quant_Q(Q[j][i]) << 2 : 0);
+            }
+            if (sim->fmt == SDR_FMT_RAW8) {
+                raw[0] = nib[0] | (nib[1] << 4);
+            }
+            else {
+                raw[0] = nib[0] | (nib[1] << 4);
+                raw[1] = nib[2] | (nib[3] << 4);
+            }
+        }
+    }
+}
+
+// generate IF data of simulation block ----------------------------------------
+static void sim_blk(void *arg, int k)
+{
+    sim_job_t *job = (sim_job_t *)arg;
+    sdr_sim_t *sim = job->sim;
+    int64_t blk = job->blk0 + k, ix0 = blk * SIM_BLK;
+    int64_t ix = MAX(ix0, sim->ix), ie = MIN(ix0 + SIM_BLK, sim->ix + job->N);
+    int n = (int)(ie - ix), skip = (int)(ix - ix0);
+    float (*I)[SIM_BLK] = (float (*)[SIM_BLK])sdr_scratch_alloc(sizeof(float) *
+        SIM_BLK * 2 * sim->nrfch);
+    float (*Q)[SIM_BLK] = I + sim->nrfch;
+    
+    if (n <= 0) {
+        sdr_scratch_free(I);
+        return;
+    }
+    for (int j = 0; j < sim->nrfch; j++) {
+        gen_noise(blk_seed(sim->seed, blk, j * 2), skip + n, I[j]);
+        if (sim->IQ[j] == 2) {
+            gen_noise(blk_seed(sim->seed, blk, j * 2 + 1), skip + n, Q[j]);
+        }
+    }
+    for (int j = 0; j < sim->nsat; j++) {
+        sdr_sim_sat_t *sat = sim->sats + j;
+        add_sig(sim, sat, ix0, skip, n, I[sat->rfch] + skip,
+            sim->IQ[sat->rfch] == 2 ? Q[sat->rfch] + skip : NULL);
+    }
+    pack_data(sim, I, Q, skip, n, job->raw + (ix - sim->ix) *
+        fmt_size(sim->fmt));
+    sdr_scratch_free(I);
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new IF signal simulator. The simulator synthesizes the digitized
+//  IF data of the satellite signals with the thermal noise in the same format
+//  as the IF data of the receiver.
+//
+//  args:
+//      fmt      (I) IF data format (SDR_FMT_INT8, SDR_FMT_INT8X2, SDR_FMT_RAW8,
+//                   SDR_FMT_RAW16)
+//      fs       (I) Sampling rate (sps)
+//      fo       (I) LO frequency of RF channels (Hz) {fo_1, fo_2, ...}
+//      IQ       (I) Sampling type of RF channels (1:I, 2:IQ) {IQ_1, IQ_2, ...}
+//      seed     (I) Seed of noise
+//      nthread  (I) Number of threads (0: number of CPU cores)
+//
+//  return:
+//      IF signal simulator (NULL: error)
+//
+sdr_sim_t *sdr_sim_new(int fmt, double fs, const double *fo, const int *IQ,
+    uint32_t seed, int nthread)
+{
+    if (fmt != SDR_FMT_INT8 && fmt != SDR_FMT_INT8X2 && fmt != SDR_FMT_RAW8 &&
+        fmt != SDR_FMT_RAW16) {
+        fprintf(stderr, "sdr_sim_new: unsupported format fmt=%d\n", fmt);
+        return NULL;
+    }
+    sdr_sim_t *sim = (sdr_sim_t *)sdr_malloc(sizeof(sdr_sim_t));
+    sim->fmt = fmt;
+    sim->fs = fs;
+    sim->nrfch = fmt_nrfch(fmt);
+    for (int i = 0; i < sim->nrfch; i++) {
+        sim->fo[i] = fo[i];
+        sim->IQ[i] = fmt == SDR_FMT_INT8 ? 1 :
+            (fmt == SDR_FMT_INT8X2 ? 2 : IQ[i]);
+    }
+    sim->seed = seed;
+    sim->nthread = nthread > 0 ? nthread : sdr_get_ncpu();
+    gen_LUT();
+    return sim;
+}
+
+//------------------------------------------------------------------------------
+//  Free IF signal simulator.
+//
+//  args:
+//      sim      (I) IF signal simulator
+//
+//  return:
+//      none
+//
+void sdr_sim_free(sdr_sim_t *sim)
+{
+    if (!sim) return;
+    for (int i = 0; i < sim->nsat; i++) {
+        sdr_free(sim->sats[i].data);
+    }
+    sdr_free(sim->sats);
+    sdr_free(sim);
+}
+
+//------------------------------------------------------------------------------
+//  Add satellite signal to IF signal simulator. The signal is assigned to the
+//  RF channel as same as the receiver. The nav data symbols are repeated in
+//  the cycle of len_data symbols.
+//
+//  args:
+//      sim      (I) IF signal simulator
+//      sig      (I) Signal type as string ('L1CA', 'L1CB', 'L1CP', ....)
+//      prn      (I) PRN number (FCN for GLONASS FDMA signals)
+//      dop      (I) Doppler frequency at time 0 (Hz)
+//      rate     (I) Doppler frequency rate (Hz/s)
+//      cn0      (I) C/N0 (dB-Hz)
+//      coff     (I) Code offset (s) (start time of the code cycle)
+//      data     (I) Nav data symbols (0 or 1) (NULL: no nav data)
+//      len_data (I) Length of nav data symbols
+//      ncyc     (I) Number of code cycles per nav data symbol
+//
+//  return:
+//      Status (1: OK, 0: error)
+//
+int sdr_sim_add_sat(sdr_sim_t *sim, const char *sig, int prn, double dop,
+    double rate, double cn0, double coff, const uint8_t *data, int len_data,
+    int ncyc)
+{
+    const sdr_sig_t *desc = sdr_sig_get(sdr_sig_id(sig));
+    sdr_sim_sat_t *sat;
+    int len_code;
+    
+    if (!desc) {
+        fprintf(stderr, "sdr_sim_add_sat: invalid signal sig=%s\n", sig);
+        return 0;
+    }
+    if (sim->nsat >= sim->nmax) {
+        int nmax = sim->nmax <= 0 ? NMAX_SAT : sim->nmax * 2;
+        sdr_sim_sat_t *sats = (sdr_sim_sat_t *)sdr_malloc(
+            sizeof(sdr_sim_sat_t) * nmax);
+        if (sim->nsat > 0) {
+            memcpy(sats, sim->sats, sizeof(sdr_sim_sat_t) * sim->nsat);
+        }
+        sdr_free(sim->sats);
+        sim->sats = sats;
+        sim->nmax = nmax;
+    }
+    sat = sim->sats + sim->nsat;
+    memset(sat, 0, sizeof(sdr_sim_sat_t));
+    if (!(sat->code = sdr_gen_code(sig, prn, &len_code)) ||
+        !(sat->sec_code = sdr_sec_code(sig, prn, &sat->len_sec_code))) {
+        fprintf(stderr, "sdr_sim_add_sat: no code sig=%s prn=%d\n", sig, prn);
+        return 0;
+    }
+    snprintf(sat->sig, sizeof(sat->sig), "%s", sig);
+    sat->prn = prn;
+    sat->fc = sdr_shift_freq(desc->sig, prn, desc->freq);
+    sat->rfch = set_rfch(sim, sat->fc, &sat->fi);
+    sat->T = desc->cyc;
+    sat->len_code = len_code;
+    sat->dop = dop;
+    sat->rate = rate;
+    sat->cn0 = cn0;
+    sat->coff = coff;
+    sat->amp = (float)sqrt(pow(10.0, cn0 / 10.0) *
+        (sim->IQ[sat->rfch] == 2 ? 2.0 : 4.0) / sim->fs);
+    if (data && len_data > 0) {
+        sat->data = (uint8_t *)sdr_malloc(len_data);
+        memcpy(sat->data, data, len_data);
+        sat->len_data = len_data;
+        sat->ncyc = MAX(ncyc, 1);
+    }
+    sim->nsat++;
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+//  Generate IF data by IF signal simulator. The IF data is generated in
+//  parallel in blocks. The noise of the block is seeded by the block index, so
+//  the IF data is reproducible independent of the number of samples per call
+//  and the number of threads.
+//
+//  args:
+//      sim      (I) IF signal simulator
+//      N        (I) Number of samples
+//      raw      (O) Raw IF data in the format of the simulator
+//                   (N x 1 bytes: INT8, RAW8, N x 2 bytes: INT8X2, RAW16)
+//
+//  return:
+//      Size of raw IF data (bytes)
+//
+int sdr_sim_gen(sdr_sim_t *sim, int N, uint8_t *raw)
+{
+    if (N <= 0) return 0;
+    
+    sim_job_t job = {sim, N, raw, sim->ix / SIM_BLK};
+    int nblk = (int)((sim->ix + N - 1) / SIM_BLK - job.blk0 + 1);
+    
+    sdr_par_for(nblk, sim->nthread, sim_blk, &job);
+    sim->ix += N;
+    return N * fmt_size(sim->fmt);
+}
@@ -0,0 +1,475 @@
+//
+//  Pocket SDR C Library - Snapshot Positioning Functions
+//
+//  Author:
+//  T.TAKASU
+//
+//  History:
+//  2026-10-15  1.0  new (port from pocket_snap.c)
+//
+#include <math.h>
+#include "pocket_sdr.h"
+
+// constants and macros --------------------------------------------------------
+#define THRES_CN0   38.0        // threshold to lock signal (dB-Hz)
+#define EL_MASK     15.0        // elevation mask (deg)
+#define MAX_DOP     5000.0      // max Doppler freq. to search signal (Hz)
+#define MAX_DFREQ   500.0       // max freq. offset of ref oscillator (Hz)
+#define MAX_SAT     256         // max number of satellites in snapshot
+
+#define ROUND(x)    floor(x + 0.5)
+
+// signals to search -----------------------------------------------------------
+static const struct {
+    int sys;
+    const char *sig;
+    int prn1, prn2;
+} snap_sigs[] = {
+    {SYS_GPS, "L1CA",   1,  32},
+    {SYS_GAL, "E1C" ,   1,  36},
+    {SYS_CMP, "B1CP",  19,  46},
+    {SYS_QZS, "L1CA", 193, 199}
+};
+#define NSIGS ((int)(sizeof(snap_sigs) / sizeof(*snap_sigs)))
+
+// satellite data type ---------------------------------------------------------
+typedef struct {
+    int sat;                    // satellite number
+    double rrate;               // range rate (m/s)
+    double coff;                // code offset (s)
+} snap_data_t;
+
+// snapshot batch type ---------------------------------------------------------
+typedef struct {
+    sdr_snap_t *snap;           // snapshot positioning engine
+    sdr_file_t *fp;             // IF data file
+    sdr_snap_job_t *jobs;       // snapshot jobs
+    pthread_mutex_t mtx;        // lock flag of IF data file
+} snap_batch_t;
+
+// satellite position, velocity and clock (svh: health with L6 mask) ----------
+static int snap_satpos(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
+    double *rs, double *dts)
+{
+    double var;
+    int svh = 0;
+    
+    memset(rs, 0, sizeof(double) * 6);
+    if (!satpos(time, teph, sat, EPHOPT_BRDC, nav, rs, dts, &var, &svh)) {
+        return 0;
+    }
+    if (satsys(sat, NULL) == SYS_QZS) svh &= 0xFE; // L6 mask
+    return norm(rs, 3) > 1e-3 && !svh;
+}
+
+// TGD of satellite (m) --------------------------------------------------------
+static double snap_tgd(int sat, const nav_t *nav)
+{
+    for (int i = 0; i < nav->n; i++) {
+        if (nav->eph[i].sat == sat) return CLIGHT * nav->eph[i].tgd[0];
+    }
+    return 0.0;
+}
+
+// select satellite by coarse time and position (return: elevation) -----------
+//  Satellites without valid ephemeris or unhealthy are pruned also without
+//  coarse position.
+static double sel_sat(gtime_t time, int sat, const double *rr, const nav_t *nav,
+    double *rrate)
+{
+    double rs[6], dts[2], e[3], pos[3], azel[2];
+    
+    if (!snap_satpos(time, time, sat, nav, rs, dts)) {
+        return 0.0;
+    }
+    if (norm(rr, 3) < 1e-3) { // no coarse position
+        return PI / 2.0;
+    }
+    geodist(rs, rr, e);
+    ecef2pos(rr, pos);
+    satazel(pos, e, azel);
+    *rrate = dot(rs + 3, e, 3);
+    return azel[1];
+}
+
+// satellite position, velocity and clock rate ---------------------------------
+static void sat_pos(gtime_t time, const snap_data_t *data, int N,
+    const nav_t *nav, double spos[][8])
+{
+    for (int i = 0; i < N; i++) {
+        double rs[6], dts[2] = {0};
+        if (!snap_satpos(time, time, data[i].sat, nav, rs, dts)) {
+            memset(rs, 0, sizeof(double) * 6);
+        }
+        matcpy(spos[i], rs, 6, 1);
+        spos[i][6] = CLIGHT * dts[0];
+        spos[i][7] = CLIGHT * dts[1];
+    }
+}
+
+// fine code offset ------------------------------------------------------------
+static double fine_coff(const char *sig, double fs, const float *P,
+    double coff)
+{
+    int len_code;
+    (void)sdr_gen_code(sig, 1, &len_code);
+    double T = sdr_code_cyc(sig) / len_code; // (s/chip)
+    double E = sqrt(P[0]);
+    double L = sqrt(P[2]);
+    return coff + (L - E) / (L + E) * (T / 2.0 - 1.0 / fs);
+}
+
+// search signals --------------------------------------------------------------
+static int search_sigs(sdr_snap_t *snap, gtime_t time, const sdr_buff_t *buff,
+    const double *rr, int nthread, snap_data_t *data)
+{
+    sdr_acq_job_t *jobs = (sdr_acq_job_t *)sdr_malloc(sizeof(sdr_acq_job_t) *
+        snap->nbook);
+    int *sats = (int *)sdr_malloc(sizeof(int) * snap->nbook), nj = 0, n = 0;
+    
+    // jobs of visible satellites
+    for (int i = 0, k = 0; i < NSIGS; i++) {
+        for (int prn = snap_sigs[i].prn1; prn <= snap_sigs[i].prn2; prn++) {
+            int sat = satno(snap_sigs[i].sys, prn);
+            double el, rrate = 0.0;
+            if (!snap->book[k++]) continue; // no code book or not selected
+            el = sel_sat(time, sat, rr, snap->nav, &rrate);
+            if (el < EL_MASK * D2R) continue;
+            
+            sdr_acq_job_t *job = jobs + nj;
+            snprintf(job->sig, sizeof(job->sig), "%s", snap_sigs[i].sig);
+            job->prn = prn;
+            if (rrate == 0.0) {
+                job->dop = 0.0f;
+                job->max_dop = MAX_DOP;
+            }
+            else {
+                job->dop = -rrate / CLIGHT * sdr_sig_freq(snap_sigs[i].sig);
+                job->max_dop = MAX_DFREQ;
+            }
+            sats[nj++] = sat;
+        }
+    }
+    // code search
+    sdr_acq_batch(jobs, nj, buff, snap->fs, snap->fi, 1, nthread);
+    
+    for (int i = 0; i < nj && n < MAX_SAT; i++) {
+        sdr_acq_job_t *job = jobs + i;
+        if (!job->stat || job->cn0 < THRES_CN0) continue;
+        data[n].sat = sats[i];
+        data[n].rrate = -job->fd * CLIGHT / sdr_sig_freq(job->sig);
+        data[n++].coff = fine_coff(job->sig, snap->fs, job->P, job->coff);
+    }
+    sdr_free(jobs);
+    sdr_free(sats);
+    return n;
+}
+
+// drdot/dx --------------------------------------------------------------------
+static void drdot_dx(const double *rs, const double *vs, const double *x,
+    double *drdot)
+{
+    double dx = 10.0, rdot, e[3], x1[3], x2[3], x3[3], e1[3], e2[3], e3[3];
+    geodist(rs, x, e);
+    rdot = dot(vs, e, 3);
+    memcpy(x1, x, sizeof(double) * 3);
+    memcpy(x2, x, sizeof(double) * 3);
+    memcpy(x3, x, sizeof(double) * 3);
+    x1[0] += dx;
+    x2[1] += dx;
+    x3[2] += dx;
+    geodist(rs, x1, e1);
+    geodist(rs, x2, e2);
+    geodist(rs, x3, e3);
+    drdot[0] = (dot(vs, e1, 3) - rdot) / dx;
+    drdot[1] = (dot(vs, e2, 3) - rdot) / dx;
+    drdot[2] = (dot(vs, e3, 3) - rdot) / dx;
+    drdot[3] = 1.0;
+}
+
+// position by Doppler ---------------------------------------------------------
+static int pos_dop(const snap_data_t *data, int N, double spos[][8],
+    double *rr)
+{
+    double x[4] = {0};
+    
+    for (int i = 0; i < 10; i++) {
+        double e[3], v[MAX_SAT] = {0}, H[MAX_SAT*4] = {0}, dx[4], Q[4*4];
+        int n = 0;
+        for (int j = 0; j < N; j++) {
+            if (norm(spos[j], 3) > 1e-3) {
+                geodist(spos[j], x, e);
+                v[n] = data[j].rrate - (dot(spos[j] + 3, e, 3) + x[3] -
+                    spos[j][7]);
+                drdot_dx(spos[j], spos[j] + 3, x, H + 4 * n);
+                n++;
+            }
+        }
+        if (n < 4 || lsq(H, v, 4, n, dx, Q)) {
+            return 0;
+        }
+        for (int k = 0; k < 4; k++) {
+            x[k] += dx[k];
+        }
+        if (norm(dx, 4) < 1.0) {
+            matcpy(rr, x, 3, 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// resolve ms ambiguity in code offset -----------------------------------------
+static void res_coff_amb(snap_data_t *data, int N, double spos[][8],
+    const double *rr)
+{
+    double e[3], r, tau[MAX_SAT], tau_min = 1e9;
+    int idx = 0;
+    for (int i = 0; i < N; i++) {
+        if (norm(spos[i], 3) > 1e-3) {
+            r = geodist(spos[i], rr, e);
+            tau[i] = (r - spos[i][6]) / CLIGHT;
+            if (tau[i] < tau_min) {
+                tau_min = tau[i];
+                idx = i;
+            }
+        }
+    }
+    double coff_ref = data[idx].coff;
+    double tau_ref = tau[idx];
+    for (int i = 0; i < N; i ++) {
+        if (norm(spos[i], 3) > 1e-3) {
+            double off = (tau[i] - tau_ref) - (data[i].coff - coff_ref);
+            data[i].coff += ROUND(off * 1e3) * 1e-3;
+        }
+    }
+}
+
+// estimate position by code offsets -------------------------------------------
+static int pos_coff(gtime_t time, const snap_data_t *data, int N, double *rr,
+    const nav_t *nav, double *dtr)
+{
+    double x[5] = {0};
+    matcpy(x, rr, 3, 1);
+    
+    for (int i = 0; i < 10; i++) {
+        int n = 0;
+        double pos[3], dx[5], v[MAX_SAT], H[MAX_SAT*5], Q[5*5];
+        ecef2pos(x, pos);
+        for (int j = 0; j < N; j++) {
+            gtime_t ts = timeadd(time, x[4]);
+            double rs[6], dts[2], rho, e[3], azel[2];
+            int stat = snap_satpos(ts, time, data[j].sat, nav, rs, dts);
+            rho = geodist(rs, x, e);
+            satazel(pos, e, azel);
+            if (stat && azel[1] >= EL_MASK * D2R) {
+                v[n] = CLIGHT * data[j].coff - (rho + x[3] - CLIGHT * dts[0] +
+                    ionmodel(ts, nav->ion_gps, pos, azel) +
+                    tropmodel(ts, pos, azel, 0.7) + snap_tgd(data[j].sat, nav));
+                H[n*5  ] = -e[0];
+                H[n*5+1] = -e[1];
+                H[n*5+2] = -e[2];
+                H[n*5+3] = 1.0;
+                H[n*5+4] = dot(rs + 3, e, 3);
+                n++;
+            }
+        }
+        if (n < 5 || lsq(H, v, 5, n, dx, Q)) {
+            break;
+        }
+        for (int k = 0; k < 5; k++) {
+            x[k] += dx[k];
+        }
+        if (norm(dx, 3) < 1e-3) {
+            if (sqrt(dot(v, v, 3) / n) > 1e3) {
+                break;
+            }
+            matcpy(rr, x, 3, 1);
+            *dtr = x[3] / CLIGHT - x[4];
+            return n;
+        }
+    }
+    memset(rr, 0, sizeof(double) * 3);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+//  Generate a new snapshot positioning engine. The code FFTs of all signals of
+//  the navigation systems are generated and kept in the code books while the
+//  engine is alive.
+//
+//  args:
+//      nav      (I) RINEX navigation data (referenced while engine is alive)
+//      sys      (I) Navigation systems (SYS_GPS | SYS_GAL | SYS_QZS | SYS_CMP)
+//      fs       (I) Sampling frequency (Hz)
+//      fi       (I) IF frequency (Hz) (0: IQ-sampling, otherwise: I-sampling)
+//      tint     (I) Integration time of signal search (s)
+//
+//  return:
+//      snapshot positioning engine (NULL: error)
+//
+sdr_snap_t *sdr_snap_new(const nav_t *nav, int sys, double fs, double fi,
+    double tint)
+{
+    if (!nav || fs <= 0.0 || tint <= 0.0) return NULL;
+    
+    sdr_snap_t *snap = (sdr_snap_t *)sdr_malloc(sizeof(sdr_snap_t));
+    snap->nav = nav;
+    snap->sys = sys;
+    snap->fs = fs;
+    snap->fi = fi;
+    snap->IQ = fi > 0.0 ? 1 : 2;
+    snap->tint = tint;
+    for (int i = 0; i < NSIGS; i++) {
+        snap->nbook += snap_sigs[i].prn2 - snap_sigs[i].prn1 + 1;
+    }
+    snap->book = (sdr_code_book_t **)sdr_malloc(sizeof(sdr_code_book_t *) *
+        snap->nbook);
+    for (int i = 0, k = 0; i < NSIGS; i++) {
+        int N = (int)(fs * sdr_code_cyc(snap_sigs[i].sig));
+        for (int prn = snap_sigs[i].prn1; prn <= snap_sigs[i].prn2; prn++) {
+            if (!(sys & snap_sigs[i].sys)) {
+                k++;
+                continue;
+            }
+            // keep code FFTs hot (same code book as sdr_acq_batch())
+            snap->book[k++] = sdr_code_book_get(snap_sigs[i].sig, prn, fs, N,
+                N, 1, SDR_CODE_FFT);
+        }
+    }
+    return snap;
+}
+
+//------------------------------------------------------------------------------
+//  Free a snapshot positioning engine.
+//
+//  args:
+//      snap     (I) snapshot positioning engine generated by sdr_snap_new()
+//
+//  return:
+//      none
+//
+void sdr_snap_free(sdr_snap_t *snap)
+{
+    if (!snap) return;
+    
+    for (int i = 0; i < snap->nbook; i++) {
+        sdr_code_book_put(snap->book[i]);
+    }
+    sdr_free(snap->book);
+    sdr_free(snap);
+}
+
+//------------------------------------------------------------------------------
+//  Snapshot positioning with IF data of a snapshot. If no coarse position, the
+//  position is solved by Doppler frequencies before code offsets.
+//
+//  args:
+//      snap     (I) snapshot positioning engine
+//      time     (I) capture time of snapshot (GPST)
+//      buff     (I) IF data buffer of snapshot
+//      rr       (I) coarse receiver position (ECEF) (m) (NULL or 0: no coarse
+//                   position)
+//      nthread  (I) number of threads of signal search (0: number of CPU
+//                   cores)
+//      sol      (O) snapshot positioning solution
+//
+//  return:
+//      number of satellites of solution (0: no solution)
+//
+int sdr_snap_pos(sdr_snap_t *snap, gtime_t time, const sdr_buff_t *buff,
+    const double *rr, int nthread, sdr_snap_sol_t *sol)
+{
+    snap_data_t data[MAX_SAT];
+    double spos[MAX_SAT][8], rr0[3] = {0};
+    
+    memset(sol, 0, sizeof(sdr_snap_sol_t));
+    sol->time = time;
+    if (rr) matcpy(rr0, rr, 3, 1);
+    
+    // search signals
+    int n = search_sigs(snap, time, buff, rr0, nthread, data);
+    if ((sol->nsig = n) <= 0) {
+        return 0;
+    }
+    // satellite position and velocity
+    sat_pos(time, data, n, snap->nav, spos);
+    
+    if (norm(rr0, 3) == 0.0) {
+        // position by Doppler
+        if (!pos_dop(data, n, spos, rr0)) {
+            return 0;
+        }
+        // force height = 0
+        double pos[3];
+        ecef2pos(rr0, pos);
+        pos[2] = 0.0;
+        pos2ecef(pos, rr0);
+    }
+    // resolve ms ambiguity in code offsets
+    res_coff_amb(data, n, spos, rr0);
+    
+    // estimate position by code offsets
+    sol->ns = pos_coff(time, data, n, rr0, snap->nav, &sol->dtr);
+    sol->time = timeadd(time, -sol->dtr);
+    matcpy(sol->rr, rr0, 3, 1);
+    return sol->ns;
+}
+
+// run snapshot job in batch ---------------------------------------------------
+static void snap_run_job(void *arg, int i)
+{
+    snap_batch_t *b = (snap_batch_t *)arg;
+    sdr_snap_job_t *job = b->jobs + i;
+    sdr_snap_t *snap = b->snap;
+    
+    pthread_mutex_lock(&b->mtx);
+    sdr_buff_t *buff = sdr_file_read_data(b->fp, snap->fs, snap->IQ, snap->tint,
+        job->toff);
+    pthread_mutex_unlock(&b->mtx);
+    
+    memset(&job->sol, 0, sizeof(sdr_snap_sol_t));
+    job->sol.time = job->time;
+    if (!buff) return;
+    sdr_snap_pos(snap, job->time, buff, job->rr, 1, &job->sol);
+    sdr_buff_free(buff);
+}
+
+//------------------------------------------------------------------------------
+//  Snapshot positioning of snapshots in IF data file in a batch. The snapshots
+//  are processed in parallel by threads with the signal search of a snapshot
+//  in a thread. The IF data of a snapshot is read from the file when the
+//  snapshot is processed and freed after that, so the memory is bounded by
+//  the number of threads independent of the number of snapshots. The
+//  solutions are independent of the number of threads.
+//
+//  args:
+//      snap     (I)  snapshot positioning engine
+//      fp       (I)  IF data file opened by sdr_file_open() (int8 format)
+//      jobs     (IO) snapshot jobs (input: time, toff, rr, output: sol)
+//      n        (I)  number of snapshot jobs
+//      nthread  (I)  number of threads (0: number of CPU cores)
+//
+//  return:
+//      number of snapshots with solution
+//
+int sdr_snap_batch(sdr_snap_t *snap, sdr_file_t *fp, sdr_snap_job_t *jobs,
+    int n, int nthread)
+{
+    snap_batch_t b;
+    int nsol = 0;
+    
+    if (!snap || !fp || n <= 0) return 0;
+    b.snap = snap;
+    b.fp = fp;
+    b.jobs = jobs;
+    pthread_mutex_init(&b.mtx, NULL);
+    
+    sdr_par_for(n, nthread > 0 ? nthread : sdr_get_ncpu(), snap_run_job, &b);
+    
+    pthread_mutex_destroy(&b.mtx);
+    for (int i = 0; i < n; i++) {
+        nsol += jobs[i].sol.ns > 0;
+    }
+    return nsol;
+}
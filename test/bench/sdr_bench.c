@@ -0,0 +1,493 @@
+//
+//  benchmark suite for Pocket SDR library (libsdr)
+//
+//  The kernels, FEC decoders and the SDR receiver by IF data file replay are
+//  timed across the sampling rates and the numbers of channels. The results
+//  are output as JSON to track the performance regressions per commit.
+//
+#include <math.h>
+#include "pocket_sdr.h"
+
+#define MAX_FS      16          // max number of sampling rates
+#define MAX_NCH     16          // max number of channel counts
+#define MAX_TRIAL   64          // max number of trials
+#define T_CODE      1e-3        // code cycle for kernels (s)
+#define SIG_NOISE   0.5         // noise sigma of soft-decision symbols
+
+#define MIN(x, y)   ((x) < (y) ? (x) : (y))
+#define MAX(x, y)   ((x) > (y) ? (x) : (y))
+
+static const char *PERF_STAGE[] = {
+    "read", "write", "srch", "trk", "nav", "dec", "pvt"
+};
+
+// benchmark options -----------------------------------------------------------
+static double fss[MAX_FS] = {8e6, 12e6, 16e6, 24e6, 32e6, 48e6};
+static int nfs = 6;
+static int nchs[MAX_NCH] = {4, 16, 32};
+static int nnch = 3;
+static int ntrial = 5;          // number of trials
+static double tmin = 0.1;       // min time of a trial (s)
+static double tlen = 1.0;       // time length of IF data file replay (s)
+static const char *tmp_dir = "."; // directory of temporary IF data file
+
+// random number by xorshift32 -------------------------------------------------
+static uint32_t rand_x = 2463534242u;
+
+static uint32_t rand_u32(void)
+{
+    rand_x ^= rand_x << 13;
+    rand_x ^= rand_x >> 17;
+    rand_x ^= rand_x << 5;
+    return rand_x;
+}
+
+// generate IF data ------------------------------------------------------------
+static sdr_buff_t *gen_data(int N)
+{
+    static const int8_t val[] = {-3, -1, 1, 3};
+    
+    sdr_buff_t *buff = sdr_buff_new(N, 2);
+    
+    for (int i = 0; i < N; i++) {
+        uint32_t r = rand_u32();
+        buff->data[i] = SDR_CPX8(val[r & 3], val[(r >> 2) & 3]);
+    }
+    return buff;
+}
+
+// soft-decision symbols of all-zero code word with noise ----------------------
+static void gen_syms(int N, uint8_t *ssyms)
+{
+    for (int i = 0; i < N; i++) {
+        double u1 = (rand_u32() + 1.0) / 4294967297.0;
+        double u2 = (rand_u32() + 1.0) / 4294967297.0;
+        double x = -1.0 + SIG_NOISE * sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+        int s = (int)floor(128.0 + x * 64.0);
+        ssyms[i] = (uint8_t)(s < 0 ? 0 : (s > 255 ? 255 : s));
+    }
+}
+
+// compare function for qsort --------------------------------------------------
+static int cmp_dbl(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+// output JSON separator -------------------------------------------------------
+static void out_sep(FILE *fp, int *n)
+{
+    fprintf(fp, "%s\n", (*n)++ ? "," : "");
+}
+
+// time function by trials -----------------------------------------------------
+//  The number of calls per trial is set by the first calls to take tmin s. The
+//  median and the min of the time per call (us) over the trials are returned.
+typedef void (*bench_func_t)(void *arg);
+
+static void bench(bench_func_t func, void *arg, double *t_med, double *t_min)
+{
+    double t[MAX_TRIAL];
+    int nrep = 1;
+    
+    func(arg); // warm-up
+    
+    for (int64_t t0 = sdr_get_tick_ns(); ; nrep *= 2) {
+        for (int i = 0; i < nrep; i++) func(arg);
+        int64_t dt = sdr_get_tick_ns() - t0;
+        if (dt >= tmin * 1e9 / 4.0 || nrep >= (1 << 24)) {
+            nrep = MAX(1, (int)(nrep * 2 * tmin * 1e9 / MAX(dt, 1)));
+            break;
+        }
+        t0 = sdr_get_tick_ns();
+    }
+    for (int i = 0; i < ntrial; i++) {
+        int64_t t0 = sdr_get_tick_ns();
+        for (int j = 0; j < nrep; j++) func(arg);
+        t[i] = (sdr_get_tick_ns() - t0) * 1e-3 / nrep;
+    }
+    qsort(t, ntrial, sizeof(double), cmp_dbl);
+    *t_med = t[ntrial / 2];
+    *t_min = t[0];
+}
+
+// kernel benchmark ------------------------------------------------------------
+typedef struct {
+    sdr_buff_t *buff;           // IF data buffer
+    int N;                      // number of samples
+    double fs;                  // sampling rate (sps)
+    sdr_cpx16_t *code_res;      // resampled code
+    sdr_cpx_t *code_fft;        // code DFT
+    sdr_cpx_t *code_fft2;       // code DFT with zero-padding
+    float *fds;                 // Doppler bins (Hz)
+    int len_fds;                // number of Doppler bins
+    float *P;                   // correlation powers
+    sdr_cpx16_t *IQ;            // carrier-mixed IF data
+    sdr_cpx_t C[4];             // correlations
+} kern_t;
+
+static const int POS[] = {0, -3, 3, -80};
+
+static void run_mix_carr(void *arg)
+{
+    kern_t *k = (kern_t *)arg;
+    sdr_mix_carr(k->buff, 0, k->N, k->fs, 1234.5, 0.3, k->IQ);
+}
+
+static void run_corr_std(void *arg)
+{
+    kern_t *k = (kern_t *)arg;
+    sdr_corr_std(k->buff, 0, k->N, k->fs, 1234.5, 0.3, k->code_res, POS, 4,
+        k->C);
+}
+
+static void run_corr_fft(void *arg)
+{
+    kern_t *k = (kern_t *)arg;
+    sdr_corr_fft(k->buff, 0, k->N, k->fs, 1234.5, 0.3, k->code_fft, k->C);
+}
+
+static void run_search_code(void *arg)
+{
+    kern_t *k = (kern_t *)arg;
+    sdr_search_code(k->code_fft2, T_CODE, k->buff, 0, 2 * k->N, k->fs, 0.0,
+        k->fds, k->len_fds, k->P);
+}
+
+static void bench_kern(FILE *fp)
+{
+    static const struct {
+        const char *name; bench_func_t func;
+    } KERN[] = {
+        {"sdr_mix_carr"   , run_mix_carr   },
+        {"sdr_corr_std"   , run_corr_std   },
+        {"sdr_corr_fft"   , run_corr_fft   },
+        {"sdr_search_code", run_search_code},
+        {NULL}
+    };
+    int len_code, n = 0;
+    int8_t *code = sdr_gen_code("L1CA", 1, &len_code);
+    
+    fprintf(fp, "  \"kernels\": [");
+    
+    for (int i = 0; i < nfs; i++) {
+        kern_t k;
+        memset(&k, 0, sizeof(k));
+        k.fs = fss[i];
+        k.N = (int)(fss[i] * T_CODE);
+        k.buff = gen_data(k.N * 2);
+        k.code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * k.N);
+        k.code_fft = sdr_cpx_malloc(k.N);
+        k.code_fft2 = sdr_cpx_malloc(2 * k.N);
+        k.IQ = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * k.N);
+        sdr_res_code(code, len_code, T_CODE, 0.0, k.fs, k.N, 0, k.code_res);
+        sdr_gen_code_fft(code, len_code, T_CODE, 0.0, k.fs, k.N, 0, k.code_fft);
+        sdr_gen_code_fft(code, len_code, T_CODE, 0.0, k.fs, k.N, k.N,
+            k.code_fft2);
+        k.fds = sdr_dop_bins(T_CODE, 0.0, 5000.0, &k.len_fds);
+        k.P = (float *)sdr_malloc(sizeof(float) * 2 * k.N * k.len_fds);
+        
+        for (int j = 0; KERN[j].name; j++) {
+            double t_med, t_min;
+            bench(KERN[j].func, &k, &t_med, &t_min);
+            out_sep(fp, &n);
+            fprintf(fp, "    {\"name\": \"%s\", \"fs\": %.0f, \"N\": %d, "
+                "\"us\": %.3f, \"us_min\": %.3f, \"msps\": %.2f}", KERN[j].name,
+                k.fs, k.N, t_med, t_min, k.N / t_med);
+            fflush(fp);
+        }
+        sdr_buff_free(k.buff);
+        sdr_free(k.code_res);
+        sdr_cpx_free(k.code_fft);
+        sdr_cpx_free(k.code_fft2);
+        sdr_free(k.IQ);
+        sdr_free(k.fds);
+        sdr_free(k.P);
+    }
+    fprintf(fp, "\n  ],\n");
+}
+
+// decoder benchmark -----------------------------------------------------------
+typedef struct {
+    const char *type;           // LDPC type
+    int N;                      // number of symbols
+    uint8_t syms[1200];         // soft-decision symbols
+    uint8_t dec[1200];          // decoded data
+    sdr_vit_t *vit;             // Viterbi decoder
+} dec_t;
+
+static void run_ldpc(void *arg)
+{
+    dec_t *d = (dec_t *)arg;
+    sdr_decode_LDPC_soft(d->type, d->syms, d->N, d->dec);
+}
+
+static void run_conv(void *arg)
+{
+    dec_t *d = (dec_t *)arg;
+    sdr_decode_conv(d->syms, d->N, d->dec);
+}
+
+static void run_vit(void *arg)
+{
+    dec_t *d = (dec_t *)arg;
+    sdr_vit_update(d->vit, d->syms, 2);
+    sdr_vit_chainback(d->vit, -1, 266, 6, d->dec);
+}
+
+static void bench_dec(FILE *fp)
+{
+    static const struct {
+        const char *name, *type; int N; bench_func_t func;
+    } DEC[] = {
+        {"ldpc"         , "CNV2_SF2" , 1200, run_ldpc},
+        {"ldpc"         , "IRNV1_SF2", 1200, run_ldpc},
+        {"nb_ldpc"      , "BCNV1_SF2", 1200, run_ldpc},
+        {"nb_ldpc"      , "BCNV3"    ,  972, run_ldpc},
+        {"viterbi"      , "block"    ,  544, run_conv},
+        {"viterbi"      , "window"   ,  544, run_vit },
+        {NULL}
+    };
+    dec_t *d = (dec_t *)sdr_malloc(sizeof(dec_t));
+    int n = 0;
+    
+    d->vit = (sdr_vit_t *)sdr_malloc(sizeof(sdr_vit_t));
+    
+    fprintf(fp, "  \"decoders\": [");
+    
+    for (int i = 0; DEC[i].name; i++) {
+        double t_med, t_min;
+        d->type = DEC[i].type;
+        d->N = DEC[i].N;
+        gen_syms(d->N, d->syms);
+        sdr_vit_init(d->vit, -1);
+        sdr_vit_update(d->vit, d->syms, d->N);
+        bench(DEC[i].func, d, &t_med, &t_min);
+        out_sep(fp, &n);
+        fprintf(fp, "    {\"name\": \"%s\", \"type\": \"%s\", \"N\": %d, "
+            "\"us\": %.3f, \"us_min\": %.3f}", DEC[i].name, DEC[i].type,
+            d->N, t_med, t_min);
+        fflush(fp);
+    }
+    fprintf(fp, "\n  ],\n");
+    sdr_free(d->vit);
+    sdr_free(d);
+}
+
+// generate IF data file (int8 x 2 complex) ------------------------------------
+static int gen_file(const char *file, double fs, double tlen)
+{
+    static const int8_t val[] = {-3, -1, 1, 3};
+    int8_t buff[65536];
+    FILE *fp;
+    
+    if (!(fp = fopen(file, "wb"))) {
+        fprintf(stderr, "file open error: %s\n", file);
+        return 0;
+    }
+    for (int64_t n = (int64_t)(fs * tlen) * 2; n > 0; ) {
+        int m = (int)MIN(n, (int64_t)sizeof(buff));
+        for (int i = 0; i < m; i += 2) {
+            uint32_t r = rand_u32();
+            buff[i  ] = val[r & 3];
+            buff[i+1] = val[(r >> 2) & 3];
+        }
+        if ((int)fwrite(buff, 1, m, fp) < m) {
+            fprintf(stderr, "file write error: %s\n", file);
+            fclose(fp);
+            return 0;
+        }
+        n -= m;
+    }
+    fclose(fp);
+    return 1;
+}
+
+// receiver benchmark by IF data file replay -----------------------------------
+//  The IF data of noise is replayed at max speed. The channels search and
+//  re-search signals over the replay as the workload of the acquisition.
+static void bench_rcv(FILE *fp)
+{
+    static const char *sigs[SDR_MAX_NCH];
+    static int prns[SDR_MAX_NCH];
+    const char *paths[] = {"", "", "", "", ""};
+    double fo[SDR_MAX_RFCH] = {1575.42e6}, stat[SDR_N_PERF*5+5+SDR_MAX_NCH];
+    int IQ[SDR_MAX_RFCH] = {2}, n = 0;
+    char file[1024];
+    
+    snprintf(file, sizeof(file), "%s/sdr_bench_%u.bin", tmp_dir,
+        sdr_get_tick());
+    
+    fprintf(fp, "  \"receiver\": [");
+    
+    for (int i = 0; i < nfs; i++) {
+        if (!gen_file(file, fss[i], tlen)) break;
+        
+        for (int j = 0; j < nnch; j++) {
+            int nch = MIN(nchs[j], SDR_MAX_NCH);
+            for (int k = 0; k < nch; k++) {
+                sigs[k] = "L1CA";
+                prns[k] = k % 32 + 1;
+            }
+            int64_t t0 = sdr_get_tick_ns();
+            sdr_rcv_t *rcv = sdr_rcv_open_file(sigs, prns, nch, SDR_FMT_INT8X2,
+                fss[i], fo, IQ, 0.0, 0.0, file, paths);
+            if (!rcv) continue;
+            while (rcv->state) {
+                sdr_sleep_msec(10);
+            }
+            double t = (sdr_get_tick_ns() - t0) * 1e-9;
+            int ns = sdr_rcv_perf_stat(rcv, stat);
+            sdr_rcv_close(rcv);
+            
+            out_sep(fp, &n);
+            fprintf(fp, "    {\"fs\": %.0f, \"nch\": %d, \"tlen\": %.3f, "
+                "\"time\": %.3f, \"speed\": %.3f", fss[i], nch, tlen, t,
+                t > 0.0 ? tlen / t : 0.0);
+            if (ns >= SDR_N_PERF * 5 + 5) {
+                double cpu = 0.0;
+                for (int k = 0; k < SDR_N_PERF; k++) {
+                    double *s = stat + k * 5;
+                    fprintf(fp, ", \"%s\": {\"n\": %.0f, \"ave\": %.3f, "
+                        "\"p50\": %.3f, \"p99\": %.3f, \"max\": %.3f}",
+                        PERF_STAGE[k], s[0], s[1], s[2], s[3], s[4]);
+                }
+                for (int k = 0; k < nch; k++) {
+                    cpu += stat[SDR_N_PERF * 5 + 5 + k];
+                }
+                fprintf(fp, ", \"buff_max\": %.1f, \"cpu_ch\": %.2f",
+                    stat[SDR_N_PERF * 5 + 1], cpu / nch);
+            }
+            fprintf(fp, "}");
+            fflush(fp);
+        }
+        remove(file);
+    }
+    fprintf(fp, "\n  ]\n");
+}
+
+// parse comma-separated list --------------------------------------------------
+static int parse_list(const char *str, double scale, double *val, int nmax)
+{
+    char buff[256], *p, *q;
+    int n = 0;
+    
+    snprintf(buff, sizeof(buff), "%s", str);
+    for (p = buff; n < nmax; p = q + 1) {
+        if ((q = strchr(p, ','))) *q = '\0';
+        val[n++] = atof(p) * scale;
+        if (!q) break;
+    }
+    return n;
+}
+
+//------------------------------------------------------------------------------
+//  Synopsis
+//
+//    sdr_bench [-fs f[,f...]] [-nch n[,n...]] [-trial n] [-tmin t] [-tlen t]
+//        [-kern] [-dec] [-rcv] [-tag str] [-tmp dir] [-out file]
+//
+//  Description
+//
+//    Run the benchmarks of libsdr and output the results as JSON. Without
+//    -kern, -dec or -rcv, all of the benchmarks are run. The time per call
+//    (us) is the median over the trials.
+//
+//  Options ([]: default)
+//
+//    -fs f[,f...]
+//        Sampling rates (Msps). [8,12,16,24,32,48]
+//
+//    -nch n[,n...]
+//        Numbers of receiver channels for the IF data file replay. [4,16,32]
+//
+//    -trial n
+//        Number of trials of the kernels and the decoders. [5]
+//
+//    -tmin t
+//        Min time of a trial (s). [0.1]
+//
+//    -tlen t
+//        Time length of the IF data file replay (s). [1.0]
+//
+//    -kern, -dec, -rcv
+//        Run the benchmarks of the kernels, the decoders or the receiver.
+//
+//    -tag str
+//        Tag of the results (e.g. commit hash). [""]
+//
+//    -tmp dir
+//        Directory of the temporary IF data file. [.]
+//
+//    -out file
+//        Output JSON file. [stdout]
+//
+int main(int argc, char **argv)
+{
+    const char *tag = "", *out_file = "";
+    double val[MAX_NCH];
+    int kern = 0, dec = 0, rcv = 0;
+    FILE *fp = stdout;
+    
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-fs") && i + 1 < argc) {
+            nfs = parse_list(argv[++i], 1e6, fss, MAX_FS);
+        }
+        else if (!strcmp(argv[i], "-nch") && i + 1 < argc) {
+            nnch = parse_list(argv[++i], 1.0, val, MAX_NCH);
+            for (int j = 0; j < nnch; j++) nchs[j] = (int)val[j];
+        }
+        else if (!strcmp(argv[i], "-trial") && i + 1 < argc) {
+            ntrial = atoi(argv[++i]);
+            ntrial = ntrial < 1 ? 1 : MIN(ntrial, MAX_TRIAL);
+        }
+        else if (!strcmp(argv[i], "-tmin") && i + 1 < argc) {
+            tmin = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-tlen") && i + 1 < argc) {
+            tlen = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-kern")) {
+            kern = 1;
+        }
+        else if (!strcmp(argv[i], "-dec")) {
+            dec = 1;
+        }
+        else if (!strcmp(argv[i], "-rcv")) {
+            rcv = 1;
+        }
+        else if (!strcmp(argv[i], "-tag") && i + 1 < argc) {
+            tag = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-tmp") && i + 1 < argc) {
+            tmp_dir = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-out") && i + 1 < argc) {
+            out_file = argv[++i];
+        }
+        else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return -1;
+        }
+    }
+    if (!kern && !dec && !rcv) {
+        kern = dec = rcv = 1;
+    }
+    if (*out_file && !(fp = fopen(out_file, "w"))) {
+        fprintf(stderr, "file open error: %s\n", out_file);
+        return -1;
+    }
+    sdr_func_init("../../python/fftw_wisdom.txt");
+    
+    fprintf(fp, "{\n  \"tag\": \"%s\", \"simd\": %d, \"trial\": %d,\n", tag,
+        sdr_get_simd(), ntrial);
+    if (kern) bench_kern(fp);
+    if (dec) bench_dec(fp);
+    if (rcv) bench_rcv(fp);
+    else fprintf(fp, "  \"receiver\": []\n");
+    fprintf(fp, "}\n");
+    
+    if (fp != stdout) fclose(fp);
+    return 0;
+}
@@ -0,0 +1,162 @@
+//
+//  unit test driver for sdr_fec.c
+//
+#include "pocket_sdr.h"
+
+#define NREP      10000 // number of repetitions of benchmark
+
+// encode convolution code (K=7, R=1/2, Poly=G1:0x4F,G2:0x6D) ------------------
+static void encode_conv(const uint8_t *data, int N, uint8_t *syms)
+{
+    uint32_t R = 0;
+    
+    for (int i = 0; i < N; i++) {
+        R = ((R << 1) | data[i]) & 0x7F;
+        syms[i*2  ] = __builtin_popcount(R & 0x4F) & 1;
+        syms[i*2+1] = __builtin_popcount(R & 0x6D) & 1;
+    }
+}
+
+// soft-decision symbols with noise --------------------------------------------
+static void soft_syms(const uint8_t *syms, int N, double sig, uint8_t *ssyms)
+{
+    for (int i = 0; i < N; i++) {
+        double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+        double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+        double x = (syms[i] ? 1.0 : -1.0) + sig * sqrt(-2.0 * log(u1)) *
+            cos(2.0 * PI * u2);
+        int s = (int)floor(128.0 + x * 64.0);
+        ssyms[i] = (uint8_t)(s < 0 ? 0 : (s > 255 ? 255 : s));
+    }
+}
+
+// test sdr_decode_conv() ------------------------------------------------------
+//  All SIMD variants should output the same decoded data as the scalar.
+static void test_01(void)
+{
+    static const int N[] = {12, 24, 56, 114, 160, 201, 244, 500, 767, 0};
+    static const double sig[] = {0.0, 0.5, 0.8};
+    uint8_t data[800], syms[1600], ssyms[1600], dec[800], ref[800];
+    int simd0 = sdr_get_simd();
+    
+    for (int i = 0; N[i]; i++) {
+        for (int j = 0; j < N[i]; j++) {
+            data[j] = j < N[i] - 6 ? rand() % 2 : 0;
+        }
+        encode_conv(data, N[i], syms);
+        
+        for (int k = 0; k < 3; k++) {
+            soft_syms(syms, N[i] * 2, sig[k], ssyms);
+            int nerr = 0;
+            for (int simd = SDR_SIMD_C; simd <= SDR_SIMD_NEON; simd++) {
+                if (!sdr_set_simd(simd)) continue;
+                sdr_decode_conv(ssyms, N[i] * 2, dec);
+                if (simd == SDR_SIMD_C) {
+                    memcpy(ref, dec, N[i] - 6);
+                }
+                else if (memcmp(dec, ref, N[i] - 6)) {
+                    printf("sdr_decode_conv() error N=%d simd=%d\n", N[i],
+                        simd);
+                    exit(-1);
+                }
+            }
+            for (int j = 0; j < N[i] - 6; j++) {
+                nerr += dec[j] != data[j];
+            }
+            if (sig[k] == 0.0 && nerr) {
+                printf("sdr_decode_conv() error N=%d nerr=%d\n", N[i], nerr);
+                exit(-1);
+            }
+            printf("test_01: N=%4d SIG=%.1f NERR=%3d\n", N[i], sig[k], nerr);
+        }
+    }
+    sdr_set_simd(simd0);
+    printf("test_01: OK\n");
+}
+
+// test sdr_vit_update(), sdr_vit_chainback() as sliding window ----------------
+//  The windows of 272 steps (544 syms) are decoded at every step of symbols.
+static void test_02(void)
+{
+    uint8_t data[2000], syms[4000], ssyms[4000], bits[266];
+    int simd0 = sdr_get_simd(), N = 2000;
+    
+    for (int i = 0; i < N; i++) {
+        data[i] = rand() % 2;
+    }
+    encode_conv(data, N, syms);
+    soft_syms(syms, N * 2, 0.5, ssyms);
+    
+    for (int simd = SDR_SIMD_C; simd <= SDR_SIMD_NEON; simd++) {
+        if (!sdr_set_simd(simd)) continue;
+        sdr_vit_t *vit = (sdr_vit_t *)sdr_malloc(sizeof(sdr_vit_t));
+        int nerr = 0, nwin = 0;
+        sdr_vit_init(vit, -1);
+        
+        for (int i = 0; i < N; i++) {
+            sdr_vit_update(vit, ssyms + i * 2, 2);
+            if (!sdr_vit_chainback(vit, -1, 266, 6, bits)) continue;
+            for (int j = 0; j < 266; j++) {
+                nerr += bits[j] != data[i-271+j];
+            }
+            nwin++;
+        }
+        if (nwin != N - 271 || nerr > nwin * 266 / 1000) {
+            printf("sdr_vit_chainback() error simd=%d nwin=%d nerr=%d\n",
+                simd, nwin, nerr);
+            exit(-1);
+        }
+        printf("test_02: simd=%d NWIN=%d BER=%.5f\n", simd, nwin,
+            (double)nerr / (nwin * 266));
+        sdr_free(vit);
+    }
+    sdr_set_simd(simd0);
+    printf("test_02: OK\n");
+}
+
+// test benchmark of sdr_decode_conv() and sdr_vit_update() --------------------
+//  The frame search by sdr_decode_conv() of 544 syms at every step is compared
+//  with the incremental update and the chainback of the sliding window.
+static void test_03(void)
+{
+    uint8_t ssyms[544], bits[266];
+    int simd0 = sdr_get_simd();
+    
+    for (int i = 0; i < 544; i++) {
+        ssyms[i] = (uint8_t)(rand() % 256);
+    }
+    for (int simd = SDR_SIMD_C; simd <= SDR_SIMD_NEON; simd++) {
+        if (!sdr_set_simd(simd)) continue;
+        sdr_vit_t *vit = (sdr_vit_t *)sdr_malloc(sizeof(sdr_vit_t));
+        sdr_vit_init(vit, -1);
+        sdr_vit_update(vit, ssyms, 544);
+        
+        uint32_t tick = sdr_get_tick();
+        for (int i = 0; i < NREP; i++) {
+            sdr_decode_conv(ssyms, 544, bits);
+        }
+        double t1 = (sdr_get_tick() - tick) * 1e3 / NREP;
+        tick = sdr_get_tick();
+        for (int i = 0; i < NREP; i++) {
+            sdr_vit_update(vit, ssyms, 2);
+            sdr_vit_chainback(vit, -1, 266, 6, bits);
+        }
+        double t2 = (sdr_get_tick() - tick) * 1e3 / NREP;
+        printf("test_03: simd=%d TIME=%6.2f us/search (block) %6.2f us/search "
+            "(incremental)\n", simd, t1, t2);
+        sdr_free(vit);
+    }
+    sdr_set_simd(simd0);
+    printf("test_03: OK\n");
+}
+
+// test main --------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    sdr_func_init("../../python/fftw_wisdom.txt");
+    
+    test_01();
+    test_02();
+    test_03();
+    return 0;
+}
@@ -258,6 +258,423 @@ static void test_05(void)
     printf("test_05: OK\n");
 }
 
+// test sdr_atan2_blk() -------------------------------------------------------
+static void test_06(void)
+{
+    static const int N[] = {1, 3, 4, 7, 100, 10000, 0};
+    
+    for (int i = 0; N[i]; i++) {
+        double *y = (double *)sdr_malloc(sizeof(double) * N[i]);
+        double *x = (double *)sdr_malloc(sizeof(double) * N[i]);
+        double *z = (double *)sdr_malloc(sizeof(double) * N[i]);
+        
+        for (int j = 0; j < N[i]; j++) {
+            y[j] = (rand() % 2001 - 1000) / 100.0;
+            x[j] = (rand() % 2000 - 1000 + 0.5) / 100.0;
+        }
+        sdr_atan2_blk(y, x, N[i], z);
+        
+        for (int j = 0; j < N[i]; j++) {
+            if (fabs(z[j] - atan2(y[j], x[j])) > 1e-14) {
+                printf("sdr_atan2_blk() error N=%d z=%.15f : %.15f\n", N[i],
+                    z[j], atan2(y[j], x[j]));
+                exit(-1);
+            }
+        }
+        sdr_free(y);
+        sdr_free(x);
+        sdr_free(z);
+        
+        printf("test_06: sdr_atan2_blk() N=%6d OK\n", N[i]);
+    }
+    printf("test_06: OK\n");
+}
+
+// test sdr_corr_std_multi() --------------------------------------------------
+static void test_07(void)
+{
+    static const int n[] = {1, 2, 8, 0};
+    int N = 4000, len_code, pos[] = {0, -3, 3, -80};
+    double fs = 4e6;
+    sdr_buff_t *buff = gen_data(N * 4);
+    int8_t *code = sdr_gen_code("L1CA", 1, &len_code);
+    sdr_cpx16_t *code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    sdr_res_code(code, len_code, 1e-3, 0.0, fs, N, 0, code_res);
+    
+    for (int i = 0; n[i]; i++) {
+        sdr_corr_job_t jobs[8];
+        sdr_cpx_t C[8][4], ref[4];
+        
+        for (int k = 0; k < n[i]; k++) {
+            jobs[k].ix = rand() % (N * 4); // including IF buffer boundary
+            jobs[k].N = N;
+            jobs[k].fs = fs;
+            jobs[k].fc = (rand() % 10001 - 5000) * 1.0;
+            jobs[k].phi = (rand() % 1000) / 1000.0;
+            jobs[k].code = code_res;
+            jobs[k].pos = pos;
+            jobs[k].npos = 4;
+            jobs[k].corr = C[k];
+        }
+        sdr_corr_std_multi(buff, jobs, n[i]);
+        
+        for (int k = 0; k < n[i]; k++) {
+            sdr_corr_std(buff, jobs[k].ix, N, fs, jobs[k].fc, jobs[k].phi,
+                code_res, pos, 4, ref);
+            if (memcmp(ref, C[k], sizeof(ref))) {
+                printf("sdr_corr_std_multi() error n=%d k=%d\n", n[i], k);
+                exit(-1);
+            }
+        }
+        printf("test_07: sdr_corr_std_multi() n=%d OK\n", n[i]);
+    }
+    sdr_free(code_res);
+    sdr_buff_free(buff);
+    printf("test_07: OK\n");
+}
+
+// correlation loss of mixed data to ideal carrier mixing (dB) ----------------
+static double mix_loss(const sdr_buff_t *buff, int N, double fs, double fc,
+    double phi, const sdr_cpx16_t *IQ)
+{
+    double R[2] = {0}, P1 = 0.0, P2 = 0.0;
+    
+    for (int i = 0; i < N; i++) {
+        double I = SDR_CPX8_I(buff->data[i]), Q = SDR_CPX8_Q(buff->data[i]);
+        double ph = -2.0 * PI * (phi + fc / fs * i);
+        double zI = I * cos(ph) - Q * sin(ph), zQ = I * sin(ph) + Q * cos(ph);
+        R[0] += IQ[i].I * zI + IQ[i].Q * zQ;
+        R[1] += IQ[i].Q * zI - IQ[i].I * zQ;
+        P1 += SQR(IQ[i].I) + SQR(IQ[i].Q);
+        P2 += SQR(zI) + SQR(zQ);
+    }
+    return -10.0 * log10((SQR(R[0]) + SQR(R[1])) / (P1 * P2));
+}
+
+// test sdr_set_mix(): speed and correlation loss of carrier mixers ------------
+static void test_08(void)
+{
+    static const char *name[] = {"LUT", "NCO"};
+    int n = 2000, N = 24000;
+    double fs = 12e6, fc = 13579.1, phi = 0.123;
+    sdr_buff_t *buff = gen_data(N);
+    sdr_cpx16_t *IQ[2];
+    
+    for (int i = 0; i < 2; i++) {
+        IQ[i] = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+        sdr_set_mix(i == 0 ? SDR_MIX_LUT : SDR_MIX_NCO);
+        
+        uint32_t tt = sdr_get_tick();
+        for (int j = 0; j < n; j++) {
+            sdr_mix_carr(buff, 0, N, fs, fc, phi, IQ[i]);
+        }
+        double t = (double)(sdr_get_tick() - tt) / n;
+        
+        printf("test_08: mixer=%s N=%d time=%8.4f ms loss=%.4f dB\n", name[i],
+            N, t, mix_loss(buff, N, fs, fc, phi, IQ[i]));
+    }
+    // polynomial NCO mixer of SIMD variants within +/-1
+    sdr_cpx16_t *IQ_c = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    int simd = sdr_get_simd();
+    sdr_set_simd(SDR_SIMD_C);
+    sdr_mix_carr(buff, 0, N, fs, fc, phi, IQ_c);
+    sdr_set_simd(simd);
+    for (int i = 0; i < N; i++) {
+        if (abs(IQ_c[i].I - IQ[1][i].I) > 1 || abs(IQ_c[i].Q - IQ[1][i].Q) > 1) {
+            printf("sdr_mix_carr() NCO error i=%d %d/%d : %d/%d\n", i,
+                IQ[1][i].I, IQ[1][i].Q, IQ_c[i].I, IQ_c[i].Q);
+            exit(-1);
+        }
+    }
+    sdr_set_mix(SDR_MIX_LUT);
+    sdr_free(IQ[0]);
+    sdr_free(IQ[1]);
+    sdr_free(IQ_c);
+    sdr_buff_free(buff);
+    printf("test_08: OK\n");
+}
+
+// test sdr_buff_new_pack(): carrier mixers and correlator of packed IF data --
+static void test_09(void)
+{
+    int N = 12000, M = 5000, pos[] = {0, -3, 3};
+    sdr_buff_t *pack = sdr_buff_new_pack(N, 2), *buff = sdr_buff_new(N, 2);
+    sdr_cpx16_t *IQ[2], code[5000];
+    sdr_cpx_t C[2][3];
+    
+    for (int i = 0; i < (N + 1) / 2; i++) {
+        pack->data[i] = (uint8_t)rand();
+    }
+    for (int i = 0; i < N; i++) {
+        buff->data[i] = sdr_buff_get(pack, i);
+    }
+    for (int i = 0; i < M; i++) {
+        code[i].I = code[i].Q = rand() % 2 ? 1 : -1;
+    }
+    for (int i = 0; i < 2; i++) {
+        IQ[i] = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * M);
+    }
+    for (int i = 0; i < 2; i++) {
+        sdr_set_mix(i == 0 ? SDR_MIX_LUT : SDR_MIX_NCO);
+        for (int j = 0; j < 20; j++) {
+            int ix = rand() % N; // including odd index and IF buffer boundary
+            double fc = (rand() % 10001 - 5000) * 1.0, phi = 0.37;
+            sdr_mix_carr(pack, ix, M, 12e6, fc, phi, IQ[0]);
+            sdr_mix_carr(buff, ix, M, 12e6, fc, phi, IQ[1]);
+            sdr_corr_std(pack, ix, M, 12e6, fc, phi, code, pos, 3, C[0]);
+            sdr_corr_std(buff, ix, M, 12e6, fc, phi, code, pos, 3, C[1]);
+            if (memcmp(IQ[0], IQ[1], sizeof(sdr_cpx16_t) * M) ||
+                memcmp(C[0], C[1], sizeof(C[0]))) {
+                printf("packed IF data error mix=%d ix=%d\n", i, ix);
+                exit(-1);
+            }
+        }
+        printf("test_09: mix=%d packed IF data OK\n", i);
+    }
+    sdr_set_mix(SDR_MIX_LUT);
+    sdr_free(IQ[0]);
+    sdr_free(IQ[1]);
+    sdr_buff_free(pack);
+    sdr_buff_free(buff);
+    printf("test_09: OK\n");
+}
+
+// output logs of test_10 -----------------------------------------------------
+static void out_logs(int n)
+{
+    for (int i = 0; i < n; i++) {
+        double t = i * 0.02 + 0.001;
+        sdr_log(3, "$CH,%.3f,%s,%d,%d,%.1f,%.9f,%.3f,%.3f,%d,%d", t, "L1CA",
+            i % 32 + 1, 1, 45.3 - i * 1e-3, 0.123456789 * i, -1234.567,
+            1e5 + i * 0.37, i, 2 * i);
+        sdr_log(3, "$LOG,%.3f,%s,%d,IF DATA GAP %lld %5.1f%% [%*d]", t, "",
+            0, (long long)i << 33, i * 0.5, 6, -i);
+    }
+}
+
+static void *log_thread(void *arg)
+{
+    out_logs(*(int *)arg);
+    return NULL;
+}
+
+// read file -------------------------------------------------------------------
+static char *read_file(const char *file, long *size)
+{
+    FILE *fp = fopen(file, "rb");
+    char *buff = NULL;
+    
+    *size = 0;
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    buff = (char *)sdr_malloc(*size + 1);
+    *size = (long)fread(buff, 1, *size, fp);
+    fclose(fp);
+    return buff;
+}
+
+// test sdr_log_format(), sdr_log_conv(): binary log ---------------------------
+static void test_10(void)
+{
+    const char *file[] = {"test_log.txt", "test_log.bin", "test_log_conv.txt"};
+    pthread_t th[4];
+    int n = 20000;
+    long size[3];
+    
+    for (int i = 0; i < 2; i++) { // text and binary log
+        sdr_log_format(i == 0 ? SDR_LOG_TEXT : SDR_LOG_BIN);
+        sdr_log_open(file[i]);
+        uint32_t tick = sdr_get_tick();
+        out_logs(n);
+        tick = sdr_get_tick() - tick;
+        sdr_log_close();
+        printf("test_10: format=%d TIME=%.3f us/log\n", i,
+            tick * 1e3 / (2 * n));
+    }
+    FILE *ifp = fopen(file[1], "rb"), *ofp = fopen(file[2], "wb");
+    int nrec = sdr_log_conv(ifp, ofp);
+    fclose(ifp);
+    fclose(ofp);
+    char *buff[3];
+    for (int i = 0; i < 3; i++) {
+        buff[i] = read_file(file[i], size + i);
+    }
+    printf("test_10: SIZE(text/bin)=%ld/%ld bytes\n", size[0], size[1]);
+    if (nrec != 2 * n || size[0] != size[2] || !buff[0] || !buff[2] ||
+        memcmp(buff[0], buff[2], size[0])) {
+        printf("binary log conversion error nrec=%d\n", nrec);
+        exit(-1);
+    }
+    for (int i = 0; i < 3; i++) {
+        sdr_free(buff[i]);
+    }
+    // binary log by multiple threads
+    sdr_log_open(file[1]);
+    for (int i = 0; i < 4; i++) {
+        pthread_create(th + i, NULL, log_thread, &n);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(th[i], NULL);
+    }
+    out_logs(n);
+    sdr_log_close();
+    ifp = fopen(file[1], "rb");
+    ofp = fopen(file[2], "wb");
+    nrec = sdr_log_conv(ifp, ofp);
+    fclose(ifp);
+    fclose(ofp);
+    if (nrec != 10 * n) {
+        printf("binary log multi-thread error nrec=%d\n", nrec);
+        exit(-1);
+    }
+    sdr_log_format(SDR_LOG_TEXT);
+    for (int i = 0; i < 3; i++) {
+        remove(file[i]);
+    }
+    printf("test_10: OK\n");
+}
+
+// test sdr_mon_update(), sdr_mon_psd(), sdr_mon_hist(): IF data monitor -------
+//  The PSD peak should be at the tone frequency. The PSDs and the histograms
+//  of packed and unpacked IF data buffers should be the same.
+static void test_11(void)
+{
+    double fs = 12e6, fc = 1.5e6;
+    int N = 2048, L = 12000, M = L * 8, val[256];
+    sdr_buff_t *buff[3];
+    sdr_mon_t *mon[3];
+    float *psd[3];
+    double hist1[3][256], hist2[3][256];
+    
+    buff[0] = sdr_buff_new(M, 2);
+    buff[1] = sdr_buff_new_pack(M, 2);
+    buff[2] = sdr_buff_new(M, 2);
+    for (int i = 0; i < 3; i++) {
+        mon[i] = sdr_mon_new(fs, 2);
+        psd[i] = (float *)sdr_malloc(sizeof(float) * N);
+        if (sdr_mon_psd(mon[i], 0.1, N, psd[i]) ||
+            sdr_mon_hist(mon[i], 0.1, val, hist1[i], hist2[i])) {
+            printf("sdr_mon_psd() error: PSD not empty\n");
+            exit(-1);
+        }
+    }
+    for (int i = 0; i < (M + 1) / 2; i++) {
+        buff[1]->data[i] = (uint8_t)rand();
+    }
+    for (int i = 0; i < M; i++) {
+        double phi = 2.0 * PI * fc / fs * i;
+        int I = (int)floor(3.0 * cos(phi) + rand() % 3 - 0.5);
+        int Q = (int)floor(3.0 * sin(phi) + rand() % 3 - 0.5);
+        buff[0]->data[i] = SDR_CPX8(I, Q);
+        buff[2]->data[i] = sdr_buff_get(buff[1], i);
+    }
+    int64_t tick = sdr_get_tick_ns();
+    for (int i = 0; i < 100; i++) { // 1 s IF data (including buffer boundary)
+        for (int j = 0; j < 3; j++) {
+            sdr_mon_update(mon[j], buff[j], L * (i % 8), L);
+        }
+    }
+    double t1 = (sdr_get_tick_ns() - tick) * 1e-3 / 300;
+    tick = sdr_get_tick_ns();
+    int n[3], nval[3];
+    for (int i = 0; i < 3; i++) {
+        n[i] = sdr_mon_psd(mon[i], 0.1, N, psd[i]);
+        nval[i] = sdr_mon_hist(mon[i], 0.1, val, hist1[i], hist2[i]);
+    }
+    double t2 = (sdr_get_tick_ns() - tick) * 1e-3 / 3;
+    int imax = 0;
+    for (int i = 0; i < N; i++) {
+        if (psd[0][i] > psd[0][imax]) imax = i;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < nval[0]; i++) {
+        sum += hist1[0][i];
+    }
+    if (n[0] != N || imax != N / 2 + (int)(fc / fs * N) ||
+        fabs(sum - 1.0) > 1e-6) {
+        printf("sdr_mon_psd() error n=%d imax=%d sum=%.6f\n", n[0], imax, sum);
+        exit(-1);
+    }
+    if (n[1] != n[2] || nval[1] != nval[2] ||
+        memcmp(psd[1], psd[2], sizeof(float) * N) ||
+        memcmp(hist1[1], hist1[2], sizeof(double) * nval[1]) ||
+        memcmp(hist2[1], hist2[2], sizeof(double) * nval[1])) {
+        printf("sdr_mon_psd() error: packed IF data\n");
+        exit(-1);
+    }
+    printf("test_11: N=%d IMAX=%d NVAL=%d TIME=%.1f us/update %.1f us/query\n",
+        n[0], imax, nval[0], t1, t2);
+    for (int i = 0; i < 3; i++) {
+        sdr_mon_free(mon[i]);
+        sdr_buff_free(buff[i]);
+        sdr_free(psd[i]);
+    }
+    printf("test_11: OK\n");
+}
+
+// test CSK demodulator --------------------------------------------------------
+//  The CSK symbols of L6D shifted by the lags should be detected with the P
+//  correlation at the peak. The time is compared with the FFT correlator of
+//  the code cycle samples.
+static void test_12(void)
+{
+    static const int lags[] = {0, 1, 37, 128, 255, -1, -255};
+    double fs = 16.384e6, T = 4e-3, chip = -0.37;
+    int N = (int)(fs * T), len_code, pos[] = {0, -2, 2, -80}, n = 100;
+    int8_t *code = sdr_gen_code("L6D", 193, &len_code);
+    double step = len_code / T / fs;
+    sdr_csk_t *csk = sdr_csk_new(sdr_gen_code_pack("L6D", 193), N, 256);
+    sdr_buff_t *buff = sdr_buff_new(N, 2);
+    sdr_cpx_t *code_fft = sdr_cpx_malloc(N);
+    sdr_cpx_t *corr = sdr_cpx_malloc(N), C[4];
+    
+    if (!csk) {
+        printf("sdr_csk_new() error\n");
+        exit(-1);
+    }
+    for (int i = 0; i < (int)(sizeof(lags) / sizeof(lags[0])); i++) {
+        for (int j = 0; j < N; j++) {
+            int c = (int)floor(chip + step * j) - lags[i] * 2;
+            c = (c % len_code + len_code) % len_code;
+            buff->data[j] = SDR_CPX8(2 * code[c] + rand() % 3 - 1,
+                rand() % 3 - 1);
+        }
+        int lag = sdr_csk_corr(csk, buff, 0, fs, 0.0, 0.0, chip, step, pos, 4,
+            C);
+        double P[4];
+        for (int j = 0; j < 4; j++) {
+            P[j] = SQR(C[j][0]) + SQR(C[j][1]);
+        }
+        printf("test_12: lag=%4d/%4d P=%8.5f %8.5f %8.5f %8.5f\n", lags[i],
+            lag, P[0], P[1], P[2], P[3]);
+        if (lag != lags[i] || P[0] < P[1] || P[0] < P[2] ||
+            P[0] < P[3] * 100.0) {
+            printf("sdr_csk_corr() error\n");
+            exit(-1);
+        }
+    }
+    sdr_gen_code_fft(code, len_code, T, 0.0, fs, N, 0, code_fft);
+    int64_t tick = sdr_get_tick_ns();
+    for (int i = 0; i < n; i++) {
+        sdr_csk_corr(csk, buff, 0, fs, 0.0, 0.0, chip, step, pos, 4, C);
+    }
+    double t1 = (sdr_get_tick_ns() - tick) * 1e-3 / n;
+    tick = sdr_get_tick_ns();
+    for (int i = 0; i < n; i++) {
+        sdr_corr_fft(buff, 0, N, fs, 0.0, 0.0, code_fft, corr);
+    }
+    double t2 = (sdr_get_tick_ns() - tick) * 1e-3 / n;
+    printf("test_12: N=%d M=%d TIME=%.1f us/cyc (FFT correlator %.1f us/cyc)\n",
+        N, csk->M, t1, t2);
+    sdr_csk_free(csk);
+    sdr_buff_free(buff);
+    sdr_cpx_free(code_fft);
+    sdr_cpx_free(corr);
+    printf("test_12: OK\n");
+}
+
 // test main --------------------------------------------------------------------
 int main(int argc, char **argv)
 {
@@ -268,6 +685,13 @@ int main(int argc, char **argv)
     test_03();
     test_04();
     test_05();
+    test_06();
+    test_07();
+    test_08();
+    test_09();
+    test_10();
+    test_11();
+    test_12();
     return 0;
 }
 
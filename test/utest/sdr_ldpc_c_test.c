@@ -0,0 +1,111 @@
+//
+//  unit test driver for sdr_ldpc.c and sdr_nb_ldpc.c
+//
+#include "pocket_sdr.h"
+
+#define NERR_MAX  50    // max number of bit errors
+#define NREP      20    // number of repetitions of benchmark
+
+// NB-LDPC test frames (from sdr_ldpc_test.py) ---------------------------------
+static const struct {
+    const char *type;   // LDPC type
+    int N, M;           // number of code and data bits
+    int rev;            // reversed data bits
+    const char *hex;    // frame in HEX
+} FRAME[] = {
+    {"BCNV1_SF2", 1200, 600, 1,
+     "E29417E5E488CFF56B7400A6E5A913FFDDFDA2BC2D24FFDE13"
+     "646E5871242E58AF0ABB304DEDF129AA1F300113FF63FF5C33"
+     "FE285BF9EF7FF77D446CEC29AFFB643FF850009735FF686476"
+     "22A2022B600C9CDB862DACD6F7631DCA245DF40282E5EFA760"
+     "FEE9B388139C4556285A26804BBB190A362A57170332578BDD"
+     "0CC86477BE72F8652E50BFFDC15657AEB45B0CA4D72DF218CA"},
+    {"BCNV1_SF3", 528, 264, 1,
+     "FBFFF43E4E32A1BB5BCB5F7FEFBF80040FFFFFFB92D8E297F0"
+     "8FDFFFFFFF8BAD2ED0ED560D1E7B17EF7E1D466C7E14095B75"
+     "3528732B0DBBED18F225F8E1BC388956"},
+    {"BCNV2", 576, 288, 0,
+     "5CA92F4075A0006DDCC02A522FFD64695BB0008809750F4B6C"
+     "0087B26E469E3B6FD2C19F13FAD5D6C360E72ED54C2607B594"
+     "A4CF0EDB258BBD81AFDF27A700E0BB872ACAA9B0A73B"},
+    {"BCNV3", 972, 486, 0,
+     "79B9BF475BB772627ACA00937800F6435791290D282004101F"
+     "FEFC0000011B49C75A03DC08D2F01B2DFE098366E90DF20005"
+     "BC17F8265E2D8E02CD89E047DF0CEDC6740BD2CFA83AF11A1F"
+     "69B4788A31A3A8C49FBAA27BB5B9798E1F40C9CF58717DA2D4"
+     "416B00875AD79686186DAF781D981E0AAA14E7588C1"},
+    {NULL}
+};
+
+// read HEX string -------------------------------------------------------------
+static void read_hex(const char *hex, int N, uint8_t *data)
+{
+    for (int i = 0; i < N; i++) {
+        char c = hex[i / 4];
+        int val = c <= '9' ? c - '0' : c - 'A' + 10;
+        data[i] = (val >> (3 - i % 4)) & 1;
+    }
+}
+
+// test sdr_decode_LDPC() of NB-LDPC codes -------------------------------------
+//  All SIMD variants should output the same decoded data as the scalar.
+static void test_01(void)
+{
+    uint8_t data[1200], err_data[NERR_MAX][1200], dec_data[600];
+    uint8_t ref_data[NERR_MAX][600];
+    int ref_nerr[NERR_MAX], simd0 = sdr_get_simd();
+    
+    for (int i = 0; FRAME[i].type; i++) {
+        int N = FRAME[i].N, M = FRAME[i].M;
+        read_hex(FRAME[i].hex, N, data);
+        
+        for (int n = 0; n < NERR_MAX; n++) {
+            memcpy(err_data[n], data, N);
+            for (int j = 0; j < n; j++) {
+                err_data[n][rand() % N] ^= 1;
+            }
+        }
+        for (int simd = SDR_SIMD_C; simd <= SDR_SIMD_NEON; simd++) {
+            if (!sdr_set_simd(simd)) continue;
+            int ok = 0, ng = 0;
+            uint32_t tick = sdr_get_tick();
+            
+            for (int k = 0; k < NREP; k++) {
+                for (int n = 0; n < NERR_MAX; n++) {
+                    int nerr = sdr_decode_LDPC(FRAME[i].type, err_data[n], N,
+                        dec_data);
+                    if (simd == SDR_SIMD_C && k == 0) {
+                        ref_nerr[n] = nerr;
+                        memcpy(ref_data[n], dec_data, M);
+                    }
+                    else if (nerr != ref_nerr[n] || (nerr >= 0 &&
+                        memcmp(dec_data, ref_data[n], M))) {
+                        printf("sdr_decode_LDPC() error type=%s simd=%d n=%d\n",
+                            FRAME[i].type, simd, n);
+                        exit(-1);
+                    }
+                    if (k > 0) continue;
+                    int good = nerr >= 0;
+                    for (int j = 0; j < M && good; j++) {
+                        good = (dec_data[j] ^ FRAME[i].rev) == data[j];
+                    }
+                    if (good) ok++; else ng++;
+                }
+            }
+            tick = sdr_get_tick() - tick;
+            printf("test_01: %-9s simd=%d OK/NG=%3d/%3d TIME=%7.1f us/frame\n",
+                FRAME[i].type, simd, ok, ng, tick * 1e3 / (NREP * NERR_MAX));
+        }
+    }
+    sdr_set_simd(simd0);
+    printf("test_01: OK\n");
+}
+
+// test main --------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    sdr_func_init("../../python/fftw_wisdom.txt");
+    
+    test_01();
+    return 0;
+}
@@ -0,0 +1,506 @@
+//
+//  unit test driver for sdr_sim.c
+//
+#include <math.h>
+#include "pocket_sdr.h"
+
+// add satellites to simulator -------------------------------------------------
+static void add_sats(sdr_sim_t *sim, int nsat)
+{
+    uint8_t data[300];
+    
+    for (int i = 0; i < 300; i++) {
+        data[i] = rand() % 2;
+    }
+    for (int i = 0; i < nsat; i++) {
+        double dop = (rand() % 10000) - 5000.0;
+        double coff = (rand() % 1000) * 1e-6;
+        if (!sdr_sim_add_sat(sim, i % 2 ? "L1CA" : "L2CM", i % 32 + 1, dop,
+            0.5, 45.0, coff, data, 300, 20)) {
+            printf("sdr_sim_add_sat() error\n");
+            exit(-1);
+        }
+    }
+}
+
+// test sdr_sim_gen() reproducibility ------------------------------------------
+//  The IF data should be the same independent of the number of samples per
+//  call and the number of threads.
+static void test_01(void)
+{
+    static const int fmt[] = {
+        SDR_FMT_INT8, SDR_FMT_INT8X2, SDR_FMT_RAW8, SDR_FMT_RAW16, 0
+    };
+    double fo[] = {1575.42e6, 1227.6e6, 1176.45e6, 1207.14e6};
+    int IQ[] = {2, 1, 2, 2}, N = 100000;
+    uint8_t *raw1 = (uint8_t *)sdr_malloc(N * 2);
+    uint8_t *raw2 = (uint8_t *)sdr_malloc(N * 2);
+    
+    for (int i = 0; fmt[i]; i++) {
+        sdr_sim_t *sim1 = sdr_sim_new(fmt[i], 12e6, fo, IQ, 123, 1);
+        sdr_sim_t *sim2 = sdr_sim_new(fmt[i], 12e6, fo, IQ, 123, 4);
+        srand(1);
+        add_sats(sim1, 8);
+        srand(1);
+        add_sats(sim2, 8);
+        int size = sdr_sim_gen(sim1, N, raw1);
+        for (int j = 0, n = 777; j < N; j += n) {
+            sdr_sim_gen(sim2, n < N - j ? n : N - j, raw2 + j * (size / N));
+        }
+        if (memcmp(raw1, raw2, size)) {
+            printf("sdr_sim_gen() error fmt=%d\n", fmt[i]);
+            exit(-1);
+        }
+        sdr_sim_free(sim1);
+        sdr_sim_free(sim2);
+        printf("test_01: fmt=%d size=%d OK\n", fmt[i], size);
+    }
+    sdr_free(raw1);
+    sdr_free(raw2);
+    printf("test_01: OK\n");
+}
+
+// test correlation of simulated signal ----------------------------------------
+//  The correlation power at the code offset should be at the peak.
+static void test_02(void)
+{
+    double fs = 12e6, fo[] = {1575.42e6}, dop = 1234.5, coff = 0.37e-3;
+    int IQ[] = {2}, N = 12000, len_code, pos[] = {0, -6, 6, 3000};
+    sdr_sim_t *sim = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+    uint8_t *raw = (uint8_t *)sdr_malloc(N * 4 * 2);
+    sdr_buff_t *buff = sdr_buff_new(N * 4, 2);
+    sdr_cpx16_t *code_res = (sdr_cpx16_t *)sdr_malloc(sizeof(sdr_cpx16_t) * N);
+    sdr_cpx_t C[4];
+    
+    sdr_sim_add_sat(sim, "L1CA", 5, dop, 0.0, 50.0, coff, NULL, 0, 0);
+    sdr_sim_gen(sim, N * 4, raw);
+    for (int i = 0; i < N * 4; i++) {
+        buff->data[i] = SDR_CPX8(raw[i*2], -raw[i*2+1]);
+    }
+    int8_t *code = sdr_gen_code("L1CA", 5, &len_code);
+    sdr_res_code(code, len_code, 1e-3, 0.0, fs, N, 0, code_res);
+    
+    for (int i = 0; i < 3; i++) {
+        int ix = (int)(coff * fs + 0.5) + N * i;
+        sdr_corr_std(buff, ix, N, fs, dop, 0.0, code_res, pos, 4, C);
+        double P[4];
+        for (int j = 0; j < 4; j++) {
+            P[j] = C[j][0] * C[j][0] + C[j][1] * C[j][1];
+        }
+        if (P[0] < P[1] || P[0] < P[2] || P[0] < P[3] * 10.0) {
+            printf("sdr_sim_gen() correlation error P=%.3f %.3f %.3f %.3f\n",
+                P[0], P[1], P[2], P[3]);
+            exit(-1);
+        }
+        printf("test_02: ix=%6d P=%8.5f %8.5f %8.5f %8.5f\n", ix, P[0], P[1],
+            P[2], P[3]);
+    }
+    sdr_buff_free(buff);
+    sdr_free(code_res);
+    sdr_free(raw);
+    sdr_sim_free(sim);
+    printf("test_02: OK\n");
+}
+
+// test performance of sdr_sim_gen() -------------------------------------------
+static void test_03(void)
+{
+    static const int nsat[] = {1, 8, 32, 0};
+    double fs = 24e6, fo[] = {1575.42e6, 1227.6e6};
+    int IQ[] = {2, 2}, N = (int)fs / 100;
+    uint8_t *raw = (uint8_t *)sdr_malloc(N);
+    
+    for (int i = 0; nsat[i]; i++) {
+        sdr_sim_t *sim = sdr_sim_new(SDR_FMT_RAW8, fs, fo, IQ, 1, 0);
+        add_sats(sim, nsat[i]);
+        uint32_t tick = sdr_get_tick();
+        for (int j = 0; j < 100; j++) {
+            sdr_sim_gen(sim, N, raw);
+        }
+        double t = (sdr_get_tick() - tick) * 1e-3;
+        printf("test_03: NSAT=%3d TIME=%7.3f s/1s IF data (x%.1f real-time)\n",
+            nsat[i], t, t > 0.0 ? 1.0 / t : 0.0);
+        sdr_sim_free(sim);
+    }
+    sdr_free(raw);
+    printf("test_03: OK\n");
+}
+
+// test long integration acquisition of weak signal ----------------------------
+//  The signal of 25 dB-Hz with nav data should be found by the long integration
+//  acquisition with the Doppler frequency and the code offset.
+static void test_04(void)
+{
+    extern double sdr_t_acq_l;
+    double fs = 4.096e6, fo[] = {1575.42e6}, dop = 1234.5, coff = 0.37e-3;
+    double T = 1e-3, cn0 = 25.0;
+    int IQ[] = {2}, N = 4096, ncyc = 1100;
+    uint8_t data[100];
+    
+    for (int i = 0; i < 100; i++) {
+        data[i] = rand() % 2;
+    }
+    sdr_sim_t *sim = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+    uint8_t *raw = (uint8_t *)sdr_malloc(N * ncyc * 2);
+    sdr_buff_t *buff = sdr_buff_new(N * ncyc, 2);
+    sdr_sim_add_sat(sim, "L1CA", 5, dop, 0.0, cn0, coff, data, 100, 20);
+    sdr_sim_gen(sim, N * ncyc, raw);
+    for (int i = 0; i < N * ncyc; i++) {
+        buff->data[i] = SDR_CPX8(raw[i*2], -raw[i*2+1]);
+    }
+    for (int i = 0; i < 2; i++) {
+        sdr_t_acq_l = i ? 1.0 : 0.0;
+        sdr_ch_t *ch = sdr_ch_new("L1CA", 5, fs, 0.0);
+        ch->state = SDR_STATE_SRCH;
+        uint32_t tick = sdr_get_tick();
+        int k;
+        for (k = 0; k < ncyc - 2 && ch->state == SDR_STATE_SRCH; k++) {
+            sdr_ch_update(ch, (k + 1) * T, buff, N * k);
+        }
+        double t = (sdr_get_tick() - tick) * 1e-3;
+        double fd = SDR_CH_FD(ch), err_c = 0.0;
+        if (ch->state == SDR_STATE_LOCK) {
+            double coff_k = coff - dop / fo[0] * (k - 1) * T;
+            err_c = fmod(SDR_CH_COFF(ch) - coff_k + 1.5 * T, T) - 0.5 * T;
+        }
+        printf("test_04: t_acq_l=%.1f state=%d fd=%.1f err_coff=%.2f(sample) "
+            "time=%.3f s\n", sdr_t_acq_l, ch->state, fd, err_c * fs, t);
+        if (i && (ch->state != SDR_STATE_LOCK || fabs(fd - dop) > 10.0 ||
+            fabs(err_c * fs) > 2.0)) {
+            printf("long integration acquisition error\n");
+            exit(-1);
+        }
+        sdr_ch_free(ch);
+    }
+    sdr_t_acq_l = 0.0;
+    sdr_buff_free(buff);
+    sdr_free(raw);
+    sdr_sim_free(sim);
+    printf("test_04: OK\n");
+}
+
+// test sub-band DDC -----------------------------------------------------------
+//  The narrowband signals and the GLONASS FDMA signals should be tracked on
+//  the decimated sub-bands with C/N0 close to the channels on the full-rate
+//  IF data.
+static void test_05(void)
+{
+    const char *sigs[] = {"L1CA", "G1CA"};
+    double fss[] = {16.384e6, 8.192e6}, fos[] = {1575.42e6, 1602e6};
+    double chip[] = {1.023e6, 0.511e6};
+    double dop[] = {-2345.6, 1234.5}, coff[] = {0.21e-3, 0.73e-3};
+    double T = 1e-3, cn0 = 45.0;
+    int prns[][2] = {{5, 12}, {-4, 3}}, IQ[] = {2}, ncyc = 600;
+    
+    for (int i = 0; i < 2; i++) {
+        double fs = fss[i], fo[] = {fos[i]};
+        int N = (int)(fs * T);
+        int D = sdr_ddc_dec(fs, N, 4.0 * chip[i]);
+        sdr_sim_t *sim = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+        uint8_t *raw = (uint8_t *)sdr_malloc(N * ncyc * 2);
+        sdr_buff_t *buff = sdr_buff_new(N * ncyc, 2);
+        for (int j = 0; j < 2; j++) {
+            sdr_sim_add_sat(sim, sigs[i], prns[i][j], dop[j], 0.0, cn0, coff[j],
+                NULL, 0, 0);
+        }
+        sdr_sim_gen(sim, N * ncyc, raw);
+        for (int j = 0; j < N * ncyc; j++) {
+            buff->data[j] = SDR_CPX8(raw[j*2], -raw[j*2+1]);
+        }
+        if (D != 4) {
+            printf("sdr_ddc_dec() error\n");
+            exit(-1);
+        }
+        for (int j = 0; j < 2; j++) {
+            double fc = sdr_shift_freq(sigs[i], prns[i][j], 0.0), t[3];
+            sdr_ddc_t *ddc = sdr_ddc_new(buff, fs, fc, N, D);
+            sdr_ch_t *ch[2];
+            ch[0] = sdr_ch_new(sigs[i], prns[i][j], fs, 0.0);
+            ch[1] = sdr_ch_new(sigs[i], prns[i][j], fs / D, -fc);
+            uint32_t tick = sdr_get_tick();
+            sdr_ddc_update(ddc, 0, ncyc - 1);
+            t[2] = (sdr_get_tick() - tick) * 1e-3;
+            for (int k = 0; k < 2; k++) { // tracking time after lock
+                sdr_buff_t *buff_k = k ? ddc->buff : buff;
+                ch[k]->state = SDR_STATE_SRCH;
+                tick = 0;
+                for (int m = 0; m < ncyc - 2; m++) {
+                    sdr_ch_update(ch[k], (m + 1) * T, buff_k, N / (k ? D : 1) *
+                        m);
+                    if (!tick && ch[k]->state == SDR_STATE_LOCK) {
+                        tick = sdr_get_tick();
+                    }
+                }
+                t[k] = tick ? (sdr_get_tick() - tick) * 1e-3 : 0.0;
+            }
+            printf("test_05: %s PRN=%+3d CN0=%.1f/%.1f fd=%.1f/%.1f "
+                "time=%.3f/%.3f/%.3f s\n", sigs[i], prns[i][j],
+                SDR_CH_CN0(ch[0]), SDR_CH_CN0(ch[1]), SDR_CH_FD(ch[0]),
+                SDR_CH_FD(ch[1]), t[0], t[1], t[2]);
+            if (ch[1]->state != SDR_STATE_LOCK ||
+                fabs(SDR_CH_FD(ch[1]) - dop[j]) > 10.0 ||
+                SDR_CH_CN0(ch[1]) < SDR_CH_CN0(ch[0]) - 1.5) {
+                printf("sub-band DDC error\n");
+                exit(-1);
+            }
+            sdr_ch_free(ch[0]);
+            sdr_ch_free(ch[1]);
+            sdr_ddc_free(ddc);
+        }
+        sdr_buff_free(buff);
+        sdr_free(raw);
+        sdr_sim_free(sim);
+    }
+    printf("test_05: OK\n");
+}
+
+// test joint tracking of data and pilot channels ------------------------------
+//  The data channel E1B is slaved to the pilot channel E1C. The data component
+//  is simulated in phase and in quadrature with the pilot component.
+static void test_06(void)
+{
+    double fs = 4.096e6, fo[] = {1575.42e6}, T = 4e-3, dop = 1876.5;
+    double coff = 1.234e-3, cn0 = 45.0, phi[] = {0.0, 0.25};
+    int IQ[] = {2}, N = (int)(fs * T), ncyc = 800, prn = 11;
+    uint8_t data[250];
+    
+    for (int i = 0; i < 250; i++) {
+        data[i] = rand() % 2;
+    }
+    for (int i = 0; i < 2; i++) {
+        sdr_sim_t *sim = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+        uint8_t *raw = (uint8_t *)sdr_malloc(N * ncyc * 2);
+        sdr_buff_t *buff = sdr_buff_new(N * ncyc, 2);
+        sdr_sim_add_sat(sim, "E1B", prn, dop, 0.0, cn0, coff, data, 250, 1);
+        sdr_sim_add_sat(sim, "E1C", prn, dop, 0.0, cn0, coff, NULL, 0, 0);
+        sim->sats[0].phi = phi[i];
+        sdr_sim_gen(sim, N * ncyc, raw);
+        for (int j = 0; j < N * ncyc; j++) {
+            buff->data[j] = SDR_CPX8(raw[j*2], -raw[j*2+1]);
+        }
+        sdr_ch_blk_t *blk = sdr_ch_blk_new();
+        sdr_ch_t *ch[2];
+        ch[0] = sdr_ch_new("E1B", prn, fs, 0.0);
+        ch[1] = sdr_ch_new("E1C", prn, fs, 0.0);
+        sdr_ch_blk_add(blk, ch[0]);
+        sdr_ch_blk_add(blk, ch[1]);
+        if (!sdr_ch_join(ch[0], ch[1])) {
+            printf("sdr_ch_join() error\n");
+            exit(-1);
+        }
+        ch[1]->state = SDR_STATE_SRCH;
+        for (int m = 0; m < ncyc - 2; m++) {
+            double time[] = {(m + 1) * T, (m + 1) * T};
+            const sdr_buff_t *buffs[] = {buff, buff};
+            int ix[] = {N * m, N * m};
+            sdr_ch_blk_update(blk, 3, time, buffs, ix, NULL);
+        }
+        double I = 0.0, Q = 0.0;
+        for (int j = SDR_N_HIST - 250; j < SDR_N_HIST; j++) {
+            I += fabs(SDR_TRK_P(ch[0]->trk, j)[0]);
+            Q += fabs(SDR_TRK_P(ch[0]->trk, j)[1]);
+        }
+        printf("test_06: phi=%.2f state=%d/%d CN0=%.1f/%.1f fd=%.1f/%.1f "
+            "rot=%d I/Q=%.2f\n", phi[i], ch[0]->state, ch[1]->state,
+            SDR_CH_CN0(ch[0]), SDR_CH_CN0(ch[1]), SDR_CH_FD(ch[0]),
+            SDR_CH_FD(ch[1]), ch[0]->trk->rot, Q > 0.0 ? I / Q : 0.0);
+        if (ch[0]->state != SDR_STATE_LOCK || ch[1]->state != SDR_STATE_LOCK ||
+            SDR_CH_FD(ch[0]) != SDR_CH_FD(ch[1]) ||
+            fabs(SDR_CH_FD(ch[0]) - dop) > 10.0 || ch[0]->trk->rot != i + 1 ||
+            I < 2.0 * Q) {
+            printf("joint tracking error\n");
+            exit(-1);
+        }
+        sdr_ch_free(ch[0]);
+        sdr_ch_free(ch[1]);
+        sdr_ch_blk_free(blk);
+        sdr_buff_free(buff);
+        sdr_free(raw);
+        sdr_sim_free(sim);
+    }
+    printf("test_06: OK\n");
+}
+
+// test coasting by Doppler aiding across signal blockage ---------------------
+//  The signal is blocked for 5 s by the IF data of noise only. The channel
+//  aided by the true Doppler should be coasted and recovered without lost,
+//  while the channel without aiding should be lost.
+static void test_07(void)
+{
+    double fs = 2.048e6, fo[] = {1575.42e6}, T = 1e-3, dop = -1234.5;
+    double t_blk[] = {3.0, 8.0}, tlen = 12.0;
+    int IQ[] = {2}, N = (int)(fs * T), depth = 64, prn = 7;
+    sdr_sim_t *sim[2];
+    sdr_ch_t *ch[2];
+    
+    for (int i = 0; i < 2; i++) {
+        sim[i] = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+        ch[i] = sdr_ch_new("L1CA", prn, fs, 0.0);
+        ch[i]->state = SDR_STATE_SRCH;
+    }
+    sdr_sim_add_sat(sim[0], "L1CA", prn, dop, 0.0, 45.0, 0.3e-3, NULL, 0, 0);
+    uint8_t *raw[2];
+    raw[0] = (uint8_t *)sdr_malloc(N * 2);
+    raw[1] = (uint8_t *)sdr_malloc(N * 2);
+    sdr_buff_t *buff = sdr_buff_new(N * depth, 2);
+    
+    for (int m = 0; m < (int)(tlen / T); m++) {
+        int blk = m * T >= t_blk[0] && m * T < t_blk[1];
+        sdr_sim_gen(sim[0], N, raw[0]);
+        sdr_sim_gen(sim[1], N, raw[1]);
+        sdr_cpx8_t *p = buff->data + N * (m % depth);
+        for (int j = 0; j < N; j++) {
+            p[j] = SDR_CPX8(raw[blk][j*2], -raw[blk][j*2+1]);
+        }
+        if (m < 1) continue;
+        for (int i = 0; i < 2; i++) {
+            if (i == 0 && m % 100 == 0) {
+                sdr_ch_aid(ch[i], m * T, dop, 0.0);
+            }
+            sdr_ch_update(ch[i], (m + 1) * T, buff, N * ((m - 1) % depth));
+        }
+    }
+    printf("test_07: state=%d/%d lost=%d/%d lock=%.3f/%.3f t_rec=%.3f "
+        "fd=%.1f CN0=%.1f\n", ch[0]->state, ch[1]->state, ch[0]->lost,
+        ch[1]->lost, ch[0]->lock * T, ch[1]->lock * T, ch[0]->t_rec,
+        SDR_CH_FD(ch[0]), SDR_CH_CN0(ch[0]));
+    if (ch[0]->state != SDR_STATE_LOCK || ch[0]->lost > 0 ||
+        ch[0]->t_rec < t_blk[1] || fabs(SDR_CH_FD(ch[0]) - dop) > 10.0 ||
+        ch[1]->lost < 1) {
+        printf("Doppler aiding error\n");
+        exit(-1);
+    }
+    for (int i = 0; i < 2; i++) {
+        sdr_ch_free(ch[i]);
+        sdr_sim_free(sim[i]);
+        sdr_free(raw[i]);
+    }
+    sdr_buff_free(buff);
+    printf("test_07: OK\n");
+}
+
+// test coherent integration over multiple code cycles -------------------------
+//  The signal with nav data is tracked by the channel with coherent integration
+//  up to 20 ms aligned to the nav data symbols. C/N0 and Doppler should be
+//  close to the channel without integration with fewer tracking loop updates.
+static void test_08(void)
+{
+    extern double sdr_t_int;
+    double fs = 2.048e6, fo[] = {1575.42e6}, T = 1e-3, dop = 2345.6;
+    double coff = 0.56e-3, cn0 = 40.0;
+    int IQ[] = {2}, N = (int)(fs * T), ncyc = 6000, prn = 18, nupd[2] = {0};
+    uint8_t data[300];
+    
+    for (int i = 0; i < 300; i++) {
+        data[i] = rand() % 2;
+    }
+    sdr_sim_t *sim = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+    uint8_t *raw = (uint8_t *)sdr_malloc(N * ncyc * 2);
+    sdr_buff_t *buff = sdr_buff_new(N * ncyc, 2);
+    sdr_sim_add_sat(sim, "L1CA", prn, dop, 0.0, cn0, coff, data, 300, 20);
+    sdr_sim_gen(sim, N * ncyc, raw);
+    for (int i = 0; i < N * ncyc; i++) {
+        buff->data[i] = SDR_CPX8(raw[i*2], -raw[i*2+1]);
+    }
+    sdr_ch_t *ch[2];
+    for (int i = 0; i < 2; i++) {
+        ch[i] = sdr_ch_new("L1CA", prn, fs, 0.0);
+        ch[i]->state = SDR_STATE_SRCH;
+    }
+    sdr_t_int = 0.02;
+    for (int m = 0; m < ncyc - 2; m++, nupd[0]++) {
+        sdr_ch_update(ch[0], (m + 1) * T, buff, N * m);
+    }
+    for (int m = 0; m < ncyc - 2 - 20; nupd[1]++) {
+        double time[SDR_CH_BLK];
+        const sdr_buff_t *buffs[SDR_CH_BLK];
+        int ix[SDR_CH_BLK], nc[SDR_CH_BLK], k = ch[1]->ib;
+        time[k] = (m + 1) * T;
+        buffs[k] = buff;
+        ix[k] = N * m;
+        nc[k] = 20;
+        sdr_ch_blk_update(ch[1]->blk, 1u << k, time, buffs, ix, nc);
+        m += nc[k];
+    }
+    sdr_t_int = 0.0;
+    printf("test_08: state=%d/%d nc=%d/%d ssync=%d/%d CN0=%.1f/%.1f "
+        "fd=%.1f/%.1f updates=%d/%d\n", ch[0]->state, ch[1]->state, ch[0]->nc,
+        ch[1]->nc, ch[0]->nav->ssync, ch[1]->nav->ssync, SDR_CH_CN0(ch[0]),
+        SDR_CH_CN0(ch[1]), SDR_CH_FD(ch[0]), SDR_CH_FD(ch[1]), nupd[0],
+        nupd[1]);
+    if (ch[1]->state != SDR_STATE_LOCK || ch[1]->nc != 20 ||
+        ch[1]->nav->ssync <= 0 || ch[1]->lost > 0 ||
+        fabs(SDR_CH_CN0(ch[1]) - SDR_CH_CN0(ch[0])) > 1.5 ||
+        fabs(SDR_CH_FD(ch[1]) - dop) > 5.0 || nupd[1] > nupd[0] / 2) {
+        printf("coherent integration error\n");
+        exit(-1);
+    }
+    for (int i = 0; i < 2; i++) {
+        sdr_ch_free(ch[i]);
+    }
+    sdr_buff_free(buff);
+    sdr_free(raw);
+    sdr_sim_free(sim);
+    printf("test_08: OK\n");
+}
+
+// test blind search of long code signal by decimated search -------------------
+//  The L2CM signal of 20 ms code cycle should be searched by the partial code
+//  in the decimated IF data without Doppler assist and locked after the full
+//  code search in the Doppler window.
+static void test_09(void)
+{
+    double fs = 6.5536e6, fo[] = {1227.6e6}, T = 20e-3, dop = -3210.5;
+    double coff = 7.3e-3, cn0 = 42.0;
+    int IQ[] = {2}, N = (int)(fs * T), ncyc = 12, k;
+    
+    sdr_sim_t *sim = sdr_sim_new(SDR_FMT_INT8X2, fs, fo, IQ, 1, 0);
+    uint8_t *raw = (uint8_t *)sdr_malloc(N * ncyc * 2);
+    sdr_buff_t *buff = sdr_buff_new(N * ncyc, 2);
+    sdr_sim_add_sat(sim, "L2CM", 7, dop, 0.0, cn0, coff, NULL, 0, 0);
+    sdr_sim_gen(sim, N * ncyc, raw);
+    for (int i = 0; i < N * ncyc; i++) {
+        buff->data[i] = SDR_CPX8(raw[i*2], -raw[i*2+1]);
+    }
+    sdr_ch_t *ch = sdr_ch_new("L2CM", 7, fs, 0.0);
+    ch->state = SDR_STATE_SRCH;
+    uint32_t tick = sdr_get_tick();
+    for (k = 0; k < ncyc - 2 && ch->state == SDR_STATE_SRCH; k++) {
+        sdr_ch_update(ch, (k + 1) * T, buff, N * k);
+    }
+    double t = (sdr_get_tick() - tick) * 1e-3;
+    double fd = SDR_CH_FD(ch), err_c = 0.0;
+    if (ch->state == SDR_STATE_LOCK) {
+        double coff_k = coff - dop / fo[0] * (k - 1) * T;
+        err_c = fmod(SDR_CH_COFF(ch) - coff_k + 1.5 * T, T) - 0.5 * T;
+    }
+    printf("test_09: D=%d state=%d fd=%.1f err_coff=%.2f(sample) ncyc=%d "
+        "time=%.3f s\n", ch->acq->D, ch->state, fd, err_c * fs, k, t);
+    if (ch->acq->D <= 1 || ch->state != SDR_STATE_LOCK ||
+        fabs(fd - dop) > 10.0 || fabs(err_c * fs) > 2.0) {
+        printf("decimated search error\n");
+        exit(-1);
+    }
+    sdr_ch_free(ch);
+    sdr_buff_free(buff);
+    sdr_free(raw);
+    sdr_sim_free(sim);
+    printf("test_09: OK\n");
+}
+
+// test main --------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    sdr_func_init("../../python/fftw_wisdom.txt");
+    
+    test_01();
+    test_02();
+    test_03();
+    test_04();
+    test_05();
+    test_06();
+    test_07();
+    test_08();
+    test_09();
+    return 0;
+}